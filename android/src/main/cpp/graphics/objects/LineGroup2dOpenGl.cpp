@@ -21,21 +21,25 @@ std::shared_ptr<GraphicsObjectInterface> LineGroup2dOpenGl::asGraphicsObject() {
 bool LineGroup2dOpenGl::isReady() { return ready; }
 
 
-void LineGroup2dOpenGl::setLines(const ::SharedBytes & lines, const ::SharedBytes & indices, const Vec3D &origin, bool is3d) {
+void LineGroup2dOpenGl::setLines(const ::SharedBytes & lines, const ::SharedBytes & indices, const Vec3D &origin, float positionScale, bool is3d) {
     std::lock_guard<std::recursive_mutex> lock(dataMutex);
     ready = false;
     dataReady = false;
 
-    lineIndices.resize(indices.elementCount);
-    lineAttributes.resize(lines.elementCount);
+    lineIndices.resize((size_t)indices.elementCount * indices.bytesPerElement);
+    lineIndexType = indices.bytesPerElement == sizeof(GLushort) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    numLineIndices = indices.elementCount;
+    lineAttributes.resize((size_t)lines.elementCount * lines.bytesPerElement);
+    lineStride = lines.bytesPerElement;
     lineOrigin = origin;
+    this->positionScale = positionScale;
     this->is3d = is3d;
 
     if (indices.elementCount > 0) {
-        std::memcpy(lineIndices.data(), (void *) indices.address, indices.elementCount * indices.bytesPerElement);
+        std::memcpy(lineIndices.data(), (void *) indices.address, lineIndices.size());
     }
     if (lines.elementCount > 0) {
-        std::memcpy(lineAttributes.data(), (void *) lines.address, lines.elementCount * lines.bytesPerElement);
+        std::memcpy(lineAttributes.data(), (void *) lines.address, lineAttributes.size());
     }
 
     dataReady = true;
@@ -63,46 +67,33 @@ void LineGroup2dOpenGl::setup(const std::shared_ptr<::RenderingContextInterface>
     glBindVertexArray(vao);
 
     positionHandle = glGetAttribLocation(program, "position");
-    extrudeHandle = glGetAttribLocation(program, "extrude");
-    lineSideHandle = glGetAttribLocation(program, "lineSide");
+    extrudeSideHandle = glGetAttribLocation(program, "extrudeSide");
     lengthPrefixHandle = glGetAttribLocation(program, "lengthPrefix");
-    lengthCorrectionHandle = glGetAttribLocation(program, "lengthCorrection");
-    stylingIndexHandle = glGetAttribLocation(program, "stylingIndex");
+    lengthCorrectionStyleHandle = glGetAttribLocation(program, "lengthCorrectionStyle");
 
     if (!glDataBuffersGenerated) {
         glGenBuffers(1, &vertexAttribBuffer);
     }
     glBindBuffer(GL_ARRAY_BUFFER, vertexAttribBuffer);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * lineAttributes.size(), &lineAttributes[0], GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, lineAttributes.size(), lineAttributes.data(), GL_STATIC_DRAW);
 
-    size_t floatSize = sizeof(GLfloat);
+    // int16 positions (padded to four in 3D), int8 extrude and side, float length prefix, half float length correction and style
     size_t dimensionality = is3d ? 3 : 2;
-    size_t sizeAttribGroup = floatSize * dimensionality;
-    size_t stride = sizeAttribGroup * 2 + 4 * floatSize;
+    size_t positionSize = is3d ? 4 * sizeof(GLshort) : 2 * sizeof(GLshort);
 
     glEnableVertexAttribArray(positionHandle);
-    glVertexAttribPointer(positionHandle, dimensionality, GL_FLOAT, false, stride, nullptr);
+    glVertexAttribPointer(positionHandle, dimensionality, GL_SHORT, true, lineStride, nullptr);
 
-    glEnableVertexAttribArray(extrudeHandle);
-    glVertexAttribPointer(extrudeHandle, dimensionality, GL_FLOAT, false, stride, (float *)(sizeAttribGroup * 1));
-
-    if (lineSideHandle >= 0) {
-        glEnableVertexAttribArray(lineSideHandle);
-        glVertexAttribPointer(lineSideHandle, 1, GL_FLOAT, false, stride, (float *) (sizeAttribGroup * 2));
-    }
+    glEnableVertexAttribArray(extrudeSideHandle);
+    glVertexAttribPointer(extrudeSideHandle, 4, GL_BYTE, true, lineStride, (void *)positionSize);
 
     if (lengthPrefixHandle >= 0) {
         glEnableVertexAttribArray(lengthPrefixHandle);
-        glVertexAttribPointer(lengthPrefixHandle, 1, GL_FLOAT, false, stride, (float *) (sizeAttribGroup * 2 + 1 * floatSize));
-    }
-
-    if (lengthCorrectionHandle >= 0) {
-        glEnableVertexAttribArray(lengthCorrectionHandle);
-        glVertexAttribPointer(lengthCorrectionHandle, 1, GL_FLOAT, false, stride, (float *) (sizeAttribGroup * 2 + 2 * floatSize));
+        glVertexAttribPointer(lengthPrefixHandle, 1, GL_FLOAT, false, lineStride, (void *)(positionSize + 4));
     }
 
-    glEnableVertexAttribArray(stylingIndexHandle);
-    glVertexAttribPointer(stylingIndexHandle, 1, GL_FLOAT, false, stride, (float *)(sizeAttribGroup * 2 + 3 * floatSize));
+    glEnableVertexAttribArray(lengthCorrectionStyleHandle);
+    glVertexAttribPointer(lengthCorrectionStyleHandle, 2, GL_HALF_FLOAT, false, lineStride, (void *)(positionSize + 4 + sizeof(GLfloat)));
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
@@ -110,7 +101,7 @@ void LineGroup2dOpenGl::setup(const std::shared_ptr<::RenderingContextInterface>
         glGenBuffers(1, &indexBuffer);
     }
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * lineIndices.size(), &lineIndices[0], GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, lineIndices.size(), lineIndices.data(), GL_STATIC_DRAW);
 
     glBindVertexArray(0);
 
@@ -120,6 +111,7 @@ void LineGroup2dOpenGl::setup(const std::shared_ptr<::RenderingContextInterface>
     originOffsetHandle = glGetUniformLocation(program, "originOffset");
     lineOriginHandle = glGetUniformLocation(program, "uLineOrigin");
     scaleFactorHandle = glGetUniformLocation(program, "scalingFactor");
+    positionScaleHandle = glGetUniformLocation(program, "positionScale");
 
     shaderProgram->setupGlObjects(openGlContext);
 
@@ -184,11 +176,12 @@ void LineGroup2dOpenGl::render(const std::shared_ptr<::RenderingContextInterface
     }
 
     glUniform4f(originOffsetHandle, lineOrigin.x - origin.x, lineOrigin.y - origin.y, lineOrigin.z - origin.z, 0.0);
+    glUniform1f(positionScaleHandle, positionScale);
 
     shaderProgram->preRender(openGlContext, isScreenSpaceCoords);
 
     // Draw the triangle
-    glDrawElements(GL_TRIANGLES, lineIndices.size(), GL_UNSIGNED_INT, nullptr);
+    glDrawElements(GL_TRIANGLES, numLineIndices, lineIndexType, nullptr);
 
     glBindVertexArray(0);
 
@@ -30,7 +30,7 @@ class LineGroup2dOpenGl : public GraphicsObjectInterface,
 
     // LineGroup2dInterface
 
-    virtual void setLines(const ::SharedBytes & lines, const ::SharedBytes & indices, const Vec3D &origin, bool is3d) override;
+    virtual void setLines(const ::SharedBytes & lines, const ::SharedBytes & indices, const Vec3D &origin, float positionScale, bool is3d) override;
 
     virtual std::shared_ptr<GraphicsObjectInterface> asGraphicsObject() override;
 
@@ -62,21 +62,26 @@ protected:
     int originOffsetHandle;
     int lineOriginHandle;
     int scaleFactorHandle;
+    int positionScaleHandle;
 
     int positionHandle = -1;
-    int extrudeHandle = -1;
-    int lineSideHandle = -1;
+    int extrudeSideHandle = -1;
     int lengthPrefixHandle = -1;
-    int lengthCorrectionHandle = -1;
-    int stylingIndexHandle = -1;
+    int lengthCorrectionStyleHandle = -1;
 
     GLuint vao;
     GLuint vertexAttribBuffer = -1;
-    std::vector<GLfloat> lineAttributes;
+    // packed vertices, see LineGeometryBuilder::PackedLineVertices
+    std::vector<uint8_t> lineAttributes;
+    GLsizei lineStride = 0;
     GLuint indexBuffer = -1;
-    std::vector<GLuint> lineIndices;
+    // 16 or 32 bit indices, depending on the size of the line group
+    std::vector<uint8_t> lineIndices;
+    GLenum lineIndexType = GL_UNSIGNED_INT;
+    GLsizei numLineIndices = 0;
     bool glDataBuffersGenerated = false;
     Vec3D lineOrigin = Vec3D(0.0, 0.0, 0.0);
+    float positionScale = 1.0;
 
     bool ready = false;
     bool dataReady = false;
@@ -11,6 +11,7 @@
 #pragma once
 
 #include "GraphicsObjectInterface.h"
+#include "InstancedRangeUpdateInterface.h"
 #include "MaskingObjectInterface.h"
 #include "OpenGlContext.h"
 #include "Quad2dInstancedInterface.h"
@@ -24,6 +25,7 @@
 class Quad2dInstancedOpenGl : public GraphicsObjectInterface,
                      public MaskingObjectInterface,
                      public Quad2dInstancedInterface,
+                     public InstancedRangeUpdateInterface,
                      public std::enable_shared_from_this<Quad2dInstancedOpenGl> {
   public:
     Quad2dInstancedOpenGl(const std::shared_ptr<::BaseShaderProgramOpenGl> &shader);
@@ -73,6 +75,8 @@ class Quad2dInstancedOpenGl : public GraphicsObjectInterface,
 
     void setPositionOffset(const SharedBytes &offsets) override;
 
+    bool setInstanceRange(InstancedRangeUpdateInterface::Attribute attribute, const ::SharedBytes &values, int32_t firstInstance) override;
+
 protected:
     virtual void adjustTextureCoordinates();
 
@@ -152,6 +156,6 @@ protected:
     static const uintptr_t instValuesSizeBytes3d = sizeof(GLfloat) * 13;
 
 private:
-    bool writeToDynamicInstanceDataBuffer(const ::SharedBytes &data, int targetOffsetBytes);
+    bool writeToDynamicInstanceDataBuffer(const ::SharedBytes &data, int targetOffsetBytes, int firstInstance = 0);
     void setBufferInstanceCapacity(int count);
 };
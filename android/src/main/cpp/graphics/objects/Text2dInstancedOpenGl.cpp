@@ -423,14 +423,59 @@ void Text2dInstancedOpenGl::setStyles(const ::SharedBytes &values) {
     buffersNotReady &= ~(1 << 7);
 }
 
-bool Text2dInstancedOpenGl::writeToDynamicInstanceDataBuffer(const ::SharedBytes &data, GLuint targetOffsetBytes) {
+bool Text2dInstancedOpenGl::setInstanceRange(InstancedRangeUpdateInterface::Attribute attribute, const ::SharedBytes &values,
+                                             int32_t firstInstance) {
+    std::lock_guard<std::recursive_mutex> lock(dataMutex);
+    GLuint targetOffsetBytes;
+    uint8_t bufferBit;
+    switch (attribute) {
+        case Attribute::POSITIONS:
+            targetOffsetBytes = is3d ? instPositionsOffsetBytes3d : instPositionsOffsetBytes;
+            bufferBit = 1;
+            break;
+        case Attribute::ROTATIONS:
+            targetOffsetBytes = is3d ? instRotationsOffsetBytes3d : instRotationsOffsetBytes;
+            bufferBit = 1 << 1;
+            break;
+        case Attribute::SCALES:
+            targetOffsetBytes = is3d ? instScalesOffsetBytes3d : instScalesOffsetBytes;
+            bufferBit = 1 << 2;
+            break;
+        case Attribute::ALPHAS:
+            targetOffsetBytes = is3d ? instAlphasOffsetBytes3d : instAlphasOffsetBytes;
+            bufferBit = 1 << 3;
+            break;
+        case Attribute::TEXTURE_COORDINATES:
+            targetOffsetBytes = is3d ? instTextureCoordinatesOffsetBytes3d : instTextureCoordinatesOffsetBytes;
+            bufferBit = 1 << 4;
+            break;
+        case Attribute::STYLE_INDICES:
+            targetOffsetBytes = is3d ? instStyleIndicesOffsetBytes3d : instStyleIndicesOffsetBytes;
+            bufferBit = 1 << 5;
+            break;
+        case Attribute::REFERENCE_POSITIONS:
+            targetOffsetBytes = is3d ? instReferencePositionsOffsetBytes3d : instReferencePositionsOffsetBytes;
+            bufferBit = 1 << 6;
+            break;
+        default:
+            return false;
+    }
+    // the rest of the instances must have been written before
+    if ((buffersNotReady & bufferBit) || firstInstance < 0 || firstInstance + values.elementCount > instanceCount) {
+        return false;
+    }
+    return writeToDynamicInstanceDataBuffer(values, targetOffsetBytes, firstInstance);
+}
+
+bool Text2dInstancedOpenGl::writeToDynamicInstanceDataBuffer(const ::SharedBytes &data, GLuint targetOffsetBytes, int firstInstance) {
     if(!ready){
         // Writing to buffer before it was created
         return false;
     }
 
     glBindBuffer(GL_ARRAY_BUFFER, dynamicInstanceDataBuffer);
-    glBufferSubData(GL_ARRAY_BUFFER, targetOffsetBytes * instanceCount, data.elementCount * data.bytesPerElement, (void *) data.address);
+    glBufferSubData(GL_ARRAY_BUFFER, targetOffsetBytes * instanceCount + firstInstance * data.bytesPerElement,
+                    data.elementCount * data.bytesPerElement, (void *) data.address);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     return true;
 }
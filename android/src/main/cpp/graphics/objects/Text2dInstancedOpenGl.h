@@ -11,6 +11,7 @@
 #pragma once
 
 #include "GraphicsObjectInterface.h"
+#include "InstancedRangeUpdateInterface.h"
 #include "OpenGlContext.h"
 #include "TextInstancedInterface.h"
 #include "ShaderProgramInterface.h"
@@ -22,6 +23,7 @@
 
 class Text2dInstancedOpenGl : public GraphicsObjectInterface,
                               public TextInstancedInterface,
+                              public InstancedRangeUpdateInterface,
                               public std::enable_shared_from_this<Text2dInstancedOpenGl> {
 public:
     Text2dInstancedOpenGl(const std::shared_ptr<::BaseShaderProgramOpenGl> &shader);
@@ -69,6 +71,8 @@ public:
 
     virtual void setStyles(const ::SharedBytes &values) override;
 
+    bool setInstanceRange(InstancedRangeUpdateInterface::Attribute attribute, const ::SharedBytes &values, int32_t firstInstance) override;
+
 protected:
     virtual void adjustTextureCoordinates();
 
@@ -160,7 +164,7 @@ protected:
     static const uintptr_t instValuesSizeBytes3d = sizeof(GLfloat) * 14;
 
 private:
-    bool writeToDynamicInstanceDataBuffer(const ::SharedBytes &data, GLuint targetOffsetBytes);
+    bool writeToDynamicInstanceDataBuffer(const ::SharedBytes &data, GLuint targetOffsetBytes, int firstInstance = 0);
 
     static const GLuint STYLE_UBO_BINDING = 1;
 };
@@ -210,22 +210,21 @@ std::string ColorLineGroup2dShaderOpenGl::getVertexShader() {
         OMMVersionedGlesShaderCodeWithFrameUBO(320 es, 300 es,
         precision highp float;
         uniform vec4 originOffset;
+        uniform float positionScale;
         ) +
 
         (is3d ? OMMShaderCode(
             in vec3 position;
-            in vec3 extrude;
         ) :
         OMMShaderCode(
             in vec2 position;
-            in vec2 extrude;
         )) +
 
+        // extrude / 2 and line side, length correction and styling index
         OMMShaderCode(
-            in float lineSide;
+            in vec4 extrudeSide;
             in float lengthPrefix;
-            in float lengthCorrection;
-            in float stylingIndex;
+            in vec2 lengthCorrectionStyle;
 
             out vec4 outColor;
             flat out int outStylingIndex;
@@ -241,7 +240,7 @@ std::string ColorLineGroup2dShaderOpenGl::getVertexShader() {
 
         + OMMShaderCode(
             void main() {
-                float fStylingIndex = mod(stylingIndex, 256.0);
+                float fStylingIndex = mod(lengthCorrectionStyle.y, 256.0);
                 int index = clamp(int(floor(fStylingIndex + 0.5)), 0, uLineStyles.numStyles);
                 float width = uLineStyles.lineValues[index].width / 2.0 * uFrameUniforms.frameSpecs.x;
                 ) +
@@ -251,19 +250,19 @@ std::string ColorLineGroup2dShaderOpenGl::getVertexShader() {
                     float blur = max(blurRadiusPx, uLineStyles.lineValues[index].blur) * uFrameUniforms.frameSpecs.x;
                 )) +
                 (is3d ? OMMShaderCode(
-                    vec4 extendedPosition = vec4(position + extrude * (width + blur), 1.0) + originOffset;
+                    vec4 extendedPosition = vec4(position * positionScale + extrudeSide.xyz * 2.0 * (width + blur), 1.0) + originOffset;
                 ) :
                 OMMShaderCode(
-                    vec4 extendedPosition = vec4(position + extrude * (width + blur), 0.0, 1.0) + originOffset;
+                    vec4 extendedPosition = vec4(position * positionScale + extrudeSide.xy * 2.0 * (width + blur), 0.0, 1.0) + originOffset;
                 )) +
 
                 (isSimple ? " " :
                 OMMShaderCode(
-                    outLengthPrefix = lengthPrefix + lengthCorrection * width;
+                    outLengthPrefix = lengthPrefix + lengthCorrectionStyle.x * width;
                 )) +
 
                 OMMShaderCode(
-                    outLineSide = lineSide;
+                    outLineSide = extrudeSide.w;
                     outStylingIndex = index;
                     outColor = vec4(uLineStyles.lineValues[index].colorR,
                                     uLineStyles.lineValues[index].colorG,
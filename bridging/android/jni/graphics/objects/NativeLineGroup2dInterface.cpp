@@ -17,7 +17,7 @@ NativeLineGroup2dInterface::JavaProxy::JavaProxy(JniType j) : Handle(::djinni::j
 
 NativeLineGroup2dInterface::JavaProxy::~JavaProxy() = default;
 
-void NativeLineGroup2dInterface::JavaProxy::setLines(const ::SharedBytes & c_lines, const ::SharedBytes & c_indices, const ::Vec3D & c_origin, bool c_is3d) {
+void NativeLineGroup2dInterface::JavaProxy::setLines(const ::SharedBytes & c_lines, const ::SharedBytes & c_indices, const ::Vec3D & c_origin, float c_positionScale, bool c_is3d) {
     auto jniEnv = ::djinni::jniGetThreadEnv();
     ::djinni::JniLocalScope jscope(jniEnv, 10);
     const auto& data = ::djinni::JniClass<::djinni_generated::NativeLineGroup2dInterface>::get();
@@ -25,6 +25,7 @@ void NativeLineGroup2dInterface::JavaProxy::setLines(const ::SharedBytes & c_lin
                            ::djinni::get(::djinni_generated::NativeSharedBytes::fromCpp(jniEnv, c_lines)),
                            ::djinni::get(::djinni_generated::NativeSharedBytes::fromCpp(jniEnv, c_indices)),
                            ::djinni::get(::djinni_generated::NativeVec3D::fromCpp(jniEnv, c_origin)),
+                           ::djinni::get(::djinni::F32::fromCpp(jniEnv, c_positionScale)),
                            ::djinni::get(::djinni::Bool::fromCpp(jniEnv, c_is3d)));
     ::djinni::jniExceptionCheck(jniEnv);
 }
@@ -44,13 +45,14 @@ CJNIEXPORT void JNICALL Java_io_openmobilemaps_mapscore_shared_graphics_objects_
     } JNI_TRANSLATE_EXCEPTIONS_RETURN(jniEnv, )
 }
 
-CJNIEXPORT void JNICALL Java_io_openmobilemaps_mapscore_shared_graphics_objects_LineGroup2dInterface_00024CppProxy_native_1setLines(JNIEnv* jniEnv, jobject /*this*/, jlong nativeRef, ::djinni_generated::NativeSharedBytes::JniType j_lines, ::djinni_generated::NativeSharedBytes::JniType j_indices, ::djinni_generated::NativeVec3D::JniType j_origin, jboolean j_is3d)
+CJNIEXPORT void JNICALL Java_io_openmobilemaps_mapscore_shared_graphics_objects_LineGroup2dInterface_00024CppProxy_native_1setLines(JNIEnv* jniEnv, jobject /*this*/, jlong nativeRef, ::djinni_generated::NativeSharedBytes::JniType j_lines, ::djinni_generated::NativeSharedBytes::JniType j_indices, ::djinni_generated::NativeVec3D::JniType j_origin, jfloat j_positionScale, jboolean j_is3d)
 {
     try {
         const auto& ref = ::djinni::objectFromHandleAddress<::LineGroup2dInterface>(nativeRef);
         ref->setLines(::djinni_generated::NativeSharedBytes::toCpp(jniEnv, j_lines),
                       ::djinni_generated::NativeSharedBytes::toCpp(jniEnv, j_indices),
                       ::djinni_generated::NativeVec3D::toCpp(jniEnv, j_origin),
+                      ::djinni::F32::toCpp(jniEnv, j_positionScale),
                       ::djinni::Bool::toCpp(jniEnv, j_is3d));
     } JNI_TRANSLATE_EXCEPTIONS_RETURN(jniEnv, )
 }
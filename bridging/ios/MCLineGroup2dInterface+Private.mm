@@ -37,11 +37,13 @@ static_assert(__has_feature(objc_arc), "Djinni requires ARC to be enabled for th
 - (void)setLines:(nonnull MCSharedBytes *)lines
          indices:(nonnull MCSharedBytes *)indices
           origin:(nonnull MCVec3D *)origin
+   positionScale:(float)positionScale
             is3d:(BOOL)is3d {
     try {
         _cppRefHandle.get()->setLines(::djinni_generated::SharedBytes::toCpp(lines),
                                       ::djinni_generated::SharedBytes::toCpp(indices),
                                       ::djinni_generated::Vec3D::toCpp(origin),
+                                      ::djinni::F32::toCpp(positionScale),
                                       ::djinni::Bool::toCpp(is3d));
     } DJINNI_TRANSLATE_EXCEPTIONS()
 }
@@ -62,12 +64,13 @@ class LineGroup2dInterface::ObjcProxy final
     friend class ::djinni_generated::LineGroup2dInterface;
 public:
     using ObjcProxyBase::ObjcProxyBase;
-    void setLines(const ::SharedBytes & c_lines, const ::SharedBytes & c_indices, const ::Vec3D & c_origin, bool c_is3d) override
+    void setLines(const ::SharedBytes & c_lines, const ::SharedBytes & c_indices, const ::Vec3D & c_origin, float c_positionScale, bool c_is3d) override
     {
         @autoreleasepool {
             [djinni_private_get_proxied_objc_object() setLines:(::djinni_generated::SharedBytes::fromCpp(c_lines))
                                                        indices:(::djinni_generated::SharedBytes::fromCpp(c_indices))
                                                         origin:(::djinni_generated::Vec3D::fromCpp(c_origin))
+                                                 positionScale:(::djinni::F32::fromCpp(c_positionScale))
                                                           is3d:(::djinni::Bool::fromCpp(c_is3d))];
         }
     }
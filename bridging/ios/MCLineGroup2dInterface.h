@@ -12,6 +12,7 @@
 - (void)setLines:(nonnull MCSharedBytes *)lines
          indices:(nonnull MCSharedBytes *)indices
           origin:(nonnull MCVec3D *)origin
+   positionScale:(float)positionScale
             is3d:(BOOL)is3d;
 
 - (nullable id<MCGraphicsObjectInterface>)asGraphicsObject;
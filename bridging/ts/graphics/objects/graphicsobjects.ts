@@ -115,7 +115,7 @@ export interface /*record*/ RenderLineDescription {
 }
 
 export interface LineGroup2dInterface {
-    setLines(lines: SharedBytes, indices: SharedBytes, origin: Vec3D, is3d: boolean): void;
+    setLines(lines: SharedBytes, indices: SharedBytes, origin: Vec3D, positionScale: number, is3d: boolean): void;
     asGraphicsObject(): GraphicsObjectInterface;
 }
 
@@ -16,11 +16,12 @@ em::val NativeLineGroup2dInterface::cppProxyMethods() {
     return methods;
 }
 
-void NativeLineGroup2dInterface::setLines(const CppType& self, const em::val& w_lines,const em::val& w_indices,const em::val& w_origin,bool w_is3d) {
+void NativeLineGroup2dInterface::setLines(const CppType& self, const em::val& w_lines,const em::val& w_indices,const em::val& w_origin,float w_positionScale,bool w_is3d) {
     try {
         self->setLines(::djinni_generated::NativeSharedBytes::toCpp(w_lines),
                  ::djinni_generated::NativeSharedBytes::toCpp(w_indices),
                  ::djinni_generated::NativeVec3D::toCpp(w_origin),
+                 ::djinni::F32::toCpp(w_positionScale),
                  ::djinni::Bool::toCpp(w_is3d));
     }
     catch(const std::exception& e) {
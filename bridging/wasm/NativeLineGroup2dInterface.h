@@ -23,7 +23,7 @@ struct NativeLineGroup2dInterface : ::djinni::JsInterface<::LineGroup2dInterface
 
     static em::val cppProxyMethods();
 
-    static void setLines(const CppType& self, const em::val& w_lines,const em::val& w_indices,const em::val& w_origin,bool w_is3d);
+    static void setLines(const CppType& self, const em::val& w_lines,const em::val& w_indices,const em::val& w_origin,float w_positionScale,bool w_is3d);
     static em::val asGraphicsObject(const CppType& self);
 
 };
@@ -19,6 +19,7 @@ final class LineGroup2d: BaseGraphicsObject, @unchecked Sendable {
     private var lineVerticesBuffer: MTLBuffer?
     private var lineIndicesBuffer: MTLBuffer?
     private var indicesCount: Int = 0
+    private var indexType: MTLIndexType = .uint32
 
     private var stencilState: MTLDepthStencilState?
     private var renderPassStencilState: MTLDepthStencilState?
@@ -119,7 +120,7 @@ final class LineGroup2d: BaseGraphicsObject, @unchecked Sendable {
         encoder.drawIndexedPrimitives(
             type: .triangle,
             indexCount: indicesCount,
-            indexType: .uint32,
+            indexType: indexType,
             indexBuffer: lineIndicesBuffer,
             indexBufferOffset: 0)
     }
@@ -127,7 +128,7 @@ final class LineGroup2d: BaseGraphicsObject, @unchecked Sendable {
 
 extension LineGroup2d: MCLineGroup2dInterface {
 
-    func setLines(_ lines: MCSharedBytes, indices: MCSharedBytes, origin: MCVec3D, is3d: Bool) {
+    func setLines(_ lines: MCSharedBytes, indices: MCSharedBytes, origin: MCVec3D, positionScale: Float, is3d: Bool) {
         guard lines.elementCount != 0 else {
             lock.withCritical {
                 lineVerticesBuffer = nil
@@ -143,6 +144,7 @@ extension LineGroup2d: MCLineGroup2dInterface {
                 bufferPointer.pointee.x = originOffset.xF
                 bufferPointer.pointee.y = originOffset.yF
                 bufferPointer.pointee.z = originOffset.zF
+                bufferPointer.pointee.w = positionScale
             } else {
                 fatalError()
             }
@@ -152,6 +154,7 @@ extension LineGroup2d: MCLineGroup2dInterface {
                 self.lineVerticesBuffer?.label = "LineGroup2d.verticesBuffer"
                 self.lineIndicesBuffer?.label = "LineGroup2d.indicesBuffer"
                 self.indicesCount = Int(indices.elementCount)
+                self.indexType = indices.bytesPerElement == 2 ? .uint16 : .uint32
             } else {
                 self.indicesCount = 0
             }
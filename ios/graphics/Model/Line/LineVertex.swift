@@ -12,47 +12,35 @@ import MapCoreSharedModule
 @preconcurrency import MetalKit
 
 public struct LineVertex: Equatable {
-    /// Returns the descriptor to use when passed to a metal shader
+    /// Returns the descriptor to use when passed to a metal shader, the vertices are packed by LineGeometryBuilder
     nonisolated(unsafe) public static let descriptorUnitSphere: MTLVertexDescriptor = {
         let vertexDescriptor = MTLVertexDescriptor()
         var offset = 0
         let bufferIndex = 0
 
-        // Position
+        // Position, normalized to the position scale
         vertexDescriptor.attributes[0].bufferIndex = bufferIndex
-        vertexDescriptor.attributes[0].format = .float3
+        vertexDescriptor.attributes[0].format = .short3Normalized
         vertexDescriptor.attributes[0].offset = offset
-        offset += 3 * MemoryLayout<Float>.stride
+        offset += 4 * MemoryLayout<Int16>.stride
 
-        // Extrude
+        // Extrude / 2 and Side
         vertexDescriptor.attributes[1].bufferIndex = bufferIndex
-        vertexDescriptor.attributes[1].format = .float3
+        vertexDescriptor.attributes[1].format = .char4Normalized
         vertexDescriptor.attributes[1].offset = offset
-        offset += 3 * MemoryLayout<Float>.stride
+        offset += 4 * MemoryLayout<Int8>.stride
 
-        // Side
+        // Length Prefix
         vertexDescriptor.attributes[2].bufferIndex = bufferIndex
         vertexDescriptor.attributes[2].format = .float
         vertexDescriptor.attributes[2].offset = offset
         offset += MemoryLayout<Float>.stride
 
-        // Length Prefix
+        // Length Correction and Line Style Info
         vertexDescriptor.attributes[3].bufferIndex = bufferIndex
-        vertexDescriptor.attributes[3].format = .float
+        vertexDescriptor.attributes[3].format = .half2
         vertexDescriptor.attributes[3].offset = offset
-        offset += MemoryLayout<Float>.stride
-
-        // Length Correction
-        vertexDescriptor.attributes[4].bufferIndex = bufferIndex
-        vertexDescriptor.attributes[4].format = .float
-        vertexDescriptor.attributes[4].offset = offset
-        offset += MemoryLayout<Float>.stride
-
-        // Line Style Info
-        vertexDescriptor.attributes[5].bufferIndex = bufferIndex
-        vertexDescriptor.attributes[5].format = .float
-        vertexDescriptor.attributes[5].offset = offset
-        offset += MemoryLayout<Float>.stride
+        offset += 2 * MemoryLayout<UInt16>.stride
 
         vertexDescriptor.layouts[0].stride = offset
         return vertexDescriptor
@@ -63,41 +51,29 @@ public struct LineVertex: Equatable {
         var offset = 0
         let bufferIndex = 0
 
-        // Position
+        // Position, normalized to the position scale
         vertexDescriptor.attributes[0].bufferIndex = bufferIndex
-        vertexDescriptor.attributes[0].format = .float2
+        vertexDescriptor.attributes[0].format = .short2Normalized
         vertexDescriptor.attributes[0].offset = offset
-        offset += 2 * MemoryLayout<Float>.stride
+        offset += 2 * MemoryLayout<Int16>.stride
 
-        // Extrude
+        // Extrude / 2 and Side
         vertexDescriptor.attributes[1].bufferIndex = bufferIndex
-        vertexDescriptor.attributes[1].format = .float2
+        vertexDescriptor.attributes[1].format = .char4Normalized
         vertexDescriptor.attributes[1].offset = offset
-        offset += 2 * MemoryLayout<Float>.stride
+        offset += 4 * MemoryLayout<Int8>.stride
 
-        // Side
+        // Length Prefix
         vertexDescriptor.attributes[2].bufferIndex = bufferIndex
         vertexDescriptor.attributes[2].format = .float
         vertexDescriptor.attributes[2].offset = offset
         offset += MemoryLayout<Float>.stride
 
-        // Length Prefix
+        // Length Correction and Line Style Info
         vertexDescriptor.attributes[3].bufferIndex = bufferIndex
-        vertexDescriptor.attributes[3].format = .float
+        vertexDescriptor.attributes[3].format = .half2
         vertexDescriptor.attributes[3].offset = offset
-        offset += MemoryLayout<Float>.stride
-
-        // Length Correction
-        vertexDescriptor.attributes[4].bufferIndex = bufferIndex
-        vertexDescriptor.attributes[4].format = .float
-        vertexDescriptor.attributes[4].offset = offset
-        offset += MemoryLayout<Float>.stride
-
-        // Line Style Info
-        vertexDescriptor.attributes[5].bufferIndex = bufferIndex
-        vertexDescriptor.attributes[5].format = .float
-        vertexDescriptor.attributes[5].offset = offset
-        offset += MemoryLayout<Float>.stride
+        offset += 2 * MemoryLayout<UInt16>.stride
 
         vertexDescriptor.layouts[0].stride = offset
         return vertexDescriptor
@@ -11,22 +11,19 @@
 #include <metal_stdlib>
 using namespace metal;
 
+// Packed vertices, see LineGeometryBuilder::PackedLineVertices
 struct LineVertexIn {
     float2 position [[attribute(0)]];
-    float2 extrude [[attribute(1)]];
-    float lineSide [[attribute(2)]];
-    float lengthPrefix [[attribute(3)]];
-    float lengthCorrection [[attribute(4)]];
-    float stylingIndex [[attribute(5)]];
+    float4 extrudeSide [[attribute(1)]];
+    float lengthPrefix [[attribute(2)]];
+    float2 lengthCorrectionStyle [[attribute(3)]];
 };
 
 struct LineVertexUnitSphereIn {
     float3 position [[attribute(0)]];
-    float3 extrude [[attribute(1)]];
-    float lineSide [[attribute(2)]];
-    float lengthPrefix [[attribute(3)]];
-    float lengthCorrection [[attribute(4)]];
-    float stylingIndex [[attribute(5)]];
+    float4 extrudeSide [[attribute(1)]];
+    float lengthPrefix [[attribute(2)]];
+    float2 lengthCorrectionStyle [[attribute(3)]];
 };
 
 struct LineVertexOut {
@@ -83,21 +80,21 @@ unitSphereSimpleLineGroupVertexShader(const LineVertexUnitSphereIn vertexIn [[st
                       constant float &scalingFactor [[buffer(2)]],
                       constant half *styling [[buffer(3)]],
                       constant float4 &originOffset [[buffer(4)]],
-                      constant float4 &tileOrigin [[buffer(5)]])
+                      constant float4 &tileOrigin [[buffer(5)]]) // w: scale of the positions
 {
-    int styleIndex = (int(vertexIn.stylingIndex) & 0xFF) * 8;
+    int styleIndex = (int(vertexIn.lengthCorrectionStyle.y) & 0xFF) * 8;
     constant SimpleLineStyling *style = (constant SimpleLineStyling *)(styling + styleIndex);
 
     // extend position in extrude direction by width / 2.0
     const float width = style->width / 2.0 * scalingFactor;
     const float blur = blurRadiusPx * scalingFactor;
 
-    const float4 extendedPosition = float4(vertexIn.position + vertexIn.extrude * (width + blur), 1.0) + originOffset;
+    const float4 extendedPosition = float4(vertexIn.position * tileOrigin.w + vertexIn.extrudeSide.xyz * 2.0 * (width + blur), 1.0) + originOffset;
 
     SimpleLineVertexOut out {
         .position = vpMatrix * extendedPosition,
         .stylingIndex = styleIndex,
-        .lineSide = vertexIn.lineSide,
+        .lineSide = vertexIn.extrudeSide.w,
     };
 
     return out;
@@ -109,21 +106,21 @@ simpleLineGroupVertexShader(const LineVertexIn vertexIn [[stage_in]],
                       constant float &scalingFactor [[buffer(2)]],
                       constant half *styling [[buffer(3)]],
                       constant float4 &originOffset [[buffer(4)]],
-                      constant float4 &tileOrigin [[buffer(5)]])
+                      constant float4 &tileOrigin [[buffer(5)]]) // w: scale of the positions
 {
-    int styleIndex = (int(vertexIn.stylingIndex) & 0xFF) * 8;
+    int styleIndex = (int(vertexIn.lengthCorrectionStyle.y) & 0xFF) * 8;
     constant SimpleLineStyling *style = (constant SimpleLineStyling *)(styling + styleIndex);
 
     // extend position in extrude direction by width / 2.0
     const float width = style->width / 2.0 * scalingFactor;
     const float blur = blurRadiusPx * scalingFactor;
 
-    const float4 extendedPosition = float4(vertexIn.position + vertexIn.extrude * (width + blur), 0.0, 1.0) + originOffset;
+    const float4 extendedPosition = float4(vertexIn.position * tileOrigin.w + vertexIn.extrudeSide.xy * 2.0 * (width + blur), 0.0, 1.0) + originOffset;
 
     SimpleLineVertexOut out {
         .position = vpMatrix * extendedPosition,
         .stylingIndex = styleIndex,
-        .lineSide = vertexIn.lineSide,
+        .lineSide = vertexIn.extrudeSide.w,
     };
 
     return out;
@@ -167,22 +164,22 @@ unitSphereLineGroupVertexShader(const LineVertexUnitSphereIn vertexIn [[stage_in
                       constant float &scalingFactor [[buffer(2)]],
                       constant half *styling [[buffer(3)]],
                       constant float4 &originOffset [[buffer(4)]],
-                      constant float4 &tileOrigin [[buffer(5)]])
+                      constant float4 &tileOrigin [[buffer(5)]]) // w: scale of the positions
 {
-    int styleIndex = (int(vertexIn.stylingIndex) & 0xFF) * 23;
+    int styleIndex = (int(vertexIn.lengthCorrectionStyle.y) & 0xFF) * 23;
     constant LineStyling *style = (constant LineStyling *)(styling + styleIndex);
 
     // extend position in extrude direction by width / 2.0
     const float width = style->width / 2.0 * scalingFactor;
     const float blur = max(blurRadiusPx, (float)style->blur) * scalingFactor;
 
-    const float4 extendedPosition = float4(vertexIn.position + vertexIn.extrude * (width + blur), 1.0)  + originOffset;
+    const float4 extendedPosition = float4(vertexIn.position * tileOrigin.w + vertexIn.extrudeSide.xyz * 2.0 * (width + blur), 1.0)  + originOffset;
 
     LineVertexOut out {
         .position = vpMatrix * extendedPosition,
         .stylingIndex = styleIndex,
-        .lineSide = vertexIn.lineSide,
-        .lengthPrefix = vertexIn.lengthPrefix + vertexIn.lengthCorrection * width,
+        .lineSide = vertexIn.extrudeSide.w,
+        .lengthPrefix = vertexIn.lengthPrefix + vertexIn.lengthCorrectionStyle.x * width,
     };
 
     return out;
@@ -194,22 +191,22 @@ lineGroupVertexShader(const LineVertexIn vertexIn [[stage_in]],
                       constant float &scalingFactor [[buffer(2)]],
                       constant half *styling [[buffer(3)]],
                       constant float4 &originOffset [[buffer(4)]],
-                      constant float4 &tileOrigin [[buffer(5)]])
+                      constant float4 &tileOrigin [[buffer(5)]]) // w: scale of the positions
 {
-    int styleIndex = (int(vertexIn.stylingIndex) & 0xFF) * 23;
+    int styleIndex = (int(vertexIn.lengthCorrectionStyle.y) & 0xFF) * 23;
     constant LineStyling *style = (constant LineStyling *)(styling + styleIndex);
 
     // extend position in extrude direction by width / 2.0
     const float width = style->width / 2.0 * scalingFactor;
     const float blur = max(blurRadiusPx, (float)style->blur) * scalingFactor;
 
-    const float4 extendedPosition = float4(vertexIn.position + vertexIn.extrude * (width + blur), 0.0, 1.0) + originOffset;
+    const float4 extendedPosition = float4(vertexIn.position * tileOrigin.w + vertexIn.extrudeSide.xy * 2.0 * (width + blur), 0.0, 1.0) + originOffset;
 
     LineVertexOut out {
         .position = vpMatrix * extendedPosition,
         .stylingIndex = styleIndex,
-        .lineSide = vertexIn.lineSide,
-        .lengthPrefix = vertexIn.lengthPrefix + vertexIn.lengthCorrection * width,
+        .lineSide = vertexIn.extrudeSide.w,
+        .lengthPrefix = vertexIn.lengthPrefix + vertexIn.lengthCorrectionStyle.x * width,
     };
 
     return out;
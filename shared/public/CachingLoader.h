@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "DataLoaderResult.h"
+#include "LoaderInterface.h"
+#include "TextureLoaderResult.h"
+#include "TilePackFile.h"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+/**
+ * Caches the data loaded by another loader persistently in a TilePackFile, for platforms without an http cache of
+ * their own (e.g. Linux and WASM).
+ *
+ * Entries younger than maxAgeMillis are returned without asking the loader, the future is ready immediately. Older
+ * entries are revalidated: the loader is asked with the stored etag and is expected to answer with status OK and
+ * without data (or with the same etag) if the data did not change. If the loader can not be reached, the stored data is
+ * returned. Tiles the loader does not find anymore (400 / 404) are removed.
+ *
+ * Texture requests are passed on, the data of textures is only available as decoded TextureHolderInterface.
+ */
+class CachingLoader : public LoaderInterface {
+  public:
+    // Pass on all requests without caching if the pack file can not be opened
+    CachingLoader(const std::shared_ptr<LoaderInterface> &loader, const std::string &packFilePath, int64_t maxSizeBytes,
+                  int64_t maxAgeMillis);
+
+    CachingLoader(const std::shared_ptr<LoaderInterface> &loader, const std::shared_ptr<TilePackFile> &packFile, int64_t maxAgeMillis);
+
+    TextureLoaderResult loadTexture(const std::string &url, const std::optional<std::string> &etag) override;
+
+    DataLoaderResult loadData(const std::string &url, const std::optional<std::string> &etag) override;
+
+    ::djinni::Future<TextureLoaderResult> loadTextureAsync(const std::string &url, const std::optional<std::string> &etag) override;
+
+    ::djinni::Future<DataLoaderResult> loadDataAsync(const std::string &url, const std::optional<std::string> &etag) override;
+
+    void cancel(const std::string &url) override;
+
+  private:
+    static DataLoaderResult handleResult(const std::shared_ptr<TilePackFile> &packFile, const std::string &url,
+                                         std::optional<TilePackFile::Tile> cached, DataLoaderResult result);
+
+    static DataLoaderResult toResult(TilePackFile::Tile tile);
+
+    bool isFresh(const TilePackFile::Tile &tile) const;
+
+    const std::shared_ptr<LoaderInterface> loader;
+    const std::shared_ptr<TilePackFile> packFile;
+    const int64_t maxAgeMillis;
+};
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "DataLoaderResult.h"
+#include "LoaderInterface.h"
+#include "TextureLoaderResult.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Deduplicates concurrent data requests for the same url and etag, e.g. when several layers of a style use the same
+ * source. Each source wraps its loaders (see wrap), the wrappers of the same loader share a table of the requests in
+ * flight: the first request is passed on to the loader, the others wait for its result.
+ *
+ * A cancel only affects one request of the wrapper it is called on. The request is cancelled on the loader once
+ * no wrapper is waiting for it anymore, otherwise the cancelled requests still get the result.
+ *
+ * Texture requests and synchronous requests are passed on as they are, texture holders can not be shared between
+ * layers.
+ */
+class CoalescingLoader : public LoaderInterface {
+  public:
+    CoalescingLoader(const std::shared_ptr<LoaderInterface> &loader);
+
+    static std::vector<std::shared_ptr<LoaderInterface>> wrap(const std::vector<std::shared_ptr<LoaderInterface>> &loaders);
+
+    TextureLoaderResult loadTexture(const std::string &url, const std::optional<std::string> &etag) override;
+
+    DataLoaderResult loadData(const std::string &url, const std::optional<std::string> &etag) override;
+
+    ::djinni::Future<TextureLoaderResult> loadTextureAsync(const std::string &url, const std::optional<std::string> &etag) override;
+
+    ::djinni::Future<DataLoaderResult> loadDataAsync(const std::string &url, const std::optional<std::string> &etag) override;
+
+    void cancel(const std::string &url) override;
+
+    // Number of requests that did not reach the loader as they were answered by a request in flight
+    int64_t getNumCoalesced();
+
+  private:
+    struct Request {
+        std::string url;
+        std::vector<std::shared_ptr<::djinni::Promise<DataLoaderResult>>> promises;
+        // number of requests per wrapper that were not cancelled
+        std::unordered_map<uint64_t, size_t> active;
+    };
+
+    // Requests in flight on one loader, shared by all its wrappers
+    struct RequestTable {
+        std::mutex mutex;
+        std::unordered_map<std::string, std::shared_ptr<Request>> requests;
+        int64_t numCoalesced = 0;
+    };
+
+    static std::shared_ptr<RequestTable> getRequestTable(const std::shared_ptr<LoaderInterface> &loader);
+
+    static std::string createKey(const std::string &url, const std::optional<std::string> &etag);
+
+    const std::shared_ptr<LoaderInterface> loader;
+    const std::shared_ptr<RequestTable> requestTable;
+    const uint64_t id;
+};
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * Coverage bitmap and metrics of a single glyph, in pixels of the rasterized font size.
+ */
+struct RasterizedGlyph {
+    int32_t width = 0;
+    int32_t height = 0;
+    // width * height values, 0 outside and 255 inside the glyph
+    std::vector<uint8_t> coverage;
+    double advance = 0.0;
+    // from the pen position to the left edge of the bitmap
+    double bearingX = 0.0;
+    // from the baseline up to the top edge of the bitmap
+    double bearingY = 0.0;
+};
+
+/**
+ * Rasterizes glyphs of a font file (e.g. a TrueType or OpenType font) for the SdfGlyphAtlas. Implementations are
+ * called concurrently from several threads.
+ */
+class GlyphRasterizerInterface {
+  public:
+    virtual ~GlyphRasterizerInterface() = default;
+
+    // Returns nullopt if the font has no glyph for the character (a single utf-8 encoded codepoint)
+    virtual std::optional<RasterizedGlyph> rasterize(const std::string &charCode, double fontSize) = 0;
+};
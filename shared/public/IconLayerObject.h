@@ -26,17 +26,30 @@
 #include "AnimationInterface.h"
 #include "Quad3dD.h"
 #include "IconInfoInterface.h"
+#include "TextureHolderInterface.h"
+#include "VectorModificationWrapper.h"
 
+/**
+ * Icons sharing a texture and blend mode, drawn as the instances of one instanced quad. The icons to draw are collected
+ * with addInstance() before each update(), which only sends the instance values that changed since the last update.
+ */
 class IconLayerObject : public LayerObjectInterface, public std::enable_shared_from_this<IconLayerObject> {
   public:
     IconLayerObject(std::shared_ptr<Quad2dInstancedInterface> quad,
-                          const std::shared_ptr<IconInfoInterface> &icon,
+                          const std::shared_ptr<TextureHolderInterface> &texture,
                           const std::shared_ptr<AlphaInstancedShaderInterface> &shader,
                           const std::shared_ptr<MapInterface> &mapInterface,
+                          const Coord &originCoordinate,
                           bool is3d = false);
 
     virtual ~IconLayerObject() override {}
 
+    void clearInstances();
+
+    void addInstance(const std::shared_ptr<IconInfoInterface> &icon);
+
+    size_t getInstanceCount() const;
+
     virtual void update() override;
 
     virtual std::vector<std::shared_ptr<RenderConfigInterface>> getRenderConfig() override;
@@ -56,19 +69,21 @@ class IconLayerObject : public LayerObjectInterface, public std::enable_shared_f
     void beginAlphaAnimation(double startAlpha, double targetAlpha, int64_t duration);
 
   private:
-    std::shared_ptr<IconInfoInterface> icon;
-    
+    std::vector<std::shared_ptr<IconInfoInterface>> instanceIcons;
+
     std::shared_ptr<Quad2dInstancedInterface> quad;
     std::shared_ptr<AlphaInstancedShaderInterface> shader;
     std::shared_ptr<GraphicsObjectInterface> graphicsObject;
     std::shared_ptr<RenderObjectInterface> renderObject;
 
-    std::vector<float> iconPositions;
-    std::vector<float> iconScales;
-    std::vector<float> iconRotations;
-    std::vector<float> iconAlphas;
-    std::vector<float> iconOffsets;
-    std::vector<float> iconTextureCoordinates;
+    int32_t instanceCount = 0;
+    float alpha = 1.0;
+    VectorModificationWrapper<float> iconPositions;
+    VectorModificationWrapper<float> iconScales;
+    VectorModificationWrapper<float> iconRotations;
+    VectorModificationWrapper<float> iconAlphas;
+    VectorModificationWrapper<float> iconOffsets;
+    VectorModificationWrapper<float> iconTextureCoordinates;
     std::shared_ptr<TextureHolderInterface> texture;
 
     std::shared_ptr<RenderConfig> renderConfig;
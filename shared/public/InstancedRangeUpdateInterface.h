@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "SharedBytes.h"
+#include "VectorModificationWrapper.h"
+#include <algorithm>
+#include <cstdint>
+
+// Instanced graphics objects (Quad2dInstancedInterface, TextInstancedInterface) implementing this interface can replace
+// the values of a range of instances instead of all instances of an attribute
+class InstancedRangeUpdateInterface {
+  public:
+    enum class Attribute { POSITIONS, REFERENCE_POSITIONS, SCALES, ROTATIONS, ALPHAS, TEXTURE_COORDINATES, POSITION_OFFSETS, STYLE_INDICES };
+
+    virtual ~InstancedRangeUpdateInterface() = default;
+
+    /**
+     * Replaces the values of the instances [firstInstance, firstInstance + values.elementCount). Returns false if the
+     * range could not be written (unknown attribute, range outside of the instances, attribute never set completely),
+     * the attribute has to be set with the regular setter in this case.
+     */
+    virtual bool setInstanceRange(Attribute attribute, const ::SharedBytes &values, int32_t firstInstance) = 0;
+};
+
+// Sends the instances modified since the last upload to the graphics object: only the modified range if the object supports
+// range updates, all instances otherwise. Returns the number of bytes sent.
+template <typename T, typename Setter>
+size_t uploadModifiedInstances(VectorModificationWrapper<T> &values, int32_t numComponents, int32_t instanceCount,
+                               InstancedRangeUpdateInterface *rangeObject, InstancedRangeUpdateInterface::Attribute attribute,
+                               const Setter &setAll) {
+    if (!values.wasModified()) {
+        return 0;
+    }
+    const auto [modifiedBegin, modifiedEnd] = values.getModifiedRange();
+    values.resetModificationFlag();
+
+    const int32_t bytesPerInstance = numComponents * (int32_t) sizeof(T);
+    const int32_t firstInstance = (int32_t) (modifiedBegin / numComponents);
+    const int32_t endInstance = std::min(instanceCount, (int32_t) ((modifiedEnd + numComponents - 1) / numComponents));
+    if (rangeObject && firstInstance < endInstance && endInstance - firstInstance < instanceCount) {
+        const int32_t count = endInstance - firstInstance;
+        if (rangeObject->setInstanceRange(attribute, SharedBytes((int64_t) (values.data() + firstInstance * numComponents), count, bytesPerInstance),
+                                          firstInstance)) {
+            return (size_t) count * bytesPerInstance;
+        }
+    }
+    setAll(SharedBytes((int64_t) values.data(), instanceCount, bytesPerInstance));
+    return (size_t) instanceCount * bytesPerInstance;
+}
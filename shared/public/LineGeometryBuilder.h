@@ -5,24 +5,190 @@
 //  Created by Nicolas Märki on 26.05.2025.
 //
 
+#pragma once
+
 #include "Vec3DHelper.h"
 #include "LineGroup2dInterface.h"
 #include "LineCapType.h"
 #include "LineJoinType.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
 
 class LineGeometryBuilder {
   public:
     static void buildLines(const std::shared_ptr<LineGroup2dInterface> &line,
                            const std::vector<std::tuple<std::vector<Vec3D>, int>> &lines, const Vec3D &origin, LineCapType capType,
                            LineJoinType defaultJoinType, bool is3d, bool optimizeForDots) {
+        std::vector<float> lineAttributes;
+        std::vector<uint32_t> lineIndices;
+        buildLineGeometry(lines, origin, capType, defaultJoinType, is3d, optimizeForDots, lineAttributes, lineIndices);
+
+        setLineGeometry(line, lineAttributes, lineIndices, origin, is3d);
+    }
+
+    // Packs the vertex attributes and uploads them with the indices, with 16bit indices whenever the vertices allow it
+    static void setLineGeometry(const std::shared_ptr<LineGroup2dInterface> &line, const std::vector<float> &lineAttributes,
+                                const std::vector<uint32_t> &lineIndices, const Vec3D &origin, bool is3d) {
+        const auto packed = packLineVertices(lineAttributes, origin, is3d);
+        auto attributes = SharedBytes((int64_t)packed.vertices.data(), (int32_t)(packed.vertices.size() / getPackedVertexSize(is3d)),
+                                      (int32_t)getPackedVertexSize(is3d));
+
+        if (lineAttributes.size() / getNumAttributesPerVertex(is3d) <= maxShortIndexVertexCount) {
+            std::vector<uint16_t> shortIndices(lineIndices.begin(), lineIndices.end());
+            auto indices = SharedBytes((int64_t)shortIndices.data(), (int32_t)shortIndices.size(), (int32_t)sizeof(uint16_t));
+            line->setLines(attributes, indices, packed.origin, packed.positionScale, is3d);
+        } else {
+            auto indices = SharedBytes((int64_t)lineIndices.data(), (int32_t)lineIndices.size(), (int32_t)sizeof(uint32_t));
+            line->setLines(attributes, indices, packed.origin, packed.positionScale, is3d);
+        }
+    }
+
+    /*
+     * Vertices as uploaded to the line groups, 16 bytes per vertex in 2D and 20 bytes in 3D:
+     *  - position: normalized int16 x, y (and z and padding in 3D), relative to the origin and multiplied by positionScale
+     *  - extrude and side: normalized int8 x / 2, y / 2, z / 2 and side, the scaled extrude is at most 2 long
+     *  - length prefix: float, half floats are too coarse for the dash pattern of long lines
+     *  - length correction and style index: half floats, the style indices are exact up to 2048
+     */
+    struct PackedLineVertices {
+        std::vector<uint8_t> vertices;
+        Vec3D origin = Vec3D(0, 0, 0);
+        float positionScale = 1.0;
+    };
+
+    static size_t getPackedVertexSize(bool is3d) { return is3d ? 20 : 16; }
+
+    // Packs the attributes of buildLineGeometry. The positions are centered in their bounding box, whose center is added to
+    // the origin, so that the quantization error is at most 1/65534 of the extent of the geometry.
+    static PackedLineVertices packLineVertices(const std::vector<float> &lineAttributes, const Vec3D &origin, bool is3d) {
+        const size_t numAttributes = getNumAttributesPerVertex(is3d);
+        const size_t dimensions = is3d ? 3 : 2;
+        const size_t numVertices = lineAttributes.size() / numAttributes;
+
+        double min[3] = {0, 0, 0};
+        double max[3] = {0, 0, 0};
+        for (size_t v = 0; v < numVertices; ++v) {
+            for (size_t d = 0; d < dimensions; ++d) {
+                const double value = lineAttributes[v * numAttributes + d];
+                min[d] = v == 0 ? value : std::min(min[d], value);
+                max[d] = v == 0 ? value : std::max(max[d], value);
+            }
+        }
+        const double center[3] = {(min[0] + max[0]) / 2, (min[1] + max[1]) / 2, (min[2] + max[2]) / 2};
+        double extent = 0;
+        for (size_t d = 0; d < dimensions; ++d) {
+            extent = std::max(extent, (max[d] - min[d]) / 2);
+        }
+
+        PackedLineVertices packed;
+        packed.origin = Vec3D(origin.x + center[0], origin.y + center[1], origin.z + center[2]);
+        packed.positionScale = extent > 0 ? (float)extent : 1.0f;
+        packed.vertices.resize(numVertices * getPackedVertexSize(is3d));
+
+        uint8_t *out = packed.vertices.data();
+        for (size_t v = 0; v < numVertices; ++v) {
+            const float *in = &lineAttributes[v * numAttributes];
+            int16_t position[4] = {0, 0, 0, 0};
+            for (size_t d = 0; d < dimensions; ++d) {
+                position[d] = (int16_t)toNormalized(((double)in[d] - center[d]) / packed.positionScale, 32767);
+            }
+            std::memcpy(out, position, dimensions == 3 ? 8 : 4);
+            out += dimensions == 3 ? 8 : 4;
+
+            const int8_t extrudeSide[4] = {(int8_t)toNormalized(in[dimensions] / 2.0, 127),
+                                           (int8_t)toNormalized(in[dimensions + 1] / 2.0, 127),
+                                           (int8_t)(is3d ? toNormalized(in[dimensions + 2] / 2.0, 127) : 0),
+                                           (int8_t)toNormalized(in[2 * dimensions], 127)};
+            std::memcpy(out, extrudeSide, 4);
+            out += 4;
+
+            std::memcpy(out, &in[2 * dimensions + 1], sizeof(float));
+            out += sizeof(float);
+
+            const uint16_t correctionStyle[2] = {toHalfFloat(in[2 * dimensions + 2]), toHalfFloat(in[2 * dimensions + 3])};
+            std::memcpy(out, correctionStyle, 4);
+            out += 4;
+        }
+        return packed;
+    }
+
+    // IEEE 754 half float of value, rounded to the nearest
+    static uint16_t toHalfFloat(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+        const int32_t exponent = (int32_t)((bits >> 23) & 0xFF) - 127 + 15;
+        uint32_t mantissa = bits & 0x7FFFFF;
+        if (exponent >= 31) {
+            return sign | 0x7C00;
+        }
+        if (exponent <= 0) {
+            // subnormal
+            if (exponent < -10) {
+                return sign;
+            }
+            mantissa |= 0x800000;
+            const int32_t shift = 14 - exponent;
+            return sign | (uint16_t)((mantissa >> shift) + ((mantissa >> (shift - 1)) & 1));
+        }
+        // a rounding carry correctly continues into the exponent
+        return sign | (uint16_t)(((uint32_t)exponent << 10 | (mantissa >> 13)) + ((mantissa >> 12) & 1));
+    }
+
+    struct LineGeometryPart {
+        std::vector<float> lineAttributes;
+        std::vector<uint32_t> lineIndices;
+    };
+
+    // Builds the geometry in parts of at most maxVertexCount vertices. The vertex count estimate is only a fit, parts
+    // which turn out too large are built again from half of their lines, a single line is split at its middle point.
+    static void buildLineGeometryParts(const std::vector<std::tuple<std::vector<Vec3D>, int>> &lines, const Vec3D &origin,
+                                       LineCapType capType, LineJoinType defaultJoinType, bool is3d, bool optimizeForDots,
+                                       size_t maxVertexCount, std::vector<LineGeometryPart> &parts) {
+        LineGeometryPart part;
+        buildLineGeometry(lines, origin, capType, defaultJoinType, is3d, optimizeForDots, part.lineAttributes, part.lineIndices);
+        if (part.lineAttributes.size() / getNumAttributesPerVertex(is3d) <= maxVertexCount) {
+            if (!part.lineIndices.empty()) {
+                parts.push_back(std::move(part));
+            }
+            return;
+        }
+
+        if (lines.size() > 1) {
+            const auto middle = lines.begin() + lines.size() / 2;
+            using Lines = std::vector<std::tuple<std::vector<Vec3D>, int>>;
+            buildLineGeometryParts(Lines(lines.begin(), middle), origin, capType, defaultJoinType, is3d, optimizeForDots, maxVertexCount, parts);
+            buildLineGeometryParts(Lines(middle, lines.end()), origin, capType, defaultJoinType, is3d, optimizeForDots, maxVertexCount, parts);
+            return;
+        }
+
+        const auto &[coordinates, styleIndex] = lines.front();
+        if (coordinates.size() <= 2) {
+            parts.push_back(std::move(part));
+            return;
+        }
+        // both halves contain the middle point
+        const auto middle = coordinates.begin() + coordinates.size() / 2;
+        buildLineGeometryParts({{std::vector<Vec3D>(coordinates.begin(), middle + 1), styleIndex}}, origin, capType, defaultJoinType, is3d,
+                               optimizeForDots, maxVertexCount, parts);
+        buildLineGeometryParts({{std::vector<Vec3D>(middle, coordinates.end()), styleIndex}}, origin, capType, defaultJoinType, is3d,
+                               optimizeForDots, maxVertexCount, parts);
+    }
+
+    // Builds the vertex attributes and indices, packLineVertices converts the attributes to the vertices of LineGroup2dInterface::setLines
+    static void buildLineGeometry(const std::vector<std::tuple<std::vector<Vec3D>, int>> &lines, const Vec3D &origin, LineCapType capType,
+                                  LineJoinType defaultJoinType, bool is3d, bool optimizeForDots,
+                                  std::vector<float> &lineAttributes, std::vector<uint32_t> &lineIndices) {
 
         if (optimizeForDots) {
             defaultJoinType = LineJoinType::ROUND; // Force miter join for dot optimization
             capType = LineCapType::ROUND; // Force round cap for dot optimization
         }
 
-        std::vector<float> lineAttributes;
-        std::vector<uint32_t> lineIndices;
         reserveEstimatedNumVertices(lines, defaultJoinType, capType, is3d, lineAttributes, lineIndices);
 
         uint32_t vertexCount = 0;
@@ -294,10 +460,6 @@ class LineGeometryBuilder {
 
             }
         }
-
-        auto attributes = SharedBytes((int64_t)lineAttributes.data(), (int32_t)lineAttributes.size(), (int32_t)sizeof(float));
-        auto indices = SharedBytes((int64_t)lineIndices.data(), (int32_t)lineIndices.size(), (int32_t)sizeof(uint32_t));
-        line->setLines(attributes, indices, origin, is3d);
     }
 
     static void pushLineVertex(const Vec3D &p, const Vec3D &extrude, const float extrudeScale, const float side,
@@ -349,11 +511,20 @@ class LineGeometryBuilder {
         return countCoordinates * numVertexPointFactor + numVertexOffset + capVertices;
     }
 
+    // position, extrude, side, length prefix, length correction, style index
+    static size_t getNumAttributesPerVertex(bool is3d) { return is3d ? 10 : 8; }
+
+    static constexpr size_t maxShortIndexVertexCount = std::numeric_limits<uint16_t>::max();
+
     static uint64_t getMaxNumLineCoordsForVertexLimit(const uint64_t vertexLimit, const uint64_t capVertices = roundCapVertexCount) {
         return (vertexLimit - capVertices - numVertexOffset) / numVertexPointFactor;
     }
 
   private:
+    static int32_t toNormalized(double value, int32_t maxValue) {
+        return (int32_t)std::lround(std::clamp(value, -1.0, 1.0) * maxValue);
+    }
+
     // Empirical values: simple linear fit for observed number of vertices and triangles,
     // biased to lightly overestimate -- slightly too large reservation is less wasted memory
     // than slightly understimating and then doubling it.
@@ -382,8 +553,7 @@ class LineGeometryBuilder {
             numTriangles += numPoints*numTrianglePointFactor + numTriangleOffset + capTriangles;
         }
 
-        size_t numAttributesPerVertex = is3d ? 9 : 7;
-        lineAttributes.reserve(numVertices * numAttributesPerVertex);
+        lineAttributes.reserve(numVertices * getNumAttributesPerVertex(is3d));
         lineIndices.reserve(numTriangles * 3);
     }
 };
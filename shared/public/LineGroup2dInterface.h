@@ -13,7 +13,7 @@ class LineGroup2dInterface {
 public:
     virtual ~LineGroup2dInterface() = default;
 
-    virtual void setLines(const ::SharedBytes & lines, const ::SharedBytes & indices, const ::Vec3D & origin, bool is3d) = 0;
+    virtual void setLines(const ::SharedBytes & lines, const ::SharedBytes & indices, const ::Vec3D & origin, float positionScale, bool is3d) = 0;
 
     virtual /*not-null*/ std::shared_ptr<GraphicsObjectInterface> asGraphicsObject() = 0;
 };
@@ -39,6 +39,10 @@ class LineGroup2dLayerObject : public LayerObjectInterface {
 
     void setScalingFactor(float factor);
 
+    static std::vector<std::tuple<std::vector<Vec3D>, int>> convertToRenderCoordinates(const std::shared_ptr<CoordinateConversionHelperInterface> &conversionHelper,
+                                                                                       const std::vector<std::tuple<std::vector<Vec2D>, int>> &lines,
+                                                                                       const int32_t systemIdentifier, const Vec3D &origin, bool is3d);
+
     std::shared_ptr<GraphicsObjectInterface> getLineObject();
 
     std::shared_ptr<ShaderProgramInterface> getShaderProgram();
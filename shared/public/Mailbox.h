@@ -16,6 +16,7 @@
 #include "SchedulerInterface.h"
 #include <cassert>
 #include <deque>
+#include <functional>
 #include <future>
 #include <mutex>
 #include <memory>
@@ -219,6 +220,23 @@ public:
         }
 
         receivingMutex.unlock();
+
+        if (wasEmpty) {
+            std::function<void()> listener;
+            {
+                std::lock_guard<std::mutex> listenerLock(emptyListenerMutex);
+                listener = emptyListener;
+            }
+            if (listener && isEmpty()) {
+                listener();
+            }
+        }
+    }
+
+    // Called after a message was processed and no further messages are queued
+    void setEmptyListener(std::function<void()> listener) {
+        std::lock_guard<std::mutex> listenerLock(emptyListenerMutex);
+        emptyListener = std::move(listener);
     }
 
     bool isEmpty() {
@@ -256,4 +274,7 @@ private:
     std::deque<std::unique_ptr<MailboxMessage>> computationQueue;
     std::mutex graphicsQueueMutex;
     std::deque<std::unique_ptr<MailboxMessage>> graphicsQueue;
+
+    std::mutex emptyListenerMutex;
+    std::function<void()> emptyListener;
 };
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "Coord.h"
+#include "Vec3D.h"
+#include <vector>
+
+/**
+ * State of the camera at one update, as passed to MapCameraListenerInterface::onCameraChange. The camera publishes
+ * one immutable snapshot per update (std::shared_ptr<const MapCameraState>), listeners and tile sources share it
+ * instead of copying the matrices.
+ */
+struct MapCameraState {
+    std::vector<float> viewMatrix;
+    std::vector<float> projectionMatrix;
+    Vec3D origin;
+    float verticalFov;
+    float horizontalFov;
+    float width;
+    float height;
+    float focusPointAltitude;
+    Coord focusPointPosition;
+    float zoom = 0.0;
+
+    bool operator==(const MapCameraState &o) const {
+        return viewMatrix == o.viewMatrix && projectionMatrix == o.projectionMatrix && origin.x == o.origin.x &&
+               origin.y == o.origin.y && origin.z == o.origin.z && verticalFov == o.verticalFov && horizontalFov == o.horizontalFov &&
+               width == o.width && height == o.height && focusPointAltitude == o.focusPointAltitude &&
+               focusPointPosition == o.focusPointPosition && zoom == o.zoom;
+    }
+};
@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "MapCameraState.h"
+#include <memory>
+
+// Camera listeners implementing this interface get the camera state snapshot instead of
+// MapCameraListenerInterface::onCameraChange
+class MapCameraStateListenerInterface {
+  public:
+    virtual ~MapCameraStateListenerInterface() = default;
+
+    virtual void onCameraStateChanged(const std::shared_ptr<const MapCameraState> &cameraState) = 0;
+};
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Read-only access to a PMTiles (version 3) archive, memory-mapped from a local file.
+ *
+ * The root directory is parsed on opening, leaf directories are parsed on demand and kept in a small LRU cache.
+ * Gzip compressed directories and tiles are only supported if the library is built with zlib (MAPSCORE_WITH_ZLIB).
+ */
+class PMTilesArchive {
+  public:
+    enum class Compression : uint8_t { UNKNOWN = 0, NONE = 1, GZIP = 2, BROTLI = 3, ZSTD = 4 };
+
+    enum class TileType : uint8_t { UNKNOWN = 0, MVT = 1, PNG = 2, JPEG = 3, WEBP = 4, AVIF = 5 };
+
+    struct Header {
+        uint64_t rootDirectoryOffset;
+        uint64_t rootDirectoryLength;
+        uint64_t metadataOffset;
+        uint64_t metadataLength;
+        uint64_t leafDirectoriesOffset;
+        uint64_t leafDirectoriesLength;
+        uint64_t tileDataOffset;
+        uint64_t tileDataLength;
+        Compression internalCompression;
+        Compression tileCompression;
+        TileType tileType;
+        uint8_t minZoom;
+        uint8_t maxZoom;
+    };
+
+    // Points into the mapped archive, valid as long as the archive is alive
+    struct TileData {
+        const uint8_t *data;
+        size_t size;
+    };
+
+    static constexpr size_t headerSize = 127;
+
+    // Returns nullptr if the file can not be mapped or is not a valid PMTiles v3 archive
+    static std::shared_ptr<PMTilesArchive> open(const std::string &path);
+
+    ~PMTilesArchive();
+
+    PMTilesArchive(const PMTilesArchive &) = delete;
+
+    PMTilesArchive &operator=(const PMTilesArchive &) = delete;
+
+    const Header &getHeader() const { return header; }
+
+    // Tile as stored in the archive, i.e. compressed with getHeader().tileCompression
+    std::optional<TileData> getTile(uint8_t z, uint32_t x, uint32_t y);
+
+    static std::optional<Header> parseHeader(const uint8_t *data, size_t size);
+
+    // Position of a tile on the Hilbert curve of its zoom level, offset by the number of tiles of all lower zoom levels
+    static uint64_t zxyToTileId(uint8_t z, uint32_t x, uint32_t y);
+
+    // Largest decompressed tile or directory, larger data is treated as corrupt
+    static constexpr size_t maxDecompressedSize = 64 * 1024 * 1024;
+
+    static std::optional<std::vector<uint8_t>> decompress(const uint8_t *data, size_t size, Compression compression,
+                                                          size_t maxSize = maxDecompressedSize);
+
+  private:
+    struct Entry {
+        uint64_t tileId;
+        uint64_t offset;
+        uint32_t length;
+        // 0 for entries pointing to a leaf directory
+        uint32_t runLength;
+    };
+
+    using Directory = std::vector<Entry>;
+
+    PMTilesArchive(const uint8_t *data, size_t size, const Header &header);
+
+    std::shared_ptr<const Directory> readDirectory(uint64_t offset, uint64_t length);
+
+    std::shared_ptr<const Directory> getLeafDirectory(uint64_t offset, uint64_t length);
+
+    static std::optional<Directory> parseDirectory(const uint8_t *data, size_t size);
+
+    // Whether [offset, offset + length) lies within size bytes, without overflowing for values read from the file
+    static bool isInRange(uint64_t offset, uint64_t length, uint64_t size) { return offset <= size && length <= size - offset; }
+
+    static constexpr size_t maxCachedLeafDirectories = 64;
+    static constexpr int maxDirectoryDepth = 4;
+
+    const uint8_t *data;
+    const size_t size;
+    const Header header;
+
+    std::shared_ptr<const Directory> rootDirectory;
+
+    std::mutex leafCacheMutex;
+    std::list<uint64_t> leafCacheOrder;
+    std::unordered_map<uint64_t, std::pair<std::shared_ptr<const Directory>, std::list<uint64_t>::iterator>> leafCache;
+};
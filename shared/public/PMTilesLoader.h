@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "LoaderInterface.h"
+#include "PMTilesArchive.h"
+#include "TextureHolderInterface.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Serves tiles from local PMTiles archives. Urls have the form pmtiles://<path of archive>/{z}/{x}/{y}, with an
+ * optional file extension, as formatted by Tiled2dMapLayerConfig::getTileUrl from a source url template like
+ * "pmtiles:///data/tiles.pmtiles/{z}/{x}/{y}.pbf". Other urls are answered with LoaderStatus::NOOP, such that the
+ * next loader is used.
+ *
+ * Archives are opened (memory-mapped) once on first use and kept open. Compressed tiles are decompressed before
+ * they are returned. Raster tiles need a textureDecoder, as there is no platform independent image decoder.
+ */
+class PMTilesLoader : public LoaderInterface {
+  public:
+    using TextureDecoder = std::function<std::shared_ptr<TextureHolderInterface>(const uint8_t *data, size_t size)>;
+
+    PMTilesLoader(TextureDecoder textureDecoder = nullptr);
+
+    TextureLoaderResult loadTexture(const std::string &url, const std::optional<std::string> &etag) override;
+
+    DataLoaderResult loadData(const std::string &url, const std::optional<std::string> &etag) override;
+
+    ::djinni::Future<TextureLoaderResult> loadTextureAsync(const std::string &url, const std::optional<std::string> &etag) override;
+
+    ::djinni::Future<DataLoaderResult> loadDataAsync(const std::string &url, const std::optional<std::string> &etag) override;
+
+    void cancel(const std::string &url) override {}
+
+  private:
+    struct TileRequest {
+        std::string archivePath;
+        uint8_t z;
+        uint32_t x;
+        uint32_t y;
+    };
+
+    static std::optional<TileRequest> parseUrl(const std::string &url);
+
+    std::shared_ptr<PMTilesArchive> getArchive(const std::string &path);
+
+    const TextureDecoder textureDecoder;
+
+    std::mutex archivesMutex;
+    std::unordered_map<std::string, std::shared_ptr<PMTilesArchive>> archives;
+};
@@ -11,12 +11,14 @@
 #pragma once
 
 // Define ENABLE_PERF_LOGGING to enable performance logging, comment out to disable it
+// (or configure with -DENABLE_PERF_LOGGING=ON)
 //#define ENABLE_PERF_LOGGING
 
 #ifdef ENABLE_PERF_LOGGING
 
 #define PERF_LOG_START(key) PerformanceLogger::getInstance().startSection(key)
 #define PERF_LOG_END(key) PerformanceLogger::getInstance().endSection(key)
+#define PERF_LOG_COUNT(key, value) PerformanceLogger::getInstance().count(key, value)
 
 class PerformanceLogger {
 public:
@@ -37,6 +39,20 @@ public:
         log(key, duration);
     }
 
+    // Adds a sample to a counter (e.g. draw calls per frame), reported as total and average per sample
+    void count(const std::string& key, int64_t value) {
+        std::lock_guard<std::mutex> lock(global_map_mutex);
+        auto& counter = global_counters[key];
+        counter.first += value;
+        counter.second++;
+    }
+
+    int64_t getCount(const std::string& key) {
+        std::lock_guard<std::mutex> lock(global_map_mutex);
+        auto it = global_counters.find(key);
+        return it != global_counters.end() ? it->second.first : 0;
+    }
+
     void print_stats() {
         std::lock_guard<std::mutex> lock(global_map_mutex);
         LogDebug <<= "--------------------------";
@@ -48,6 +64,13 @@ public:
             const double average = count > 0 ? total / count : 0.0;
             LogDebug << pair.first << "," << total << "," << time_unit << "," << average << "," <<= time_unit;
         }
+        if (!global_counters.empty()) {
+            LogDebug <<= "Key,Total,Samples,Average"; // CSV header
+            for (const auto& [key, counter] : global_counters) {
+                const double average = counter.second > 0 ? double(counter.first) / counter.second : 0.0;
+                LogDebug << key << "," << counter.first << "," << counter.second << "," <<= average;
+            }
+        }
         LogDebug <<= "--------------------------";
     }
 
@@ -63,6 +86,7 @@ private:
 
     static thread_local ThreadLocalData local_data;
     std::unordered_map<std::string, std::pair<int64_t, int64_t>> global_map;
+    std::unordered_map<std::string, std::pair<int64_t, int64_t>> global_counters;
     std::mutex global_map_mutex;
     std::chrono::steady_clock::time_point last_print_time = std::chrono::steady_clock::now();
 
@@ -110,4 +134,5 @@ public:
 #else
     #define PERF_LOG_START(key)
     #define PERF_LOG_END(key)
+    #define PERF_LOG_COUNT(key, value) ((void)(value))
 #endif
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "FontLoaderInterface.h"
+#include "FontLoaderResult.h"
+#include "GlyphRasterizerInterface.h"
+#include "TextureHolderInterface.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class SdfGlyphAtlas;
+
+/**
+ * Font loader for TrueType and OpenType fonts, whose glyphs are rendered as signed distance fields on demand instead of
+ * being shipped as pre-rendered atlases with a fixed glyph set.
+ *
+ * Each font has an atlas that initially contains the printable ASCII characters. The vector layers add the glyphs of
+ * their labels with prepareGlyphs before laying them out, on their worker threads, and load the font again whenever
+ * glyphs were added. Every loaded FontLoaderResult is a snapshot with a texture of its own, labels laid out with an older
+ * snapshot keep using it.
+ */
+class SdfFontLoader : public FontLoaderInterface {
+  public:
+    // Creates the texture of an atlas from its single channel distance values, rows top-down. The text shaders take the
+    // median of the red, green and blue channel, so the values have to be uploaded to all three. As only some of the
+    // loaded snapshots are ever drawn, the upload should wait until the texture is attached to the graphics.
+    using TextureFactory =
+        std::function<std::shared_ptr<TextureHolderInterface>(int32_t width, int32_t height, std::vector<uint8_t> distances)>;
+
+    struct AtlasStatistics {
+        std::string fontName;
+        size_t numGlyphs;
+        size_t numMissingGlyphs;
+        int32_t width;
+        int32_t height;
+        size_t sizeBytes;
+        // area of the glyphs in relation to the area of the atlas
+        double occupancy;
+    };
+
+    // fontSize: size the glyphs are rasterized with, in pixels
+    explicit SdfFontLoader(TextureFactory createTexture, double fontSize = 24.0);
+
+    ~SdfFontLoader() override;
+
+    // Adds a font file with FreeType, returns false if it can not be opened or the library is built without FreeType
+    bool addFont(const std::string &fontName, const std::string &fontFilePath);
+
+    void addFont(const std::string &fontName, const std::shared_ptr<GlyphRasterizerInterface> &rasterizer);
+
+    // All glyphs added to the atlas of the font so far
+    FontLoaderResult loadFont(const Font &font) override;
+
+    // Adds the glyphs of the letters of text to the atlas of the font. Returns the version of the atlas, which changes
+    // whenever glyphs are added, or nullopt if the font is unknown. Thread-safe, the glyphs are rendered on the calling
+    // thread.
+    std::optional<uint64_t> prepareGlyphs(const std::string &fontName, const std::string &text);
+
+    std::vector<AtlasStatistics> getStatistics();
+
+  private:
+    std::shared_ptr<SdfGlyphAtlas> getAtlas(const std::string &fontName);
+
+    const TextureFactory createTexture;
+    const double fontSize;
+
+    std::mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<SdfGlyphAtlas>> atlases;
+};
@@ -19,6 +19,7 @@
 #include "SymbolAlignment.h"
 #include "Vec2DHelper.h"
 #include <optional>
+#include <string_view>
 
 struct BreakResult {
     BreakResult(int index, bool keepLetter) : index(index), keepLetter(keepLetter) {};
@@ -42,6 +43,7 @@ class TextHelper {
                                                              double maxCharacterAngle,
                                                              SymbolAlignment rotationAlignment);
 
+    // Uppercase of a UTF-8 string, invalid bytes are kept
     static std::string uppercase(const std::string &string);
 
     inline static Quad2dD rotateQuad2d(const Quad2dD &quad, const Vec2D &aroundPoint, double sinAngle, double cosAngle) {
@@ -51,12 +53,15 @@ class TextHelper {
                        Vec2DHelper::rotate(quad.bottomLeft, aroundPoint, sinAngle, cosAngle));
     }
 
+    // The letters of a UTF-8 string, see Utf8Letters to iterate them without allocating
     static std::vector<std::string> splitWstring(const std::string &word);
 
-    static std::vector<BreakResult> bestBreakIndices(std::vector<std::string> &letters, int64_t maxCharacterWidth);
+    // Line breaks for a text of at most maxCharacterWidth letters per line, results are cached for repeated texts
+    static std::vector<BreakResult> bestBreakIndices(const std::vector<std::string_view> &letters, int64_t maxCharacterWidth);
 
   private:
-    static std::vector<BreakResult> bestBreakIndicesSub(std::vector<std::string> &letters, int64_t maxCharacterWidth);
+    static void bestBreakIndicesSub(const std::vector<std::string_view> &letters, size_t begin, size_t end, int64_t maxCharacterWidth,
+                                    std::vector<BreakResult> &result);
 
   private:
     std::weak_ptr<MapInterface> mapInterface;
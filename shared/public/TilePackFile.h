@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Persistent key-value store for tile data in a single append-only file, read through a memory mapping.
+ *
+ * Each record holds the key (the tile url), the etag, the time it was stored and the data. New data for a key is
+ * appended, the index (key -> newest record) is rebuilt by scanning the record headers on opening; a partially written
+ * record at the end, e.g. after a crash, is cut off. Records are written in host byte order, the file is not meant to
+ * be moved between machines.
+ *
+ * Once the file grows beyond maxSize, it is compacted: the most recently used entries are rewritten into a new file
+ * until three quarters of maxSize are filled, older and superseded records are dropped. The usage order is only kept in
+ * memory, after reopening the file the entries are ordered by the time they were written.
+ */
+class TilePackFile {
+  public:
+    struct Tile {
+        std::vector<uint8_t> data;
+        std::optional<std::string> etag;
+        // milliseconds since epoch
+        int64_t storedAt;
+    };
+
+    // Returns nullptr if the file can not be created or mapped
+    static std::shared_ptr<TilePackFile> open(const std::string &path, int64_t maxSize);
+
+    ~TilePackFile();
+
+    TilePackFile(const TilePackFile &) = delete;
+
+    TilePackFile &operator=(const TilePackFile &) = delete;
+
+    std::optional<Tile> get(const std::string &key);
+
+    bool put(const std::string &key, const uint8_t *data, size_t size, const std::optional<std::string> &etag, int64_t storedAt);
+
+    // Updates the time an entry was stored, after it was revalidated
+    void touch(const std::string &key, int64_t storedAt);
+
+    void remove(const std::string &key);
+
+    size_t getNumEntries();
+
+    // Size of the file, including superseded records
+    int64_t getFileSize();
+
+  private:
+    struct RecordHeader {
+        uint32_t magic;
+        uint32_t keyLength;
+        // noEtag if the record has no etag
+        uint32_t etagLength;
+        // removedKey for records removing a key
+        uint32_t dataLength;
+        int64_t storedAt;
+    };
+
+    struct Entry {
+        uint64_t offset;
+        RecordHeader header;
+        uint64_t lastAccess;
+    };
+
+    static constexpr uint32_t fileMagic = 0x4b50544d; // "MTPK"
+    static constexpr uint32_t fileVersion = 1;
+    static constexpr size_t fileHeaderSize = 8;
+    static constexpr uint32_t recordMagic = 0x43525054; // "TPRC"
+    static constexpr uint32_t noEtag = UINT32_MAX;
+    static constexpr uint32_t removedKey = UINT32_MAX;
+
+    TilePackFile(const std::string &path, int64_t maxSize);
+
+    bool openFile(bool truncate);
+
+    void closeFile();
+
+    bool mapFile();
+
+    // Reads the records of the file into the index, returns false if the file is not a pack file
+    bool readIndex();
+
+    bool append(const RecordHeader &header, const std::string &key, const std::optional<std::string> &etag, const uint8_t *data);
+
+    void compact();
+
+    static size_t recordSize(const RecordHeader &header);
+
+    const std::string path;
+    const int64_t maxSize;
+
+    std::mutex mutex;
+    int fd = -1;
+    uint64_t fileSize = 0;
+    uint8_t *mapped = nullptr;
+    size_t mappedSize = 0;
+    std::unordered_map<std::string, Entry> index;
+    uint64_t accessCounter = 0;
+};
@@ -12,22 +12,36 @@
 
 #include "SimpleLayerInterface.h"
 #include "MapCameraListenerInterface.h"
+#include "MapCameraStateListenerInterface.h"
 #include "MapInterface.h"
 #include "RenderPassInterface.h"
 #include "Tiled2dMapLayerConfig.h"
 #include "Tiled2dMapSourceInterface.h"
+#include "Tiled2dMapSourcePrefetchInterface.h"
 #include "SimpleTouchInterface.h"
 #include "Actor.h"
 #include <mutex>
 
+class LayerReadyStateObserverInterface;
+
 class Tiled2dMapLayer : public SimpleLayerInterface,
                         public MapCameraListenerInterface,
+                        public MapCameraStateListenerInterface,
                         public std::enable_shared_from_this<Tiled2dMapLayer> {
   public:
     Tiled2dMapLayer();
 
     void setSourceInterfaces(const std::vector<WeakActor<Tiled2dMapSourceInterface>> &sourceInterfaces);
 
+    void setPrefetchSourceInterfaces(const std::vector<WeakActor<Tiled2dMapSourcePrefetchInterface>> &prefetchSourceInterfaces);
+
+    // Sources getting the camera state snapshots, see onCameraStateChanged
+    void setCameraStateSourceInterfaces(const std::vector<WeakActor<MapCameraStateListenerInterface>> &cameraStateSourceInterfaces);
+
+    // Opt-in: while the camera is moving (inertia, move or zoom animations), the tiles at the predicted camera target are
+    // loaded ahead with a low priority. Currently only supported with MapCamera2d.
+    void setPrefetchEnabled(bool enabled);
+
     virtual void update() override = 0;
 
     virtual std::vector<std::shared_ptr<::RenderPassInterface>> buildRenderPasses() override = 0;
@@ -71,11 +85,27 @@ class Tiled2dMapLayer : public SimpleLayerInterface,
     void onCameraChange(const std::vector<float> &viewMatrix, const std::vector<float> &projectionMatrix, const ::Vec3D & origin, float verticalFov,
                         float horizontalFov, float width, float height, float focusPointAltitude, const ::Coord & focusPointPosition, float zoom) override;
 
+    void onCameraStateChanged(const std::shared_ptr<const MapCameraState> &cameraState) override;
+
 protected:
+    void notifyReadyStateObserver();
+
+    // The ready state of the layer depends on the messages queued in the mailbox of a source or manager, the map is
+    // notified whenever it has been emptied
+    void observeReadyState(const std::shared_ptr<Mailbox> &mailbox);
+
+    // Forwards the bounds predicted by the camera (2D or 3D) to the prefetching sources
+    void updatePrefetchBounds(double zoom);
+
     std::shared_ptr<MapInterface> mapInterface;
+    std::weak_ptr<LayerReadyStateObserverInterface> readyStateObserver;
     std::shared_ptr< ::ErrorManager> errorManager;
     std::recursive_mutex sourcesMutex;
     std::vector<WeakActor<Tiled2dMapSourceInterface>> sourceInterfaces;
+    std::vector<WeakActor<Tiled2dMapSourcePrefetchInterface>> prefetchSourceInterfaces;
+    std::vector<WeakActor<MapCameraStateListenerInterface>> cameraStateSourceInterfaces;
+
+    bool prefetchEnabled = false;
 
     bool isHidden = false;
 
@@ -25,6 +25,7 @@
 #include <unordered_map>
 #include <map>
 #include <atomic>
+#include <functional>
 #include "Actor.h"
 #include "VectorSet.h"
 
@@ -107,6 +108,16 @@ public:
                                   
     void onTilesUpdated(const std::string &layerName, VectorSet<Tiled2dMapRasterTileInfo> currentTileInfos) override;
 
+    // Loads the next numFrames time steps ahead of setT for smooth playback of animated layers (numFrames 0 to disable),
+    // keeping at most memoryBudget bytes of decoded frames (0 for no limit)
+    void setTimeSeries(int32_t numFrames, int64_t memoryBudget);
+
+    // Called with the number of upcoming time steps that are loaded for all visible tiles, playback can advance without
+    // waiting while readyFrames > 0
+    void setTimeSeriesReadyListener(std::function<void(int32_t readyFrames, int32_t numFrames)> listener);
+
+    void onTimeSeriesReadyChanged(int32_t readyFrames, int32_t numFrames) override;
+
     virtual void setReadyStateListener(const /*not-null*/ std::shared_ptr<::Tiled2dMapReadyStateListener> & listener) override;
 
     void set3dSubdivisionFactor(int32_t factor) override;
@@ -156,6 +167,10 @@ protected:
     std::optional<LayerReadyState> lastReadyState;
     std::shared_ptr<::Tiled2dMapReadyStateListener> readyStateListener;
 
+    int32_t timeSeriesFrames = 0;
+    int64_t timeSeriesMemoryBudget = 0;
+    std::function<void(int32_t readyFrames, int32_t numFrames)> timeSeriesReadyListener;
+
 private:
     const static int32_t SUBDIVISION_FACTOR_3D_DEFAULT = 3;
 
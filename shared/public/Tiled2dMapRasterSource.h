@@ -43,6 +43,10 @@ class Tiled2dMapRasterSource
     virtual std::shared_ptr<::TextureHolderInterface> postLoadingTask(std::shared_ptr<TextureLoaderResult> loadedData,
                                                                       Tiled2dMapTileInfo tile) override;
 
+    virtual int64_t getResultMemorySize(const std::shared_ptr<::TextureHolderInterface> &result) override;
+
+    virtual void onTimeSeriesReadyChanged(int32_t readyFrames, int32_t numFrames) override;
+
 
   private:
     const std::vector<std::shared_ptr<::LoaderInterface>> loaders;
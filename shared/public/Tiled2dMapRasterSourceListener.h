@@ -16,4 +16,6 @@
 class Tiled2dMapRasterSourceListener {
 public:
     virtual void onTilesUpdated(const std::string &layerName, VectorSet<Tiled2dMapRasterTileInfo> currentTileInfos) = 0;
+
+    virtual void onTimeSeriesReadyChanged(int32_t readyFrames, int32_t numFrames) {}
 };
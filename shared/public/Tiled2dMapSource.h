@@ -17,6 +17,7 @@
 #include "Future.hpp"
 #include "LambdaTask.h"
 #include "LoaderStatus.h"
+#include "MapCameraStateListenerInterface.h"
 #include "MapConfig.h"
 #include "PolygonCoord.h"
 #include "PrioritizedTiled2dMapTileInfo.h"
@@ -25,7 +26,10 @@
 #include "TileState.h"
 #include "Tiled2dMapLayerConfig.h"
 #include "Tiled2dMapSourceInterface.h"
+#include "Tiled2dMapSourceLoadScheduler.h"
+#include "Tiled2dMapSourcePrefetchInterface.h"
 #include "Tiled2dMapVersionedTileInfo.h"
+#include "Tiled2dMapVisibleTilesPyramid.h"
 #include "Tiled2dMapZoomInfo.h"
 #include "Tiled2dMapZoomLevelInfo.h"
 #include "Vec3D.h"
@@ -126,6 +130,8 @@ class Tiled2dMapSourceReadyInterface {
 template <class L, class R>
 class Tiled2dMapSource : public Tiled2dMapSourceInterface,
                          public Tiled2dMapSourceReadyInterface,
+                         public Tiled2dMapSourcePrefetchInterface,
+                         public MapCameraStateListenerInterface,
                          public std::enable_shared_from_this<Tiled2dMapSourceInterface>,
                          public ActorObject {
   public:
@@ -134,14 +140,27 @@ class Tiled2dMapSource : public Tiled2dMapSourceInterface,
                      const std::shared_ptr<SchedulerInterface> &scheduler, float screenDensityPpi, size_t loaderCount,
                      std::string layerName);
 
+    virtual ~Tiled2dMapSource();
+
     virtual void onVisibleBoundsChanged(const ::RectCoord &visibleBounds, int curT, double zoom) override;
 
     virtual void onCameraChange(const std::vector<float> &viewMatrix, const std::vector<float> &projectionMatrix,
                                 const ::Vec3D &origin, float verticalFov, float horizontalFov, float width, float height,
                                 float focusPointAltitude, const ::Coord &focusPointPosition, float zoom) override;
 
+    virtual void onCameraStateChanged(const std::shared_ptr<const MapCameraState> &cameraState) override;
+
     virtual bool isTileVisible(const Tiled2dMapTileInfo &tileInfo);
 
+    void setPrefetchEnabled(bool enabled) override;
+
+    void onPrefetchBoundsChanged(const std::optional<::RectCoord> &predictedBounds, int32_t curT, double zoom) override;
+
+    // Time series playback: the results of the next numFrames time steps of the visible tiles are loaded ahead and kept,
+    // wrapping around after the last time step for looping animations. memoryBudget limits the number of frames kept
+    // (in bytes, as estimated by getResultMemorySize, 0 for no limit). Applied with the next visible bounds update.
+    void setTimeSeries(int32_t numFrames, int64_t memoryBudget);
+
     virtual void pause() override;
 
     virtual void resume() override;
@@ -175,6 +194,12 @@ class Tiled2dMapSource : public Tiled2dMapSourceInterface,
     void didFailToLoad(Tiled2dMapTileInfo tile, size_t loaderIndex, const LoaderStatus &status,
                        const std::optional<std::string> &errorCode);
 
+    // Results of scheduled loads, dropped if the load was cancelled and the tile is loading again with a newer load
+    void didLoadWithToken(Tiled2dMapTileInfo tile, size_t loaderIndex, uint64_t loadToken, const R &result);
+
+    void didFailToLoadWithToken(Tiled2dMapTileInfo tile, size_t loaderIndex, uint64_t loadToken, const LoaderStatus &status,
+                                const std::optional<std::string> &errorCode);
+
     void performDelayedTasks();
 
   protected:
@@ -182,8 +207,11 @@ class Tiled2dMapSource : public Tiled2dMapSourceInterface,
 
     virtual R postLoadingTask(L loadedData, Tiled2dMapTileInfo tile) = 0;
 
-    ::Vec3D transformToView(const ::Coord &position, const std::vector<float> &vpMatrix, const Vec3D &origin);
-    ::Vec3D projectToScreen(const ::Vec3D &point, const std::vector<float> &vpMatrix);
+    // Memory used by a loaded result, used for the time series memory budget
+    virtual int64_t getResultMemorySize(const R &result) { return 0; }
+
+    // Called when the number of upcoming time steps that are loaded for all visible tiles changes
+    virtual void onTimeSeriesReadyChanged(int32_t readyFrames, int32_t numFrames) {}
 
     MapConfig mapConfig;
     std::shared_ptr<Tiled2dMapLayerConfig> layerConfig;
@@ -215,7 +243,35 @@ class Tiled2dMapSource : public Tiled2dMapSourceInterface,
 
     std::vector<VisibleTilesLayer> currentPyramid;
     int currentKeepZoomLevelOffset;
-    std::vector<std::vector<Tiled2dMapTileInfo>> loadingQueues;
+
+    const size_t loaderCount;
+    // shared by all sources of the map, queues and throttles the loads
+    const std::shared_ptr<Tiled2dMapSourceLoadScheduler> loadScheduler;
+    std::optional<uint64_t> loadSchedulerClientId;
+    // prefetch requests are scheduled as a separate client, so that they are not replaced by the visible tile requests
+    std::optional<uint64_t> prefetchSchedulerClientId;
+
+    bool prefetchEnabled = false;
+    // predicted tiles that are not yet visible, loading or loaded
+    std::unordered_set<Tiled2dMapTileInfo> prefetchTiles;
+    std::unordered_map<Tiled2dMapTileInfo, std::pair<size_t, R>> prefetchedResults;
+    int64_t prefetchHits = 0;
+    int64_t prefetchMisses = 0;
+
+    int32_t timeSeriesFrames = 0;
+    int64_t timeSeriesMemoryBudget = 0;
+    // number of upcoming time steps kept, limited by the memory budget
+    int32_t timeSeriesWindow = 0;
+    int64_t timeSeriesTileMemorySize = 0;
+    int32_t timeSeriesReadyFrames = -1;
+    // upcoming time steps of the visible tiles, loaded results that are not visible yet are kept aside
+    std::unordered_set<Tiled2dMapTileInfo> timeSeriesTiles;
+    std::unordered_map<Tiled2dMapTileInfo, std::pair<size_t, R>> timeSeriesResults;
+    std::unordered_set<Tiled2dMapTileInfo> timeSeriesNotFoundTiles;
+
+    // shared by all sources of the map, the visible tiles of sources with the same tiling are only computed once
+    const std::shared_ptr<Tiled2dMapVisibleTilesPyramid> visibleTilesPyramid;
+    Tiled2dMapVisibleTilesPyramid::Tiling visibleTilesTiling;
 
     std::vector<PolygonCoord> currentViewBounds = {};
     std::optional<RectCoord> currentViewBoundsRect = std::nullopt;
@@ -230,12 +286,25 @@ class Tiled2dMapSource : public Tiled2dMapSourceInterface,
     void onVisibleTilesChanged(const std::vector<VisibleTilesLayer> &pyramid, bool keepMultipleLevels, int keepZoomLevelOffset = 0);
 
   protected:
-    void scheduleFixedNumberOfLoadingTasks();
-    void performLoadingTask(Tiled2dMapTileInfo tile, size_t loaderIndex);
+    uint64_t getLoadSchedulerClientId();
+    uint64_t getPrefetchSchedulerClientId();
+    std::vector<PrioritizedTiled2dMapTileInfo> getPrefetchTileCandidates(const RectCoord &bounds, int curT, double zoom);
+    void clearPrefetchTiles(const std::unordered_set<Tiled2dMapTileInfo> &keep);
+    int getTimeSeriesOffset(int t, int curT) const;
+    bool isInTimeSeriesWindow(int t, int curT) const;
+    int getTimeDistance(int t, int curT) const;
+    void updateTimeSeriesWindow(size_t numTargetTiles);
+    void updateTimeSeriesReadyFrames();
+    void requestLoad(const Tiled2dMapTileInfo &tile, size_t loaderIndex);
+    void performLoadingTask(Tiled2dMapTileInfo tile, size_t loaderIndex, uint64_t loadToken);
+    // Cancels the load and frees its slot in the load scheduler, the tile may be requested again right away
+    void cancelLoading(const Tiled2dMapTileInfo &tile, size_t loaderIndex);
 
     void updateTileMasks();
 
     std::unordered_map<Tiled2dMapTileInfo, int> currentlyLoading;
+    // load scheduler token of the latest load of every loading tile
+    std::unordered_map<Tiled2dMapTileInfo, uint64_t> currentLoadTokens;
 
     const int64_t MAX_WAIT_TIME = 32000;
     const int64_t MIN_WAIT_TIME = 1000;
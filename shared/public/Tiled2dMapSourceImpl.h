@@ -9,6 +9,7 @@
  */
 
 #include "DateHelper.h"
+#include "PerformanceLogger.h"
 #include "Tiled2dMapSource.h"
 #include "TiledLayerError.h"
 
@@ -21,28 +22,6 @@
 #include <algorithm>
 #include <queue>
 
-struct VisibleTileCandidate {
-    int x;
-    int y;
-    int levelIndex;
-    bool operator==(const VisibleTileCandidate &other) const {
-        return x == other.x && y == other.y && levelIndex == other.levelIndex;
-    }
-};
-
-namespace std {
-template <> struct hash<VisibleTileCandidate> {
-    size_t operator()(const VisibleTileCandidate &candidate) const {
-        size_t h1 = hash<int>()(candidate.x);
-        size_t h2 = hash<int>()(candidate.y);
-        size_t h3 = hash<int>()(candidate.levelIndex);
-
-        // Combine hashes using a simple combining function, based on the one from Boost library
-        return h1 ^ (h2 << 1) ^ (h3 << 2);
-    }
-};
-} // namespace std
-
 template <class L, class R>
 Tiled2dMapSource<L, R>::Tiled2dMapSource(const MapConfig &mapConfig, const std::shared_ptr<Tiled2dMapLayerConfig> &layerConfig,
                                             const std::shared_ptr<CoordinateConversionHelperInterface> &conversionHelper,
@@ -60,7 +39,9 @@ Tiled2dMapSource<L, R>::Tiled2dMapSource(const MapConfig &mapConfig, const std::
     , layerName(layerName)
     , curT(std::numeric_limits<decltype(curT)>::lowest())
     , curZoom(std::numeric_limits<decltype(curZoom)>::lowest())
-    , loadingQueues(loaderCount)
+    , loaderCount(loaderCount)
+    , loadScheduler(Tiled2dMapSourceLoadScheduler::getInstance(scheduler))
+    , visibleTilesPyramid(Tiled2dMapVisibleTilesPyramid::getInstance(conversionHelper))
 {
     std::sort(zoomLevelInfos.begin(), zoomLevelInfos.end(),
               [](const Tiled2dMapZoomLevelInfo &a, const Tiled2dMapZoomLevelInfo &b) -> bool { return a.zoom > b.zoom; });
@@ -72,6 +53,19 @@ Tiled2dMapSource<L, R>::Tiled2dMapSource(const MapConfig &mapConfig, const std::
     zoomLevelInfosWithVirtual.insert(zoomLevelInfosWithVirtual.end(), virtualZoomLevelInfos.begin(), virtualZoomLevelInfos.end());
     std::sort(zoomLevelInfosWithVirtual.begin(), zoomLevelInfosWithVirtual.end(),
               [](const Tiled2dMapZoomLevelInfo &a, const Tiled2dMapZoomLevelInfo &b) -> bool { return a.zoom > b.zoom; });
+
+    visibleTilesTiling = Tiled2dMapVisibleTilesPyramid::Tiling(layerSystemId, mapConfig.mapCoordinateSystem.identifier,
+                                                               zoomLevelInfosWithVirtual, topMostZoomLevel,
+                                                               zoomInfo.zoomLevelScaleFactor);
+}
+
+template <class L, class R> Tiled2dMapSource<L, R>::~Tiled2dMapSource() {
+    if (loadSchedulerClientId) {
+        loadScheduler->unregisterClient(*loadSchedulerClientId);
+    }
+    if (prefetchSchedulerClientId) {
+        loadScheduler->unregisterClient(*prefetchSchedulerClientId);
+    }
 }
 
 const static double VIEWBOUNDS_PADDING_MIN_DIM_PC = 0.15;
@@ -87,434 +81,44 @@ template <typename T> static void hash_combine(size_t &seed, const T &value) {
     seed ^= v + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 }
 
-template <class L, class R>
-::Vec3D Tiled2dMapSource<L, R>::transformToView(const ::Coord &position, const std::vector<float> &viewMatrix,
-                                                const Vec3D &origin) {
-
-    Coord mapCoord = conversionHelper->convertToRenderSystem(position);
-
-    const double rx = origin.x;
-    const double ry = origin.y;
-    const double rz = origin.z;
-
-    double sinX, cosX, sinY, cosY;
-    lut::sincos(mapCoord.y, sinY, cosY);
-    lut::sincos(mapCoord.x, sinX, cosX);
-
-    std::vector<float> inVec = {(float)((mapCoord.z * sinY * cosX - rx)),
-                                (float)((mapCoord.z * cosY - ry)),
-                                (float)((-mapCoord.z * sinY * sinX - rz)), 1.0};
-    std::vector<float> outVec = {0, 0, 0, 0};
-
-    Matrix::multiply(viewMatrix, inVec, outVec);
-
-    auto point2d = Vec3D(outVec[0] / outVec[3], outVec[1] / outVec[3], outVec[2] / outVec[3]);
-    return point2d;
-}
-
-template <class L, class R>
-::Vec3D Tiled2dMapSource<L, R>::projectToScreen(const ::Vec3D &position, const std::vector<float> &projectionMatrix) {
-    std::vector<float> inVec = {(float)position.x, (float)position.y, (float)position.z, 1.0};
-    std::vector<float> outVec = {0, 0, 0, 0};
-
-    Matrix::multiply(projectionMatrix, inVec, outVec);
-
-    auto point2d = Vec3D(outVec[0] / outVec[3], outVec[1] / outVec[3], outVec[2] / outVec[3]);
-    return point2d;
-}
-
 template <class L, class R>
 void Tiled2dMapSource<L, R>::onCameraChange(const std::vector<float> &viewMatrix, const std::vector<float> &projectionMatrix,
                                                const ::Vec3D &origin, float verticalFov, float horizontalFov, float width,
                                                float height, float focusPointAltitude, const ::Coord &focusPointPosition,
                                                float zoom) {
+    onCameraStateChanged(std::make_shared<const MapCameraState>(MapCameraState{viewMatrix, projectionMatrix, origin, verticalFov,
+                                                                               horizontalFov, width, height, focusPointAltitude,
+                                                                               focusPointPosition, zoom}));
+}
+
+template <class L, class R>
+void Tiled2dMapSource<L, R>::onCameraStateChanged(const std::shared_ptr<const MapCameraState> &cameraState) {
 
     if (isPaused) {
         return;
     }
 
-    if (width <= 0 || height <= 0) {
+    if (cameraState->width <= 0 || cameraState->height <= 0) {
         return;
     }
 
-    std::queue<VisibleTileCandidate> candidates;
-    std::unordered_set<VisibleTileCandidate> candidatesSet;
-
-    Coord viewBoundsTopLeft(layerSystemId, 0, 0, 0);
-    Coord viewBoundsTopRight(layerSystemId, 0, 0, 0);
-    Coord viewBoundsBottomLeft(layerSystemId, 0, 0, 0);
-    Coord viewBoundsBottomRight(layerSystemId, 0, 0, 0);
-    bool validViewBounds = false;
-
-    int minNumTiles = layerSystemId == CoordinateSystemIdentifiers::EPSG4326() ? 0 : 1;
-
-    int maxLevel = 0;
-    int minZoomLevelIndex = 0;
-    for (int index = 0; index < zoomLevelInfosWithVirtual.size(); ++index) {
-        const auto &level = zoomLevelInfosWithVirtual[index];
-        if (level.numTilesX > minNumTiles && level.numTilesY > minNumTiles) {
-            if (level.numTilesX * level.numTilesY > 100) {
-                printf("Ignore seed candidates for %d x %d tiles for %s\n", level.numTilesX, level.numTilesY, layerName.c_str());
-                break;
-            }
-            for (int x = 0; x < level.numTilesX; x++) {
-                for (int y = 0; y < level.numTilesY; y++) {
-                    VisibleTileCandidate c;
-                    c.levelIndex = index;
-                    c.x = x;
-                    c.y = y;
-
-                    candidates.push(c);
-                }
-            }
-            maxLevel = level.zoomLevelIdentifier;
-            minZoomLevelIndex = level.zoomLevelIdentifier;
-            break;
-        }
-    }
-
-    gpc_polygon currentViewBoundsPolygon;
-    gpc_polygon currentTilePolygon;
-    gpc_set_polygon({PolygonCoord(
-                        {
-                            conversionHelper->convert(layerSystemId, Coord(4326, -180, 90, 0)),  // top left
-                            conversionHelper->convert(layerSystemId, Coord(4326, 180, 90, 0)),   // top right
-                            conversionHelper->convert(layerSystemId, Coord(4326, 180, -90, 0)),  // bottom right
-                            conversionHelper->convert(layerSystemId, Coord(4326, -180, -90, 0)), // bottom left
-                            conversionHelper->convert(layerSystemId, Coord(4326, -180, 90, 0))   // top left
-                        },
-                        {})},
-                    &currentViewBoundsPolygon);
-    auto clipAndFreeLambda = [&currentViewBoundsPolygon](gpc_polygon &polygon) {
-        gpc_polygon_clip(GPC_DIFF, &currentViewBoundsPolygon, &polygon, &currentViewBoundsPolygon);
-        gpc_free_polygon(&polygon);
-    };
-
-    size_t visibleTileHash = minZoomLevelIndex;
-    std::vector<std::pair<VisibleTileCandidate, PrioritizedTiled2dMapTileInfo>> visibleTilesVec;
-
-    auto maxLevelAvailable = zoomLevelInfosWithVirtual.size() - 1;
-
-    int candidateChecks = 0;
-
-    auto focusPointInLayerCoords = conversionHelper->convert(layerSystemId, focusPointPosition);
-
-    auto earthCenterView = transformToView(Coord(CoordinateSystemIdentifiers::UnitSphere(), 0, 0, 0), viewMatrix, origin);
-
-    while (candidates.size() > 0) {
-        VisibleTileCandidate candidate = candidates.front();
-        candidates.pop();
-        candidatesSet.erase(candidate);
-
-        candidateChecks++;
-
-        if (candidateChecks > 1000) {
-            // something seems wrong here.
-            // lets ignore this run and wait for the next update instead of burning the cpu
-            return;
-        }
-
-        const Tiled2dMapZoomLevelInfo &zoomLevelInfo = zoomLevelInfosWithVirtual.at(candidate.levelIndex);
-
-        const double boundsRatio =
-            std::abs(((zoomLevelInfo.bounds.bottomRight.y - zoomLevelInfo.bounds.topLeft.y) / zoomLevelInfo.numTilesY) /
-                     ((zoomLevelInfo.bounds.bottomRight.x - zoomLevelInfo.bounds.topLeft.x) / zoomLevelInfo.numTilesX));
-        const double tileWidth = zoomLevelInfo.tileWidthLayerSystemUnits;
-        const double tileHeight = zoomLevelInfo.tileWidthLayerSystemUnits * boundsRatio;
-
-        RectCoord layerBounds = zoomLevelInfo.bounds;
-        layerBounds = conversionHelper->convertRect(layerSystemId, layerBounds);
-
-        const bool leftToRight = layerBounds.topLeft.x < layerBounds.bottomRight.x;
-        const bool topToBottom = layerBounds.topLeft.y < layerBounds.bottomRight.y;
-        const double tileWidthAdj = leftToRight ? tileWidth : -tileWidth;
-        const double tileHeightAdj = topToBottom ? tileHeight : -tileHeight;
-
-        const double boundsLeft = layerBounds.topLeft.x;
-        const double boundsTop = layerBounds.topLeft.y;
-
-        const double heightRange = 1000;
-
-        const Coord topLeft = Coord(layerSystemId, candidate.x * tileWidthAdj + boundsLeft, candidate.y * tileHeightAdj + boundsTop,
-                                    focusPointAltitude);
-        const Coord topRight = Coord(layerSystemId, topLeft.x + tileWidthAdj, topLeft.y, focusPointAltitude - heightRange / 2.0);
-        const Coord bottomLeft = Coord(layerSystemId, topLeft.x, topLeft.y + tileHeightAdj, focusPointAltitude - heightRange / 2.0);
-        const Coord bottomRight =
-            Coord(layerSystemId, topLeft.x + tileWidthAdj, topLeft.y + tileHeightAdj, focusPointAltitude - heightRange / 2.0);
-
-        const Coord tileCenter = Coord(layerSystemId, topLeft.x * 0.5 + bottomRight.x * 0.5, topLeft.y * 0.5 + bottomRight.y * 0.5,
-                                       topLeft.z * 0.5 + bottomRight.z * 0.5);
-
-        gpc_set_polygon({PolygonCoord({topLeft, topRight, bottomRight, bottomLeft, topLeft}, {})}, &currentTilePolygon);
+    const float focusPointAltitude = cameraState->focusPointAltitude;
 
-        const auto focusPointClampedToTile =
-            Coord(layerSystemId,
-                  topLeft.x < topRight.x ? std::clamp(focusPointInLayerCoords.x, topLeft.x, topRight.x)
-                                         : std::clamp(focusPointInLayerCoords.x, topRight.x, topLeft.x),
-                  topLeft.y < bottomLeft.y ? std::clamp(focusPointInLayerCoords.y, topLeft.y, bottomLeft.y)
-                                           : std::clamp(focusPointInLayerCoords.y, bottomLeft.y, topLeft.y),
-                  focusPointAltitude);
-
-        auto toRight = focusPointClampedToTile.x < tileCenter.x;
-        auto toTop = focusPointClampedToTile.y < tileCenter.y;
-
-        const double sampleSize = 0.25;
-
-        const auto focusPointSampleX =
-            Coord(layerSystemId, focusPointClampedToTile.x + (toRight ? tileWidthAdj : -tileWidthAdj) * sampleSize,
-                  focusPointClampedToTile.y, focusPointClampedToTile.z);
-
-        const auto focusPointSampleY =
-            Coord(layerSystemId, focusPointClampedToTile.x,
-                  focusPointClampedToTile.y + (toTop ? -tileHeightAdj : tileHeightAdj) * sampleSize, focusPointClampedToTile.z);
-
-        const Coord topCenter = Coord(layerSystemId, topLeft.x * 0.5 + topRight.x * 0.5, topLeft.y, topLeft.z);
-        const Coord bottomCenter = Coord(layerSystemId, bottomLeft.x * 0.5 + bottomRight.x * 0.5, bottomLeft.y, bottomLeft.z);
-        const Coord leftCenter = Coord(layerSystemId, topLeft.x, bottomLeft.y * 0.5 + topLeft.y * 0.5, topLeft.z);
-        const Coord rightCenter = Coord(layerSystemId, topRight.x, bottomRight.y * 0.5 + topRight.y * 0.5, topRight.z);
-
-        auto topLeftView = transformToView(topLeft, viewMatrix, origin);
-        auto topRightView = transformToView(topRight, viewMatrix, origin);
-        auto bottomLeftView = transformToView(bottomLeft, viewMatrix, origin);
-        auto bottomRightView = transformToView(bottomRight, viewMatrix, origin);
-
-        /*
-         use focuspoint in layersystem and clamp to tileBounds
-         */
-
-        auto focusPointClampedView = transformToView(focusPointClampedToTile, viewMatrix, origin);
-        auto focusPointSampleXView = transformToView(focusPointSampleX, viewMatrix, origin);
-        auto focusPointSampleYView = transformToView(focusPointSampleY, viewMatrix, origin);
-
-        auto topCenterView = transformToView(topCenter, viewMatrix, origin);
-        auto bottomCenterView = transformToView(bottomCenter, viewMatrix, origin);
-        auto leftCenterView = transformToView(leftCenter, viewMatrix, origin);
-        auto rightCenterView = transformToView(rightCenter, viewMatrix, origin);
-
-        float centerZ = (topLeftView.z + topRightView.z + bottomLeftView.z + bottomRightView.z) / 4.0;
-
-        auto diffCenterViewTopLeft = topLeftView - earthCenterView;
-        auto diffCenterViewTopRight = topRightView - earthCenterView;
-        auto diffCenterViewBottomLeft = bottomLeftView - earthCenterView;
-        auto diffCenterViewBottomRight = bottomRightView - earthCenterView;
-
-        auto diffCenterViewTopCenter = topCenterView - earthCenterView;
-        auto diffCenterViewBottomCenter = bottomCenterView - earthCenterView;
-        auto diffCenterViewLeftCenter = leftCenterView - earthCenterView;
-        auto diffCenterViewRightCenter = rightCenterView - earthCenterView;
-
-        bool isKeptLevel = candidate.levelIndex == minZoomLevelIndex;
-
-        if (!isKeptLevel && diffCenterViewTopLeft.z < 0.0 && diffCenterViewTopRight.z < 0.0 && diffCenterViewBottomLeft.z < 0.0 &&
-            diffCenterViewBottomRight.z < 0.0) {
-            clipAndFreeLambda(currentTilePolygon);
-            // LogDebug << "UBCM: dropping tile (all facing away) " << candidate.levelIndex << "/" << candidate.x << "/" <<=
-            // candidate.y; Tile is facing away from the camera
-            continue;
-        }
-        auto samplePointOriginViewScreen = projectToScreen(focusPointClampedView, projectionMatrix);
-        if (!isKeptLevel && (samplePointOriginViewScreen.x < -1.0 || samplePointOriginViewScreen.x > 1.0 ||
-                             samplePointOriginViewScreen.y < -1.0 || samplePointOriginViewScreen.y > 1.0)) {
-            if (mapConfig.mapCoordinateSystem.identifier == CoordinateSystemIdentifiers::UnitSphere()) {
-                // v(0,0,+1) = unit-vector out of screen
-                float topLeftHA = 180.0 / M_PI * atan2(topLeftView.x, -topLeftView.z);
-                float topLeftVA = 180.0 / M_PI * atan2(topLeftView.y, -topLeftView.z);
-                float topRightHA = 180.0 / M_PI * atan2(topRightView.x, -topRightView.z);
-                float topRightVA = 180.0 / M_PI * atan2(topRightView.y, -topRightView.z);
-                float bottomLeftHA = 180.0 / M_PI * atan2(bottomLeftView.x, -bottomLeftView.z);
-                float bottomLeftVA = 180.0 / M_PI * atan2(bottomLeftView.y, -bottomLeftView.z);
-                float bottomRightHA = 180.0 / M_PI * atan2(bottomRightView.x, -bottomRightView.z);
-                float bottomRightVA = 180.0 / M_PI * atan2(bottomRightView.y, -bottomRightView.z);
-
-                float topCenterHA = 180.0 / M_PI * atan2(topCenterView.x, -topCenterView.z);
-                float topCenterVA = 180.0 / M_PI * atan2(topCenterView.y, -topCenterView.z);
-                float bottomCenterHA = 180.0 / M_PI * atan2(bottomCenterView.x, -bottomCenterView.z);
-                float bottomCenterVA = 180.0 / M_PI * atan2(bottomCenterView.y, -bottomCenterView.z);
-                float leftCenterHA = 180.0 / M_PI * atan2(leftCenterView.x, -leftCenterView.z);
-                float leftCenterVA = 180.0 / M_PI * atan2(leftCenterView.y, -leftCenterView.z);
-                float rightCenterHA = 180.0 / M_PI * atan2(rightCenterView.x, -rightCenterView.z);
-                float rightCenterVA = 180.0 / M_PI * atan2(rightCenterView.y, -rightCenterView.z);
-
-                // 0.5: half of view on each side of center
-                // 1.1: increase angle with padding
-                float fovFactor = 0.5 * 1.1;
-
-                float left = -horizontalFov * fovFactor;
-                float right = horizontalFov * fovFactor;
-                float top = verticalFov * fovFactor;
-                float bottom = -verticalFov * fovFactor;
-
-                if ((topLeftVA < bottom || diffCenterViewTopLeft.z < 0.0) &&
-                    (topRightVA < bottom || diffCenterViewTopRight.z < 0.0) &&
-                    (bottomLeftVA < bottom || diffCenterViewBottomLeft.z < 0.0) &&
-                    (bottomRightVA < bottom || diffCenterViewBottomRight.z < 0.0) &&
-                    (topCenterVA < bottom || diffCenterViewTopCenter.z < 0.0) &&
-                    (bottomCenterVA < bottom || diffCenterViewBottomCenter.z < 0.0) &&
-                    (leftCenterVA < bottom || diffCenterViewLeftCenter.z < 0.0) &&
-                    (rightCenterVA < bottom || diffCenterViewRightCenter.z < 0.0)) {
-                    clipAndFreeLambda(currentTilePolygon);
-                    // LogDebug << "UBCM: dropping tile (below) " << candidate.levelIndex << "/" << candidate.x << "/" <<=
-                    // candidate.y;
-                    continue; // All camera-facing corners are BELOW the viewport
-                }
-                if ((topLeftHA < left || diffCenterViewTopLeft.z < 0.0) && (topRightHA < left || diffCenterViewTopRight.z < 0.0) &&
-                    (bottomLeftHA < left || diffCenterViewBottomLeft.z < 0.0) &&
-                    (bottomRightHA < left || diffCenterViewBottomRight.z < 0.0) &&
-                    (topCenterHA < left || diffCenterViewTopCenter.z < 0.0) &&
-                    (bottomCenterHA < left || diffCenterViewBottomCenter.z < 0.0) &&
-                    (leftCenterHA < left || diffCenterViewLeftCenter.z < 0.0) &&
-                    (rightCenterHA < left || diffCenterViewRightCenter.z < 0.0)) {
-                    clipAndFreeLambda(currentTilePolygon);
-                    // LogDebug << "UBCM: dropping tile (left) " << candidate.levelIndex << "/" << candidate.x << "/" <<=
-                    // candidate.y;
-                    continue; // All camera-facing corners are TO THE LEFT of the viewport
-                }
-                if ((topLeftVA > top || diffCenterViewTopLeft.z < 0.0) && (topRightVA > top || diffCenterViewTopRight.z < 0.0) &&
-                    (bottomLeftVA > top || diffCenterViewBottomLeft.z < 0.0) &&
-                    (bottomRightVA > top || diffCenterViewBottomRight.z < 0.0) &&
-                    (topCenterVA > top || diffCenterViewTopCenter.z < 0.0) &&
-                    (bottomCenterVA > top || diffCenterViewBottomCenter.z < 0.0) &&
-                    (leftCenterVA > top || diffCenterViewLeftCenter.z < 0.0) &&
-                    (rightCenterVA > top || diffCenterViewRightCenter.z < 0.0)) {
-                    clipAndFreeLambda(currentTilePolygon);
-                    // LogDebug << "UBCM: dropping tile (above) " << candidate.levelIndex << "/" << candidate.x << "/" <<=
-                    // candidate.y;
-                    continue; // All camera-facing corners are ABOVE the viewport
-                }
-                if ((topLeftHA > right || diffCenterViewTopLeft.z < 0.0) &&
-                    (topRightHA > right || diffCenterViewTopRight.z < 0.0) &&
-                    (bottomLeftHA > right || diffCenterViewBottomLeft.z < 0.0) &&
-                    (bottomRightHA > right || diffCenterViewBottomRight.z < 0.0) &&
-                    (topCenterHA > right || diffCenterViewTopCenter.z < 0.0) &&
-                    (bottomCenterHA > right || diffCenterViewBottomCenter.z < 0.0) &&
-                    (leftCenterHA > right || diffCenterViewLeftCenter.z < 0.0) &&
-                    (rightCenterHA > right || diffCenterViewRightCenter.z < 0.0)) {
-                    clipAndFreeLambda(currentTilePolygon);
-                    // LogDebug << "UBCM: dropping tile (right) " << candidate.levelIndex << "/" << candidate.x << "/" <<=
-                    // candidate.y;
-                    continue; // All camera-facing corners are TO THE RIGHT of the viewport
-                }
-            } else {
-                if (topLeftView.x < -width / 2.0 && topRightView.x < -width / 2.0 && bottomLeftView.x < -width / 2.0 &&
-                    bottomRightView.x < -width / 2.0) {
-                    clipAndFreeLambda(currentTilePolygon);
-                    continue;
-                }
-                if (topLeftView.y < -height / 2.0 && topRightView.y < -height / 2.0 && bottomLeftView.y < -height / 2.0 &&
-                    bottomRightView.y < -height / 2.0) {
-                    clipAndFreeLambda(currentTilePolygon);
-                    continue;
-                }
-                if (topLeftView.x > width / 2.0 && topRightView.x > width / 2.0 && bottomLeftView.x > width / 2.0 &&
-                    bottomRightView.x > width / 2.0) {
-                    clipAndFreeLambda(currentTilePolygon);
-                    continue;
-                }
-                if (topLeftView.y > height / 2.0 && topRightView.y > height / 2.0 && bottomLeftView.y > height / 2.0 &&
-                    bottomRightView.y > height / 2.0) {
-                    clipAndFreeLambda(currentTilePolygon);
-                    continue;
-                }
-            }
-        }
-
-        if (!validViewBounds) {
-            viewBoundsTopLeft = topLeft;
-            viewBoundsBottomRight = bottomRight;
-            validViewBounds = true;
-        }
-
-        auto updateBounds = [](double &bound, double value, bool compareLess) {
-            bound = compareLess ? std::min(bound, value) : std::max(bound, value);
-        };
-
-        // Update x coordinates
-        updateBounds(viewBoundsTopRight.x, topRight.x, leftToRight);
-        updateBounds(viewBoundsTopLeft.x, topLeft.x, !leftToRight);
-        updateBounds(viewBoundsBottomRight.x, bottomRight.x, leftToRight);
-        updateBounds(viewBoundsBottomLeft.x, bottomLeft.x, !leftToRight);
-
-        // Update y coordinates
-        updateBounds(viewBoundsTopRight.y, topRight.y, topToBottom);
-        updateBounds(viewBoundsTopLeft.y, topLeft.y, topToBottom);
-        updateBounds(viewBoundsBottomRight.y, bottomRight.y, !topToBottom);
-        updateBounds(viewBoundsBottomLeft.y, bottomLeft.y, !topToBottom);
-
-        auto samplePointYViewScreen = projectToScreen(focusPointSampleYView, projectionMatrix);
-        auto samplePointXViewScreen = projectToScreen(focusPointSampleXView, projectionMatrix);
-
-        Vec2D samplePointOriginViewScreenPx(samplePointOriginViewScreen.x * (width / 2.0),
-                                            samplePointOriginViewScreen.y * (height / 2.0));
-        Vec2D samplePointYViewScreenPx(samplePointYViewScreen.x * (width / 2.0), samplePointYViewScreen.y * (height / 2.0));
-        Vec2D samplePointXViewScreenPx(samplePointXViewScreen.x * (width / 2.0), samplePointXViewScreen.y * (height / 2.0));
-
-        double xLengthPx = Vec2DHelper::distance(samplePointOriginViewScreenPx, samplePointXViewScreenPx);
-        double yLengthPx = Vec2DHelper::distance(samplePointOriginViewScreenPx, samplePointYViewScreenPx);
-
-        double maxLength = sampleSize * (std::min(width, height) * 0.5 / zoomInfo.zoomLevelScaleFactor);
-        bool preciseEnough = xLengthPx <= maxLength || yLengthPx <= maxLength;
-
-        bool lastLevel = candidate.levelIndex == maxLevelAvailable;
-
-        bool isVirtual = topMostZoomLevel > zoomLevelInfo.zoomLevelIdentifier;
-
-        if (!isVirtual && (preciseEnough || lastLevel || isKeptLevel)) {
-            const RectCoord rect(topLeft, bottomRight);
-            int t = 0;
-            double priority = -centerZ * 100000;
-            visibleTilesVec.push_back(std::make_pair(
-                candidate, PrioritizedTiled2dMapTileInfo(Tiled2dMapTileInfo(rect, candidate.x, candidate.y, t,
-                                                                            zoomLevelInfo.zoomLevelIdentifier, zoomLevelInfo.zoom),
-                                                         priority)));
-
-            maxLevel = std::max(maxLevel, zoomLevelInfo.zoomLevelIdentifier);
-        }
-
-        if (!preciseEnough && !lastLevel) {
-            const Tiled2dMapZoomLevelInfo &zoomLevelInfo = zoomLevelInfosWithVirtual.at(candidate.levelIndex + 1);
-
-            const double tileWidth = zoomLevelInfo.tileWidthLayerSystemUnits;
-            const double tileHeight = zoomLevelInfo.tileWidthLayerSystemUnits * boundsRatio;
-
-            RectCoord layerBounds = zoomLevelInfo.bounds;
-            layerBounds = conversionHelper->convertRect(layerSystemId, layerBounds);
-
-            const bool leftToRight = layerBounds.topLeft.x < layerBounds.bottomRight.x;
-            const bool topToBottom = layerBounds.topLeft.y < layerBounds.bottomRight.y;
-            const double tileWidthAdj = leftToRight ? tileWidth : -tileWidth;
-            const double tileHeightAdj = topToBottom ? tileHeight : -tileHeight;
-
-            const double boundsLeft = layerBounds.topLeft.x;
-            const double boundsTop = layerBounds.topLeft.y;
-
-            int nextCandidateXMin = floor((topLeft.x - boundsLeft) / tileWidthAdj);
-            int nextCandidateXMax = ceil((topRight.x - boundsLeft) / tileWidthAdj) - 1;
-
-            int nextCandidateYMin = floor((topLeft.y - boundsTop) / tileHeightAdj);
-            int nextCandidateYMax = ceil((bottomLeft.y - boundsTop) / tileHeightAdj) - 1;
-
-            for (int nextX = nextCandidateXMin; nextX <= nextCandidateXMax; nextX++) {
-                for (int nextY = nextCandidateYMin; nextY <= nextCandidateYMax; nextY++) {
-                    VisibleTileCandidate cNext;
-                    cNext.levelIndex = candidate.levelIndex + 1;
-                    cNext.x = nextX;
-                    cNext.y = nextY;
-                    if (candidatesSet.find(cNext) == candidatesSet.end()) {
-                        candidates.push(cNext);
-                        candidatesSet.insert(cNext);
-                    }
-                }
-            }
-        }
+    const auto visibleTiles = visibleTilesPyramid->getVisibleTiles(visibleTilesTiling, cameraState);
+    if (!visibleTiles->valid) {
+        return;
     }
 
-    currentViewBounds = gpc_get_polygon_coord(&currentViewBoundsPolygon, layerSystemId);
-    gpc_free_polygon(&currentViewBoundsPolygon);
+    currentViewBounds = visibleTiles->viewBounds;
 
-    if (!validViewBounds) {
+    if (!visibleTiles->validViewBounds) {
         return;
     }
 
+    size_t visibleTileHash = visibleTiles->minZoomLevelIndex;
+    std::vector<std::pair<VisibleTileCandidate, PrioritizedTiled2dMapTileInfo>> visibleTilesVec = visibleTiles->visibleTiles;
+    const int maxLevel = visibleTiles->maxLevel;
+
     std::vector<VisibleTilesLayer> layers;
 
     for (int previousLayerOffset = 0; (previousLayerOffset <= zoomInfo.numDrawPreviousLayers || zoomInfo.maskTile);
@@ -667,8 +271,8 @@ void Tiled2dMapSource<L, R>::onVisibleBoundsChanged(const ::RectCoord &visibleBo
 
     if (((currentViewBoundsRect && visibleBoundsLayer != *currentViewBoundsRect) || curT != curT_)) {
         for (auto it = currentlyLoading.begin(); it != currentlyLoading.end();) {
-            if (it->first.t != curT_) {
-                cancelLoad(it->first, it->second);
+            if (it->first.t != curT_ && !isInTimeSeriesWindow(it->first.t, curT_)) {
+                cancelLoading(it->first, it->second);
                 it = currentlyLoading.erase(it);
             } else
                 it++;
@@ -869,7 +473,7 @@ void Tiled2dMapSource<L, R>::onVisibleBoundsChanged(const ::RectCoord &visibleBo
                         onScreenFactor = onScreenWeight;
                     }
                     float zoomlevelFactor = zoomDistanceFactor * zoomLevelWeight;
-                    float zDistanceFactor = std::abs(t - curT) * zDistanceWeight;
+                    float zDistanceFactor = getTimeDistance(t, curT) * zDistanceWeight;
 
                     const int priority = std::ceil(distanceFactor + onScreenFactor + zoomlevelFactor + zDistanceFactor);
 
@@ -911,12 +515,237 @@ void Tiled2dMapSource<L, R>::onVisibleBoundsChanged(const ::RectCoord &visibleBo
     currentViewBoundsRect = visibleBoundsLayer;
 }
 
+template <class L, class R> void Tiled2dMapSource<L, R>::setPrefetchEnabled(bool enabled) {
+    prefetchEnabled = enabled;
+    if (!enabled) {
+        onPrefetchBoundsChanged(std::nullopt, curT, curZoom);
+    }
+}
+
+template <class L, class R> void Tiled2dMapSource<L, R>::setTimeSeries(int32_t numFrames, int64_t memoryBudget) {
+    timeSeriesFrames = std::max(numFrames, 0);
+    timeSeriesMemoryBudget = std::max(memoryBudget, (int64_t)0);
+    if (timeSeriesFrames == 0) {
+        timeSeriesWindow = 0;
+        timeSeriesTiles.clear();
+        timeSeriesResults.clear();
+        timeSeriesNotFoundTiles.clear();
+        timeSeriesReadyFrames = -1;
+    }
+    lastVisibleTilesHash = -1;
+}
+
+template <class L, class R> int Tiled2dMapSource<L, R>::getTimeSeriesOffset(int t, int curT_) const {
+    const int numTilesT = zoomLevelInfos.empty() ? 1 : std::max(zoomLevelInfos.at(0).numTilesT, 1);
+    return ((t - curT_) % numTilesT + numTilesT) % numTilesT;
+}
+
+template <class L, class R> bool Tiled2dMapSource<L, R>::isInTimeSeriesWindow(int t, int curT_) const {
+    if (timeSeriesWindow <= 0) {
+        return false;
+    }
+    const int offset = getTimeSeriesOffset(t, curT_);
+    return offset > 0 && offset <= timeSeriesWindow;
+}
+
+template <class L, class R> int Tiled2dMapSource<L, R>::getTimeDistance(int t, int curT_) const {
+    // upcoming time steps wrap around when playing a time series
+    if (std::abs(t - curT_) > zoomInfo.numDrawPreviousOrLaterTLayers && isInTimeSeriesWindow(t, curT_)) {
+        return getTimeSeriesOffset(t, curT_);
+    }
+    return std::abs(t - curT_);
+}
+
+template <class L, class R> void Tiled2dMapSource<L, R>::updateTimeSeriesWindow(size_t numTargetTiles) {
+    const int numTilesT = zoomLevelInfos.empty() ? 1 : std::max(zoomLevelInfos.at(0).numTilesT, 1);
+    int32_t window = std::min(timeSeriesFrames, numTilesT - 1);
+    if (timeSeriesMemoryBudget > 0 && timeSeriesTileMemorySize > 0 && numTargetTiles > 0) {
+        // the budget includes the current time step
+        const int64_t frameSize = timeSeriesTileMemorySize * (int64_t)numTargetTiles;
+        window = (int32_t)std::min((int64_t)window, timeSeriesMemoryBudget / frameSize - 1);
+    }
+    timeSeriesWindow = std::max(window, 0);
+}
+
+template <class L, class R> void Tiled2dMapSource<L, R>::updateTimeSeriesReadyFrames() {
+    if (timeSeriesFrames <= 0) {
+        return;
+    }
+
+    std::vector<Tiled2dMapTileInfo> targetTiles;
+    for (const auto &layer : currentPyramid) {
+        if (layer.targetZoomLevelOffset != 0) {
+            continue;
+        }
+        for (const auto &tile : layer.visibleTiles) {
+            if (tile.tileInfo.t == curT) {
+                targetTiles.push_back(tile.tileInfo);
+            }
+        }
+    }
+
+    const int numTilesT = zoomLevelInfos.empty() ? 1 : std::max(zoomLevelInfos.at(0).numTilesT, 1);
+    int32_t readyFrames = 0;
+    for (int32_t offset = 1; offset <= timeSeriesWindow && !targetTiles.empty(); ++offset) {
+        bool frameReady = true;
+        for (auto tile : targetTiles) {
+            tile.t = (curT + offset) % numTilesT;
+            if (currentTiles.count(tile) == 0 && timeSeriesResults.count(tile) == 0 && timeSeriesNotFoundTiles.count(tile) == 0 &&
+                notFoundTiles.count(tile) == 0) {
+                frameReady = false;
+                break;
+            }
+        }
+        if (!frameReady) {
+            break;
+        }
+        readyFrames++;
+    }
+
+    if (readyFrames != timeSeriesReadyFrames) {
+        timeSeriesReadyFrames = readyFrames;
+        onTimeSeriesReadyChanged(readyFrames, timeSeriesWindow);
+    }
+}
+
+template <class L, class R>
+void Tiled2dMapSource<L, R>::onPrefetchBoundsChanged(const std::optional<::RectCoord> &predictedBounds, int32_t curT_, double zoom) {
+    if (isPaused) {
+        return;
+    }
+
+    std::unordered_set<Tiled2dMapTileInfo> predictedTiles;
+    std::vector<Tiled2dMapSourceLoadScheduler::Request> requests;
+    if (prefetchEnabled && predictedBounds && loaderCount > 0) {
+        for (const auto &candidate : getPrefetchTileCandidates(*predictedBounds, curT_, zoom)) {
+            const auto &tile = candidate.tileInfo;
+            if (currentVisibleTiles.count(tile) != 0 || currentTiles.count(tile) != 0 || notFoundTiles.count(tile) != 0) {
+                continue;
+            }
+            predictedTiles.insert(tile);
+            if (currentlyLoading.count(tile) == 0 && prefetchedResults.count(tile) == 0) {
+                requests.push_back({tile, 0, candidate.priority});
+            }
+        }
+    }
+
+    clearPrefetchTiles(predictedTiles);
+    prefetchTiles = std::move(predictedTiles);
+
+    if (!requests.empty() || prefetchSchedulerClientId) {
+        loadScheduler->setRequests(getPrefetchSchedulerClientId(), requests);
+    }
+}
+
+template <class L, class R> void Tiled2dMapSource<L, R>::clearPrefetchTiles(const std::unordered_set<Tiled2dMapTileInfo> &keep) {
+    int64_t misses = 0;
+    for (const auto &tile : prefetchTiles) {
+        if (keep.count(tile) != 0) {
+            continue;
+        }
+        // the prediction was wrong, the tile did not become visible
+        misses++;
+        auto loading = currentlyLoading.find(tile);
+        if (loading != currentlyLoading.end()) {
+            cancelLoading(loading->first, loading->second);
+            currentlyLoading.erase(loading);
+        }
+        prefetchedResults.erase(tile);
+    }
+    if (misses > 0) {
+        prefetchMisses += misses;
+        PERF_LOG_COUNT("Tiled2dMapSource_prefetchMisses", misses);
+    }
+}
+
+template <class L, class R>
+std::vector<PrioritizedTiled2dMapTileInfo> Tiled2dMapSource<L, R>::getPrefetchTileCandidates(const RectCoord &bounds, int curT_, double zoom) {
+    if (zoomLevelInfos.empty()) {
+        return {};
+    }
+
+    // same target zoom level selection as in onVisibleBoundsChanged, only the target level is prefetched
+    const float screenScaleFactor = zoomInfo.adaptScaleToScreen ? screenDensityPpi / (0.0254 / 0.00028) : 1.0;
+    int targetZoomLayer = -1;
+    for (int i = 0; i < zoomLevelInfos.size(); i++) {
+        if (zoomInfo.zoomLevelScaleFactor * screenScaleFactor * zoomLevelInfos[i].zoom < zoom) {
+            targetZoomLayer = std::max(i - 1, 0);
+            break;
+        }
+    }
+    if (targetZoomLayer < 0) {
+        if (!zoomInfo.overzoom) {
+            return {};
+        }
+        targetZoomLayer = (int)zoomLevelInfos.size() - 1;
+    }
+
+    const Tiled2dMapZoomLevelInfo &zoomLevelInfo = zoomLevelInfos.at(targetZoomLayer);
+    if ((minZoomLevelIdentifier.has_value() && zoomLevelInfo.zoomLevelIdentifier < minZoomLevelIdentifier) ||
+        (maxZoomLevelIdentifier.has_value() && zoomLevelInfo.zoomLevelIdentifier > maxZoomLevelIdentifier)) {
+        return {};
+    }
+
+    const RectCoord boundsLayer = conversionHelper->convertRect(layerSystemId, bounds);
+    const double minX = std::min(boundsLayer.topLeft.x, boundsLayer.bottomRight.x);
+    const double maxX = std::max(boundsLayer.topLeft.x, boundsLayer.bottomRight.x);
+    const double minY = std::min(boundsLayer.topLeft.y, boundsLayer.bottomRight.y);
+    const double maxY = std::max(boundsLayer.topLeft.y, boundsLayer.bottomRight.y);
+    const double centerX = 0.5 * (minX + maxX);
+    const double centerY = 0.5 * (minY + maxY);
+
+    const double boundsRatio =
+        std::abs(((zoomLevelInfo.bounds.bottomRight.y - zoomLevelInfo.bounds.topLeft.y) / zoomLevelInfo.numTilesY) /
+                 ((zoomLevelInfo.bounds.bottomRight.x - zoomLevelInfo.bounds.topLeft.x) / zoomLevelInfo.numTilesX));
+    const double tileWidth = zoomLevelInfo.tileWidthLayerSystemUnits;
+    const double tileHeight = zoomLevelInfo.tileWidthLayerSystemUnits * boundsRatio;
+
+    const RectCoord layerBounds = conversionHelper->convertRect(layerSystemId, zoomLevelInfo.bounds);
+    const bool leftToRight = layerBounds.topLeft.x < layerBounds.bottomRight.x;
+    const bool topToBottom = layerBounds.topLeft.y < layerBounds.bottomRight.y;
+    const double tileWidthAdj = leftToRight ? tileWidth : -tileWidth;
+    const double tileHeightAdj = topToBottom ? tileHeight : -tileHeight;
+    const double boundsLeft = layerBounds.topLeft.x;
+    const double boundsTop = layerBounds.topLeft.y;
+
+    const int startTileLeft = std::floor(std::max(leftToRight ? (minX - boundsLeft) : (boundsLeft - maxX), 0.0) / tileWidth);
+    const int maxTileLeft = std::floor(std::max(leftToRight ? (maxX - boundsLeft) : (boundsLeft - minX), 0.0) / tileWidth);
+    const int startTileTop = std::floor(std::max(topToBottom ? (minY - boundsTop) : (boundsTop - maxY), 0.0) / tileHeight);
+    const int maxTileTop = std::floor(std::max(topToBottom ? (maxY - boundsTop) : (boundsTop - minY), 0.0) / tileHeight);
+
+    const double maxDisCenter = std::sqrt(std::pow(0.5 * (maxX - minX) + tileWidth, 2.0) + std::pow(0.5 * (maxY - minY) + tileHeight, 2.0));
+
+    // prefetched tiles are loaded after all visible tiles, the closest to the predicted center first
+    const int prefetchPriority = std::numeric_limits<int>::max() - 1000;
+
+    std::vector<PrioritizedTiled2dMapTileInfo> tiles;
+    for (int x = startTileLeft; x <= maxTileLeft && x < zoomLevelInfo.numTilesX; x++) {
+        for (int y = startTileTop; y <= maxTileTop && y < zoomLevelInfo.numTilesY; y++) {
+            const Coord topLeft = Coord(layerSystemId, x * tileWidthAdj + boundsLeft, y * tileHeightAdj + boundsTop, 0);
+            const Coord bottomRight = Coord(layerSystemId, topLeft.x + tileWidthAdj, topLeft.y + tileHeightAdj, 0);
+
+            const double tileCenterDis =
+                std::sqrt(std::pow(topLeft.x + 0.5 * tileWidthAdj - centerX, 2.0) + std::pow(topLeft.y + 0.5 * tileHeightAdj - centerY, 2.0));
+            const int priority = prefetchPriority + std::min((int)std::ceil(tileCenterDis / maxDisCenter * 100), 1000);
+
+            tiles.push_back(PrioritizedTiled2dMapTileInfo(
+                Tiled2dMapTileInfo(RectCoord(topLeft, bottomRight), x, y, curT_, zoomLevelInfo.zoomLevelIdentifier, zoomLevelInfo.zoom),
+                priority));
+        }
+    }
+    return tiles;
+}
+
 template <class L, class R>
 void Tiled2dMapSource<L, R>::onVisibleTilesChanged(const std::vector<VisibleTilesLayer> &pyramid, bool enforceMultipleLevels,
                                                       int keepZoomLevelOffset) {
     currentVisibleTiles.clear();
 
     std::vector<PrioritizedTiled2dMapTileInfo> toAdd;
+    std::vector<Tiled2dMapTileInfo> prefetchedTilesToAdd;
+    std::vector<Tiled2dMapTileInfo> timeSeriesTilesToAdd;
+    std::vector<PrioritizedTiled2dMapTileInfo> timeSeriesCandidates;
+    size_t numTargetTiles = 0;
 
     // make sure all tiles on the current zoom level are scheduled to load (as well as those from the level we always want to keep)
     for (const auto &layer : pyramid) {
@@ -924,9 +753,15 @@ void Tiled2dMapSource<L, R>::onVisibleTilesChanged(const std::vector<VisibleTile
             layer.targetZoomLevelOffset == keepZoomLevelOffset) {
             for (auto const &tileInfo : layer.visibleTiles) {
                 if (abs(tileInfo.tileInfo.t - layer.curT) > zoomInfo.numDrawPreviousOrLaterTLayers) {
+                    if (timeSeriesFrames > 0 && layer.targetZoomLevelOffset == 0) {
+                        timeSeriesCandidates.push_back(tileInfo);
+                    }
                     continue;
                 }
                 currentVisibleTiles.insert(tileInfo.tileInfo);
+                if (layer.targetZoomLevelOffset == 0 && tileInfo.tileInfo.t == layer.curT) {
+                    numTargetTiles++;
+                }
 
                 size_t currentTilesCount = currentTiles.count(tileInfo.tileInfo);
                 size_t currentlyLoadingCount = currentlyLoading.count(tileInfo.tileInfo);
@@ -938,12 +773,55 @@ void Tiled2dMapSource<L, R>::onVisibleTilesChanged(const std::vector<VisibleTile
                 }
 
                 if (currentTilesCount == 0 && currentlyLoadingCount == 0 && notFoundCount == 0 && errorTileCount == 0) {
-                    toAdd.push_back(tileInfo);
+                    if (prefetchedResults.count(tileInfo.tileInfo) != 0) {
+                        prefetchedTilesToAdd.push_back(tileInfo.tileInfo);
+                    } else if (timeSeriesResults.count(tileInfo.tileInfo) != 0) {
+                        timeSeriesTilesToAdd.push_back(tileInfo.tileInfo);
+                    } else {
+                        toAdd.push_back(tileInfo);
+                    }
                 }
             }
         }
     }
 
+    if (!prefetchTiles.empty()) {
+        int64_t hits = 0;
+        for (auto it = prefetchTiles.begin(); it != prefetchTiles.end();) {
+            if (currentVisibleTiles.count(*it) != 0) {
+                hits++;
+                it = prefetchTiles.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (hits > 0) {
+            prefetchHits += hits;
+            PERF_LOG_COUNT("Tiled2dMapSource_prefetchHits", hits);
+        }
+    }
+
+    if (timeSeriesFrames > 0) {
+        updateTimeSeriesWindow(numTargetTiles);
+        timeSeriesTiles.clear();
+        for (const auto &tileInfo : timeSeriesCandidates) {
+            if (!isInTimeSeriesWindow(tileInfo.tileInfo.t, curT)) {
+                continue;
+            }
+            timeSeriesTiles.insert(tileInfo.tileInfo);
+
+            bool isError = false;
+            for (auto const &[index, errors] : errorTiles) {
+                isError |= errors.count(tileInfo.tileInfo) != 0;
+            }
+            if (currentTiles.count(tileInfo.tileInfo) == 0 && currentlyLoading.count(tileInfo.tileInfo) == 0 &&
+                timeSeriesResults.count(tileInfo.tileInfo) == 0 && timeSeriesNotFoundTiles.count(tileInfo.tileInfo) == 0 &&
+                notFoundTiles.count(tileInfo.tileInfo) == 0 && !isError) {
+                toAdd.push_back(tileInfo);
+            }
+        }
+    }
+
     currentPyramid = pyramid;
     currentKeepZoomLevelOffset = keepZoomLevelOffset;
 
@@ -975,6 +853,16 @@ void Tiled2dMapSource<L, R>::onVisibleTilesChanged(const std::vector<VisibleTile
             }
         }
 
+        // time steps that are not drawn anymore are kept aside if they are still upcoming, and dropped otherwise to stay
+        // within the memory budget
+        if (found && timeSeriesFrames > 0 && tileInfo.zoomIdentifier == currentZoomLevelIdentifier &&
+            std::abs(tileInfo.t - curT) > zoomInfo.numDrawPreviousOrLaterTLayers) {
+            if (isInTimeSeriesWindow(tileInfo.t, curT)) {
+                timeSeriesResults.insert_or_assign(tileInfo, std::make_pair((size_t)0, tileWrapper.result));
+            }
+            found = false;
+        }
+
         if (!found) {
             toRemove.push_back(tileInfo);
         }
@@ -983,6 +871,7 @@ void Tiled2dMapSource<L, R>::onVisibleTilesChanged(const std::vector<VisibleTile
     for (const auto &removedTile : toRemove) {
         currentTiles.erase(removedTile);
         currentlyLoading.erase(removedTile);
+        currentLoadTokens.erase(removedTile);
 
         readyTiles.erase(removedTile);
 
@@ -1009,8 +898,8 @@ void Tiled2dMapSource<L, R>::onVisibleTilesChanged(const std::vector<VisibleTile
             }
         }
 
-        if (!found) {
-            cancelLoad(it->first, it->second);
+        if (!found && prefetchTiles.count(it->first) == 0 && timeSeriesTiles.count(it->first) == 0) {
+            cancelLoading(it->first, it->second);
             it = currentlyLoading.erase(it);
         } else
             it++;
@@ -1037,21 +926,50 @@ void Tiled2dMapSource<L, R>::onVisibleTilesChanged(const std::vector<VisibleTile
         }
     }
 
-    std::sort(toAdd.begin(), toAdd.end());
-    for(auto &queue : loadingQueues) {
-        queue.clear();
-    }
-    if(loadingQueues.empty()) {
+    if (loaderCount == 0) {
         // no loader (typically this means that the map layer setup is broken)
         for(auto &t : toAdd) {
             notFoundTiles.insert(t.tileInfo);
         }
     } else {
-        for(auto &t : toAdd) {
-            loadingQueues[0].push_back(t.tileInfo);
+        std::vector<Tiled2dMapSourceLoadScheduler::Request> requests;
+        requests.reserve(toAdd.size());
+        for (const auto &t : toAdd) {
+            requests.push_back({t.tileInfo, 0, t.priority});
+        }
+        loadScheduler->setRequests(getLoadSchedulerClientId(), requests);
+    }
+
+    for (const auto &tile : prefetchedTilesToAdd) {
+        auto prefetched = prefetchedResults.extract(tile);
+        didLoad(tile, prefetched.mapped().first, prefetched.mapped().second);
+    }
+    for (auto it = prefetchedResults.begin(); it != prefetchedResults.end();) {
+        if (prefetchTiles.count(it->first) == 0) {
+            it = prefetchedResults.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (const auto &tile : timeSeriesTilesToAdd) {
+        auto timeSeriesResult = timeSeriesResults.extract(tile);
+        didLoad(tile, timeSeriesResult.mapped().first, timeSeriesResult.mapped().second);
+    }
+    for (auto it = timeSeriesResults.begin(); it != timeSeriesResults.end();) {
+        if (timeSeriesTiles.count(it->first) == 0) {
+            it = timeSeriesResults.erase(it);
+        } else {
+            ++it;
         }
     }
-    scheduleFixedNumberOfLoadingTasks();
+    for (auto it = timeSeriesNotFoundTiles.begin(); it != timeSeriesNotFoundTiles.end();) {
+        if (timeSeriesTiles.count(*it) == 0) {
+            it = timeSeriesNotFoundTiles.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    updateTimeSeriesReadyFrames();
     // if we removed tiles, we potentially need to update the tilemasks - also if no new tile is loaded
     updateTileMasks();
 
@@ -1059,25 +977,51 @@ void Tiled2dMapSource<L, R>::onVisibleTilesChanged(const std::vector<VisibleTile
 }
 
 template <class L, class R>
-void Tiled2dMapSource<L, R>::scheduleFixedNumberOfLoadingTasks() {
-    // strictly prioritize by loader index; the fallback loaders must not block the primary loader.
-    // alternatively we could e.g. have a max number of ongoing loads per loader.
-    for(size_t loaderIndex = 0; loaderIndex < loadingQueues.size(); ++loaderIndex) {
-        auto &queue = loadingQueues[loaderIndex];
-        while(queue.size()>0 && currentlyLoading.size() < 16){
-            performLoadingTask(queue.front(), loaderIndex);
-            queue.erase(queue.begin());
+uint64_t Tiled2dMapSource<L, R>::getLoadSchedulerClientId() {
+    if (!loadSchedulerClientId) {
+        auto weakActor = WeakActor<Tiled2dMapSource>(mailbox, std::static_pointer_cast<Tiled2dMapSource>(shared_from_this()));
+        loadSchedulerClientId = loadScheduler->registerClient([weakActor](const Tiled2dMapTileInfo &tile, size_t loaderIndex, uint64_t loadToken) {
+            weakActor.message(MFN(&Tiled2dMapSource::performLoadingTask), tile, loaderIndex, loadToken);
+        });
+    }
+    return *loadSchedulerClientId;
+}
+
+template <class L, class R>
+uint64_t Tiled2dMapSource<L, R>::getPrefetchSchedulerClientId() {
+    if (!prefetchSchedulerClientId) {
+        auto weakActor = WeakActor<Tiled2dMapSource>(mailbox, std::static_pointer_cast<Tiled2dMapSource>(shared_from_this()));
+        prefetchSchedulerClientId = loadScheduler->registerClient([weakActor](const Tiled2dMapTileInfo &tile, size_t loaderIndex, uint64_t loadToken) {
+            weakActor.message(MFN(&Tiled2dMapSource::performLoadingTask), tile, loaderIndex, loadToken);
+        });
+    }
+    return *prefetchSchedulerClientId;
+}
+
+template <class L, class R>
+void Tiled2dMapSource<L, R>::requestLoad(const Tiled2dMapTileInfo &tile, size_t loaderIndex) {
+    int priority = std::numeric_limits<int>::max();
+    for (const auto &layer : currentPyramid) {
+        auto visibleTile = layer.visibleTiles.find({tile, 0});
+        if (visibleTile != layer.visibleTiles.end()) {
+            priority = visibleTile->priority;
+            break;
         }
     }
+    loadScheduler->addRequest(getLoadSchedulerClientId(), {tile, loaderIndex, priority});
 }
 
 template <class L, class R>
-void Tiled2dMapSource<L, R>::performLoadingTask(Tiled2dMapTileInfo tile, size_t loaderIndex) {
-    if (currentlyLoading.count(tile) != 0)
+void Tiled2dMapSource<L, R>::performLoadingTask(Tiled2dMapTileInfo tile, size_t loaderIndex, uint64_t loadToken) {
+    // a tile may be requested by both the visible and the prefetch requests
+    if (currentlyLoading.count(tile) != 0 || currentTiles.count(tile) != 0) {
+        loadScheduler->loadFinished(loadToken, false);
         return;
+    }
 
-    if (currentVisibleTiles.count(tile) == 0) {
+    if (currentVisibleTiles.count(tile) == 0 && prefetchTiles.count(tile) == 0 && timeSeriesTiles.count(tile) == 0) {
         errorTiles[loaderIndex].erase(tile);
+        loadScheduler->loadFinished(loadToken, false);
         return;
     }
 
@@ -1085,19 +1029,25 @@ void Tiled2dMapSource<L, R>::performLoadingTask(Tiled2dMapTileInfo tile, size_t
     auto weakActor = WeakActor<Tiled2dMapSource>(mailbox, std::static_pointer_cast<Tiled2dMapSource>(shared_from_this()));
 
     currentlyLoading.insert({tile, loaderIndex});
+    currentLoadTokens[tile] = loadToken;
     std::string layerName = layerConfig->getLayerName();
     readyTiles.erase(tile);
-    loadDataAsync(tile, loaderIndex).then([weakActor, loaderIndex, tile, weakSelfPtr, layerName](::djinni::Future<L> result) {
+    auto loadScheduler = this->loadScheduler;
+    loadScheduler->loadStarted(loadToken);
+    loadDataAsync(tile, loaderIndex).then([weakActor, loaderIndex, tile, weakSelfPtr, layerName, loadScheduler, loadToken](::djinni::Future<L> result) {
+        auto res = result.get();
+        // NOOP loads did not reach the loader's backend, their latency says nothing about its load
+        loadScheduler->loadFinished(loadToken, res->status != LoaderStatus::NOOP);
+
         auto strongSelf = weakSelfPtr.lock();
         if (strongSelf) {
-            auto res = result.get();
             if (res->status == LoaderStatus::OK) {
                 if (strongSelf->hasExpensivePostLoadingTask()) {
                     auto strongScheduler = strongSelf->scheduler.lock();
                     if (strongScheduler) {
                         strongScheduler->addTask(std::make_shared<LambdaTask>(
                                 TaskConfig("postLoadingTask", 0.0, TaskPriority::NORMAL, ExecutionEnvironment::COMPUTATION),
-                                [tile, loaderIndex, weakSelfPtr, weakActor, res] {
+                                [tile, loaderIndex, loadToken, weakSelfPtr, weakActor, res] {
                                     auto strongSelf = weakSelfPtr.lock();
                                     if (strongSelf) {
                                         auto isStillVisible = weakActor.syncAccess([tile](auto actor) {
@@ -1105,14 +1055,14 @@ void Tiled2dMapSource<L, R>::performLoadingTask(Tiled2dMapTileInfo tile, size_t
                                             return strongSelf ? strongSelf->isTileVisible(tile) : false;
                                         });
                                         if (isStillVisible == false) {
-                                            weakActor.message(MFN(&Tiled2dMapSource::didFailToLoad), tile, loaderIndex,
+                                            weakActor.message(MFN(&Tiled2dMapSource::didFailToLoadWithToken), tile, loaderIndex, loadToken,
                                                               LoaderStatus::ERROR_OTHER, std::nullopt);
                                         } else {
                                             try {
-                                            weakActor.message(MFN(&Tiled2dMapSource::didLoad), tile, loaderIndex, strongSelf->postLoadingTask(res, tile));
+                                            weakActor.message(MFN(&Tiled2dMapSource::didLoadWithToken), tile, loaderIndex, loadToken, strongSelf->postLoadingTask(res, tile));
                                             } catch (const std::exception &e) {
                                                 LogError << "Failed post-loading for tile " << tile.to_string_short() << " with error " <<= e.what();
-                                                weakActor.message(MFN(&Tiled2dMapSource::didFailToLoad), tile, loaderIndex,
+                                                weakActor.message(MFN(&Tiled2dMapSource::didFailToLoadWithToken), tile, loaderIndex, loadToken,
                                                                   LoaderStatus::ERROR_OTHER, std::nullopt);
                                             }
                                         }
@@ -1121,27 +1071,64 @@ void Tiled2dMapSource<L, R>::performLoadingTask(Tiled2dMapTileInfo tile, size_t
                     }
                 } else {
                     try {
-                        weakActor.message(MFN(&Tiled2dMapSource::didLoad), tile, loaderIndex, strongSelf->postLoadingTask(res, tile));
+                        weakActor.message(MFN(&Tiled2dMapSource::didLoadWithToken), tile, loaderIndex, loadToken, strongSelf->postLoadingTask(res, tile));
                     } catch (const std::exception &e) {
                         LogError << "Failed post-loading for tile " << tile.to_string_short() << " with error " <<= e.what();
-                        weakActor.message(MFN(&Tiled2dMapSource::didFailToLoad), tile, loaderIndex,LoaderStatus::ERROR_OTHER, std::nullopt);
+                        weakActor.message(MFN(&Tiled2dMapSource::didFailToLoadWithToken), tile, loaderIndex, loadToken, LoaderStatus::ERROR_OTHER, std::nullopt);
                     }
                 }
             } else {
-                weakActor.message(MFN(&Tiled2dMapSource::didFailToLoad), tile, loaderIndex, res->status, res->errorCode);
+                weakActor.message(MFN(&Tiled2dMapSource::didFailToLoadWithToken), tile, loaderIndex, loadToken, res->status, res->errorCode);
             }
         }
     });
 }
 
+template <class L, class R>
+void Tiled2dMapSource<L, R>::cancelLoading(const Tiled2dMapTileInfo &tile, size_t loaderIndex) {
+    cancelLoad(tile, loaderIndex);
+    auto token = currentLoadTokens.find(tile);
+    if (token != currentLoadTokens.end()) {
+        loadScheduler->loadCancelled(token->second);
+    }
+}
+
+template <class L, class R>
+void Tiled2dMapSource<L, R>::didLoadWithToken(Tiled2dMapTileInfo tile, size_t loaderIndex, uint64_t loadToken, const R &result) {
+    auto token = currentLoadTokens.find(tile);
+    if (token != currentLoadTokens.end() && token->second != loadToken) {
+        return;
+    }
+    didLoad(tile, loaderIndex, result);
+}
+
+template <class L, class R>
+void Tiled2dMapSource<L, R>::didFailToLoadWithToken(Tiled2dMapTileInfo tile, size_t loaderIndex, uint64_t loadToken,
+                                                    const LoaderStatus &status, const std::optional<std::string> &errorCode) {
+    auto token = currentLoadTokens.find(tile);
+    if (token != currentLoadTokens.end() && token->second != loadToken) {
+        return;
+    }
+    didFailToLoad(tile, loaderIndex, status, errorCode);
+}
+
 template <class L, class R>
 void Tiled2dMapSource<L, R>::didLoad(Tiled2dMapTileInfo tile, size_t loaderIndex, const R &result) {
     currentlyLoading.erase(tile);
-    scheduleFixedNumberOfLoadingTasks();
+    currentLoadTokens.erase(tile);
 
     std::string layerName = layerConfig->getLayerName();
     const bool isVisible = currentVisibleTiles.count(tile);
     if (!isVisible) {
+        if (prefetchTiles.count(tile) != 0) {
+            prefetchedResults.insert_or_assign(tile, std::make_pair(loaderIndex, result));
+        } else if (timeSeriesTiles.count(tile) != 0) {
+            timeSeriesTileMemorySize = std::max(timeSeriesTileMemorySize, getResultMemorySize(result));
+            timeSeriesResults.insert_or_assign(tile, std::make_pair(loaderIndex, result));
+            errorTiles[loaderIndex].erase(tile);
+            updateTimeSeriesReadyFrames();
+            return;
+        }
         errorTiles[loaderIndex].erase(tile);
         return;
     }
@@ -1174,11 +1161,25 @@ template <class L, class R>
 void Tiled2dMapSource<L, R>::didFailToLoad(Tiled2dMapTileInfo tile, size_t loaderIndex, const LoaderStatus &status,
                                               const std::optional<std::string> &errorCode) {
     currentlyLoading.erase(tile);
+    currentLoadTokens.erase(tile);
 
     const bool isVisible = currentVisibleTiles.count(tile);
     if (!isVisible) {
         errorTiles[loaderIndex].erase(tile);
-        scheduleFixedNumberOfLoadingTasks();
+        if (prefetchTiles.count(tile) != 0) {
+            // like visible tiles, predicted tiles fall back to the next loader
+            if (status == LoaderStatus::NOOP && loaderIndex + 1 < loaderCount) {
+                loadScheduler->addRequest(getPrefetchSchedulerClientId(), {tile, loaderIndex + 1, std::numeric_limits<int>::max()});
+            }
+        } else if (timeSeriesTiles.count(tile) != 0) {
+            // other errors are retried with the next update of the visible tiles
+            if (status == LoaderStatus::NOOP && loaderIndex + 1 < loaderCount) {
+                requestLoad(tile, loaderIndex + 1);
+            } else if (status == LoaderStatus::NOOP || status == LoaderStatus::ERROR_400 || status == LoaderStatus::ERROR_404) {
+                timeSeriesNotFoundTiles.insert(tile);
+                updateTimeSeriesReadyFrames();
+            }
+        }
         return;
     }
 
@@ -1193,8 +1194,8 @@ void Tiled2dMapSource<L, R>::didFailToLoad(Tiled2dMapTileInfo tile, size_t loade
         errorTiles[loaderIndex].erase(tile);
 
         auto newLoaderIndex = loaderIndex + 1;
-        if(newLoaderIndex < loadingQueues.size()) {
-            loadingQueues[newLoaderIndex].push_back(tile);
+        if(newLoaderIndex < loaderCount) {
+            requestLoad(tile, newLoaderIndex);
             break;
         } else {
             [[fallthrough]]; // no more loaders, treat this same as not found.
@@ -1251,7 +1252,6 @@ void Tiled2dMapSource<L, R>::didFailToLoad(Tiled2dMapTileInfo tile, size_t loade
         break;
     }
     }
-    scheduleFixedNumberOfLoadingTasks();
 
     // XXX: why???
     updateTileMasks();
@@ -1279,7 +1279,7 @@ template <class L, class R> void Tiled2dMapSource<L, R>::performDelayedTasks() {
     }
 
     for (auto &[loaderIndex, tile] : toLoad) {
-        performLoadingTask(tile, loaderIndex);
+        requestLoad(tile, loaderIndex);
     }
 
     if (minDelay != std::numeric_limits<int64_t>::max()) {
@@ -1508,7 +1508,7 @@ template <class L, class R> void Tiled2dMapSource<L, R>::forceReload() {
         }
     }
     for (const auto &[tile, loaderIndex] : newLoadingTasks) {
-        performLoadingTask(tile, loaderIndex);
+        requestLoad(tile, loaderIndex);
     }
 
     onVisibleTilesChanged(currentPyramid, currentKeepZoomLevelOffset);
@@ -1520,10 +1520,19 @@ template <class L, class R> void Tiled2dMapSource<L, R>::reloadTiles() {
     readyTiles.clear();
 
     for (auto it = currentlyLoading.begin(); it != currentlyLoading.end(); ++it) {
-        cancelLoad(it->first, it->second);
+        cancelLoading(it->first, it->second);
     }
     currentlyLoading.clear();
     errorTiles.clear();
+    prefetchTiles.clear();
+    prefetchedResults.clear();
+    timeSeriesTiles.clear();
+    timeSeriesResults.clear();
+    timeSeriesNotFoundTiles.clear();
+    timeSeriesReadyFrames = -1;
+    if (prefetchSchedulerClientId) {
+        loadScheduler->setRequests(*prefetchSchedulerClientId, {});
+    }
 
     lastVisibleTilesHash = -1;
     onVisibleTilesChanged(currentPyramid, false, currentKeepZoomLevelOffset);
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "SchedulerInterface.h"
+#include "Tiled2dMapTileInfo.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Schedules the tile loads of all Tiled2dMapSources of a map (i.e. of all sources sharing a SchedulerInterface).
+ *
+ * Pending loads are kept in one priority heap, ordered by loader index (fallback loaders last), tile priority and
+ * arrival. Sources replace their pending requests whenever the visible tiles change, requests that stay pending are
+ * reprioritized in place.
+ *
+ * The number of concurrent loads adapts to the observed loader latency: it grows while the latency of a source and
+ * loader stays close to the lowest latency seen for it, and shrinks when loads get slower, i.e. when the loader or
+ * the server behind it is saturated.
+ */
+class Tiled2dMapSourceLoadScheduler {
+  public:
+    struct Config {
+        size_t minConcurrentLoads = 4;
+        size_t maxConcurrentLoads = 64;
+        size_t initialConcurrentLoads = 16;
+        // latency increase over the lowest observed latency that is still tolerated without reducing concurrency
+        double latencyTolerance = 2.0;
+        // time source of the latency measurements
+        std::function<std::chrono::steady_clock::time_point()> now = std::chrono::steady_clock::now;
+    };
+
+    struct Request {
+        Tiled2dMapTileInfo tile;
+        size_t loaderIndex;
+        int priority;
+    };
+
+    // Called (from any thread, without holding locks) when a request may be loaded. The client must report the
+    // outcome with loadStarted / loadFinished using the given token.
+    using StartLoadCallback = std::function<void(const Tiled2dMapTileInfo &tile, size_t loaderIndex, uint64_t token)>;
+
+    Tiled2dMapSourceLoadScheduler();
+
+    Tiled2dMapSourceLoadScheduler(const Config &config);
+
+    // Shared instance for all sources using the given scheduler
+    static std::shared_ptr<Tiled2dMapSourceLoadScheduler> getInstance(const std::shared_ptr<SchedulerInterface> &scheduler);
+
+    uint64_t registerClient(StartLoadCallback startLoad);
+
+    // Drops the pending requests of the client. Loads that were already started must still be finished.
+    void unregisterClient(uint64_t clientId);
+
+    // Replaces all pending requests of the client. Requests for tiles that are already loading are ignored, pending
+    // requests keep their loader index.
+    void setRequests(uint64_t clientId, const std::vector<Request> &requests);
+
+    // Adds a request or updates the pending request for the same tile
+    void addRequest(uint64_t clientId, const Request &request);
+
+    void loadStarted(uint64_t token);
+
+    // Frees the slot of the load. The time since loadStarted is used to adapt the concurrency if countLatency is set.
+    void loadFinished(uint64_t token, bool countLatency);
+
+    // Frees the slot of a cancelled load without counting its latency, the tile may be requested again right away.
+    // Finishing the load later on has no effect.
+    void loadCancelled(uint64_t token);
+
+    size_t getConcurrencyLimit();
+
+    size_t getNumLoading();
+
+    size_t getNumPending();
+
+    // Pending requests of a client, i.e. requests that were not yet handed to the client to load
+    size_t getNumPending(uint64_t clientId);
+
+  private:
+    struct RequestKey {
+        uint64_t clientId;
+        Tiled2dMapTileInfo tile;
+
+        bool operator==(const RequestKey &o) const { return clientId == o.clientId && tile == o.tile; }
+    };
+
+    struct RequestKeyHash {
+        size_t operator()(const RequestKey &key) const {
+            size_t res = std::hash<uint64_t>()(key.clientId);
+            res = res * 31 + std::hash<Tiled2dMapTileInfo>()(key.tile);
+            return res;
+        }
+    };
+
+    struct PendingRequest {
+        RequestKey key;
+        size_t loaderIndex;
+        int priority;
+        uint64_t sequence;
+    };
+
+    struct Load {
+        RequestKey key;
+        size_t loaderIndex;
+        std::optional<std::chrono::steady_clock::time_point> startTime;
+    };
+
+    struct LatencyStats {
+        double minLatencyMs = -1.0;
+        double averageLatencyMs = -1.0;
+        size_t numSamples = 0;
+    };
+
+    struct Grant {
+        StartLoadCallback callback;
+        Tiled2dMapTileInfo tile;
+        size_t loaderIndex;
+        uint64_t token;
+    };
+
+    static bool isBefore(const PendingRequest &lhs, const PendingRequest &rhs);
+
+    void addRequestLocked(uint64_t clientId, const Request &request);
+
+    void removeRequestsLocked(const std::function<bool(const RequestKey &key)> &predicate);
+
+    void removeAt(size_t index);
+
+    void restoreHeapAt(size_t index);
+
+    void siftUp(size_t index);
+
+    void siftDown(size_t index);
+
+    void swapEntries(size_t a, size_t b);
+
+    void updateLimitLocked(uint64_t clientId, size_t loaderIndex, double latencyMs);
+
+    std::vector<Grant> collectGrantsLocked();
+
+    void dispatch(std::vector<Grant> grants);
+
+    static constexpr double limitSmoothing = 0.1;
+    static constexpr double latencySmoothing = 0.2;
+    // the lowest latency is re-measured periodically, as it may change over time (e.g. a different network)
+    static constexpr size_t minLatencyResetSamples = 500;
+
+    const Config config;
+
+    std::mutex mutex;
+    double limit;
+    uint64_t nextClientId = 1;
+    uint64_t nextToken = 1;
+    uint64_t nextSequence = 0;
+
+    std::unordered_map<uint64_t, StartLoadCallback> clients;
+
+    // binary min-heap of the pending requests, with the index of every request
+    std::vector<PendingRequest> heap;
+    std::unordered_map<RequestKey, size_t, RequestKeyHash> heapIndices;
+
+    std::unordered_map<uint64_t, Load> loads;
+    std::unordered_map<RequestKey, uint64_t, RequestKeyHash> loadTokens;
+
+    std::unordered_map<uint64_t, std::unordered_map<size_t, LatencyStats>> latencyStats;
+};
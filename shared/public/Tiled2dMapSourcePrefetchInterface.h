@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "RectCoord.h"
+#include <cstdint>
+#include <optional>
+
+class Tiled2dMapSourcePrefetchInterface {
+  public:
+    virtual ~Tiled2dMapSourcePrefetchInterface() = default;
+
+    virtual void setPrefetchEnabled(bool enabled) = 0;
+
+    // Bounds and zoom the camera is predicted to come to rest at, std::nullopt if the camera is not moving.
+    // Tiles covering the predicted bounds are loaded with a lower priority than the visible tiles.
+    virtual void onPrefetchBoundsChanged(const std::optional<::RectCoord> &predictedBounds, int32_t curT, double zoom) = 0;
+};
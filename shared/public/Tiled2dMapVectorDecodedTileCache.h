@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "StringInterner.h"
+#include "Tiled2dMapVectorTileInfo.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+/**
+ * Byte-budgeted LRU cache of decoded and triangulated vector tiles, keyed by tile url and the decoded source layers.
+ *
+ * A cache instance can be shared between vector layers and map instances (see Tiled2dMapVectorLayer::setDecodedTileCache).
+ * Feature properties are keyed by strings interned in the StringInterner of the layer that decoded the tile. If a
+ * tile is requested with another StringInterner, the feature contexts are copied with translated keys, the
+ * geometries are shared.
+ *
+ * Hits, misses and evictions are counted in getStatistics() and, if enabled, in the PerformanceLogger.
+ */
+class Tiled2dMapVectorDecodedTileCache {
+  public:
+    struct Statistics {
+        int64_t hits;
+        int64_t misses;
+        int64_t evictions;
+        size_t numEntries;
+        size_t sizeBytes;
+    };
+
+    static constexpr size_t defaultMaxSizeBytes = 64 * 1024 * 1024;
+
+    Tiled2dMapVectorDecodedTileCache(size_t maxSizeBytes = defaultMaxSizeBytes);
+
+    static std::string createKey(const std::string &tileUrl, const std::unordered_set<std::string> &layersToDecode);
+
+    // Returns nullptr if the tile is not cached
+    Tiled2dMapVectorTileInfo::FeatureMap get(const std::string &key, const std::shared_ptr<StringInterner> &stringTable);
+
+    void put(const std::string &key, const std::shared_ptr<StringInterner> &stringTable, const Tiled2dMapVectorTileInfo::FeatureMap &featureMap);
+
+    void setMaxSizeBytes(size_t maxSizeBytes);
+
+    void clear();
+
+    Statistics getStatistics();
+
+    // Approximate heap size of a decoded tile
+    static size_t estimateSizeBytes(const Tiled2dMapVectorTileInfo::FeatureMap &featureMap);
+
+  private:
+    struct Entry {
+        Tiled2dMapVectorTileInfo::FeatureMap featureMap;
+        std::shared_ptr<StringInterner> stringTable;
+        size_t sizeBytes;
+        std::list<std::string>::iterator lruIterator;
+    };
+
+    static Tiled2dMapVectorTileInfo::FeatureMap translateKeys(const Tiled2dMapVectorTileInfo::FeatureMap &featureMap,
+                                                              const StringInterner &sourceTable, StringInterner &targetTable);
+
+    void evictLocked(size_t maxSizeBytes);
+
+    std::mutex mutex;
+    size_t maxSizeBytes;
+    size_t sizeBytes = 0;
+    std::list<std::string> lruOrder;
+    std::unordered_map<std::string, Entry> entries;
+
+    int64_t hits = 0;
+    int64_t misses = 0;
+    int64_t evictions = 0;
+};
@@ -214,6 +214,25 @@ class Tiled2dMapVectorLayer : public Tiled2dMapLayer,
     StringInterner& getStringInterner() { return *stringTable; }
     const StringInterner& getStringInterner() const { return *stringTable; }
 
+    /**
+     * Cache for decoded vector tiles, may be shared with other layers and maps. Only applies to sources created
+     * afterwards, i.e. set it before adding the layer to a map.
+     */
+    void setDecodedTileCache(const std::shared_ptr<Tiled2dMapVectorDecodedTileCache> &decodedTileCache);
+
+    /**
+     * Persistent store for decoded tiles (see Tiled2dMapVectorPackedTile), reloading a stored tile skips the decoding and
+     * triangulation. Stored tiles older than maxAgeMillis are loaded again. Only applies to sources created afterwards.
+     */
+    void setPackedTileStore(const std::shared_ptr<TilePackFile> &packedTileStore, int64_t maxAgeMillis);
+
+    /**
+     * Simplifies the lines of vector tiles when decoding, dropping vertices closer than tolerancePixels to the simplified
+     * line at the largest scale a tile is shown at. Tiles of the most detailed level are not simplified, they may be shown
+     * overzoomed. 0 (default) keeps all vertices. Only applies to sources created afterwards.
+     */
+    void setLineSimplificationTolerance(float tolerancePixels);
+
 	protected:
     virtual void setMapDescription(const std::shared_ptr<VectorMapDescription> &mapDescription);
 
@@ -276,6 +295,13 @@ class Tiled2dMapVectorLayer : public Tiled2dMapLayer,
 
     const std::shared_ptr<FontLoaderInterface> fontLoader;
 
+    std::shared_ptr<Tiled2dMapVectorDecodedTileCache> decodedTileCache;
+
+    std::shared_ptr<TilePackFile> packedTileStore;
+    int64_t packedTileMaxAgeMillis = 0;
+
+    float lineSimplificationTolerance = 0.0;
+
     std::unordered_map<std::string, Actor<Tiled2dMapVectorSourceTileDataManager>> sourceDataManagers;
     std::unordered_map<std::string, Actor<Tiled2dMapVectorSourceSymbolDataManager>> symbolSourceDataManagers;
     Actor<Tiled2dMapVectorSourceSymbolCollisionManager> collisionManager;
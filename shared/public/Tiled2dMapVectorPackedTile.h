@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "CoordinateConversionHelperInterface.h"
+#include "RectCoord.h"
+#include "StringInterner.h"
+#include "Tiled2dMapVectorTileInfo.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Binary serialization of a decoded vector tile (see Tiled2dMapVectorSource::postLoadingTask): the feature properties
+ * and the geometries, with lines and points already converted to the layer system and polygons converted to the render
+ * system and triangulated. Reading a packed tile skips the protobuf decoding, the coordinate conversion and earcut,
+ * coordinate and index arrays are copied as they are.
+ *
+ * Packed tiles start with a magic number and a version, tiles of other versions are rejected. Numbers are stored in
+ * host byte order, packed tiles are meant for a cache on the same device (e.g. a TilePackFile).
+ *
+ * Styling is not part of a packed tile: the style dependent work (filters, line extrusion, ...) is done when the
+ * tile is set up for the sublayers, as for tiles decoded from protobuf.
+ */
+class Tiled2dMapVectorPackedTile {
+  public:
+    static constexpr uint32_t version = 1;
+
+    static std::vector<uint8_t> pack(const Tiled2dMapVectorTileInfo::FeatureMap &featureMap, const StringInterner &stringTable);
+
+    // Returns nullptr if the data is not a packed tile of this version or is truncated
+    static Tiled2dMapVectorTileInfo::FeatureMap unpack(const uint8_t *data, size_t size, const ::RectCoord &tileBounds,
+                                                       StringInterner &stringTable,
+                                                       const std::shared_ptr<CoordinateConversionHelperInterface> &conversionHelper);
+
+  private:
+    static constexpr uint32_t magic = 0x54564d4f; // "OMVT"
+};
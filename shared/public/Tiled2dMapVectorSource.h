@@ -15,8 +15,10 @@
 #include "DataLoaderResult.h"
 #include "LoaderInterface.h"
 #include "StringInterner.h"
+#include "Tiled2dMapVectorDecodedTileCache.h"
 #include "Tiled2dMapVectorTileInfo.h"
 #include "Tiled2dMapVectorSourceListener.h"
+#include "TilePackFile.h"
 #include <vector>
 
 class Tiled2dMapVectorLayer;
@@ -34,7 +36,11 @@ public:
                            const std::unordered_set<std::string> &layersToDecode,
                            const std::string &sourceName,
                            float screenDensityPpi,
-                           std::string layerName);
+                           std::string layerName,
+                           const std::shared_ptr<Tiled2dMapVectorDecodedTileCache> &decodedTileCache = nullptr,
+                           const std::shared_ptr<TilePackFile> &packedTileStore = nullptr,
+                           int64_t packedTileMaxAgeMillis = 0,
+                           float lineSimplificationTolerance = 0.0);
 
     VectorSet<Tiled2dMapVectorTileInfo> getCurrentTiles();
 
@@ -63,4 +69,27 @@ protected:
     const std::string sourceName;
 
     const std::weak_ptr<StringInterner> stringTable;
+
+    const std::shared_ptr<Tiled2dMapVectorDecodedTileCache> decodedTileCache;
+    // cache hits of loadDataAsync, handed over to postLoadingTask, guarded by loadingTilesMutex
+    std::unordered_map<Tiled2dMapTileInfo, Tiled2dMapVectorTileInfo::FeatureMap> cachedFeatureMaps;
+
+    // decoded tiles in the format of Tiled2dMapVectorPackedTile, kept across sessions
+    const std::shared_ptr<TilePackFile> packedTileStore;
+    const int64_t packedTileMaxAgeMillis;
+    // tiles whose loaded data is a packed tile instead of protobuf, guarded by loadingTilesMutex
+    std::unordered_set<Tiled2dMapTileInfo> packedTiles;
+
+    // Returns nullptr if the loaded data is not a valid packed tile
+    Tiled2dMapVectorTileInfo::FeatureMap unpackTile(const std::shared_ptr<DataLoaderResult> &loadedData, const Tiled2dMapTileInfo &tile);
+
+    std::string getPackedTileKey(const std::string &url) const;
+
+    // in pixels, see Tiled2dMapVectorLayer::setLineSimplificationTolerance
+    const float lineSimplificationTolerance;
+
+    // in units of the tile extent, 0 if the lines of the tile are not simplified
+    double getLineSimplificationTolerance(const Tiled2dMapTileInfo &tile, int extent) const;
+
+    std::string getDecodedTileKey(const std::string &url) const;
 };
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "Coord.h"
+#include "CoordinateConversionHelperInterface.h"
+#include "MapCameraState.h"
+#include "PolygonCoord.h"
+#include "PrioritizedTiled2dMapTileInfo.h"
+#include "Tiled2dMapZoomLevelInfo.h"
+#include "Vec3D.h"
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct VisibleTileCandidate {
+    int x;
+    int y;
+    int levelIndex;
+    bool operator==(const VisibleTileCandidate &other) const {
+        return x == other.x && y == other.y && levelIndex == other.levelIndex;
+    }
+};
+
+namespace std {
+template <> struct hash<VisibleTileCandidate> {
+    size_t operator()(const VisibleTileCandidate &candidate) const {
+        size_t h1 = hash<int>()(candidate.x);
+        size_t h2 = hash<int>()(candidate.y);
+        size_t h3 = hash<int>()(candidate.levelIndex);
+
+        // Combine hashes using a simple combining function, based on the one from Boost library
+        return h1 ^ (h2 << 1) ^ (h3 << 2);
+    }
+};
+} // namespace std
+
+/**
+ * Computes the tiles visible from a camera (see Tiled2dMapSourceInterface::onCameraChange) by traversing the tile
+ * pyramid from the top level down to the level precise enough for the screen.
+ *
+ * The traversal only depends on the camera and the tiling of a source. Sources with the same tiling (e.g. several
+ * WebMercator sources of a style) share one instance per map, the pyramid is traversed once per camera frame and
+ * tiling, by the first source asking for it; the other sources get the same result.
+ */
+class Tiled2dMapVisibleTilesPyramid {
+  public:
+    struct Tiling {
+        Tiling() = default;
+
+        Tiling(int32_t layerSystemId, int32_t mapSystemId, const std::vector<Tiled2dMapZoomLevelInfo> &zoomLevelInfos,
+               int32_t topMostZoomLevel, float zoomLevelScaleFactor);
+
+        bool operator==(const Tiling &o) const;
+
+        int32_t layerSystemId = 0;
+        int32_t mapSystemId = 0;
+        // including the virtual levels, sorted by descending zoom
+        std::vector<Tiled2dMapZoomLevelInfo> zoomLevelInfos;
+        int32_t topMostZoomLevel = 0;
+        float zoomLevelScaleFactor = 1.0;
+        size_t hash = 0;
+    };
+
+    using Camera = MapCameraState;
+
+    struct Result {
+        // false if the traversal was aborted
+        bool valid = false;
+        bool validViewBounds = false;
+        int minZoomLevelIndex = 0;
+        int maxLevel = 0;
+        std::vector<std::pair<VisibleTileCandidate, PrioritizedTiled2dMapTileInfo>> visibleTiles;
+        // the area of the world not covered by the visible tiles
+        std::vector<PolygonCoord> viewBounds;
+    };
+
+    Tiled2dMapVisibleTilesPyramid(const std::shared_ptr<CoordinateConversionHelperInterface> &conversionHelper);
+
+    // Shared instance for all sources using the given conversion helper, i.e. of the same map
+    static std::shared_ptr<Tiled2dMapVisibleTilesPyramid>
+    getInstance(const std::shared_ptr<CoordinateConversionHelperInterface> &conversionHelper);
+
+    // Returns the result of an earlier traversal for the same camera and tiling, or traverses the pyramid. Concurrent
+    // calls for the same camera and tiling wait for the first one.
+    std::shared_ptr<const Result> getVisibleTiles(const Tiling &tiling, const std::shared_ptr<const Camera> &camera);
+
+    std::shared_ptr<const Result> getVisibleTiles(const Tiling &tiling, const Camera &camera);
+
+    // Traverses the pyramid without looking up or storing the result
+    std::shared_ptr<const Result> computeVisibleTiles(const Tiling &tiling, const Camera &camera);
+
+    size_t getNumComputations();
+
+  private:
+    struct Frame {
+        // sources of a layer get the same snapshot from the camera, compared by pointer first
+        std::shared_ptr<const Camera> camera;
+        std::vector<std::pair<Tiling, std::shared_future<std::shared_ptr<const Result>>>> results;
+    };
+
+    std::shared_ptr<const Result> computeVisibleTilesInternal(const Tiling &tiling, const Camera &camera);
+
+    ::Vec3D transformToView(const ::Coord &position, const std::vector<float> &viewMatrix, const Vec3D &origin);
+
+    static ::Vec3D projectToScreen(const ::Vec3D &point, const std::vector<float> &projectionMatrix);
+
+    // sources may lag a frame behind each other, results are kept for a few camera frames
+    static constexpr size_t maxFrames = 4;
+
+    const std::shared_ptr<CoordinateConversionHelperInterface> conversionHelper;
+
+    std::mutex mutex;
+    std::deque<Frame> frames;
+    size_t numComputations = 0;
+};
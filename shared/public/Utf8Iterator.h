@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+/**
+ * Iterates the letters of a UTF-8 string without allocating, each letter is a view of its bytes in the string.
+ *
+ * Like the glyphs of the fonts, only letters of the basic multilingual plane are returned. Letters outside of it (e.g.
+ * emojis) and invalid bytes are skipped.
+ */
+class Utf8Iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view *;
+    using reference = std::string_view;
+
+    Utf8Iterator() = default;
+
+    Utf8Iterator(std::string_view string, size_t position)
+        : string(string), position(position) {
+        findValid();
+    }
+
+    std::string_view operator*() const { return string.substr(position, length); }
+
+    // The unicode code point of the current letter
+    uint32_t codepoint() const { return value; }
+
+    // Byte offset of the current letter in the string
+    size_t offset() const { return position; }
+
+    Utf8Iterator &operator++() {
+        position += length;
+        findValid();
+        return *this;
+    }
+
+    Utf8Iterator operator++(int) {
+        auto copy = *this;
+        ++(*this);
+        return copy;
+    }
+
+    bool operator==(const Utf8Iterator &other) const { return position == other.position; }
+    bool operator!=(const Utf8Iterator &other) const { return position != other.position; }
+
+    // Decodes the letter at the start of bytes, returns its length in bytes or 0 if the bytes are not valid UTF-8
+    static size_t decode(std::string_view bytes, uint32_t &codepoint) {
+        if (bytes.empty()) {
+            return 0;
+        }
+        const auto b0 = (uint8_t)bytes[0];
+        if (b0 < 0x80) {
+            codepoint = b0;
+            return 1;
+        }
+        size_t length;
+        uint32_t c;
+        uint32_t min;
+        if (b0 >= 0xC2 && b0 < 0xE0) {
+            length = 2;
+            c = b0 & 0x1F;
+            min = 0x80;
+        } else if (b0 >= 0xE0 && b0 < 0xF0) {
+            length = 3;
+            c = b0 & 0x0F;
+            min = 0x800;
+        } else if (b0 >= 0xF0 && b0 < 0xF5) {
+            length = 4;
+            c = b0 & 0x07;
+            min = 0x10000;
+        } else {
+            return 0;
+        }
+        if (bytes.size() < length) {
+            return 0;
+        }
+        for (size_t i = 1; i < length; ++i) {
+            if (((uint8_t)bytes[i] & 0xC0) != 0x80) {
+                return 0;
+            }
+            c = (c << 6) | ((uint8_t)bytes[i] & 0x3F);
+        }
+        // overlong encodings, surrogates and values above the unicode range
+        if (c < min || (c >= 0xD800 && c < 0xE000) || c > 0x10FFFF) {
+            return 0;
+        }
+        codepoint = c;
+        return length;
+    }
+
+    // Appends the UTF-8 encoding of codepoint to string
+    static void append(std::string &string, uint32_t codepoint) {
+        if (codepoint < 0x80) {
+            string.push_back((char)codepoint);
+        } else if (codepoint < 0x800) {
+            string.push_back((char)(0xC0 | (codepoint >> 6)));
+            string.push_back((char)(0x80 | (codepoint & 0x3F)));
+        } else if (codepoint < 0x10000) {
+            string.push_back((char)(0xE0 | (codepoint >> 12)));
+            string.push_back((char)(0x80 | ((codepoint >> 6) & 0x3F)));
+            string.push_back((char)(0x80 | (codepoint & 0x3F)));
+        } else {
+            string.push_back((char)(0xF0 | (codepoint >> 18)));
+            string.push_back((char)(0x80 | ((codepoint >> 12) & 0x3F)));
+            string.push_back((char)(0x80 | ((codepoint >> 6) & 0x3F)));
+            string.push_back((char)(0x80 | (codepoint & 0x3F)));
+        }
+    }
+
+  private:
+    void findValid() {
+        while (position < string.size()) {
+            length = decode(string.substr(position), value);
+            if (length > 0 && value < 0x10000) {
+                return;
+            }
+            // skip letters outside of the basic multilingual plane as a whole, invalid bytes one by one
+            position += std::max(length, (size_t)1);
+        }
+        position = string.size();
+        length = 0;
+    }
+
+    std::string_view string;
+    size_t position = 0;
+    size_t length = 0;
+    uint32_t value = 0;
+};
+
+/**
+ * The letters of a UTF-8 string, to be used in a range based for loop. The string has to outlive the range.
+ */
+class Utf8Letters {
+  public:
+    explicit Utf8Letters(std::string_view string)
+        : string(string) {}
+
+    Utf8Iterator begin() const { return Utf8Iterator(string, 0); }
+    Utf8Iterator end() const { return Utf8Iterator(string, string.size()); }
+
+  private:
+    std::string_view string;
+};
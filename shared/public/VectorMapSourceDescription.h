@@ -63,6 +63,8 @@ public:
     std::map<std::string, std::shared_ptr<GeoJSONVTInterface>> geoJsonSources;
     bool persistingSymbolPlacement;
     std::optional<bool> use3xSprites;
+    // draw line and polygon layers of neighbouring tiles from shared buffers (see Tiled2dMapVectorGeometryBatch)
+    bool batchTileGeometry;
 
     VectorMapDescription(std::string identifier,
                          std::vector<std::shared_ptr<VectorMapSourceDescription>> vectorSources,
@@ -70,12 +72,14 @@ public:
                          std::vector<SpriteSourceDescription> sprites,
                          std::map<std::string, std::shared_ptr<GeoJSONVTInterface>> geoJsonSources,
                          bool persistingSymbolPlacement,
-                         std::optional<bool> use3xSprites)
+                         std::optional<bool> use3xSprites,
+                         bool batchTileGeometry = false)
         : identifier(std::move(identifier))
         , vectorSources(std::move(vectorSources))
         , layers(std::move(layers))
         , sprites(std::move(sprites))
         , geoJsonSources(std::move(geoJsonSources))
         , persistingSymbolPlacement(persistingSymbolPlacement)
-        , use3xSprites(use3xSprites) {}
+        , use3xSprites(use3xSprites)
+        , batchTileGeometry(batchTileGeometry) {}
 };
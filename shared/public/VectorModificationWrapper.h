@@ -9,6 +9,10 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <utility>
 #include <vector>
 
 /**
@@ -16,12 +20,14 @@
  * @brief A wrapper for a `std::vector` that tracks modifications.
  *
  * This class provides functionality to wrap a `std::vector` and track
- * whether the vector has been modified. The `modified` flag is set
- * under the following conditions:
- * - Accessing elements via the `operator[]` for writing.
+ * whether the vector has been modified, and which range of elements was
+ * modified. The `modified` flag is set under the following conditions:
+ * - Assigning a different value to an element accessed via `operator[]`.
  * - Adding elements using the `push_back()` or `emplace_back()` methods.
  * - resizing the vector via the `resize()` method
 
+ * Writing an unchanged value does not set the flag. Adding elements extends
+ * the modified range, resizing and `setModified()` mark the whole vector.
  * Use the `resetModificationFlag()` method to reset the modification
  * state after changes are processed.
  *
@@ -32,8 +38,53 @@ class VectorModificationWrapper {
   private:
     std::vector<T> vec;
     bool modified;
+    size_t modifiedBegin = std::numeric_limits<size_t>::max();
+    size_t modifiedEnd = 0;
+
+    void markModified(size_t begin, size_t end) {
+        modified = true;
+        modifiedBegin = std::min(modifiedBegin, begin);
+        modifiedEnd = std::max(modifiedEnd, end);
+    }
 
   public:
+    /**
+     * Element access returned by the non-const `operator[]`, marks the element
+     * as modified when a different value is assigned.
+     */
+    class Reference {
+      public:
+        Reference(VectorModificationWrapper &wrapper, size_t index)
+            : wrapper(wrapper)
+            , index(index) {}
+
+        Reference(const Reference &other) = default;
+
+        operator const T &() const { return wrapper.vec[index]; }
+
+        Reference &operator=(const T &value) {
+            if (!(wrapper.vec[index] == value)) {
+                wrapper.vec[index] = value;
+                wrapper.markModified(index, index + 1);
+            }
+            return *this;
+        }
+
+        Reference &operator=(const Reference &other) { return *this = (const T &)other; }
+
+        template <typename U> Reference &operator+=(const U &value) { return *this = (T)(wrapper.vec[index] + value); }
+
+        template <typename U> Reference &operator-=(const U &value) { return *this = (T)(wrapper.vec[index] - value); }
+
+        template <typename U> Reference &operator*=(const U &value) { return *this = (T)(wrapper.vec[index] * value); }
+
+        template <typename U> Reference &operator/=(const U &value) { return *this = (T)(wrapper.vec[index] / value); }
+
+      private:
+        VectorModificationWrapper &wrapper;
+        size_t index;
+    };
+
     VectorModificationWrapper()
         : modified(false) {}
 
@@ -41,10 +92,7 @@ class VectorModificationWrapper {
         : vec(std::move(initialVec))
         , modified(false) {}
 
-    T &operator[](size_t index) {
-        modified = true;
-        return vec[index];
-    }
+    Reference operator[](size_t index) { return Reference(*this, index); }
 
     const T &operator[](size_t index) const { return vec[index]; }
 
@@ -55,34 +103,53 @@ class VectorModificationWrapper {
     const T *data() const { return vec.data(); }
 
     void resize(size_t newSize) {
-        modified |= (newSize != vec.size());
+        if (newSize != vec.size()) {
+            markModified(0, newSize);
+        }
         vec.resize(newSize);
     }
 
     void resize(size_t newSize, const T &value) {
-        modified |= (newSize != vec.size());
+        if (newSize != vec.size()) {
+            markModified(0, newSize);
+        }
         vec.resize(newSize, value);
     }
 
     bool wasModified() const { return modified; }
 
-    void resetModificationFlag() { modified = false; }
+    /**
+     * Range [first, second) of the elements modified since the last reset,
+     * empty if the vector was not modified.
+     */
+    std::pair<size_t, size_t> getModifiedRange() const {
+        if (!modified) {
+            return {0, 0};
+        }
+        return {std::min(modifiedBegin, vec.size()), std::min(modifiedEnd, vec.size())};
+    }
+
+    void resetModificationFlag() {
+        modified = false;
+        modifiedBegin = std::numeric_limits<size_t>::max();
+        modifiedEnd = 0;
+    }
 
-    void setModified() { modified = true; }
+    void setModified() { markModified(0, vec.size()); }
 
     void push_back(const T &value) {
-        modified = true;
+        markModified(vec.size(), vec.size() + 1);
         vec.push_back(value);
     }
 
     void push_back(T &&value) {
-        modified = true;
+        markModified(vec.size(), vec.size() + 1);
         vec.push_back(std::move(value));
     }
 
     template <typename... Args>
     void emplace_back(Args&&... args) {
-        modified = true;
+        markModified(vec.size(), vec.size() + 1);
         vec.emplace_back(std::forward<Args>(args)...);
     }
 };
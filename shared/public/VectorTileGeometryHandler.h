@@ -20,6 +20,7 @@
 #include "CoordinateSystemIdentifiers.h"
 #include "GeoJsonTypes.h"
 #include "EarcutVectorView.h"
+#include "simplify.hpp"
 
 namespace mapbox {
     namespace util {
@@ -54,12 +55,16 @@ namespace mapbox {
 
 class VectorTileGeometryHandler {
 public:
-    VectorTileGeometryHandler(::RectCoord tileCoords, int extent, const std::optional<Tiled2dMapVectorSettings> &vectorSettings, const std::shared_ptr<CoordinateConversionHelperInterface> &conversionHelper)
+    // lineSimplificationTolerance: in units of the tile extent, line vertices closer than that to the simplified line are
+    // dropped (Douglas-Peucker). 0 keeps all vertices.
+    VectorTileGeometryHandler(::RectCoord tileCoords, int extent, const std::optional<Tiled2dMapVectorSettings> &vectorSettings, const std::shared_ptr<CoordinateConversionHelperInterface> &conversionHelper,
+                              double lineSimplificationTolerance = 0.0)
     : tileCoords(tileCoords),
       // use standard TOP_LEFT origin, when no vector settings given.
       origin(vectorSettings ? vectorSettings->tileOrigin : Tiled2dMapVectorTileOrigin::TOP_LEFT),
       extent((double)extent),
-      conversionHelper(conversionHelper)
+      conversionHelper(conversionHelper),
+      lineTolerance(extent > 0 ? lineSimplificationTolerance * std::abs(tileCoords.bottomRight.x - tileCoords.topLeft.x) / extent : 0.0)
     {};
 
     VectorTileGeometryHandler(const std::shared_ptr<GeoJsonGeometry> &geometry, ::RectCoord tileCoords, const std::shared_ptr<CoordinateConversionHelperInterface> &conversionHelper): tileCoords(tileCoords), conversionHelper(conversionHelper) {
@@ -109,6 +114,10 @@ public:
     }
 
     void linestring_end() {
+        numLineVertices += coordinates.back().size();
+        if (lineTolerance > 0.0) {
+            numRemovedLineVertices += simplifyLine(coordinates.back(), lineTolerance);
+        }
     }
 
     void ring_begin(uint32_t count) {
@@ -236,6 +245,18 @@ public:
         std::vector<uint16_t> indices;
     };
 
+    // Restores already decoded and triangulated geometries, see Tiled2dMapVectorPackedTile
+    VectorTileGeometryHandler(::RectCoord tileCoords, std::vector<std::vector<::Vec2D>> &&coordinates,
+                              std::vector<TriangulatedPolygon> &&polygons,
+                              const std::shared_ptr<CoordinateConversionHelperInterface> &conversionHelper)
+    : coordinates(std::move(coordinates)),
+      polygons(std::move(polygons)),
+      origin(Tiled2dMapVectorTileOrigin::TOP_LEFT),
+      tileCoords(tileCoords),
+      extent(0.0),
+      conversionHelper(conversionHelper)
+    {};
+
     const std::vector<TriangulatedPolygon> &getPolygons() const {
         return polygons;
     }
@@ -244,6 +265,11 @@ public:
         return coordinates;
     }
 
+    // Line vertices as decoded and dropped by the simplification
+    size_t getNumLineVertices() const { return numLineVertices; }
+
+    size_t getNumRemovedLineVertices() const { return numRemovedLineVertices; }
+
     static inline double signedTriangleArea(const Vec2D& a, const Vec2D& b, const Vec2D& c) {
         return (b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y);
     }
@@ -350,4 +376,9 @@ private:
     double extent;
 
     const std::shared_ptr<CoordinateConversionHelperInterface> conversionHelper;
+
+    // in the layer system
+    const double lineTolerance = 0.0;
+    size_t numLineVertices = 0;
+    size_t numRemovedLineVertices = 0;
 };
@@ -14,6 +14,7 @@
 #include "RenderObjectInterface.h"
 #include "ComputeObjectInterface.h"
 #include <Logger.h>
+#include "PerformanceLogger.h"
 
 void Renderer::addToRenderQueue(const std::shared_ptr<RenderPassInterface> &renderPass) {
     int32_t renderPassIndex = renderPass->getRenderPassConfig().renderPassIndex;
@@ -40,6 +41,8 @@ void Renderer::drawFrame(const std::shared_ptr<RenderingContextInterface> &rende
 
     renderingContext->setupDrawFrame(vpMatrixPointer, origin, factor);
 
+    int64_t drawCalls = 0;
+
     for (const auto &[index, passes] : renderQueue) {
         for (const auto &pass : passes) {
             if (pass->getRenderPassConfig().renderTarget != target) {
@@ -74,6 +77,11 @@ void Renderer::drawFrame(const std::shared_ptr<RenderingContextInterface> &rende
                     if (hasMask) {
                         maskObject->renderAsMask(renderingContext, pass->getRenderPassConfig(), vpMatrixPointer,
                                                  identityMatrixPointer, origin, factor, isScreenSpaceCoords);
+#ifdef ENABLE_PERF_LOGGING
+                        if (maskObject->asGraphicsObject()->isReady()) {
+                            drawCalls++;
+                        }
+#endif
                     }
 
                     prepared = true;
@@ -92,6 +100,12 @@ void Renderer::drawFrame(const std::shared_ptr<RenderingContextInterface> &rende
                     graphicsObject->render(renderingContext, pass->getRenderPassConfig(), vpMatrixPointer, identityMatrixPointer,
                                            origin, hasMask, factor, isScreenSpaceCoords);
                 }
+#ifdef ENABLE_PERF_LOGGING
+                // objects that are not ready return from render without drawing
+                if (graphicsObject->isReady()) {
+                    drawCalls++;
+                }
+#endif
             }
 
             if (prepared) {
@@ -105,6 +119,8 @@ void Renderer::drawFrame(const std::shared_ptr<RenderingContextInterface> &rende
             }
         }
     }
+    PERF_LOG_COUNT("Renderer_drawCalls", drawCalls);
+
     if (!target) {
         renderQueue.clear();
     }
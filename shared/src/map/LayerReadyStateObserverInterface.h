@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+/**
+ * Implemented by the map, notified by layers whenever their offscreen ready state may have changed, such that
+ * drawReadyFrame only re-evaluates the ready state of the layers when there is a reason to.
+ */
+class LayerReadyStateObserverInterface {
+public:
+    virtual ~LayerReadyStateObserverInterface() = default;
+
+    virtual void onLayerReadyStateChanged() = 0;
+};
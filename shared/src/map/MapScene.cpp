@@ -22,6 +22,7 @@
 #include "Logger.h"
 #include "RenderingCullMode.h"
 #include <algorithm>
+#include <chrono>
 #ifdef __EMSCRIPTEN__
     #include <emscripten/threading.h>
 #endif
@@ -428,6 +429,8 @@ void MapScene::compute() {
 
 void MapScene::drawFrame() {
     scene->drawFrame(nullptr);
+    // graphics tasks and layer updates of this frame may have changed the ready state
+    notifyReadyStateWaiters();
 }
 
 void MapScene::drawOffscreenFrame(const /*not-null*/ std::shared_ptr<::RenderTargetInterface> & target) {
@@ -523,6 +526,11 @@ void MapScene::drawReadyFrame(const ::RectCoord &bounds, float paddingPc, float
     auto timeoutTimestamp = DateHelper::currentTimeMillis() + (int64_t)(timeout * 1000);
 
     while (state == LayerReadyState::NOT_READY) {
+        uint64_t generation;
+        {
+            std::lock_guard<std::mutex> readyLock(readyStateMutex);
+            generation = readyStateGeneration;
+        }
 
 #ifdef __APPLE__
         while(scheduler->runGraphicsTasks()) {
@@ -538,11 +546,17 @@ void MapScene::drawReadyFrame(const ::RectCoord &bounds, float paddingPc, float
             state = getLayersReadyState();
         }
 
-        // sleep for 0.05s to avoid starving main thread
+        // wait until a layer (whenever the mailbox of one of its sources or managers is emptied), the scheduler or
+        // a rendered frame signals a possible change of the ready state, or until the timeout
         if (state == LayerReadyState::NOT_READY) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            const auto waitMillis = timeoutTimestamp - now;
+            std::unique_lock<std::mutex> readyLock(readyStateMutex);
+            readyStateCondition.wait_for(readyLock, std::chrono::milliseconds(std::max(waitMillis, (int64_t)1)),
+                                         [&] { return readyStateGeneration != generation; });
         }
 
+        // always request the next frame, on platforms rendering on demand the layer updates and graphics tasks only
+        // progress with rendered frames
         callbacks->stateDidUpdate(state);
         invalidate();
     }
@@ -582,6 +596,19 @@ void MapScene::forceReload() {
 
 void MapScene::requestGraphicsTaskExecution() {
     invalidate();
+    notifyReadyStateWaiters();
+}
+
+void MapScene::onLayerReadyStateChanged() {
+    notifyReadyStateWaiters();
+}
+
+void MapScene::notifyReadyStateWaiters() {
+    {
+        std::lock_guard<std::mutex> lock(readyStateMutex);
+        readyStateGeneration++;
+    }
+    readyStateCondition.notify_all();
 }
 
 bool MapScene::is3d() {
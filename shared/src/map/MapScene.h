@@ -11,14 +11,20 @@
 #pragma once
 
 #include "LayerReadyState.h"
+#include "LayerReadyStateObserverInterface.h"
 #include "MapConfig.h"
 #include "MapInterface.h"
 #include "SchedulerGraphicsTaskCallbacks.h"
 #include "Scene.h"
+#include <condition_variable>
 #include <map>
 #include <mutex>
 
-class MapScene : public MapInterface, public SceneCallbackInterface, public SchedulerGraphicsTaskCallbacks, public std::enable_shared_from_this<MapScene> {
+class MapScene : public MapInterface,
+                 public SceneCallbackInterface,
+                 public SchedulerGraphicsTaskCallbacks,
+                 public LayerReadyStateObserverInterface,
+                 public std::enable_shared_from_this<MapScene> {
   public:
     MapScene(std::shared_ptr<SceneInterface> scene, const MapConfig &mapConfig,
              const std::shared_ptr<::SchedulerInterface> &scheduler, float pixelDensity, bool is3D);
@@ -98,9 +104,13 @@ class MapScene : public MapInterface, public SceneCallbackInterface, public Sche
 
     virtual void requestGraphicsTaskExecution() override;
 
+    virtual void onLayerReadyStateChanged() override;
+
   private:
     LayerReadyState getLayersReadyState();
 
+    void notifyReadyStateWaiters();
+
   private:
     const MapConfig mapConfig;
 
@@ -124,6 +134,11 @@ class MapScene : public MapInterface, public SceneCallbackInterface, public Sche
     std::atomic_flag isInvalidated = ATOMIC_FLAG_INIT;
     bool mapIs3d = false;
 
+    // drawReadyFrame waits for changes of readyStateGeneration instead of polling the layers
+    std::mutex readyStateMutex;
+    std::condition_variable readyStateCondition;
+    uint64_t readyStateGeneration = 0;
+
     std::mutex performanceLoggersMutex;
     std::vector<std::shared_ptr<PerformanceLoggerInterface>> performanceLoggers;
 };
@@ -420,7 +420,7 @@ std::vector<float> MapCamera2d::getVpMatrix() {
     double currentRotation = angle;
     double currentZoom = zoom;
     double zoomFactor = screenPixelAsRealMeterFactor * currentZoom;
-    RectCoord viewBounds = getRectFromViewport(sizeViewport, centerPosition);
+    RectCoord viewBounds = getRectFromViewport(sizeViewport, centerPosition, zoom);
 
     Coord renderCoordCenter = conversionHelper->convertToRenderSystem(centerPosition);
 
@@ -535,7 +535,7 @@ std::vector<float> MapCamera2d::getInvariantModelMatrix(const ::Coord &coordinat
 
 RectCoord MapCamera2d::getVisibleRect() {
     Vec2I sizeViewport = mapInterface->getRenderingContext()->getViewportSize();
-    return getRectFromViewport(sizeViewport, centerPosition);
+    return getRectFromViewport(sizeViewport, centerPosition, zoom);
 }
 
 RectCoord MapCamera2d::getPaddingAdjustedVisibleRect() {
@@ -546,10 +546,10 @@ RectCoord MapCamera2d::getPaddingAdjustedVisibleRect() {
     sizeViewport.y -= (paddingTop + paddingBottom);
 
     // also use the padding adjusted center position
-    return getRectFromViewport(sizeViewport, getCenterPosition());
+    return getRectFromViewport(sizeViewport, getCenterPosition(), zoom);
 }
 
-RectCoord MapCamera2d::getRectFromViewport(const Vec2I &sizeViewport, const Coord &center) {
+RectCoord MapCamera2d::getRectFromViewport(const Vec2I &sizeViewport, const Coord &center, double zoom) {
     double zoomFactor = screenPixelAsRealMeterFactor * zoom;
 
     double halfWidth = sizeViewport.x * 0.5 * zoomFactor;
@@ -664,6 +664,42 @@ void MapCamera2d::setupInertia() {
     currentDragTimestamp = 0;
 }
 
+std::optional<std::tuple<RectCoord, double>> MapCamera2d::getPredictedVisibleRect() {
+    Coord targetCenter = centerPosition;
+    double targetZoom = zoom;
+    bool isMoving = false;
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(animationMutex);
+        if (coordAnimation && !coordAnimation->isFinished()) {
+            targetCenter = coordAnimation->endValue;
+            isMoving = true;
+        }
+        if (zoomAnimation && !zoomAnimation->isFinished()) {
+            targetZoom = zoomAnimation->endValue;
+            isMoving = true;
+        }
+    }
+
+    auto inertia = this->inertia;
+    if (inertia) {
+        const double remaining = inertia->remainingDistanceFactor(DateHelper::currentTimeMicros(), 0.95);
+        if (remaining > 0.0) {
+            targetCenter.x += inertia->velocity.x * remaining;
+            targetCenter.y += inertia->velocity.y * remaining;
+            isMoving = true;
+        }
+    }
+
+    if (!isMoving) {
+        return std::nullopt;
+    }
+
+    const auto [adjustedCenter, adjustedZoom] = getBoundsCorrectedCoords(targetCenter, targetZoom);
+    Vec2I sizeViewport = mapInterface->getRenderingContext()->getViewportSize();
+    return std::make_tuple(getRectFromViewport(sizeViewport, adjustedCenter, adjustedZoom), adjustedZoom);
+}
+
 void MapCamera2d::inertiaStep() {
     if (inertia == std::nullopt) {
         return;
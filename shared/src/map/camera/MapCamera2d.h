@@ -156,6 +156,9 @@ class MapCamera2d : public MapCameraInterface,
 
     std::shared_ptr<MapCamera3dInterface> asMapCamera3d() override;
 
+    /** visible rect and zoom at which the current inertia and move / zoom animations come to rest, std::nullopt if the camera is not moving */
+    std::optional<std::tuple<RectCoord, double>> getPredictedVisibleRect();
+
 protected:
     virtual void setupInertia();
 
@@ -229,7 +232,7 @@ protected:
     RectCoord getPaddingCorrectedBounds(double zoom);
     void clampCenterToPaddingCorrectedBounds();
 
-    RectCoord getRectFromViewport(const Vec2I &sizeViewport, const Coord &center);
+    RectCoord getRectFromViewport(const Vec2I &sizeViewport, const Coord &center, double zoom);
 
     std::vector<float> newVpMatrix = std::vector<float>(16, 0.0);
     std::vector<float> newInverseVpMatrix = std::vector<float>(16, 0.0);
@@ -17,6 +17,7 @@
 #include "DateHelper.h"
 #include "DoubleAnimation.h"
 #include "Logger.h"
+#include "MapCameraStateListenerInterface.h"
 #include "MapConfig.h"
 #include "MapInterface.h"
 #include "Matrix.h"
@@ -683,6 +684,52 @@ RectCoord MapCamera3d::getVisibleRect() {
     return getRectFromViewport(sizeViewport, focusPointPosition);
 }
 
+std::optional<std::tuple<RectCoord, double>> MapCamera3d::getPredictedVisibleRect() {
+    Coord targetFocus = focusPointPosition;
+    double targetZoom = zoom;
+    bool isMoving = false;
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(animationMutex);
+        if (coordAnimation && !coordAnimation->isFinished()) {
+            targetFocus = coordAnimation->endValue;
+            isMoving = true;
+        }
+        if (zoomAnimation && !zoomAnimation->isFinished()) {
+            targetZoom = zoomAnimation->endValue;
+            isMoving = true;
+        }
+    }
+
+    auto inertia = this->inertia;
+    if (inertia) {
+        const double remaining = inertia->remainingDistanceFactor(DateHelper::currentTimeMicros(), 0.9);
+        if (remaining > 0.0) {
+            targetFocus.x += inertia->velocity.x * remaining;
+            targetFocus.y += inertia->velocity.y * remaining;
+            isMoving = true;
+        }
+    }
+
+    if (!isMoving) {
+        return std::nullopt;
+    }
+
+    auto [adjustedFocus, adjustedZoom] = getBoundsCorrectedCoords(targetFocus, targetZoom);
+    adjustedFocus.x = std::fmod(adjustedFocus.x + 540.0, 360.0) - 180.0;
+    adjustedFocus.y = std::clamp(adjustedFocus.y, -85.0, 85.0);
+
+    // the extent of the viewport looking straight down at the focus point, the far side of a pitched view is not covered
+    const Coord center = conversionHelper->convert(CoordinateSystemIdentifiers::EPSG3857(), adjustedFocus);
+    const double metersPerPixel = 0.0254 / screenDensityPpi * adjustedZoom / std::cos(adjustedFocus.y * M_PI / 180.0);
+    const Vec2I sizeViewport = mapInterface->getRenderingContext()->getViewportSize();
+    const double halfWidth = 0.5 * sizeViewport.x * metersPerPixel;
+    const double halfHeight = 0.5 * sizeViewport.y * metersPerPixel;
+    const RectCoord rect(Coord(center.systemIdentifier, center.x - halfWidth, center.y + halfHeight, 0.0),
+                         Coord(center.systemIdentifier, center.x + halfWidth, center.y - halfHeight, 0.0));
+    return std::make_tuple(rect, adjustedZoom);
+}
+
 RectCoord MapCamera3d::getPaddingAdjustedVisibleRect() {
     // TODO: Implement for Camera3D
     //    printf("Warning: getPaddingAdjustedVisibleRect incomplete logic.\n");
@@ -733,14 +780,8 @@ void MapCamera3d::notifyListeners(const int &listenerType) {
 
     double angle = this->angle;
 
-    std::vector<float> viewMatrix;
-    std::vector<float> projectionMatrix;
-    float width = 0.0;
-    float height = 0.0;
-    float horizontalFov = 0.0;
-    float verticalFov = 0.0;
-    float focusPointAltitude = 0.0;
-    auto focusPointPosition = Coord(0, 0.0, 0.0, 0.0);
+    // one snapshot per update, shared by all listeners
+    std::shared_ptr<const MapCameraState> cameraState;
 
     if (listenerType & ListenerType::BOUNDS) {
         bool validVpMatrix = false;
@@ -751,6 +792,12 @@ void MapCamera3d::notifyListeners(const int &listenerType) {
         if (!validVpMatrix) {
             updateMatrices(); // update matrices
         }
+
+        std::vector<float> viewMatrix;
+        std::vector<float> projectionMatrix;
+        float horizontalFov = 0.0;
+        float verticalFov = 0.0;
+        Vec3D origin(0.0, 0.0, 0.0);
         {
             std::scoped_lock<std::recursive_mutex, std::recursive_mutex> lock(matrixMutex, paramMutex);
 
@@ -758,23 +805,26 @@ void MapCamera3d::notifyListeners(const int &listenerType) {
             projectionMatrix = this->projectionMatrix;
             horizontalFov = this->horizontalFov;
             verticalFov = this->verticalFov;
-            focusPointPosition = this->focusPointPosition;
+            origin = this->origin;
         }
 
         Vec2I sizeViewport = mapInterface->getRenderingContext()->getViewportSize();
-        width = sizeViewport.x;
-        height = sizeViewport.y;
+        const float focusPointAltitude = 0.0;
+        cameraState = std::make_shared<const MapCameraState>(MapCameraState{
+            std::move(viewMatrix), std::move(projectionMatrix), origin, verticalFov, horizontalFov, (float)sizeViewport.x,
+            (float)sizeViewport.y, focusPointAltitude, getCenterPosition(), (float)getZoom()});
     }
 
     std::lock_guard<std::recursive_mutex> lock(listenerMutex);
     for (auto listener : listeners) {
         if (listenerType & (ListenerType::BOUNDS)) {
-
-            std::vector<float> viewMatrixF = VectorHelper::clone(viewMatrix);
-            std::vector<float> projectionMatrixF = VectorHelper::clone(projectionMatrix);
-
-            listener->onCameraChange(viewMatrixF, projectionMatrixF, origin, verticalFov, horizontalFov, width, height,
-                                     focusPointAltitude, getCenterPosition(), getZoom());
+            if (auto stateListener = std::dynamic_pointer_cast<MapCameraStateListenerInterface>(listener)) {
+                stateListener->onCameraStateChanged(cameraState);
+            } else {
+                listener->onCameraChange(cameraState->viewMatrix, cameraState->projectionMatrix, cameraState->origin,
+                                         cameraState->verticalFov, cameraState->horizontalFov, cameraState->width, cameraState->height,
+                                         cameraState->focusPointAltitude, cameraState->focusPointPosition, cameraState->zoom);
+            }
         }
         if (listenerType & ListenerType::ROTATION) {
             listener->onRotationChanged(angle);
@@ -142,6 +142,10 @@ class MapCamera3d : public MapCameraInterface,
 
     virtual RectCoord getPaddingAdjustedVisibleRect() override;
 
+    /** approximate visible rect (EPSG:3857) and zoom at which the current inertia and move / zoom animations come to rest,
+     * std::nullopt if the camera is not moving */
+    std::optional<std::tuple<RectCoord, double>> getPredictedVisibleRect();
+
     virtual ::Coord coordFromScreenPosition(const ::Vec2F &posScreen) override;
 
     virtual ::Coord coordFromScreenPositionZoom(const ::Vec2F &posScreen, float zoom) override;
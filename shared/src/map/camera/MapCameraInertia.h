@@ -11,6 +11,8 @@
 #ifndef MAPSCORE__MapCameraInertia__MapCameraInertia__
 #define MAPSCORE__MapCameraInertia__MapCameraInertia__
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 
 #include "Vec2F.h"
@@ -33,6 +35,25 @@ struct MapCameraInertia {
         , velocity(velocity)
         , t1(t1)
         , t2(t2) {}
+
+    /// distance still covered from the given time on, as a multiple of the velocity
+    /// the velocity is applied per 16ms frame, reduced by decay per frame and additionally by 0.6 per frame after t1
+    double remainingDistanceFactor(int64_t timestamp, double decay) const {
+        const double start = std::max((timestamp - timestampStart) / 16000.0, 0.0);
+        const double end = t1 + t2;
+        if (start >= end) {
+            return 0.0;
+        }
+        // integral of decay^t until t1 and of decay^t * 0.6^(t - t1) after it
+        double remaining = 0.0;
+        if (start < t1) {
+            remaining += (std::pow(decay, t1) - std::pow(decay, start)) / std::log(decay);
+        }
+        const double slowDecay = decay * 0.6;
+        const double slowStart = std::max(start, t1);
+        remaining += std::pow(0.6, -t1) * (std::pow(slowDecay, end) - std::pow(slowDecay, slowStart)) / std::log(slowDecay);
+        return remaining;
+    }
 };
 
 #endif // MAPSCORE__MapCameraInertia__MapCameraInertia__
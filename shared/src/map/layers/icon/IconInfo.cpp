@@ -28,6 +28,7 @@ std::shared_ptr<::TextureHolderInterface> IconInfo::getTexture() {
 void IconInfo::setCoordinate(const Coord &coord) {
     std::lock_guard<std::mutex> dataLock(dataMutex);
     this->coordinate = coord;
+    version++;
 }
 
 ::Coord IconInfo::getCoordinate() {
@@ -38,6 +39,7 @@ void IconInfo::setCoordinate(const Coord &coord) {
 void IconInfo::setIconSize(const Vec2F &size) {
     std::lock_guard<std::mutex> dataLock(dataMutex);
     this->iconSize = size;
+    version++;
 }
 
 ::Vec2F IconInfo::getIconSize() {
@@ -48,6 +50,7 @@ void IconInfo::setIconSize(const Vec2F &size) {
 void IconInfo::setType(IconType type) {
     std::lock_guard<std::mutex> dataLock(dataMutex);
     this->type = type;
+    version++;
 }
 
 IconType IconInfo::getType() {
@@ -64,3 +67,5 @@ BlendMode IconInfo::getBlendMode() {
     // Immutable
     return blendMode;
 }
+
+uint64_t IconInfo::getVersion() const { return version.load(); }
@@ -11,6 +11,7 @@
 #pragma once
 
 #include "IconInfoInterface.h"
+#include <atomic>
 #include <mutex>
 
 class IconInfo : public IconInfoInterface {
@@ -40,8 +41,12 @@ class IconInfo : public IconInfoInterface {
 
     virtual ::BlendMode getBlendMode() override;
 
+    // Increased by every change of the coordinate, size or type
+    uint64_t getVersion() const;
+
   private:
     std::mutex dataMutex;
+    std::atomic<uint64_t> version = 0;
     std::string identifier;
     Coord coordinate;
     std::shared_ptr<::TextureHolderInterface> texture;
@@ -20,7 +20,10 @@
 #include "Matrix.h"
 #include "MapConfig.h"
 #include "Vec2FHelper.h"
+#include "Vec4D.h"
 #include <IconType.h>
+#include <cmath>
+#include <limits>
 
 IconLayer::IconLayer()
     : isHidden(false) {}
@@ -40,8 +43,8 @@ std::vector<std::shared_ptr<IconInfoInterface>> IconLayer::getIcons() {
         return icons;
     }
     std::lock_guard<std::recursive_mutex> lock(iconsMutex);
-    for (auto const &icon : this->icons) {
-        icons.push_back(icon.first);
+    for (auto const &entry : this->icons) {
+        icons.push_back(entry->icon);
     }
     return icons;
 }
@@ -92,17 +95,24 @@ void IconLayer::removeIdentifierSet(const std::unordered_set<std::string> &ident
     std::vector<std::shared_ptr<GraphicsObjectInterface>> iconsToClear;
     {
         std::lock_guard<std::recursive_mutex> lock(iconsMutex);
+        std::vector<std::shared_ptr<IconLayerObject>> releasedBatches;
         for (auto it = this->icons.begin(); it != this->icons.end();) {
-            if (identifiersToRemove.find(it->first->getIdentifier()) != identifiersToRemove.end()) {
-                auto graphicsObject = it->second->getGraphicsObject();
-                if (graphicsObject->isReady()) {
-                    iconsToClear.push_back(graphicsObject);
-                }
+            const auto &entry = *it;
+            if (identifiersToRemove.find(entry->icon->getIdentifier()) != identifiersToRemove.end()) {
+                iconBatches.release(entry->batchKey, releasedBatches);
+                iconIndex.remove(entry->icon.get());
+                maxIconSizesInvalid = true;
                 it = this->icons.erase(it);
             } else {
                 it++;
             }
         }
+        for (const auto &iconObject : releasedBatches) {
+            if (iconObject->getGraphicsObject()->isReady()) {
+                iconsToClear.push_back(iconObject->getGraphicsObject());
+            }
+        }
+        visibleBatches.clear();
     }
     if (!iconsToClear.empty()) {
         scheduler->addTask(
@@ -116,7 +126,7 @@ void IconLayer::removeIdentifierSet(const std::unordered_set<std::string> &ident
                         }));
     }
 
-    preGenerateRenderPasses();
+    removeUnusedScaleAnimations();
     if (mapInterface)
         mapInterface->invalidate();
 }
@@ -149,64 +159,77 @@ void IconLayer::addIcons(const std::vector<std::shared_ptr<IconInfoInterface>> &
         return;
     }
 
-    std::vector<std::pair<std::shared_ptr<IconInfoInterface>, std::shared_ptr<IconLayerObject>>> iconObjects;
+    // the batches are created and set up in update(), in the order the icons are drawn
+    {
+        std::lock_guard<std::recursive_mutex> lock(iconsMutex);
+        for (const auto &icon : iconsToAdd) {
+            auto entry = std::make_shared<IconEntry>();
+            entry->icon = icon;
+            entry->iconInfo = dynamic_cast<IconInfo *>(icon.get());
+            addToIconIndex(entry, true);
+            iconBatches.retain(entry->batchKey);
+            this->icons.push_back(entry);
+        }
+    }
+
+    if (mapInterface)
+        mapInterface->invalidate();
+}
 
-    for (const auto &icon : iconsToAdd) {
-        auto shader = is3D ? shaderFactory->createUnitSphereAlphaInstancedShader() : shaderFactory->createAlphaInstancedShader();
-        shader->asShaderProgramInterface()->setBlendMode(icon->getBlendMode());
-        auto quadObject = objectFactory->createQuadInstanced(shader->asShaderProgramInterface());
-        //int32_t subdivisionFactor = is3D ? SUBDIVISION_FACTOR_3D_DEFAULT : 0;
-        //quadObject->setSubdivisionFactor(subdivisionFactor);
+std::shared_ptr<IconLayerObject> IconLayer::createIconBatch(const std::shared_ptr<IconInfoInterface> &icon,
+                                                            const std::shared_ptr<MapInterface> &mapInterface) {
+    auto objectFactory = mapInterface->getGraphicsObjectFactory();
+    auto shaderFactory = mapInterface->getShaderFactory();
+    auto shader = is3D ? shaderFactory->createUnitSphereAlphaInstancedShader() : shaderFactory->createAlphaInstancedShader();
+    shader->asShaderProgramInterface()->setBlendMode(icon->getBlendMode());
+    auto quadObject = objectFactory->createQuadInstanced(shader->asShaderProgramInterface());
+    //int32_t subdivisionFactor = is3D ? SUBDIVISION_FACTOR_3D_DEFAULT : 0;
+    //quadObject->setSubdivisionFactor(subdivisionFactor);
 
 #if DEBUG
-        quadObject->asGraphicsObject()->setDebugLabel("IconLayerID:" + icon->getIdentifier());
+    quadObject->asGraphicsObject()->setDebugLabel("IconLayerBatch:" + icon->getIdentifier());
 #endif
 
-        auto iconObject = std::make_shared<IconLayerObject>(quadObject, icon, shader, mapInterface, is3D);
-
-        iconObjects.push_back(std::make_pair(icon, iconObject));
+    auto iconObject = std::make_shared<IconLayerObject>(quadObject, icon->getTexture(), shader, mapInterface, icon->getCoordinate(), is3D);
+    iconObject->setAlpha(alpha);
+    return iconObject;
+}
 
-        {
-            std::lock_guard<std::recursive_mutex> lock(iconsMutex);
-            this->icons.push_back(std::make_pair(icon, iconObject));
-        }
+int64_t IconLayer::getIconBatchRegion(const Coord &position) {
+    // In 2d the instance positions are floats relative to the first icon of a batch. Icons far apart are split into
+    // regions of 1/64 of the map bounds to keep them precise, in 3d they are relative positions on the unit sphere.
+    // The position is in the coordinate system of the icon index.
+    auto mapInterface = this->mapInterface;
+    if (is3D || !mapInterface) {
+        return 0;
     }
-
-    std::weak_ptr<IconLayer> weakSelfPtr = std::dynamic_pointer_cast<IconLayer>(shared_from_this());
-    std::string taskId =
-        "IconLayer_setup_coll_" + std::get<0>(iconObjects.at(0))->getIdentifier() + "_[" + std::to_string(iconObjects.size()) + "]";
-    scheduler->addTask(std::make_shared<LambdaTask>(
-        TaskConfig(taskId, 0, TaskPriority::NORMAL, ExecutionEnvironment::GRAPHICS), [weakSelfPtr, iconObjects] {
-            auto selfPtr = weakSelfPtr.lock();
-            if (selfPtr)
-                selfPtr->setupIconObjects(iconObjects);
-        }));
-
-    preGenerateRenderPasses();
-    if (mapInterface)
-        mapInterface->invalidate();
+    const auto &bounds = mapInterface->getMapConfig().mapCoordinateSystem.bounds;
+    const double regionWidth = std::abs(bounds.bottomRight.x - bounds.topLeft.x) / ICON_BATCH_REGIONS;
+    const double regionHeight = std::abs(bounds.bottomRight.y - bounds.topLeft.y) / ICON_BATCH_REGIONS;
+    if (!(regionWidth > 0.0) || !(regionHeight > 0.0)) {
+        return 0;
+    }
+    const auto regionX = (int64_t)std::floor((position.x - std::min(bounds.topLeft.x, bounds.bottomRight.x)) / regionWidth);
+    const auto regionY = (int64_t)std::floor((position.y - std::min(bounds.topLeft.y, bounds.bottomRight.y)) / regionHeight);
+    return regionX * (ICON_BATCH_REGIONS + 1) + regionY;
 }
 
 void IconLayer::setRenderPassIndex(int32_t index) {
     renderPassIndex = index;
-    preGenerateRenderPasses();
 
     if (mapInterface) {
         mapInterface->invalidate();
     }
 }
 
-void IconLayer::setupIconObjects(
-    const std::vector<std::pair<std::shared_ptr<IconInfoInterface>, std::shared_ptr<IconLayerObject>>> &iconObjects) {
+void IconLayer::setupIconObjects(const std::vector<std::shared_ptr<IconLayerObject>> &iconObjects) {
     auto mapInterface = this->mapInterface;
     auto renderingContext = mapInterface ? mapInterface->getRenderingContext() : nullptr;
     if (!renderingContext) {
         return;
     }
 
-    for (const auto &iconPair : iconObjects) {
-        const auto &iconObject = iconPair.second;
-
+    for (const auto &iconObject : iconObjects) {
         iconObject->setup(renderingContext);
 
         if (mask && !mask->asGraphicsObject()->isReady()) {
@@ -229,7 +252,7 @@ void IconLayer::clear() {
     {
         std::lock_guard<std::recursive_mutex> lock(iconsMutex);
         std::weak_ptr<IconLayer> weakSelfPtr = std::dynamic_pointer_cast<IconLayer>(shared_from_this());
-        auto iconsToClear = icons;
+        auto iconsToClear = getIconBatches();
         scheduler->addTask(std::make_shared<LambdaTask>(
             TaskConfig("IconLayer_clear", 0, TaskPriority::NORMAL, ExecutionEnvironment::GRAPHICS), [weakSelfPtr, iconsToClear] {
                 if (auto self = weakSelfPtr.lock()) {
@@ -237,26 +260,33 @@ void IconLayer::clear() {
                 }
             }));
         icons.clear();
+        iconIndex.clear();
+        maxFixedIconSize = 0.0;
+        maxInvariantIconSize = 0.0;
+        maxIconSizesInvalid = false;
+        iconBatches.clear();
+        visibleBatches.clear();
     }
     if (mask) {
         if (mask->asGraphicsObject()->isReady())
             mask->asGraphicsObject()->clear();
     }
-    {
-        std::lock_guard<std::recursive_mutex> lock(iconsMutex);
-        renderPassObjectMap.clear();
-    }
     mapInterface->invalidate();
 }
 
-void IconLayer::clearSync(const std::vector<std::pair<std::shared_ptr<IconInfoInterface>, std::shared_ptr<IconLayerObject>>> &iconsToClear) {
-    for (const auto &icon : iconsToClear) {
-        if (icon.second->getGraphicsObject()->isReady()) {
-            icon.second->getGraphicsObject()->clear();
+void IconLayer::clearSync(const std::vector<std::shared_ptr<IconLayerObject>> &iconsToClear) {
+    for (const auto &iconObject : iconsToClear) {
+        if (iconObject->getGraphicsObject()->isReady()) {
+            iconObject->getGraphicsObject()->clear();
         }
     }
 }
 
+std::vector<std::shared_ptr<IconLayerObject>> IconLayer::getIconBatches() {
+    std::lock_guard<std::recursive_mutex> lock(iconsMutex);
+    return iconBatches.getBatches();
+}
+
 void IconLayer::setCallbackHandler(const std::shared_ptr<IconLayerCallbackInterface> &handler) { this->callbackHandler = handler; }
 
 std::shared_ptr<::LayerInterface> IconLayer::asLayerInterface() { return shared_from_this(); }
@@ -278,12 +308,72 @@ void IconLayer::update() {
 
     {
         std::lock_guard<std::recursive_mutex> lock(iconsMutex);
-        for (const auto &[iconInfo, layerObject]: icons) {
-            if (!layerObject->getGraphicsObject()->isReady()) {
-                layerObject->getGraphicsObject()->setup(renderingContext);
+        updateIconIndex();
+
+        // the icons are drawn in the order they were added, each run of icons with the same batch key as instances of a batch
+        iconBatches.beginFrame();
+        const auto addInstance = [&](const IconEntry &entry) {
+            const size_t batchCount = iconBatches.getDrawingOrder().size();
+            const auto &iconObject = iconBatches.add(entry.batchKey, [&] { return createIconBatch(entry.icon, mapInterface); });
+            if (iconBatches.getDrawingOrder().size() != batchCount) {
+                iconObject->clearInstances();
+            }
+            iconObject->addInstance(entry.icon);
+        };
+
+        // in 2d the icons around the visible rect are found in the index, in 3d the icons are culled with the view
+        // projection matrix
+        auto camera = mapInterface->getCamera();
+        const auto vpMatrix = is3D && camera ? camera->asCameraInterface()->getVpMatrix() : std::vector<float>();
+        if (!is3D && camera) {
+            visibleIcons.clear();
+            const auto conversionHelper = mapInterface->getCoordinateConverterHelper();
+            const RectCoord visibleRect = camera->getVisibleRect();
+            const Coord topLeft = conversionHelper->convert(iconIndexSystemIdentifier, visibleRect.topLeft);
+            const Coord bottomRight = conversionHelper->convert(iconIndexSystemIdentifier, visibleRect.bottomRight);
+            const double padding = getIconIndexPadding(camera);
+            iconIndex.query(std::min(topLeft.x, bottomRight.x) - padding, std::min(topLeft.y, bottomRight.y) - padding,
+                            std::max(topLeft.x, bottomRight.x) + padding, std::max(topLeft.y, bottomRight.y) + padding, visibleIcons);
+            for (const auto &entry : visibleIcons) {
+                addInstance(*entry);
+            }
+            visibleIcons.clear();
+        } else if (camera && vpMatrix.size() == 16) {
+            const auto origin = camera->asCameraInterface()->getOrigin();
+            const auto viewportSize = renderingContext->getViewportSize();
+
+            // Largest distance of a pixel of an icon from its position in normalized device coordinates, with the scales
+            // and anchor offsets of IconLayerObject::update(). Icons behind the globe are also hidden by the shader.
+            const double fixedScale = mapInterface->getMapConfig().mapCoordinateSystem.unitToScreenMeterFactor / camera->getScalingFactor();
+            const double extent = std::max(2.0, 0.5 * fixedScale + 1.0) * maxInvariantIconSize;
+            const double maxX = 1.0 + extent / std::max(1, viewportSize.x);
+            const double maxY = 1.0 + extent / std::max(1, viewportSize.y);
+
+            const Vec4D earthCenter = Matrix::multiply(vpMatrix, Vec4D(-origin.x, -origin.y, -origin.z, 1.0));
+            const double earthCenterZ = earthCenter.z / earthCenter.w;
+            Vec4D position(0.0, 0.0, 0.0, 1.0);
+            Vec4D projected(0.0, 0.0, 0.0, 0.0);
+            for (const auto &entry : icons) {
+                position.x = entry->position.x - origin.x;
+                position.y = entry->position.y - origin.y;
+                position.z = entry->position.z - origin.z;
+                Matrix::multiply(vpMatrix, position, projected);
+                if (!(projected.w > 0.0) || projected.z / projected.w - earthCenterZ >= 0.0 ||
+                    std::abs(projected.x / projected.w) > maxX || std::abs(projected.y / projected.w) > maxY) {
+                    continue;
+                }
+                addInstance(*entry);
+            }
+        } else {
+            for (const auto &entry : icons) {
+                addInstance(*entry);
             }
+        }
 
-            layerObject->update();
+        visibleBatches = iconBatches.getDrawingOrder();
+        for (const auto &iconObject : visibleBatches) {
+            iconObject->setup(renderingContext);
+            iconObject->update();
         }
     }
 
@@ -313,53 +403,45 @@ std::vector<std::shared_ptr<::RenderPassInterface>> IconLayer::buildRenderPasses
         return {};
     } else {
         std::lock_guard<std::recursive_mutex> lock(iconsMutex);
-        std::vector<std::shared_ptr<RenderPassInterface>> renderPasses;
-        for (const auto &passEntry : renderPassObjectMap) {
-            std::shared_ptr<RenderPass> renderPass =
-                std::make_shared<RenderPass>(RenderPassConfig(passEntry.first, false, renderTarget), passEntry.second, mask);
-            renderPasses.push_back(renderPass);
+        if (visibleBatches.empty()) {
+            return {};
+        }
+        std::vector<std::shared_ptr<RenderObjectInterface>> renderObjects;
+        renderObjects.reserve(visibleBatches.size());
+        for (const auto &iconObject : visibleBatches) {
+            renderObjects.push_back(iconObject->getRenderObject());
         }
-        return renderPasses;
+        return {std::make_shared<RenderPass>(RenderPassConfig(renderPassIndex, false, renderTarget), renderObjects, mask)};
     }
 }
 
-void IconLayer::preGenerateRenderPasses() {
+void IconLayer::removeUnusedScaleAnimations() {
     std::lock_guard<std::recursive_mutex> lock(iconsMutex);
-    std::map<int, std::vector<std::shared_ptr<RenderObjectInterface>>> newRenderPassObjectMap;
-    for (auto const &iconTuple : icons) {
-        for (const auto &config : iconTuple.second->getRenderConfig()) {
-            newRenderPassObjectMap[renderPassIndex].push_back(std::make_shared<RenderObject>(config->getGraphicsObject()));
-        }
-    }
-
-    {
-        std::lock_guard<std::recursive_mutex> animationLock(scaleAnimationMutex);
+    std::lock_guard<std::recursive_mutex> animationLock(scaleAnimationMutex);
 
-        for (auto it = scaleAnimations.begin(); it != scaleAnimations.end();) {
-            auto& id = it->first;
+    for (auto it = scaleAnimations.begin(); it != scaleAnimations.end();) {
+        auto& id = it->first;
 
-            auto hasIcon = false;
-            for(auto& icon : icons) {
-                if(icon.first->getIdentifier() == id) {
-                    hasIcon = true;
-                    break;
-                }
+        auto hasIcon = false;
+        for(auto& entry : icons) {
+            if(entry->icon->getIdentifier() == id) {
+                hasIcon = true;
+                break;
             }
+        }
 
-            if(!hasIcon) {
-                it = scaleAnimations.erase(it);  // erase() returns the next iterator
-            } else {
-                ++it;  // Increment iterator if no erasure
-            }
+        if(!hasIcon) {
+            it = scaleAnimations.erase(it);  // erase() returns the next iterator
+        } else {
+            ++it;  // Increment iterator if no erasure
         }
     }
-
-    renderPassObjectMap = newRenderPassObjectMap;
 }
 
 void IconLayer::onAdded(const std::shared_ptr<MapInterface> &mapInterface, int32_t layerIndex) {
     this->mapInterface = mapInterface;
     is3D = mapInterface->is3d();
+    iconIndexSystemIdentifier = mapInterface->getMapConfig().mapCoordinateSystem.identifier;
     {
         std::scoped_lock<std::recursive_mutex> lock(addingQueueMutex);
         if (!addingQueue.empty()) {
@@ -399,10 +481,7 @@ void IconLayer::onRemoved() {
 }
 
 void IconLayer::pause() {
-    {
-        std::lock_guard<std::recursive_mutex> lock(iconsMutex);
-        clearSync(icons);
-    }
+    clearSync(getIconBatches());
 
     if (mask) {
         if (mask->asGraphicsObject()->isReady())
@@ -411,10 +490,7 @@ void IconLayer::pause() {
 }
 
 void IconLayer::resume() {
-    {
-        std::lock_guard<std::recursive_mutex> lock(iconsMutex);
-        setupIconObjects(icons);
-    }
+    setupIconObjects(getIconBatches());
 }
 
 void IconLayer::hide() {
@@ -446,8 +522,52 @@ std::vector<std::shared_ptr<IconInfoInterface>> IconLayer::getIconsAtPosition(co
 
     {
         std::lock_guard<std::recursive_mutex> lock(iconsMutex);
-        for (const auto &iconTuple : icons) {
-            std::shared_ptr<IconInfoInterface> icon = iconTuple.first;
+
+        // Only the icons around the click position in the index are tested. In 3d the area covered by the largest icon
+        // around the click is unprojected, all icons are tested if it is not completely on the globe or wraps around.
+        std::vector<std::shared_ptr<IconEntry>> iconCandidates;
+        bool useIconIndex = false;
+        if (!is3D) {
+            const Coord center = conversionHelper->convert(iconIndexSystemIdentifier, clickCoords);
+            const double padding = getIconIndexPadding(camera);
+            iconIndex.query(center.x - padding, center.y - padding, center.x + padding, center.y + padding, iconCandidates);
+            useIconIndex = true;
+        } else {
+            const float radius = maxInvariantIconSize;
+            double minX = std::numeric_limits<double>::max();
+            double minY = std::numeric_limits<double>::max();
+            double maxX = std::numeric_limits<double>::lowest();
+            double maxY = std::numeric_limits<double>::lowest();
+            double minLongitude = 180.0;
+            double maxLongitude = -180.0;
+            useIconIndex = true;
+            for (const auto &corner : {Vec2F(posScreen.x - radius, posScreen.y - radius), Vec2F(posScreen.x + radius, posScreen.y - radius),
+                                       Vec2F(posScreen.x + radius, posScreen.y + radius), Vec2F(posScreen.x - radius, posScreen.y + radius)}) {
+                const Coord cornerCoord = camera->coordFromScreenPosition(corner);
+                if (cornerCoord.systemIdentifier == -1) {
+                    useIconIndex = false;
+                    break;
+                }
+                const Coord converted = conversionHelper->convert(iconIndexSystemIdentifier, cornerCoord);
+                minX = std::min(minX, converted.x);
+                minY = std::min(minY, converted.y);
+                maxX = std::max(maxX, converted.x);
+                maxY = std::max(maxY, converted.y);
+                minLongitude = std::min(minLongitude, cornerCoord.x);
+                maxLongitude = std::max(maxLongitude, cornerCoord.x);
+            }
+            if (useIconIndex && maxLongitude - minLongitude < 90.0) {
+                // the unprojected corners do not bound the curved area exactly, extend the rect by half its size
+                const double paddingX = (maxX - minX) * 0.5;
+                const double paddingY = (maxY - minY) * 0.5;
+                iconIndex.query(minX - paddingX, minY - paddingY, maxX + paddingX, maxY + paddingY, iconCandidates);
+            } else {
+                useIconIndex = false;
+            }
+        }
+
+        for (const auto &entry : (useIconIndex ? iconCandidates : icons)) {
+            std::shared_ptr<IconInfoInterface> icon = entry->icon;
 
             const Vec2F &anchor = icon->getIconAnchor();
             const Vec2F& iconSize = icon->getIconSize();
@@ -545,8 +665,8 @@ void IconLayer::setLayerClickable(bool isLayerClickable) {
 
 void IconLayer::setAlpha(float alpha) {
     std::lock_guard<std::recursive_mutex> lock(iconsMutex);
-    for (auto const &icon : this->icons) {
-        icon.second->setAlpha(alpha);
+    for (auto const &iconObject : iconBatches.getBatches()) {
+        iconObject->setAlpha(alpha);
     }
     this->alpha = alpha;
 }
@@ -591,9 +711,9 @@ void IconLayer::addScaleAnimation(const IconScaleAnimation& iconScaleAnimation)
     if(it != scaleAnimations.end()) {
         initialSize = it->second.initialSize;
     } else {
-        for(auto& icon : icons) {
-            if(icon.first->getIdentifier() == scaleAnimation.identifier) {
-                initialSize = icon.first->getIconSize();
+        for(auto& entry : icons) {
+            if(entry->icon->getIdentifier() == scaleAnimation.identifier) {
+                initialSize = entry->icon->getIconSize();
                 break;
             }
         }
@@ -609,9 +729,9 @@ void IconLayer::addScaleAnimation(const IconScaleAnimation& iconScaleAnimation)
     auto animation = std::make_shared<DoubleAnimation>(scaleAnimation.duration, scaleAnimation.from, scaleAnimation.to, InterpolatorFunction::EaseInOut,
             [weakSelf, id, initialSize](double scale) {
               if (auto selfPtr = weakSelf.lock()) {
-                  for(auto& icon : selfPtr->icons) {
-                      if(icon.first->getIdentifier() == id) {
-                          icon.first->setIconSize(Vec2F(initialSize.x * scale, initialSize.y * scale));
+                  for(auto& entry : selfPtr->icons) {
+                      if(entry->icon->getIdentifier() == id) {
+                          entry->icon->setIconSize(Vec2F(initialSize.x * scale, initialSize.y * scale));
                       }
                   }
 
@@ -649,6 +769,96 @@ void IconLayer::addScaleAnimation(const IconScaleAnimation& iconScaleAnimation)
     mapInterface->invalidate();
 }
 
+// Refreshes the icons moved, resized or retyped since the last update in the index, moved icons change their batch if
+// they left its region. iconsMutex has to be locked, called on the graphics thread.
+void IconLayer::updateIconIndex() {
+    std::vector<std::shared_ptr<IconLayerObject>> releasedBatches;
+    for (const auto &entry : icons) {
+        const bool changed = entry->iconInfo ? entry->iconInfo->getVersion() != entry->version
+                                             : (entry->icon->getCoordinate() != entry->coordinate ||
+                                                entry->icon->getIconSize() != entry->iconSize || entry->icon->getType() != entry->type);
+        if (changed) {
+            const auto batchKey = entry->batchKey;
+            addToIconIndex(entry, false);
+            if (entry->batchKey != batchKey) {
+                iconBatches.retain(entry->batchKey);
+                iconBatches.release(batchKey, releasedBatches);
+            }
+        }
+    }
+    for (const auto &iconObject : releasedBatches) {
+        if (iconObject->getGraphicsObject()->isReady()) {
+            iconObject->getGraphicsObject()->clear();
+        }
+    }
+    if (maxIconSizesInvalid) {
+        maxFixedIconSize = 0.0;
+        maxInvariantIconSize = 0.0;
+        for (const auto &entry : icons) {
+            addToMaxIconSizes(*entry);
+        }
+        maxIconSizesInvalid = false;
+    }
+}
+
+void IconLayer::addToIconIndex(const std::shared_ptr<IconEntry> &entry, bool isNew) {
+    auto mapInterface = this->mapInterface;
+    auto conversionHelper = mapInterface ? mapInterface->getCoordinateConverterHelper() : nullptr;
+    if (!conversionHelper) {
+        return;
+    }
+
+    // the version is read first, a change while reading the values is refreshed with the next update
+    if (entry->iconInfo) {
+        entry->version = entry->iconInfo->getVersion();
+    }
+    const auto &iconInfo = entry->icon;
+    const Coord coordinate = iconInfo->getCoordinate();
+    const Vec2F iconSize = iconInfo->getIconSize();
+    const auto type = iconInfo->getType();
+
+    if (isNew || coordinate != entry->coordinate) {
+        const Coord position = conversionHelper->convert(iconIndexSystemIdentifier, coordinate);
+        iconIndex.insert(iconInfo.get(), entry, position.x, position.y);
+        entry->batchKey = IconBatchKey{iconInfo->getTexture().get(), iconInfo->getBlendMode(), getIconBatchRegion(position)};
+
+        if (is3D) {
+            const auto renderCoord = conversionHelper->convertToRenderSystem(coordinate);
+            const double sinY = sin(renderCoord.y);
+            const double cosY = cos(renderCoord.y);
+            const double sinX = sin(renderCoord.x);
+            const double cosX = cos(renderCoord.x);
+            entry->position = Vec3D(renderCoord.z * sinY * cosX, renderCoord.z * cosY, -renderCoord.z * sinY * sinX);
+        }
+    }
+
+    // a smaller icon might have been the largest one
+    if (!isNew && (type != entry->type || std::hypot(iconSize.x, iconSize.y) < std::hypot(entry->iconSize.x, entry->iconSize.y))) {
+        maxIconSizesInvalid = true;
+    }
+    entry->coordinate = coordinate;
+    entry->iconSize = iconSize;
+    entry->type = type;
+    addToMaxIconSizes(*entry);
+}
+
+void IconLayer::addToMaxIconSizes(const IconEntry &entry) {
+    const float size = std::hypot(entry.iconSize.x, entry.iconSize.y);
+    if (!is3D && (entry.type == IconType::FIXED || entry.type == IconType::ROTATION_INVARIANT)) {
+        maxFixedIconSize = std::max(maxFixedIconSize, size);
+    } else {
+        maxInvariantIconSize = std::max(maxInvariantIconSize, size);
+    }
+}
+
+double IconLayer::getIconIndexPadding(const std::shared_ptr<MapCameraInterface> &camera) {
+    // Upper bound of the distance in map units between the position of an icon and any of its pixels, in 2d. FIXED and
+    // ROTATION_INVARIANT icons are hit tested in map units and rendered with the unit to meter factor of the map
+    // coordinate system. The anchor offsets are applied in pixels for all icon types.
+    const double unitToScreenMeterFactor = mapInterface ? mapInterface->getMapConfig().mapCoordinateSystem.unitToScreenMeterFactor : 1.0;
+    return maxFixedIconSize * std::max(1.0, unitToScreenMeterFactor) + camera->mapUnitsFromPixels(maxFixedIconSize + maxInvariantIconSize);
+}
+
 bool IconLayer::isPointInRect(const Vec2F& point, float leftW, float rightW, float topH, float bottomH) {
     return point.x > -leftW && point.x < rightW &&
            point.y < topH && point.y > -bottomH;
@@ -10,17 +10,22 @@
 
 #pragma once
 
+#include "IconInfo.h"
 #include "IconInfoInterface.h"
+#include "IconLayerBatches.h"
 #include "IconLayerCallbackInterface.h"
 #include "IconLayerInterface.h"
 #include "MapInterface.h"
 #include "SimpleLayerInterface.h"
 #include "SimpleTouchInterface.h"
 #include "IconLayerObject.h"
+#include "IconType.h"
 #include "DoubleAnimation.h"
+#include "SpatialGridIndex.h"
 #include <atomic>
 #include <map>
 #include <mutex>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -111,11 +116,16 @@ class IconLayer : public IconLayerInterface,
     virtual void setRenderPassIndex(int32_t index) override;
 
   private:
-    virtual void clearSync(const std::vector<std::pair<std::shared_ptr<IconInfoInterface>, std::shared_ptr<IconLayerObject>>> &iconsToClear);
+    virtual void clearSync(const std::vector<std::shared_ptr<IconLayerObject>> &iconsToClear);
 
-    void
-    setupIconObjects(const std::vector<std::pair<std::shared_ptr<IconInfoInterface>, std::shared_ptr<IconLayerObject>>>
-                         &iconObjects);
+    void setupIconObjects(const std::vector<std::shared_ptr<IconLayerObject>> &iconObjects);
+
+    std::vector<std::shared_ptr<IconLayerObject>> getIconBatches();
+
+    std::shared_ptr<IconLayerObject> createIconBatch(const std::shared_ptr<IconInfoInterface> &icon,
+                                                     const std::shared_ptr<MapInterface> &mapInterface);
+
+    int64_t getIconBatchRegion(const Coord &position);
 
     void addScaleAnimation(const IconScaleAnimation& iconScaleAnimation);
 
@@ -123,7 +133,46 @@ class IconLayer : public IconLayerInterface,
 
     std::vector<std::shared_ptr<IconInfoInterface>> getIconsAtPosition(const ::Vec2F &posScreen);
 
+    // Icons with the same texture, blend mode and region are drawn as instances of one IconLayerObject, as long as
+    // they follow each other in the order the icons were added
+    struct IconBatchKey {
+        TextureHolderInterface *texture;
+        BlendMode blendMode;
+        int64_t region;
+
+        bool operator<(const IconBatchKey &other) const {
+            return std::tie(texture, blendMode, region) < std::tie(other.texture, other.blendMode, other.region);
+        }
+
+        bool operator!=(const IconBatchKey &other) const {
+            return std::tie(texture, blendMode, region) != std::tie(other.texture, other.blendMode, other.region);
+        }
+    };
+
+    // An icon with the key of its batch and the values it was last indexed with
+    struct IconEntry {
+        std::shared_ptr<IconInfoInterface> icon;
+        IconBatchKey batchKey = IconBatchKey{nullptr, BlendMode::NORMAL, 0};
+        // icons of the IconFactory count their changes, the values of other icons are compared in every update
+        IconInfo *iconInfo = nullptr;
+        uint64_t version = 0;
+        Coord coordinate = Coord(0, 0.0, 0.0, 0.0);
+        Vec2F iconSize = Vec2F(0.0, 0.0);
+        IconType type = IconType::INVARIANT;
+        // position of the icon on the globe in 3d, as rendered by IconLayerObject
+        Vec3D position = Vec3D(0.0, 0.0, 0.0);
+    };
+
+    void updateIconIndex();
+
+    void addToIconIndex(const std::shared_ptr<IconEntry> &entry, bool isNew);
+
+    void addToMaxIconSizes(const IconEntry &entry);
+
+    double getIconIndexPadding(const std::shared_ptr<MapCameraInterface> &camera);
+
     const static int32_t SUBDIVISION_FACTOR_3D_DEFAULT = 2;
+    const static int64_t ICON_BATCH_REGIONS = 64;
 
     std::shared_ptr<MapInterface> mapInterface;
     bool is3D = false;
@@ -131,11 +180,27 @@ class IconLayer : public IconLayerInterface,
     std::shared_ptr<IconLayerCallbackInterface> callbackHandler;
 
     std::recursive_mutex iconsMutex;
-    std::vector<std::pair<std::shared_ptr<IconInfoInterface>, std::shared_ptr<IconLayerObject>>> icons;
+    // in the order they were added
+    std::vector<std::shared_ptr<IconEntry>> icons;
+
+    IconLayerBatches<IconBatchKey, IconLayerObject> iconBatches;
+    // batches with icons to draw in the last update(), in drawing order
+    std::vector<std::shared_ptr<IconLayerObject>> visibleBatches;
     std::shared_ptr<MaskingObjectInterface> mask = nullptr;
 
-    void preGenerateRenderPasses();
-    std::map<int, std::vector<std::shared_ptr<RenderObjectInterface>>> renderPassObjectMap;
+    // Icons by their position in the map coordinate system, for hit testing and culling. Icons can be moved and resized
+    // through IconInfoInterface, update() refreshes the icons changed since the last update.
+    SpatialGridIndex<IconInfoInterface *, std::shared_ptr<IconEntry>> iconIndex;
+    int32_t iconIndexSystemIdentifier = 0;
+    // largest icon diagonal of FIXED and ROTATION_INVARIANT icons in 2d (in map units) and of all other icons (in pixels),
+    // recomputed in update() if an icon was removed or became smaller
+    float maxFixedIconSize = 0.0;
+    float maxInvariantIconSize = 0.0;
+    bool maxIconSizesInvalid = false;
+    // icons within the visible rect, only used during update() in 2d
+    std::vector<std::shared_ptr<IconEntry>> visibleIcons;
+
+    void removeUnusedScaleAnimations();
 
     std::recursive_mutex addingQueueMutex;
     std::vector<std::shared_ptr<IconInfoInterface>> addingQueue;
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+/**
+ * Batches of the icons of an icon layer, each drawn as the instances of one object. The icons are added to the batches
+ * in drawing order for every frame: consecutive icons with the same key share a batch, a different key starts the next
+ * batch. Icons are thus drawn in the order they were added, with one batch per run of icons of the same key.
+ *
+ * The batches of a key are reused in the next frames and only released with the last icon of the key.
+ */
+template <typename Key, typename Batch> class IconLayerBatches {
+  public:
+    // An icon with the key was added to the layer
+    void retain(const Key &key) { batchesByKey[key].iconCount++; }
+
+    // The last icon with the key was removed, returns true and appends the batches of the key to releasedBatches
+    bool release(const Key &key, std::vector<std::shared_ptr<Batch>> &releasedBatches) {
+        auto it = batchesByKey.find(key);
+        if (it == batchesByKey.end() || --it->second.iconCount > 0) {
+            return false;
+        }
+        releasedBatches.insert(releasedBatches.end(), it->second.batches.begin(), it->second.batches.end());
+        for (const auto &batch : it->second.batches) {
+            drawingOrder.erase(std::remove(drawingOrder.begin(), drawingOrder.end(), batch), drawingOrder.end());
+        }
+        if (lastKey && !(*lastKey < key) && !(key < *lastKey)) {
+            lastKey = std::nullopt;
+        }
+        batchesByKey.erase(it);
+        return true;
+    }
+
+    void beginFrame() {
+        for (auto &[key, keyBatches] : batchesByKey) {
+            keyBatches.usedBatches = 0;
+        }
+        drawingOrder.clear();
+        lastKey = std::nullopt;
+    }
+
+    // Returns the batch for the next icon in drawing order, createBatch() is called if all batches of the key are used
+    template <typename CreateBatch> const std::shared_ptr<Batch> &add(const Key &key, CreateBatch &&createBatch) {
+        if (lastKey && !(*lastKey < key) && !(key < *lastKey)) {
+            return drawingOrder.back();
+        }
+        auto &keyBatches = batchesByKey[key];
+        if (keyBatches.usedBatches == keyBatches.batches.size()) {
+            keyBatches.batches.push_back(createBatch());
+        }
+        drawingOrder.push_back(keyBatches.batches[keyBatches.usedBatches++]);
+        lastKey = key;
+        return drawingOrder.back();
+    }
+
+    // The batches with icons of the current frame, in drawing order
+    const std::vector<std::shared_ptr<Batch>> &getDrawingOrder() const { return drawingOrder; }
+
+    std::vector<std::shared_ptr<Batch>> getBatches() const {
+        std::vector<std::shared_ptr<Batch>> batches;
+        for (const auto &[key, keyBatches] : batchesByKey) {
+            batches.insert(batches.end(), keyBatches.batches.begin(), keyBatches.batches.end());
+        }
+        return batches;
+    }
+
+    void clear() {
+        batchesByKey.clear();
+        drawingOrder.clear();
+        lastKey = std::nullopt;
+    }
+
+  private:
+    struct KeyBatches {
+        size_t iconCount = 0;
+        // the first usedBatches are drawn in the current frame
+        size_t usedBatches = 0;
+        std::vector<std::shared_ptr<Batch>> batches;
+    };
+
+    std::map<Key, KeyBatches> batchesByKey;
+    std::vector<std::shared_ptr<Batch>> drawingOrder;
+    std::optional<Key> lastKey;
+};
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Dynamic uniform grid over 2d positions, used to find the values within a rect without testing all of them.
+ * Values are identified by a key and can be inserted, moved and removed at any time. The cell size is derived from
+ * the extent and the number of positions and is adapted whenever the number of values has grown or shrunk by a
+ * factor of two. Queries return the values in the order they have been inserted, moving a value keeps its place.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>> class SpatialGridIndex {
+  public:
+    // Inserts the value at the position, or moves it there if the key is already in the index
+    void insert(const Key &key, const Value &value, double x, double y) {
+        auto it = slotByKey.find(key);
+        if (it != slotByKey.end()) {
+            moveSlot(it->second, x, y);
+            return;
+        }
+
+        const uint32_t slot = (uint32_t)slots.size();
+        const int64_t cell = cellKey(x, y);
+        slots.push_back(Slot{key, value, x, y, cell, true});
+        slotByKey.emplace(key, slot);
+        cells[cell].push_back(CellEntry{slot, x, y});
+
+        if (slotByKey.size() > 2 * std::max(sizeAtRebuild, minRebuildSize)) {
+            rebuild();
+        }
+    }
+
+    // Moves the value with key to the position, returns false if the key is not in the index
+    bool move(const Key &key, double x, double y) {
+        auto it = slotByKey.find(key);
+        if (it == slotByKey.end()) {
+            return false;
+        }
+        moveSlot(it->second, x, y);
+        return true;
+    }
+
+    bool remove(const Key &key) {
+        auto it = slotByKey.find(key);
+        if (it == slotByKey.end()) {
+            return false;
+        }
+        auto &slot = slots[it->second];
+        removeFromCell(slot.cell, it->second);
+        slot.value = Value();
+        slot.used = false;
+        slotByKey.erase(it);
+
+        // removed slots are only reclaimed by a rebuild, which also adapts the cell size to fewer values
+        if (slots.size() > 2 * std::max(slotByKey.size(), minRebuildSize) || slotByKey.size() < sizeAtRebuild / 4) {
+            rebuild();
+        }
+        return true;
+    }
+
+    void clear() {
+        slots.clear();
+        slotByKey.clear();
+        cells.clear();
+        sizeAtRebuild = 0;
+        cellSize = 1.0;
+    }
+
+    size_t size() const { return slotByKey.size(); }
+
+    // Appends the values with a position within [minX, maxX] x [minY, maxY] to result, in insertion order
+    void query(double minX, double minY, double maxX, double maxY, std::vector<Value> &result) const {
+        if (slotByKey.empty() || !(minX <= maxX) || !(minY <= maxY)) {
+            return;
+        }
+
+        std::vector<uint32_t> found;
+        const auto collect = [&](const std::vector<CellEntry> &cellEntries) {
+            for (const auto &cellEntry : cellEntries) {
+                if (cellEntry.x >= minX && cellEntry.x <= maxX && cellEntry.y >= minY && cellEntry.y <= maxY) {
+                    found.push_back(cellEntry.slot);
+                }
+            }
+        };
+
+        const int64_t minCellX = cellIndex(minX);
+        const int64_t maxCellX = cellIndex(maxX);
+        const int64_t minCellY = cellIndex(minY);
+        const int64_t maxCellY = cellIndex(maxY);
+        const double numCellsInRect = double(maxCellX - minCellX + 1) * double(maxCellY - minCellY + 1);
+
+        if (numCellsInRect > (double)cells.size()) {
+            // large rect compared to the occupied cells, e.g. zoomed out: test the occupied cells only
+            for (const auto &[key, cellEntries] : cells) {
+                collect(cellEntries);
+            }
+        } else {
+            for (int64_t cellX = minCellX; cellX <= maxCellX; cellX++) {
+                for (int64_t cellY = minCellY; cellY <= maxCellY; cellY++) {
+                    auto it = cells.find(cellKey(cellX, cellY));
+                    if (it != cells.end()) {
+                        collect(it->second);
+                    }
+                }
+            }
+        }
+
+        // slots are in insertion order, many results are marked instead of sorted
+        result.reserve(result.size() + found.size());
+        if (found.size() * 16 > slots.size()) {
+            std::vector<bool> isFound(slots.size(), false);
+            for (const auto slot : found) {
+                isFound[slot] = true;
+            }
+            for (size_t slot = 0; slot < slots.size(); slot++) {
+                if (isFound[slot]) {
+                    result.push_back(slots[slot].value);
+                }
+            }
+        } else {
+            std::sort(found.begin(), found.end());
+            for (const auto slot : found) {
+                result.push_back(slots[slot].value);
+            }
+        }
+    }
+
+  private:
+    struct Slot {
+        Key key;
+        Value value;
+        double x;
+        double y;
+        int64_t cell;
+        bool used;
+    };
+
+    struct CellEntry {
+        uint32_t slot;
+        double x;
+        double y;
+    };
+
+    void moveSlot(uint32_t slotIndex, double x, double y) {
+        auto &slot = slots[slotIndex];
+        if (slot.x == x && slot.y == y) {
+            return;
+        }
+
+        const int64_t cell = cellKey(x, y);
+        if (cell == slot.cell) {
+            for (auto &cellEntry : cells[cell]) {
+                if (cellEntry.slot == slotIndex) {
+                    cellEntry.x = x;
+                    cellEntry.y = y;
+                    break;
+                }
+            }
+        } else {
+            removeFromCell(slot.cell, slotIndex);
+            cells[cell].push_back(CellEntry{slotIndex, x, y});
+        }
+        slot.x = x;
+        slot.y = y;
+        slot.cell = cell;
+    }
+
+    void removeFromCell(int64_t cell, uint32_t slot) {
+        auto cellIt = cells.find(cell);
+        auto &cellEntries = cellIt->second;
+        auto it = std::find_if(cellEntries.begin(), cellEntries.end(), [slot](const CellEntry &cellEntry) { return cellEntry.slot == slot; });
+        *it = cellEntries.back();
+        cellEntries.pop_back();
+        if (cellEntries.empty()) {
+            cells.erase(cellIt);
+        }
+    }
+
+    // Drops the removed slots, chooses the cell size for about targetEntriesPerCell positions per cell and distributes
+    // all values again
+    void rebuild() {
+        slots.erase(std::remove_if(slots.begin(), slots.end(), [](const Slot &slot) { return !slot.used; }), slots.end());
+
+        double minX = std::numeric_limits<double>::max();
+        double minY = std::numeric_limits<double>::max();
+        double maxX = std::numeric_limits<double>::lowest();
+        double maxY = std::numeric_limits<double>::lowest();
+        for (const auto &slot : slots) {
+            minX = std::min(minX, slot.x);
+            minY = std::min(minY, slot.y);
+            maxX = std::max(maxX, slot.x);
+            maxY = std::max(maxY, slot.y);
+        }
+
+        const double numCells = std::max(1.0, (double)slots.size() / targetEntriesPerCell);
+        const double width = slots.empty() ? 0.0 : maxX - minX;
+        const double height = slots.empty() ? 0.0 : maxY - minY;
+        if (width > 0.0 && height > 0.0) {
+            cellSize = std::sqrt(width * height / numCells);
+        } else if (width > 0.0 || height > 0.0) {
+            cellSize = std::max(width, height) / numCells;
+        } else {
+            cellSize = 1.0;
+        }
+        if (!slots.empty()) {
+            // keep the cell indices within 32 bit
+            cellSize = std::max(cellSize, std::max({std::abs(minX), std::abs(maxX), std::abs(minY), std::abs(maxY)}) * 1e-8);
+        }
+        if (!(cellSize > 0.0) || !std::isfinite(cellSize)) {
+            cellSize = 1.0;
+        }
+
+        cells.clear();
+        for (uint32_t slotIndex = 0; slotIndex < (uint32_t)slots.size(); slotIndex++) {
+            auto &slot = slots[slotIndex];
+            slot.cell = cellKey(slot.x, slot.y);
+            slotByKey[slot.key] = slotIndex;
+            cells[slot.cell].push_back(CellEntry{slotIndex, slot.x, slot.y});
+        }
+        sizeAtRebuild = slots.size();
+    }
+
+    int64_t cellIndex(double value) const {
+        const double index = std::floor(value / cellSize);
+        return (int64_t)std::clamp(index, (double)std::numeric_limits<int32_t>::min(), (double)std::numeric_limits<int32_t>::max());
+    }
+
+    static int64_t cellKey(int64_t cellX, int64_t cellY) { return (int64_t)(((uint64_t)(uint32_t)cellX << 32) | (uint32_t)cellY); }
+
+    int64_t cellKey(double x, double y) const { return cellKey(cellIndex(x), cellIndex(y)); }
+
+    static constexpr double targetEntriesPerCell = 8.0;
+    static constexpr size_t minRebuildSize = 64;
+
+    // in insertion order, removed slots are kept until the next rebuild
+    std::vector<Slot> slots;
+    std::unordered_map<Key, uint32_t, Hash> slotByKey;
+    std::unordered_map<int64_t, std::vector<CellEntry>> cells;
+    double cellSize = 1.0;
+    size_t sizeAtRebuild = 0;
+};
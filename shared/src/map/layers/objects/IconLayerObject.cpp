@@ -19,14 +19,16 @@
 #include "Anchor.h"
 #include "MapCameraInterface.h"
 #include "MapConfig.h"
+#include "InstancedRangeUpdateInterface.h"
 
 IconLayerObject::IconLayerObject(std::shared_ptr<Quad2dInstancedInterface> quad,
-                                             const std::shared_ptr<IconInfoInterface> &icon,
+                                             const std::shared_ptr<TextureHolderInterface> &texture,
                                              const std::shared_ptr<AlphaInstancedShaderInterface> &shader,
                                  const std::shared_ptr<MapInterface> &mapInterface,
+                                 const Coord &originCoordinate,
                                  bool is3d)
         : quad(quad),
-          icon(icon),
+          texture(texture),
           shader(shader),
           mapInterface(mapInterface),
           conversionHelper(mapInterface->getCoordinateConverterHelper()),
@@ -34,17 +36,9 @@ IconLayerObject::IconLayerObject(std::shared_ptr<Quad2dInstancedInterface> quad,
           graphicsObject(quad->asGraphicsObject()),
           renderObject(std::make_shared<RenderObject>(graphicsObject)),
           is3d(is3d) {
-    int count = 1;
-    quad->setInstanceCount(count);
+    quad->setInstanceCount(instanceCount);
 
-    iconAlphas.resize(count, 1.0);
-    iconRotations.resize(count, 0.0);
-    iconScales.resize(count * 2, 0.0);
-    iconPositions.resize(count * (is3d ? 3 : 2), 0.0);
-    iconTextureCoordinates = {0.0, 0.0, 1.0, 1.0};
-    iconOffsets.resize(count * 2, 0.0);
-
-    auto renderCoord = conversionHelper->convertToRenderSystem(icon->getCoordinate());
+    auto renderCoord = conversionHelper->convertToRenderSystem(originCoordinate);
     if (is3d) {
         const double sinY = sin(renderCoord.y);
         const double cosY = cos(renderCoord.y);
@@ -60,13 +54,28 @@ IconLayerObject::IconLayerObject(std::shared_ptr<Quad2dInstancedInterface> quad,
 }
 
 void IconLayerObject::setup(const std::shared_ptr<RenderingContextInterface> context) {
+    // shared by all icons of the batch, only set up once
+    if (getGraphicsObject()->isReady()) {
+        return;
+    }
     getGraphicsObject()->setup(context);
-    getQuadObject()->loadTexture(context, icon->getTexture());
-
-    quad->setTextureCoordinates(SharedBytes((int64_t)iconTextureCoordinates.data(), (int32_t) iconAlphas.size(), 4 * (int32_t)sizeof(float)));
-    quad->setAlphas(SharedBytes((int64_t) iconAlphas.data(), (int32_t) iconAlphas.size(), (int32_t) sizeof(float)));
+    getQuadObject()->loadTexture(context, texture);
+
+    // the values of all instances are sent again with the next update
+    iconPositions.setModified();
+    iconScales.setModified();
+    iconRotations.setModified();
+    iconAlphas.setModified();
+    iconOffsets.setModified();
+    iconTextureCoordinates.setModified();
 }
 
+void IconLayerObject::clearInstances() { instanceIcons.clear(); }
+
+void IconLayerObject::addInstance(const std::shared_ptr<IconInfoInterface> &icon) { instanceIcons.push_back(icon); }
+
+size_t IconLayerObject::getInstanceCount() const { return instanceIcons.size(); }
+
 void IconLayerObject::update() {
     auto lockSelfPtr = shared_from_this();
     auto mapInterface = lockSelfPtr ? lockSelfPtr->mapInterface : nullptr;
@@ -78,98 +87,120 @@ void IconLayerObject::update() {
     auto viewport = context->getViewportSize();
 
     const auto scaleFactor = camera->getScalingFactor();
+    const float meterToMapUnit = mapInterface->getMapConfig().mapCoordinateSystem.unitToScreenMeterFactor;
+    const double rotation = camera->getRotation();
+
+    const int32_t count = (int32_t)instanceIcons.size();
+    const int32_t positionSize = is3d ? 3 : 2;
+    if (count != instanceCount) {
+        instanceCount = count;
+        quad->setInstanceCount(count);
+        iconPositions.resize(count * positionSize, 0.0);
+        iconScales.resize(count * 2, 0.0);
+        iconRotations.resize(count, 0.0);
+        iconAlphas.resize(count, alpha);
+        iconOffsets.resize(count * 2, 0.0);
+        iconTextureCoordinates.resize(count * 4, 0.0);
+    }
+    if (count == 0) {
+        return;
+    }
 
-    auto iconSize = icon->getIconSize();
-    auto type = icon->getType();
-
-    // POSITION
+    for (int32_t i = 0; i < count; i++) {
+        const auto &icon = instanceIcons[i];
+        auto iconSize = icon->getIconSize();
+        auto type = icon->getType();
 
-    auto currentRenderCoord = conversionHelper->convertToRenderSystem(icon->getCoordinate());
-    if (is3d) {
-        const double sinY = sin(currentRenderCoord.y);
-        const double cosY = cos(currentRenderCoord.y);
-        const double sinX = sin(currentRenderCoord.x);
-        const double cosX = cos(currentRenderCoord.x);
+        // POSITION
 
-        iconPositions = {
-            (float)(currentRenderCoord.z * (sinY * cosX) - origin.x),
-            (float)(currentRenderCoord.z * cosY - origin.y),
-            (float)(-currentRenderCoord.z * (sinY * sinX) - origin.z)
-        };
+        auto currentRenderCoord = conversionHelper->convertToRenderSystem(icon->getCoordinate());
+        if (is3d) {
+            const double sinY = sin(currentRenderCoord.y);
+            const double cosY = cos(currentRenderCoord.y);
+            const double sinX = sin(currentRenderCoord.x);
+            const double cosX = cos(currentRenderCoord.x);
 
-    } else {
-        iconPositions = {(float) (currentRenderCoord.x - origin.x), (float) (currentRenderCoord.y - origin.y)};
-    }
-
-    // SCALE
+            iconPositions[3 * i] = (float)(currentRenderCoord.z * (sinY * cosX) - origin.x);
+            iconPositions[3 * i + 1] = (float)(currentRenderCoord.z * cosY - origin.y);
+            iconPositions[3 * i + 2] = (float)(-currentRenderCoord.z * (sinY * sinX) - origin.z);
+        } else {
+            iconPositions[2 * i] = (float) (currentRenderCoord.x - origin.x);
+            iconPositions[2 * i + 1] = (float) (currentRenderCoord.y - origin.y);
+        }
 
-    auto width = iconSize.x;
-    auto height = iconSize.y;
+        // SCALE
 
-    if(type == IconType::FIXED || type == IconType::ROTATION_INVARIANT) {
-        float meterToMapUnit = mapInterface->getMapConfig().mapCoordinateSystem.unitToScreenMeterFactor;
+        auto width = iconSize.x;
+        auto height = iconSize.y;
 
-        float z = meterToMapUnit / scaleFactor;
+        if(type == IconType::FIXED || type == IconType::ROTATION_INVARIANT) {
+            float z = meterToMapUnit / scaleFactor;
 
-        if(is3d) {
-            iconScales[0] = z * width;
-            iconScales[1] = z * height;
-            iconScales[0] /= double(viewport.x);
-            iconScales[1] /= double(viewport.y);
-        } else {
-            iconScales[0] = meterToMapUnit * width;
-            iconScales[1] = meterToMapUnit * height;
-        }
-    } else {
-        if(is3d) {
-            iconScales[0] = 2.0 * width / double(viewport.x);
-            iconScales[1] = 2.0 * height / double(viewport.y);
+            if(is3d) {
+                iconScales[2 * i] = z * width / double(viewport.x);
+                iconScales[2 * i + 1] = z * height / double(viewport.y);
+            } else {
+                iconScales[2 * i] = meterToMapUnit * width;
+                iconScales[2 * i + 1] = meterToMapUnit * height;
+            }
         } else {
-            iconScales[0] = width * scaleFactor;
-            iconScales[1] = height * scaleFactor;
+            if(is3d) {
+                iconScales[2 * i] = 2.0 * width / double(viewport.x);
+                iconScales[2 * i + 1] = 2.0 * height / double(viewport.y);
+            } else {
+                iconScales[2 * i] = width * scaleFactor;
+                iconScales[2 * i + 1] = height * scaleFactor;
+            }
         }
-    }
-
-    // ROTATION
-
-    double angle = 0.0;
-    if(type == IconType::ROTATION_INVARIANT || type == IconType::INVARIANT) {
-        angle = camera->getRotation();
-    }
 
-    iconRotations[0] = angle;
+        // ROTATION
 
-    // OFFSETS
+        double angle = 0.0;
+        if(type == IconType::ROTATION_INVARIANT || type == IconType::INVARIANT) {
+            angle = rotation;
+        }
 
-    iconOffsets[0] = 0.0;
-    iconOffsets[1] = 0.0;
+        iconRotations[i] = angle;
 
-    const Vec2F &anchor = icon->getIconAnchor();
-    float ratioLeftRight = std::clamp(anchor.x, 0.0f, 1.0f);
-    float ratioTopBottom = std::clamp(anchor.y, 0.0f, 1.0f);
+        // OFFSETS
 
-    // ratio = 0.5 -> center -> nothing to do
-    // ratio = 1.0 -> right in middle -> -0.5 * width
-    // ratio = 0.0 -> left in middle -> 0.5 * width
-    if(!is3d) {
-        iconOffsets[0] = (0.5 - ratioLeftRight) * width * scaleFactor;
-        iconOffsets[1] = (0.5 - ratioTopBottom) * height * scaleFactor;
-    } else {
-        iconOffsets[0] = 2.0 * (0.5 - ratioLeftRight) * width / viewport.x;
-        iconOffsets[1] = 2.0 * (0.5 - (1.0 - ratioTopBottom)) * height / viewport.y;
-    }
+        const Vec2F &anchor = icon->getIconAnchor();
+        float ratioLeftRight = std::clamp(anchor.x, 0.0f, 1.0f);
+        float ratioTopBottom = std::clamp(anchor.y, 0.0f, 1.0f);
 
-    quad->setPositions(SharedBytes((int64_t) iconPositions.data(), (int32_t) iconAlphas.size(),
-                                   (int32_t) iconPositions.size() * (int32_t) sizeof(float)));
+        // ratio = 0.5 -> center -> nothing to do
+        // ratio = 1.0 -> right in middle -> -0.5 * width
+        // ratio = 0.0 -> left in middle -> 0.5 * width
+        if(!is3d) {
+            iconOffsets[2 * i] = (0.5 - ratioLeftRight) * width * scaleFactor;
+            iconOffsets[2 * i + 1] = (0.5 - ratioTopBottom) * height * scaleFactor;
+        } else {
+            iconOffsets[2 * i] = 2.0 * (0.5 - ratioLeftRight) * width / viewport.x;
+            iconOffsets[2 * i + 1] = 2.0 * (0.5 - (1.0 - ratioTopBottom)) * height / viewport.y;
+        }
 
-    quad->setScales(
-        SharedBytes((int64_t) iconScales.data(), (int32_t) iconAlphas.size(), 2 * (int32_t) sizeof(float)));
+        // ALPHA, TEXTURE
 
-    quad->setRotations(
-        SharedBytes((int64_t) iconRotations.data(), (int32_t) iconAlphas.size(), 1 * (int32_t) sizeof(float)));
+        iconAlphas[i] = alpha;
+        iconTextureCoordinates[4 * i] = 0.0;
+        iconTextureCoordinates[4 * i + 1] = 0.0;
+        iconTextureCoordinates[4 * i + 2] = 1.0;
+        iconTextureCoordinates[4 * i + 3] = 1.0;
+    }
 
-    quad->setPositionOffset(
-        SharedBytes((int64_t) iconOffsets.data(), (int32_t) iconAlphas.size(), 2 * (int32_t) sizeof(float)));
+    auto rangeObject = dynamic_cast<InstancedRangeUpdateInterface *>(quad.get());
+    uploadModifiedInstances(iconPositions, positionSize, count, rangeObject, InstancedRangeUpdateInterface::Attribute::POSITIONS,
+                            [&](const SharedBytes &bytes) { quad->setPositions(bytes); });
+    uploadModifiedInstances(iconScales, 2, count, rangeObject, InstancedRangeUpdateInterface::Attribute::SCALES,
+                            [&](const SharedBytes &bytes) { quad->setScales(bytes); });
+    uploadModifiedInstances(iconRotations, 1, count, rangeObject, InstancedRangeUpdateInterface::Attribute::ROTATIONS,
+                            [&](const SharedBytes &bytes) { quad->setRotations(bytes); });
+    uploadModifiedInstances(iconOffsets, 2, count, rangeObject, InstancedRangeUpdateInterface::Attribute::POSITION_OFFSETS,
+                            [&](const SharedBytes &bytes) { quad->setPositionOffset(bytes); });
+    uploadModifiedInstances(iconAlphas, 1, count, rangeObject, InstancedRangeUpdateInterface::Attribute::ALPHAS,
+                            [&](const SharedBytes &bytes) { quad->setAlphas(bytes); });
+    uploadModifiedInstances(iconTextureCoordinates, 4, count, rangeObject, InstancedRangeUpdateInterface::Attribute::TEXTURE_COORDINATES,
+                            [&](const SharedBytes &bytes) { quad->setTextureCoordinates(bytes); });
 
     if (animation) {
         animation->update();
@@ -179,8 +210,8 @@ void IconLayerObject::update() {
 std::vector<std::shared_ptr<RenderConfigInterface>> IconLayerObject::getRenderConfig() { return {renderConfig}; }
 
 void IconLayerObject::setAlpha(float alpha) {
-    iconAlphas[0] = alpha;
-    quad->setAlphas(SharedBytes((int64_t) iconAlphas.data(), (int32_t) iconAlphas.size(), (int32_t) sizeof(float)));
+    // written to the instances with the next update
+    this->alpha = alpha;
 
     mapInterface->invalidate();
 }
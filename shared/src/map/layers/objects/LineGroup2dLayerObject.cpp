@@ -34,6 +34,14 @@ std::vector<std::shared_ptr<RenderConfigInterface>> LineGroup2dLayerObject::getR
 
 void LineGroup2dLayerObject::setLines(const std::vector<std::tuple<std::vector<Vec2D>, int>> &lines, const int32_t systemIdentifier,
                                       const Vec3D &origin, LineCapType capType, LineJoinType joinType, bool optimizeForDots) {
+    const auto convertedLines = convertToRenderCoordinates(conversionHelper, lines, systemIdentifier, origin, is3d);
+    LineGeometryBuilder::buildLines(line, convertedLines, origin, capType, joinType, is3d, optimizeForDots);
+}
+
+std::vector<std::tuple<std::vector<Vec3D>, int>> LineGroup2dLayerObject::convertToRenderCoordinates(const std::shared_ptr<CoordinateConversionHelperInterface> &conversionHelper,
+                                                                                                    const std::vector<std::tuple<std::vector<Vec2D>, int>> &lines,
+                                                                                                    const int32_t systemIdentifier,
+                                                                                                    const Vec3D &origin, bool is3d) {
     int numLines = (int)lines.size();
 
     std::vector<std::tuple<std::vector<Vec3D>, int>> convertedLines;
@@ -61,7 +69,7 @@ void LineGroup2dLayerObject::setLines(const std::vector<std::tuple<std::vector<V
         convertedLines.emplace_back(std::move(renderCoords), lineStyleIndex);
     }
 
-    LineGeometryBuilder::buildLines(line, convertedLines, origin, capType, joinType, is3d, optimizeForDots);
+    return convertedLines;
 }
 
 void LineGroup2dLayerObject::setLines(const std::vector<std::tuple<std::vector<Coord>, int>> &lines, const Vec3D &origin,
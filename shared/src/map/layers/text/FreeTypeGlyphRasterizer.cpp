@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "FreeTypeGlyphRasterizer.h"
+#include "Logger.h"
+#include "Utf8Iterator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#ifdef MAPSCORE_WITH_FREETYPE
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+struct FreeTypeGlyphRasterizer::Face {
+    FT_Library library = nullptr;
+    FT_Face face = nullptr;
+
+    ~Face() {
+        if (face) {
+            FT_Done_Face(face);
+        }
+        if (library) {
+            FT_Done_FreeType(library);
+        }
+    }
+};
+
+std::shared_ptr<FreeTypeGlyphRasterizer> FreeTypeGlyphRasterizer::create(const std::string &fontFilePath) {
+    auto face = std::make_unique<Face>();
+    if (FT_Init_FreeType(&face->library) != 0) {
+        LogError <<= "FreeTypeGlyphRasterizer: FreeType could not be initialized";
+        return nullptr;
+    }
+    if (FT_New_Face(face->library, fontFilePath.c_str(), 0, &face->face) != 0) {
+        LogError <<= "FreeTypeGlyphRasterizer: font " + fontFilePath + " could not be opened";
+        return nullptr;
+    }
+    return std::shared_ptr<FreeTypeGlyphRasterizer>(new FreeTypeGlyphRasterizer(std::move(face)));
+}
+
+std::optional<RasterizedGlyph> FreeTypeGlyphRasterizer::rasterize(const std::string &charCode, double fontSize) {
+    uint32_t codepoint;
+    if (Utf8Iterator::decode(charCode, codepoint) != charCode.size()) {
+        return std::nullopt;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto glyphIndex = FT_Get_Char_Index(face->face, codepoint);
+    if (glyphIndex == 0) {
+        return std::nullopt;
+    }
+    // sizes in 26.6 fixed point
+    if (FT_Set_Char_Size(face->face, 0, (FT_F26Dot6)std::lround(fontSize * 64.0), 72, 72) != 0 ||
+        FT_Load_Glyph(face->face, glyphIndex, FT_LOAD_RENDER) != 0) {
+        return std::nullopt;
+    }
+
+    const auto slot = face->face->glyph;
+    const auto &bitmap = slot->bitmap;
+    RasterizedGlyph glyph;
+    glyph.advance = slot->advance.x / 64.0;
+    glyph.bearingX = slot->bitmap_left;
+    glyph.bearingY = slot->bitmap_top;
+    if (bitmap.pixel_mode != FT_PIXEL_MODE_GRAY || bitmap.width == 0 || bitmap.rows == 0) {
+        // e.g. spaces
+        return glyph;
+    }
+    glyph.width = (int32_t)bitmap.width;
+    glyph.height = (int32_t)bitmap.rows;
+    glyph.coverage.resize((size_t)glyph.width * glyph.height);
+    for (int32_t y = 0; y < glyph.height; y++) {
+        const auto row = bitmap.buffer + (ptrdiff_t)y * bitmap.pitch;
+        std::copy(row, row + glyph.width, glyph.coverage.begin() + (size_t)y * glyph.width);
+    }
+    return glyph;
+}
+
+#else
+
+struct FreeTypeGlyphRasterizer::Face {};
+
+std::shared_ptr<FreeTypeGlyphRasterizer> FreeTypeGlyphRasterizer::create(const std::string &fontFilePath) {
+    LogError <<= "FreeTypeGlyphRasterizer: built without FreeType, font " + fontFilePath + " can not be used";
+    return nullptr;
+}
+
+std::optional<RasterizedGlyph> FreeTypeGlyphRasterizer::rasterize(const std::string &charCode, double fontSize) {
+    return std::nullopt;
+}
+
+#endif
+
+FreeTypeGlyphRasterizer::FreeTypeGlyphRasterizer(std::unique_ptr<Face> face)
+    : face(std::move(face)) {}
+
+FreeTypeGlyphRasterizer::~FreeTypeGlyphRasterizer() = default;
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "GlyphRasterizerInterface.h"
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+/**
+ * Rasterizes the glyphs of a TrueType or OpenType font file with FreeType.
+ *
+ * Only available if the library is built with FreeType (MAPSCORE_WITH_FREETYPE). A face of FreeType must not be used
+ * concurrently, so the rasterization itself is serialized, the distance fields are still generated in parallel.
+ */
+class FreeTypeGlyphRasterizer : public GlyphRasterizerInterface {
+  public:
+    // Returns nullptr if the font file can not be opened or the library is built without FreeType
+    static std::shared_ptr<FreeTypeGlyphRasterizer> create(const std::string &fontFilePath);
+
+    ~FreeTypeGlyphRasterizer() override;
+
+    std::optional<RasterizedGlyph> rasterize(const std::string &charCode, double fontSize) override;
+
+  private:
+    struct Face;
+
+    explicit FreeTypeGlyphRasterizer(std::unique_ptr<Face> face);
+
+    std::mutex mutex;
+    std::unique_ptr<Face> face;
+};
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "SdfFontLoader.h"
+#include "Font.h"
+#include "FreeTypeGlyphRasterizer.h"
+#include "SdfGlyphAtlas.h"
+#include "Utf8Iterator.h"
+
+SdfFontLoader::SdfFontLoader(TextureFactory createTexture, double fontSize)
+    : createTexture(std::move(createTexture)),
+      fontSize(fontSize) {}
+
+SdfFontLoader::~SdfFontLoader() = default;
+
+bool SdfFontLoader::addFont(const std::string &fontName, const std::string &fontFilePath) {
+    auto rasterizer = FreeTypeGlyphRasterizer::create(fontFilePath);
+    if (!rasterizer) {
+        return false;
+    }
+    addFont(fontName, rasterizer);
+    return true;
+}
+
+void SdfFontLoader::addFont(const std::string &fontName, const std::shared_ptr<GlyphRasterizerInterface> &rasterizer) {
+    SdfGlyphAtlas::Config config;
+    config.fontName = fontName;
+    config.fontSize = fontSize;
+    auto atlas = std::make_shared<SdfGlyphAtlas>(rasterizer, config);
+
+    std::vector<std::string> printableAscii;
+    for (char c = ' '; c <= '~'; c++) {
+        printableAscii.emplace_back(1, c);
+    }
+    atlas->prepareGlyphs(printableAscii);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    atlases[fontName] = atlas;
+}
+
+FontLoaderResult SdfFontLoader::loadFont(const Font &font) {
+    const auto atlas = getAtlas(font.name);
+    if (!atlas) {
+        return FontLoaderResult(nullptr, std::nullopt, LoaderStatus::ERROR_404);
+    }
+
+    auto [fontData, image] = atlas->createFontDataWithImage();
+    auto texture = createTexture(image.width, image.height, std::move(image.pixels));
+    if (!texture) {
+        return FontLoaderResult(nullptr, std::nullopt, LoaderStatus::ERROR_OTHER);
+    }
+    return FontLoaderResult(texture, std::move(fontData), LoaderStatus::OK);
+}
+
+std::optional<uint64_t> SdfFontLoader::prepareGlyphs(const std::string &fontName, const std::string &text) {
+    const auto atlas = getAtlas(fontName);
+    if (!atlas) {
+        return std::nullopt;
+    }
+
+    std::vector<std::string> letters;
+    for (const auto letter : Utf8Letters(text)) {
+        letters.emplace_back(letter);
+    }
+    atlas->prepareGlyphs(letters);
+    return atlas->getVersion();
+}
+
+std::vector<SdfFontLoader::AtlasStatistics> SdfFontLoader::getStatistics() {
+    std::vector<std::pair<std::string, std::shared_ptr<SdfGlyphAtlas>>> fonts;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        fonts.assign(atlases.begin(), atlases.end());
+    }
+
+    std::vector<AtlasStatistics> statistics;
+    for (const auto &[fontName, atlas] : fonts) {
+        const auto atlasStatistics = atlas->getStatistics();
+        statistics.push_back(AtlasStatistics{fontName, atlasStatistics.numGlyphs, atlasStatistics.numMissingGlyphs,
+                                             atlasStatistics.width, atlasStatistics.height, atlasStatistics.sizeBytes,
+                                             atlasStatistics.occupancy});
+    }
+    return statistics;
+}
+
+std::shared_ptr<SdfGlyphAtlas> SdfFontLoader::getAtlas(const std::string &fontName) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = atlases.find(fontName);
+    return it != atlases.end() ? it->second : nullptr;
+}
@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "SdfGlyphAtlas.h"
+#include "PerformanceLogger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// large instead of infinite, to keep the parabola intersections finite
+constexpr double sdfInfinity = 1e20;
+
+// Squared euclidean distance transform of one row or column, see Felzenszwalb and Huttenlocher, "Distance Transforms
+// of Sampled Functions"
+void distanceTransform1d(std::vector<double> &grid, size_t offset, size_t stride, int32_t length, std::vector<double> &f,
+                         std::vector<int32_t> &v, std::vector<double> &z) {
+    v[0] = 0;
+    z[0] = -sdfInfinity;
+    z[1] = sdfInfinity;
+    f[0] = grid[offset];
+
+    int32_t k = 0;
+    for (int32_t q = 1; q < length; q++) {
+        f[q] = grid[offset + q * stride];
+        double s;
+        do {
+            const int32_t r = v[k];
+            s = (f[q] - f[r] + (double)q * q - (double)r * r) / (q - r) / 2.0;
+        } while (s <= z[k] && --k > -1);
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = sdfInfinity;
+    }
+
+    k = 0;
+    for (int32_t q = 0; q < length; q++) {
+        while (z[k + 1] < q) {
+            k++;
+        }
+        const int32_t r = v[k];
+        grid[offset + q * stride] = f[r] + (double)(q - r) * (q - r);
+    }
+}
+
+void distanceTransform2d(std::vector<double> &grid, int32_t width, int32_t height, std::vector<double> &f, std::vector<int32_t> &v,
+                         std::vector<double> &z) {
+    for (int32_t x = 0; x < width; x++) {
+        distanceTransform1d(grid, x, width, height, f, v, z);
+    }
+    for (int32_t y = 0; y < height; y++) {
+        distanceTransform1d(grid, (size_t)y * width, 1, width, f, v, z);
+    }
+}
+
+} // namespace
+
+SdfGlyphAtlas::SdfGlyphAtlas(const std::shared_ptr<GlyphRasterizerInterface> &rasterizer, const Config &config)
+    : rasterizer(rasterizer),
+      config(config),
+      height(std::min(config.initialHeight, config.maxHeight)),
+      pixels((size_t)config.width * height, 0) {}
+
+std::vector<uint8_t> SdfGlyphAtlas::generateSdf(const std::vector<uint8_t> &coverage, int32_t width, int32_t height, int32_t buffer,
+                                                double distanceRange) {
+    const int32_t paddedWidth = width + 2 * buffer;
+    const int32_t paddedHeight = height + 2 * buffer;
+    const size_t size = (size_t)paddedWidth * paddedHeight;
+
+    // squared distances to the nearest pixel inside (outer) and outside (inner) of the glyph, partially covered pixels
+    // are placed on the outline with a subpixel offset
+    std::vector<double> gridOuter(size, sdfInfinity);
+    std::vector<double> gridInner(size, 0.0);
+    for (int32_t y = 0; y < height; y++) {
+        for (int32_t x = 0; x < width; x++) {
+            const double a = coverage[(size_t)y * width + x] / 255.0;
+            const size_t index = (size_t)(y + buffer) * paddedWidth + x + buffer;
+            if (a == 1.0) {
+                gridOuter[index] = 0.0;
+                gridInner[index] = sdfInfinity;
+            } else if (a > 0.0) {
+                const double d = 0.5 - a;
+                gridOuter[index] = d > 0.0 ? d * d : 0.0;
+                gridInner[index] = d < 0.0 ? d * d : 0.0;
+            }
+        }
+    }
+
+    const int32_t maxLength = std::max(paddedWidth, paddedHeight);
+    std::vector<double> f(maxLength);
+    std::vector<int32_t> v(maxLength);
+    std::vector<double> z(maxLength + 1);
+    distanceTransform2d(gridOuter, paddedWidth, paddedHeight, f, v, z);
+    distanceTransform2d(gridInner, paddedWidth, paddedHeight, f, v, z);
+
+    std::vector<uint8_t> sdf(size);
+    for (size_t i = 0; i < size; i++) {
+        const double distance = std::sqrt(gridOuter[i]) - std::sqrt(gridInner[i]);
+        const double value = std::clamp(0.5 - distance / distanceRange, 0.0, 1.0);
+        sdf[i] = (uint8_t)std::lround(value * 255.0);
+    }
+    return sdf;
+}
+
+bool SdfGlyphAtlas::prepareGlyphs(const std::vector<std::string> &charCodes) {
+    std::vector<std::string> missing;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unordered_set<std::string> requested;
+        for (const auto &charCode : charCodes) {
+            if (glyphs.count(charCode) == 0 && missingGlyphs.count(charCode) == 0 && requested.insert(charCode).second) {
+                missing.push_back(charCode);
+            }
+        }
+    }
+    if (missing.empty()) {
+        return true;
+    }
+
+    struct PreparedGlyph {
+        std::optional<RasterizedGlyph> glyph;
+        std::vector<uint8_t> sdf;
+    };
+    std::vector<PreparedGlyph> preparedGlyphs;
+    preparedGlyphs.reserve(missing.size());
+    for (const auto &charCode : missing) {
+        auto glyph = rasterizer->rasterize(charCode, config.fontSize);
+        if (glyph && glyph->coverage.size() < (size_t)std::max(glyph->width, 0) * std::max(glyph->height, 0)) {
+            glyph = std::nullopt;
+        }
+        std::vector<uint8_t> sdf;
+        if (glyph && glyph->width > 0 && glyph->height > 0) {
+            sdf = generateSdf(glyph->coverage, glyph->width, glyph->height, config.buffer, config.distanceRange);
+        }
+        preparedGlyphs.push_back(PreparedGlyph{std::move(glyph), std::move(sdf)});
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    bool allFit = true;
+    size_t numAdded = 0;
+    for (size_t i = 0; i < missing.size(); i++) {
+        const auto &charCode = missing[i];
+        const auto &prepared = preparedGlyphs[i];
+        if (glyphs.count(charCode) != 0 || missingGlyphs.count(charCode) != 0) {
+            // added by another thread in the meantime
+            continue;
+        }
+        rasterizedGlyphs++;
+        if (!prepared.glyph) {
+            missingGlyphs.insert(charCode);
+            continue;
+        }
+
+        const auto &rasterized = *prepared.glyph;
+        Glyph glyph{0, 0, 0, 0, rasterized.advance, rasterized.bearingX, rasterized.bearingY};
+        if (!prepared.sdf.empty()) {
+            glyph.width = rasterized.width + 2 * config.buffer;
+            glyph.height = rasterized.height + 2 * config.buffer;
+            if (!packLocked(glyph.width, glyph.height, glyph.x, glyph.y)) {
+                allFit = false;
+                continue;
+            }
+            for (int32_t row = 0; row < glyph.height; row++) {
+                std::memcpy(&pixels[(size_t)(glyph.y + row) * config.width + glyph.x], &prepared.sdf[(size_t)row * glyph.width],
+                            glyph.width);
+            }
+            glyph.bearingX -= config.buffer;
+            glyph.bearingY += config.buffer;
+            glyphArea += (int64_t)glyph.width * glyph.height;
+        }
+        glyphs.emplace(charCode, glyph);
+        this->charCodes.push_back(charCode);
+        numAdded++;
+    }
+    if (numAdded > 0) {
+        version++;
+    }
+    PERF_LOG_COUNT("SdfGlyphAtlas_rasterizedGlyphs", (int64_t)missing.size());
+    return allFit;
+}
+
+bool SdfGlyphAtlas::packLocked(int32_t width, int32_t height, int32_t &x, int32_t &y) {
+    if (width > config.width || height > config.maxHeight) {
+        return false;
+    }
+
+    // the lowest shelf the rect fits into without wasting more than a quarter of the shelf
+    Shelf *bestShelf = nullptr;
+    for (auto &shelf : shelves) {
+        if (shelf.x + width <= config.width && shelf.height >= height && shelf.height * 3 <= height * 4 + 8 &&
+            (!bestShelf || shelf.height < bestShelf->height)) {
+            bestShelf = &shelf;
+        }
+    }
+    if (bestShelf) {
+        x = bestShelf->x;
+        y = bestShelf->y;
+        bestShelf->x += width;
+        return true;
+    }
+
+    const int32_t top = shelves.empty() ? 0 : shelves.back().y + shelves.back().height;
+    if (top + height > config.maxHeight) {
+        return false;
+    }
+    if (top + height > this->height) {
+        // rows are contiguous, growing only appends rows to the image
+        while (top + height > this->height) {
+            this->height = std::min(this->height * 2, config.maxHeight);
+        }
+        pixels.resize((size_t)config.width * this->height, 0);
+    }
+    shelves.push_back(Shelf{top, height, width});
+    x = 0;
+    y = top;
+    return true;
+}
+
+std::optional<SdfGlyphAtlas::Glyph> SdfGlyphAtlas::getGlyph(const std::string &charCode) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = glyphs.find(charCode);
+        if (it != glyphs.end()) {
+            return it->second;
+        }
+        if (missingGlyphs.count(charCode) != 0) {
+            return std::nullopt;
+        }
+    }
+
+    prepareGlyphs({charCode});
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = glyphs.find(charCode);
+    if (it != glyphs.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+FontData SdfGlyphAtlas::createFontData() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return createFontDataLocked();
+}
+
+FontData SdfGlyphAtlas::createFontDataLocked() {
+    const double size = config.fontSize;
+    const double width = config.width;
+    const double height = this->height;
+
+    std::vector<FontGlyph> fontGlyphs;
+    fontGlyphs.reserve(charCodes.size());
+    for (const auto &charCode : charCodes) {
+        const auto &glyph = glyphs.at(charCode);
+        const double s0 = glyph.x / width;
+        const double s1 = (glyph.x + glyph.width) / width;
+        const double t0 = glyph.y / height;
+        const double t1 = (glyph.y + glyph.height) / height;
+        // offset of the rect from the top of the line, as in the pre-rendered fonts
+        const double yOffset = config.base * size - glyph.bearingY;
+        fontGlyphs.emplace_back(charCode, Vec2D(glyph.advance / size, 0.0), Vec2D(glyph.width / size, glyph.height / size),
+                                Vec2D(glyph.bearingX / size, -yOffset / size),
+                                Quad2dD(Vec2D(s0, t1), Vec2D(s1, t1), Vec2D(s1, t0), Vec2D(s0, t0)));
+    }
+    return FontData(FontWrapper(config.fontName, config.lineHeight, config.base, Vec2D(width, height), size, config.distanceRange),
+                    std::move(fontGlyphs));
+}
+
+SdfGlyphAtlas::Image SdfGlyphAtlas::getImage() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return Image{config.width, height, pixels, version};
+}
+
+std::pair<FontData, SdfGlyphAtlas::Image> SdfGlyphAtlas::createFontDataWithImage() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return {createFontDataLocked(), Image{config.width, height, pixels, version}};
+}
+
+uint64_t SdfGlyphAtlas::getVersion() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return version;
+}
+
+SdfGlyphAtlas::Statistics SdfGlyphAtlas::getStatistics() {
+    std::lock_guard<std::mutex> lock(mutex);
+    const double atlasArea = (double)config.width * height;
+    return Statistics{glyphs.size(),
+                      missingGlyphs.size(),
+                      rasterizedGlyphs,
+                      config.width,
+                      height,
+                      pixels.size(),
+                      atlasArea > 0 ? glyphArea / atlasArea : 0.0};
+}
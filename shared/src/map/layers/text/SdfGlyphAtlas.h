@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "FontData.h"
+#include "GlyphRasterizerInterface.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+ * Single channel signed distance field atlas of a font, filled on demand with the glyphs of a GlyphRasterizerInterface.
+ *
+ * Instead of shipping a pre-rendered atlas with a fixed glyph set, glyphs are rasterized when they are first requested.
+ * The distance fields are packed into shelves of an atlas of fixed width, whose height doubles when it is full, up to
+ * maxHeight. The atlas can be exported as FontData with the image, in the format of the pre-rendered fonts (metrics
+ * relative to the font size, distance 0.5 on the outline), see SdfFontLoader. The text shaders take the median of the
+ * red, green and blue channel, so the single channel is uploaded to all three.
+ *
+ * All methods are thread-safe. Rasterization and distance field generation run on the calling thread without holding
+ * the lock, so several worker threads can fill the atlas concurrently.
+ */
+class SdfGlyphAtlas {
+  public:
+    struct Config {
+        std::string fontName;
+        // size the glyphs are rasterized with, in pixels
+        double fontSize = 24.0;
+        // relative to the font size
+        double lineHeight = 1.2;
+        double base = 0.95;
+        // padding around each glyph, in pixels
+        int32_t buffer = 4;
+        // distance in pixels between the minimum and the maximum value of the field, centered on the outline
+        double distanceRange = 8.0;
+        int32_t width = 512;
+        int32_t initialHeight = 128;
+        int32_t maxHeight = 4096;
+    };
+
+    // Rect of a glyph in the atlas, including the buffer, and its metrics in pixels. The bearings refer to the rect.
+    struct Glyph {
+        int32_t x;
+        int32_t y;
+        int32_t width;
+        int32_t height;
+        double advance;
+        double bearingX;
+        double bearingY;
+    };
+
+    struct Image {
+        int32_t width;
+        int32_t height;
+        std::vector<uint8_t> pixels;
+        uint64_t version;
+    };
+
+    struct Statistics {
+        size_t numGlyphs;
+        size_t numMissingGlyphs;
+        int64_t rasterizedGlyphs;
+        int32_t width;
+        int32_t height;
+        size_t sizeBytes;
+        // area of the glyphs in relation to the area of the atlas
+        double occupancy;
+    };
+
+    SdfGlyphAtlas(const std::shared_ptr<GlyphRasterizerInterface> &rasterizer, const Config &config);
+
+    // Adds the glyphs not yet in the atlas, returns false if one of them did not fit into the atlas
+    bool prepareGlyphs(const std::vector<std::string> &charCodes);
+
+    // Adds the glyph if needed, returns nullopt if the font has no glyph for the character or the atlas is full
+    std::optional<Glyph> getGlyph(const std::string &charCode);
+
+    // All glyphs added so far, with texture coordinates relative to the current size of the atlas
+    FontData createFontData();
+
+    Image getImage();
+
+    // Font data together with the image it refers to
+    std::pair<FontData, Image> createFontDataWithImage();
+
+    // Increased whenever glyphs are added to the image
+    uint64_t getVersion();
+
+    Statistics getStatistics();
+
+    // Distance field of a coverage bitmap, padded by buffer pixels on each side: 0.5 on the outline, changing by
+    // 1 / distanceRange per pixel, increasing towards the inside.
+    static std::vector<uint8_t> generateSdf(const std::vector<uint8_t> &coverage, int32_t width, int32_t height, int32_t buffer,
+                                            double distanceRange);
+
+  private:
+    struct Shelf {
+        int32_t y;
+        int32_t height;
+        int32_t x;
+    };
+
+    FontData createFontDataLocked();
+
+    // Finds a place for a rect, growing the atlas if needed
+    bool packLocked(int32_t width, int32_t height, int32_t &x, int32_t &y);
+
+    const std::shared_ptr<GlyphRasterizerInterface> rasterizer;
+    const Config config;
+
+    std::mutex mutex;
+    int32_t height;
+    std::vector<uint8_t> pixels;
+    std::vector<Shelf> shelves;
+    std::unordered_map<std::string, Glyph> glyphs;
+    // characters in the order they have been added
+    std::vector<std::string> charCodes;
+    std::unordered_set<std::string> missingGlyphs;
+    int64_t glyphArea = 0;
+    int64_t rasterizedGlyphs = 0;
+    uint64_t version = 0;
+};
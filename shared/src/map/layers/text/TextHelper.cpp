@@ -16,42 +16,23 @@
 #include "TextDescription.h"
 #include "BoundingBox.h"
 #include "SymbolInfo.h"
-#include <codecvt>
-#include <iosfwd>
-#include <locale>
+#include "Utf8Iterator.h"
+#include "PerformanceLogger.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include "Vec2DHelper.h"
 
-unsigned char *StrToUprExt(unsigned char *pString);
-#if defined(__clang__) || defined(__GNUC__)
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-#endif
-
-#if defined(__clang__) || defined(__GNUC__)
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-#endif
-
-
 std::vector<std::string> TextHelper::splitWstring(const std::string &word) {
-    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    std::wstring wword = converter.from_bytes(word);
     std::vector<std::string> characters;
-    for (auto iter : wword) {
-        try {
-            characters.push_back(converter.to_bytes(iter));
-        } // thrown by std::wstring_convert.to_bytes() for emojis
-        catch (const std::range_error & exception)
-        {}
+    for (const auto letter : Utf8Letters(word)) {
+        characters.emplace_back(letter);
     }
     return characters;
 }
 
-#if defined(__clang__) || defined(__GNUC__)
-#pragma GCC diagnostic pop
-#endif
-
 TextHelper::TextHelper(const std::shared_ptr<MapInterface> &mapInterface)
     : mapInterface(mapInterface) {}
 
@@ -95,697 +76,244 @@ std::shared_ptr<TextLayerObject> TextHelper::textLayerObject(const std::shared_p
     return textObject;
 }
 
-std::string TextHelper::uppercase(const std::string &string) {
-    std::string s = "";
-    for (int i = 0; i < string.size(); ++i) {
-        auto a = StrToUprExt((unsigned char *)&string[i]);
+// MARK: - Uppercase
 
-        if (a) {
-            s.insert(s.end(), *a);
-        }
-    }
+namespace {
+struct UppercaseRange {
+    uint32_t first;
+    uint32_t last;
+    int32_t delta;
+    // 1 for a block of lowercase letters, 2 for alternating lower- and uppercase letters starting at first
+    uint32_t step;
+};
 
-    return s;
+// Lowercase code points and the offset to their uppercase letter, sorted by first
+constexpr UppercaseRange uppercaseRanges[] = {
+    {0x0061, 0x007A, -32, 1},
+    {0x00E0, 0x00F6, -32, 1},
+    {0x00F8, 0x00FE, -32, 1},
+    {0x00FF, 0x00FF, 121, 1},
+    {0x0101, 0x0137, -1, 2},
+    {0x013A, 0x0148, -1, 2},
+    {0x014B, 0x0177, -1, 2},
+    {0x017A, 0x017E, -1, 2},
+    {0x0180, 0x0180, 195, 1},
+    {0x0183, 0x0185, -1, 2},
+    {0x0188, 0x0188, -1, 1},
+    {0x018C, 0x018C, -1, 1},
+    {0x0192, 0x0192, -1, 1},
+    {0x0195, 0x0195, 97, 1},
+    {0x0199, 0x0199, -1, 1},
+    {0x019A, 0x019A, 163, 1},
+    {0x019E, 0x019E, 130, 1},
+    {0x01A1, 0x01A5, -1, 2},
+    {0x01A8, 0x01A8, -1, 1},
+    {0x01AD, 0x01AD, -1, 1},
+    {0x01B0, 0x01B0, -1, 1},
+    {0x01B4, 0x01B6, -1, 2},
+    {0x01B9, 0x01B9, -1, 1},
+    {0x01BD, 0x01BD, -1, 1},
+    {0x01C5, 0x01C5, -1, 1},
+    {0x01C6, 0x01C6, -2, 1},
+    {0x01C8, 0x01C8, -1, 1},
+    {0x01C9, 0x01C9, -2, 1},
+    {0x01CB, 0x01CB, -1, 1},
+    {0x01CC, 0x01CC, -2, 1},
+    {0x01CE, 0x01DC, -1, 2},
+    {0x01DF, 0x01EF, -1, 2},
+    {0x01F2, 0x01F2, -1, 1},
+    {0x01F3, 0x01F3, -2, 1},
+    {0x01F5, 0x01F5, -1, 1},
+    {0x01F9, 0x021F, -1, 2},
+    {0x0223, 0x0233, -1, 2},
+    {0x023C, 0x023C, -1, 1},
+    {0x0242, 0x0242, -1, 1},
+    {0x0247, 0x024F, -1, 2},
+    {0x0253, 0x0253, -210, 1},
+    {0x0254, 0x0254, -206, 1},
+    {0x0257, 0x0257, -205, 1},
+    {0x0258, 0x0259, -202, 1},
+    {0x025B, 0x025B, -203, 1},
+    {0x0260, 0x0260, -205, 1},
+    {0x0263, 0x0263, -207, 1},
+    {0x0268, 0x0268, -209, 1},
+    {0x0269, 0x0269, -211, 1},
+    {0x026F, 0x026F, -211, 1},
+    {0x0272, 0x0272, -213, 1},
+    {0x0283, 0x0283, -218, 1},
+    {0x0288, 0x0288, -218, 1},
+    {0x0289, 0x0289, -69, 1},
+    {0x028A, 0x028B, -217, 1},
+    {0x028C, 0x028C, -71, 1},
+    {0x0292, 0x0292, -219, 1},
+    {0x0371, 0x0373, -1, 2},
+    {0x0377, 0x0377, -1, 1},
+    {0x037B, 0x037D, 130, 1},
+    {0x03AC, 0x03AC, -38, 1},
+    {0x03AD, 0x03AF, -37, 1},
+    {0x03B1, 0x03CB, -32, 1},
+    {0x03CC, 0x03CC, -64, 1},
+    {0x03CD, 0x03CE, -63, 1},
+    {0x03D1, 0x03D1, 35, 1},
+    {0x03D7, 0x03D7, -8, 1},
+    {0x03D9, 0x03EF, -1, 2},
+    {0x03F2, 0x03F2, 7, 1},
+    {0x03F3, 0x03F3, -116, 1},
+    {0x03F8, 0x03F8, -1, 1},
+    {0x03FB, 0x03FB, -1, 1},
+    {0x0430, 0x044F, -32, 1},
+    {0x0450, 0x045F, -80, 1},
+    {0x0461, 0x0481, -1, 2},
+    {0x048B, 0x04BF, -1, 2},
+    {0x04C2, 0x04CE, -1, 2},
+    {0x04CF, 0x04CF, -15, 1},
+    {0x04D1, 0x052F, -1, 2},
+    {0x0561, 0x0586, -48, 1},
+    {0x10D0, 0x10FA, 3008, 1},
+    {0x10FD, 0x10FF, 3008, 1},
+    {0x13F8, 0x13FD, -8, 1},
+    {0x1D8E, 0x1D8E, 35384, 1},
+    {0x1E01, 0x1E93, -1, 2},
+    {0x1EA1, 0x1EFF, -1, 2},
+    {0x1F00, 0x1F07, 8, 1},
+    {0x1F10, 0x1F17, 8, 1},
+    {0x1F20, 0x1F27, 8, 1},
+    {0x1F30, 0x1F37, 8, 1},
+    {0x1F40, 0x1F47, 8, 1},
+    {0x1F51, 0x1F57, 8, 2},
+    {0x1F60, 0x1F67, 8, 1},
+    {0x1F70, 0x1F71, 74, 1},
+    {0x1F72, 0x1F75, 86, 1},
+    {0x1F76, 0x1F77, 98, 1},
+    {0x1F78, 0x1F79, 128, 1},
+    {0x1F7A, 0x1F7B, 112, 1},
+    {0x1F7C, 0x1F7D, 126, 1},
+    {0x1F80, 0x1F87, 8, 1},
+    {0x1F90, 0x1F97, 8, 1},
+    {0x1FA0, 0x1FA7, 8, 1},
+    {0x1FB0, 0x1FB1, 8, 1},
+    {0x1FB3, 0x1FB3, 9, 1},
+    {0x1FC3, 0x1FC3, 9, 1},
+    {0x1FD0, 0x1FD1, 8, 1},
+    {0x1FE0, 0x1FE1, 8, 1},
+    {0x1FE5, 0x1FE5, 7, 1},
+    {0x1FF3, 0x1FF3, 9, 1},
+    {0x2C30, 0x2C5E, -48, 1},
+    {0x2C61, 0x2C61, -1, 1},
+    {0x2C68, 0x2C6C, -1, 2},
+    {0x2C73, 0x2C73, -1, 1},
+    {0x2C76, 0x2C76, -1, 1},
+    {0x2C81, 0x2CE3, -1, 2},
+    {0x2CEC, 0x2CEE, -1, 2},
+    {0x2CF3, 0x2CF3, -1, 1},
+    {0xA641, 0xA66D, -1, 2},
+    {0xA681, 0xA69B, -1, 2},
+    {0xA723, 0xA72F, -1, 2},
+    {0xA733, 0xA76F, -1, 2},
+    {0xA77A, 0xA77C, -1, 2},
+    {0xA77F, 0xA787, -1, 2},
+    {0xA78C, 0xA78C, -1, 1},
+    {0xA791, 0xA793, -1, 2},
+    {0xA794, 0xA794, 48, 1},
+    {0xA797, 0xA7A9, -1, 2},
+    {0xA7B5, 0xA7BF, -1, 2},
+    {0xA7C3, 0xA7C3, -1, 1},
+    {0xA7C8, 0xA7CA, -1, 2},
+    {0xA7F6, 0xA7F6, -1, 1},
+    {0xAB53, 0xAB53, -928, 1},
+    {0xAB70, 0xABBF, -38864, 1},
+    {0xFF41, 0xFF5A, -32, 1},
+    {0x10428, 0x1044F, -40, 1},
+    {0x104D8, 0x104FB, -40, 1},
+    {0x10CC0, 0x10CF2, -64, 1},
+    {0x118C0, 0x118DF, -32, 1},
+    {0x16E60, 0x16E7F, -32, 1},
+    {0x1E922, 0x1E943, -34, 1}
+};
+
+uint32_t uppercaseCodepoint(uint32_t codepoint) {
+    const auto it = std::upper_bound(std::begin(uppercaseRanges), std::end(uppercaseRanges), codepoint,
+                                     [](uint32_t c, const UppercaseRange &range) { return c < range.first; });
+    if (it == std::begin(uppercaseRanges)) {
+        return codepoint;
+    }
+    const auto &range = *(it - 1);
+    if (codepoint > range.last || (codepoint - range.first) % range.step != 0) {
+        return codepoint;
+    }
+    return (uint32_t)((int32_t)codepoint + range.delta);
 }
+} // namespace
 
-unsigned char *StrToUprExt(unsigned char *pString) {
-    if (pString && *pString) {
-        unsigned char *p = pString;
-        unsigned char *pExtChar = 0;
-        while (*p) {
-            if ((*p >= 0x61) && (*p <= 0x7a)) // US ASCII
-                (*p) -= 0x20;
-            else if (*p > 0xc0) {
-                pExtChar = p;
-                p++;
-                switch (*pExtChar) {
-                case 0xc3: // Latin 1
-                    // 0x9f Three byte capital 0xe1 0xba 0x9e
-                    if ((*p >= 0xa0) && (*p <= 0xbe) && (*p != 0xb7))
-                        (*p) -= 0x20; // US ASCII shift
-                    else if (*p == 0xbf) {
-                        *pExtChar = 0xc5;
-                        (*p) = 0xb8;
-                    }
-                    break;
-                case 0xc4:                                                // Latin ext
-                    if ((*p >= 0x80) && (*p <= 0xb7) && (*p % 2))         // Odd
-                        (*p)--;                                           // Prev char is upr
-                    else if ((*p >= 0xb9) && (*p <= 0xbe) && (!(*p % 2))) // Even
-                        (*p)--;                                           // Prev char is upr
-                    break;
-                case 0xc5: // Latin ext
-                    if (*p == 0x80) {
-                        *pExtChar = 0xc4;
-                        (*p) = 0xbf;
-                    } else if ((*p >= 0x81) && (*p <= 0x88) && (!(*p % 2))) // Even
-                        (*p)--;                                             // Prev char is upr
-                    else if ((*p >= 0x8a) && (*p <= 0xb7) && (*p % 2))      // Odd
-                        (*p)--;                                             // Prev char is upr
-                    else if (*p == 0xb8) {
-                        *pExtChar = 0xc5;
-                        (*p) = 0xb8;
-                    } else if ((*p >= 0xb9) && (*p <= 0xbe) && (!(*p % 2))) // Even
-                        (*p)--;                                             // Prev char is upr
-                    break;
-                case 0xc6: // Latin ext
-                    switch (*p) {
-                    case 0x83:
-                    case 0x85:
-                    case 0x88:
-                    case 0x8c:
-                    case 0x92:
-                    case 0x99:
-                    case 0xa1:
-                    case 0xa3:
-                    case 0xa5:
-                    case 0xa8:
-                    case 0xad:
-                    case 0xb0:
-                    case 0xb4:
-                    case 0xb6:
-                    case 0xb9:
-                    case 0xbd:
-                        (*p)--; // Prev char is upr
-                        break;
-                    case 0x80:
-                        *pExtChar = 0xc9;
-                        (*p) = 0x83;
-                        break;
-                    case 0x95:
-                        *pExtChar = 0xc7;
-                        (*p) = 0xb6;
-                        break;
-                    case 0x9a:
-                        *pExtChar = 0xc8;
-                        (*p) = 0xbd;
-                        break;
-                    case 0x9e:
-                        *pExtChar = 0xc8;
-                        (*p) = 0xa0;
-                        break;
-                    default:
-                        break;
-                    }
-                    break;
-                case 0xc7: // Latin ext
-                    if (*p == 0x85)
-                        (*p)--; // Prev char is upr
-                    else if (*p == 0x86)
-                        (*p) = 0x84;
-                    else if (*p == 0x88)
-                        (*p)--; // Prev char is upr
-                    else if (*p == 0x89)
-                        (*p) = 0x87;
-                    else if (*p == 0x8b)
-                        (*p)--; // Prev char is upr
-                    else if (*p == 0x8c)
-                        (*p) = 0x8a;
-                    else if ((*p >= 0x8d) && (*p <= 0x9c) && (!(*p % 2))) // Even
-                        (*p)--;                                           // Prev char is upr
-                    else if ((*p >= 0x9e) && (*p <= 0xaf) && (*p % 2))    // Odd
-                        (*p)--;                                           // Prev char is upr
-                    else if (*p == 0xb2)
-                        (*p)--; // Prev char is upr
-                    else if (*p == 0xb3)
-                        (*p) = 0xb1;
-                    else if (*p == 0xb5)
-                        (*p)--;                                        // Prev char is upr
-                    else if ((*p >= 0xb9) && (*p <= 0xbf) && (*p % 2)) // Odd
-                        (*p)--;                                        // Prev char is upr
-                    break;
-                case 0xc8:                                             // Latin ext
-                    if ((*p >= 0x80) && (*p <= 0x9f) && (*p % 2))      // Odd
-                        (*p)--;                                        // Prev char is upr
-                    else if ((*p >= 0xa2) && (*p <= 0xb3) && (*p % 2)) // Odd
-                        (*p)--;                                        // Prev char is upr
-                    else if (*p == 0xbc)
-                        (*p)--; // Prev char is upr
-                    // 0xbf Three byte capital 0xe2 0xb1 0xbe
-                    break;
-                case 0xc9: // Latin ext
-                    switch (*p) {
-                    case 0x80: // Three byte capital 0xe2 0xb1 0xbf
-                    case 0x90: // Three byte capital 0xe2 0xb1 0xaf
-                    case 0x91: // Three byte capital 0xe2 0xb1 0xad
-                    case 0x92: // Three byte capital 0xe2 0xb1 0xb0
-                    case 0x9c: // Three byte capital 0xea 0x9e 0xab
-                    case 0xa1: // Three byte capital 0xea 0x9e 0xac
-                    case 0xa5: // Three byte capital 0xea 0x9e 0x8d
-                    case 0xa6: // Three byte capital 0xea 0x9e 0xaa
-                    case 0xab: // Three byte capital 0xe2 0xb1 0xa2
-                    case 0xac: // Three byte capital 0xea 0x9e 0xad
-                    case 0xb1: // Three byte capital 0xe2 0xb1 0xae
-                    case 0xbd: // Three byte capital 0xe2 0xb1 0xa4
-                        break;
-                    case 0x82:
-                        (*p)--; // Prev char is upr
-                        break;
-                    case 0x93:
-                        *pExtChar = 0xc6;
-                        (*p) = 0x81;
-                        break;
-                    case 0x94:
-                        *pExtChar = 0xc6;
-                        (*p) = 0x86;
-                        break;
-                    case 0x97:
-                        *pExtChar = 0xc6;
-                        (*p) = 0x8a;
-                        break;
-                    case 0x98:
-                        *pExtChar = 0xc6;
-                        (*p) = 0x8e;
-                        break;
-                    case 0x99:
-                        *pExtChar = 0xc6;
-                        (*p) = 0x8f;
-                        break;
-                    case 0x9b:
-                        *pExtChar = 0xc6;
-                        (*p) = 0x90;
-                        break;
-                    case 0xa0:
-                        *pExtChar = 0xc6;
-                        (*p) = 0x93;
-                        break;
-                    case 0xa3:
-                        *pExtChar = 0xc6;
-                        (*p) = 0x94;
-                        break;
-                    case 0xa8:
-                        *pExtChar = 0xc6;
-                        (*p) = 0x97;
-                        break;
-                    case 0xa9:
-                        *pExtChar = 0xc6;
-                        (*p) = 0x96;
-                        break;
-                    case 0xaf:
-                        *pExtChar = 0xc6;
-                        (*p) = 0x9c;
-                        break;
-                    case 0xb2:
-                        *pExtChar = 0xc6;
-                        (*p) = 0x9d;
-                        break;
-                    default:
-                        if ((*p >= 0x87) && (*p <= 0x8f) && (*p % 2)) // Odd
-                            (*p)--;                                   // Prev char is upr
-                        break;
-                    }
-                    break;
-
-                case 0xca: // Latin ext
-                    switch (*p) {
-                    case 0x82: // Three byte capital 0xea 0x9f 0x85
-                    case 0x87: // Three byte capital 0xea 0x9e 0xb1
-                    case 0x9d: // Three byte capital 0xea 0x9e 0xb2
-                    case 0x9e: // Three byte capital 0xea 0x9e 0xb0
-                        break;
-                    case 0x83:
-                        *pExtChar = 0xc6;
-                        (*p) = 0xa9;
-                        break;
-                    case 0x88:
-                        *pExtChar = 0xc6;
-                        (*p) = 0xae;
-                        break;
-                    case 0x89:
-                        *pExtChar = 0xc9;
-                        (*p) = 0x84;
-                        break;
-                    case 0x8a:
-                        *pExtChar = 0xc6;
-                        (*p) = 0xb1;
-                        break;
-                    case 0x8b:
-                        *pExtChar = 0xc6;
-                        (*p) = 0xb2;
-                        break;
-                    case 0x8c:
-                        *pExtChar = 0xc9;
-                        (*p) = 0x85;
-                        break;
-                    case 0x92:
-                        *pExtChar = 0xc6;
-                        (*p) = 0xb7;
-                        break;
-                    default:
-                        break;
-                    }
-                    break;
-                case 0xcd: // Greek & Coptic
-                    switch (*p) {
-                    case 0xb1:
-                    case 0xb3:
-                    case 0xb7:
-                        (*p)--; // Prev char is upr
-                        break;
-                    case 0xbb:
-                        *pExtChar = 0xcf;
-                        (*p) = 0xbd;
-                        break;
-                    case 0xbc:
-                        *pExtChar = 0xcf;
-                        (*p) = 0xbe;
-                        break;
-                    case 0xbd:
-                        *pExtChar = 0xcf;
-                        (*p) = 0xbf;
-                        break;
-                    default:
-                        break;
-                    }
-                    break;
-                case 0xce: // Greek & Coptic
-                    if (*p == 0xac)
-                        (*p) = 0x86;
-                    else if (*p == 0xad)
-                        (*p) = 0x88;
-                    else if (*p == 0xae)
-                        (*p) = 0x89;
-                    else if (*p == 0xaf)
-                        (*p) = 0x8a;
-                    else if ((*p >= 0xb1) && (*p <= 0xbf))
-                        (*p) -= 0x20; // US ASCII shift
-                    break;
-                case 0xcf: // Greek & Coptic
-                    if ((*p >= 0x80) && (*p <= 0x8b)) {
-                        *pExtChar = 0xce;
-                        (*p) += 0x20;
-                    } else if (*p == 0x8c) {
-                        *pExtChar = 0xce;
-                        (*p) = 0x8c;
-                    } else if (*p == 0x8d) {
-                        *pExtChar = 0xce;
-                        (*p) = 0x8e;
-                    } else if (*p == 0x8e) {
-                        *pExtChar = 0xce;
-                        (*p) = 0x8f;
-                    } else if (*p == 0x91)
-                        (*p) = 0xb4;
-                    else if (*p == 0x97)
-                        (*p) = 0x8f;
-                    else if ((*p >= 0x98) && (*p <= 0xaf) && (*p % 2)) // Odd
-                        (*p)--;                                        // Prev char is upr
-                    else if (*p == 0xb2)
-                        (*p) = 0xb9;
-                    else if (*p == 0xb3) {
-                        *pExtChar = 0xcd;
-                        (*p) = 0xbf;
-                    } else if (*p == 0xb8)
-                        (*p)--; // Prev char is upr
-                    else if (*p == 0xbb)
-                        (*p)--; // Prev char is upr
-                    break;
-                case 0xd0: // Cyrillic
-                    if ((*p >= 0xb0) && (*p <= 0xbf))
-                        (*p) -= 0x20; // US ASCII shift
-                    break;
-                case 0xd1: // Cyrillic supplement
-                    if ((*p >= 0x80) && (*p <= 0x8f)) {
-                        *pExtChar = 0xd0;
-                        (*p) += 0x20;
-                    } else if ((*p >= 0x90) && (*p <= 0x9f)) {
-                        *pExtChar = 0xd0;
-                        (*p) -= 0x10;
-                    } else if ((*p >= 0xa0) && (*p <= 0xbf) && (*p % 2)) // Odd
-                        (*p)--;                                          // Prev char is upr
-                    break;
-                case 0xd2: // Cyrillic supplement
-                    if (*p == 0x81)
-                        (*p)--;                                        // Prev char is upr
-                    else if ((*p >= 0x8a) && (*p <= 0xbf) && (*p % 2)) // Odd
-                        (*p)--;                                        // Prev char is upr
-                    break;
-                case 0xd3:                                           // Cyrillic supplement
-                    if ((*p >= 0x81) && (*p <= 0x8e) && (!(*p % 2))) // Even
-                        (*p)--;                                      // Prev char is upr
-                    else if (*p == 0x8f)
-                        (*p) = 0x80;
-                    else if ((*p >= 0x90) && (*p <= 0xbf) && (*p % 2)) // Odd
-                        (*p)--;                                        // Prev char is upr
-                    break;
-                case 0xd4:                                        // Cyrillic supplement & Armenian
-                    if ((*p >= 0x80) && (*p <= 0xaf) && (*p % 2)) // Odd
-                        (*p)--;                                   // Prev char is upr
-                    break;
-                case 0xd5: // Armenian
-                    if ((*p >= 0xa1) && (*p <= 0xaf)) {
-                        *pExtChar = 0xd4;
-                        (*p) += 0x10;
-                    } else if ((*p >= 0xb0) && (*p <= 0xbf)) {
-                        (*p) -= 0x30;
-                    }
-                    break;
-                case 0xd6: // Armenian
-                    if ((*p >= 0x80) && (*p <= 0x86)) {
-                        *pExtChar = 0xd5;
-                        (*p) += 0x10;
-                    }
-                    break;
-                case 0xe1: // Three byte code
-                    pExtChar = p;
-                    p++;
-                    switch (*pExtChar) {
-                    case 0x82: // Georgian mkhedruli
-                        break;
-                    case 0x83: // Georgian mkhedruli
-                        if (((*p >= 0x90) && (*p <= 0xba)) || (*p == 0xbd) || (*p == 0xbe) || (*p == 0xbf)) {
-                            *pExtChar = 0xb2;
-                        }
-                        break;
-                    case 0x8f: // Cherokee
-                        if ((*p >= 0xb8) && (*p <= 0xbd)) {
-                            (*p) -= 0x08;
-                        }
-                        break;
-                    case 0xb6: // Latin ext
-                        if (*p == 0x8e) {
-                            *(p - 2) = 0xea;
-                            *(p - 1) = 0x9f;
-                            (*p) = 0x86;
-                        }
-                        break;
-                    case 0xb8:                                        // Latin ext
-                        if ((*p >= 0x80) && (*p <= 0xbf) && (*p % 2)) // Odd
-                            (*p)--;                                   // Prev char is upr
-                        break;
-                    case 0xb9:                                        // Latin ext
-                        if ((*p >= 0x80) && (*p <= 0xbf) && (*p % 2)) // Odd
-                            (*p)--;                                   // Prev char is upr
-                        break;
-                    case 0xba:                                             // Latin ext
-                        if ((*p >= 0x80) && (*p <= 0x93) && (*p % 2))      // Odd
-                            (*p)--;                                        // Prev char is upr
-                        else if ((*p >= 0xa0) && (*p <= 0xbf) && (*p % 2)) // Odd
-                            (*p)--;                                        // Prev char is upr
-                        break;
-                    case 0xbb:                                        // Latin ext
-                        if ((*p >= 0x80) && (*p <= 0xbf) && (*p % 2)) // Odd
-                            (*p)--;                                   // Prev char is upr
-                        break;
-                    case 0xbc: // Greek ext
-                        if ((*p >= 0x80) && (*p <= 0x87))
-                            (*p) += 0x08;
-                        else if ((*p >= 0x90) && (*p <= 0x97))
-                            (*p) += 0x08;
-                        else if ((*p >= 0xa0) && (*p <= 0xa7))
-                            (*p) += 0x08;
-                        else if ((*p >= 0xb0) && (*p <= 0xb7))
-                            (*p) += 0x08;
-                        break;
-                    case 0xbd: // Greek ext
-                        if ((*p >= 0x80) && (*p <= 0x87))
-                            (*p) += 0x08;
-                        else if (((*p >= 0x90) && (*p <= 0x97)) && (*p % 2)) // Odd
-                            (*p) += 0x08;
-                        else if ((*p >= 0xa0) && (*p <= 0xa7))
-                            (*p) += 0x08;
-                        else if ((*p >= 0xb0) && (*p <= 0xb1)) {
-                            *(p - 1) = 0xbe;
-                            (*p) += 0x0a;
-                        } else if ((*p >= 0xb2) && (*p <= 0xb5)) {
-                            *(p - 1) = 0xbf;
-                            (*p) -= 0x2a;
-                        } else if ((*p >= 0xb6) && (*p <= 0xb7)) {
-                            *(p - 1) = 0xbf;
-                            (*p) -= 0x1e;
-                        } else if ((*p >= 0xb8) && (*p <= 0xb9)) {
-                            *(p - 1) = 0xbf;
-                        } else if ((*p >= 0xba) && (*p <= 0xbb)) {
-                            *(p - 1) = 0xbf;
-                            (*p) -= 0x10;
-                        } else if ((*p >= 0xbc) && (*p <= 0xbd)) {
-                            *(p - 1) = 0xbf;
-                            (*p) -= 0x02;
-                        }
-                        break;
-                    case 0xbe: // Greek ext
-                        if ((*p >= 0x80) && (*p <= 0x87))
-                            (*p) += 0x08;
-                        else if ((*p >= 0x90) && (*p <= 0x97))
-                            (*p) += 0x08;
-                        else if ((*p >= 0xa0) && (*p <= 0xa7))
-                            (*p) += 0x08;
-                        else if ((*p >= 0xb0) && (*p <= 0xb1))
-                            (*p) += 0x08;
-                        else if (*p == 0xb3)
-                            (*p) += 0x09;
-                        break;
-                    case 0xbf: // Greek ext
-                        if (*p == 0x83)
-                            (*p) += 0x09;
-                        else if ((*p >= 0x90) && (*p <= 0x91))
-                            *p += 0x08;
-                        else if ((*p >= 0xa0) && (*p <= 0xa1))
-                            (*p) += 0x08;
-                        else if (*p == 0xa5)
-                            (*p) += 0x07;
-                        else if (*p == 0xb3)
-                            (*p) += 0x09;
-                        break;
-                    default:
-                        break;
-                    }
-                    break;
-                case 0xe2: // Three byte code
-                    pExtChar = p;
-                    p++;
-                    switch (*pExtChar) {
-                    case 0xb0: // Glagolitic
-                        if ((*p >= 0xb0) && (*p <= 0xbf)) {
-                            (*p) -= 0x30;
-                        }
-                        break;
-                    case 0xb1: // Glagolitic
-                        if ((*p >= 0x80) && (*p <= 0x9e)) {
-                            *pExtChar = 0xb0;
-                            (*p) += 0x10;
-                        } else { // Latin ext
-                            switch (*p) {
-                            case 0xa1:
-                            case 0xa8:
-                            case 0xaa:
-                            case 0xac:
-                            case 0xb3:
-                            case 0xb6:
-                                (*p)--; // Prev char is upr
-                                break;
-                            case 0xa5: // Two byte capital  0xc8 0xba
-                            case 0xa6: // Two byte capital  0xc8 0xbe
-                                break;
-                            default:
-                                break;
-                            }
-                        }
-                        break;
-                    case 0xb2:                                        // Coptic
-                        if ((*p >= 0x80) && (*p <= 0xbf) && (*p % 2)) // Odd
-                            (*p)--;                                   // Prev char is upr
-                        break;
-                    case 0xb3:                                         // Coptic
-                        if (((*p >= 0x80) && (*p <= 0xa3) && (*p % 2)) // Odd
-                            || (*p == 0xac) || (*p == 0xae) || (*p == 0xb3))
-                            (*p)--; // Prev char is upr
-                        break;
-                    default:
-                        break;
-                    }
-                    break;
-                case 0xea: // Three byte code
-                    pExtChar = p;
-                    p++;
-                    switch (*pExtChar) {
-                    case 0x99:                                        // Cyrillic
-                        if ((*p >= 0x80) && (*p <= 0xad) && (*p % 2)) // Odd
-                            (*p)--;                                   // Prev char is upr
-                        break;
-                    case 0x9a:                                        // Cyrillic
-                        if ((*p >= 0x80) && (*p <= 0x9b) && (*p % 2)) // Odd
-                            (*p)--;                                   // Prev char is upr
-                        break;
-                    case 0x9c:                                                                              // Latin ext
-                        if ((((*p >= 0xa2) && (*p <= 0xaf)) || ((*p >= 0xb2) && (*p <= 0xbf))) && (*p % 2)) // Odd
-                            (*p)--;                                                                         // Prev char is upr
-                        break;
-                    case 0x9d:                                         // Latin ext
-                        if (((*p >= 0x80) && (*p <= 0xaf) && (*p % 2)) // Odd
-                            || (*p == 0xba) || (*p == 0xbc) || (*p == 0xbf))
-                            (*p)--; // Prev char is upr
-                        break;
-                    case 0x9e: // Latin ext
-                        if (((((*p >= 0x80) && (*p <= 0x87)) || ((*p >= 0x96) && (*p <= 0xa9)) || ((*p >= 0xb4) && (*p <= 0xbf))) &&
-                             (*p % 2)) // Odd
-                            || (*p == 0x8c) || (*p == 0x91) || (*p == 0x93))
-                            (*p)--; // Prev char is upr
-                        else if (*p == 0x94) {
-                            *(p - 2) = 0xea;
-                            *(p - 1) = 0x9f;
-                            *(p) = 0x84;
-                        }
-                        break;
-                    case 0x9f: // Latin ext
-                        if ((*p == 0x83) || (*p == 0x88) || (*p == 0x8a) || (*p == 0xb6))
-                            (*p)--; // Prev char is upr
-                        break;
-                    case 0xad:
-                        // Latin ext
-                        if (*p == 0x93) {
-                            *pExtChar = 0x9e;
-                            (*p) = 0xb3;
-                        }
-                        // Cherokee
-                        else if ((*p >= 0xb0) && (*p <= 0xbf)) {
-                            *(p - 2) = 0xe1;
-                            *pExtChar = 0x8e;
-                            (*p) -= 0x10;
-                        }
-                        break;
-                    case 0xae: // Cherokee
-                        if ((*p >= 0x80) && (*p <= 0x8f)) {
-                            *(p - 2) = 0xe1;
-                            *pExtChar = 0x8e;
-                            (*p) += 0x30;
-                        } else if ((*p >= 0x90) && (*p <= 0xbf)) {
-                            *(p - 2) = 0xe1;
-                            *pExtChar = 0x8f;
-                            (*p) -= 0x10;
-                        }
-                        break;
-                    default:
-                        break;
-                    }
-                    break;
-                case 0xef: // Three byte code
-                    pExtChar = p;
-                    p++;
-                    switch (*pExtChar) {
-                    case 0xbd: // Latin fullwidth
-                        if ((*p >= 0x81) && (*p <= 0x9a)) {
-                            *pExtChar = 0xbc;
-                            (*p) += 0x20;
-                        }
-                        break;
-                    default:
-                        break;
-                    }
-                    break;
-                case 0xf0: // Four byte code
-                    pExtChar = p;
-                    p++;
-                    switch (*pExtChar) {
-                    case 0x90:
-                        pExtChar = p;
-                        p++;
-                        switch (*pExtChar) {
-                        case 0x90: // Deseret
-                            if ((*p >= 0xa8) && (*p <= 0xbf)) {
-                                (*p) -= 0x28;
-                            }
-                            break;
-                        case 0x91: // Deseret
-                            if ((*p >= 0x80) && (*p <= 0x8f)) {
-                                *pExtChar = 0x90;
-                                (*p) += 0x18;
-                            }
-                            break;
-                        case 0x93: // Osage
-                            if ((*p >= 0x98) && (*p <= 0xa7)) {
-                                *pExtChar = 0x92;
-                                (*p) += 0x18;
-                            } else if ((*p >= 0xa8) && (*p <= 0xbb))
-                                (*p) -= 0x28;
-                            break;
-                        case 0xb3: // Old hungarian
-                            if ((*p >= 0x80) && (*p <= 0xb2))
-                                *pExtChar = 0xb2;
-                            break;
-                        default:
-                            break;
-                        }
-                        break;
-                    case 0x91:
-                        pExtChar = p;
-                        p++;
-                        switch (*pExtChar) {
-                        case 0xa3: // Warang citi
-                            if ((*p >= 0x80) && (*p <= 0x9f)) {
-                                *pExtChar = 0xa2;
-                                (*p) += 0x20;
-                            }
-                            break;
-                        default:
-                            break;
-                        }
-                        break;
-                    case 0x96:
-                        pExtChar = p;
-                        p++;
-                        switch (*pExtChar) {
-                        case 0xb9: // Medefaidrin
-                            if ((*p >= 0xa0) && (*p <= 0xbf))
-                                (*p) -= 0x20;
-                            break;
-                        default:
-                            break;
-                        }
-                        break;
-                    case 0x9E:
-                        pExtChar = p;
-                        p++;
-                        switch (*pExtChar) {
-                        case 0xA4: // Adlam
-                            if ((*p >= 0xa2) && (*p <= 0xbf))
-                                (*p) -= 0x22;
-                            break;
-                        case 0xA5: // Adlam
-                            if ((*p >= 0x80) && (*p <= 0x83)) {
-                                *(pExtChar) = 0xa4;
-                                (*p) += 0x1e;
-                            }
-                            break;
-                        default:
-                            break;
-                        }
-                        break;
-                    }
-                    break;
-                default:
-                    break;
-                }
-                pExtChar = 0;
+std::string TextHelper::uppercase(const std::string &string) {
+    std::string result;
+    result.reserve(string.size());
+
+    constexpr uint64_t highBits = 0x8080808080808080ULL;
+    size_t i = 0;
+    while (i < string.size()) {
+        // ASCII fast path, eight letters at once
+        if (i + 8 <= string.size()) {
+            uint64_t block;
+            std::memcpy(&block, string.data() + i, 8);
+            if ((block & highBits) == 0) {
+                // the high bit of a byte is set by the additions if it is >= 'a' resp. > 'z'
+                const uint64_t isLower = (block + 0x1F1F1F1F1F1F1F1FULL) & ~(block + 0x0505050505050505ULL) & highBits;
+                block -= isLower >> 2;
+                result.append((const char *)&block, 8);
+                i += 8;
+                continue;
             }
-            p++;
         }
+
+        const auto c = (uint8_t)string[i];
+        if (c < 0x80) {
+            result.push_back((c >= 'a' && c <= 'z') ? (char)(c - 0x20) : (char)c);
+            ++i;
+            continue;
+        }
+
+        uint32_t codepoint;
+        const size_t length = Utf8Iterator::decode(std::string_view(string).substr(i), codepoint);
+        if (length == 0) {
+            // keep invalid bytes as they are
+            result.push_back((char)c);
+            ++i;
+            continue;
+        }
+        Utf8Iterator::append(result, uppercaseCodepoint(codepoint));
+        i += length;
     }
-    return pString;
+
+    return result;
 }
 
 // MARK: - Line Breaks
 
-bool isSpecialCharacter(const std::string &c) {
+bool isSpecialCharacter(std::string_view c) {
     return c == "-" || c == "/";
 }
 
-bool isLineBreak(const std::string &c) {
+bool isLineBreak(std::string_view c) {
     return c == "\n";
 }
 
-bool allowsLineBreak(const std::string &c) {
+bool allowsLineBreak(std::string_view c) {
     return isSpecialCharacter(c) || isLineBreak(c) || c == " ";
 }
 
-class Break {
-  public:
-    Break(int index, const std::shared_ptr<Break>& prior, float cost)
-    : index(index), prior(prior), cost(cost)
-    {}
-
-    int index;
-    std::shared_ptr<Break> prior;
-    float cost;
+// Potential line breaks of a text as parallel arrays, the prior is the index of the previous break or -1 for the
+// start of the text
+struct BreakCandidates {
+    std::vector<int> indices;
+    std::vector<int> priors;
+    std::vector<float> costs;
+
+    void clear() {
+        indices.clear();
+        priors.clear();
+        costs.clear();
+    }
 };
 
 float calculateCost(float lineWidth, float targetWidth, float additionalCost, bool isLast) {
@@ -802,97 +330,110 @@ float calculateCost(float lineWidth, float targetWidth, float additionalCost, bo
     return cost + additionalCost * additionalCost;
 }
 
-std::shared_ptr<Break> evaluate(int nextIndex, float targetWidth, const std::vector<std::shared_ptr<Break>> &potentials, int additionalCost, bool isLast) {
+void evaluate(int nextIndex, float targetWidth, BreakCandidates &candidates, int additionalCost, bool isLast) {
 
-    std::shared_ptr<Break> bestPrior = nullptr;
+    int bestPrior = -1;
     float bestCost = calculateCost(nextIndex, targetWidth, additionalCost, isLast);
 
-    for (const auto& potential : potentials) {
-        float lineWidth = nextIndex - potential->index;
-        float cost = calculateCost(lineWidth, targetWidth, additionalCost, isLast) + potential->cost;
+    for (int i = 0; i < candidates.indices.size(); ++i) {
+        float lineWidth = nextIndex - candidates.indices[i];
+        float cost = calculateCost(lineWidth, targetWidth, additionalCost, isLast) + candidates.costs[i];
         if(cost <= bestCost) {
-            bestPrior = potential;
+            bestPrior = i;
             bestCost = cost;
         }
     }
 
-    return std::make_shared<Break>(nextIndex, bestPrior, bestCost);
+    candidates.indices.push_back(nextIndex);
+    candidates.priors.push_back(bestPrior);
+    candidates.costs.push_back(bestCost);
 }
 
-std::vector<BreakResult> TextHelper::bestBreakIndices(std::vector<std::string> &letters, int64_t maxCharacterWidth) {
+namespace {
+// The same label texts are broken for many tiles, the results are kept until the cache is full
+constexpr size_t maxBreakCacheEntries = 4096;
+std::mutex breakCacheMutex;
+std::unordered_map<std::string, std::vector<BreakResult>> breakCache;
+} // namespace
 
-    std::vector<std::vector<std::string>> strings = {};
-    std::vector<std::string> current = {};
+std::vector<BreakResult> TextHelper::bestBreakIndices(const std::vector<std::string_view> &letters, int64_t maxCharacterWidth) {
+    // most labels fit on one line
+    if ((int64_t)letters.size() < maxCharacterWidth && std::none_of(letters.begin(), letters.end(), isLineBreak)) {
+        return {};
+    }
 
-    for(auto& l : letters) {
-        if(isLineBreak(l)) {
-            strings.push_back(current);
-            strings.push_back({ l });
-            current.clear();
-        } else {
-            current.push_back(l);
-        }
+    thread_local std::string key;
+    key.clear();
+    key.append((const char *)&maxCharacterWidth, sizeof(maxCharacterWidth));
+    for (const auto &l : letters) {
+        key.push_back((char)l.size());
+        key.append(l);
     }
 
-    if(current.size() >  0) {
-        strings.push_back(current);
+    {
+        std::lock_guard<std::mutex> lock(breakCacheMutex);
+        auto it = breakCache.find(key);
+        if (it != breakCache.end()) {
+            PERF_LOG_COUNT("TextHelper_breakCacheHits", 1);
+            return it->second;
+        }
     }
+    PERF_LOG_COUNT("TextHelper_breakCacheMisses", 1);
 
     std::vector<BreakResult> result = {};
-    int currentIndex = 0;
+    size_t begin = 0;
 
-    for(auto& s : strings) {
-        if(s.size() == 1 && isLineBreak(s[0])) {
-            result.push_back(BreakResult(currentIndex, true));
-        } else {
-            auto breaks = bestBreakIndicesSub(s, maxCharacterWidth);
-
-            for(auto& b : breaks) {
-                b.index += currentIndex;
-                result.push_back(b);
-            }
+    for (size_t i = 0; i < letters.size(); ++i) {
+        if (isLineBreak(letters[i])) {
+            bestBreakIndicesSub(letters, begin, i, maxCharacterWidth, result);
+            result.push_back(BreakResult((int)i, true));
+            begin = i + 1;
         }
-        currentIndex += s.size();
     }
+    bestBreakIndicesSub(letters, begin, letters.size(), maxCharacterWidth, result);
 
+    std::lock_guard<std::mutex> lock(breakCacheMutex);
+    if (breakCache.size() >= maxBreakCacheEntries) {
+        breakCache.clear();
+    }
+    breakCache.emplace(key, result);
     return result;
 }
 
 
-std::vector<BreakResult> TextHelper::bestBreakIndicesSub(std::vector<std::string> &letters, int64_t maxCharacterWidth) {
-    if(letters.size() == 0 || letters.size() < maxCharacterWidth) {
-        return {};
+void TextHelper::bestBreakIndicesSub(const std::vector<std::string_view> &letters, size_t begin, size_t end, int64_t maxCharacterWidth,
+                                     std::vector<BreakResult> &result) {
+    const size_t count = end - begin;
+    if(count == 0 || count < maxCharacterWidth) {
+        return;
     }
 
-    float targetBreakCount = std::ceil(letters.size() / (float)maxCharacterWidth);
-    float targetWidth = (float)letters.size() / targetBreakCount;
+    float targetBreakCount = std::ceil(count / (float)maxCharacterWidth);
+    float targetWidth = (float)count / targetBreakCount;
 
-    std::vector<std::shared_ptr<Break>> potentials;
+    thread_local BreakCandidates candidates;
+    candidates.clear();
 
-    for(int i=0; i<letters.size(); ++i) {
-        const auto &l = letters[i];
+    for(int i=0; i<count; ++i) {
+        const auto &l = letters[begin + i];
 
-        if(i < letters.size() - 1 && allowsLineBreak(l)) {
-            float additionalCost = 0;
+        if(i < count - 1 && allowsLineBreak(l)) {
+            int additionalCost = 0;
 
             if (isSpecialCharacter(l)) {
                 additionalCost = 100;
             }
 
-            auto b = evaluate(i+1, targetWidth, potentials, additionalCost, false);
-            potentials.push_back(b);
+            evaluate(i+1, targetWidth, candidates, additionalCost, false);
         }
     }
 
-    auto last = evaluate((int)letters.size(), targetWidth, potentials, 0, true);
+    evaluate((int)count, targetWidth, candidates, 0, true);
 
-    std::vector<BreakResult> leastBads;
-    auto prior = last->prior;
-    while (prior) {
-        auto b = BreakResult(prior->index - 1, isSpecialCharacter(letters[prior->index]));
-        leastBads.push_back(b);
-        prior = prior->prior;
+    auto prior = candidates.priors.back();
+    while (prior >= 0) {
+        const int index = candidates.indices[prior];
+        result.push_back(BreakResult((int)begin + index - 1, isSpecialCharacter(letters[begin + index])));
+        prior = candidates.priors[prior];
     }
-
-    return leastBads;
 }
@@ -18,6 +18,7 @@
 #include "TextJustify.h"
 #include "TextDescription.h"
 #include "TextSymbolPlacement.h"
+#include "Utf8Iterator.h"
 #include "Vec2DHelper.h"
 #include "Logger.h"
 
@@ -54,10 +55,10 @@ TextLayerObject::TextLayerObject(const std::shared_ptr<TextInterface> &text, con
 
     std::vector<BreakResult> breaks = {};
     if(textInfo->getSymbolPlacement() == TextSymbolPlacement::POINT) {
-        std::vector<std::string> letters;
+        std::vector<std::string_view> letters;
 
         for (const auto &entry: textInfo->getText()) {
-            for (const auto &c : TextHelper::splitWstring(entry.text)) {
+            for (const auto c : Utf8Letters(entry.text)) {
                 letters.push_back(c);
             }
         }
@@ -67,7 +68,7 @@ TextLayerObject::TextLayerObject(const std::shared_ptr<TextInterface> &text, con
 
     int currentLetterIndex = 0;
     for (const auto &entry: textInfo->getText()) {
-        for (const auto &c : TextHelper::splitWstring(entry.text)) {
+        for (const auto c : Utf8Letters(entry.text)) {
             int index = -1;
             bool found = false;
 
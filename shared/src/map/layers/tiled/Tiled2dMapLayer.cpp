@@ -9,8 +9,11 @@
  */
 
 #include "Tiled2dMapLayer.h"
+#include "MapCamera2d.h"
+#include "MapCamera3d.h"
 #include "MapCameraInterface.h"
 #include "CoordinateSystemIdentifiers.h"
+#include "LayerReadyStateObserverInterface.h"
 
 Tiled2dMapLayer::Tiled2dMapLayer()
     : curT(0) {}
@@ -29,8 +32,30 @@ void Tiled2dMapLayer::setSourceInterfaces(const std::vector<WeakActor<Tiled2dMap
     }
 }
 
+void Tiled2dMapLayer::setPrefetchSourceInterfaces(const std::vector<WeakActor<Tiled2dMapSourcePrefetchInterface>> &prefetchSourceInterfaces) {
+    std::lock_guard<std::recursive_mutex> lock(sourcesMutex);
+    this->prefetchSourceInterfaces = prefetchSourceInterfaces;
+    for (const auto &sourceInterface : prefetchSourceInterfaces) {
+        sourceInterface.message(MFN(&Tiled2dMapSourcePrefetchInterface::setPrefetchEnabled), prefetchEnabled);
+    }
+}
+
+void Tiled2dMapLayer::setCameraStateSourceInterfaces(const std::vector<WeakActor<MapCameraStateListenerInterface>> &cameraStateSourceInterfaces) {
+    std::lock_guard<std::recursive_mutex> lock(sourcesMutex);
+    this->cameraStateSourceInterfaces = cameraStateSourceInterfaces;
+}
+
+void Tiled2dMapLayer::setPrefetchEnabled(bool enabled) {
+    std::lock_guard<std::recursive_mutex> lock(sourcesMutex);
+    prefetchEnabled = enabled;
+    for (const auto &sourceInterface : prefetchSourceInterfaces) {
+        sourceInterface.message(MFN(&Tiled2dMapSourcePrefetchInterface::setPrefetchEnabled), enabled);
+    }
+}
+
 void Tiled2dMapLayer::onAdded(const std::shared_ptr<::MapInterface> &mapInterface, int32_t layerIndex) {
     this->mapInterface = mapInterface;
+    this->readyStateObserver = std::dynamic_pointer_cast<LayerReadyStateObserverInterface>(mapInterface);
 
     {
         std::lock_guard<std::recursive_mutex> lock(sourcesMutex);
@@ -55,6 +80,22 @@ void Tiled2dMapLayer::onRemoved() {
         }
     }
     mapInterface = nullptr;
+    readyStateObserver.reset();
+}
+
+void Tiled2dMapLayer::notifyReadyStateObserver() {
+    if (auto observer = readyStateObserver.lock()) {
+        observer->onLayerReadyStateChanged();
+    }
+}
+
+void Tiled2dMapLayer::observeReadyState(const std::shared_ptr<Mailbox> &mailbox) {
+    auto weakSelf = weak_from_this();
+    mailbox->setEmptyListener([weakSelf] {
+        if (auto self = weakSelf.lock()) {
+            self->notifyReadyStateObserver();
+        }
+    });
 }
 
 void Tiled2dMapLayer::pause() {
@@ -111,6 +152,34 @@ void Tiled2dMapLayer::onVisibleBoundsChanged(const ::RectCoord &visibleBounds, d
         sourceInterface.message(MailboxDuplicationStrategy::replaceNewest, MFN(&Tiled2dMapSourceInterface::onVisibleBoundsChanged),
                                 visibleBounds, curT, zoom);
     }
+
+    updatePrefetchBounds(zoom);
+}
+
+void Tiled2dMapLayer::updatePrefetchBounds(double zoom) {
+    auto mapInterface = this->mapInterface;
+    if (!prefetchEnabled || prefetchSourceInterfaces.empty() || !mapInterface) {
+        return;
+    }
+
+    std::optional<std::tuple<RectCoord, double>> prediction;
+    auto camera = mapInterface->getCamera();
+    if (auto camera2d = std::dynamic_pointer_cast<MapCamera2d>(camera)) {
+        prediction = camera2d->getPredictedVisibleRect();
+    } else if (auto camera3d = std::dynamic_pointer_cast<MapCamera3d>(camera)) {
+        prediction = camera3d->getPredictedVisibleRect();
+    }
+
+    std::optional<RectCoord> predictedBounds;
+    double predictedZoom = zoom;
+    if (prediction) {
+        predictedBounds = std::get<0>(*prediction);
+        predictedZoom = std::get<1>(*prediction);
+    }
+    for (const auto &sourceInterface : prefetchSourceInterfaces) {
+        sourceInterface.message(MailboxDuplicationStrategy::replaceNewest, MFN(&Tiled2dMapSourcePrefetchInterface::onPrefetchBoundsChanged),
+                                predictedBounds, curT, predictedZoom);
+    }
 }
 
 void Tiled2dMapLayer::onCameraChange(const std::vector<float> &viewMatrix, const std::vector<float> &projectionMatrix, const ::Vec3D & origin, float verticalFov, float horizontalFov, float width, float height, float focusPointAltitude, const ::Coord & focusPointPosition, float zoom) {
@@ -120,6 +189,20 @@ void Tiled2dMapLayer::onCameraChange(const std::vector<float> &viewMatrix, const
         sourceInterface.message(MailboxDuplicationStrategy::replaceNewest, MFN(&Tiled2dMapSourceInterface::onCameraChange),
                                 viewMatrix, projectionMatrix, origin, verticalFov, horizontalFov, width, height, focusPointAltitude, focusPointPosition, zoom);
     }
+
+    updatePrefetchBounds(zoom);
+}
+
+void Tiled2dMapLayer::onCameraStateChanged(const std::shared_ptr<const MapCameraState> &cameraState) {
+    std::lock_guard<std::recursive_mutex> lock(sourcesMutex);
+
+    // only the pointer is copied into the messages, all sources share the snapshot
+    for (const auto &sourceInterface: cameraStateSourceInterfaces) {
+        sourceInterface.message(MailboxDuplicationStrategy::replaceNewest, MFN(&MapCameraStateListenerInterface::onCameraStateChanged),
+                                cameraState);
+    }
+
+    updatePrefetchBounds(cameraState->zoom);
 }
 
 void Tiled2dMapLayer::onRotationChanged(float angle) {
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "Tiled2dMapSourceLoadScheduler.h"
+#include "PerformanceLogger.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+Tiled2dMapSourceLoadScheduler::Tiled2dMapSourceLoadScheduler()
+    : Tiled2dMapSourceLoadScheduler(Config()) {}
+
+Tiled2dMapSourceLoadScheduler::Tiled2dMapSourceLoadScheduler(const Config &config)
+    : config(config)
+    , limit((double)std::clamp(config.initialConcurrentLoads, config.minConcurrentLoads, config.maxConcurrentLoads)) {}
+
+std::shared_ptr<Tiled2dMapSourceLoadScheduler> Tiled2dMapSourceLoadScheduler::getInstance(const std::shared_ptr<SchedulerInterface> &scheduler) {
+    static std::mutex instancesMutex;
+    static std::vector<std::pair<std::weak_ptr<SchedulerInterface>, std::weak_ptr<Tiled2dMapSourceLoadScheduler>>> instances;
+
+    std::lock_guard<std::mutex> lock(instancesMutex);
+    std::shared_ptr<Tiled2dMapSourceLoadScheduler> instance;
+    for (auto it = instances.begin(); it != instances.end();) {
+        auto strongScheduler = it->first.lock();
+        auto strongInstance = it->second.lock();
+        if (!strongScheduler || !strongInstance) {
+            it = instances.erase(it);
+            continue;
+        }
+        if (strongScheduler == scheduler) {
+            instance = strongInstance;
+        }
+        ++it;
+    }
+
+    if (!instance) {
+        instance = std::make_shared<Tiled2dMapSourceLoadScheduler>();
+        instances.emplace_back(scheduler, instance);
+    }
+    return instance;
+}
+
+uint64_t Tiled2dMapSourceLoadScheduler::registerClient(StartLoadCallback startLoad) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto clientId = nextClientId++;
+    clients.emplace(clientId, std::move(startLoad));
+    return clientId;
+}
+
+void Tiled2dMapSourceLoadScheduler::unregisterClient(uint64_t clientId) {
+    std::vector<Grant> grants;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        clients.erase(clientId);
+        latencyStats.erase(clientId);
+
+        removeRequestsLocked([clientId](const RequestKey &key) { return key.clientId == clientId; });
+
+        // granted loads that were not started yet will never be
+        for (auto it = loads.begin(); it != loads.end();) {
+            if (it->second.key.clientId == clientId && !it->second.startTime) {
+                loadTokens.erase(it->second.key);
+                it = loads.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        grants = collectGrantsLocked();
+    }
+    dispatch(std::move(grants));
+}
+
+void Tiled2dMapSourceLoadScheduler::setRequests(uint64_t clientId, const std::vector<Request> &requests) {
+    std::vector<Grant> grants;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::unordered_set<Tiled2dMapTileInfo> requestedTiles;
+        requestedTiles.reserve(requests.size());
+        for (const auto &request: requests) {
+            requestedTiles.insert(request.tile);
+        }
+        removeRequestsLocked([clientId, &requestedTiles](const RequestKey &key) {
+            return key.clientId == clientId && requestedTiles.count(key.tile) == 0;
+        });
+
+        for (const auto &request: requests) {
+            RequestKey key{clientId, request.tile};
+            auto it = heapIndices.find(key);
+            if (it != heapIndices.end()) {
+                addRequestLocked(clientId, Request{request.tile, heap[it->second].loaderIndex, request.priority});
+            } else {
+                addRequestLocked(clientId, request);
+            }
+        }
+
+        grants = collectGrantsLocked();
+    }
+    dispatch(std::move(grants));
+}
+
+void Tiled2dMapSourceLoadScheduler::addRequest(uint64_t clientId, const Request &request) {
+    std::vector<Grant> grants;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        addRequestLocked(clientId, request);
+        grants = collectGrantsLocked();
+    }
+    dispatch(std::move(grants));
+}
+
+void Tiled2dMapSourceLoadScheduler::addRequestLocked(uint64_t clientId, const Request &request) {
+    RequestKey key{clientId, request.tile};
+    if (loadTokens.count(key) != 0) {
+        return;
+    }
+
+    auto it = heapIndices.find(key);
+    if (it != heapIndices.end()) {
+        // reprioritize in place
+        auto &entry = heap[it->second];
+        entry.loaderIndex = request.loaderIndex;
+        entry.priority = request.priority;
+        restoreHeapAt(it->second);
+        return;
+    }
+
+    heap.push_back(PendingRequest{key, request.loaderIndex, request.priority, nextSequence++});
+    heapIndices[key] = heap.size() - 1;
+    siftUp(heap.size() - 1);
+}
+
+void Tiled2dMapSourceLoadScheduler::loadStarted(uint64_t token) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = loads.find(token);
+    if (it != loads.end()) {
+        it->second.startTime = config.now();
+    }
+}
+
+void Tiled2dMapSourceLoadScheduler::loadFinished(uint64_t token, bool countLatency) {
+    std::vector<Grant> grants;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = loads.find(token);
+        if (it == loads.end()) {
+            return;
+        }
+        auto load = it->second;
+        loads.erase(it);
+        loadTokens.erase(load.key);
+
+        if (countLatency && load.startTime) {
+            const std::chrono::duration<double, std::milli> latency = config.now() - *load.startTime;
+            updateLimitLocked(load.key.clientId, load.loaderIndex, latency.count());
+        }
+
+        grants = collectGrantsLocked();
+    }
+    dispatch(std::move(grants));
+}
+
+void Tiled2dMapSourceLoadScheduler::loadCancelled(uint64_t token) {
+    std::vector<Grant> grants;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = loads.find(token);
+        if (it == loads.end()) {
+            return;
+        }
+        loadTokens.erase(it->second.key);
+        loads.erase(it);
+
+        grants = collectGrantsLocked();
+    }
+    dispatch(std::move(grants));
+}
+
+void Tiled2dMapSourceLoadScheduler::updateLimitLocked(uint64_t clientId, size_t loaderIndex, double latencyMs) {
+    if (clients.count(clientId) == 0) {
+        // client was unregistered
+        return;
+    }
+    // sub-millisecond loads (e.g. local data) carry no signal
+    latencyMs = std::max(latencyMs, 1.0);
+
+    auto &stats = latencyStats[clientId][loaderIndex];
+    stats.numSamples++;
+    if (stats.averageLatencyMs < 0) {
+        stats.averageLatencyMs = latencyMs;
+    } else {
+        stats.averageLatencyMs = stats.averageLatencyMs * (1.0 - latencySmoothing) + latencyMs * latencySmoothing;
+    }
+    if (stats.minLatencyMs < 0 || stats.numSamples % minLatencyResetSamples == 0) {
+        stats.minLatencyMs = stats.averageLatencyMs;
+    }
+    stats.minLatencyMs = std::min(stats.minLatencyMs, latencyMs);
+
+    // don't grow the limit if it is not the bottleneck
+    const bool limited = (double)(loads.size() + 1) >= limit * 0.5 && !heap.empty();
+
+    const double gradient = std::clamp(stats.minLatencyMs * config.latencyTolerance / stats.averageLatencyMs, 0.5, 1.0);
+    double newLimit = limit * gradient;
+    if (limited) {
+        newLimit += std::sqrt(limit);
+    } else if (gradient >= 1.0) {
+        return;
+    }
+
+    limit = std::clamp(limit * (1.0 - limitSmoothing) + newLimit * limitSmoothing, (double)config.minConcurrentLoads,
+                       (double)config.maxConcurrentLoads);
+}
+
+std::vector<Tiled2dMapSourceLoadScheduler::Grant> Tiled2dMapSourceLoadScheduler::collectGrantsLocked() {
+    std::vector<Grant> grants;
+    while (!heap.empty() && (double)loads.size() < std::floor(limit)) {
+        auto request = heap.front();
+        removeAt(0);
+
+        auto clientIt = clients.find(request.key.clientId);
+        if (clientIt == clients.end()) {
+            continue;
+        }
+
+        auto token = nextToken++;
+        loads.emplace(token, Load{request.key, request.loaderIndex, std::nullopt});
+        loadTokens[request.key] = token;
+        grants.push_back(Grant{clientIt->second, request.key.tile, request.loaderIndex, token});
+    }
+    if (!grants.empty()) {
+        PERF_LOG_COUNT("Tiled2dMapSourceLoadScheduler_concurrencyLimit", (int64_t)limit);
+    }
+    return grants;
+}
+
+void Tiled2dMapSourceLoadScheduler::dispatch(std::vector<Grant> grants) {
+    for (const auto &grant: grants) {
+        grant.callback(grant.tile, grant.loaderIndex, grant.token);
+    }
+}
+
+size_t Tiled2dMapSourceLoadScheduler::getConcurrencyLimit() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return (size_t)limit;
+}
+
+size_t Tiled2dMapSourceLoadScheduler::getNumLoading() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return loads.size();
+}
+
+size_t Tiled2dMapSourceLoadScheduler::getNumPending() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return heap.size();
+}
+
+size_t Tiled2dMapSourceLoadScheduler::getNumPending(uint64_t clientId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t count = 0;
+    for (const auto &request: heap) {
+        count += request.key.clientId == clientId;
+    }
+    return count;
+}
+
+bool Tiled2dMapSourceLoadScheduler::isBefore(const PendingRequest &lhs, const PendingRequest &rhs) {
+    if (lhs.loaderIndex != rhs.loaderIndex) {
+        return lhs.loaderIndex < rhs.loaderIndex;
+    }
+    if (lhs.priority != rhs.priority) {
+        return lhs.priority < rhs.priority;
+    }
+    return lhs.sequence < rhs.sequence;
+}
+
+void Tiled2dMapSourceLoadScheduler::removeRequestsLocked(const std::function<bool(const RequestKey &key)> &predicate) {
+    std::vector<RequestKey> toRemove;
+    for (const auto &request: heap) {
+        if (predicate(request.key)) {
+            toRemove.push_back(request.key);
+        }
+    }
+    for (const auto &key: toRemove) {
+        removeAt(heapIndices.at(key));
+    }
+}
+
+void Tiled2dMapSourceLoadScheduler::removeAt(size_t index) {
+    heapIndices.erase(heap[index].key);
+    const size_t last = heap.size() - 1;
+    if (index != last) {
+        heap[index] = heap[last];
+        heapIndices[heap[index].key] = index;
+    }
+    heap.pop_back();
+    if (index < heap.size()) {
+        restoreHeapAt(index);
+    }
+}
+
+void Tiled2dMapSourceLoadScheduler::restoreHeapAt(size_t index) {
+    const auto key = heap[index].key;
+    siftUp(index);
+    siftDown(heapIndices.at(key));
+}
+
+void Tiled2dMapSourceLoadScheduler::siftUp(size_t index) {
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!isBefore(heap[index], heap[parent])) {
+            break;
+        }
+        swapEntries(index, parent);
+        index = parent;
+    }
+}
+
+void Tiled2dMapSourceLoadScheduler::siftDown(size_t index) {
+    while (true) {
+        size_t smallest = index;
+        size_t left = 2 * index + 1;
+        size_t right = left + 1;
+        if (left < heap.size() && isBefore(heap[left], heap[smallest])) {
+            smallest = left;
+        }
+        if (right < heap.size() && isBefore(heap[right], heap[smallest])) {
+            smallest = right;
+        }
+        if (smallest == index) {
+            break;
+        }
+        swapEntries(index, smallest);
+        index = smallest;
+    }
+}
+
+void Tiled2dMapSourceLoadScheduler::swapEntries(size_t a, size_t b) {
+    std::swap(heap[a], heap[b]);
+    heapIndices[heap[a].key] = a;
+    heapIndices[heap[b].key] = b;
+}
@@ -0,0 +1,587 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "Tiled2dMapVisibleTilesPyramid.h"
+#include "CoordinateSystemIdentifiers.h"
+#include "Matrix.h"
+#include "PerformanceLogger.h"
+#include "TrigonometryLUT.h"
+#include "Vec2DHelper.h"
+#include "Vec3DHelper.h"
+#include "gpc.h"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <unordered_set>
+
+template <typename T> static void hash_combine(size_t &seed, const T &value) {
+    std::hash<T> hasher;
+    auto v = hasher(value);
+    seed ^= v + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+Tiled2dMapVisibleTilesPyramid::Tiling::Tiling(int32_t layerSystemId, int32_t mapSystemId,
+                                              const std::vector<Tiled2dMapZoomLevelInfo> &zoomLevelInfos,
+                                              int32_t topMostZoomLevel, float zoomLevelScaleFactor)
+    : layerSystemId(layerSystemId)
+    , mapSystemId(mapSystemId)
+    , zoomLevelInfos(zoomLevelInfos)
+    , topMostZoomLevel(topMostZoomLevel)
+    , zoomLevelScaleFactor(zoomLevelScaleFactor) {
+    hash_combine(hash, layerSystemId);
+    hash_combine(hash, mapSystemId);
+    hash_combine(hash, topMostZoomLevel);
+    hash_combine(hash, zoomLevelScaleFactor);
+    for (const auto &level : zoomLevelInfos) {
+        hash_combine(hash, level.zoom);
+        hash_combine(hash, level.tileWidthLayerSystemUnits);
+        hash_combine(hash, level.numTilesX);
+        hash_combine(hash, level.numTilesY);
+        hash_combine(hash, level.zoomLevelIdentifier);
+    }
+}
+
+bool Tiled2dMapVisibleTilesPyramid::Tiling::operator==(const Tiling &o) const {
+    if (hash != o.hash || layerSystemId != o.layerSystemId || mapSystemId != o.mapSystemId ||
+        topMostZoomLevel != o.topMostZoomLevel || zoomLevelScaleFactor != o.zoomLevelScaleFactor ||
+        zoomLevelInfos.size() != o.zoomLevelInfos.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < zoomLevelInfos.size(); ++i) {
+        const auto &a = zoomLevelInfos[i];
+        const auto &b = o.zoomLevelInfos[i];
+        if (a.zoom != b.zoom || a.tileWidthLayerSystemUnits != b.tileWidthLayerSystemUnits || a.numTilesX != b.numTilesX ||
+            a.numTilesY != b.numTilesY || a.numTilesT != b.numTilesT || a.zoomLevelIdentifier != b.zoomLevelIdentifier ||
+            !(a.bounds == b.bounds)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Tiled2dMapVisibleTilesPyramid::Tiled2dMapVisibleTilesPyramid(
+    const std::shared_ptr<CoordinateConversionHelperInterface> &conversionHelper)
+    : conversionHelper(conversionHelper) {}
+
+std::shared_ptr<Tiled2dMapVisibleTilesPyramid>
+Tiled2dMapVisibleTilesPyramid::getInstance(const std::shared_ptr<CoordinateConversionHelperInterface> &conversionHelper) {
+    static std::mutex instancesMutex;
+    static std::vector<std::pair<std::weak_ptr<CoordinateConversionHelperInterface>, std::weak_ptr<Tiled2dMapVisibleTilesPyramid>>>
+        instances;
+
+    std::lock_guard<std::mutex> lock(instancesMutex);
+    std::shared_ptr<Tiled2dMapVisibleTilesPyramid> instance;
+    for (auto it = instances.begin(); it != instances.end();) {
+        auto strongHelper = it->first.lock();
+        auto strongInstance = it->second.lock();
+        if (!strongHelper || !strongInstance) {
+            it = instances.erase(it);
+            continue;
+        }
+        if (strongHelper == conversionHelper) {
+            instance = strongInstance;
+        }
+        ++it;
+    }
+
+    if (!instance) {
+        instance = std::make_shared<Tiled2dMapVisibleTilesPyramid>(conversionHelper);
+        instances.emplace_back(conversionHelper, instance);
+    }
+    return instance;
+}
+
+std::shared_ptr<const Tiled2dMapVisibleTilesPyramid::Result> Tiled2dMapVisibleTilesPyramid::getVisibleTiles(const Tiling &tiling,
+                                                                                                           const Camera &camera) {
+    return getVisibleTiles(tiling, std::make_shared<const Camera>(camera));
+}
+
+std::shared_ptr<const Tiled2dMapVisibleTilesPyramid::Result>
+Tiled2dMapVisibleTilesPyramid::getVisibleTiles(const Tiling &tiling, const std::shared_ptr<const Camera> &camera) {
+    std::promise<std::shared_ptr<const Result>> promise;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto frameIt = std::find_if(frames.begin(), frames.end(),
+                                    [&camera](const Frame &frame) { return frame.camera == camera || *frame.camera == *camera; });
+        if (frameIt == frames.end()) {
+            if (frames.size() >= maxFrames) {
+                frames.pop_front();
+            }
+            frames.push_back(Frame{camera, {}});
+            frameIt = std::prev(frames.end());
+        }
+
+        for (const auto &[frameTiling, future] : frameIt->results) {
+            if (frameTiling == tiling) {
+                auto sharedResult = future;
+                lock.unlock();
+                PERF_LOG_COUNT("Tiled2dMapVisibleTilesPyramid_shared", 1);
+                return sharedResult.get();
+            }
+        }
+        frameIt->results.emplace_back(tiling, promise.get_future().share());
+        numComputations++;
+    }
+
+    PERF_LOG_COUNT("Tiled2dMapVisibleTilesPyramid_shared", 0);
+    try {
+        auto result = computeVisibleTiles(tiling, *camera);
+        promise.set_value(result);
+        return result;
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+}
+
+size_t Tiled2dMapVisibleTilesPyramid::getNumComputations() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return numComputations;
+}
+
+std::shared_ptr<const Tiled2dMapVisibleTilesPyramid::Result> Tiled2dMapVisibleTilesPyramid::computeVisibleTiles(const Tiling &tiling,
+                                                                                                               const Camera &camera) {
+    PERF_LOG_START("Tiled2dMapVisibleTilesPyramid_compute");
+    auto result = computeVisibleTilesInternal(tiling, camera);
+    PERF_LOG_END("Tiled2dMapVisibleTilesPyramid_compute");
+    return result;
+}
+
+std::shared_ptr<const Tiled2dMapVisibleTilesPyramid::Result>
+Tiled2dMapVisibleTilesPyramid::computeVisibleTilesInternal(const Tiling &tiling, const Camera &camera) {
+    const int32_t layerSystemId = tiling.layerSystemId;
+    const auto &zoomLevelInfosWithVirtual = tiling.zoomLevelInfos;
+    const int32_t topMostZoomLevel = tiling.topMostZoomLevel;
+
+    const auto &viewMatrix = camera.viewMatrix;
+    const auto &projectionMatrix = camera.projectionMatrix;
+    const auto &origin = camera.origin;
+    const float verticalFov = camera.verticalFov;
+    const float horizontalFov = camera.horizontalFov;
+    const float width = camera.width;
+    const float height = camera.height;
+    const float focusPointAltitude = camera.focusPointAltitude;
+    const auto &focusPointPosition = camera.focusPointPosition;
+
+    std::queue<VisibleTileCandidate> candidates;
+    std::unordered_set<VisibleTileCandidate> candidatesSet;
+
+    Coord viewBoundsTopLeft(layerSystemId, 0, 0, 0);
+    Coord viewBoundsTopRight(layerSystemId, 0, 0, 0);
+    Coord viewBoundsBottomLeft(layerSystemId, 0, 0, 0);
+    Coord viewBoundsBottomRight(layerSystemId, 0, 0, 0);
+    bool validViewBounds = false;
+
+    int minNumTiles = layerSystemId == CoordinateSystemIdentifiers::EPSG4326() ? 0 : 1;
+
+    int maxLevel = 0;
+    int minZoomLevelIndex = 0;
+    for (int index = 0; index < zoomLevelInfosWithVirtual.size(); ++index) {
+        const auto &level = zoomLevelInfosWithVirtual[index];
+        if (level.numTilesX > minNumTiles && level.numTilesY > minNumTiles) {
+            if (level.numTilesX * level.numTilesY > 100) {
+                printf("Ignore seed candidates for %d x %d tiles\n", level.numTilesX, level.numTilesY);
+                break;
+            }
+            for (int x = 0; x < level.numTilesX; x++) {
+                for (int y = 0; y < level.numTilesY; y++) {
+                    VisibleTileCandidate c;
+                    c.levelIndex = index;
+                    c.x = x;
+                    c.y = y;
+
+                    candidates.push(c);
+                }
+            }
+            maxLevel = level.zoomLevelIdentifier;
+            minZoomLevelIndex = level.zoomLevelIdentifier;
+            break;
+        }
+    }
+
+    gpc_polygon currentViewBoundsPolygon;
+    gpc_polygon currentTilePolygon;
+    gpc_set_polygon({PolygonCoord(
+                        {
+                            conversionHelper->convert(layerSystemId, Coord(4326, -180, 90, 0)),  // top left
+                            conversionHelper->convert(layerSystemId, Coord(4326, 180, 90, 0)),   // top right
+                            conversionHelper->convert(layerSystemId, Coord(4326, 180, -90, 0)),  // bottom right
+                            conversionHelper->convert(layerSystemId, Coord(4326, -180, -90, 0)), // bottom left
+                            conversionHelper->convert(layerSystemId, Coord(4326, -180, 90, 0))   // top left
+                        },
+                        {})},
+                    &currentViewBoundsPolygon);
+    auto clipAndFreeLambda = [&currentViewBoundsPolygon](gpc_polygon &polygon) {
+        gpc_polygon_clip(GPC_DIFF, &currentViewBoundsPolygon, &polygon, &currentViewBoundsPolygon);
+        gpc_free_polygon(&polygon);
+    };
+
+    auto result = std::make_shared<Result>();
+    auto &visibleTilesVec = result->visibleTiles;
+
+    auto maxLevelAvailable = zoomLevelInfosWithVirtual.size() - 1;
+
+    int candidateChecks = 0;
+
+    auto focusPointInLayerCoords = conversionHelper->convert(layerSystemId, focusPointPosition);
+
+    auto earthCenterView = transformToView(Coord(CoordinateSystemIdentifiers::UnitSphere(), 0, 0, 0), viewMatrix, origin);
+
+    while (candidates.size() > 0) {
+        VisibleTileCandidate candidate = candidates.front();
+        candidates.pop();
+        candidatesSet.erase(candidate);
+
+        candidateChecks++;
+
+        if (candidateChecks > 1000) {
+            // something seems wrong here.
+            // lets ignore this run and wait for the next update instead of burning the cpu
+            gpc_free_polygon(&currentViewBoundsPolygon);
+            return result;
+        }
+
+        const Tiled2dMapZoomLevelInfo &zoomLevelInfo = zoomLevelInfosWithVirtual.at(candidate.levelIndex);
+
+        const double boundsRatio =
+            std::abs(((zoomLevelInfo.bounds.bottomRight.y - zoomLevelInfo.bounds.topLeft.y) / zoomLevelInfo.numTilesY) /
+                     ((zoomLevelInfo.bounds.bottomRight.x - zoomLevelInfo.bounds.topLeft.x) / zoomLevelInfo.numTilesX));
+        const double tileWidth = zoomLevelInfo.tileWidthLayerSystemUnits;
+        const double tileHeight = zoomLevelInfo.tileWidthLayerSystemUnits * boundsRatio;
+
+        RectCoord layerBounds = zoomLevelInfo.bounds;
+        layerBounds = conversionHelper->convertRect(layerSystemId, layerBounds);
+
+        const bool leftToRight = layerBounds.topLeft.x < layerBounds.bottomRight.x;
+        const bool topToBottom = layerBounds.topLeft.y < layerBounds.bottomRight.y;
+        const double tileWidthAdj = leftToRight ? tileWidth : -tileWidth;
+        const double tileHeightAdj = topToBottom ? tileHeight : -tileHeight;
+
+        const double boundsLeft = layerBounds.topLeft.x;
+        const double boundsTop = layerBounds.topLeft.y;
+
+        const double heightRange = 1000;
+
+        const Coord topLeft = Coord(layerSystemId, candidate.x * tileWidthAdj + boundsLeft, candidate.y * tileHeightAdj + boundsTop,
+                                    focusPointAltitude);
+        const Coord topRight = Coord(layerSystemId, topLeft.x + tileWidthAdj, topLeft.y, focusPointAltitude - heightRange / 2.0);
+        const Coord bottomLeft = Coord(layerSystemId, topLeft.x, topLeft.y + tileHeightAdj, focusPointAltitude - heightRange / 2.0);
+        const Coord bottomRight =
+            Coord(layerSystemId, topLeft.x + tileWidthAdj, topLeft.y + tileHeightAdj, focusPointAltitude - heightRange / 2.0);
+
+        const Coord tileCenter = Coord(layerSystemId, topLeft.x * 0.5 + bottomRight.x * 0.5, topLeft.y * 0.5 + bottomRight.y * 0.5,
+                                       topLeft.z * 0.5 + bottomRight.z * 0.5);
+
+        gpc_set_polygon({PolygonCoord({topLeft, topRight, bottomRight, bottomLeft, topLeft}, {})}, &currentTilePolygon);
+
+        const auto focusPointClampedToTile =
+            Coord(layerSystemId,
+                  topLeft.x < topRight.x ? std::clamp(focusPointInLayerCoords.x, topLeft.x, topRight.x)
+                                         : std::clamp(focusPointInLayerCoords.x, topRight.x, topLeft.x),
+                  topLeft.y < bottomLeft.y ? std::clamp(focusPointInLayerCoords.y, topLeft.y, bottomLeft.y)
+                                           : std::clamp(focusPointInLayerCoords.y, bottomLeft.y, topLeft.y),
+                  focusPointAltitude);
+
+        auto toRight = focusPointClampedToTile.x < tileCenter.x;
+        auto toTop = focusPointClampedToTile.y < tileCenter.y;
+
+        const double sampleSize = 0.25;
+
+        const auto focusPointSampleX =
+            Coord(layerSystemId, focusPointClampedToTile.x + (toRight ? tileWidthAdj : -tileWidthAdj) * sampleSize,
+                  focusPointClampedToTile.y, focusPointClampedToTile.z);
+
+        const auto focusPointSampleY =
+            Coord(layerSystemId, focusPointClampedToTile.x,
+                  focusPointClampedToTile.y + (toTop ? -tileHeightAdj : tileHeightAdj) * sampleSize, focusPointClampedToTile.z);
+
+        const Coord topCenter = Coord(layerSystemId, topLeft.x * 0.5 + topRight.x * 0.5, topLeft.y, topLeft.z);
+        const Coord bottomCenter = Coord(layerSystemId, bottomLeft.x * 0.5 + bottomRight.x * 0.5, bottomLeft.y, bottomLeft.z);
+        const Coord leftCenter = Coord(layerSystemId, topLeft.x, bottomLeft.y * 0.5 + topLeft.y * 0.5, topLeft.z);
+        const Coord rightCenter = Coord(layerSystemId, topRight.x, bottomRight.y * 0.5 + topRight.y * 0.5, topRight.z);
+
+        auto topLeftView = transformToView(topLeft, viewMatrix, origin);
+        auto topRightView = transformToView(topRight, viewMatrix, origin);
+        auto bottomLeftView = transformToView(bottomLeft, viewMatrix, origin);
+        auto bottomRightView = transformToView(bottomRight, viewMatrix, origin);
+
+        /*
+         use focuspoint in layersystem and clamp to tileBounds
+         */
+
+        auto focusPointClampedView = transformToView(focusPointClampedToTile, viewMatrix, origin);
+        auto focusPointSampleXView = transformToView(focusPointSampleX, viewMatrix, origin);
+        auto focusPointSampleYView = transformToView(focusPointSampleY, viewMatrix, origin);
+
+        auto topCenterView = transformToView(topCenter, viewMatrix, origin);
+        auto bottomCenterView = transformToView(bottomCenter, viewMatrix, origin);
+        auto leftCenterView = transformToView(leftCenter, viewMatrix, origin);
+        auto rightCenterView = transformToView(rightCenter, viewMatrix, origin);
+
+        float centerZ = (topLeftView.z + topRightView.z + bottomLeftView.z + bottomRightView.z) / 4.0;
+
+        auto diffCenterViewTopLeft = topLeftView - earthCenterView;
+        auto diffCenterViewTopRight = topRightView - earthCenterView;
+        auto diffCenterViewBottomLeft = bottomLeftView - earthCenterView;
+        auto diffCenterViewBottomRight = bottomRightView - earthCenterView;
+
+        auto diffCenterViewTopCenter = topCenterView - earthCenterView;
+        auto diffCenterViewBottomCenter = bottomCenterView - earthCenterView;
+        auto diffCenterViewLeftCenter = leftCenterView - earthCenterView;
+        auto diffCenterViewRightCenter = rightCenterView - earthCenterView;
+
+        bool isKeptLevel = candidate.levelIndex == minZoomLevelIndex;
+
+        if (!isKeptLevel && diffCenterViewTopLeft.z < 0.0 && diffCenterViewTopRight.z < 0.0 && diffCenterViewBottomLeft.z < 0.0 &&
+            diffCenterViewBottomRight.z < 0.0) {
+            clipAndFreeLambda(currentTilePolygon);
+            // LogDebug << "UBCM: dropping tile (all facing away) " << candidate.levelIndex << "/" << candidate.x << "/" <<=
+            // candidate.y; Tile is facing away from the camera
+            continue;
+        }
+        auto samplePointOriginViewScreen = projectToScreen(focusPointClampedView, projectionMatrix);
+        if (!isKeptLevel && (samplePointOriginViewScreen.x < -1.0 || samplePointOriginViewScreen.x > 1.0 ||
+                             samplePointOriginViewScreen.y < -1.0 || samplePointOriginViewScreen.y > 1.0)) {
+            if (tiling.mapSystemId == CoordinateSystemIdentifiers::UnitSphere()) {
+                // v(0,0,+1) = unit-vector out of screen
+                float topLeftHA = 180.0 / M_PI * atan2(topLeftView.x, -topLeftView.z);
+                float topLeftVA = 180.0 / M_PI * atan2(topLeftView.y, -topLeftView.z);
+                float topRightHA = 180.0 / M_PI * atan2(topRightView.x, -topRightView.z);
+                float topRightVA = 180.0 / M_PI * atan2(topRightView.y, -topRightView.z);
+                float bottomLeftHA = 180.0 / M_PI * atan2(bottomLeftView.x, -bottomLeftView.z);
+                float bottomLeftVA = 180.0 / M_PI * atan2(bottomLeftView.y, -bottomLeftView.z);
+                float bottomRightHA = 180.0 / M_PI * atan2(bottomRightView.x, -bottomRightView.z);
+                float bottomRightVA = 180.0 / M_PI * atan2(bottomRightView.y, -bottomRightView.z);
+
+                float topCenterHA = 180.0 / M_PI * atan2(topCenterView.x, -topCenterView.z);
+                float topCenterVA = 180.0 / M_PI * atan2(topCenterView.y, -topCenterView.z);
+                float bottomCenterHA = 180.0 / M_PI * atan2(bottomCenterView.x, -bottomCenterView.z);
+                float bottomCenterVA = 180.0 / M_PI * atan2(bottomCenterView.y, -bottomCenterView.z);
+                float leftCenterHA = 180.0 / M_PI * atan2(leftCenterView.x, -leftCenterView.z);
+                float leftCenterVA = 180.0 / M_PI * atan2(leftCenterView.y, -leftCenterView.z);
+                float rightCenterHA = 180.0 / M_PI * atan2(rightCenterView.x, -rightCenterView.z);
+                float rightCenterVA = 180.0 / M_PI * atan2(rightCenterView.y, -rightCenterView.z);
+
+                // 0.5: half of view on each side of center
+                // 1.1: increase angle with padding
+                float fovFactor = 0.5 * 1.1;
+
+                float left = -horizontalFov * fovFactor;
+                float right = horizontalFov * fovFactor;
+                float top = verticalFov * fovFactor;
+                float bottom = -verticalFov * fovFactor;
+
+                if ((topLeftVA < bottom || diffCenterViewTopLeft.z < 0.0) &&
+                    (topRightVA < bottom || diffCenterViewTopRight.z < 0.0) &&
+                    (bottomLeftVA < bottom || diffCenterViewBottomLeft.z < 0.0) &&
+                    (bottomRightVA < bottom || diffCenterViewBottomRight.z < 0.0) &&
+                    (topCenterVA < bottom || diffCenterViewTopCenter.z < 0.0) &&
+                    (bottomCenterVA < bottom || diffCenterViewBottomCenter.z < 0.0) &&
+                    (leftCenterVA < bottom || diffCenterViewLeftCenter.z < 0.0) &&
+                    (rightCenterVA < bottom || diffCenterViewRightCenter.z < 0.0)) {
+                    clipAndFreeLambda(currentTilePolygon);
+                    // LogDebug << "UBCM: dropping tile (below) " << candidate.levelIndex << "/" << candidate.x << "/" <<=
+                    // candidate.y;
+                    continue; // All camera-facing corners are BELOW the viewport
+                }
+                if ((topLeftHA < left || diffCenterViewTopLeft.z < 0.0) && (topRightHA < left || diffCenterViewTopRight.z < 0.0) &&
+                    (bottomLeftHA < left || diffCenterViewBottomLeft.z < 0.0) &&
+                    (bottomRightHA < left || diffCenterViewBottomRight.z < 0.0) &&
+                    (topCenterHA < left || diffCenterViewTopCenter.z < 0.0) &&
+                    (bottomCenterHA < left || diffCenterViewBottomCenter.z < 0.0) &&
+                    (leftCenterHA < left || diffCenterViewLeftCenter.z < 0.0) &&
+                    (rightCenterHA < left || diffCenterViewRightCenter.z < 0.0)) {
+                    clipAndFreeLambda(currentTilePolygon);
+                    // LogDebug << "UBCM: dropping tile (left) " << candidate.levelIndex << "/" << candidate.x << "/" <<=
+                    // candidate.y;
+                    continue; // All camera-facing corners are TO THE LEFT of the viewport
+                }
+                if ((topLeftVA > top || diffCenterViewTopLeft.z < 0.0) && (topRightVA > top || diffCenterViewTopRight.z < 0.0) &&
+                    (bottomLeftVA > top || diffCenterViewBottomLeft.z < 0.0) &&
+                    (bottomRightVA > top || diffCenterViewBottomRight.z < 0.0) &&
+                    (topCenterVA > top || diffCenterViewTopCenter.z < 0.0) &&
+                    (bottomCenterVA > top || diffCenterViewBottomCenter.z < 0.0) &&
+                    (leftCenterVA > top || diffCenterViewLeftCenter.z < 0.0) &&
+                    (rightCenterVA > top || diffCenterViewRightCenter.z < 0.0)) {
+                    clipAndFreeLambda(currentTilePolygon);
+                    // LogDebug << "UBCM: dropping tile (above) " << candidate.levelIndex << "/" << candidate.x << "/" <<=
+                    // candidate.y;
+                    continue; // All camera-facing corners are ABOVE the viewport
+                }
+                if ((topLeftHA > right || diffCenterViewTopLeft.z < 0.0) &&
+                    (topRightHA > right || diffCenterViewTopRight.z < 0.0) &&
+                    (bottomLeftHA > right || diffCenterViewBottomLeft.z < 0.0) &&
+                    (bottomRightHA > right || diffCenterViewBottomRight.z < 0.0) &&
+                    (topCenterHA > right || diffCenterViewTopCenter.z < 0.0) &&
+                    (bottomCenterHA > right || diffCenterViewBottomCenter.z < 0.0) &&
+                    (leftCenterHA > right || diffCenterViewLeftCenter.z < 0.0) &&
+                    (rightCenterHA > right || diffCenterViewRightCenter.z < 0.0)) {
+                    clipAndFreeLambda(currentTilePolygon);
+                    // LogDebug << "UBCM: dropping tile (right) " << candidate.levelIndex << "/" << candidate.x << "/" <<=
+                    // candidate.y;
+                    continue; // All camera-facing corners are TO THE RIGHT of the viewport
+                }
+            } else {
+                if (topLeftView.x < -width / 2.0 && topRightView.x < -width / 2.0 && bottomLeftView.x < -width / 2.0 &&
+                    bottomRightView.x < -width / 2.0) {
+                    clipAndFreeLambda(currentTilePolygon);
+                    continue;
+                }
+                if (topLeftView.y < -height / 2.0 && topRightView.y < -height / 2.0 && bottomLeftView.y < -height / 2.0 &&
+                    bottomRightView.y < -height / 2.0) {
+                    clipAndFreeLambda(currentTilePolygon);
+                    continue;
+                }
+                if (topLeftView.x > width / 2.0 && topRightView.x > width / 2.0 && bottomLeftView.x > width / 2.0 &&
+                    bottomRightView.x > width / 2.0) {
+                    clipAndFreeLambda(currentTilePolygon);
+                    continue;
+                }
+                if (topLeftView.y > height / 2.0 && topRightView.y > height / 2.0 && bottomLeftView.y > height / 2.0 &&
+                    bottomRightView.y > height / 2.0) {
+                    clipAndFreeLambda(currentTilePolygon);
+                    continue;
+                }
+            }
+        }
+
+        if (!validViewBounds) {
+            viewBoundsTopLeft = topLeft;
+            viewBoundsBottomRight = bottomRight;
+            validViewBounds = true;
+        }
+
+        auto updateBounds = [](double &bound, double value, bool compareLess) {
+            bound = compareLess ? std::min(bound, value) : std::max(bound, value);
+        };
+
+        // Update x coordinates
+        updateBounds(viewBoundsTopRight.x, topRight.x, leftToRight);
+        updateBounds(viewBoundsTopLeft.x, topLeft.x, !leftToRight);
+        updateBounds(viewBoundsBottomRight.x, bottomRight.x, leftToRight);
+        updateBounds(viewBoundsBottomLeft.x, bottomLeft.x, !leftToRight);
+
+        // Update y coordinates
+        updateBounds(viewBoundsTopRight.y, topRight.y, topToBottom);
+        updateBounds(viewBoundsTopLeft.y, topLeft.y, topToBottom);
+        updateBounds(viewBoundsBottomRight.y, bottomRight.y, !topToBottom);
+        updateBounds(viewBoundsBottomLeft.y, bottomLeft.y, !topToBottom);
+
+        auto samplePointYViewScreen = projectToScreen(focusPointSampleYView, projectionMatrix);
+        auto samplePointXViewScreen = projectToScreen(focusPointSampleXView, projectionMatrix);
+
+        Vec2D samplePointOriginViewScreenPx(samplePointOriginViewScreen.x * (width / 2.0),
+                                            samplePointOriginViewScreen.y * (height / 2.0));
+        Vec2D samplePointYViewScreenPx(samplePointYViewScreen.x * (width / 2.0), samplePointYViewScreen.y * (height / 2.0));
+        Vec2D samplePointXViewScreenPx(samplePointXViewScreen.x * (width / 2.0), samplePointXViewScreen.y * (height / 2.0));
+
+        double xLengthPx = Vec2DHelper::distance(samplePointOriginViewScreenPx, samplePointXViewScreenPx);
+        double yLengthPx = Vec2DHelper::distance(samplePointOriginViewScreenPx, samplePointYViewScreenPx);
+
+        double maxLength = sampleSize * (std::min(width, height) * 0.5 / tiling.zoomLevelScaleFactor);
+        bool preciseEnough = xLengthPx <= maxLength || yLengthPx <= maxLength;
+
+        bool lastLevel = candidate.levelIndex == maxLevelAvailable;
+
+        bool isVirtual = topMostZoomLevel > zoomLevelInfo.zoomLevelIdentifier;
+
+        if (!isVirtual && (preciseEnough || lastLevel || isKeptLevel)) {
+            const RectCoord rect(topLeft, bottomRight);
+            int t = 0;
+            double priority = -centerZ * 100000;
+            visibleTilesVec.push_back(std::make_pair(
+                candidate, PrioritizedTiled2dMapTileInfo(Tiled2dMapTileInfo(rect, candidate.x, candidate.y, t,
+                                                                            zoomLevelInfo.zoomLevelIdentifier, zoomLevelInfo.zoom),
+                                                         priority)));
+
+            maxLevel = std::max(maxLevel, zoomLevelInfo.zoomLevelIdentifier);
+        }
+
+        if (!preciseEnough && !lastLevel) {
+            const Tiled2dMapZoomLevelInfo &zoomLevelInfo = zoomLevelInfosWithVirtual.at(candidate.levelIndex + 1);
+
+            const double tileWidth = zoomLevelInfo.tileWidthLayerSystemUnits;
+            const double tileHeight = zoomLevelInfo.tileWidthLayerSystemUnits * boundsRatio;
+
+            RectCoord layerBounds = zoomLevelInfo.bounds;
+            layerBounds = conversionHelper->convertRect(layerSystemId, layerBounds);
+
+            const bool leftToRight = layerBounds.topLeft.x < layerBounds.bottomRight.x;
+            const bool topToBottom = layerBounds.topLeft.y < layerBounds.bottomRight.y;
+            const double tileWidthAdj = leftToRight ? tileWidth : -tileWidth;
+            const double tileHeightAdj = topToBottom ? tileHeight : -tileHeight;
+
+            const double boundsLeft = layerBounds.topLeft.x;
+            const double boundsTop = layerBounds.topLeft.y;
+
+            int nextCandidateXMin = floor((topLeft.x - boundsLeft) / tileWidthAdj);
+            int nextCandidateXMax = ceil((topRight.x - boundsLeft) / tileWidthAdj) - 1;
+
+            int nextCandidateYMin = floor((topLeft.y - boundsTop) / tileHeightAdj);
+            int nextCandidateYMax = ceil((bottomLeft.y - boundsTop) / tileHeightAdj) - 1;
+
+            for (int nextX = nextCandidateXMin; nextX <= nextCandidateXMax; nextX++) {
+                for (int nextY = nextCandidateYMin; nextY <= nextCandidateYMax; nextY++) {
+                    VisibleTileCandidate cNext;
+                    cNext.levelIndex = candidate.levelIndex + 1;
+                    cNext.x = nextX;
+                    cNext.y = nextY;
+                    if (candidatesSet.find(cNext) == candidatesSet.end()) {
+                        candidates.push(cNext);
+                        candidatesSet.insert(cNext);
+                    }
+                }
+            }
+        }
+    }
+
+    result->viewBounds = gpc_get_polygon_coord(&currentViewBoundsPolygon, layerSystemId);
+    gpc_free_polygon(&currentViewBoundsPolygon);
+
+    result->valid = true;
+    result->validViewBounds = validViewBounds;
+    result->minZoomLevelIndex = minZoomLevelIndex;
+    result->maxLevel = maxLevel;
+    return result;
+}
+
+::Vec3D Tiled2dMapVisibleTilesPyramid::transformToView(const ::Coord &position, const std::vector<float> &viewMatrix,
+                                                       const Vec3D &origin) {
+
+    Coord mapCoord = conversionHelper->convertToRenderSystem(position);
+
+    const double rx = origin.x;
+    const double ry = origin.y;
+    const double rz = origin.z;
+
+    double sinX, cosX, sinY, cosY;
+    lut::sincos(mapCoord.y, sinY, cosY);
+    lut::sincos(mapCoord.x, sinX, cosX);
+
+    std::vector<float> inVec = {(float)((mapCoord.z * sinY * cosX - rx)),
+                                (float)((mapCoord.z * cosY - ry)),
+                                (float)((-mapCoord.z * sinY * sinX - rz)), 1.0};
+    std::vector<float> outVec = {0, 0, 0, 0};
+
+    Matrix::multiply(viewMatrix, inVec, outVec);
+
+    auto point2d = Vec3D(outVec[0] / outVec[3], outVec[1] / outVec[3], outVec[2] / outVec[3]);
+    return point2d;
+}
+
+::Vec3D Tiled2dMapVisibleTilesPyramid::projectToScreen(const ::Vec3D &position, const std::vector<float> &projectionMatrix) {
+    std::vector<float> inVec = {(float)position.x, (float)position.y, (float)position.z, 1.0};
+    std::vector<float> outVec = {0, 0, 0, 0};
+
+    Matrix::multiply(projectionMatrix, inVec, outVec);
+
+    auto point2d = Vec3D(outVec[0] / outVec[3], outVec[1] / outVec[3], outVec[2] / outVec[3]);
+    return point2d;
+}
@@ -72,11 +72,17 @@ void Tiled2dMapRasterLayer::onAdded(const std::shared_ptr<::MapInterface> &mapIn
         auto selfActor = WeakActor<Tiled2dMapRasterSourceListener>(selfMailbox, castedMe);
 
         auto mailbox = std::make_shared<Mailbox>(mapInterface->getScheduler());
+        observeReadyState(mailbox);
         rasterSource.emplaceObject(mailbox, mapInterface->getMapConfig(), layerConfig, mapInterface->getCoordinateConverterHelper(),
                                    mapInterface->getScheduler(), tileLoaders, selfActor,
                                    mapInterface->getCamera()->getScreenDensityPpi(), layerConfig->getLayerName());
 
         setSourceInterfaces({rasterSource.weakActor<Tiled2dMapSourceInterface>()});
+        setPrefetchSourceInterfaces({rasterSource.weakActor<Tiled2dMapSourcePrefetchInterface>()});
+        setCameraStateSourceInterfaces({rasterSource.weakActor<MapCameraStateListenerInterface>()});
+        if (timeSeriesFrames > 0) {
+            rasterSource.message(MFN(&Tiled2dMapRasterSource::setTimeSeries), timeSeriesFrames, timeSeriesMemoryBudget);
+        }
     }
 
     Tiled2dMapLayer::onAdded(mapInterface, layerIndex);
@@ -182,6 +188,26 @@ void Tiled2dMapRasterLayer::setT(int32_t t) {
     }
 }
 
+void Tiled2dMapRasterLayer::setTimeSeries(int32_t numFrames, int64_t memoryBudget) {
+    timeSeriesFrames = numFrames;
+    timeSeriesMemoryBudget = memoryBudget;
+    if (rasterSource) {
+        rasterSource.message(MFN(&Tiled2dMapRasterSource::setTimeSeries), numFrames, memoryBudget);
+        // update the visible tiles with the new window
+        Tiled2dMapLayer::setT(curT);
+    }
+}
+
+void Tiled2dMapRasterLayer::setTimeSeriesReadyListener(std::function<void(int32_t readyFrames, int32_t numFrames)> listener) {
+    timeSeriesReadyListener = listener;
+}
+
+void Tiled2dMapRasterLayer::onTimeSeriesReadyChanged(int32_t readyFrames, int32_t numFrames) {
+    if (timeSeriesReadyListener) {
+        timeSeriesReadyListener(readyFrames, numFrames);
+    }
+}
+
 bool Tiled2dMapRasterLayer::shouldLoadTile(const Tiled2dMapTileInfo &tileInfo) {
     return abs(tileInfo.t - curT) <= layerConfig->getZoomInfo().numDrawPreviousOrLaterTLayers;
 }
@@ -631,6 +657,8 @@ void Tiled2dMapRasterLayer::setReadyStateListener(const /*not-null*/ std::shared
 }
 
 void Tiled2dMapRasterLayer::updateReadyStateListenerIfNeeded() {
+    notifyReadyStateObserver();
+
     const auto listener = readyStateListener;
     if (!listener) {
         return;
@@ -48,6 +48,18 @@ std::shared_ptr<::TextureHolderInterface> Tiled2dMapRasterSource::postLoadingTas
     return loadedData->data;
 }
 
+int64_t Tiled2dMapRasterSource::getResultMemorySize(const std::shared_ptr<::TextureHolderInterface> &result) {
+    if (!result) {
+        return 0;
+    }
+    // decoded RGBA
+    return (int64_t)result->getImageWidth() * result->getImageHeight() * 4;
+}
+
+void Tiled2dMapRasterSource::onTimeSeriesReadyChanged(int32_t readyFrames, int32_t numFrames) {
+    rasterLayerActor.message(MFN(&Tiled2dMapRasterSourceListener::onTimeSeriesReadyChanged), readyFrames, numFrames);
+}
+
 void Tiled2dMapRasterSource::notifyTilesUpdates() {
     rasterLayerActor.message(MailboxDuplicationStrategy::replaceNewest, MFN(&Tiled2dMapRasterSourceListener::onTilesUpdated),
                              layerConfig->getLayerName(), getCurrentTiles());
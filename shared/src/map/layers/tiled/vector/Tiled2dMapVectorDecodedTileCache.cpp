@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "Tiled2dMapVectorDecodedTileCache.h"
+#include "PerformanceLogger.h"
+#include <algorithm>
+#include <vector>
+
+Tiled2dMapVectorDecodedTileCache::Tiled2dMapVectorDecodedTileCache(size_t maxSizeBytes)
+    : maxSizeBytes(maxSizeBytes) {}
+
+std::string Tiled2dMapVectorDecodedTileCache::createKey(const std::string &tileUrl, const std::unordered_set<std::string> &layersToDecode) {
+    std::vector<std::string> layers(layersToDecode.begin(), layersToDecode.end());
+    std::sort(layers.begin(), layers.end());
+
+    std::string key = tileUrl;
+    for (const auto &layer: layers) {
+        key += '\n';
+        key += layer;
+    }
+    return key;
+}
+
+Tiled2dMapVectorTileInfo::FeatureMap Tiled2dMapVectorDecodedTileCache::get(const std::string &key,
+                                                                           const std::shared_ptr<StringInterner> &stringTable) {
+    Tiled2dMapVectorTileInfo::FeatureMap featureMap;
+    std::shared_ptr<StringInterner> sourceTable;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it == entries.end()) {
+            misses++;
+            PERF_LOG_COUNT("Tiled2dMapVectorDecodedTileCache_misses", 1);
+            return nullptr;
+        }
+        lruOrder.splice(lruOrder.begin(), lruOrder, it->second.lruIterator);
+        featureMap = it->second.featureMap;
+        sourceTable = it->second.stringTable;
+        hits++;
+    }
+    PERF_LOG_COUNT("Tiled2dMapVectorDecodedTileCache_hits", 1);
+
+    if (sourceTable == stringTable) {
+        return featureMap;
+    }
+    return translateKeys(featureMap, *sourceTable, *stringTable);
+}
+
+void Tiled2dMapVectorDecodedTileCache::put(const std::string &key, const std::shared_ptr<StringInterner> &stringTable,
+                                           const Tiled2dMapVectorTileInfo::FeatureMap &featureMap) {
+    if (!featureMap || !stringTable) {
+        return;
+    }
+    size_t entrySize = key.capacity() + estimateSizeBytes(featureMap);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        sizeBytes -= it->second.sizeBytes;
+        lruOrder.erase(it->second.lruIterator);
+        entries.erase(it);
+    }
+    if (entrySize > maxSizeBytes) {
+        return;
+    }
+
+    evictLocked(maxSizeBytes - entrySize);
+
+    lruOrder.push_front(key);
+    entries.emplace(key, Entry{featureMap, stringTable, entrySize, lruOrder.begin()});
+    sizeBytes += entrySize;
+}
+
+void Tiled2dMapVectorDecodedTileCache::setMaxSizeBytes(size_t maxSizeBytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->maxSizeBytes = maxSizeBytes;
+    evictLocked(maxSizeBytes);
+}
+
+void Tiled2dMapVectorDecodedTileCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    lruOrder.clear();
+    sizeBytes = 0;
+}
+
+Tiled2dMapVectorDecodedTileCache::Statistics Tiled2dMapVectorDecodedTileCache::getStatistics() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return Statistics{hits, misses, evictions, entries.size(), sizeBytes};
+}
+
+void Tiled2dMapVectorDecodedTileCache::evictLocked(size_t maxSizeBytes) {
+    int64_t numEvicted = 0;
+    while (sizeBytes > maxSizeBytes && !lruOrder.empty()) {
+        auto it = entries.find(lruOrder.back());
+        sizeBytes -= it->second.sizeBytes;
+        entries.erase(it);
+        lruOrder.pop_back();
+        numEvicted++;
+    }
+    if (numEvicted > 0) {
+        evictions += numEvicted;
+        PERF_LOG_COUNT("Tiled2dMapVectorDecodedTileCache_evictions", numEvicted);
+    }
+}
+
+Tiled2dMapVectorTileInfo::FeatureMap Tiled2dMapVectorDecodedTileCache::translateKeys(const Tiled2dMapVectorTileInfo::FeatureMap &featureMap,
+                                                                                     const StringInterner &sourceTable,
+                                                                                     StringInterner &targetTable) {
+    std::unordered_map<InternedString, InternedString> translatedKeys;
+    auto translate = [&](InternedString key) {
+        auto it = translatedKeys.find(key);
+        if (it != translatedKeys.end()) {
+            return it->second;
+        }
+        auto translated = targetTable.add(sourceTable.get(key));
+        translatedKeys.emplace(key, translated);
+        return translated;
+    };
+
+    auto result = std::make_shared<std::unordered_map<std::string, std::shared_ptr<std::vector<Tiled2dMapVectorTileInfo::FeatureTuple>>>>();
+    result->reserve(featureMap->size());
+    for (const auto &[layerName, features]: *featureMap) {
+        auto translatedFeatures = std::make_shared<std::vector<Tiled2dMapVectorTileInfo::FeatureTuple>>();
+        translatedFeatures->reserve(features->size());
+        for (const auto &[featureContext, geometryHandler]: *features) {
+            auto translatedContext = std::make_shared<FeatureContext>(*featureContext);
+            for (auto &property: translatedContext->propertiesMap) {
+                property.first = translate(property.first);
+            }
+            translatedFeatures->push_back({translatedContext, geometryHandler});
+        }
+        result->emplace(layerName, std::move(translatedFeatures));
+    }
+    return result;
+}
+
+size_t Tiled2dMapVectorDecodedTileCache::estimateSizeBytes(const Tiled2dMapVectorTileInfo::FeatureMap &featureMap) {
+    // rough per allocation overhead of std::make_shared / node based containers
+    static constexpr size_t allocationOverhead = 16;
+
+    auto valueSize = [](const ValueVariant &value) -> size_t {
+        if (auto string = std::get_if<std::string>(&value)) {
+            return string->capacity();
+        } else if (auto floats = std::get_if<std::vector<float>>(&value)) {
+            return floats->capacity() * sizeof(float);
+        } else if (auto strings = std::get_if<std::vector<std::string>>(&value)) {
+            size_t size = strings->capacity() * sizeof(std::string);
+            for (const auto &s: *strings) {
+                size += s.capacity();
+            }
+            return size;
+        } else if (auto entries = std::get_if<std::vector<FormattedStringEntry>>(&value)) {
+            size_t size = entries->capacity() * sizeof(FormattedStringEntry);
+            for (const auto &entry: *entries) {
+                size += entry.text.capacity();
+            }
+            return size;
+        }
+        return 0;
+    };
+
+    size_t size = sizeof(*featureMap) + allocationOverhead;
+    for (const auto &[layerName, features]: *featureMap) {
+        size += sizeof(std::pair<const std::string, std::shared_ptr<std::vector<Tiled2dMapVectorTileInfo::FeatureTuple>>>) + layerName.capacity();
+        size += sizeof(*features) + features->capacity() * sizeof(Tiled2dMapVectorTileInfo::FeatureTuple) + 2 * allocationOverhead;
+
+        for (const auto &[featureContext, geometryHandler]: *features) {
+            size += sizeof(FeatureContext) + allocationOverhead;
+            size += featureContext->propertiesMap.capacity() * sizeof(FeatureContext::mapType::value_type);
+            for (const auto &[key, value]: featureContext->propertiesMap) {
+                size += valueSize(value);
+            }
+
+            size += sizeof(VectorTileGeometryHandler) + allocationOverhead;
+            const auto &coordinates = geometryHandler->getPointCoordinates();
+            size += coordinates.capacity() * sizeof(std::vector<Vec2D>);
+            for (const auto &line: coordinates) {
+                size += line.capacity() * sizeof(Vec2D);
+            }
+            const auto &polygons = geometryHandler->getPolygons();
+            size += polygons.capacity() * sizeof(VectorTileGeometryHandler::TriangulatedPolygon);
+            for (const auto &polygon: polygons) {
+                size += polygon.coordinates.capacity() * sizeof(Vec2D) + polygon.indices.capacity() * sizeof(uint16_t);
+            }
+        }
+    }
+    return size;
+}
@@ -312,6 +312,8 @@ void Tiled2dMapVectorLayer::initializeVectorLayer() {
     auto selfVectorActor = WeakActor<Tiled2dMapVectorSourceListener>(selfMailbox, castedMe);
 
     std::vector<WeakActor<Tiled2dMapSourceInterface>> sourceInterfaces;
+    std::vector<WeakActor<Tiled2dMapSourcePrefetchInterface>> prefetchSourceInterfaces;
+    std::vector<WeakActor<MapCameraStateListenerInterface>> cameraStateSourceInterfaces;
     std::vector<Actor<Tiled2dMapRasterSource>> rasterSources;
 
     std::unordered_map<std::string, Actor<Tiled2dMapVectorSource>> vectorTileSources;
@@ -338,6 +340,7 @@ void Tiled2dMapVectorLayer::initializeVectorLayer() {
                                 std::static_pointer_cast<RasterVectorLayerDescription>(layerDesc), is3d);
 
                 auto sourceMailbox = std::make_shared<Mailbox>(mapInterface->getScheduler());
+                observeReadyState(sourceMailbox);
                 auto sourceActor = Actor<Tiled2dMapRasterSource>(sourceMailbox,
                                                                  mapInterface->getMapConfig(),
                                                                  rasterSubLayerConfig,
@@ -353,6 +356,7 @@ void Tiled2dMapVectorLayer::initializeVectorLayer() {
                 auto readyManager = Actor<Tiled2dMapVectorReadyManager>(readyManagerMailbox, sourceActor.weakActor<Tiled2dMapSourceReadyInterface>());
 
                 auto sourceDataManagerMailbox = std::make_shared<Mailbox>(mapInterface->getScheduler());
+                observeReadyState(sourceDataManagerMailbox);
                 auto sourceManagerActor = Actor<Tiled2dMapVectorSourceRasterTileDataManager>(sourceDataManagerMailbox,
                                                                                              selfActor,
                                                                                              mapDescription,
@@ -365,6 +369,8 @@ void Tiled2dMapVectorLayer::initializeVectorLayer() {
                 sourceManagerActor.unsafe()->setAlpha(alpha);
                 sourceTileManagers[layerDesc->source] = sourceManagerActor.strongActor<Tiled2dMapVectorSourceTileDataManager>();
                 sourceInterfaces.push_back(sourceActor.weakActor<Tiled2dMapSourceInterface>());
+                prefetchSourceInterfaces.push_back(sourceActor.weakActor<Tiled2dMapSourcePrefetchInterface>());
+                cameraStateSourceInterfaces.push_back(sourceActor.weakActor<MapCameraStateListenerInterface>());
                 interactionDataManagers[layerDesc->source].push_back(sourceManagerActor.weakActor<Tiled2dMapVectorSourceDataManager>());
                 break;
             }
@@ -391,6 +397,7 @@ void Tiled2dMapVectorLayer::initializeVectorLayer() {
         }
 
         auto sourceMailbox = std::make_shared<Mailbox>(mapInterface->getScheduler());
+        observeReadyState(sourceMailbox);
 
         Actor<Tiled2dMapVectorSource> vectorSource;
         auto geoJsonSourceIt = mapDescription->geoJsonSources.find(source);
@@ -424,15 +431,22 @@ void Tiled2dMapVectorLayer::initializeVectorLayer() {
                                                               layers,
                                                               source,
                                                               mapInterface->getCamera()->getScreenDensityPpi(),
-                                                              layerName);
+                                                              layerName,
+                                                              decodedTileCache,
+                                                              packedTileStore,
+                                                              packedTileMaxAgeMillis,
+                                                              lineSimplificationTolerance);
         }
         vectorTileSources[source] = vectorSource;
         sourceInterfaces.push_back(vectorSource.weakActor<Tiled2dMapSourceInterface>());
+        prefetchSourceInterfaces.push_back(vectorSource.weakActor<Tiled2dMapSourcePrefetchInterface>());
+        cameraStateSourceInterfaces.push_back(vectorSource.weakActor<MapCameraStateListenerInterface>());
 
         auto readyManagerMailbox = std::make_shared<Mailbox>(mapInterface->getScheduler());
         auto readyManager = Actor<Tiled2dMapVectorReadyManager>(readyManagerMailbox, vectorSource.weakActor<Tiled2dMapSourceReadyInterface>());
 
         auto sourceDataManagerMailbox = std::make_shared<Mailbox>(mapInterface->getScheduler());
+        observeReadyState(sourceDataManagerMailbox);
         auto sourceManagerActor = Actor<Tiled2dMapVectorSourceVectorTileDataManager>(sourceDataManagerMailbox,
                                                                                      selfActor,
                                                                                      mapDescription,
@@ -447,6 +461,7 @@ void Tiled2dMapVectorLayer::initializeVectorLayer() {
 
         if (symbolSources.count(source) != 0) {
             auto symbolSourceDataManagerMailbox = std::make_shared<Mailbox>(mapInterface->getScheduler());
+            observeReadyState(symbolSourceDataManagerMailbox);
             auto actor = Actor<Tiled2dMapVectorSourceSymbolDataManager>(symbolSourceDataManagerMailbox,
                                                                         selfActor,
                                                                         mapDescription,
@@ -488,6 +503,8 @@ void Tiled2dMapVectorLayer::initializeVectorLayer() {
     }
 
     setSourceInterfaces(sourceInterfaces);
+    setPrefetchSourceInterfaces(prefetchSourceInterfaces);
+    setCameraStateSourceInterfaces(cameraStateSourceInterfaces);
 
     Tiled2dMapLayer::onAdded(mapInterface, layerIndex);
     mapInterface->getTouchHandler()->insertListener(std::dynamic_pointer_cast<TouchInterface>(shared_from_this()), layerIndex);
@@ -1452,7 +1469,25 @@ void Tiled2dMapVectorLayer::setReadyStateListener(const /*not-null*/ std::shared
     readyStateListener = listener;
 }
 
+void Tiled2dMapVectorLayer::setDecodedTileCache(const std::shared_ptr<Tiled2dMapVectorDecodedTileCache> &decodedTileCache) {
+    std::lock_guard<std::recursive_mutex> lock(mapDescriptionMutex);
+    this->decodedTileCache = decodedTileCache;
+}
+
+void Tiled2dMapVectorLayer::setPackedTileStore(const std::shared_ptr<TilePackFile> &packedTileStore, int64_t maxAgeMillis) {
+    std::lock_guard<std::recursive_mutex> lock(mapDescriptionMutex);
+    this->packedTileStore = packedTileStore;
+    this->packedTileMaxAgeMillis = maxAgeMillis;
+}
+
+void Tiled2dMapVectorLayer::setLineSimplificationTolerance(float tolerancePixels) {
+    std::lock_guard<std::recursive_mutex> lock(mapDescriptionMutex);
+    this->lineSimplificationTolerance = tolerancePixels;
+}
+
 void Tiled2dMapVectorLayer::updateReadyStateListenerIfNeeded() {
+    notifyReadyStateObserver();
+
     const auto listener = readyStateListener;
     if (!listener) {
         return;
@@ -297,11 +297,13 @@ Tiled2dMapVectorLayerParserResult Tiled2dMapVectorLayerParserHelper::parseStyleJ
     std::shared_ptr<Value> globalIsInteractable;
     bool persistingSymbolPlacement = false;
     std::optional<bool> use3xSprites;
+    bool batchTileGeometry = false;
 
     if(json["metadata"].is_object()) {
         metadata = json["metadata"].dump();
         globalIsInteractable = parser.parseValue(json["metadata"]["interactable"]);
         persistingSymbolPlacement = json["metadata"].value("persistingSymbolPlacement", false);
+        batchTileGeometry = json["metadata"].value("batchTileGeometry", false);
         
         // XXX: make this a per sprite option?
         if (json["metadata"].contains("use3xSprites")) {
@@ -589,6 +591,7 @@ Tiled2dMapVectorLayerParserResult Tiled2dMapVectorLayerParserHelper::parseStyleJ
                                                           sprites,
                                                           geojsonSources,
                                                           persistingSymbolPlacement,
-                                                          use3xSprites);
+                                                          use3xSprites,
+                                                          batchTileGeometry);
     return Tiled2dMapVectorLayerParserResult(mapDesc, LoaderStatus::OK, "", metadata);
 };
@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "Tiled2dMapVectorPackedTile.h"
+#include "Value.h"
+#include "VectorTileGeometryHandler.h"
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+
+namespace {
+
+class PackWriter {
+  public:
+    template <typename T> void write(T value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const size_t pos = buffer.size();
+        buffer.resize(pos + sizeof(T));
+        std::memcpy(buffer.data() + pos, &value, sizeof(T));
+    }
+
+    template <typename T> void writeArray(const std::vector<T> &values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        write((uint32_t)values.size());
+        const size_t pos = buffer.size();
+        buffer.resize(pos + values.size() * sizeof(T));
+        if (!values.empty()) {
+            std::memcpy(buffer.data() + pos, values.data(), values.size() * sizeof(T));
+        }
+    }
+
+    void writeString(const std::string &value) {
+        write((uint32_t)value.size());
+        buffer.insert(buffer.end(), value.begin(), value.end());
+    }
+
+    std::vector<uint8_t> buffer;
+};
+
+class PackReader {
+  public:
+    PackReader(const uint8_t *data, size_t size)
+        : pos(data)
+        , end(data + size) {}
+
+    template <typename T> T read() {
+        T value{};
+        if (!ensure(sizeof(T))) {
+            return value;
+        }
+        std::memcpy(&value, pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    template <typename T> std::vector<T> readArray() {
+        const auto count = read<uint32_t>();
+        if (!ensure((size_t)count * sizeof(T))) {
+            return {};
+        }
+        std::vector<T> values(count);
+        if (count > 0) {
+            std::memcpy(values.data(), pos, count * sizeof(T));
+        }
+        pos += count * sizeof(T);
+        return values;
+    }
+
+    // Vec2D is not default constructible
+    std::vector<::Vec2D> readCoordinates() {
+        const auto count = read<uint32_t>();
+        if (!ensure((size_t)count * 2 * sizeof(double))) {
+            return {};
+        }
+        std::vector<::Vec2D> coordinates;
+        coordinates.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            double xy[2];
+            std::memcpy(xy, pos, sizeof(xy));
+            pos += sizeof(xy);
+            coordinates.emplace_back(xy[0], xy[1]);
+        }
+        return coordinates;
+    }
+
+    std::string readString() {
+        const auto length = read<uint32_t>();
+        if (!ensure(length)) {
+            return {};
+        }
+        std::string value((const char *)pos, length);
+        pos += length;
+        return value;
+    }
+
+    bool failed = false;
+
+  private:
+    bool ensure(size_t size) {
+        if (failed || (size_t)(end - pos) < size) {
+            failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    const uint8_t *pos;
+    const uint8_t *end;
+};
+
+void writeValue(PackWriter &writer, const ValueVariant &value) {
+    writer.write((uint8_t)value.index());
+    std::visit(overloaded{[&](const std::string &val) { writer.writeString(val); },
+                          [&](double val) { writer.write(val); },
+                          [&](int64_t val) { writer.write(val); },
+                          [&](bool val) { writer.write((uint8_t)val); },
+                          [&](const Color &val) {
+                              writer.write(val.r);
+                              writer.write(val.g);
+                              writer.write(val.b);
+                              writer.write(val.a);
+                          },
+                          [&](const std::vector<float> &val) { writer.writeArray(val); },
+                          [&](const std::vector<std::string> &val) {
+                              writer.write((uint32_t)val.size());
+                              for (const auto &string : val) {
+                                  writer.writeString(string);
+                              }
+                          },
+                          [&](const std::vector<FormattedStringEntry> &val) {
+                              writer.write((uint32_t)val.size());
+                              for (const auto &entry : val) {
+                                  writer.writeString(entry.text);
+                                  writer.write(entry.scale);
+                              }
+                          },
+                          [&](const std::monostate &val) {}},
+               value);
+}
+
+ValueVariant readValue(PackReader &reader) {
+    switch (reader.read<uint8_t>()) {
+    case 0:
+        return reader.readString();
+    case 1:
+        return reader.read<double>();
+    case 2:
+        return reader.read<int64_t>();
+    case 3:
+        return reader.read<uint8_t>() != 0;
+    case 4: {
+        const auto r = reader.read<float>();
+        const auto g = reader.read<float>();
+        const auto b = reader.read<float>();
+        const auto a = reader.read<float>();
+        return Color(r, g, b, a);
+    }
+    case 5:
+        return reader.readArray<float>();
+    case 6: {
+        const auto count = reader.read<uint32_t>();
+        std::vector<std::string> strings;
+        for (uint32_t i = 0; i < count && !reader.failed; i++) {
+            strings.push_back(reader.readString());
+        }
+        return strings;
+    }
+    case 7: {
+        const auto count = reader.read<uint32_t>();
+        std::vector<FormattedStringEntry> entries;
+        for (uint32_t i = 0; i < count && !reader.failed; i++) {
+            auto text = reader.readString();
+            entries.emplace_back(std::move(text), reader.read<float>());
+        }
+        return entries;
+    }
+    case 8:
+        return std::monostate();
+    default:
+        reader.failed = true;
+        return std::monostate();
+    }
+}
+
+} // namespace
+
+std::vector<uint8_t> Tiled2dMapVectorPackedTile::pack(const Tiled2dMapVectorTileInfo::FeatureMap &featureMap,
+                                                      const StringInterner &stringTable) {
+    PackWriter writer;
+    writer.write(magic);
+    writer.write(version);
+
+    // property keys are interned per layer, the packed tile has its own key table
+    std::vector<InternedString> keys;
+    std::unordered_map<InternedString, uint32_t> keyIndices;
+    for (const auto &[layerName, features] : *featureMap) {
+        for (const auto &[featureContext, geometryHandler] : *features) {
+            for (const auto &[key, value] : featureContext->propertiesMap) {
+                if (keyIndices.emplace(key, (uint32_t)keys.size()).second) {
+                    keys.push_back(key);
+                }
+            }
+        }
+    }
+    writer.write((uint32_t)keys.size());
+    for (const auto &key : keys) {
+        writer.writeString(stringTable.get(key));
+    }
+
+    writer.write((uint32_t)featureMap->size());
+    for (const auto &[layerName, features] : *featureMap) {
+        writer.writeString(layerName);
+        writer.write((uint32_t)features->size());
+        for (const auto &[featureContext, geometryHandler] : *features) {
+            writer.write((uint8_t)featureContext->geomType);
+            writer.write((uint8_t)featureContext->hasCustomId);
+            writer.write(featureContext->identifier);
+            writer.write((uint32_t)featureContext->propertiesMap.size());
+            for (const auto &[key, value] : featureContext->propertiesMap) {
+                writer.write(keyIndices.at(key));
+                writeValue(writer, value);
+            }
+
+            const auto &coordinates = geometryHandler->getPointCoordinates();
+            writer.write((uint32_t)coordinates.size());
+            for (const auto &line : coordinates) {
+                writer.writeArray(line);
+            }
+            const auto &polygons = geometryHandler->getPolygons();
+            writer.write((uint32_t)polygons.size());
+            for (const auto &polygon : polygons) {
+                writer.writeArray(polygon.coordinates);
+                writer.writeArray(polygon.indices);
+            }
+        }
+    }
+    return std::move(writer.buffer);
+}
+
+Tiled2dMapVectorTileInfo::FeatureMap
+Tiled2dMapVectorPackedTile::unpack(const uint8_t *data, size_t size, const ::RectCoord &tileBounds, StringInterner &stringTable,
+                                   const std::shared_ptr<CoordinateConversionHelperInterface> &conversionHelper) {
+    PackReader reader(data, size);
+    if (reader.read<uint32_t>() != magic || reader.read<uint32_t>() != version) {
+        return nullptr;
+    }
+
+    const auto numKeys = reader.read<uint32_t>();
+    std::vector<std::string> keyStrings;
+    for (uint32_t i = 0; i < numKeys && !reader.failed; i++) {
+        keyStrings.push_back(reader.readString());
+    }
+    std::vector<InternedString> keys;
+    keys.reserve(keyStrings.size());
+    stringTable.add(keyStrings.begin(), keyStrings.end(), std::back_inserter(keys));
+
+    auto featureMap = std::make_shared<std::unordered_map<std::string, std::shared_ptr<std::vector<Tiled2dMapVectorTileInfo::FeatureTuple>>>>();
+    const auto numLayers = reader.read<uint32_t>();
+    for (uint32_t layerIndex = 0; layerIndex < numLayers && !reader.failed; layerIndex++) {
+        auto layerName = reader.readString();
+        const auto numFeatures = reader.read<uint32_t>();
+        auto features = std::make_shared<std::vector<Tiled2dMapVectorTileInfo::FeatureTuple>>();
+        features->reserve(std::min(numFeatures, (uint32_t)(size / 8)));
+
+        for (uint32_t featureIndex = 0; featureIndex < numFeatures && !reader.failed; featureIndex++) {
+            auto featureContext = std::make_shared<FeatureContext>();
+            featureContext->geomType = (vtzero::GeomType)reader.read<uint8_t>();
+            featureContext->hasCustomId = reader.read<uint8_t>() != 0;
+            featureContext->identifier = reader.read<uint64_t>();
+            const auto numProperties = reader.read<uint32_t>();
+            for (uint32_t i = 0; i < numProperties && !reader.failed; i++) {
+                const auto keyIndex = reader.read<uint32_t>();
+                if (keyIndex >= keys.size()) {
+                    return nullptr;
+                }
+                featureContext->propertiesMap.emplace_back(keys[keyIndex], readValue(reader));
+            }
+
+            const auto numLines = reader.read<uint32_t>();
+            std::vector<std::vector<::Vec2D>> coordinates;
+            for (uint32_t i = 0; i < numLines && !reader.failed; i++) {
+                coordinates.push_back(reader.readCoordinates());
+            }
+            const auto numPolygons = reader.read<uint32_t>();
+            std::vector<VectorTileGeometryHandler::TriangulatedPolygon> polygons;
+            for (uint32_t i = 0; i < numPolygons && !reader.failed; i++) {
+                auto polygonCoordinates = reader.readCoordinates();
+                auto indices = reader.readArray<uint16_t>();
+                polygons.emplace_back(std::move(polygonCoordinates), std::move(indices));
+            }
+
+            auto geometryHandler =
+                std::make_shared<VectorTileGeometryHandler>(tileBounds, std::move(coordinates), std::move(polygons), conversionHelper);
+            features->push_back({featureContext, geometryHandler});
+        }
+        featureMap->emplace(std::move(layerName), std::move(features));
+    }
+
+    if (reader.failed) {
+        return nullptr;
+    }
+    return featureMap;
+}
@@ -9,11 +9,15 @@
  */
 
 #include "Tiled2dMapVectorSource.h"
+#include "CoalescingLoader.h"
+#include "DateHelper.h"
 #include "Logger.h"
 #include "PerformanceLogger.h"
 #include "Tiled2dMapVectorLayer.h"
+#include "Tiled2dMapVectorPackedTile.h"
 #include "Tiled2dMapVectorTileInfo.h"
 #include "vtzero/vector_tile.hpp"
+#include <stdexcept>
 
 Tiled2dMapVectorSource::Tiled2dMapVectorSource(const MapConfig &mapConfig,
                                                const std::weak_ptr<StringInterner> &stringTable,
@@ -25,9 +29,14 @@ Tiled2dMapVectorSource::Tiled2dMapVectorSource(const MapConfig &mapConfig,
                                                const std::unordered_set<std::string> &layersToDecode,
                                                const std::string &sourceName,
                                                float screenDensityPpi,
-                                               std::string layerName)
+                                               std::string layerName,
+                                               const std::shared_ptr<Tiled2dMapVectorDecodedTileCache> &decodedTileCache,
+                                               const std::shared_ptr<TilePackFile> &packedTileStore,
+                                               int64_t packedTileMaxAgeMillis,
+                                               float lineSimplificationTolerance)
         : Tiled2dMapSource<std::shared_ptr<DataLoaderResult>, Tiled2dMapVectorTileInfo::FeatureMap>(mapConfig, layerConfig, conversionHelper, scheduler, screenDensityPpi, tileLoaders.size(), layerName),
-loaders(tileLoaders), layersToDecode(layersToDecode), listener(listener), sourceName(sourceName), stringTable(stringTable) {}
+loaders(CoalescingLoader::wrap(tileLoaders)), layersToDecode(layersToDecode), listener(listener), sourceName(sourceName), stringTable(stringTable), decodedTileCache(decodedTileCache),
+packedTileStore(packedTileStore), packedTileMaxAgeMillis(packedTileMaxAgeMillis), lineSimplificationTolerance(lineSimplificationTolerance) {}
 
 ::djinni::Future<std::shared_ptr<DataLoaderResult>> Tiled2dMapVectorSource::loadDataAsync(Tiled2dMapTileInfo tile, size_t loaderIndex) {
     {
@@ -36,6 +45,37 @@ loaders(tileLoaders), layersToDecode(layersToDecode), listener(listener), source
     }
     auto const url = layerConfig->getTileUrl(tile.x, tile.y, tile.t, tile.zoomIdentifier);
     auto promise = std::make_shared<::djinni::Promise<std::shared_ptr<DataLoaderResult>>>();
+
+    auto strongStringTable = stringTable.lock();
+    if (decodedTileCache && strongStringTable) {
+        auto featureMap = decodedTileCache->get(getDecodedTileKey(url), strongStringTable);
+        if (featureMap) {
+            {
+                std::lock_guard<std::mutex> lock_guard(loadingTilesMutex);
+                cachedFeatureMaps[tile] = featureMap;
+            }
+            // no need to load the data, postLoadingTask returns the cached tile
+            promise->setValue(std::make_shared<DataLoaderResult>(std::nullopt, std::nullopt, LoaderStatus::OK, std::nullopt));
+            return promise->getFuture();
+        }
+    }
+
+    if (packedTileStore) {
+        auto packedTile = packedTileStore->get(getPackedTileKey(url));
+        const bool isFresh = packedTile && DateHelper::currentTimeMillis() - packedTile->storedAt < packedTileMaxAgeMillis;
+        PERF_LOG_COUNT(sourceName + "_packedTileHits", isFresh ? 1 : 0);
+        if (isFresh) {
+            {
+                std::lock_guard<std::mutex> lock_guard(loadingTilesMutex);
+                packedTiles.insert(tile);
+            }
+            // postLoadingTask unpacks the tile instead of decoding it
+            promise->setValue(std::make_shared<DataLoaderResult>(::djinni::DataRef(std::move(packedTile->data)), std::nullopt,
+                                                                 LoaderStatus::OK, std::nullopt));
+            return promise->getFuture();
+        }
+    }
+
     loaders[loaderIndex]->loadDataAsync(url, std::nullopt).then([promise](::djinni::Future<::DataLoaderResult> result) {
         promise->setValue(std::make_shared<DataLoaderResult>(result.get()));
     });
@@ -46,6 +86,9 @@ void Tiled2dMapVectorSource::cancelLoad(Tiled2dMapTileInfo tile, size_t loaderIn
     {
         std::lock_guard<std::mutex> lock_guard(loadingTilesMutex);
         loadingTiles.erase(tile);
+        if (cachedFeatureMaps.erase(tile) > 0 || packedTiles.erase(tile) > 0) {
+            return;
+        }
     }
     auto const url = layerConfig->getTileUrl(tile.x, tile.y, tile.t, tile.zoomIdentifier);
     loaders[loaderIndex]->cancel(url);
@@ -95,6 +138,36 @@ static std::shared_ptr<FeatureContext> convertToFeatureContext(const vtzero::fea
 }
 
 Tiled2dMapVectorTileInfo::FeatureMap Tiled2dMapVectorSource::postLoadingTask(std::shared_ptr<DataLoaderResult> loadedData, Tiled2dMapTileInfo tile) {
+    {
+        std::lock_guard<std::mutex> lock_guard(loadingTilesMutex);
+        auto cachedIt = cachedFeatureMaps.find(tile);
+        if (cachedIt != cachedFeatureMaps.end()) {
+            auto featureMap = std::move(cachedIt->second);
+            cachedFeatureMaps.erase(cachedIt);
+            loadingTiles.erase(tile);
+            return featureMap;
+        }
+    }
+
+    bool isPackedTile;
+    {
+        std::lock_guard<std::mutex> lock_guard(loadingTilesMutex);
+        isPackedTile = packedTiles.erase(tile) > 0;
+    }
+    if (isPackedTile) {
+        if (auto featureMap = unpackTile(loadedData, tile)) {
+            return featureMap;
+        }
+        // the packed tile is unusable, the tile fails and is loaded again through the loaders on the retry
+        auto const url = layerConfig->getTileUrl(tile.x, tile.y, tile.t, tile.zoomIdentifier);
+        packedTileStore->remove(getPackedTileKey(url));
+        {
+            std::lock_guard<std::mutex> lock_guard(loadingTilesMutex);
+            loadingTiles.erase(tile);
+        }
+        throw std::runtime_error("invalid packed tile");
+    }
+
     PERF_LOG_START(sourceName + "_postLoadingTask");
     auto layerFeatureMap = std::make_shared<std::unordered_map<std::string, std::shared_ptr<std::vector<Tiled2dMapVectorTileInfo::FeatureTuple>>>>();
     
@@ -110,6 +183,10 @@ Tiled2dMapVectorTileInfo::FeatureMap Tiled2dMapVectorSource::postLoadingTask(std
         return layerFeatureMap;
     }
 
+    size_t numLineVertices = 0;
+    size_t numRemovedLineVertices = 0;
+    // a tile that could only be decoded partially is not stored
+    bool decodeFailed = false;
     try {
         vtzero::vector_tile tileData((char*)loadedData->data->buf(), loadedData->data->len());
 
@@ -120,6 +197,7 @@ Tiled2dMapVectorTileInfo::FeatureMap Tiled2dMapVectorSource::postLoadingTask(std
             std::string sourceLayerName = std::string(layer.name());
             if ((layersToDecode.empty() || layersToDecode.count(sourceLayerName) > 0) && !layer.empty()) {
                 int extent = (int) layer.extent();
+                const double lineTolerance = getLineSimplificationTolerance(tile, extent);
                 layerFeatureMap->emplace(sourceLayerName, std::make_shared<std::vector<Tiled2dMapVectorTileInfo::FeatureTuple>>());
                 layerFeatureMap->at(sourceLayerName)->reserve(layer.num_features());
 
@@ -136,7 +214,7 @@ Tiled2dMapVectorTileInfo::FeatureMap Tiled2dMapVectorSource::postLoadingTask(std
                     auto const featureContext = convertToFeatureContext(feature, layer, internedLayerKeys);
                     PERF_LOG_START(sourceLayerName + "_decode");
                     try {
-                        std::shared_ptr<VectorTileGeometryHandler> geometryHandler = std::make_shared<VectorTileGeometryHandler>(tile.bounds, extent, layerConfig->getVectorSettings(), conversionHelper);
+                        std::shared_ptr<VectorTileGeometryHandler> geometryHandler = std::make_shared<VectorTileGeometryHandler>(tile.bounds, extent, layerConfig->getVectorSettings(), conversionHelper, lineTolerance);
                         vtzero::decode_geometry(feature.geometry(), *geometryHandler);
                         size_t polygonCount = geometryHandler->beginTriangulatePolygons();
                         for (size_t i = 0; i < polygonCount; i++) {
@@ -150,6 +228,8 @@ Tiled2dMapVectorTileInfo::FeatureMap Tiled2dMapVectorSource::postLoadingTask(std
                         }
 
                         geometryHandler->endTringulatePolygons();
+                        numLineVertices += geometryHandler->getNumLineVertices();
+                        numRemovedLineVertices += geometryHandler->getNumRemovedLineVertices();
                         layerFeatureMap->at(sourceLayerName)->push_back({featureContext, geometryHandler});
                     } catch (const vtzero::geometry_exception &geometryException) {
                         LogError <<= "geometryException for tile " + std::to_string(tile.zoomIdentifier) + "/" + std::to_string(tile.x) + "/" + std::to_string(tile.y);
@@ -164,23 +244,87 @@ Tiled2dMapVectorTileInfo::FeatureMap Tiled2dMapVectorSource::postLoadingTask(std
         }
     }
     catch (const protozero::invalid_tag_exception &tagException) {
+        decodeFailed = true;
         LogError <<= "Invalid tag exception for tile " + std::to_string(tile.zoomIdentifier) + "/" +
         std::to_string(tile.x) + "/" + std::to_string(tile.y);
     }
     catch (const protozero::unknown_pbf_wire_type_exception &typeException) {
+        decodeFailed = true;
         LogError <<= "Unknown wire type exception for tile " + std::to_string(tile.zoomIdentifier) + "/" +
         std::to_string(tile.x) + "/" + std::to_string(tile.y);
     }
     PERF_LOG_START(sourceName + "_postLoadingTask");
+    PERF_LOG_COUNT(sourceName + "_lineVertices", numLineVertices);
+    PERF_LOG_COUNT(sourceName + "_removedLineVertices", numRemovedLineVertices);
 
     {
         std::lock_guard<std::mutex> lock_guard(loadingTilesMutex);
         loadingTiles.erase(tile);
     }
 
+    if (decodedTileCache && !decodeFailed) {
+        auto const url = layerConfig->getTileUrl(tile.x, tile.y, tile.t, tile.zoomIdentifier);
+        decodedTileCache->put(getDecodedTileKey(url), strongStringTable, layerFeatureMap);
+    }
+
+    if (packedTileStore && !decodeFailed) {
+        auto const url = layerConfig->getTileUrl(tile.x, tile.y, tile.t, tile.zoomIdentifier);
+        auto packedTile = Tiled2dMapVectorPackedTile::pack(layerFeatureMap, stringTable);
+        packedTileStore->put(getPackedTileKey(url), packedTile.data(), packedTile.size(), std::nullopt, DateHelper::currentTimeMillis());
+    }
+
     return layerFeatureMap;
 }
 
+Tiled2dMapVectorTileInfo::FeatureMap Tiled2dMapVectorSource::unpackTile(const std::shared_ptr<DataLoaderResult> &loadedData, const Tiled2dMapTileInfo &tile) {
+    auto strongStringTable = stringTable.lock();
+    if (!strongStringTable || !loadedData->data.has_value()) {
+        return nullptr;
+    }
+
+    PERF_LOG_START(sourceName + "_unpackTile");
+    auto featureMap = Tiled2dMapVectorPackedTile::unpack(loadedData->data->buf(), loadedData->data->len(), tile.bounds,
+                                                         *strongStringTable, conversionHelper);
+    PERF_LOG_END(sourceName + "_unpackTile");
+    if (!featureMap) {
+        LogError <<= "Invalid packed tile " + std::to_string(tile.zoomIdentifier) + "/" + std::to_string(tile.x) + "/" + std::to_string(tile.y);
+        return nullptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock_guard(loadingTilesMutex);
+        loadingTiles.erase(tile);
+    }
+
+    if (decodedTileCache) {
+        auto const url = layerConfig->getTileUrl(tile.x, tile.y, tile.t, tile.zoomIdentifier);
+        decodedTileCache->put(getDecodedTileKey(url), strongStringTable, featureMap);
+    }
+    return featureMap;
+}
+
+double Tiled2dMapVectorSource::getLineSimplificationTolerance(const Tiled2dMapTileInfo &tile, int extent) const {
+    // the most detailed level may be shown overzoomed, its lines are kept as they are
+    if (lineSimplificationTolerance <= 0.0 || zoomLevelInfos.empty() || tile.zoomIdentifier >= zoomLevelInfos.back().zoomLevelIdentifier) {
+        return 0.0;
+    }
+    // a tile is shown at up to twice its nominal size of 256 pixels before the next level replaces it
+    return lineSimplificationTolerance * extent / 512.0;
+}
+
+std::string Tiled2dMapVectorSource::getDecodedTileKey(const std::string &url) const {
+    auto key = Tiled2dMapVectorDecodedTileCache::createKey(url, layersToDecode);
+    if (lineSimplificationTolerance > 0.0) {
+        key += "\nsimplified " + std::to_string(lineSimplificationTolerance);
+    }
+    return key;
+}
+
+std::string Tiled2dMapVectorSource::getPackedTileKey(const std::string &url) const {
+    return "packed-v" + std::to_string(Tiled2dMapVectorPackedTile::version) + " " +
+           getDecodedTileKey(url);
+}
+
 void Tiled2dMapVectorSource::notifyTilesUpdates() {
     listener.message(MFN(&Tiled2dMapVectorSourceListener::onTilesUpdated), sourceName, getCurrentTiles());
 }
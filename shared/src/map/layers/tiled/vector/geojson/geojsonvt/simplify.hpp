@@ -1,9 +1,14 @@
 #pragma once
 
 #include "Coord.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
 // square distance from a point to a segment
-inline double getSqSegDist(const Coord& p, const Coord& a, const Coord& b) {
+template <class Point>
+inline double getSqSegDist(const Point& p, const Point& a, const Point& b) {
     double x = a.x;
     double y = a.y;
     double dx = b.x - a.x;
@@ -75,3 +80,58 @@ inline void simplify(std::vector<Coord>& points, double tolerance) {
 
     simplify(points, 0, len - 1, tolerance * tolerance);
 }
+
+// same Douglas-Peucker simplification, marking the retained points instead of storing their importance
+template <class Point>
+inline void simplifyLine(const std::vector<Point>& points, size_t first, size_t last, double sqTolerance, std::vector<bool>& retained) {
+    double maxSqDist = sqTolerance;
+    size_t index = 0;
+    const int64_t mid = (first + (last - first)) >> 1;
+    int64_t minPosToMid = last - first;
+
+    for (auto i = first + 1; i < last; i++) {
+        const double sqDist = getSqSegDist(points[i], points[first], points[last]);
+
+        if (sqDist > maxSqDist) {
+            index = i;
+            maxSqDist = sqDist;
+
+        } else if (sqDist == maxSqDist) {
+            auto posToMid = std::abs(static_cast<int64_t>(i) - mid);
+            if (posToMid < minPosToMid) {
+                index = i;
+                minPosToMid = posToMid;
+            }
+        }
+    }
+
+    if (maxSqDist > sqTolerance) {
+        retained[index] = true;
+        if (index - first > 1)
+            simplifyLine(points, first, index, sqTolerance, retained);
+        if (last - index > 1)
+            simplifyLine(points, index, last, sqTolerance, retained);
+    }
+}
+
+// removes the points of a line closer than tolerance to the simplified line, returns the number of removed points
+template <class Point>
+inline size_t simplifyLine(std::vector<Point>& points, double tolerance) {
+    const size_t len = points.size();
+    if (len <= 2) return 0;
+
+    std::vector<bool> retained(len, false);
+    retained[0] = true;
+    retained[len - 1] = true;
+
+    simplifyLine(points, 0, len - 1, tolerance * tolerance, retained);
+
+    size_t count = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (retained[i]) {
+            points[count++] = points[i];
+        }
+    }
+    points.erase(points.begin() + count, points.end());
+    return len - count;
+}
@@ -13,6 +13,8 @@
 #include "Tiled2dMapVectorPolygonTile.h"
 #include "Tiled2dMapVectorPolygonPatternTile.h"
 #include "Tiled2dMapVectorLineTile.h"
+#include "Tiled2dMapVectorLineGeometryBatch.h"
+#include "Tiled2dMapVectorPolygonGeometryBatch.h"
 #include "Tiled2dMapVectorLayer.h"
 #include "RenderPass.h"
 #include "PerformanceLogger.h"
@@ -43,11 +45,16 @@ void Tiled2dMapVectorSourceTileDataManager::update() {
             PERF_LOG_END(identifier + "_update");
         }
     }
+
+    if (geometryBatchManager) {
+        geometryBatchManager->updateStyles();
+    }
 }
 
 
 void Tiled2dMapVectorSourceTileDataManager::pregenerateRenderPasses() {
     std::vector<std::shared_ptr<Tiled2dMapVectorLayer::TileRenderDescription>> renderDescriptions;
+    std::unordered_map<Tiled2dMapVersionedTileInfo, std::shared_ptr<MaskingObjectInterface>> batchedTiles;
     bool maskTile = layerConfig->getZoomInfo().maskTile;
     for (const auto &[tile, subTiles] : tileRenderObjectsMap) {
         if (tilesReady.count(tile) == 0) {
@@ -70,6 +77,10 @@ void Tiled2dMapVectorSourceTileDataManager::pregenerateRenderPasses() {
         const std::shared_ptr<MaskingObjectInterface> &mask = maskTile ? tileMaskWrapper->second.getGraphicsMaskObject() : nullptr;
         assert(!mask || mask->asGraphicsObject()->isReady());
         for (const auto &[layerIndex, renderObjects]: subTiles) {
+            if (geometryBatchManager && geometryBatchManager->isBatched(tile, layerIndex)) {
+                batchedTiles[tile] = mask;
+                continue;
+            }
             const bool modifiesMask = modifyingMaskLayers.find(layerIndex) != modifyingMaskLayers.end();
             const bool selfMasked = selfMaskedLayers.find(layerIndex) != selfMaskedLayers.end();
             const auto optRenderPassIndex = mapDescription->layers[layerIndex]->renderPassIndex;
@@ -77,6 +88,21 @@ void Tiled2dMapVectorSourceTileDataManager::pregenerateRenderPasses() {
             renderDescriptions.push_back(std::make_shared<Tiled2dMapVectorLayer::TileRenderDescription>(Tiled2dMapVectorLayer::TileRenderDescription{layerIndex, sourceHash, tile.tileInfo.zoomIdentifier, renderObjects, mask, modifiesMask, selfMasked, renderPassIndex}));
         }
     }
+
+    if (geometryBatchManager) {
+        const auto batchDescriptions = geometryBatchManager->prepareRenderDescriptions(batchedTiles);
+        if (!batchDescriptions) {
+            // the render passes are updated once the batches are uploaded
+            auto selfActor = WeakActor(mailbox, weak_from_this());
+            selfActor.message(MailboxExecutionEnvironment::graphics, MFN(&Tiled2dMapVectorSourceTileDataManager::uploadGeometryBatches));
+            return;
+        }
+        for (const auto &description: *batchDescriptions) {
+            const auto optRenderPassIndex = mapDescription->layers[description.layerIndex]->renderPassIndex;
+            const int32_t renderPassIndex = optRenderPassIndex ? *optRenderPassIndex : 0;
+            renderDescriptions.push_back(std::make_shared<Tiled2dMapVectorLayer::TileRenderDescription>(Tiled2dMapVectorLayer::TileRenderDescription{description.layerIndex, sourceHash, description.zoomIdentifier, description.renderObjects, description.mask, false, false, renderPassIndex}));
+        }
+    }
     vectorLayer.syncAccess([source = this->source, &renderDescriptions](const auto &layer){
         if(auto strong = layer.lock()) {
             strong->onRenderPassUpdate(source, false, renderDescriptions);
@@ -84,6 +110,40 @@ void Tiled2dMapVectorSourceTileDataManager::pregenerateRenderPasses() {
     });
 }
 
+void Tiled2dMapVectorSourceTileDataManager::uploadGeometryBatches() {
+    auto mapInterface = this->mapInterface.lock();
+    auto renderingContext = mapInterface ? mapInterface->getRenderingContext() : nullptr;
+    if (!renderingContext || !geometryBatchManager) {
+        return;
+    }
+
+    geometryBatchManager->upload(renderingContext);
+    pregenerateRenderPasses();
+    mapInterface->invalidate();
+}
+
+bool Tiled2dMapVectorSourceTileDataManager::canBatchGeometry() {
+    // all tile masks of a source need to be mutually exclusive for the layer to group the render passes by mask,
+    // this only holds for the batch masks if no other tiles of this source are rendered with their own mask
+    for (const auto &layer: mapDescription->layers) {
+        if (layer->source != source || layer->getType() == VectorLayerType::symbol) {
+            continue;
+        }
+        if (layer->selfMasked) {
+            return false;
+        }
+        if (layer->getType() == VectorLayerType::line) {
+            continue;
+        }
+        if (layer->getType() == VectorLayerType::polygon &&
+            !std::static_pointer_cast<PolygonVectorLayerDescription>(layer)->style.hasPatternPotentially()) {
+            continue;
+        }
+        return false;
+    }
+    return true;
+}
+
 void Tiled2dMapVectorSourceTileDataManager::pause() {
     for (const auto &tileMask: tileMaskMap) {
         if (tileMask.second.getGraphicsObject() &&
@@ -100,6 +160,10 @@ void Tiled2dMapVectorSourceTileDataManager::pause() {
         }
     }
 
+    if (geometryBatchManager) {
+        geometryBatchManager->clear();
+    }
+
     tilesReady.clear();
     tilesReadyControlSet.clear();
     tileRenderObjectsMap.clear();
@@ -208,6 +272,10 @@ void Tiled2dMapVectorSourceTileDataManager::updateMaskObjects() {
             tilesReady.erase(tileToRemove);
             tilesReadyControlSet.erase(tileToRemove);
             tileRenderObjectsMap.erase(tileToRemove);
+
+            if (geometryBatchManager) {
+                geometryBatchManager->removeTile(tileToRemove);
+            }
         }
 
         std::unordered_set<Tiled2dMapVersionedTileInfo> localToRemove = std::unordered_set(tilesToRemove);
@@ -234,6 +302,10 @@ Actor<Tiled2dMapVectorTile> Tiled2dMapVectorSourceTileDataManager::createTileAct
     auto castedMe = std::static_pointer_cast<Tiled2dMapVectorLayerTileCallbackInterface>(shared_from_this());
     auto selfActor = WeakActor<Tiled2dMapVectorLayerTileCallbackInterface>(mailbox, castedMe);
 
+    const auto layerIndexIt = layerNameIndexMap.find(layerDescription->identifier);
+    const int32_t layerIndex = layerIndexIt != layerNameIndexMap.end() ? layerIndexIt->second : -1;
+    std::shared_ptr<Tiled2dMapVectorGeometryBatch> geometryBatch = nullptr;
+
     switch (layerDescription->getType()) {
         case VectorLayerType::background: {
             break;
@@ -241,11 +313,22 @@ Actor<Tiled2dMapVectorTile> Tiled2dMapVectorSourceTileDataManager::createTileAct
         case VectorLayerType::line: {
             auto mailbox = std::make_shared<Mailbox>(mapInterface->getScheduler());
 
+            auto lineDescription = std::static_pointer_cast<LineVectorLayerDescription>(layerDescription);
+            std::shared_ptr<Tiled2dMapVectorLineGeometryBatch> lineBatch = nullptr;
+            if (geometryBatchManager && layerIndex >= 0) {
+                lineBatch = std::dynamic_pointer_cast<Tiled2dMapVectorLineGeometryBatch>(geometryBatchManager->registerTile(layerIndex, tileInfo, [&]() {
+                    return std::make_shared<Tiled2dMapVectorLineGeometryBatch>(mapInterface->getGraphicsObjectFactory(), mapInterface->getShaderFactory(),
+                                                                               lineDescription->style.isSimpleLine(), mapInterface->is3d());
+                }));
+                geometryBatch = lineBatch;
+            }
+
             auto lineActor = Actor<Tiled2dMapVectorLineTile>(mailbox, (std::weak_ptr<MapInterface>) mapInterface, vectorLayer.unsafe(), tileInfo,
                                                              selfActor,
-                                                             std::static_pointer_cast<LineVectorLayerDescription>(layerDescription),
+                                                             lineDescription,
                                                              layerConfig,
-                                                             featureStateManager);
+                                                             featureStateManager,
+                                                             lineBatch);
 
             actor = lineActor.strongActor<Tiled2dMapVectorTile>();
             break;
@@ -262,9 +345,18 @@ Actor<Tiled2dMapVectorTile> Tiled2dMapVectorSourceTileDataManager::createTileAct
                                                                               featureStateManager);
                 actor = polygonActor.strongActor<Tiled2dMapVectorTile>();
             } else {
+                std::shared_ptr<Tiled2dMapVectorPolygonGeometryBatch> polygonBatch = nullptr;
+                if (geometryBatchManager && layerIndex >= 0) {
+                    polygonBatch = std::dynamic_pointer_cast<Tiled2dMapVectorPolygonGeometryBatch>(geometryBatchManager->registerTile(layerIndex, tileInfo, [&]() {
+                        return std::make_shared<Tiled2dMapVectorPolygonGeometryBatch>(mapInterface->getGraphicsObjectFactory(), mapInterface->getShaderFactory(),
+                                                                                      polygonDescription->style.isStripedPotentially(), mapInterface->is3d());
+                    }));
+                    geometryBatch = polygonBatch;
+                }
+
                 auto polygonActor = Actor<Tiled2dMapVectorPolygonTile>(mailbox, (std::weak_ptr<MapInterface>) mapInterface, vectorLayer.unsafe(),
                                                                        tileInfo, selfActor, polygonDescription, layerConfig,
-                                                                       featureStateManager);
+                                                                       featureStateManager, polygonBatch);
                 actor = polygonActor.strongActor<Tiled2dMapVectorTile>();
             }
 
@@ -290,6 +382,10 @@ Actor<Tiled2dMapVectorTile> Tiled2dMapVectorSourceTileDataManager::createTileAct
             break;
         }
     }
+    if (geometryBatchManager && !geometryBatch) {
+        // drop geometry of a replaced tile of this layer that was batched before
+        geometryBatchManager->removeTile(tileInfo, layerIndex);
+    }
     if (actor) {
         actor.unsafe()->setAlpha(alpha);
     }
@@ -12,6 +12,7 @@
 
 #include "Tiled2dMapVectorSourceDataManager.h"
 #include "SpriteData.h"
+#include "Tiled2dMapVectorGeometryBatchManager.h"
 
 class Tiled2dMapVectorLayer;
 
@@ -67,6 +68,10 @@ protected:
 
     virtual void pregenerateRenderPasses();
 
+    void uploadGeometryBatches();
+
+    bool canBatchGeometry();
+
     virtual void onTileCompletelyReady(const Tiled2dMapVersionedTileInfo &tileInfo) = 0;
 
     std::unordered_map<Tiled2dMapVersionedTileInfo, std::vector<std::tuple<int32_t, std::vector<std::shared_ptr<RenderObjectInterface>>>>> tileRenderObjectsMap;
@@ -89,4 +94,7 @@ protected:
     std::shared_ptr<TextureHolderInterface> spriteTexture;
 
     float alpha = 1.0;
+
+    // set if line and polygon tiles of this source are drawn from shared geometry batches
+    std::shared_ptr<Tiled2dMapVectorGeometryBatchManager> geometryBatchManager;
 };
@@ -23,7 +23,11 @@ Tiled2dMapVectorSourceVectorTileDataManager::Tiled2dMapVectorSourceVectorTileDat
                                                                                          const Actor<Tiled2dMapVectorReadyManager> &readyManager,
                                                                                          const std::shared_ptr<Tiled2dMapVectorStateManager> &featureStateManager)
 : Tiled2dMapVectorSourceTileDataManager(vectorLayer, mapDescription, layerConfig, source, readyManager, featureStateManager),
-vectorSource(vectorSource) {}
+vectorSource(vectorSource) {
+    if (mapDescription->batchTileGeometry && canBatchGeometry()) {
+        geometryBatchManager = std::make_shared<Tiled2dMapVectorGeometryBatchManager>();
+    }
+}
 
 void Tiled2dMapVectorSourceVectorTileDataManager::onVectorTilesUpdated(const std::string &sourceName,
                                                                        VectorSet<Tiled2dMapVectorTileInfo> currentTileInfos) {
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "Vec3D.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+// Position on a line: the segment starting at coordinate `index` and the fraction of that segment
+struct DistanceIndex {
+    int index;
+    double percentage;
+
+    DistanceIndex(int index_, double percentage_)
+    : index(std::move(index_))
+    , percentage(std::move(percentage_))
+    {}
+};
+
+/**
+ * Arc-length parameterization of a line: the distance along the line of each coordinate (only x and y are used).
+ * Moving along the line by a distance is a binary search in the cumulative distances instead of a walk over the
+ * coordinates, which labels placed along lines do several times per glyph.
+ */
+class LineArcLengthParameterization {
+public:
+    void update(const std::vector<Vec3D> &coordinates) {
+        cumulativeDistances.resize(coordinates.size());
+        double distance = 0.0;
+        for (size_t i = 0; i < coordinates.size(); i++) {
+            if (i > 0) {
+                const double dx = coordinates[i].x - coordinates[i - 1].x;
+                const double dy = coordinates[i].y - coordinates[i - 1].y;
+                distance += std::sqrt(dx * dx + dy * dy);
+            }
+            cumulativeDistances[i] = distance;
+        }
+    }
+
+    double length() const {
+        return cumulativeDistances.empty() ? 0.0 : cumulativeDistances.back();
+    }
+
+    double distanceAtIndex(const DistanceIndex &index) const {
+        if (index.index + 1 >= (int)cumulativeDistances.size()) {
+            return length();
+        }
+        const double start = cumulativeDistances[index.index];
+        return start + (cumulativeDistances[index.index + 1] - start) * index.percentage;
+    }
+
+    // Moves from index by distance along the line, towards the start of the line for negative distances. Moving past
+    // the end of the line results in the last coordinate, moving past the start in the first coordinate.
+    DistanceIndex indexAtDistance(const DistanceIndex &index, double distance) const {
+        const int count = (int)cumulativeDistances.size();
+        if (count < 2) {
+            return DistanceIndex(0, 0.0);
+        }
+
+        const double target = distanceAtIndex(index) + distance;
+        if (distance >= 0) {
+            if (target > cumulativeDistances.back()) {
+                return DistanceIndex(count - 1, 0.0);
+            }
+            // first segment ending at or after the target
+            const auto segmentEnd = std::lower_bound(cumulativeDistances.begin() + 1, cumulativeDistances.end(), target);
+            return indexInSegment((int)(segmentEnd - cumulativeDistances.begin()) - 1, target);
+        } else {
+            if (target < 0) {
+                return DistanceIndex(0, 0.0);
+            }
+            // last segment starting at or before the target
+            const auto segmentStart = std::upper_bound(cumulativeDistances.begin(), cumulativeDistances.end() - 1, target);
+            return indexInSegment((int)(segmentStart - cumulativeDistances.begin()) - 1, target);
+        }
+    }
+
+private:
+    DistanceIndex indexInSegment(int segment, double target) const {
+        const double start = cumulativeDistances[segment];
+        const double segmentLength = cumulativeDistances[segment + 1] - start;
+        const double percentage = segmentLength > 0.0 ? std::clamp((target - start) / segmentLength, 0.0, 1.0) : 0.0;
+        return DistanceIndex(segment, percentage);
+    }
+
+    std::vector<double> cumulativeDistances;
+};
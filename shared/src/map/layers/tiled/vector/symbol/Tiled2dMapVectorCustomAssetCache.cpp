@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "Tiled2dMapVectorCustomAssetCache.h"
+#include "PerformanceLogger.h"
+
+namespace {
+
+bool equalProperties(const std::unordered_map<std::string, VectorLayerFeatureInfoValue> &lhs,
+                     const std::unordered_map<std::string, VectorLayerFeatureInfoValue> &rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (const auto &[key, value]: lhs) {
+        auto it = rhs.find(key);
+        if (it == rhs.end()) {
+            return false;
+        }
+        const auto &other = it->second;
+        if (value.stringVal != other.stringVal || value.doubleVal != other.doubleVal || value.intVal != other.intVal ||
+            value.boolVal != other.boolVal || value.colorVal != other.colorVal || value.listFloatVal != other.listFloatVal ||
+            value.listStringVal != other.listStringVal) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+Tiled2dMapVectorCustomAssetCache::Tiled2dMapVectorCustomAssetCache(size_t maxRetainedPages)
+    : maxRetainedPages(maxRetainedPages) {}
+
+std::string Tiled2dMapVectorCustomAssetCache::createKey(const std::string &layerIdentifier, const std::string &featureIdentifier) {
+    std::string key = layerIdentifier;
+    key += '\n';
+    key += featureIdentifier;
+    return key;
+}
+
+std::vector<Tiled2dMapVectorAssetInfo> Tiled2dMapVectorCustomAssetCache::getCustomAssetsFor(
+    const std::shared_ptr<Tiled2dMapVectorLayerSymbolDelegateInterface> &delegate, const std::vector<VectorLayerFeatureInfo> &featureInfos,
+    const std::string &layerIdentifier) {
+    std::vector<Tiled2dMapVectorAssetInfo> result;
+    if (!delegate || featureInfos.empty()) {
+        return result;
+    }
+
+    std::unordered_map<uint64_t, size_t> resultIndexByPage;
+    std::vector<VectorLayerFeatureInfo> missingFeatureInfos;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        setDelegateLocked(delegate);
+
+        for (const auto &featureInfo: featureInfos) {
+            auto iconIt = icons.find(createKey(layerIdentifier, featureInfo.identifier));
+            std::shared_ptr<TextureHolderInterface> texture;
+            if (iconIt != icons.end() && equalProperties(iconIt->second.properties, featureInfo.properties)) {
+                texture = pages.at(iconIt->second.pageId).texture.lock();
+            }
+            if (!texture) {
+                missingFeatureInfos.push_back(featureInfo);
+                continue;
+            }
+
+            const auto pageId = iconIt->second.pageId;
+            auto resultIt = resultIndexByPage.find(pageId);
+            if (resultIt == resultIndexByPage.end()) {
+                auto &page = pages.at(pageId);
+                lruOrder.splice(lruOrder.begin(), lruOrder, page.lruIterator);
+                page.retainedTexture = texture;
+                resultIt = resultIndexByPage.emplace(pageId, result.size()).first;
+                result.emplace_back(std::unordered_map<std::string, ::RectI>(), texture);
+            }
+            result[resultIt->second].featureIdentifiersUv.emplace(featureInfo.identifier, iconIt->second.uv);
+        }
+
+        const auto numHits = (int64_t)(featureInfos.size() - missingFeatureInfos.size());
+        hits += numHits;
+        misses += (int64_t)missingFeatureInfos.size();
+        PERF_LOG_COUNT("Tiled2dMapVectorCustomAssetCache_hits", numHits);
+        PERF_LOG_COUNT("Tiled2dMapVectorCustomAssetCache_misses", (int64_t)missingFeatureInfos.size());
+
+        if (missingFeatureInfos.empty()) {
+            trimLocked();
+            return result;
+        }
+    }
+
+    // the delegate may be slow (e.g. drawing and packing the icons), it is called without holding the lock
+    auto newPages = delegate->getCustomAssetsFor(missingFeatureInfos, layerIdentifier);
+
+    std::unordered_map<std::string, const VectorLayerFeatureInfo *> missingFeatureInfoByIdentifier;
+    for (const auto &featureInfo: missingFeatureInfos) {
+        missingFeatureInfoByIdentifier.emplace(featureInfo.identifier, &featureInfo);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    // pages of a replaced delegate are not cached
+    const bool cachePages = this->delegate.lock() == delegate;
+
+    for (auto &newPage: newPages) {
+        if (cachePages && newPage.texture) {
+            const auto pageId = nextPageId++;
+            auto &page = pages[pageId];
+            page.texture = newPage.texture;
+            page.retainedTexture = newPage.texture;
+            page.iconArea = 0;
+            page.pageArea = (int64_t)newPage.texture->getImageWidth() * (int64_t)newPage.texture->getImageHeight();
+            lruOrder.push_front(pageId);
+            page.lruIterator = lruOrder.begin();
+
+            for (const auto &[identifier, uv]: newPage.featureIdentifiersUv) {
+                auto featureInfoIt = missingFeatureInfoByIdentifier.find(identifier);
+                if (featureInfoIt == missingFeatureInfoByIdentifier.end()) {
+                    continue;
+                }
+                auto key = createKey(layerIdentifier, identifier);
+                icons.insert_or_assign(key, Icon{pageId, uv, featureInfoIt->second->properties});
+                page.iconKeys.push_back(std::move(key));
+                page.iconArea += (int64_t)uv.width * (int64_t)uv.height;
+            }
+            pagesCreated++;
+            PERF_LOG_COUNT("Tiled2dMapVectorCustomAssetCache_pagesCreated", 1);
+        }
+        result.push_back(std::move(newPage));
+    }
+
+    trimLocked();
+    return result;
+}
+
+void Tiled2dMapVectorCustomAssetCache::setDelegateLocked(const std::shared_ptr<Tiled2dMapVectorLayerSymbolDelegateInterface> &delegate) {
+    if (this->delegate.lock() == delegate) {
+        return;
+    }
+    // the icons of another delegate may differ for the same features
+    pages.clear();
+    lruOrder.clear();
+    icons.clear();
+    this->delegate = delegate;
+}
+
+void Tiled2dMapVectorCustomAssetCache::trimLocked() {
+    size_t rank = 0;
+    for (auto it = lruOrder.begin(); it != lruOrder.end();) {
+        const auto pageId = *it;
+        ++it;
+        auto &page = pages.at(pageId);
+        if (rank++ >= maxRetainedPages) {
+            page.retainedTexture = nullptr;
+        }
+        if (page.texture.expired()) {
+            removePageLocked(pageId);
+        }
+    }
+}
+
+void Tiled2dMapVectorCustomAssetCache::removePageLocked(uint64_t pageId) {
+    auto pageIt = pages.find(pageId);
+    if (pageIt == pages.end()) {
+        return;
+    }
+    for (const auto &key: pageIt->second.iconKeys) {
+        auto iconIt = icons.find(key);
+        // the icon may have been replaced by a newer page
+        if (iconIt != icons.end() && iconIt->second.pageId == pageId) {
+            icons.erase(iconIt);
+        }
+    }
+    lruOrder.erase(pageIt->second.lruIterator);
+    pages.erase(pageIt);
+}
+
+void Tiled2dMapVectorCustomAssetCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    pages.clear();
+    lruOrder.clear();
+    icons.clear();
+}
+
+Tiled2dMapVectorCustomAssetCache::Statistics Tiled2dMapVectorCustomAssetCache::getStatistics() {
+    std::lock_guard<std::mutex> lock(mutex);
+    trimLocked();
+
+    int64_t iconArea = 0;
+    int64_t pageArea = 0;
+    for (const auto &[pageId, page]: pages) {
+        iconArea += page.iconArea;
+        pageArea += page.pageArea;
+    }
+    return Statistics{hits, misses, pagesCreated, pages.size(), icons.size(), pageArea > 0 ? (double)iconArea / (double)pageArea : 0.0};
+}
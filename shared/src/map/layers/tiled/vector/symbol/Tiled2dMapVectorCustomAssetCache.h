@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "Tiled2dMapVectorAssetInfo.h"
+#include "Tiled2dMapVectorLayerSymbolDelegateInterface.h"
+#include "TextureHolderInterface.h"
+#include "VectorLayerFeatureInfo.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Cache of the texture pages with custom icons returned by a Tiled2dMapVectorLayerSymbolDelegateInterface, shared by
+ * all symbol groups of a source.
+ *
+ * The icons are packed into pages by the delegate. Once a page has been returned, its icons are handed out to every
+ * symbol group requesting the same feature (same layer, identifier and properties) with the same texture holder, so
+ * the texture is only uploaded once. Only the features not found on a cached page are requested from the delegate.
+ *
+ * Pages are held as long as a symbol group uses them. Additionally, the maxRetainedPages most recently used pages are
+ * kept when they are no longer used, e.g. while the tiles of the next zoom level are loaded. All pages are dropped
+ * when the delegate changes.
+ *
+ * Hits (icons served from a cached page), misses (icons requested from the delegate) and the number of pages created
+ * by the delegate are counted in getStatistics() and, if enabled, in the PerformanceLogger.
+ */
+class Tiled2dMapVectorCustomAssetCache {
+  public:
+    struct Statistics {
+        int64_t hits;
+        int64_t misses;
+        int64_t pagesCreated;
+        size_t numPages;
+        size_t numIcons;
+        // area of the icons on the cached pages in relation to the area of the pages
+        double occupancy;
+    };
+
+    static constexpr size_t defaultMaxRetainedPages = 8;
+
+    Tiled2dMapVectorCustomAssetCache(size_t maxRetainedPages = defaultMaxRetainedPages);
+
+    // Same contract as Tiled2dMapVectorLayerSymbolDelegateInterface::getCustomAssetsFor. Pages served from the cache
+    // only contain the uvs of the requested features.
+    std::vector<Tiled2dMapVectorAssetInfo> getCustomAssetsFor(const std::shared_ptr<Tiled2dMapVectorLayerSymbolDelegateInterface> &delegate,
+                                                              const std::vector<VectorLayerFeatureInfo> &featureInfos,
+                                                              const std::string &layerIdentifier);
+
+    void clear();
+
+    Statistics getStatistics();
+
+  private:
+    struct Page {
+        std::weak_ptr<TextureHolderInterface> texture;
+        // set while the page is one of the maxRetainedPages most recently used pages
+        std::shared_ptr<TextureHolderInterface> retainedTexture;
+        std::vector<std::string> iconKeys;
+        int64_t iconArea;
+        int64_t pageArea;
+        std::list<uint64_t>::iterator lruIterator;
+    };
+
+    struct Icon {
+        uint64_t pageId;
+        ::RectI uv;
+        std::unordered_map<std::string, VectorLayerFeatureInfoValue> properties;
+    };
+
+    static std::string createKey(const std::string &layerIdentifier, const std::string &featureIdentifier);
+
+    void setDelegateLocked(const std::shared_ptr<Tiled2dMapVectorLayerSymbolDelegateInterface> &delegate);
+
+    // Drops the pages no longer used by any symbol group and releases the pages beyond maxRetainedPages
+    void trimLocked();
+
+    void removePageLocked(uint64_t pageId);
+
+    std::mutex mutex;
+    size_t maxRetainedPages;
+    std::weak_ptr<Tiled2dMapVectorLayerSymbolDelegateInterface> delegate;
+    uint64_t nextPageId = 0;
+    std::unordered_map<uint64_t, Page> pages;
+    std::list<uint64_t> lruOrder;
+    std::unordered_map<std::string, Icon> icons;
+
+    int64_t hits = 0;
+    int64_t misses = 0;
+    int64_t pagesCreated = 0;
+};
@@ -15,5 +15,6 @@
 
 class Tiled2dMapVectorFontProvider {
 public:
-    virtual std::shared_ptr<FontLoaderResult> loadFont(const std::string &fontName) = 0;
+    // text: the label to be laid out with the font, fonts rendered on demand add its glyphs first
+    virtual std::shared_ptr<FontLoaderResult> loadFont(const std::string &fontName, const std::string &text) = 0;
 };
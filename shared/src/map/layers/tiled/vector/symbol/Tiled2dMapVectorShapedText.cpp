@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "Tiled2dMapVectorShapedText.h"
+#include "TextHelper.h"
+#include "Utf8Iterator.h"
+#include <algorithm>
+#include <cassert>
+
+std::shared_ptr<Tiled2dMapVectorShapedText> Tiled2dMapVectorShapedText::shape(const std::shared_ptr<FontLoaderResult> &fontResult,
+                                                                                const std::vector<FormattedStringEntry> &text,
+                                                                                TextSymbolPlacement textSymbolPlacement,
+                                                                                int64_t maxCharacterWidth,
+                                                                                double lineHeight) {
+    auto shapedText = std::make_shared<Tiled2dMapVectorShapedText>();
+    shapedText->fontResult = fontResult;
+    const auto &glyphs = fontResult->fontData->glyphs;
+
+    for(auto i=0; i<glyphs.size(); ++i) {
+        auto& letter = glyphs[i];
+        if(letter.charCode == " ") {
+            shapedText->spaceAdvance = letter.advance.x;
+            shapedText->spaceIndex = i;
+            break;
+        }
+    }
+
+    std::vector<BreakResult> breaks = {};
+    if(textSymbolPlacement == TextSymbolPlacement::POINT) {
+        std::vector<std::string_view> letters;
+
+        for (const auto &entry: text) {
+            for (const auto c : Utf8Letters(entry.text)) {
+                letters.push_back(c);
+            }
+        }
+
+        breaks = TextHelper::bestBreakIndices(letters, maxCharacterWidth);
+    }
+
+    auto &splittedTextInfo = shapedText->splittedTextInfo;
+    int currentLetterIndex = 0;
+    for (const auto &entry: text) {
+        for (const auto c : Utf8Letters(entry.text)) {
+            int index = -1;
+            bool found = false;
+
+            int i = 0;
+            for (const auto &d : glyphs) {
+                if(c == d.charCode) {
+                    index = i;
+                    found = true;
+                    break;
+                }
+
+                ++i;
+            }
+
+            if(textSymbolPlacement == TextSymbolPlacement::POINT) {
+                // check for line breaks in point texts
+                auto it = std::find_if(breaks.begin(), breaks.end(), [&](const auto& v) { return v.index == currentLetterIndex; });
+                if(it != breaks.end()) {
+                    // add line break
+                    if(it->keepLetter && found) {
+                        splittedTextInfo.emplace_back(index, entry.scale);
+                    }
+                    // use -1 as line break
+                    shapedText->numLines++;
+                    splittedTextInfo.emplace_back(-1, entry.scale);
+                } else {
+                    // just add it
+                    if(found) {
+                        splittedTextInfo.emplace_back(index, entry.scale);
+                    }
+                }
+            } else {
+                // non-point symbols: just add it if found, no line breaks possible
+                if(found) {
+                    splittedTextInfo.emplace_back(index, entry.scale);
+                }
+            }
+
+            currentLetterIndex++;
+        }
+    }
+
+    for (const auto &i : splittedTextInfo) {
+        if (i.glyphIndex < 0) continue;
+        const auto &d = glyphs[i.glyphIndex];
+        if (d.charCode != " ") {
+            shapedText->characterCount += 1;
+            shapedText->textureCoordinates.push_back(d.uv.topLeft.x);
+            shapedText->textureCoordinates.push_back(d.uv.bottomRight.y);
+            shapedText->textureCoordinates.push_back(d.uv.bottomRight.x - d.uv.topLeft.x);
+            shapedText->textureCoordinates.push_back(d.uv.topLeft.y - d.uv.bottomLeft.y);
+        }
+    }
+
+    shapedText->computeMedianLastBaseLine(lineHeight);
+    return shapedText;
+}
+
+void Tiled2dMapVectorShapedText::computeMedianLastBaseLine(double lineHeight) {
+    std::vector<double> heights;
+
+    const auto &glyphs = fontResult->fontData->glyphs;
+    int baseLineStartIndex = 0;
+
+    auto penY = -lineHeight * 0.25;
+
+    int c = 0;
+    for(const auto &i : splittedTextInfo) {
+        if(i.glyphIndex >= 0) {
+            assert(i.glyphIndex < glyphs.size());
+            const auto &d = glyphs[i.glyphIndex];
+
+            auto scale = i.scale;
+            auto size = Vec2D(d.boundingBoxSize.x * scale, d.boundingBoxSize.y * scale);
+            auto bearing = Vec2D(d.bearing.x * scale, d.bearing.y * scale);
+
+            if(i.glyphIndex != spaceIndex) {
+                auto y = penY - bearing.y;
+                auto yh = y + size.y;
+                heights.emplace_back(yh);
+                c++;
+            }
+        } else if(i.glyphIndex == -1) {
+            baseLineStartIndex = c;
+            penY += lineHeight;
+        } else {
+            assert(false);
+        }
+    }
+
+    // Last line is a new line or there are no heights,
+    // just take where the penY is at the end
+    int lastLineLength = c - baseLineStartIndex;
+    if(lastLineLength == 0) {
+        medianLastBaseLine = penY;
+        return;
+    }
+
+    // Otherwise compute the median indices
+    std::sort(
+        heights.begin() + baseLineStartIndex,
+        heights.begin() + c
+    );
+
+    int medianOffset = lastLineLength / 2;
+    int median = baseLineStartIndex + medianOffset;
+
+    if (lastLineLength % 2 == 0) {
+        double medianBaseLineLow = heights[median - 1];
+        double medianBaseLineHigh = heights[median];
+        medianLastBaseLine = 0.5 * (medianBaseLineHigh + medianBaseLineLow);
+    } else {
+        medianLastBaseLine = heights[median];
+    }
+}
+
+size_t Tiled2dMapVectorShapedText::sizeBytes() const {
+    return sizeof(Tiled2dMapVectorShapedText) + splittedTextInfo.capacity() * sizeof(SplitInfo) +
+           textureCoordinates.capacity() * sizeof(float);
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "FontLoaderResult.h"
+#include "FormattedStringEntry.h"
+#include "TextSymbolPlacement.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * The glyphs of a label text in a font, with line breaks, independent of the position and the style of the label.
+ * Labels with the same text share one instance, see Tiled2dMapVectorShapedTextCache.
+ */
+struct Tiled2dMapVectorShapedText {
+    struct SplitInfo {
+        SplitInfo(int g, float s) : glyphIndex(g), scale(s) {};
+        // index in the glyphs of the font, -1 for a line break
+        int glyphIndex;
+        float scale;
+    };
+
+    // keeps the glyph indices valid
+    std::shared_ptr<FontLoaderResult> fontResult;
+
+    std::vector<SplitInfo> splittedTextInfo;
+    // number of rendered glyphs, without spaces and line breaks
+    int characterCount = 0;
+    size_t numLines = 1;
+
+    int spaceIndex = -1;
+    float spaceAdvance = 0.0f;
+
+    // median of the glyph bottoms on the last line, relative to the font size
+    double medianLastBaseLine = 0.0;
+
+    // s, t, width and height in the font atlas for each rendered glyph
+    std::vector<float> textureCoordinates;
+
+    static std::shared_ptr<Tiled2dMapVectorShapedText> shape(const std::shared_ptr<FontLoaderResult> &fontResult,
+                                                             const std::vector<FormattedStringEntry> &text,
+                                                             TextSymbolPlacement textSymbolPlacement,
+                                                             int64_t maxCharacterWidth,
+                                                             double lineHeight);
+
+    // Approximate heap size
+    size_t sizeBytes() const;
+
+  private:
+    void computeMedianLastBaseLine(double lineHeight);
+};
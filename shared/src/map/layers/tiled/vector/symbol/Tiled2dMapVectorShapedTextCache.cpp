@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "Tiled2dMapVectorShapedTextCache.h"
+#include "PerformanceLogger.h"
+#include <algorithm>
+
+std::string Tiled2dMapVectorShapedTextCache::createKey(const std::shared_ptr<FontLoaderResult> &fontResult,
+                                                       const std::vector<FormattedStringEntry> &text, TextSymbolPlacement textSymbolPlacement,
+                                                       int64_t maxCharacterWidth, double lineHeight) {
+    // the shaped text holds the font, its address is unique as long as the entry is alive
+    const auto font = (uintptr_t)fontResult.get();
+    const bool isPoint = textSymbolPlacement == TextSymbolPlacement::POINT;
+    // line breaks are only used for point placements
+    const int64_t maxWidth = isPoint ? maxCharacterWidth : 0;
+
+    std::string key;
+    key.append((const char *)&font, sizeof(font));
+    key.push_back(isPoint ? 'p' : 'l');
+    key.append((const char *)&maxWidth, sizeof(maxWidth));
+    key.append((const char *)&lineHeight, sizeof(lineHeight));
+    for (const auto &entry: text) {
+        const uint32_t length = (uint32_t)entry.text.size();
+        key.append((const char *)&entry.scale, sizeof(entry.scale));
+        key.append((const char *)&length, sizeof(length));
+        key.append(entry.text);
+    }
+    return key;
+}
+
+std::shared_ptr<const Tiled2dMapVectorShapedText> Tiled2dMapVectorShapedTextCache::getShapedText(const std::shared_ptr<FontLoaderResult> &fontResult,
+                                                                                                const std::vector<FormattedStringEntry> &text,
+                                                                                                TextSymbolPlacement textSymbolPlacement,
+                                                                                                int64_t maxCharacterWidth,
+                                                                                                double lineHeight) {
+    const auto key = createKey(fontResult, text, textSymbolPlacement, maxCharacterWidth, lineHeight);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            if (auto shapedText = it->second.lock()) {
+                hits++;
+                PERF_LOG_COUNT("Tiled2dMapVectorShapedTextCache_hits", 1);
+                return shapedText;
+            }
+        }
+    }
+
+    // shaping runs without holding the lock, the groups of several tiles are set up concurrently
+    std::shared_ptr<const Tiled2dMapVectorShapedText> shapedText =
+            Tiled2dMapVectorShapedText::shape(fontResult, text, textSymbolPlacement, maxCharacterWidth, lineHeight);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    misses++;
+    PERF_LOG_COUNT("Tiled2dMapVectorShapedTextCache_misses", 1);
+    auto &entry = entries[key];
+    if (auto existing = entry.lock()) {
+        // shaped by another thread in the meantime
+        return existing;
+    }
+    entry = shapedText;
+
+    if (entries.size() > 2 * std::max(sizeAtCleanup, (size_t)1024)) {
+        removeExpiredLocked();
+    }
+    return shapedText;
+}
+
+void Tiled2dMapVectorShapedTextCache::removeExpiredLocked() {
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.expired()) {
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    sizeAtCleanup = entries.size();
+}
+
+Tiled2dMapVectorShapedTextCache::Statistics Tiled2dMapVectorShapedTextCache::getStatistics() {
+    std::lock_guard<std::mutex> lock(mutex);
+    removeExpiredLocked();
+
+    size_t sizeBytes = 0;
+    for (const auto &[key, entry]: entries) {
+        if (auto shapedText = entry.lock()) {
+            sizeBytes += key.capacity() + shapedText->sizeBytes();
+        }
+    }
+    return Statistics{hits, misses, entries.size(), sizeBytes};
+}
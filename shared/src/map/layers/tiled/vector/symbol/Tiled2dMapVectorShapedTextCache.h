@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "Tiled2dMapVectorShapedText.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Interns the shaped texts of labels, keyed by text, font and the style properties used for shaping.
+ *
+ * The same road or place name appears in many adjacent tiles and on several zoom levels. Labels with the same text
+ * share one Tiled2dMapVectorShapedText, which is held by the labels only and dropped with the last of them.
+ *
+ * Hits and misses are counted in getStatistics() and, if enabled, in the PerformanceLogger.
+ */
+class Tiled2dMapVectorShapedTextCache {
+  public:
+    struct Statistics {
+        int64_t hits;
+        int64_t misses;
+        size_t numEntries;
+        size_t sizeBytes;
+    };
+
+    std::shared_ptr<const Tiled2dMapVectorShapedText> getShapedText(const std::shared_ptr<FontLoaderResult> &fontResult,
+                                                                    const std::vector<FormattedStringEntry> &text,
+                                                                    TextSymbolPlacement textSymbolPlacement,
+                                                                    int64_t maxCharacterWidth,
+                                                                    double lineHeight);
+
+    Statistics getStatistics();
+
+  private:
+    static std::string createKey(const std::shared_ptr<FontLoaderResult> &fontResult, const std::vector<FormattedStringEntry> &text,
+                                 TextSymbolPlacement textSymbolPlacement, int64_t maxCharacterWidth, double lineHeight);
+
+    void removeExpiredLocked();
+
+    std::mutex mutex;
+    std::unordered_map<std::string, std::weak_ptr<const Tiled2dMapVectorShapedText>> entries;
+    size_t sizeAtCleanup = 0;
+
+    int64_t hits = 0;
+    int64_t misses = 0;
+};
@@ -18,6 +18,7 @@
 #include "RenderObject.h"
 
 #include "TrigonometryLUT.h"
+#include "PerformanceLogger.h"
 
 Tiled2dMapVectorSourceSymbolDataManager::Tiled2dMapVectorSourceSymbolDataManager(const WeakActor<Tiled2dMapVectorLayer> &vectorLayer,
                                                                                  const std::shared_ptr<VectorMapDescription> &mapDescription,
@@ -31,7 +32,9 @@ Tiled2dMapVectorSourceSymbolDataManager::Tiled2dMapVectorSourceSymbolDataManager
         : Tiled2dMapVectorSourceDataManager(vectorLayer, mapDescription, layerConfig, source, readyManager, featureStateManager),
         fontLoader(fontLoader), vectorSource(vectorSource),
         animationCoordinatorMap(std::make_shared<SymbolAnimationCoordinatorMap>()),
-        symbolDelegate(symbolDelegate)
+        symbolDelegate(symbolDelegate),
+        customAssetCache(std::make_shared<Tiled2dMapVectorCustomAssetCache>()),
+        shapedTextCache(std::make_shared<Tiled2dMapVectorShapedTextCache>())
 {
 
     for (const auto &layer: mapDescription->layers) {
@@ -456,7 +459,9 @@ std::vector<Actor<Tiled2dMapVectorSymbolGroup>> Tiled2dMapVectorSourceSymbolData
                                                                                                  layerDescriptions.at(
                                                                                                          layerIdentifier),
                                                                                                  featureStateManager,
-                                                                                                 symbolDelegate);
+                                                                                                 symbolDelegate,
+                                                                                                 customAssetCache,
+                                                                                                 shapedTextCache);
         symbolGroupActor.message(MFN(&Tiled2dMapVectorSymbolGroup::initialize), features, featuresBase,
                                  std::min(featuresBase + maxNumFeaturesPerGroup, numFeatures) - featuresBase,
                                  animationCoordinatorMap, selfActor, alpha);
@@ -579,6 +584,9 @@ void Tiled2dMapVectorSourceSymbolDataManager::updateSymbolGroups() {
         if (clearCoordinator) {
             animationCoordinatorMap->clearAnimationCoordinators();
         }
+
+        // visible tiles and the owners of the animation coordinators may have changed
+        collisionEpoch++;
     }
 
     pregenerateRenderPasses();
@@ -660,8 +668,12 @@ void Tiled2dMapVectorSourceSymbolDataManager::collisionDetection(std::vector<std
                             return a->symbolSortKey > b->symbolSortKey;
                         });
 
+        bool collisionsChanged = false;
         for (const auto &object: allObjects) {
-            object->collisionDetection(zoomIdentifier, rotation, scaleFactor, collisionGrid);
+            collisionsChanged |= object->collisionDetection(zoomIdentifier, rotation, scaleFactor, collisionGrid);
+        }
+        if (collisionsChanged) {
+            collisionEpoch++;
         }
     }
 }
@@ -685,6 +697,10 @@ bool Tiled2dMapVectorSourceSymbolDataManager::update(int64_t now) {
     const auto vpMatrix = camera->asCameraInterface()->getVpMatrix();
     const auto origin = camera->asCameraInterface()->getOrigin();
 
+    Tiled2dMapVectorSymbolGroup::UpdateState updateState;
+    updateState.cameraEpoch = cameraEpoch.update(zoomIdentifier, rotation, scaleFactor, viewPortSize, vpMatrix, origin);
+    updateState.collisionEpoch = collisionEpoch;
+
     bool anyRenderObjectsChanged = false;
     for (const auto &[tile, symbolGroupsMap]: tileSymbolGroupMap) {
         const auto tileState = tileStateMap.find(tile);
@@ -693,14 +709,17 @@ bool Tiled2dMapVectorSourceSymbolDataManager::update(int64_t now) {
         }
         for (const auto &[layerIdentifier, symbolGroups]: symbolGroupsMap) {
             for (auto &symbolGroup: std::get<1>(symbolGroups)) {
-                bool renderObjectsChanged = symbolGroup.syncAccess([&zoomIdentifier, &rotation, &scaleFactor, &now, &viewPortSize, &vpMatrix, &origin](auto group){
-                    return group->update(zoomIdentifier, rotation, scaleFactor, now, viewPortSize, vpMatrix, origin);
+                bool renderObjectsChanged = symbolGroup.syncAccess([&zoomIdentifier, &rotation, &scaleFactor, &now, &viewPortSize, &vpMatrix, &origin, &updateState](auto group){
+                    return group->update(zoomIdentifier, rotation, scaleFactor, now, viewPortSize, vpMatrix, origin, updateState);
                 });
                 anyRenderObjectsChanged |= renderObjectsChanged;
             }
         }
     }
 
+    PERF_LOG_COUNT("Tiled2dMapVectorSourceSymbolDataManager_updatedObjects", updateState.updatedObjects);
+    PERF_LOG_COUNT("Tiled2dMapVectorSourceSymbolDataManager_skippedObjects", updateState.skippedObjects);
+
     if (anyRenderObjectsChanged) {
         pregenerateRenderPasses();
     }
@@ -846,4 +865,5 @@ void Tiled2dMapVectorSourceSymbolDataManager::setSymbolDelegate(const /*not-null
 
 void Tiled2dMapVectorSourceSymbolDataManager::enableAnimations(bool enabled) {
     animationCoordinatorMap->enableAnimations(enabled);
+    collisionEpoch++;
 }
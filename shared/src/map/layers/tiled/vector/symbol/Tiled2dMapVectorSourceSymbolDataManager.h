@@ -18,6 +18,7 @@
 #include "SpriteData.h"
 #include "FontLoaderResult.h"
 #include "Tiled2dMapVectorSymbolGroup.h"
+#include "Tiled2dMapVectorSymbolUpdateState.h"
 #include "TextInstancedInterface.h"
 #include "Tiled2dMapVectorFontProvider.h"
 #include "CollisionGrid.h"
@@ -25,6 +26,8 @@
 #include "SymbolAnimationCoordinatorMap.h"
 #include "Tiled2dMapVectorSymbolFontProviderManager.h"
 #include "Tiled2dMapVectorLayerSymbolDelegateInterface.h"
+#include "Tiled2dMapVectorCustomAssetCache.h"
+#include "Tiled2dMapVectorShapedTextCache.h"
 
 #ifdef OPENMOBILEMAPS_GL
 #include "TextInstancedShaderOpenGl.h"
@@ -149,6 +152,12 @@ private:
 
     std::shared_ptr<SymbolAnimationCoordinatorMap> animationCoordinatorMap;
     std::shared_ptr<Tiled2dMapVectorLayerSymbolDelegateInterface> symbolDelegate;
+    const std::shared_ptr<Tiled2dMapVectorCustomAssetCache> customAssetCache;
+    const std::shared_ptr<Tiled2dMapVectorShapedTextCache> shapedTextCache;
+
+    // Symbol groups skip their update if none of the epochs changed since their last update (and no animation is running)
+    Tiled2dMapVectorSymbolCameraEpoch cameraEpoch;
+    uint64_t collisionEpoch = 0;
 
 #ifdef OPENMOBILEMAPS_GL
     // Higher counts can't be handled due to the limited UBO size
@@ -11,15 +11,23 @@
 #include "Tiled2dMapVectorSymbolFontProviderManager.h"
 
 Tiled2dMapVectorSymbolFontProviderManager::Tiled2dMapVectorSymbolFontProviderManager(
-        const std::shared_ptr<FontLoaderInterface> &fontLoader) : fontLoader(fontLoader) {}
+        const std::shared_ptr<FontLoaderInterface> &fontLoader)
+        : fontLoader(fontLoader), sdfFontLoader(std::dynamic_pointer_cast<SdfFontLoader>(fontLoader)) {}
 
-std::shared_ptr <FontLoaderResult> Tiled2dMapVectorSymbolFontProviderManager::loadFont(const std::string &fontName) {
-    if (fontLoaderResults.count(fontName) > 0) {
-        return fontLoaderResults.at(fontName);
+std::shared_ptr <FontLoaderResult> Tiled2dMapVectorSymbolFontProviderManager::loadFont(const std::string &fontName, const std::string &text) {
+    // fonts rendered on demand are loaded again whenever glyphs had to be added for the text
+    std::optional<uint64_t> glyphsVersion;
+    if (sdfFontLoader) {
+        glyphsVersion = sdfFontLoader->prepareGlyphs(fontName, text);
+    }
+
+    auto it = fontLoaderResults.find(fontName);
+    if (it != fontLoaderResults.end() && (!glyphsVersion || it->second.glyphsVersion == *glyphsVersion)) {
+        return it->second.result;
     } else {
         auto fontResult = std::make_shared<FontLoaderResult>(fontLoader->loadFont(Font(fontName)));
         if (fontResult->status == LoaderStatus::OK && fontResult->fontData && fontResult->imageData) {
-            fontLoaderResults.insert({fontName, fontResult});
+            fontLoaderResults[fontName] = LoadedFont{fontResult, glyphsVersion.value_or(0)};
         }
         return fontResult;
     }
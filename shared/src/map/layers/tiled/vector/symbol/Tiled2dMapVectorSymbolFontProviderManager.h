@@ -14,15 +14,24 @@
 #include "Tiled2dMapVectorFontProvider.h"
 #include "FontLoaderResult.h"
 #include "FontLoaderInterface.h"
+#include "SdfFontLoader.h"
+#include <cstdint>
 #include <unordered_map>
 
 class Tiled2dMapVectorSymbolFontProviderManager : public ActorObject, public Tiled2dMapVectorFontProvider {
 public:
     Tiled2dMapVectorSymbolFontProviderManager(const std::shared_ptr<FontLoaderInterface> &fontLoader);
 
-    virtual std::shared_ptr<FontLoaderResult> loadFont(const std::string &fontName);
+    virtual std::shared_ptr<FontLoaderResult> loadFont(const std::string &fontName, const std::string &text);
 
 private:
+    struct LoadedFont {
+        std::shared_ptr<FontLoaderResult> result;
+        // version of the glyph atlas the result contains at least, for fonts rendered on demand
+        uint64_t glyphsVersion;
+    };
+
     std::shared_ptr<FontLoaderInterface> fontLoader;
-    std::unordered_map<std::string, std::shared_ptr<FontLoaderResult>> fontLoaderResults;
+    std::shared_ptr<SdfFontLoader> sdfFontLoader;
+    std::unordered_map<std::string, LoadedFont> fontLoaderResults;
 };
@@ -19,6 +19,8 @@
 #include "Tiled2dMapVectorSourceSymbolDataManager.h"
 #include "RenderObject.h"
 #include "Tiled2dMapVectorAssetInfo.h"
+#include "InstancedRangeUpdateInterface.h"
+#include "PerformanceLogger.h"
 
 Tiled2dMapVectorSymbolGroup::Tiled2dMapVectorSymbolGroup(uint32_t groupId,
                                                          const std::weak_ptr<MapInterface> &mapInterface,
@@ -29,7 +31,9 @@ Tiled2dMapVectorSymbolGroup::Tiled2dMapVectorSymbolGroup(uint32_t groupId,
                                                          const std::string &layerIdentifier,
                                                          const std::shared_ptr<SymbolVectorLayerDescription> &layerDescription,
                                                          const std::shared_ptr<Tiled2dMapVectorStateManager> &featureStateManager,
-                                                         const std::shared_ptr<Tiled2dMapVectorLayerSymbolDelegateInterface> &symbolDelegate)
+                                                         const std::shared_ptr<Tiled2dMapVectorLayerSymbolDelegateInterface> &symbolDelegate,
+                                                         const std::shared_ptr<Tiled2dMapVectorCustomAssetCache> &customAssetCache,
+                                                         const std::shared_ptr<Tiled2dMapVectorShapedTextCache> &shapedTextCache)
 : groupId(groupId),
 mapInterface(mapInterface),
 vectorLayer(vectorLayer),
@@ -40,6 +44,8 @@ layerDescription(layerDescription),
 fontProvider(fontProvider),
 featureStateManager(featureStateManager),
 symbolDelegate(symbolDelegate),
+customAssetCache(customAssetCache),
+shapedTextCache(shapedTextCache),
 usedKeys(layerDescription->getUsedKeys()),
 tileOrigin(0, 0, 0),
 is3d(mapInterface.lock()->is3d()){
@@ -374,7 +380,8 @@ void Tiled2dMapVectorSymbolGroup::initialize(std::weak_ptr<std::vector<Tiled2dMa
 
     if (!featureInfosWithCustomAssets.empty()) {
         assert(symbolDelegate != nullptr);
-        auto customAssetPages = symbolDelegate->getCustomAssetsFor(featureInfosWithCustomAssets, layerDescription->identifier);
+        // icons already provided to other groups of the source are reused, only the missing ones are requested
+        auto customAssetPages = customAssetCache->getCustomAssetsFor(symbolDelegate, featureInfosWithCustomAssets, layerDescription->identifier);
         for (const auto &page: customAssetPages) {
             auto object = strongMapInterface->getGraphicsObjectFactory()->createQuadInstanced(alphaInstancedShader);
             object->setInstanceCount((int32_t) page.featureIdentifiersUv.size());
@@ -455,6 +462,7 @@ void Tiled2dMapVectorSymbolGroup::updateLayerDescription(const std::shared_ptr<S
     for (auto const &object: symbolObjects) {
         object->updateLayerDescription(layerDescription, usedKeys);
     }
+    updateTracker.invalidate();
 }
 
 void Tiled2dMapVectorSymbolGroup::setupObjects(const std::vector<std::pair<std::shared_ptr<SpriteData>, std::shared_ptr<::TextureHolderInterface>>> &sprites, const std::optional<WeakActor<Tiled2dMapVectorSourceSymbolDataManager>> &symbolDataManager) {
@@ -467,7 +475,8 @@ void Tiled2dMapVectorSymbolGroup::setupObjects(const std::vector<std::pair<std::
     }
     const auto context = mapInterface.lock()->getRenderingContext();
 
-    std::unordered_map<std::string, int32_t> textOffsets;
+    // fonts rendered on demand can be loaded several times with the same name, the descriptors are per loaded font
+    std::unordered_map<const FontLoaderResult *, int32_t> textOffsets;
 
     int positionSize = is3d ? 3 : 2;
 
@@ -493,16 +502,15 @@ void Tiled2dMapVectorSymbolGroup::setupObjects(const std::vector<std::pair<std::
         if (font) {
             const auto &textDescriptor = std::find_if(textDescriptors.begin(), textDescriptors.end(),
                                                       [&font](const auto &textDescriptor) {
-                                                          return font->fontData->info.name ==
-                                                                 textDescriptor->fontResult->fontData->info.name;
+                                                          return font == textDescriptor->fontResult;
                                                       });
             if (textDescriptor != textDescriptors.end()) {
-                int32_t currentTextOffset = textOffsets[font->fontData->info.name];
+                int32_t currentTextOffset = textOffsets[font.get()];
                 object->setupTextProperties((*textDescriptor)->textTextureCoordinates,
                                             (*textDescriptor)->textStyleIndices,
                                             currentTextOffset,
                                             tileInfo.tileInfo.zoomIdentifier);
-                textOffsets[font->fontData->info.name] = currentTextOffset;
+                textOffsets[font.get()] = currentTextOffset;
             }
         }
     }
@@ -550,6 +558,7 @@ void Tiled2dMapVectorSymbolGroup::setupObjects(const std::vector<std::pair<std::
     }
 
     isInitialized = true;
+    updateTracker.invalidate();
 }
 
 void Tiled2dMapVectorSymbolGroup::addSprite(const std::shared_ptr<SpriteData> &spriteData, const std::shared_ptr<TextureHolderInterface> &spriteTexture) {
@@ -583,6 +592,7 @@ void Tiled2dMapVectorSymbolGroup::addSprite(const std::shared_ptr<SpriteData> &s
         spriteLookup[iconId] = ResolvedSpriteIconId{sheetIndex, iconIndex};
         spriteIconData.push_back(spriteDesc);
     }
+    updateTracker.invalidate();
 }
 
 // Initialize or update sprite icon instanced object and buffers. Adapt the graphics objects to changed icon counts, initializing it only if icons should be visible.
@@ -651,7 +661,7 @@ bool Tiled2dMapVectorSymbolGroup::prepareIconObject(SpriteIconDescriptor &sprite
     return renderObjectsChanged;
 }
 
-bool Tiled2dMapVectorSymbolGroup::update(const double zoomIdentifier, const double rotation, const double scaleFactor, int64_t now, const Vec2I viewPortSize, const std::vector<float>& vpMatrix, const Vec3D& origin) {
+bool Tiled2dMapVectorSymbolGroup::update(const double zoomIdentifier, const double rotation, const double scaleFactor, int64_t now, const Vec2I viewPortSize, const std::vector<float>& vpMatrix, const Vec3D& origin, UpdateState &updateState) {
     bool renderObjectsChanged = false;
     if (!isInitialized) {
         return renderObjectsChanged;
@@ -660,34 +670,81 @@ bool Tiled2dMapVectorSymbolGroup::update(const double zoomIdentifier, const doub
         return renderObjectsChanged;
     }
 
-    // Count the number of icons per sheet to update instance counts and buffer sizes.
-    for(auto &spriteDescriptor : sprites) {
-        spriteDescriptor.tmpIconCounter = 0;
-        spriteDescriptor.tmpStretchedIconCounter = 0;
-    }
-    for (auto const &object: symbolObjects) {
-        auto spriteIconRef = object->getUpdatedSpriteIconRef(zoomIdentifier, spriteLookup);
-        if(spriteIconRef && !object->hasCustomTexture) {
-            const auto objectInstanceCounts = object->getInstanceCounts();
-            
-            auto &spriteDescriptor = sprites.at(spriteIconRef->sheet);
-            spriteDescriptor.tmpIconCounter += objectInstanceCounts.icons;
-            spriteDescriptor.tmpStretchedIconCounter += objectInstanceCounts.stretchedIcons;
+    size_t numAnimatingObjects = 0;
+    const auto updateMode = updateTracker.beginUpdate(updateState, featureStateManager->getCurrentState(), [&]() {
+        for (const auto &object : symbolObjects) {
+            if (object->animationCoordinator->isAnimating()) {
+                numAnimatingObjects++;
+            }
         }
+        return numAnimatingObjects > 0;
+    });
+    if (updateMode == Tiled2dMapVectorSymbolGroupUpdateTracker::UpdateMode::NONE) {
+        updateState.skippedObjects += symbolObjects.size();
+        return renderObjectsChanged;
     }
-    for(auto &spriteDescriptor : sprites) {
-        renderObjectsChanged |= prepareIconObject(spriteDescriptor, spriteDescriptor.tmpIconCounter, spriteDescriptor.tmpStretchedIconCounter);
-        spriteDescriptor.tmpIconCounter = 0;
-        spriteDescriptor.tmpStretchedIconCounter = 0;
+    const bool inputsChanged = updateMode == Tiled2dMapVectorSymbolGroupUpdateTracker::UpdateMode::ALL;
+
+    if (inputsChanged) {
+        // Count the number of icons per sheet to update instance counts and buffer sizes.
+        // The sprite icons only change with the inputs, the counts stay the same while only animations are running.
+        for(auto &spriteDescriptor : sprites) {
+            spriteDescriptor.tmpIconCounter = 0;
+            spriteDescriptor.tmpStretchedIconCounter = 0;
+        }
+        for (auto const &object: symbolObjects) {
+            auto spriteIconRef = object->getUpdatedSpriteIconRef(zoomIdentifier, spriteLookup);
+            if(spriteIconRef && !object->hasCustomTexture) {
+                const auto objectInstanceCounts = object->getInstanceCounts();
+
+                auto &spriteDescriptor = sprites.at(spriteIconRef->sheet);
+                spriteDescriptor.tmpIconCounter += objectInstanceCounts.icons;
+                spriteDescriptor.tmpStretchedIconCounter += objectInstanceCounts.stretchedIcons;
+            }
+        }
+        for(auto &spriteDescriptor : sprites) {
+            renderObjectsChanged |= prepareIconObject(spriteDescriptor, spriteDescriptor.tmpIconCounter, spriteDescriptor.tmpStretchedIconCounter);
+            spriteDescriptor.tmpIconCounter = 0;
+            spriteDescriptor.tmpStretchedIconCounter = 0;
+        }
+        updateState.updatedObjects += symbolObjects.size();
+    } else {
+        for(auto &spriteDescriptor : sprites) {
+            spriteDescriptor.tmpIconCounter = 0;
+            spriteDescriptor.tmpStretchedIconCounter = 0;
+        }
+        updateState.updatedObjects += numAnimatingObjects;
+        updateState.skippedObjects += symbolObjects.size() - numAnimatingObjects;
     }
-    
 
-        std::unordered_map<std::string, int32_t> textOffsets;
+        std::unordered_map<const FontLoaderResult *, int32_t> textOffsets;
         int32_t singleTextOffset = 0;
 
         for (auto &object : symbolObjects) {
             auto spriteIconRef = object->getSpriteIconRef();
 
+            if (!inputsChanged && !object->animationCoordinator->isAnimating()) {
+                // unchanged, only move past the instances of the object
+                const auto instanceCounts = object->getInstanceCounts();
+                if (spriteIconRef && !object->hasCustomTexture) {
+                    SpriteIconDescriptor &spriteDescriptor = sprites.at(spriteIconRef->sheet);
+                    if (instanceCounts.icons) {
+                        spriteDescriptor.tmpIconCounter += instanceCounts.icons;
+                    } else {
+                        spriteDescriptor.tmpStretchedIconCounter += instanceCounts.stretchedIcons;
+                    }
+                }
+                auto font = object->getFont();
+                if (font && instanceCounts.textCharacters != 0) {
+                    if (textDescriptors.size() > 1) {
+                        textOffsets[font.get()] += instanceCounts.textCharacters;
+                    } else {
+                        singleTextOffset += instanceCounts.textCharacters;
+                    }
+                }
+                continue;
+            }
+
             if (object->hasCustomTexture) {
                 auto &page = customTextures[object->customTexturePage];
                 uint32_t offset = object->customTextureOffset;
@@ -713,21 +770,19 @@ bool Tiled2dMapVectorSymbolGroup::update(const double zoomIdentifier, const doub
                 auto n = textDescriptors.size();
 
                 if(n > 1) {
-                    auto &name = font->fontData->info.name;
-
                     const auto &textDescriptor = std::find_if(textDescriptors.begin(), textDescriptors.end(),
-                                                              [&name](const auto &textDescriptor) {
-                        return name == textDescriptor->fontResult->fontData->info.name;
+                                                              [&font](const auto &textDescriptor) {
+                        return font == textDescriptor->fontResult;
                     });
 
                     if (textDescriptor != textDescriptors.end()) {
-                        int32_t currentTextOffset = textOffsets[name];
+                        int32_t currentTextOffset = textOffsets[font.get()];
                         object->updateTextProperties((*textDescriptor)->textPositions, (*textDescriptor)->textReferencePositions,
                                                      (*textDescriptor)->textScales, (*textDescriptor)->textRotations,
                                                      (*textDescriptor)->textAlphas, (*textDescriptor)->textStyles,
                                                      currentTextOffset,
                                                      zoomIdentifier, scaleFactor, rotation, now, viewPortSize, vpMatrix, origin);
-                        textOffsets[name] = currentTextOffset;
+                        textOffsets[font.get()] = currentTextOffset;
                     }
                 } else if(n == 1) {
                     // use first, as it has to be this one, otherwise multiple fonts
@@ -743,162 +798,94 @@ bool Tiled2dMapVectorSymbolGroup::update(const double zoomIdentifier, const doub
         }
 
         const int positionSize = is3d ? 3 : 2;
+        size_t uploadedBytes = 0;
         for (auto &customDescriptor: customTextures) {
             int32_t count = (int32_t)customDescriptor.featureIdentifiersUv.size();
-
-            if (customDescriptor.iconPositions.wasModified()) {
-                customDescriptor.renderObject->setPositions(
-                        SharedBytes((int64_t) customDescriptor.iconPositions.data(), (int32_t) count, positionSize * (int32_t) sizeof(float)));
-                customDescriptor.iconPositions.resetModificationFlag();
-            }
-
-            if (customDescriptor.iconAlphas.wasModified()) {
-                customDescriptor.renderObject->setAlphas(
-                                                         SharedBytes((int64_t) customDescriptor.iconAlphas.data(), (int32_t) count, (int32_t) sizeof(float)));
-                customDescriptor.iconAlphas.resetModificationFlag();
-            }
-
-            if (customDescriptor.iconScales.wasModified()) {
-                customDescriptor.renderObject->setScales(
-                                                         SharedBytes((int64_t) customDescriptor.iconScales.data(), (int32_t) count, 2 * (int32_t) sizeof(float)));
-                customDescriptor.iconScales.resetModificationFlag();
-            }
-
-            if (customDescriptor.iconRotations.wasModified()) {
-                customDescriptor.renderObject->setRotations(
-                                                            SharedBytes((int64_t) customDescriptor.iconRotations.data(), (int32_t) count, 1 * (int32_t) sizeof(float)));
-                customDescriptor.iconRotations.resetModificationFlag();
-            }
-
-            if (customDescriptor.iconOffsets.wasModified()) {
-                customDescriptor.renderObject->setPositionOffset(
-                                                                 SharedBytes((int64_t) customDescriptor.iconOffsets.data(), (int32_t) count, 2 * (int32_t) sizeof(float)));
-                customDescriptor.iconOffsets.resetModificationFlag();
-            }
-
-            if (customDescriptor.iconTextureCoordinates.wasModified()) {
-                customDescriptor.renderObject->setTextureCoordinates(
-                                                                 SharedBytes((int64_t) customDescriptor.iconTextureCoordinates.data(), (int32_t) count, 4 * (int32_t) sizeof(float)));
-                customDescriptor.iconTextureCoordinates.resetModificationFlag();
-            }
+            const auto &renderObject = customDescriptor.renderObject;
+            auto rangeObject = dynamic_cast<InstancedRangeUpdateInterface *>(renderObject.get());
+
+            uploadedBytes += uploadModifiedInstances(customDescriptor.iconPositions, positionSize, count, rangeObject, InstancedRangeUpdateInterface::Attribute::POSITIONS,
+                                                     [&](const SharedBytes &values) { renderObject->setPositions(values); });
+            uploadedBytes += uploadModifiedInstances(customDescriptor.iconAlphas, 1, count, rangeObject, InstancedRangeUpdateInterface::Attribute::ALPHAS,
+                                                     [&](const SharedBytes &values) { renderObject->setAlphas(values); });
+            uploadedBytes += uploadModifiedInstances(customDescriptor.iconScales, 2, count, rangeObject, InstancedRangeUpdateInterface::Attribute::SCALES,
+                                                     [&](const SharedBytes &values) { renderObject->setScales(values); });
+            uploadedBytes += uploadModifiedInstances(customDescriptor.iconRotations, 1, count, rangeObject, InstancedRangeUpdateInterface::Attribute::ROTATIONS,
+                                                     [&](const SharedBytes &values) { renderObject->setRotations(values); });
+            uploadedBytes += uploadModifiedInstances(customDescriptor.iconOffsets, 2, count, rangeObject, InstancedRangeUpdateInterface::Attribute::POSITION_OFFSETS,
+                                                     [&](const SharedBytes &values) { renderObject->setPositionOffset(values); });
+            uploadedBytes += uploadModifiedInstances(customDescriptor.iconTextureCoordinates, 4, count, rangeObject, InstancedRangeUpdateInterface::Attribute::TEXTURE_COORDINATES,
+                                                     [&](const SharedBytes &values) { renderObject->setTextureCoordinates(values); });
         }
 
         for (auto &spriteDescriptor: sprites) {
             if(spriteDescriptor.iconInstancedObject) {
                 int32_t iconCount = (int32_t) spriteDescriptor.iconAlphas.size();
-                if (spriteDescriptor.iconPositions.wasModified()) {
-                    spriteDescriptor.iconInstancedObject->setPositions(
-                                                      SharedBytes((int64_t) spriteDescriptor.iconPositions.data(), iconCount, positionSize * (int32_t) sizeof(float)));
-                    spriteDescriptor.iconPositions.resetModificationFlag();
-                }
-
-                if (spriteDescriptor.iconAlphas.wasModified()) {
-                    spriteDescriptor.iconInstancedObject->setAlphas(
-                                                   SharedBytes((int64_t) spriteDescriptor.iconAlphas.data(), iconCount, (int32_t) sizeof(float)));
-                    spriteDescriptor.iconAlphas.resetModificationFlag();
-                }
-
-                if (spriteDescriptor.iconScales.wasModified()) {
-                    spriteDescriptor.iconInstancedObject->setScales(
-                                                   SharedBytes((int64_t) spriteDescriptor.iconScales.data(), iconCount, 2 * (int32_t) sizeof(float)));
-                    spriteDescriptor.iconScales.resetModificationFlag();
-                }
-
-                if (spriteDescriptor.iconRotations.wasModified()) {
-                    spriteDescriptor.iconInstancedObject->setRotations(
-                                                      SharedBytes((int64_t) spriteDescriptor.iconRotations.data(), iconCount, 1 * (int32_t) sizeof(float)));
-                    spriteDescriptor.iconRotations.resetModificationFlag();
-                }
-
-                if (spriteDescriptor.iconOffsets.wasModified()) {
-                    spriteDescriptor.iconInstancedObject->setPositionOffset(
-                                                           SharedBytes((int64_t) spriteDescriptor.iconOffsets.data(), iconCount, 2 * (int32_t) sizeof(float)));
-                    spriteDescriptor.iconOffsets.resetModificationFlag();
-                }
-
-                if (spriteDescriptor.iconTextureCoordinates.wasModified()) {
-                    spriteDescriptor.iconInstancedObject->setTextureCoordinates(
-                                                           SharedBytes((int64_t) spriteDescriptor.iconTextureCoordinates.data(), iconCount, 4 * (int32_t) sizeof(float)));
-                    spriteDescriptor.iconTextureCoordinates.resetModificationFlag();
-                }
+                const auto &renderObject = spriteDescriptor.iconInstancedObject;
+                auto rangeObject = dynamic_cast<InstancedRangeUpdateInterface *>(renderObject.get());
+
+                uploadedBytes += uploadModifiedInstances(spriteDescriptor.iconPositions, positionSize, iconCount, rangeObject, InstancedRangeUpdateInterface::Attribute::POSITIONS,
+                                                         [&](const SharedBytes &values) { renderObject->setPositions(values); });
+                uploadedBytes += uploadModifiedInstances(spriteDescriptor.iconAlphas, 1, iconCount, rangeObject, InstancedRangeUpdateInterface::Attribute::ALPHAS,
+                                                         [&](const SharedBytes &values) { renderObject->setAlphas(values); });
+                uploadedBytes += uploadModifiedInstances(spriteDescriptor.iconScales, 2, iconCount, rangeObject, InstancedRangeUpdateInterface::Attribute::SCALES,
+                                                         [&](const SharedBytes &values) { renderObject->setScales(values); });
+                uploadedBytes += uploadModifiedInstances(spriteDescriptor.iconRotations, 1, iconCount, rangeObject, InstancedRangeUpdateInterface::Attribute::ROTATIONS,
+                                                         [&](const SharedBytes &values) { renderObject->setRotations(values); });
+                uploadedBytes += uploadModifiedInstances(spriteDescriptor.iconOffsets, 2, iconCount, rangeObject, InstancedRangeUpdateInterface::Attribute::POSITION_OFFSETS,
+                                                         [&](const SharedBytes &values) { renderObject->setPositionOffset(values); });
+                uploadedBytes += uploadModifiedInstances(spriteDescriptor.iconTextureCoordinates, 4, iconCount, rangeObject, InstancedRangeUpdateInterface::Attribute::TEXTURE_COORDINATES,
+                                                         [&](const SharedBytes &values) { renderObject->setTextureCoordinates(values); });
             }
 
             if(spriteDescriptor.stretchedInstancedObject) {
                 int32_t iconCount = (int32_t) spriteDescriptor.stretchedIconAlphas.size();
-                if (spriteDescriptor.stretchedIconPositions.wasModified()) {
-                    spriteDescriptor.stretchedInstancedObject->setPositions(SharedBytes((int64_t) spriteDescriptor.stretchedIconPositions.data(), iconCount,
-                                                                       positionSize * (int32_t) sizeof(float)));
-                    spriteDescriptor.stretchedIconPositions.resetModificationFlag();
-                }
-
-                if (spriteDescriptor.stretchedIconAlphas.wasModified()) {
-                    spriteDescriptor.stretchedInstancedObject->setAlphas(SharedBytes((int64_t) spriteDescriptor.stretchedIconAlphas.data(), iconCount,
-                                                                    (int32_t) sizeof(float)));
-                    spriteDescriptor.stretchedIconAlphas.resetModificationFlag();
-                }
-
-                if (spriteDescriptor.stretchedIconScales.wasModified()) {
-                    spriteDescriptor.stretchedInstancedObject->setScales(SharedBytes((int64_t) spriteDescriptor.stretchedIconScales.data(), iconCount,
-                                                                    2 * (int32_t) sizeof(float)));
-                    spriteDescriptor.stretchedIconScales.resetModificationFlag();
-                }
-
-                if (spriteDescriptor.stretchedIconRotations.wasModified()) {
-                    spriteDescriptor.stretchedInstancedObject->setRotations(SharedBytes((int64_t) spriteDescriptor.stretchedIconRotations.data(), iconCount,
-                                                                       1 * (int32_t) sizeof(float)));
-                    spriteDescriptor.stretchedIconRotations.resetModificationFlag();
-                }
-
-                if (spriteDescriptor.stretchedIconStretchInfos.wasModified()) {
-                    spriteDescriptor.stretchedInstancedObject->setStretchInfos(SharedBytes((int64_t) spriteDescriptor.stretchedIconStretchInfos.data(), iconCount,
-                                                                          10 * (int32_t) sizeof(float)));
-                    spriteDescriptor.stretchedIconStretchInfos.resetModificationFlag();
-                }
-
-                if (spriteDescriptor.stretchedIconTextureCoordinates.wasModified()) {
-                    spriteDescriptor.stretchedInstancedObject->setTextureCoordinates(SharedBytes((int64_t) spriteDescriptor.stretchedIconTextureCoordinates.data(), iconCount,
-                                                                          4 * (int32_t) sizeof(float)));
-                    spriteDescriptor.stretchedIconTextureCoordinates.resetModificationFlag();
-                }
+                const auto &renderObject = spriteDescriptor.stretchedInstancedObject;
+                // stretched icons are always uploaded completely
+                InstancedRangeUpdateInterface *rangeObject = nullptr;
+
+                uploadedBytes += uploadModifiedInstances(spriteDescriptor.stretchedIconPositions, positionSize, iconCount, rangeObject, InstancedRangeUpdateInterface::Attribute::POSITIONS,
+                                                         [&](const SharedBytes &values) { renderObject->setPositions(values); });
+                uploadedBytes += uploadModifiedInstances(spriteDescriptor.stretchedIconAlphas, 1, iconCount, rangeObject, InstancedRangeUpdateInterface::Attribute::ALPHAS,
+                                                         [&](const SharedBytes &values) { renderObject->setAlphas(values); });
+                uploadedBytes += uploadModifiedInstances(spriteDescriptor.stretchedIconScales, 2, iconCount, rangeObject, InstancedRangeUpdateInterface::Attribute::SCALES,
+                                                         [&](const SharedBytes &values) { renderObject->setScales(values); });
+                uploadedBytes += uploadModifiedInstances(spriteDescriptor.stretchedIconRotations, 1, iconCount, rangeObject, InstancedRangeUpdateInterface::Attribute::ROTATIONS,
+                                                         [&](const SharedBytes &values) { renderObject->setRotations(values); });
+                uploadedBytes += uploadModifiedInstances(spriteDescriptor.stretchedIconStretchInfos, 10, iconCount, rangeObject, InstancedRangeUpdateInterface::Attribute::SCALES,
+                                                         [&](const SharedBytes &values) { renderObject->setStretchInfos(values); });
+                uploadedBytes += uploadModifiedInstances(spriteDescriptor.stretchedIconTextureCoordinates, 4, iconCount, rangeObject, InstancedRangeUpdateInterface::Attribute::TEXTURE_COORDINATES,
+                                                         [&](const SharedBytes &values) { renderObject->setTextureCoordinates(values); });
             }
         }
 
         for (size_t i = 0; i < textDescriptors.size(); i++) {
             const auto &textDescriptor = textDescriptors[i];
             const auto &textInstancedObject = textInstancedObjects[i];
-            if (textDescriptor->textPositions.wasModified()) {
-                textInstancedObject->setPositions(
-                                                  SharedBytes((int64_t) textDescriptor->textPositions.data(), (int32_t) textDescriptor->textRotations.size(), 2 * (int32_t) sizeof(float)));
-                textDescriptor->textPositions.resetModificationFlag();
-            }
-            if (is3d && textDescriptor->textReferencePositions.wasModified()) {
-                textInstancedObject->setReferencePositions(
-                        SharedBytes((int64_t) textDescriptor->textReferencePositions.data(), (int32_t) textDescriptor->textRotations.size(), positionSize * (int32_t) sizeof(float)));
-                textDescriptor->textReferencePositions.resetModificationFlag();
+            const int32_t count = (int32_t) textDescriptor->textRotations.size();
+            auto rangeObject = dynamic_cast<InstancedRangeUpdateInterface *>(textInstancedObject.get());
+
+            uploadedBytes += uploadModifiedInstances(textDescriptor->textPositions, 2, count, rangeObject, InstancedRangeUpdateInterface::Attribute::POSITIONS,
+                                                     [&](const SharedBytes &values) { textInstancedObject->setPositions(values); });
+            if (is3d) {
+                uploadedBytes += uploadModifiedInstances(textDescriptor->textReferencePositions, positionSize, count, rangeObject, InstancedRangeUpdateInterface::Attribute::REFERENCE_POSITIONS,
+                                                         [&](const SharedBytes &values) { textInstancedObject->setReferencePositions(values); });
             }
 
             if (textDescriptor->textStyles.wasModified()) {
                 textInstancedObject->setStyles(SharedBytes((int64_t) textDescriptor->textStyles.data(), (int32_t) textDescriptor->textStyles.size() / 4, 4 * (int32_t) sizeof(float)));
+                uploadedBytes += textDescriptor->textStyles.size() * sizeof(float);
                 textDescriptor->textStyles.resetModificationFlag();
             }
 
-            if (textDescriptor->textScales.wasModified()) {
-                textInstancedObject->setScales(SharedBytes((int64_t) textDescriptor->textScales.data(), (int32_t) textDescriptor->textRotations.size(), 2 * (int32_t) sizeof(float)));
-                textDescriptor->textScales.resetModificationFlag();
-            }
-
-            if (textDescriptor->textAlphas.wasModified()) {
-                textInstancedObject->setAlphas(SharedBytes((int64_t) textDescriptor->textAlphas.data(), (int32_t) textDescriptor->textAlphas.size(), 1 * (int32_t) sizeof(float)));
-                textDescriptor->textAlphas.resetModificationFlag();
-            }
-
-            if (textDescriptor->textRotations.wasModified()) {
-                textInstancedObject->setRotations(
-                                                  SharedBytes((int64_t) textDescriptor->textRotations.data(), (int32_t) textDescriptor->textRotations.size(), 1 * (int32_t) sizeof(float)));
-                textDescriptor->textRotations.resetModificationFlag();
-            }
-
+            uploadedBytes += uploadModifiedInstances(textDescriptor->textScales, 2, count, rangeObject, InstancedRangeUpdateInterface::Attribute::SCALES,
+                                                     [&](const SharedBytes &values) { textInstancedObject->setScales(values); });
+            uploadedBytes += uploadModifiedInstances(textDescriptor->textAlphas, 1, (int32_t) textDescriptor->textAlphas.size(), rangeObject, InstancedRangeUpdateInterface::Attribute::ALPHAS,
+                                                     [&](const SharedBytes &values) { textInstancedObject->setAlphas(values); });
+            uploadedBytes += uploadModifiedInstances(textDescriptor->textRotations, 1, count, rangeObject, InstancedRangeUpdateInterface::Attribute::ROTATIONS,
+                                                     [&](const SharedBytes &values) { textInstancedObject->setRotations(values); });
         }
+        PERF_LOG_COUNT("Tiled2dMapVectorSymbolGroup_uploadedBytes", uploadedBytes);
 
 #ifdef DRAW_TEXT_BOUNDING_BOX
 
@@ -1106,7 +1093,7 @@ Tiled2dMapVectorSymbolGroup::createSymbolObject(const Tiled2dMapVersionedTileInf
                                                           description, featureContext, text, fullText, coordinate, lineCoordinates,
                                                           fontList, textAnchor, angle, textJustify, textSymbolPlacement, hideIcon, animationCoordinatorMap,
                                                           featureStateManager, usedKeys, symbolTileIndex, hasCustomTexture, dpFactor,
-                                                          is3d, tileOrigin, styleIndex);
+                                                          is3d, tileOrigin, styleIndex, shapedTextCache);
     symbolObject->setAlpha(alpha);
     const auto counts = symbolObject->getInstanceCounts();
     if (counts.icons + counts.stretchedIcons + counts.textCharacters == 0) {
@@ -1146,6 +1133,7 @@ void Tiled2dMapVectorSymbolGroup::setAlpha(float alpha) {
     for (auto const object: symbolObjects) {
         object->setAlpha(alpha);
     }
+    updateTracker.invalidate();
 }
 
 void Tiled2dMapVectorSymbolGroup::clear() {
@@ -1167,18 +1155,21 @@ void Tiled2dMapVectorSymbolGroup::clear() {
         textInstancedObject->asGraphicsObject()->clear();
     }
     isInitialized = false;
+    updateTracker.invalidate();
 }
 
 void Tiled2dMapVectorSymbolGroup::placedInCache() {
     for (auto const object: symbolObjects) {
         object->placedInCache();
     }
+    updateTracker.invalidate();
 }
 
 void Tiled2dMapVectorSymbolGroup::removeFromCache() {
     for (auto const object: symbolObjects) {
         object->removeFromCache();
     }
+    updateTracker.invalidate();
 }
 
 
@@ -12,6 +12,7 @@
 
 #include "Tiled2dMapVectorLayer.h"
 #include "Tiled2dMapVectorSymbolObject.h"
+#include "Tiled2dMapVectorSymbolUpdateState.h"
 #include "MapInterface.h"
 #include "Tiled2dMapTileInfo.h"
 #include "Tiled2dMapVersionedTileInfo.h"
@@ -25,6 +26,7 @@
 #include "Quad2dStretchedInstancedInterface.h"
 #include "PolygonGroup2dLayerObject.h"
 #include "Tiled2dMapVectorLayerSymbolDelegateInterface.h"
+#include "Tiled2dMapVectorCustomAssetCache.h"
 #include "CollisionGrid.h"
 #include "RenderObjectInterface.h"
 #include "VectorModificationWrapper.h"
@@ -45,7 +47,9 @@ public:
                                 const std::string &layerIdentifier,
                                 const std::shared_ptr<SymbolVectorLayerDescription> &layerDescription,
                                 const std::shared_ptr<Tiled2dMapVectorStateManager> &featureStateManager,
-                                const std::shared_ptr<Tiled2dMapVectorLayerSymbolDelegateInterface> &symbolDelegate);
+                                const std::shared_ptr<Tiled2dMapVectorLayerSymbolDelegateInterface> &symbolDelegate,
+                                const std::shared_ptr<Tiled2dMapVectorCustomAssetCache> &customAssetCache,
+                                const std::shared_ptr<Tiled2dMapVectorShapedTextCache> &shapedTextCache);
 
     void initialize(std::weak_ptr<std::vector<Tiled2dMapVectorTileInfo::FeatureTuple>> weakFeatures,
                     int32_t featuresBase,
@@ -54,7 +58,11 @@ public:
                     const WeakActor<Tiled2dMapVectorSourceSymbolDataManager> &symbolManagerActor,
                     float alpha = 1.0);
 
-    bool update(const double zoomIdentifier, const double rotation, const double scaleFactor, int64_t now, const Vec2I viewPortSize, const std::vector<float>& vpMatrix, const Vec3D& origin);
+    using UpdateState = Tiled2dMapVectorSymbolUpdateState;
+
+    // Skips all objects if none of the inputs changed and no animation is running. If only animations are running, the
+    // objects with a running animation are updated.
+    bool update(const double zoomIdentifier, const double rotation, const double scaleFactor, int64_t now, const Vec2I viewPortSize, const std::vector<float>& vpMatrix, const Vec3D& origin, UpdateState &updateState);
 
     void setupObjects(const std::vector<std::pair<std::shared_ptr<SpriteData>, std::shared_ptr<::TextureHolderInterface>>> &sprites, const std::optional<WeakActor<Tiled2dMapVectorSourceSymbolDataManager>> &symbolDataManager = std::nullopt);
     void addSprite(const std::shared_ptr<SpriteData> &spriteData, const std::shared_ptr<TextureHolderInterface> &spriteTexture);
@@ -212,11 +220,16 @@ private:
 
     bool isInitialized = false;
 
+    // invalidated by everything changing the symbol objects outside of update
+    Tiled2dMapVectorSymbolGroupUpdateTracker updateTracker;
+
     bool is3d;
     Vec3D tileOrigin;
 
     const std::shared_ptr<Tiled2dMapVectorStateManager> featureStateManager;
     const std::shared_ptr<Tiled2dMapVectorLayerSymbolDelegateInterface> &symbolDelegate;
+    const std::shared_ptr<Tiled2dMapVectorCustomAssetCache> customAssetCache;
+    const std::shared_ptr<Tiled2dMapVectorShapedTextCache> shapedTextCache;
 
 #ifdef DRAW_TEXT_BOUNDING_BOX
     TextSymbolPlacement textSymbolPlacement;
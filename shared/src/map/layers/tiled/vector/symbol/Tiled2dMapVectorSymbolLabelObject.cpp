@@ -45,6 +45,7 @@ Tiled2dMapVectorSymbolLabelObject::Tiled2dMapVectorSymbolLabelObject(const std::
                                                                      bool is3d,
                                                                      const Vec3D &tileOrigin,
                                                                      const uint16_t styleIndex,
+                                                                     const std::shared_ptr<Tiled2dMapVectorShapedTextCache> &shapedTextCache,
                                                                      const int32_t systemIdentifier)
         : textSymbolPlacement(textSymbolPlacement),
           rotationAlignment(rotationAlignment),
@@ -69,86 +70,13 @@ Tiled2dMapVectorSymbolLabelObject::Tiled2dMapVectorSymbolLabelObject(const std::
           positionSize(is3d ? 3 : 2),
           styleIndex(styleIndex) {
 
-    for(auto i=0; i<fontResult->fontData->glyphs.size(); ++i) {
-        auto& letter = fontResult->fontData->glyphs[i];
-        if(letter.charCode == " ") {
-            spaceAdvance = letter.advance.x;
-            spaceIndex = i;
-            break;
-        }
-    }
-
-    std::vector<BreakResult> breaks = {};
-    if(textSymbolPlacement == TextSymbolPlacement::POINT) {
-        std::vector<std::string> letters;
-
-        for (const auto &entry: text) {
-            const auto splitText = TextHelper::splitWstring(entry.text);
-            std::copy(splitText.begin(), splitText.end(), std::back_inserter(letters));
-        }
-
-        breaks = TextHelper::bestBreakIndices(letters, maxCharacterWidth);
-    }
-
-    lineEndIndices.push_back(0); // one is always needed
-
-    int currentLetterIndex = 0;
-    for (const auto &entry: text) {
-        for (const auto &c : TextHelper::splitWstring(entry.text)) {
-            int index = -1;
-            bool found = false;
-            bool isSpace = false;
-
-            int i = 0;
-            for (const auto &d : fontResult->fontData->glyphs) {
-                if(c == d.charCode) {
-                    index = i;
-                    found = true;
-                    isSpace = d.charCode == " ";
-                    break;
-                }
-
-                ++i;
-            }
-
-            if(textSymbolPlacement == TextSymbolPlacement::POINT) {
-                // check for line breaks in point texts
-                auto it = std::find_if(breaks.begin(), breaks.end(), [&](const auto& v) { return v.index == currentLetterIndex; });
-                if(it != breaks.end()) {
-                    // add line break
-                    if(it->keepLetter && found) {
-                        if (!isSpace) {
-                            characterCount += 1;
-                        }
-                        splittedTextInfo.emplace_back(index, entry.scale);
-                    }
-                    // use -1 as line break
-                    lineEndIndices.push_back(0.0);
-                    splittedTextInfo.emplace_back(-1, entry.scale);
-                } else {
-                    // just add it
-                    if(found) {
-                        if (!isSpace) {
-                            characterCount += 1;
-                        }
-                        splittedTextInfo.emplace_back(index, entry.scale);
-                    }
-                }
-            } else {
-                // non-point symbols: just add it if found, no line breaks possible
-                if(found) {
-                    if (!isSpace) {
-                        characterCount += 1;
-                    }
-                    splittedTextInfo.emplace_back(index, entry.scale);
-                }
-            }
-
-            currentLetterIndex++;
-        }
-    }
-
-    numSymbols = (int)splittedTextInfo.size();
+    shapedText = shapedTextCache->getShapedText(fontResult, text, textSymbolPlacement, maxCharacterWidth, lineHeight);
+    spaceAdvance = shapedText->spaceAdvance;
+    spaceIndex = shapedText->spaceIndex;
+    characterCount = shapedText->characterCount;
+    medianLastBaseLine = shapedText->medianLastBaseLine;
+    numSymbols = (int)shapedText->splittedTextInfo.size();
+    lineEndIndices.resize(shapedText->numLines, 0);
 
     if(lineCoordinates) {
         std::transform(lineCoordinates->begin(), lineCoordinates->end(), std::back_inserter(renderLineCoordinates),
@@ -179,6 +107,7 @@ Tiled2dMapVectorSymbolLabelObject::Tiled2dMapVectorSymbolLabelObject(const std::
         }
 
         screenLineCoordinates = renderLineCoordinates;
+        screenLineParameterization.update(screenLineCoordinates);
         renderLineCoordinatesCount = renderLineCoordinates.size();
 
         if(!is3d) {
@@ -188,8 +117,6 @@ Tiled2dMapVectorSymbolLabelObject::Tiled2dMapVectorSymbolLabelObject(const std::
         renderLineCoordinatesCount = 0;
     }
 
-    precomputeMedianIfNeeded();
-
     if (textJustify == TextJustify::AUTO) {
         switch (textAnchor) {
             case Anchor::TOP_LEFT:
@@ -214,70 +141,6 @@ Tiled2dMapVectorSymbolLabelObject::Tiled2dMapVectorSymbolLabelObject(const std::
     isStyleStateDependant = usedKeys.isStateDependant();
 }
 
-void Tiled2dMapVectorSymbolLabelObject::precomputeMedianIfNeeded() {
-    if(lineCoordinates && (rotationAlignment != SymbolAlignment::VIEWPORT)) {
-        return;
-    }
-
-    // calculate medians if not on line
-    std::vector<double> heights;
-
-    const auto &glyphs = fontResult->fontData->glyphs;
-    int baseLineStartIndex = 0;
-
-    auto penY = -lineHeight * 0.25;
-
-    int c = 0;
-    for(const auto &i : splittedTextInfo) {
-        if(i.glyphIndex >= 0) {
-            assert(i.glyphIndex < glyphs.size());
-            const auto &d = glyphs[i.glyphIndex];
-
-            auto scale = i.scale;
-            auto size = Vec2D(d.boundingBoxSize.x * scale, d.boundingBoxSize.y * scale);
-            auto bearing = Vec2D(d.bearing.x * scale, d.bearing.y * scale);
-            // auto advance = Vec2D(d.advance.x * scale, d.advance.y * scale);
-
-            if(i.glyphIndex != spaceIndex) {
-                auto y = penY - bearing.y;
-                auto yh = y + size.y;
-                heights.emplace_back(yh);
-                c++;
-            }
-        } else if(i.glyphIndex == -1) {
-            baseLineStartIndex = c;
-            penY += lineHeight;
-        } else {
-            assert(false);
-        }
-    }
-
-    // Last line is a new line or there are no heights,
-    // just take where the penY is at the end
-    int lastLineLength = c - baseLineStartIndex;
-    if(lastLineLength == 0) {
-        medianLastBaseLine = penY;
-        return;
-    }
-
-    // Otherwise compute the median indices
-    std::sort(
-        heights.begin() + baseLineStartIndex,
-        heights.begin() + c
-    );
-
-    int medianOffset = lastLineLength / 2;
-    int median = baseLineStartIndex + medianOffset;
-
-    if (lastLineLength % 2 == 0) {
-        double medianBaseLineLow = heights[median - 1];
-        double medianBaseLineHigh = heights[median];
-        medianLastBaseLine = 0.5 * (medianBaseLineHigh + medianBaseLineLow);
-    } else {
-        medianLastBaseLine = heights[median];
-    }
-}
-
 void Tiled2dMapVectorSymbolLabelObject::updateLayerDescription(const std::shared_ptr<SymbolVectorLayerDescription> layerDescription) {
     this->description = layerDescription;
     const auto &usedKeys = description->getUsedKeys();
@@ -303,18 +166,15 @@ int Tiled2dMapVectorSymbolLabelObject::getCharacterCount(){
 void Tiled2dMapVectorSymbolLabelObject::setupProperties(VectorModificationWrapper<float> &textureCoordinates, VectorModificationWrapper<uint16_t> &styleIndices, int &countOffset, const double zoomIdentifier) {
     evaluateStyleProperties(zoomIdentifier);
 
-    for(auto &i : splittedTextInfo) {
-        if (i.glyphIndex < 0) continue;
-        auto& d = fontResult->fontData->glyphs[i.glyphIndex];
-        if(d.charCode != " ") {
-            textureCoordinates[(4 * countOffset) + 0] = d.uv.topLeft.x;
-            textureCoordinates[(4 * countOffset) + 1] = d.uv.bottomRight.y;
-            textureCoordinates[(4 * countOffset) + 2] = d.uv.bottomRight.x - d.uv.topLeft.x;
-            textureCoordinates[(4 * countOffset) + 3] = d.uv.topLeft.y - d.uv.bottomLeft.y;
+    const auto &glyphTextureCoordinates = shapedText->textureCoordinates;
+    for (int i = 0; i < characterCount; i++) {
+        textureCoordinates[(4 * countOffset) + 0] = glyphTextureCoordinates[4 * i + 0];
+        textureCoordinates[(4 * countOffset) + 1] = glyphTextureCoordinates[4 * i + 1];
+        textureCoordinates[(4 * countOffset) + 2] = glyphTextureCoordinates[4 * i + 2];
+        textureCoordinates[(4 * countOffset) + 3] = glyphTextureCoordinates[4 * i + 3];
 
-            styleIndices[countOffset] = styleIndex;
-            countOffset += 1;
-        }
+        styleIndices[countOffset] = styleIndex;
+        countOffset += 1;
     }
 }
 
@@ -421,6 +281,7 @@ void Tiled2dMapVectorSymbolLabelObject::updateProperties(VectorModificationWrapp
                     std::reverse((*lineCoordinates).begin(), (*lineCoordinates).end());
                     std::reverse(renderLineCoordinates.begin(), renderLineCoordinates.end());
                     std::reverse(screenLineCoordinates.begin(), screenLineCoordinates.end());
+                    screenLineParameterization.update(screenLineCoordinates);
                     std::reverse(cartesianRenderLineCoordinates.begin(), cartesianRenderLineCoordinates.end());
                     if(!is3d) {
                         currentReferencePointIndex = findReferencePointIndices();
@@ -469,7 +330,7 @@ void Tiled2dMapVectorSymbolLabelObject::updatePropertiesPoint(VectorModification
     int lineEndIndicesIndex = 0;
     const auto &glyphs = fontResult->fontData->glyphs;
 
-    for(const auto &i : splittedTextInfo) {
+    for(const auto &i : shapedText->splittedTextInfo) {
         if(i.glyphIndex >= 0) {
             assert(i.glyphIndex < fontResult->fontData->glyphs.size());
             const auto &d = glyphs[i.glyphIndex];
@@ -751,7 +612,7 @@ double Tiled2dMapVectorSymbolLabelObject::updatePropertiesLine(VectorModificatio
     double size = 0;
     const auto &glyphs = fontResult->fontData->glyphs;
 
-    for(const auto &i : splittedTextInfo) {
+    for(const auto &i : shapedText->splittedTextInfo) {
         if(i.glyphIndex < 0) {
             size += spaceAdvance * fontSize * i.scale;
         } else {
@@ -762,23 +623,21 @@ double Tiled2dMapVectorSymbolLabelObject::updatePropertiesLine(VectorModificatio
     }
 
     // updates currentIndex
-    auto currentIndexPoint = pointForIndex(currentIndex, std::nullopt);
-
     switch (textAnchor) {
         case Anchor::TOP_LEFT:
         case Anchor::LEFT:
         case Anchor::BOTTOM_LEFT:
-            indexAtDistance(currentIndex, currentIndexPoint, fontSize * scaleCorrection, currentIndex);
+            indexAtDistance(currentIndex, fontSize * scaleCorrection, currentIndex);
             break;
         case Anchor::TOP_RIGHT:
         case Anchor::RIGHT:
         case Anchor::BOTTOM_RIGHT:
-            indexAtDistance(currentIndex, currentIndexPoint, -size * 1.0 * scaleCorrection, currentIndex);
+            indexAtDistance(currentIndex, -size * 1.0 * scaleCorrection, currentIndex);
             break;
         case Anchor::CENTER:
         case Anchor::TOP:
         case Anchor::BOTTOM:
-            indexAtDistance(currentIndex, currentIndexPoint, -size * 0.5 * scaleCorrection, currentIndex);
+            indexAtDistance(currentIndex, -size * 0.5 * scaleCorrection, currentIndex);
             break;
     }
     
@@ -803,12 +662,11 @@ double Tiled2dMapVectorSymbolLabelObject::updatePropertiesLine(VectorModificatio
     auto indexBefore = DistanceIndex(0, 0.0);
     auto indexAfter = DistanceIndex(0, 0.0);
 
-    for(auto &i : splittedTextInfo) {
+    for(auto &i : shapedText->splittedTextInfo) {
 
         if(i.glyphIndex < 0) {
             // updates current index
-            auto currentIndexPoint = pointForIndex(currentIndex, std::nullopt);
-            indexAtDistance(currentIndex, currentIndexPoint, spaceAdvance * fontSize * i.scale * scaleCorrection, currentIndex);
+            indexAtDistance(currentIndex, spaceAdvance * fontSize * i.scale * scaleCorrection, currentIndex);
             index = 0;
         } else {
             auto& d = glyphs[i.glyphIndex];
@@ -820,11 +678,10 @@ double Tiled2dMapVectorSymbolLabelObject::updatePropertiesLine(VectorModificatio
 
             // Punkt auf Linie
             const auto &p = pointAtIndex(currentIndex, true);
-            auto currentIndexPoint = pointForIndex(currentIndex, p);
 
             // get before and after to calculate angle
-            indexAtDistance(currentIndex, currentIndexPoint, -halfSpace * scaleCorrection, indexBefore);
-            indexAtDistance(currentIndex, currentIndexPoint, halfSpace * scaleCorrection, indexAfter);
+            indexAtDistance(currentIndex, -halfSpace * scaleCorrection, indexBefore);
+            indexAtDistance(currentIndex, halfSpace * scaleCorrection, indexAfter);
 
             const auto &before = is3d ? screenPointAtIndex(indexBefore) : pointAtIndex(indexBefore, false);
             const auto &after = is3d ? screenPointAtIndex(indexAfter) : pointAtIndex(indexAfter, false);
@@ -872,7 +729,7 @@ double Tiled2dMapVectorSymbolLabelObject::updatePropertiesLine(VectorModificatio
             auto lastIndex = currentIndex;
             // update currentIndex
 
-            indexAtDistance(currentIndex, currentIndexPoint, advance.x * (1.0 + letterSpacing) * scaleCorrection, currentIndex);
+            indexAtDistance(currentIndex, advance.x * (1.0 + letterSpacing) * scaleCorrection, currentIndex);
 
             // if we are at the end, and we were at the end (lastIndex), then clear and skip
             if(currentIndex.index == renderLineCoordinatesCount - 1 && lastIndex.index == currentIndex.index && (lastIndex.percentage == currentIndex.percentage)) {
@@ -1029,6 +886,7 @@ void Tiled2dMapVectorSymbolLabelObject::setupCameraFor3D(const std::vector<float
         screenLineCoordinates[i].y = posScreenY;
         ++i;
     }
+    screenLineParameterization.update(screenLineCoordinates);
 
     const auto &cc = Vec4D(cartesianReferencePoint.x - origin.x, cartesianReferencePoint.y - origin.y, cartesianReferencePoint.z - origin.z, 1.0);
     const auto &projected = Matrix::multiply(vpMatrix, cc);
@@ -28,19 +28,11 @@
 #include "Vec2DHelper.h"
 #include "MapCameraInterface.h"
 #include "VectorModificationWrapper.h"
+#include "LineArcLengthParameterization.h"
+#include "Tiled2dMapVectorShapedTextCache.h"
 
 class SymbolAnimationCoordinator;
 
-struct DistanceIndex {
-    int index;
-    double percentage;
-
-    DistanceIndex(int index_, double percentage_)
-    : index(std::move(index_))
-    , percentage(std::move(percentage_))
-    {}
-};
-
 class Tiled2dMapVectorSymbolLabelObject {
 public:
     Tiled2dMapVectorSymbolLabelObject(const std::shared_ptr<CoordinateConversionHelperInterface> &converter,
@@ -67,6 +59,7 @@ public:
                                       bool is3d,
                                       const Vec3D &tileOrigin,
                                       const uint16_t styleIndex,
+                                      const std::shared_ptr<Tiled2dMapVectorShapedTextCache> &shapedTextCache,
                                       const int32_t systemIdentifier);
 
     int getCharacterCount();
@@ -93,8 +86,6 @@ public:
     Vec3D tileOrigin = Vec3D(0,0,0);
 
 private:
-    void precomputeMedianIfNeeded();
-
     void setupCameraFor3D(const std::vector<float>& vpMatrix, const Vec3D& origin, const Vec2I& viewportSize);
 
     void writePosition(const double x, const double y, const size_t offset, VectorModificationWrapper<float> &buffer);
@@ -121,67 +112,8 @@ private:
         return Vec2D(s.x + (e.x - s.x) * index.percentage, s.y + (e.y - s.y) * index.percentage);
     }
 
-    Vec2D pointForIndex(const DistanceIndex &index, const std::optional<Vec2D> &indexCoord) {
-        return is3d ? screenPointAtIndex(index) : (indexCoord ? *indexCoord : pointAtIndex(index, true));
-    }
-
-    inline void indexAtDistance(const DistanceIndex &index, const Vec2D& currentPoint, double distance, DistanceIndex& result) {
-        auto dist = std::abs(distance);
-        auto current = currentPoint;
-
-        int currentI = index.index;
-        double currentPercentage = index.percentage;
-
-        if(distance >= 0) {
-            auto start = std::min(index.index + 1, (int)renderLineCoordinatesCount - 1);
-
-            for(int i = start; i < renderLineCoordinatesCount; i++) {
-                const auto &next = screenLineCoordinates[i];
-
-                const double d = Vec2DHelper::distance(current, Vec2D(next.x, next.y));
-
-                if(dist > d) {
-                    dist -= d;
-                    current.x = next.x;
-                    current.y = next.y;
-                    currentI = i;
-                    currentPercentage = 0;
-                } else {
-                    result.index = currentI;
-                    result.percentage = currentPercentage + dist / d * (1.0 - currentPercentage);
-                    return;
-                }
-            }
-        } else {
-            auto start = index.index;
-
-            for(int i = start; i >= 0; i--) {
-                const auto &next = screenLineCoordinates[i];
-
-                const auto d = Vec2DHelper::distance(current, Vec2D(next.x, next.y));
-
-                if(dist > d) {
-                    dist -= d;
-                    current.x = next.x;
-                    current.y = next.y;
-
-                    currentI = i;
-                    currentPercentage = 0.0;
-                } else {
-                    if(i == currentI) {
-                        result.index = i;
-                        result.percentage = currentPercentage - currentPercentage * dist / d;
-                        return;
-                    } else {
-                        result.index = i;
-                        result.percentage = 1.0 - dist / d;
-                        return;
-                    }
-                }
-            }
-        }
-
-        result = DistanceIndex(currentI, currentPercentage);
+    inline void indexAtDistance(const DistanceIndex &index, double distance, DistanceIndex& result) {
+        result = screenLineParameterization.indexAtDistance(index, distance);
     }
 
     std::shared_ptr<SymbolVectorLayerDescription> description;
@@ -209,14 +141,9 @@ private:
     std::vector<Vec2D> centerPositions;
     std::vector<size_t> lineEndIndices;
 
-    struct SplitInfo {
-        SplitInfo(int g, float s) : glyphIndex(g), scale(s) {};
-        int glyphIndex;
-        float scale;
-    };
-
+    // glyphs and line breaks, shared by the labels with the same text
+    std::shared_ptr<const Tiled2dMapVectorShapedText> shapedText;
     int characterCount = 0;
-    std::vector<SplitInfo> splittedTextInfo;
     int numSymbols;
     int spaceIndex = -1;
 
@@ -225,6 +152,8 @@ private:
     size_t renderLineCoordinatesCount;
     std::vector<Vec3D> renderLineCoordinates;
     std::vector<Vec3D> screenLineCoordinates;
+    // arc-length parameterization of screenLineCoordinates, updated whenever they change
+    LineArcLengthParameterization screenLineParameterization;
     std::vector<Vec3D> cartesianRenderLineCoordinates;
     std::optional<std::vector<Vec2D>> lineCoordinates;
     DistanceIndex currentReferencePointIndex = DistanceIndex(0, 0.0);
@@ -49,7 +49,8 @@ Tiled2dMapVectorSymbolObject::Tiled2dMapVectorSymbolObject(const std::weak_ptr<M
                                                            const double dpFactor,
                                                            bool is3d,
                                                            const Vec3D &tileOrigin,
-                                                           const uint16_t styleIndex) :
+                                                           const uint16_t styleIndex,
+                                                           const std::shared_ptr<Tiled2dMapVectorShapedTextCache> &shapedTextCache) :
     description(description),
     layerConfig(layerConfig),
     coordinate(coordinate),
@@ -122,10 +123,10 @@ Tiled2dMapVectorSymbolObject::Tiled2dMapVectorSymbolObject(const std::weak_ptr<M
 
         for (const auto &font: fontList) {
             // try to load a font until we succeed
-            fontResult = fontProvider.syncAccess([font] (auto provider) -> std::shared_ptr<FontLoaderResult>  {
+            fontResult = fontProvider.syncAccess([&font, &fullText] (auto provider) -> std::shared_ptr<FontLoaderResult>  {
                 auto ptr = provider.lock();
                 if (ptr) {
-                    return ptr->loadFont(font);
+                    return ptr->loadFont(font, fullText);
                 } else {
                     return nullptr;
                 }
@@ -156,6 +157,7 @@ Tiled2dMapVectorSymbolObject::Tiled2dMapVectorSymbolObject(const std::weak_ptr<M
                                                                               is3d,
                                                                               tileOrigin,
                                                                               styleIndex,
+                                                                              shapedTextCache,
                                                                               systemIdentifier);
 
             instanceCounts.textCharacters = labelObject->getCharacterCount();
@@ -970,24 +972,25 @@ bool Tiled2dMapVectorSymbolObject::isPlaced() {
     return false;
 }
 
-void Tiled2dMapVectorSymbolObject::setHideFromCollision(bool hide) {
+bool Tiled2dMapVectorSymbolObject::setHideFromCollision(bool hide) {
     if(animationCoordinator->setColliding(hide)) {
         lastIconUpdateScaleFactor = -1;
         lastStretchIconUpdateScaleFactor = -1;
         lastTextUpdateScaleFactor = -1;
+        return true;
     }
+    return false;
 }
 
-void Tiled2dMapVectorSymbolObject::collisionDetection(const double zoomIdentifier, const double rotation, const double scaleFactor, std::shared_ptr<CollisionGrid> collisionGrid) {
+bool Tiled2dMapVectorSymbolObject::collisionDetection(const double zoomIdentifier, const double rotation, const double scaleFactor, std::shared_ptr<CollisionGrid> collisionGrid) {
 
     if (!isCoordinateOwner) {
-        return;
+        return false;
     }
 
     if (!(description->minZoom <= zoomIdentifier && description->maxZoom >= zoomIdentifier) || !getIsOpaque() || !isPlaced()) {
         // not visible
-        setHideFromCollision(true);
-        return;
+        return setHideFromCollision(true);
     }
 
     auto visibleIn3d = true;
@@ -1003,8 +1006,7 @@ void Tiled2dMapVectorSymbolObject::collisionDetection(const double zoomIdentifie
 
     if(!visibleIn3d) {
         // not visible
-        setHideFromCollision(true);
-        return;
+        return setHideFromCollision(true);
     }
 
     bool willCollide = true;
@@ -1034,9 +1036,9 @@ void Tiled2dMapVectorSymbolObject::collisionDetection(const double zoomIdentifie
     }
 
     if (!outside) {
-        setHideFromCollision(willCollide);
+        return setHideFromCollision(willCollide);
     }
-
+    return false;
 }
 
 std::optional<std::tuple<Coord, VectorLayerFeatureInfo>> Tiled2dMapVectorSymbolObject::onClickConfirmed(const CircleD &clickHitCircle, double zoomIdentifier, CollisionUtil::CollisionEnvironment &collisionEnvironment, const StringInterner &stringTable) {
@@ -55,7 +55,8 @@ public:
                                  const double dpFactor,
                                  bool is3d,
                                  const Vec3D &tileOrigin,
-                                 const uint16_t styleIndex);
+                                 const uint16_t styleIndex,
+                                 const std::shared_ptr<Tiled2dMapVectorShapedTextCache> &shapedTextCache);
 
     ~Tiled2dMapVectorSymbolObject();
 
@@ -95,9 +96,10 @@ public:
 
     bool getIsOpaque();
 
-    void setHideFromCollision(bool hide);
+    // returns true if the collision state of the symbol changed
+    bool setHideFromCollision(bool hide);
 
-    void collisionDetection(const double zoomIdentifier, const double rotation, const double scaleFactor, std::shared_ptr<CollisionGrid> collisionGrid);
+    bool collisionDetection(const double zoomIdentifier, const double rotation, const double scaleFactor, std::shared_ptr<CollisionGrid> collisionGrid);
 
     std::optional<std::tuple<Coord, VectorLayerFeatureInfo>> onClickConfirmed(const CircleD &clickHitCircle, double zoomIdentifier, CollisionUtil::CollisionEnvironment &collisionEnvironment, const StringInterner &stringTable);
 
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "Vec2I.h"
+#include "Vec3D.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Inputs of a symbol group update which are not passed as values: the epochs are increased by the symbol data manager
+ * whenever the camera (zoom, rotation, scaling, viewport, matrices) or the collision or ownership state of the symbols
+ * changes. The counters are summed up over all groups of a frame.
+ */
+struct Tiled2dMapVectorSymbolUpdateState {
+    uint64_t cameraEpoch = 0;
+    uint64_t collisionEpoch = 0;
+    size_t updatedObjects = 0;
+    size_t skippedObjects = 0;
+};
+
+/**
+ * Counts the changes of the camera values the symbol groups are updated with.
+ */
+class Tiled2dMapVectorSymbolCameraEpoch {
+  public:
+    // Returns the epoch, increased if any of the values differs from the last call
+    uint64_t update(double zoomIdentifier, double rotation, double scaleFactor, const Vec2I &viewPortSize,
+                    const std::vector<float> &vpMatrix, const Vec3D &origin) {
+        if (zoomIdentifier != lastZoomIdentifier || rotation != lastRotation || scaleFactor != lastScaleFactor ||
+            viewPortSize.x != lastViewPortSize.x || viewPortSize.y != lastViewPortSize.y || vpMatrix != lastVpMatrix ||
+            origin != lastOrigin) {
+            epoch++;
+            lastZoomIdentifier = zoomIdentifier;
+            lastRotation = rotation;
+            lastScaleFactor = scaleFactor;
+            lastViewPortSize = viewPortSize;
+            lastVpMatrix = vpMatrix;
+            lastOrigin = origin;
+        }
+        return epoch;
+    }
+
+  private:
+    uint64_t epoch = 0;
+    double lastZoomIdentifier = -1;
+    double lastRotation = 0;
+    double lastScaleFactor = 0;
+    Vec2I lastViewPortSize = Vec2I(0, 0);
+    std::vector<float> lastVpMatrix;
+    Vec3D lastOrigin = Vec3D(0, 0, 0);
+};
+
+/**
+ * Decides how much of a symbol group an update has to touch: all objects if any input changed since the last update,
+ * only the objects with a running animation if nothing else changed, and none otherwise.
+ */
+class Tiled2dMapVectorSymbolGroupUpdateTracker {
+  public:
+    enum class UpdateMode { NONE, ANIMATIONS, ALL };
+
+    // The symbol objects were changed outside of an update
+    void invalidate() { needsUpdate = true; }
+
+    // anyAnimating is only called if no input changed
+    template <typename AnyAnimating>
+    UpdateMode beginUpdate(const Tiled2dMapVectorSymbolUpdateState &state, int32_t featureStateId, AnyAnimating &&anyAnimating) {
+        const bool inputsChanged = needsUpdate || lastCameraEpoch != state.cameraEpoch || lastCollisionEpoch != state.collisionEpoch ||
+                                   lastFeatureStateId != featureStateId;
+        if (!inputsChanged && !anyAnimating()) {
+            return UpdateMode::NONE;
+        }
+        needsUpdate = false;
+        lastCameraEpoch = state.cameraEpoch;
+        lastCollisionEpoch = state.collisionEpoch;
+        lastFeatureStateId = featureStateId;
+        return inputsChanged ? UpdateMode::ALL : UpdateMode::ANIMATIONS;
+    }
+
+  private:
+    bool needsUpdate = true;
+    uint64_t lastCameraEpoch = 0;
+    uint64_t lastCollisionEpoch = 0;
+    int32_t lastFeatureStateId = -1;
+};
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <optional>
+
+/**
+ * Sub-allocator for ranges of a shared buffer (vertices, style slots, ...). Released ranges are kept in a free-list
+ * and reused first-fit, adjacent free ranges are coalesced and trailing free space shrinks the used extent again.
+ */
+class Tiled2dMapVectorGeometryArena {
+public:
+    explicit Tiled2dMapVectorGeometryArena(size_t capacity = std::numeric_limits<size_t>::max())
+        : capacity(capacity) {}
+
+    std::optional<size_t> allocate(size_t count) {
+        if (count == 0) {
+            return std::nullopt;
+        }
+
+        for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it) {
+            if (it->second < count) {
+                continue;
+            }
+            size_t offset = it->first;
+            size_t remaining = it->second - count;
+            freeRanges.erase(it);
+            if (remaining > 0) {
+                freeRanges[offset + count] = remaining;
+            }
+            used += count;
+            return offset;
+        }
+
+        if (count > capacity - end) {
+            return std::nullopt;
+        }
+        size_t offset = end;
+        end += count;
+        used += count;
+        return offset;
+    }
+
+    void release(size_t offset, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        used -= count;
+
+        auto next = freeRanges.lower_bound(offset);
+        if (next != freeRanges.end() && offset + count == next->first) {
+            count += next->second;
+            next = freeRanges.erase(next);
+        }
+        if (next != freeRanges.begin()) {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second == offset) {
+                offset = prev->first;
+                count += prev->second;
+                freeRanges.erase(prev);
+            }
+        }
+
+        if (offset + count == end) {
+            end = offset;
+        } else {
+            freeRanges[offset] = count;
+        }
+    }
+
+    void reset() {
+        freeRanges.clear();
+        end = 0;
+        used = 0;
+    }
+
+    /** Size of the buffer region that is in use, including free ranges in between allocations */
+    size_t getEnd() const { return end; }
+
+    size_t getUsed() const { return used; }
+
+    size_t getCapacity() const { return capacity; }
+
+    bool isEmpty() const { return used == 0; }
+
+private:
+    size_t capacity;
+    size_t end = 0;
+    size_t used = 0;
+    std::map<size_t, size_t> freeRanges;
+};
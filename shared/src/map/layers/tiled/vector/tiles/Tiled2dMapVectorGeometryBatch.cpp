@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "Tiled2dMapVectorGeometryBatch.h"
+#include "RenderObject.h"
+#include "Logger.h"
+#include "PerformanceLogger.h"
+#include <cstring>
+
+Tiled2dMapVectorGeometryBatch::Tiled2dMapVectorGeometryBatch(size_t floatsPerVertex, size_t positionComponents,
+                                                             size_t maxStylesPerGroup, size_t maxVerticesPerGroup)
+        : floatsPerVertex(floatsPerVertex),
+          positionComponents(positionComponents),
+          maxStylesPerGroup(maxStylesPerGroup),
+          maxVerticesPerGroup(maxVerticesPerGroup) {}
+
+void Tiled2dMapVectorGeometryBatch::registerTile(const Tiled2dMapVersionedTileInfo &tile) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    registeredTiles.insert(tile);
+}
+
+void Tiled2dMapVectorGeometryBatch::removeTile(const Tiled2dMapVersionedTileInfo &tile) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    registeredTiles.erase(tile);
+    releaseTileEntries(tile);
+    activeTiles.erase(tile);
+}
+
+bool Tiled2dMapVectorGeometryBatch::containsTile(const Tiled2dMapVersionedTileInfo &tile) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    return registeredTiles.count(tile) > 0;
+}
+
+bool Tiled2dMapVectorGeometryBatch::isEmpty() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    return registeredTiles.empty();
+}
+
+void Tiled2dMapVectorGeometryBatch::setTileGeometry(const Tiled2dMapVersionedTileInfo &tile, const Vec3D &tileOrigin,
+                                                    std::vector<TileGeometry> &&geometries) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (registeredTiles.count(tile) == 0) {
+        // tile was removed in the meantime
+        return;
+    }
+
+    releaseTileEntries(tile);
+
+    if (!origin) {
+        origin = tileOrigin;
+    }
+    const float offset[3] = {(float) (tileOrigin.x - origin->x), (float) (tileOrigin.y - origin->y), (float) (tileOrigin.z - origin->z)};
+    const bool isActive = activeTiles.count(tile) > 0;
+
+    std::vector<Entry> entries;
+    for (auto &geometry: geometries) {
+        const size_t vertexCount = geometry.vertices.size() / floatsPerVertex;
+        if (vertexCount == 0 || geometry.indices.empty()) {
+            continue;
+        }
+
+        auto entry = allocateEntry(entries, geometry.styleGroupIndex, geometry.numStyles, vertexCount);
+        if (!entry) {
+            LogError <<= "Unable to batch tile geometry with " + std::to_string(vertexCount) + " vertices";
+            continue;
+        }
+
+        auto &group = groups[entry->groupIndex];
+        group.vertices.resize(group.vertexArena.getEnd() * floatsPerVertex);
+
+        float *target = group.vertices.data() + entry->vertexOffset * floatsPerVertex;
+        std::memcpy(target, geometry.vertices.data(), vertexCount * floatsPerVertex * sizeof(float));
+        for (size_t v = 0; v < vertexCount; v++) {
+            float *vertex = target + v * floatsPerVertex;
+            for (size_t c = 0; c < positionComponents; c++) {
+                vertex[c] += offset[c];
+            }
+            vertex[floatsPerVertex - 1] += (float) entry->styleOffset;
+        }
+
+        entry->indices = std::move(geometry.indices);
+        group.geometryDirty |= isActive;
+        entries.push_back(std::move(*entry));
+    }
+
+    tileEntries[tile] = std::move(entries);
+}
+
+std::optional<Tiled2dMapVectorGeometryBatch::Entry> Tiled2dMapVectorGeometryBatch::allocateEntry(const std::vector<Entry> &tileEntries,
+                                                                                                 int32_t styleGroupIndex,
+                                                                                                 size_t styleCount,
+                                                                                                 size_t vertexCount) {
+    if (vertexCount > maxVerticesPerGroup || styleCount > maxStylesPerGroup) {
+        return std::nullopt;
+    }
+
+    // a style group split into multiple parts shares its style slots if the parts fit into the same group
+    for (const auto &other: tileEntries) {
+        if (other.styleGroupIndex != styleGroupIndex || !other.ownsStyles) {
+            continue;
+        }
+        auto vertexOffset = groups[other.groupIndex].vertexArena.allocate(vertexCount);
+        if (vertexOffset) {
+            return Entry{styleGroupIndex, other.groupIndex, *vertexOffset, vertexCount, other.styleOffset, other.styleCount, false, {}};
+        }
+    }
+
+    for (size_t groupIndex = 0; groupIndex <= groups.size(); groupIndex++) {
+        if (groupIndex == groups.size()) {
+            groups.push_back(Group{Tiled2dMapVectorGeometryArena(maxVerticesPerGroup), Tiled2dMapVectorGeometryArena(maxStylesPerGroup)});
+        }
+        auto &group = groups[groupIndex];
+        auto styleOffset = group.styleArena.allocate(styleCount);
+        if (!styleOffset) {
+            continue;
+        }
+        auto vertexOffset = group.vertexArena.allocate(vertexCount);
+        if (!vertexOffset) {
+            group.styleArena.release(*styleOffset, styleCount);
+            continue;
+        }
+        return Entry{styleGroupIndex, groupIndex, *vertexOffset, vertexCount, *styleOffset, styleCount, true, {}};
+    }
+    return std::nullopt;
+}
+
+void Tiled2dMapVectorGeometryBatch::releaseTileEntries(const Tiled2dMapVersionedTileInfo &tile) {
+    auto it = tileEntries.find(tile);
+    if (it == tileEntries.end()) {
+        return;
+    }
+
+    const bool isActive = activeTiles.count(tile) > 0;
+    for (const auto &entry: it->second) {
+        auto &group = groups[entry.groupIndex];
+        group.vertexArena.release(entry.vertexOffset, entry.vertexCount);
+        if (entry.ownsStyles) {
+            group.styleArena.release(entry.styleOffset, entry.styleCount);
+        }
+        group.geometryDirty |= isActive;
+        if (group.vertexArena.isEmpty()) {
+            group.vertices.clear();
+            group.vertices.shrink_to_fit();
+            group.geometryDirty = true;
+        }
+    }
+    tileEntries.erase(it);
+}
+
+void Tiled2dMapVectorGeometryBatch::setTileStyles(const Tiled2dMapVersionedTileInfo &tile, int32_t styleGroupIndex, const SharedBytes &styles) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = tileEntries.find(tile);
+    if (it == tileEntries.end()) {
+        return;
+    }
+
+    if (styleSizeBytes == 0) {
+        styleSizeBytes = styles.bytesPerElement;
+    } else if (styleSizeBytes != styles.bytesPerElement) {
+        LogError <<= "Inconsistent style size in geometry batch";
+        return;
+    }
+
+    for (const auto &entry: it->second) {
+        if (entry.styleGroupIndex != styleGroupIndex || !entry.ownsStyles) {
+            continue;
+        }
+        auto &group = groups[entry.groupIndex];
+        group.styles.resize(std::max(group.styles.size(), group.styleArena.getEnd() * styleSizeBytes));
+        const size_t count = std::min((size_t) styles.elementCount, entry.styleCount);
+        std::memcpy(group.styles.data() + entry.styleOffset * styleSizeBytes, (void *) styles.address, count * styleSizeBytes);
+        group.stylesDirty = true;
+    }
+}
+
+void Tiled2dMapVectorGeometryBatch::setActiveTiles(const std::unordered_set<Tiled2dMapVersionedTileInfo> &tiles) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (tiles == activeTiles) {
+        return;
+    }
+
+    auto markDirty = [&](const Tiled2dMapVersionedTileInfo &tile) {
+        auto it = tileEntries.find(tile);
+        if (it == tileEntries.end()) {
+            return;
+        }
+        for (const auto &entry: it->second) {
+            groups[entry.groupIndex].geometryDirty = true;
+        }
+    };
+
+    for (const auto &tile: tiles) {
+        if (activeTiles.count(tile) == 0) {
+            markDirty(tile);
+        }
+    }
+    for (const auto &tile: activeTiles) {
+        if (tiles.count(tile) == 0) {
+            markDirty(tile);
+        }
+    }
+
+    activeTiles = tiles;
+}
+
+void Tiled2dMapVectorGeometryBatch::setHidden(bool hidden) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (this->hidden == hidden) {
+        return;
+    }
+    this->hidden = hidden;
+    for (const auto &group: groups) {
+        if (group.renderObject) {
+            group.renderObject->setHidden(hidden);
+        }
+    }
+}
+
+bool Tiled2dMapVectorGeometryBatch::needsUpload() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    for (const auto &group: groups) {
+        if (group.geometryDirty) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Tiled2dMapVectorGeometryBatch::upload(const std::shared_ptr<RenderingContextInterface> &context) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+
+    for (size_t groupIndex = 0; groupIndex < groups.size(); groupIndex++) {
+        auto &group = groups[groupIndex];
+        if (!group.geometryDirty) {
+            continue;
+        }
+        group.geometryDirty = false;
+
+        std::vector<uint32_t> indices;
+        for (const auto &tile: activeTiles) {
+            auto it = tileEntries.find(tile);
+            if (it == tileEntries.end()) {
+                continue;
+            }
+            for (const auto &entry: it->second) {
+                if (entry.groupIndex != groupIndex) {
+                    continue;
+                }
+                const auto base = (uint32_t) entry.vertexOffset;
+                for (const auto index: entry.indices) {
+                    indices.push_back(base + index);
+                }
+            }
+        }
+
+        group.numIndices = indices.size();
+        if (indices.empty()) {
+            continue;
+        }
+
+        if (!group.graphicsObject) {
+            group.graphicsObject = createGroupObject(groupIndex);
+            group.renderObject = std::make_shared<RenderObject>(group.graphicsObject);
+            group.renderObject->setHidden(hidden);
+            group.stylesDirty = true;
+        }
+
+        setGroupGeometry(groupIndex, group.vertices, indices, *origin);
+        group.graphicsObject->setup(context);
+
+        PERF_LOG_COUNT("GeometryBatch_uploadedBytes", group.vertices.size() * sizeof(float) + indices.size() * sizeof(uint32_t));
+    }
+
+    updateStyles();
+}
+
+void Tiled2dMapVectorGeometryBatch::updateStyles() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    for (size_t groupIndex = 0; groupIndex < groups.size(); groupIndex++) {
+        auto &group = groups[groupIndex];
+        if (!group.stylesDirty || !group.graphicsObject || group.styles.empty()) {
+            continue;
+        }
+        group.stylesDirty = false;
+        const auto numStyles = (int32_t) (group.styles.size() / styleSizeBytes);
+        setGroupStyles(groupIndex, SharedBytes((int64_t) group.styles.data(), numStyles, (int32_t) styleSizeBytes));
+    }
+}
+
+void Tiled2dMapVectorGeometryBatch::clear() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    for (auto &group: groups) {
+        if (group.graphicsObject && group.graphicsObject->isReady()) {
+            group.graphicsObject->clear();
+        }
+        group.geometryDirty = true;
+        group.stylesDirty = true;
+    }
+}
+
+std::vector<std::shared_ptr<RenderObjectInterface>> Tiled2dMapVectorGeometryBatch::getRenderObjects() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::vector<std::shared_ptr<RenderObjectInterface>> renderObjects;
+    for (const auto &group: groups) {
+        if (group.renderObject && group.numIndices > 0) {
+            renderObjects.push_back(group.renderObject);
+        }
+    }
+    return renderObjects;
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "Tiled2dMapVectorGeometryArena.h"
+#include "Tiled2dMapVersionedTileInfo.h"
+#include "GraphicsObjectInterface.h"
+#include "RenderObjectInterface.h"
+#include "RenderingContextInterface.h"
+#include "SharedBytes.h"
+#include "Vec3D.h"
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Shared geometry of one style layer for a block of tiles of the same zoom level.
+ *
+ * Tiles hand over their CPU-side geometry instead of creating their own graphics objects. The vertices are
+ * sub-allocated in a few shared buffers (groups), each with its own shader and style slots, so that all tiles
+ * of the layer are drawn with one call per group. Only the tiles set with setActiveTiles are part of the index
+ * buffers. Geometry and index changes are uploaded on the graphics thread with upload().
+ */
+class Tiled2dMapVectorGeometryBatch {
+public:
+    struct TileGeometry {
+        // style group of the tile, all its style indices in the vertices are local to this group
+        int32_t styleGroupIndex;
+        int32_t numStyles;
+        std::vector<float> vertices;
+        std::vector<uint32_t> indices;
+    };
+
+    Tiled2dMapVectorGeometryBatch(size_t floatsPerVertex, size_t positionComponents, size_t maxStylesPerGroup, size_t maxVerticesPerGroup);
+
+    virtual ~Tiled2dMapVectorGeometryBatch() = default;
+
+    void registerTile(const Tiled2dMapVersionedTileInfo &tile);
+
+    void removeTile(const Tiled2dMapVersionedTileInfo &tile);
+
+    bool containsTile(const Tiled2dMapVersionedTileInfo &tile);
+
+    bool isEmpty();
+
+    /**
+     * Replaces the geometry of a tile. The vertex positions are relative to tileOrigin, the last attribute of each
+     * vertex is the style index within the style group.
+     */
+    void setTileGeometry(const Tiled2dMapVersionedTileInfo &tile, const Vec3D &tileOrigin, std::vector<TileGeometry> &&geometries);
+
+    void setTileStyles(const Tiled2dMapVersionedTileInfo &tile, int32_t styleGroupIndex, const SharedBytes &styles);
+
+    void setActiveTiles(const std::unordered_set<Tiled2dMapVersionedTileInfo> &tiles);
+
+    void setHidden(bool hidden);
+
+    bool needsUpload();
+
+    /** Ensure calling on graphics thread */
+    void upload(const std::shared_ptr<RenderingContextInterface> &context);
+
+    /** Ensure calling on graphics thread */
+    void updateStyles();
+
+    /** Ensure calling on graphics thread */
+    void clear();
+
+    std::vector<std::shared_ptr<RenderObjectInterface>> getRenderObjects();
+
+protected:
+    virtual std::shared_ptr<GraphicsObjectInterface> createGroupObject(size_t groupIndex) = 0;
+
+    virtual void setGroupGeometry(size_t groupIndex, const std::vector<float> &vertices, const std::vector<uint32_t> &indices,
+                                  const Vec3D &origin) = 0;
+
+    virtual void setGroupStyles(size_t groupIndex, const SharedBytes &styles) = 0;
+
+    std::recursive_mutex mutex;
+
+private:
+    struct Group {
+        Tiled2dMapVectorGeometryArena vertexArena;
+        Tiled2dMapVectorGeometryArena styleArena;
+        std::vector<float> vertices;
+        std::vector<uint8_t> styles;
+        std::shared_ptr<GraphicsObjectInterface> graphicsObject;
+        std::shared_ptr<RenderObjectInterface> renderObject;
+        size_t numIndices = 0;
+        bool geometryDirty = false;
+        bool stylesDirty = false;
+    };
+
+    struct Entry {
+        int32_t styleGroupIndex;
+        size_t groupIndex;
+        size_t vertexOffset;
+        size_t vertexCount;
+        size_t styleOffset;
+        size_t styleCount;
+        bool ownsStyles;
+        std::vector<uint32_t> indices;
+    };
+
+    std::optional<Entry> allocateEntry(const std::vector<Entry> &tileEntries, int32_t styleGroupIndex, size_t styleCount,
+                                       size_t vertexCount);
+
+    void releaseTileEntries(const Tiled2dMapVersionedTileInfo &tile);
+
+    const size_t floatsPerVertex;
+    const size_t positionComponents;
+    const size_t maxStylesPerGroup;
+    const size_t maxVerticesPerGroup;
+
+    std::optional<Vec3D> origin;
+    size_t styleSizeBytes = 0;
+    bool hidden = false;
+
+    std::vector<Group> groups;
+    std::unordered_set<Tiled2dMapVersionedTileInfo> registeredTiles;
+    std::unordered_set<Tiled2dMapVersionedTileInfo> activeTiles;
+    std::unordered_map<Tiled2dMapVersionedTileInfo, std::vector<Entry>> tileEntries;
+};
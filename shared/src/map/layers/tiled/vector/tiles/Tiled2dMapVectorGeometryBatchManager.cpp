@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "Tiled2dMapVectorGeometryBatchManager.h"
+#include <algorithm>
+
+Tiled2dMapVectorGeometryBatchManager::BlockKey Tiled2dMapVectorGeometryBatchManager::getBlockKey(const Tiled2dMapVersionedTileInfo &tile) {
+    return BlockKey{tile.tileInfo.zoomIdentifier, tile.tileInfo.t, tile.tileInfo.x >> batchZoomLevelSpan, tile.tileInfo.y >> batchZoomLevelSpan};
+}
+
+std::shared_ptr<Tiled2dMapVectorGeometryBatch> Tiled2dMapVectorGeometryBatchManager::registerTile(int32_t layerIndex,
+                                                                                                  const Tiled2dMapVersionedTileInfo &tile,
+                                                                                                  const std::function<std::shared_ptr<Tiled2dMapVectorGeometryBatch>()> &createBatch) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto &batch = batches[layerIndex][getBlockKey(tile)];
+    if (!batch) {
+        batch = createBatch();
+    }
+    batch->registerTile(tile);
+    return batch;
+}
+
+void Tiled2dMapVectorGeometryBatchManager::removeTile(const Tiled2dMapVersionedTileInfo &tile) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::vector<int32_t> layerIndices;
+    for (const auto &[layerIndex, layerBatches]: batches) {
+        layerIndices.push_back(layerIndex);
+    }
+    for (const auto layerIndex: layerIndices) {
+        removeTile(tile, layerIndex);
+    }
+}
+
+void Tiled2dMapVectorGeometryBatchManager::removeTile(const Tiled2dMapVersionedTileInfo &tile, int32_t layerIndex) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto batch = findBatch(layerIndex, tile);
+    if (!batch) {
+        return;
+    }
+    batch->removeTile(tile);
+    removeIfEmpty(layerIndex, getBlockKey(tile));
+}
+
+bool Tiled2dMapVectorGeometryBatchManager::isBatched(const Tiled2dMapVersionedTileInfo &tile, int32_t layerIndex) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto batch = findBatch(layerIndex, tile);
+    return batch && batch->containsTile(tile);
+}
+
+std::shared_ptr<Tiled2dMapVectorGeometryBatch> Tiled2dMapVectorGeometryBatchManager::findBatch(int32_t layerIndex,
+                                                                                               const Tiled2dMapVersionedTileInfo &tile) {
+    auto layerIt = batches.find(layerIndex);
+    if (layerIt == batches.end()) {
+        return nullptr;
+    }
+    auto batchIt = layerIt->second.find(getBlockKey(tile));
+    return batchIt != layerIt->second.end() ? batchIt->second : nullptr;
+}
+
+void Tiled2dMapVectorGeometryBatchManager::removeIfEmpty(int32_t layerIndex, const BlockKey &key) {
+    auto layerIt = batches.find(layerIndex);
+    if (layerIt == batches.end()) {
+        return;
+    }
+    auto batchIt = layerIt->second.find(key);
+    if (batchIt == layerIt->second.end() || !batchIt->second->isEmpty()) {
+        return;
+    }
+    batchesToClear.push_back(batchIt->second);
+    layerIt->second.erase(batchIt);
+    if (layerIt->second.empty()) {
+        batches.erase(layerIt);
+    }
+}
+
+std::optional<std::vector<Tiled2dMapVectorGeometryBatchManager::BatchRenderDescription>> Tiled2dMapVectorGeometryBatchManager::prepareRenderDescriptions(
+        const std::unordered_map<Tiled2dMapVersionedTileInfo, std::shared_ptr<MaskingObjectInterface>> &tiles) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+
+    std::unordered_map<BlockKey, std::vector<std::pair<Tiled2dMapVersionedTileInfo, std::shared_ptr<MaskingObjectInterface>>>, BlockKeyHash> blockTiles;
+    for (const auto &[tile, mask]: tiles) {
+        blockTiles[getBlockKey(tile)].emplace_back(tile, mask);
+    }
+
+    std::unordered_map<BlockKey, BlockMask, BlockKeyHash> newBlockMasks;
+    std::unordered_map<BlockKey, std::unordered_set<Tiled2dMapVersionedTileInfo>, BlockKeyHash> blockTileSets;
+    for (auto &[key, entries]: blockTiles) {
+        std::sort(entries.begin(), entries.end(), [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+
+        auto &tileSet = blockTileSets[key];
+        std::vector<std::shared_ptr<MaskingObjectInterface>> tileMasks;
+        for (const auto &[tile, mask]: entries) {
+            tileSet.insert(tile);
+            if (mask) {
+                tileMasks.push_back(mask);
+            }
+        }
+
+        if (tileMasks.empty()) {
+            continue;
+        }
+
+        auto cached = blockMasks.find(key);
+        if (cached != blockMasks.end() && cached->second.tileMasks == tileMasks) {
+            newBlockMasks[key] = cached->second;
+        } else {
+            auto mask = std::make_shared<Tiled2dMapVectorGeometryBatchMask>(tileMasks);
+            newBlockMasks[key] = BlockMask{std::move(tileMasks), mask};
+        }
+    }
+    blockMasks = std::move(newBlockMasks);
+
+    bool needsUpload = false;
+    std::vector<BatchRenderDescription> descriptions;
+    for (const auto &[layerIndex, layerBatches]: batches) {
+        for (const auto &[key, batch]: layerBatches) {
+            auto tileSetIt = blockTileSets.find(key);
+            if (tileSetIt == blockTileSets.end()) {
+                batch->setActiveTiles({});
+                needsUpload |= batch->needsUpload();
+                continue;
+            }
+
+            batch->setActiveTiles(tileSetIt->second);
+            needsUpload |= batch->needsUpload();
+
+            auto maskIt = blockMasks.find(key);
+            std::shared_ptr<MaskingObjectInterface> mask = maskIt != blockMasks.end() ? maskIt->second.mask : nullptr;
+            descriptions.push_back(BatchRenderDescription{layerIndex, key.zoomIdentifier, batch->getRenderObjects(), mask});
+        }
+    }
+
+    if (needsUpload) {
+        return std::nullopt;
+    }
+    return descriptions;
+}
+
+void Tiled2dMapVectorGeometryBatchManager::upload(const std::shared_ptr<RenderingContextInterface> &context) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    for (const auto &batch: batchesToClear) {
+        batch->clear();
+    }
+    batchesToClear.clear();
+
+    for (const auto &[layerIndex, layerBatches]: batches) {
+        for (const auto &[key, batch]: layerBatches) {
+            if (batch->needsUpload()) {
+                batch->upload(context);
+            }
+        }
+    }
+}
+
+void Tiled2dMapVectorGeometryBatchManager::updateStyles() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    for (const auto &[layerIndex, layerBatches]: batches) {
+        for (const auto &[key, batch]: layerBatches) {
+            batch->updateStyles();
+        }
+    }
+}
+
+void Tiled2dMapVectorGeometryBatchManager::clear() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    for (const auto &batch: batchesToClear) {
+        batch->clear();
+    }
+    batchesToClear.clear();
+
+    for (const auto &[layerIndex, layerBatches]: batches) {
+        for (const auto &[key, batch]: layerBatches) {
+            batch->clear();
+        }
+    }
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "Tiled2dMapVectorGeometryBatch.h"
+#include "Tiled2dMapVectorGeometryBatchMask.h"
+#include "MaskingObjectInterface.h"
+#include <functional>
+#include <optional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Owns the geometry batches of a vector source. Tiles of the same style layer, zoom level and time that lie in
+ * the same block of 2^batchZoomLevelSpan x 2^batchZoomLevelSpan tiles are drawn from one batch, masked with the
+ * union of their tile masks. All batches of a block share the same mask object, so that the layer groups them
+ * into a single render pass.
+ */
+class Tiled2dMapVectorGeometryBatchManager {
+public:
+    struct BatchRenderDescription {
+        int32_t layerIndex;
+        int32_t zoomIdentifier;
+        std::vector<std::shared_ptr<RenderObjectInterface>> renderObjects;
+        std::shared_ptr<MaskingObjectInterface> mask;
+    };
+
+    static constexpr int batchZoomLevelSpan = 3;
+
+    std::shared_ptr<Tiled2dMapVectorGeometryBatch> registerTile(int32_t layerIndex, const Tiled2dMapVersionedTileInfo &tile,
+                                                                const std::function<std::shared_ptr<Tiled2dMapVectorGeometryBatch>()> &createBatch);
+
+    void removeTile(const Tiled2dMapVersionedTileInfo &tile);
+
+    void removeTile(const Tiled2dMapVersionedTileInfo &tile, int32_t layerIndex);
+
+    bool isBatched(const Tiled2dMapVersionedTileInfo &tile, int32_t layerIndex);
+
+    /**
+     * Sets the active tiles of all batches, given the visible and ready tiles with batched content and their masks
+     * (nullptr if tiles are not masked). Returns the descriptions to render, or std::nullopt if some batches need to
+     * be uploaded first.
+     */
+    std::optional<std::vector<BatchRenderDescription>> prepareRenderDescriptions(
+            const std::unordered_map<Tiled2dMapVersionedTileInfo, std::shared_ptr<MaskingObjectInterface>> &tiles);
+
+    /** Ensure calling on graphics thread */
+    void upload(const std::shared_ptr<RenderingContextInterface> &context);
+
+    /** Ensure calling on graphics thread */
+    void updateStyles();
+
+    /** Ensure calling on graphics thread */
+    void clear();
+
+private:
+    struct BlockKey {
+        int32_t zoomIdentifier;
+        int32_t t;
+        int32_t x;
+        int32_t y;
+
+        bool operator==(const BlockKey &o) const {
+            return zoomIdentifier == o.zoomIdentifier && t == o.t && x == o.x && y == o.y;
+        }
+    };
+
+    struct BlockKeyHash {
+        size_t operator()(const BlockKey &k) const {
+            size_t res = 17;
+            res = res * 31 + std::hash<int32_t>()(k.zoomIdentifier);
+            res = res * 31 + std::hash<int32_t>()(k.t);
+            res = res * 31 + std::hash<int32_t>()(k.x);
+            res = res * 31 + std::hash<int32_t>()(k.y);
+            return res;
+        }
+    };
+
+    struct BlockMask {
+        std::vector<std::shared_ptr<MaskingObjectInterface>> tileMasks;
+        std::shared_ptr<Tiled2dMapVectorGeometryBatchMask> mask;
+    };
+
+    static BlockKey getBlockKey(const Tiled2dMapVersionedTileInfo &tile);
+
+    std::shared_ptr<Tiled2dMapVectorGeometryBatch> findBatch(int32_t layerIndex, const Tiled2dMapVersionedTileInfo &tile);
+
+    void removeIfEmpty(int32_t layerIndex, const BlockKey &key);
+
+    std::recursive_mutex mutex;
+    std::unordered_map<int32_t, std::unordered_map<BlockKey, std::shared_ptr<Tiled2dMapVectorGeometryBatch>, BlockKeyHash>> batches;
+    std::unordered_map<BlockKey, BlockMask, BlockKeyHash> blockMasks;
+    std::vector<std::shared_ptr<Tiled2dMapVectorGeometryBatch>> batchesToClear;
+};
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "MaskingObjectInterface.h"
+#include "GraphicsObjectInterface.h"
+#include <vector>
+
+/**
+ * Union of the tile masks of a geometry batch. The member masks are owned (setup and cleared) by the source data
+ * manager, rendering them one after the other into the stencil buffer yields the masked area of all batched tiles.
+ */
+class Tiled2dMapVectorGeometryBatchMask : public MaskingObjectInterface,
+                                          public GraphicsObjectInterface,
+                                          public std::enable_shared_from_this<Tiled2dMapVectorGeometryBatchMask> {
+public:
+    Tiled2dMapVectorGeometryBatchMask(const std::vector<std::shared_ptr<MaskingObjectInterface>> &masks)
+        : masks(masks) {}
+
+    std::shared_ptr<GraphicsObjectInterface> asGraphicsObject() override { return shared_from_this(); }
+
+    void renderAsMask(const std::shared_ptr<::RenderingContextInterface> &context, const ::RenderPassConfig &renderPass,
+                      int64_t vpMatrix, int64_t mMatrix, const ::Vec3D &origin, double screenPixelAsRealMeterFactor,
+                      bool isScreenSpaceCoords) override {
+        for (const auto &mask: masks) {
+            mask->renderAsMask(context, renderPass, vpMatrix, mMatrix, origin, screenPixelAsRealMeterFactor, isScreenSpaceCoords);
+        }
+    }
+
+    bool isReady() override {
+        for (const auto &mask: masks) {
+            if (!mask->asGraphicsObject()->isReady()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void setup(const std::shared_ptr<::RenderingContextInterface> &context) override {
+        for (const auto &mask: masks) {
+            if (!mask->asGraphicsObject()->isReady()) {
+                mask->asGraphicsObject()->setup(context);
+            }
+        }
+    }
+
+    void clear() override {}
+
+    void setIsInverseMasked(bool inversed) override {
+        for (const auto &mask: masks) {
+            mask->asGraphicsObject()->setIsInverseMasked(inversed);
+        }
+    }
+
+    void setDebugLabel(const std::string &label) override {}
+
+    void render(const std::shared_ptr<::RenderingContextInterface> &context, const ::RenderPassConfig &renderPass, int64_t vpMatrix,
+                int64_t mMatrix, const ::Vec3D &origin, bool isMasked, double screenPixelAsRealMeterFactor,
+                bool isScreenSpaceCoords) override {}
+
+    const std::vector<std::shared_ptr<MaskingObjectInterface>> &getMasks() const { return masks; }
+
+private:
+    const std::vector<std::shared_ptr<MaskingObjectInterface>> masks;
+};
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "Tiled2dMapVectorLineGeometryBatch.h"
+#include "Tiled2dMapVectorLineTile.h"
+#include "ShaderProgramInterface.h"
+#include "LineGeometryBuilder.h"
+
+Tiled2dMapVectorLineGeometryBatch::Tiled2dMapVectorLineGeometryBatch(const std::shared_ptr<GraphicsObjectFactoryInterface> &graphicsObjectFactory,
+                                                                     const std::shared_ptr<ShaderFactoryInterface> &shaderFactory,
+                                                                     bool isSimpleLine,
+                                                                     bool is3d)
+        // position, extrude, side, length prefix, length correction, style index
+        : Tiled2dMapVectorGeometryBatch(is3d ? 10 : 8, is3d ? 3 : 2, Tiled2dMapVectorLineTile::maxStylesPerGroup,
+                                        LineGeometryBuilder::maxShortIndexVertexCount),
+          graphicsObjectFactory(graphicsObjectFactory),
+          shaderFactory(shaderFactory),
+          isSimpleLine(isSimpleLine),
+          is3d(is3d) {}
+
+void Tiled2dMapVectorLineGeometryBatch::setBlendMode(BlendMode blendMode) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    this->blendMode = blendMode;
+    for (const auto &shader: shaders) {
+        if (shader) shader->asShaderProgramInterface()->setBlendMode(blendMode);
+    }
+}
+
+void Tiled2dMapVectorLineGeometryBatch::setScalingFactor(float scalingFactor) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (this->scalingFactor == scalingFactor) {
+        return;
+    }
+    this->scalingFactor = scalingFactor;
+    for (const auto &shader: shaders) {
+        if (shader) shader->setDashingScaleFactor(scalingFactor);
+    }
+}
+
+std::shared_ptr<GraphicsObjectInterface> Tiled2dMapVectorLineGeometryBatch::createGroupObject(size_t groupIndex) {
+    auto shader = isSimpleLine ? (is3d ? shaderFactory->createUnitSphereSimpleLineGroupShader() : shaderFactory->createSimpleLineGroupShader())
+                               : (is3d ? shaderFactory->createUnitSphereLineGroupShader() : shaderFactory->createLineGroupShader());
+    if (blendMode) {
+        shader->asShaderProgramInterface()->setBlendMode(*blendMode);
+    }
+    if (scalingFactor) {
+        shader->setDashingScaleFactor(*scalingFactor);
+    }
+    auto line = graphicsObjectFactory->createLineGroup(shader->asShaderProgramInterface());
+#if DEBUG
+    line->asGraphicsObject()->setDebugLabel("line_batch_" + std::to_string(groupIndex));
+#endif
+    if (shaders.size() <= groupIndex) {
+        shaders.resize(groupIndex + 1);
+        lines.resize(groupIndex + 1);
+    }
+    shaders[groupIndex] = shader;
+    lines[groupIndex] = line;
+    return line->asGraphicsObject();
+}
+
+void Tiled2dMapVectorLineGeometryBatch::setGroupGeometry(size_t groupIndex, const std::vector<float> &vertices,
+                                                         const std::vector<uint32_t> &indices, const Vec3D &origin) {
+    // the vertex arena of a group is limited to the 16bit index range
+    LineGeometryBuilder::setLineGeometry(lines[groupIndex], vertices, indices, origin, is3d);
+}
+
+void Tiled2dMapVectorLineGeometryBatch::setGroupStyles(size_t groupIndex, const SharedBytes &styles) {
+    shaders[groupIndex]->setStyles(styles);
+}
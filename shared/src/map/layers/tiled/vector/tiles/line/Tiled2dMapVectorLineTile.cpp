@@ -15,6 +15,7 @@
 #include "LineHelper.h"
 #include "Tiled2dMapVectorLayerConfig.h"
 #include "Tiled2dMapVectorStyleParser.h"
+#include "Tiled2dMapVectorLineGeometryBatch.h"
 
 Tiled2dMapVectorLineTile::Tiled2dMapVectorLineTile(const std::weak_ptr<MapInterface> &mapInterface,
                                                    const std::weak_ptr<Tiled2dMapVectorLayer> &vectorLayer,
@@ -22,9 +23,10 @@ Tiled2dMapVectorLineTile::Tiled2dMapVectorLineTile(const std::weak_ptr<MapInterf
                                                    const WeakActor<Tiled2dMapVectorLayerTileCallbackInterface> &tileCallbackInterface,
                                                    const std::shared_ptr<LineVectorLayerDescription> &description,
                                                    const std::shared_ptr<Tiled2dMapVectorLayerConfig> &layerConfig,
-                                                   const std::shared_ptr<Tiled2dMapVectorStateManager> &featureStateManager)
+                                                   const std::shared_ptr<Tiled2dMapVectorStateManager> &featureStateManager,
+                                                   const std::shared_ptr<Tiled2dMapVectorLineGeometryBatch> &geometryBatch)
         : Tiled2dMapVectorTile(mapInterface, vectorLayer, tileInfo, description, layerConfig, tileCallbackInterface, featureStateManager),
-          usedKeys(description->getUsedKeys()), selectionSizeFactor(description->selectionSizeFactor) {
+          usedKeys(description->getUsedKeys()), selectionSizeFactor(description->selectionSizeFactor), geometryBatch(geometryBatch) {
     isStyleZoomDependant = usedKeys.usedKeys.contains(ValueKeys::ZOOM);
     isStyleStateDependant = usedKeys.isStateDependant();
 
@@ -96,6 +98,9 @@ void Tiled2dMapVectorLineTile::update() {
         for (auto const &object : renderObjects) {
             object->setHidden(!inZoomRange);
         }
+        if (geometryBatch) {
+            geometryBatch->setHidden(!inZoomRange);
+        }
     }
 
     if (!inZoomRange) {
@@ -105,6 +110,9 @@ void Tiled2dMapVectorLineTile::update() {
     for (auto const &line: lines) {
         line->setScalingFactor(scalingFactor);
     }
+    if (geometryBatch) {
+        geometryBatch->setScalingFactor(scalingFactor);
+    }
 
     if (lastAlpha == alpha &&
         lastZoom &&
@@ -288,11 +296,19 @@ void Tiled2dMapVectorLineTile::update() {
             if (isSimpleLine) {
                 auto &styles = reusableSimpleLineStyles[styleGroupId];
                 auto buffer = SharedBytes((int64_t)styles.data(), (int)styles.size(), sizeof(ShaderSimpleLineStyle));
-                shaders[styleGroupId]->setStyles(buffer);
+                if (geometryBatch) {
+                    geometryBatch->setTileStyles(tileInfo, styleGroupId, buffer);
+                } else {
+                    shaders[styleGroupId]->setStyles(buffer);
+                }
             } else {
                 auto &styles = reusableLineStyles[styleGroupId];
                 auto buffer = SharedBytes((int64_t)styles.data(), (int)styles.size(), sizeof(ShaderLineStyle));
-                shaders[styleGroupId]->setStyles(buffer);
+                if (geometryBatch) {
+                    geometryBatch->setTileStyles(tileInfo, styleGroupId, buffer);
+                } else {
+                    shaders[styleGroupId]->setStyles(buffer);
+                }
             }
         }
     }
@@ -415,10 +431,17 @@ void Tiled2dMapVectorLineTile::setVectorTileData(const Tiled2dMapVectorTileDataV
                         } else {
                             styleGroupIndex = (int) featureGroups.size();
                             styleIndex = 0;
-                            auto shader = isSimpleLine ? (is3d ? shaderFactory->createUnitSphereSimpleLineGroupShader() : shaderFactory->createSimpleLineGroupShader()) : (is3d ? shaderFactory->createUnitSphereLineGroupShader() : shaderFactory->createLineGroupShader());
                             auto lineDescription = std::static_pointer_cast<LineVectorLayerDescription>(description);
-                            shader->asShaderProgramInterface()->setBlendMode(lineDescription->style.getBlendMode(EvaluationContext(0.0, dpFactor, std::make_shared<FeatureContext>(), featureStateManager)));
-                            shaders.push_back(shader);
+                            auto blendMode = lineDescription->style.getBlendMode(EvaluationContext(0.0, dpFactor, std::make_shared<FeatureContext>(), featureStateManager));
+                            if (geometryBatch) {
+                                // the batch owns the shaders, the style group only reserves its style slots there
+                                geometryBatch->setBlendMode(blendMode);
+                                shaders.push_back(nullptr);
+                            } else {
+                                auto shader = isSimpleLine ? (is3d ? shaderFactory->createUnitSphereSimpleLineGroupShader() : shaderFactory->createSimpleLineGroupShader()) : (is3d ? shaderFactory->createUnitSphereLineGroupShader() : shaderFactory->createLineGroupShader());
+                                shader->asShaderProgramInterface()->setBlendMode(blendMode);
+                                shaders.push_back(shader);
+                            }
                             capTypes.push_back(capType);
                             joinTypes.push_back(joinType);
                             dotted.push_back(isDotted);
@@ -456,7 +479,7 @@ void Tiled2dMapVectorLineTile::setVectorTileData(const Tiled2dMapVectorTileDataV
                         size_t startOffset = coordinateOffset > 0 ? coordinateOffset - 1 : 0; // always include first coordinate of last split (if any)
 
                         uint64_t newLineVertexCount = LineGeometryBuilder::estimateVertexCount(excludingEndOffset - startOffset);
-                        int vertexCount = subGroupVertexCount[styleGroupIndex];
+                        uint32_t vertexCount = subGroupVertexCount[styleGroupIndex];
 
                         // Check if adding this line would exceed vertex limit for current subgroup
                         // Split into new subgroup if we exceed the limit
@@ -470,7 +493,7 @@ void Tiled2dMapVectorLineTile::setVectorTileData(const Tiled2dMapVectorTileDataV
                         }
 
                         styleGroupLineSubGroupVector[styleGroupIndex].push_back({std::vector<::Vec2D>(coordinates.begin() + startOffset, coordinates.begin() + excludingEndOffset), std::min(maxStylesPerGroup - 1, styleIndex)});
-                        subGroupVertexCount[styleGroupIndex] = (int)subGroupVertexCount[styleGroupIndex] + newLineVertexCount;
+                        subGroupVertexCount[styleGroupIndex] = (uint32_t)(subGroupVertexCount[styleGroupIndex] + newLineVertexCount);
                     }
 
                     if (isInteractable) {
@@ -531,6 +554,10 @@ void Tiled2dMapVectorLineTile::addLines(const std::vector<std::vector<std::vecto
     double rz = is3d ? -1.0 * sin(cy) * sin(cx) : 0.0;
     auto origin = Vec3D(rx, ry, rz);
 
+    if (geometryBatch) {
+        addLinesToBatch(styleIdLinesVector, origin);
+        return;
+    }
 
     for (int styleGroupIndex = 0; styleGroupIndex < styleIdLinesVector.size(); styleGroupIndex++) {
         for (const auto &lineSubGroup: styleIdLinesVector[styleGroupIndex]) {
@@ -574,6 +601,37 @@ void Tiled2dMapVectorLineTile::addLines(const std::vector<std::vector<std::vecto
 
 }
 
+void Tiled2dMapVectorLineTile::addLinesToBatch(const std::vector<std::vector<std::vector<std::tuple<std::vector<Vec2D>, int>>>> &styleIdLinesVector,
+                                               const Vec3D &origin) {
+    auto mapInterface = this->mapInterface.lock();
+    const auto &coordinateConverterHelper = mapInterface ? mapInterface->getCoordinateConverterHelper() : nullptr;
+    if (!coordinateConverterHelper) {
+        return;
+    }
+
+    bool is3d = mapInterface->is3d();
+    const auto systemIdentifier = tileInfo.tileInfo.bounds.topLeft.systemIdentifier;
+
+    std::vector<Tiled2dMapVectorGeometryBatch::TileGeometry> geometries;
+    for (int styleGroupIndex = 0; styleGroupIndex < styleIdLinesVector.size(); styleGroupIndex++) {
+        const int32_t numStyles = (int32_t) featureGroups.at(styleGroupIndex).size();
+        for (const auto &lineSubGroup: styleIdLinesVector[styleGroupIndex]) {
+            const auto renderLines = LineGroup2dLayerObject::convertToRenderCoordinates(coordinateConverterHelper, lineSubGroup, systemIdentifier, origin, is3d);
+            std::vector<LineGeometryBuilder::LineGeometryPart> parts;
+            LineGeometryBuilder::buildLineGeometryParts(renderLines, origin, capTypes.at(styleGroupIndex), joinTypes.at(styleGroupIndex), is3d,
+                                                        dotted.at(styleGroupIndex), LineGeometryBuilder::maxShortIndexVertexCount, parts);
+            for (auto &part: parts) {
+                geometries.push_back({styleGroupIndex, numStyles, std::move(part.lineAttributes), std::move(part.lineIndices)});
+            }
+        }
+    }
+
+    geometryBatch->setTileGeometry(tileInfo, origin, std::move(geometries));
+
+    auto selfActor = WeakActor<Tiled2dMapVectorTile>(mailbox, shared_from_this());
+    tileCallbackInterface.message(MFN(&Tiled2dMapVectorLayerTileCallbackInterface::tileIsReady), tileInfo, description->identifier, selfActor);
+}
+
 void Tiled2dMapVectorLineTile::setupLines(const std::vector<std::shared_ptr<GraphicsObjectInterface>> &newLineGraphicsObjects) {
     auto mapInterface = this->mapInterface.lock();
     auto renderingContext = mapInterface ? mapInterface->getRenderingContext() : nullptr;
@@ -17,6 +17,8 @@
 #include "ShaderLineStyle.h"
 #include "ShaderSimpleLineStyle.h"
 
+class Tiled2dMapVectorLineGeometryBatch;
+
 class Tiled2dMapVectorLineTile
         : public Tiled2dMapVectorTile,
           public std::enable_shared_from_this<Tiled2dMapVectorLineTile> {
@@ -27,7 +29,8 @@ public:
                              const WeakActor<Tiled2dMapVectorLayerTileCallbackInterface> &tileCallbackInterface,
                              const std::shared_ptr<LineVectorLayerDescription> &description,
                              const std::shared_ptr<Tiled2dMapVectorLayerConfig> &layerConfig,
-                             const std::shared_ptr<Tiled2dMapVectorStateManager> &featureStateManager);
+                             const std::shared_ptr<Tiled2dMapVectorStateManager> &featureStateManager,
+                             const std::shared_ptr<Tiled2dMapVectorLineGeometryBatch> &geometryBatch = nullptr);
 
     void updateVectorLayerDescription(const std::shared_ptr<VectorLayerDescription> &description,
                                 const Tiled2dMapVectorTileDataVector &tileData) override;
@@ -46,19 +49,22 @@ public:
 
     bool performClick(const Coord &coord) override;
 
-private:
-    void addLines(const std::vector<std::vector<std::vector<std::tuple<std::vector<Vec2D>, int>>>> &styleIdLinesVector);
-
-    void setupLines(const std::vector<std::shared_ptr<GraphicsObjectInterface>> &newLineGraphicsObjects);
-
-    static const int maxNumLineVertices = std::numeric_limits<uint32_t>::max();
-
 #ifdef OPENMOBILEMAPS_GL
     static const int maxStylesPerGroup = 32;
 #else
     static const int maxStylesPerGroup = 256;
 #endif
 
+private:
+    void addLines(const std::vector<std::vector<std::vector<std::tuple<std::vector<Vec2D>, int>>>> &styleIdLinesVector);
+
+    void addLinesToBatch(const std::vector<std::vector<std::vector<std::tuple<std::vector<Vec2D>, int>>>> &styleIdLinesVector, const Vec3D &origin);
+
+    void setupLines(const std::vector<std::shared_ptr<GraphicsObjectInterface>> &newLineGraphicsObjects);
+
+    // line groups are drawn with 16bit indices (see LineGeometryBuilder::maxShortIndexVertexCount)
+    static const uint32_t maxNumLineVertices = std::numeric_limits<uint16_t>::max();
+
     std::vector<std::shared_ptr<LineGroupShaderInterface>> shaders;
     std::vector<LineCapType> capTypes;
     std::vector<LineJoinType> joinTypes;
@@ -84,6 +90,9 @@ private:
 
     std::vector<std::shared_ptr<LineGroup2dLayerObject>> toClear;
 
+    // if set, the geometry is drawn by the batch shared with the neighbouring tiles of this layer
+    const std::shared_ptr<Tiled2dMapVectorLineGeometryBatch> geometryBatch;
+
 
     bool isSimpleLine;
 };
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "Tiled2dMapVectorPolygonGeometryBatch.h"
+#include "Tiled2dMapVectorPolygonTile.h"
+#include "ShaderProgramInterface.h"
+
+Tiled2dMapVectorPolygonGeometryBatch::Tiled2dMapVectorPolygonGeometryBatch(const std::shared_ptr<GraphicsObjectFactoryInterface> &graphicsObjectFactory,
+                                                                           const std::shared_ptr<ShaderFactoryInterface> &shaderFactory,
+                                                                           bool isStriped,
+                                                                           bool is3d)
+        // x, y, z, style index with 16bit indices
+        : Tiled2dMapVectorGeometryBatch(4, 3, Tiled2dMapVectorPolygonTile::maxStylesPerGroup, std::numeric_limits<uint16_t>::max()),
+          graphicsObjectFactory(graphicsObjectFactory),
+          shaderFactory(shaderFactory),
+          isStriped(isStriped),
+          is3d(is3d) {}
+
+void Tiled2dMapVectorPolygonGeometryBatch::setBlendMode(BlendMode blendMode) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    this->blendMode = blendMode;
+    for (const auto &shader: shaders) {
+        if (shader) shader->asShaderProgramInterface()->setBlendMode(blendMode);
+    }
+}
+
+std::shared_ptr<GraphicsObjectInterface> Tiled2dMapVectorPolygonGeometryBatch::createGroupObject(size_t groupIndex) {
+    auto shader = shaderFactory->createPolygonGroupShader(isStriped, is3d);
+    if (blendMode) {
+        shader->asShaderProgramInterface()->setBlendMode(*blendMode);
+    }
+    auto polygon = graphicsObjectFactory->createPolygonGroup(shader->asShaderProgramInterface());
+#if DEBUG
+    polygon->asGraphicsObject()->setDebugLabel("polygon_batch_" + std::to_string(groupIndex));
+#endif
+    if (shaders.size() <= groupIndex) {
+        shaders.resize(groupIndex + 1);
+        polygons.resize(groupIndex + 1);
+    }
+    shaders[groupIndex] = shader;
+    polygons[groupIndex] = polygon;
+    return polygon->asGraphicsObject();
+}
+
+void Tiled2dMapVectorPolygonGeometryBatch::setGroupGeometry(size_t groupIndex, const std::vector<float> &vertices,
+                                                            const std::vector<uint32_t> &indices, const Vec3D &origin) {
+    // the vertex arena of a group is limited to the 16bit index range
+    std::vector<uint16_t> shortIndices(indices.begin(), indices.end());
+    auto v = SharedBytes((int64_t) vertices.data(), (int32_t) vertices.size(), (int32_t) sizeof(float));
+    auto i = SharedBytes((int64_t) shortIndices.data(), (int32_t) shortIndices.size(), (int32_t) sizeof(uint16_t));
+    polygons[groupIndex]->setVertices(v, i, origin);
+}
+
+void Tiled2dMapVectorPolygonGeometryBatch::setGroupStyles(size_t groupIndex, const SharedBytes &styles) {
+    shaders[groupIndex]->setStyles(styles);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#pragma once
+
+#include "Tiled2dMapVectorGeometryBatch.h"
+#include "GraphicsObjectFactoryInterface.h"
+#include "ShaderFactoryInterface.h"
+#include "PolygonGroup2dInterface.h"
+#include "PolygonGroupShaderInterface.h"
+#include "BlendMode.h"
+
+class Tiled2dMapVectorPolygonGeometryBatch : public Tiled2dMapVectorGeometryBatch {
+public:
+    Tiled2dMapVectorPolygonGeometryBatch(const std::shared_ptr<GraphicsObjectFactoryInterface> &graphicsObjectFactory,
+                                         const std::shared_ptr<ShaderFactoryInterface> &shaderFactory,
+                                         bool isStriped,
+                                         bool is3d);
+
+    void setBlendMode(BlendMode blendMode);
+
+protected:
+    std::shared_ptr<GraphicsObjectInterface> createGroupObject(size_t groupIndex) override;
+
+    void setGroupGeometry(size_t groupIndex, const std::vector<float> &vertices, const std::vector<uint32_t> &indices,
+                          const Vec3D &origin) override;
+
+    void setGroupStyles(size_t groupIndex, const SharedBytes &styles) override;
+
+private:
+    const std::shared_ptr<GraphicsObjectFactoryInterface> graphicsObjectFactory;
+    const std::shared_ptr<ShaderFactoryInterface> shaderFactory;
+    const bool isStriped;
+    const bool is3d;
+
+    std::optional<BlendMode> blendMode;
+
+    std::vector<std::shared_ptr<PolygonGroupShaderInterface>> shaders;
+    std::vector<std::shared_ptr<PolygonGroup2dInterface>> polygons;
+};
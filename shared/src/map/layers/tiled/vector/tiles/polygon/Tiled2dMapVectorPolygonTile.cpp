@@ -18,6 +18,7 @@
 #include "CoordinateSystemIdentifiers.h"
 #include "Tiled2dMapVectorStyleParser.h"
 #include "Tiled2dMapVectorLayerConstants.h"
+#include "Tiled2dMapVectorPolygonGeometryBatch.h"
 
 #include "TrigonometryLUT.h"
 
@@ -27,9 +28,10 @@ Tiled2dMapVectorPolygonTile::Tiled2dMapVectorPolygonTile(const std::weak_ptr<Map
                                                          const WeakActor<Tiled2dMapVectorLayerTileCallbackInterface> &tileCallbackInterface,
                                                          const std::shared_ptr<PolygonVectorLayerDescription> &description,
                                                          const std::shared_ptr<Tiled2dMapVectorLayerConfig> &layerConfig,
-                                                         const std::shared_ptr<Tiled2dMapVectorStateManager> &featureStateManager)
+                                                         const std::shared_ptr<Tiled2dMapVectorStateManager> &featureStateManager,
+                                                         const std::shared_ptr<Tiled2dMapVectorPolygonGeometryBatch> &geometryBatch)
         : Tiled2dMapVectorTile(mapInterface, vectorLayer, tileInfo, description, layerConfig, tileCallbackInterface, featureStateManager),
-          usedKeys(std::move(description->getUsedKeys())), isStriped(description->style.isStripedPotentially()) {
+          usedKeys(std::move(description->getUsedKeys())), isStriped(description->style.isStripedPotentially()), geometryBatch(geometryBatch) {
     isStyleZoomDependant = usedKeys.containsUsedKey(ValueKeys::ZOOM);
     isStyleStateDependant = usedKeys.isStateDependant();
 }
@@ -92,6 +94,9 @@ void Tiled2dMapVectorPolygonTile::update() {
         for (auto const &object : renderObjects) {
             object->setHidden(!inZoomRange);
         }
+        if (geometryBatch) {
+            geometryBatch->setHidden(!inZoomRange);
+        }
     }
 
     if (!inZoomRange) {
@@ -144,7 +149,11 @@ void Tiled2dMapVectorPolygonTile::update() {
         int32_t numAttributesPerStyle = isStriped ? 7 : 5;
 #endif
         auto s = SharedBytes((int64_t)shaderStyles.data(), (int32_t)featureGroups.at(styleGroupId).size(), numAttributesPerStyle * (int32_t)sizeof(float));
-        shaders[styleGroupId]->setStyles(s);
+        if (geometryBatch) {
+            geometryBatch->setTileStyles(tileInfo, styleGroupId, s);
+        } else {
+            shaders[styleGroupId]->setStyles(s);
+        }
     }
 }
 
@@ -247,10 +256,17 @@ void Tiled2dMapVectorPolygonTile::setVectorTileData(const Tiled2dMapVectorTileDa
                         } else {
                             styleGroupIndex = (int) featureGroups.size();
                             styleIndex = 0;
-                            auto shader = shaderFactory->createPolygonGroupShader(isStriped, mapInterface->is3d());
                             auto polygonDescription = std::static_pointer_cast<PolygonVectorLayerDescription>(description);
-                            shader->asShaderProgramInterface()->setBlendMode(polygonDescription->style.getBlendMode(EvaluationContext(0.0, dpFactor, std::make_shared<FeatureContext>(), featureStateManager)));
-                            shaders.push_back(shader);
+                            auto blendMode = polygonDescription->style.getBlendMode(EvaluationContext(0.0, dpFactor, std::make_shared<FeatureContext>(), featureStateManager));
+                            if (geometryBatch) {
+                                // the batch owns the shaders, the style group only reserves its style slots there
+                                geometryBatch->setBlendMode(blendMode);
+                                shaders.push_back(nullptr);
+                            } else {
+                                auto shader = shaderFactory->createPolygonGroupShader(isStriped, mapInterface->is3d());
+                                shader->asShaderProgramInterface()->setBlendMode(blendMode);
+                                shaders.push_back(shader);
+                            }
                             featureGroups.push_back(std::vector<std::tuple<size_t, std::shared_ptr<FeatureContext>>>{{hash, featureContext}});
                             styleGroupNewPolygonsVector.push_back({{{}, {}}});
                             styleIndicesOffsets[styleGroupIndex] = 0;
@@ -350,6 +366,11 @@ void Tiled2dMapVectorPolygonTile::addPolygons(const std::vector<std::vector<Obje
         return;
     }
 
+    if (geometryBatch) {
+        addPolygonsToBatch(styleGroupNewPolygonsVector, origin);
+        return;
+    }
+
     auto mapInterface = this->mapInterface.lock();
     auto objectFactory = mapInterface ? mapInterface->getGraphicsObjectFactory() : nullptr;
     auto converter = mapInterface ? mapInterface->getCoordinateConverterHelper() : nullptr;
@@ -395,6 +416,23 @@ void Tiled2dMapVectorPolygonTile::addPolygons(const std::vector<std::vector<Obje
 #endif
 }
 
+void Tiled2dMapVectorPolygonTile::addPolygonsToBatch(const std::vector<std::vector<ObjectDescriptions>> &styleGroupNewPolygonsVector,
+                                                     const Vec3D & origin) {
+    std::vector<Tiled2dMapVectorGeometryBatch::TileGeometry> geometries;
+    for (int styleGroupIndex = 0; styleGroupIndex < styleGroupNewPolygonsVector.size(); styleGroupIndex++) {
+        const int32_t numStyles = (int32_t) featureGroups.at(styleGroupIndex).size();
+        for (const auto &polygonDesc: styleGroupNewPolygonsVector[styleGroupIndex]) {
+            geometries.push_back({styleGroupIndex, numStyles, polygonDesc.vertices,
+                                  std::vector<uint32_t>(polygonDesc.indices.begin(), polygonDesc.indices.end())});
+        }
+    }
+
+    geometryBatch->setTileGeometry(tileInfo, origin, std::move(geometries));
+
+    auto selfActor = WeakActor<Tiled2dMapVectorTile>(mailbox, shared_from_this());
+    tileCallbackInterface.message(MFN(&Tiled2dMapVectorLayerTileCallbackInterface::tileIsReady), tileInfo, description->identifier, selfActor);
+}
+
 void Tiled2dMapVectorPolygonTile::setupPolygons(const std::vector<std::shared_ptr<GraphicsObjectInterface>> &newPolygonObjects) {
 
     auto mapInterface = this->mapInterface.lock();
@@ -16,6 +16,8 @@
 #include "PolygonGroup2dLayerObject.h"
 #include "PolygonCoord.h"
 
+class Tiled2dMapVectorPolygonGeometryBatch;
+
 class Tiled2dMapVectorPolygonTile
         : public Tiled2dMapVectorTile,
           public std::enable_shared_from_this<Tiled2dMapVectorPolygonTile> {
@@ -26,7 +28,8 @@ public:
                                 const WeakActor<Tiled2dMapVectorLayerTileCallbackInterface> &tileCallbackInterface,
                                 const std::shared_ptr<PolygonVectorLayerDescription> &description,
                                 const std::shared_ptr<Tiled2dMapVectorLayerConfig> &layerConfig,
-                                const std::shared_ptr<Tiled2dMapVectorStateManager> &featureStateManager);
+                                const std::shared_ptr<Tiled2dMapVectorStateManager> &featureStateManager,
+                                const std::shared_ptr<Tiled2dMapVectorPolygonGeometryBatch> &geometryBatch = nullptr);
 
     void updateVectorLayerDescription(const std::shared_ptr<VectorLayerDescription> &description,
                                 const Tiled2dMapVectorTileDataVector &layerFeatures) override;
@@ -45,6 +48,12 @@ public:
 
     bool performClick(const Coord &coord) override;
 
+#ifdef OPENMOBILEMAPS_GL
+    static const int maxStylesPerGroup = 16;
+#else
+    static const int maxStylesPerGroup = 256;
+#endif
+
 private:
 
     struct ObjectDescriptions {
@@ -54,13 +63,9 @@ private:
 
     void addPolygons(const std::vector<std::vector<ObjectDescriptions>> &styleGroupNewPolygonsVector, const Vec3D & origin);
 
-    void setupPolygons(const std::vector<std::shared_ptr<GraphicsObjectInterface>> &newPolygonObjects);
+    void addPolygonsToBatch(const std::vector<std::vector<ObjectDescriptions>> &styleGroupNewPolygonsVector, const Vec3D & origin);
 
-#ifdef OPENMOBILEMAPS_GL
-    static const int maxStylesPerGroup = 16;
-#else
-    static const int maxStylesPerGroup = 256;
-#endif
+    void setupPolygons(const std::vector<std::shared_ptr<GraphicsObjectInterface>> &newPolygonObjects);
 
     std::vector<std::shared_ptr<PolygonGroupShaderInterface>> shaders;
     std::vector<std::shared_ptr<PolygonGroup2dLayerObject>> polygons;
@@ -78,4 +83,7 @@ private:
     std::vector<std::tuple<VectorTileGeometryHandler::TriangulatedPolygon, std::shared_ptr<FeatureContext>>> hitDetectionPolygons;
 
     std::vector<std::shared_ptr<PolygonGroup2dLayerObject>> toClear;
+
+    // if set, the geometry is drawn by the batch shared with the neighbouring tiles of this layer
+    const std::shared_ptr<Tiled2dMapVectorPolygonGeometryBatch> geometryBatch;
 };
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "CachingLoader.h"
+#include "DateHelper.h"
+#include "PerformanceLogger.h"
+
+CachingLoader::CachingLoader(const std::shared_ptr<LoaderInterface> &loader, const std::string &packFilePath, int64_t maxSizeBytes,
+                             int64_t maxAgeMillis)
+    : CachingLoader(loader, TilePackFile::open(packFilePath, maxSizeBytes), maxAgeMillis) {}
+
+CachingLoader::CachingLoader(const std::shared_ptr<LoaderInterface> &loader, const std::shared_ptr<TilePackFile> &packFile,
+                             int64_t maxAgeMillis)
+    : loader(loader)
+    , packFile(packFile)
+    , maxAgeMillis(maxAgeMillis) {}
+
+TextureLoaderResult CachingLoader::loadTexture(const std::string &url, const std::optional<std::string> &etag) {
+    return loader->loadTexture(url, etag);
+}
+
+::djinni::Future<TextureLoaderResult> CachingLoader::loadTextureAsync(const std::string &url, const std::optional<std::string> &etag) {
+    return loader->loadTextureAsync(url, etag);
+}
+
+DataLoaderResult CachingLoader::loadData(const std::string &url, const std::optional<std::string> &etag) {
+    if (!packFile) {
+        return loader->loadData(url, etag);
+    }
+
+    auto cached = packFile->get(url);
+    if (cached && isFresh(*cached)) {
+        PERF_LOG_COUNT("CachingLoader_hits", 1);
+        return toResult(std::move(*cached));
+    }
+    PERF_LOG_COUNT("CachingLoader_misses", 1);
+
+    auto requestEtag = cached ? cached->etag : etag;
+    return handleResult(packFile, url, std::move(cached), loader->loadData(url, requestEtag));
+}
+
+::djinni::Future<DataLoaderResult> CachingLoader::loadDataAsync(const std::string &url, const std::optional<std::string> &etag) {
+    if (!packFile) {
+        return loader->loadDataAsync(url, etag);
+    }
+
+    auto cached = packFile->get(url);
+    if (cached && isFresh(*cached)) {
+        PERF_LOG_COUNT("CachingLoader_hits", 1);
+        ::djinni::Promise<DataLoaderResult> promise;
+        promise.setValue(toResult(std::move(*cached)));
+        return promise.getFuture();
+    }
+    PERF_LOG_COUNT("CachingLoader_misses", 1);
+
+    auto requestEtag = cached ? cached->etag : etag;
+    auto promise = std::make_shared<::djinni::Promise<DataLoaderResult>>();
+    loader->loadDataAsync(url, requestEtag)
+        .then([packFile = packFile, url, cached = std::move(cached), promise](::djinni::Future<DataLoaderResult> result) {
+            promise->setValue(handleResult(packFile, url, cached, result.get()));
+        });
+    return promise->getFuture();
+}
+
+void CachingLoader::cancel(const std::string &url) { loader->cancel(url); }
+
+DataLoaderResult CachingLoader::handleResult(const std::shared_ptr<TilePackFile> &packFile, const std::string &url,
+                                             std::optional<TilePackFile::Tile> cached, DataLoaderResult result) {
+    switch (result.status) {
+    case LoaderStatus::OK: {
+        const bool notModified = cached && (!result.data || (result.etag && result.etag == cached->etag));
+        if (notModified) {
+            PERF_LOG_COUNT("CachingLoader_revalidated", 1);
+            packFile->touch(url, DateHelper::currentTimeMillis());
+            return toResult(std::move(*cached));
+        }
+        if (result.data) {
+            packFile->put(url, result.data->buf(), result.data->len(), result.etag, DateHelper::currentTimeMillis());
+        }
+        return result;
+    }
+    case LoaderStatus::ERROR_400:
+    case LoaderStatus::ERROR_404: {
+        if (cached) {
+            packFile->remove(url);
+        }
+        return result;
+    }
+    case LoaderStatus::ERROR_TIMEOUT:
+    case LoaderStatus::ERROR_NETWORK:
+    case LoaderStatus::ERROR_OTHER: {
+        // offline, the stale data is better than nothing
+        if (cached) {
+            return toResult(std::move(*cached));
+        }
+        return result;
+    }
+    case LoaderStatus::NOOP:
+        return result;
+    }
+    return result;
+}
+
+DataLoaderResult CachingLoader::toResult(TilePackFile::Tile tile) {
+    return DataLoaderResult(::djinni::DataRef(std::move(tile.data)), std::move(tile.etag), LoaderStatus::OK, std::nullopt);
+}
+
+bool CachingLoader::isFresh(const TilePackFile::Tile &tile) const {
+    return DateHelper::currentTimeMillis() - tile.storedAt < maxAgeMillis;
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "CoalescingLoader.h"
+#include "PerformanceLogger.h"
+#include <atomic>
+#include <exception>
+
+CoalescingLoader::CoalescingLoader(const std::shared_ptr<LoaderInterface> &loader)
+    : loader(loader)
+    , requestTable(getRequestTable(loader))
+    , id([] {
+        static std::atomic<uint64_t> nextId = 0;
+        return nextId++;
+    }()) {}
+
+std::vector<std::shared_ptr<LoaderInterface>> CoalescingLoader::wrap(const std::vector<std::shared_ptr<LoaderInterface>> &loaders) {
+    std::vector<std::shared_ptr<LoaderInterface>> wrapped;
+    wrapped.reserve(loaders.size());
+    for (const auto &loader : loaders) {
+        if (!loader || std::dynamic_pointer_cast<CoalescingLoader>(loader)) {
+            wrapped.push_back(loader);
+        } else {
+            wrapped.push_back(std::make_shared<CoalescingLoader>(loader));
+        }
+    }
+    return wrapped;
+}
+
+std::shared_ptr<CoalescingLoader::RequestTable> CoalescingLoader::getRequestTable(const std::shared_ptr<LoaderInterface> &loader) {
+    static std::mutex tablesMutex;
+    static std::vector<std::pair<std::weak_ptr<LoaderInterface>, std::weak_ptr<RequestTable>>> tables;
+
+    std::lock_guard<std::mutex> lock(tablesMutex);
+    std::shared_ptr<RequestTable> table;
+    for (auto it = tables.begin(); it != tables.end();) {
+        auto strongLoader = it->first.lock();
+        auto strongTable = it->second.lock();
+        if (!strongLoader || !strongTable) {
+            it = tables.erase(it);
+            continue;
+        }
+        if (strongLoader == loader) {
+            table = strongTable;
+        }
+        ++it;
+    }
+
+    if (!table) {
+        table = std::make_shared<RequestTable>();
+        tables.emplace_back(loader, table);
+    }
+    return table;
+}
+
+std::string CoalescingLoader::createKey(const std::string &url, const std::optional<std::string> &etag) {
+    if (!etag) {
+        return url;
+    }
+    // urls do not contain whitespace
+    return url + " " + *etag;
+}
+
+TextureLoaderResult CoalescingLoader::loadTexture(const std::string &url, const std::optional<std::string> &etag) {
+    return loader->loadTexture(url, etag);
+}
+
+DataLoaderResult CoalescingLoader::loadData(const std::string &url, const std::optional<std::string> &etag) {
+    return loader->loadData(url, etag);
+}
+
+::djinni::Future<TextureLoaderResult> CoalescingLoader::loadTextureAsync(const std::string &url, const std::optional<std::string> &etag) {
+    return loader->loadTextureAsync(url, etag);
+}
+
+::djinni::Future<DataLoaderResult> CoalescingLoader::loadDataAsync(const std::string &url, const std::optional<std::string> &etag) {
+    const auto key = createKey(url, etag);
+    auto promise = std::make_shared<::djinni::Promise<DataLoaderResult>>();
+    auto future = promise->getFuture();
+
+    std::shared_ptr<Request> request;
+    {
+        std::lock_guard<std::mutex> lock(requestTable->mutex);
+        auto it = requestTable->requests.find(key);
+        if (it != requestTable->requests.end()) {
+            it->second->promises.push_back(promise);
+            it->second->active[id]++;
+            requestTable->numCoalesced++;
+            PERF_LOG_COUNT("CoalescingLoader_coalesced", 1);
+            return future;
+        }
+
+        request = std::make_shared<Request>();
+        request->url = url;
+        request->promises.push_back(promise);
+        request->active[id] = 1;
+        requestTable->requests.emplace(key, request);
+    }
+
+    std::weak_ptr<RequestTable> weakTable = requestTable;
+    loader->loadDataAsync(url, etag).then([weakTable, key, request](::djinni::Future<DataLoaderResult> result) {
+        std::vector<std::shared_ptr<::djinni::Promise<DataLoaderResult>>> promises;
+        {
+            std::unique_lock<std::mutex> lock;
+            auto table = weakTable.lock();
+            if (table) {
+                lock = std::unique_lock<std::mutex>(table->mutex);
+                // the request may have been cancelled and replaced by a new one
+                auto it = table->requests.find(key);
+                if (it != table->requests.end() && it->second == request) {
+                    table->requests.erase(it);
+                }
+            }
+            promises.swap(request->promises);
+        }
+
+        // every waiting request gets an answer, also if the loader failed
+        std::optional<DataLoaderResult> dataResult;
+        try {
+            dataResult = result.get();
+        } catch (const std::exception &e) {
+            dataResult = DataLoaderResult(std::nullopt, std::nullopt, LoaderStatus::ERROR_OTHER, e.what());
+        } catch (...) {
+            dataResult = DataLoaderResult(std::nullopt, std::nullopt, LoaderStatus::ERROR_OTHER, std::nullopt);
+        }
+        for (const auto &promise : promises) {
+            promise->setValue(DataLoaderResult(*dataResult));
+        }
+    });
+
+    return future;
+}
+
+void CoalescingLoader::cancel(const std::string &url) {
+    bool cancelLoad = false;
+    {
+        std::lock_guard<std::mutex> lock(requestTable->mutex);
+        for (auto it = requestTable->requests.begin(); it != requestTable->requests.end();) {
+            auto &request = it->second;
+            auto active = request->active.find(id);
+            if (request->url != url || active == request->active.end()) {
+                ++it;
+                continue;
+            }
+            // one cancel per request of this wrapper
+            if (--active->second == 0) {
+                request->active.erase(active);
+            }
+            if (request->active.empty()) {
+                // nobody is waiting anymore, later requests for the url start a new load
+                cancelLoad = true;
+                it = requestTable->requests.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    if (cancelLoad) {
+        loader->cancel(url);
+    }
+}
+
+int64_t CoalescingLoader::getNumCoalesced() {
+    std::lock_guard<std::mutex> lock(requestTable->mutex);
+    return requestTable->numCoalesced;
+}
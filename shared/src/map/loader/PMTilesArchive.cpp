@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "PMTilesArchive.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef MAPSCORE_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+    uint64_t readUInt64(const uint8_t *data) {
+        uint64_t value = 0;
+        for (int i = 7; i >= 0; i--) {
+            value = (value << 8) | data[i];
+        }
+        return value;
+    }
+
+    bool readVarint(const uint8_t *&pos, const uint8_t *end, uint64_t &value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && pos < end; shift += 7) {
+            const uint8_t byte = *pos++;
+            value |= (uint64_t)(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+std::shared_ptr<PMTilesArchive> PMTilesArchive::open(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LogError <<= "PMTilesArchive: unable to open " + path;
+        return nullptr;
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size < (off_t)headerSize) {
+        ::close(fd);
+        LogError <<= "PMTilesArchive: invalid file " + path;
+        return nullptr;
+    }
+
+    const size_t size = (size_t)fileStat.st_size;
+    void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid after closing the descriptor
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        LogError <<= "PMTilesArchive: unable to map " + path;
+        return nullptr;
+    }
+
+    const auto data = (const uint8_t *)mapped;
+    const auto header = parseHeader(data, size);
+    if (!header || !isInRange(header->rootDirectoryOffset, header->rootDirectoryLength, size) ||
+        !isInRange(header->leafDirectoriesOffset, header->leafDirectoriesLength, size) ||
+        !isInRange(header->tileDataOffset, header->tileDataLength, size)) {
+        munmap(mapped, size);
+        LogError <<= "PMTilesArchive: not a valid PMTiles v3 archive " + path;
+        return nullptr;
+    }
+
+    auto archive = std::shared_ptr<PMTilesArchive>(new PMTilesArchive(data, size, *header));
+    archive->rootDirectory = archive->readDirectory(header->rootDirectoryOffset, header->rootDirectoryLength);
+    if (!archive->rootDirectory) {
+        LogError <<= "PMTilesArchive: unable to read root directory of " + path;
+        return nullptr;
+    }
+    return archive;
+}
+
+PMTilesArchive::PMTilesArchive(const uint8_t *data, size_t size, const Header &header)
+    : data(data), size(size), header(header) {}
+
+PMTilesArchive::~PMTilesArchive() {
+    munmap((void *)data, size);
+}
+
+std::optional<PMTilesArchive::Header> PMTilesArchive::parseHeader(const uint8_t *data, size_t size) {
+    if (size < headerSize || std::memcmp(data, "PMTiles", 7) != 0 || data[7] != 3) {
+        return std::nullopt;
+    }
+    return Header{
+        readUInt64(data + 8),
+        readUInt64(data + 16),
+        readUInt64(data + 24),
+        readUInt64(data + 32),
+        readUInt64(data + 40),
+        readUInt64(data + 48),
+        readUInt64(data + 56),
+        readUInt64(data + 64),
+        (Compression)data[97],
+        (Compression)data[98],
+        (TileType)data[99],
+        data[100],
+        data[101],
+    };
+}
+
+uint64_t PMTilesArchive::zxyToTileId(uint8_t z, uint32_t x, uint32_t y) {
+    uint64_t acc = 0;
+    for (uint8_t t = 0; t < z; t++) {
+        acc += (1ULL << t) * (1ULL << t);
+    }
+
+    const int64_t n = 1LL << z;
+    int64_t tx = x;
+    int64_t ty = y;
+    uint64_t d = 0;
+    for (int64_t s = n / 2; s > 0; s /= 2) {
+        const int64_t rx = (tx & s) > 0;
+        const int64_t ry = (ty & s) > 0;
+        d += (uint64_t)(s * s * ((3 * rx) ^ ry));
+        if (ry == 0) {
+            if (rx == 1) {
+                tx = s - 1 - tx;
+                ty = s - 1 - ty;
+            }
+            std::swap(tx, ty);
+        }
+    }
+    return acc + d;
+}
+
+std::optional<std::vector<uint8_t>> PMTilesArchive::decompress(const uint8_t *data, size_t size, Compression compression,
+                                                               size_t maxSize) {
+    switch (compression) {
+        case Compression::NONE:
+        case Compression::UNKNOWN:
+            if (size > maxSize) {
+                return std::nullopt;
+            }
+            return std::vector<uint8_t>(data, data + size);
+        case Compression::GZIP: {
+#ifdef MAPSCORE_WITH_ZLIB
+            z_stream stream{};
+            // 16 + MAX_WBITS: expect a gzip header
+            if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) {
+                return std::nullopt;
+            }
+            stream.next_in = (Bytef *)data;
+            stream.avail_in = (uInt)size;
+
+            std::vector<uint8_t> result(std::min(std::max<size_t>(size * 4, 1024), maxSize));
+            int status = Z_OK;
+            while (status == Z_OK) {
+                if (stream.total_out >= result.size()) {
+                    // a corrupt or malicious stream must not inflate without bounds
+                    if (result.size() >= maxSize) {
+                        status = Z_BUF_ERROR;
+                        break;
+                    }
+                    result.resize(std::min(result.size() * 2, maxSize));
+                }
+                stream.next_out = result.data() + stream.total_out;
+                stream.avail_out = (uInt)(result.size() - stream.total_out);
+                status = inflate(&stream, Z_NO_FLUSH);
+            }
+            inflateEnd(&stream);
+            if (status != Z_STREAM_END) {
+                return std::nullopt;
+            }
+            result.resize(stream.total_out);
+            return result;
+#else
+            LogError <<= "PMTilesArchive: gzip compression is not supported without zlib";
+            return std::nullopt;
+#endif
+        }
+        default:
+            LogError <<= "PMTilesArchive: unsupported compression " + std::to_string((int)compression);
+            return std::nullopt;
+    }
+}
+
+std::optional<PMTilesArchive::Directory> PMTilesArchive::parseDirectory(const uint8_t *data, size_t size) {
+    const uint8_t *pos = data;
+    const uint8_t *end = data + size;
+
+    uint64_t numEntries = 0;
+    if (!readVarint(pos, end, numEntries) || numEntries > size) {
+        return std::nullopt;
+    }
+
+    Directory directory(numEntries);
+    uint64_t value = 0;
+    uint64_t lastId = 0;
+    for (auto &entry : directory) {
+        if (!readVarint(pos, end, value)) {
+            return std::nullopt;
+        }
+        lastId += value;
+        entry.tileId = lastId;
+    }
+    for (auto &entry : directory) {
+        if (!readVarint(pos, end, value)) {
+            return std::nullopt;
+        }
+        entry.runLength = (uint32_t)value;
+    }
+    for (auto &entry : directory) {
+        if (!readVarint(pos, end, value)) {
+            return std::nullopt;
+        }
+        entry.length = (uint32_t)value;
+    }
+    for (size_t i = 0; i < directory.size(); i++) {
+        if (!readVarint(pos, end, value)) {
+            return std::nullopt;
+        }
+        // 0 encodes an entry directly following the previous one
+        if (value == 0 && i > 0) {
+            directory[i].offset = directory[i - 1].offset + directory[i - 1].length;
+        } else {
+            directory[i].offset = value - 1;
+        }
+    }
+    return directory;
+}
+
+std::shared_ptr<const PMTilesArchive::Directory> PMTilesArchive::readDirectory(uint64_t offset, uint64_t length) {
+    if (!isInRange(offset, length, size)) {
+        return nullptr;
+    }
+    const auto bytes = decompress(data + offset, length, header.internalCompression);
+    if (!bytes) {
+        return nullptr;
+    }
+    auto directory = parseDirectory(bytes->data(), bytes->size());
+    if (!directory) {
+        return nullptr;
+    }
+    return std::make_shared<const Directory>(std::move(*directory));
+}
+
+std::shared_ptr<const PMTilesArchive::Directory> PMTilesArchive::getLeafDirectory(uint64_t offset, uint64_t length) {
+    // the offsets of the directory entries are relative to their section, checked against the rest of the file
+    if (!isInRange(offset, length, size - header.leafDirectoriesOffset)) {
+        return nullptr;
+    }
+    const uint64_t absoluteOffset = header.leafDirectoriesOffset + offset;
+    {
+        std::lock_guard<std::mutex> lock(leafCacheMutex);
+        auto it = leafCache.find(absoluteOffset);
+        if (it != leafCache.end()) {
+            leafCacheOrder.splice(leafCacheOrder.begin(), leafCacheOrder, it->second.second);
+            return it->second.first;
+        }
+    }
+
+    auto directory = readDirectory(absoluteOffset, length);
+    if (!directory) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(leafCacheMutex);
+    if (leafCache.count(absoluteOffset) == 0) {
+        leafCacheOrder.push_front(absoluteOffset);
+        leafCache[absoluteOffset] = {directory, leafCacheOrder.begin()};
+        if (leafCache.size() > maxCachedLeafDirectories) {
+            leafCache.erase(leafCacheOrder.back());
+            leafCacheOrder.pop_back();
+        }
+    }
+    return directory;
+}
+
+std::optional<PMTilesArchive::TileData> PMTilesArchive::getTile(uint8_t z, uint32_t x, uint32_t y) {
+    if (z < header.minZoom || z > header.maxZoom || x >= (1ULL << z) || y >= (1ULL << z)) {
+        return std::nullopt;
+    }
+
+    const uint64_t tileId = zxyToTileId(z, x, y);
+    auto directory = rootDirectory;
+    for (int depth = 0; depth < maxDirectoryDepth && directory; depth++) {
+        // last entry with an id not greater than the tile id
+        auto it = std::upper_bound(directory->begin(), directory->end(), tileId,
+                                   [](uint64_t id, const Entry &entry) { return id < entry.tileId; });
+        if (it == directory->begin()) {
+            return std::nullopt;
+        }
+        const auto &entry = *std::prev(it);
+
+        if (entry.runLength == 0) {
+            directory = getLeafDirectory(entry.offset, entry.length);
+            continue;
+        }
+        if (tileId >= entry.tileId + entry.runLength) {
+            return std::nullopt;
+        }
+        if (!isInRange(entry.offset, entry.length, size - header.tileDataOffset)) {
+            return std::nullopt;
+        }
+        return TileData{data + header.tileDataOffset + entry.offset, entry.length};
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "PMTilesLoader.h"
+#include "DataLoaderResult.h"
+#include "TextureLoaderResult.h"
+#include <charconv>
+
+PMTilesLoader::PMTilesLoader(TextureDecoder textureDecoder)
+    : textureDecoder(std::move(textureDecoder)) {}
+
+std::optional<PMTilesLoader::TileRequest> PMTilesLoader::parseUrl(const std::string &url) {
+    static const std::string scheme = "pmtiles://";
+    if (url.rfind(scheme, 0) != 0) {
+        return std::nullopt;
+    }
+
+    // split off the last three path components {z}/{x}/{y}
+    size_t end = url.size();
+    uint32_t values[3];
+    for (int i = 2; i >= 0; i--) {
+        const size_t slash = url.rfind('/', end - 1);
+        if (slash == std::string::npos || slash < scheme.size()) {
+            return std::nullopt;
+        }
+        const char *first = url.data() + slash + 1;
+        const auto [ptr, ec] = std::from_chars(first, url.data() + end, values[i]);
+        // only the last component may have a suffix (file extension)
+        if (ec != std::errc() || ptr == first || (i != 2 && ptr != url.data() + end)) {
+            return std::nullopt;
+        }
+        end = slash;
+    }
+    if (values[0] > 31) {
+        return std::nullopt;
+    }
+    return TileRequest{url.substr(scheme.size(), end - scheme.size()), (uint8_t)values[0], values[1], values[2]};
+}
+
+std::shared_ptr<PMTilesArchive> PMTilesLoader::getArchive(const std::string &path) {
+    std::lock_guard<std::mutex> lock(archivesMutex);
+    auto it = archives.find(path);
+    if (it != archives.end()) {
+        return it->second;
+    }
+    // failed opens are not retried
+    auto archive = PMTilesArchive::open(path);
+    archives[path] = archive;
+    return archive;
+}
+
+DataLoaderResult PMTilesLoader::loadData(const std::string &url, const std::optional<std::string> &etag) {
+    const auto request = parseUrl(url);
+    if (!request) {
+        return DataLoaderResult(std::nullopt, std::nullopt, LoaderStatus::NOOP, std::nullopt);
+    }
+    const auto archive = getArchive(request->archivePath);
+    if (!archive) {
+        return DataLoaderResult(std::nullopt, std::nullopt, LoaderStatus::ERROR_OTHER, "invalid archive");
+    }
+    const auto tile = archive->getTile(request->z, request->x, request->y);
+    if (!tile) {
+        return DataLoaderResult(std::nullopt, std::nullopt, LoaderStatus::ERROR_404, std::nullopt);
+    }
+
+    const auto compression = archive->getHeader().tileCompression;
+    if (compression == PMTilesArchive::Compression::NONE || compression == PMTilesArchive::Compression::UNKNOWN) {
+        return DataLoaderResult(::djinni::DataRef(tile->data, tile->size), std::nullopt, LoaderStatus::OK, std::nullopt);
+    }
+    auto decompressed = PMTilesArchive::decompress(tile->data, tile->size, compression);
+    if (!decompressed) {
+        return DataLoaderResult(std::nullopt, std::nullopt, LoaderStatus::ERROR_OTHER, "decompression failed");
+    }
+    return DataLoaderResult(::djinni::DataRef(std::move(*decompressed)), std::nullopt, LoaderStatus::OK, std::nullopt);
+}
+
+TextureLoaderResult PMTilesLoader::loadTexture(const std::string &url, const std::optional<std::string> &etag) {
+    const auto request = parseUrl(url);
+    if (!request) {
+        return TextureLoaderResult(nullptr, std::nullopt, LoaderStatus::NOOP, std::nullopt);
+    }
+    if (!textureDecoder) {
+        return TextureLoaderResult(nullptr, std::nullopt, LoaderStatus::ERROR_OTHER, "no texture decoder");
+    }
+    const auto archive = getArchive(request->archivePath);
+    if (!archive) {
+        return TextureLoaderResult(nullptr, std::nullopt, LoaderStatus::ERROR_OTHER, "invalid archive");
+    }
+    const auto tile = archive->getTile(request->z, request->x, request->y);
+    if (!tile) {
+        return TextureLoaderResult(nullptr, std::nullopt, LoaderStatus::ERROR_404, std::nullopt);
+    }
+    auto texture = textureDecoder(tile->data, tile->size);
+    if (!texture) {
+        return TextureLoaderResult(nullptr, std::nullopt, LoaderStatus::ERROR_OTHER, "decoding failed");
+    }
+    return TextureLoaderResult(texture, std::nullopt, LoaderStatus::OK, std::nullopt);
+}
+
+::djinni::Future<DataLoaderResult> PMTilesLoader::loadDataAsync(const std::string &url, const std::optional<std::string> &etag) {
+    // reading from the mapped archive does not block on I/O other than page faults
+    ::djinni::Promise<DataLoaderResult> promise;
+    promise.setValue(loadData(url, etag));
+    return promise.getFuture();
+}
+
+::djinni::Future<TextureLoaderResult> PMTilesLoader::loadTextureAsync(const std::string &url, const std::optional<std::string> &etag) {
+    ::djinni::Promise<TextureLoaderResult> promise;
+    promise.setValue(loadTexture(url, etag));
+    return promise.getFuture();
+}
@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2021 Ubique Innovation AG <https://www.ubique.ch>
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ *  SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "TilePackFile.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static bool writeFully(int fd, const uint8_t *data, size_t size, uint64_t offset) {
+    while (size > 0) {
+        auto written = pwrite(fd, data, size, (off_t)offset);
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        size -= (size_t)written;
+        offset += (uint64_t)written;
+    }
+    return true;
+}
+
+std::shared_ptr<TilePackFile> TilePackFile::open(const std::string &path, int64_t maxSize) {
+    auto packFile = std::shared_ptr<TilePackFile>(new TilePackFile(path, maxSize));
+    if (!packFile->openFile(false)) {
+        LogError <<= "TilePackFile: unable to open " + path;
+        return nullptr;
+    }
+    if (!packFile->readIndex()) {
+        LogError <<= "TilePackFile: " + path + " is not a tile pack file, it is replaced";
+        packFile->closeFile();
+        if (!packFile->openFile(true)) {
+            LogError <<= "TilePackFile: unable to create " + path;
+            return nullptr;
+        }
+    }
+    return packFile;
+}
+
+TilePackFile::TilePackFile(const std::string &path, int64_t maxSize)
+    : path(path)
+    , maxSize(maxSize) {}
+
+TilePackFile::~TilePackFile() { closeFile(); }
+
+bool TilePackFile::openFile(bool truncate) {
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | (truncate ? O_TRUNC : 0), 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0) {
+        closeFile();
+        return false;
+    }
+    fileSize = (uint64_t)fileStat.st_size;
+
+    if (fileSize == 0) {
+        uint8_t header[fileHeaderSize];
+        std::memcpy(header, &fileMagic, 4);
+        std::memcpy(header + 4, &fileVersion, 4);
+        if (!writeFully(fd, header, fileHeaderSize, 0)) {
+            closeFile();
+            return false;
+        }
+        fileSize = fileHeaderSize;
+    }
+
+    if (!mapFile()) {
+        closeFile();
+        return false;
+    }
+    return true;
+}
+
+void TilePackFile::closeFile() {
+    if (mapped) {
+        munmap(mapped, mappedSize);
+        mapped = nullptr;
+        mappedSize = 0;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+bool TilePackFile::mapFile() {
+    if (mapped) {
+        munmap(mapped, mappedSize);
+        mapped = nullptr;
+        mappedSize = 0;
+    }
+    void *newMapping = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+    if (newMapping == MAP_FAILED) {
+        return false;
+    }
+    mapped = (uint8_t *)newMapping;
+    mappedSize = fileSize;
+    return true;
+}
+
+size_t TilePackFile::recordSize(const RecordHeader &header) {
+    return sizeof(RecordHeader) + header.keyLength + (header.etagLength == noEtag ? 0 : header.etagLength) +
+           (header.dataLength == removedKey ? 0 : header.dataLength);
+}
+
+bool TilePackFile::readIndex() {
+    if (fileSize < fileHeaderSize) {
+        return false;
+    }
+    uint32_t magic;
+    uint32_t version;
+    std::memcpy(&magic, mapped, 4);
+    std::memcpy(&version, mapped + 4, 4);
+    if (magic != fileMagic || version != fileVersion) {
+        return false;
+    }
+
+    index.clear();
+    uint64_t offset = fileHeaderSize;
+    while (offset + sizeof(RecordHeader) <= fileSize) {
+        RecordHeader header;
+        std::memcpy(&header, mapped + offset, sizeof(RecordHeader));
+        if (header.magic != recordMagic || offset + recordSize(header) > fileSize) {
+            break;
+        }
+
+        std::string key((const char *)mapped + offset + sizeof(RecordHeader), header.keyLength);
+        if (header.dataLength == removedKey) {
+            index.erase(key);
+        } else {
+            index.insert_or_assign(std::move(key), Entry{offset, header, ++accessCounter});
+        }
+        offset += recordSize(header);
+    }
+
+    if (offset < fileSize) {
+        LogWarning <<= "TilePackFile: dropping incomplete records at the end of " + path;
+        if (ftruncate(fd, (off_t)offset) != 0) {
+            return false;
+        }
+        fileSize = offset;
+        return mapFile();
+    }
+    return true;
+}
+
+std::optional<TilePackFile::Tile> TilePackFile::get(const std::string &key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(key);
+    if (it == index.end()) {
+        return std::nullopt;
+    }
+    auto &entry = it->second;
+    entry.lastAccess = ++accessCounter;
+
+    if (entry.offset + recordSize(entry.header) > mappedSize && !mapFile()) {
+        LogError <<= "TilePackFile: unable to map " + path;
+        return std::nullopt;
+    }
+
+    const uint8_t *record = mapped + entry.offset + sizeof(RecordHeader) + entry.header.keyLength;
+    std::optional<std::string> etag;
+    if (entry.header.etagLength != noEtag) {
+        etag = std::string((const char *)record, entry.header.etagLength);
+        record += entry.header.etagLength;
+    }
+    return Tile{std::vector<uint8_t>(record, record + entry.header.dataLength), std::move(etag), entry.header.storedAt};
+}
+
+bool TilePackFile::put(const std::string &key, const uint8_t *data, size_t size, const std::optional<std::string> &etag,
+                       int64_t storedAt) {
+    RecordHeader header{recordMagic, (uint32_t)key.size(), etag ? (uint32_t)etag->size() : noEtag, (uint32_t)size, storedAt};
+    if (size >= removedKey || (int64_t)recordSize(header) > maxSize) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    const uint64_t offset = fileSize;
+    if (!append(header, key, etag, data)) {
+        return false;
+    }
+    index.insert_or_assign(key, Entry{offset, header, ++accessCounter});
+
+    if ((int64_t)fileSize > maxSize) {
+        compact();
+    }
+    return true;
+}
+
+void TilePackFile::touch(const std::string &key, int64_t storedAt) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(key);
+    if (it == index.end()) {
+        return;
+    }
+    // the only write that is not an append
+    if (writeFully(fd, (const uint8_t *)&storedAt, sizeof(storedAt), it->second.offset + offsetof(RecordHeader, storedAt))) {
+        it->second.header.storedAt = storedAt;
+    }
+}
+
+void TilePackFile::remove(const std::string &key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (index.erase(key) == 0) {
+        return;
+    }
+    RecordHeader header{recordMagic, (uint32_t)key.size(), noEtag, removedKey, 0};
+    append(header, key, std::nullopt, nullptr);
+}
+
+size_t TilePackFile::getNumEntries() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return index.size();
+}
+
+int64_t TilePackFile::getFileSize() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return (int64_t)fileSize;
+}
+
+bool TilePackFile::append(const RecordHeader &header, const std::string &key, const std::optional<std::string> &etag,
+                          const uint8_t *data) {
+    std::vector<uint8_t> record(recordSize(header));
+    uint8_t *pos = record.data();
+    std::memcpy(pos, &header, sizeof(RecordHeader));
+    pos += sizeof(RecordHeader);
+    std::memcpy(pos, key.data(), key.size());
+    pos += key.size();
+    if (etag) {
+        std::memcpy(pos, etag->data(), etag->size());
+        pos += etag->size();
+    }
+    if (header.dataLength != removedKey && header.dataLength > 0) {
+        std::memcpy(pos, data, header.dataLength);
+    }
+
+    if (!writeFully(fd, record.data(), record.size(), fileSize)) {
+        LogError <<= "TilePackFile: unable to write to " + path;
+        // drop a partially written record
+        if (ftruncate(fd, (off_t)fileSize) != 0) {
+            LogError <<= "TilePackFile: unable to truncate " + path;
+        }
+        return false;
+    }
+    fileSize += record.size();
+    return true;
+}
+
+void TilePackFile::compact() {
+    if (mappedSize < fileSize && !mapFile()) {
+        LogError <<= "TilePackFile: unable to map " + path;
+        return;
+    }
+
+    std::vector<std::pair<const std::string *, Entry *>> entries;
+    entries.reserve(index.size());
+    for (auto &[key, entry] : index) {
+        entries.emplace_back(&key, &entry);
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto &a, const auto &b) { return a.second->lastAccess > b.second->lastAccess; });
+
+    // keep the most recently used entries
+    const uint64_t targetSize = (uint64_t)maxSize / 4 * 3;
+    uint64_t keptSize = fileHeaderSize;
+    size_t numKept = 0;
+    while (numKept < entries.size() && keptSize + recordSize(entries[numKept].second->header) <= targetSize) {
+        keptSize += recordSize(entries[numKept].second->header);
+        numKept++;
+    }
+    entries.resize(numKept);
+
+    const std::string compactPath = path + ".compact";
+    int compactFd = ::open(compactPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (compactFd < 0) {
+        LogError <<= "TilePackFile: unable to create " + compactPath;
+        return;
+    }
+
+    // written from the least to the most recently used, such that reopening the file restores the order
+    std::unordered_map<std::string, Entry> compactedIndex;
+    uint64_t offset = 0;
+    bool success = writeFully(compactFd, mapped, fileHeaderSize, 0);
+    offset += fileHeaderSize;
+    for (auto it = entries.rbegin(); it != entries.rend() && success; ++it) {
+        const auto &entry = *it->second;
+        const size_t size = recordSize(entry.header);
+        success = writeFully(compactFd, mapped + entry.offset, size, offset);
+        compactedIndex.emplace(*it->first, Entry{offset, entry.header, entry.lastAccess});
+        offset += size;
+    }
+    ::close(compactFd);
+
+    if (!success || std::rename(compactPath.c_str(), path.c_str()) != 0) {
+        LogError <<= "TilePackFile: unable to compact " + path;
+        std::remove(compactPath.c_str());
+        return;
+    }
+
+    closeFile();
+    index.clear();
+    if (!openFile(false)) {
+        LogError <<= "TilePackFile: unable to reopen " + path;
+        return;
+    }
+    index = std::move(compactedIndex);
+}
@@ -107,4 +107,22 @@ TEST_CASE("Actor Mailbox with synthetic Scheduler") {
         scheduler->drain();
         REQUIRE(fooActor.unsafe()->value == 5);
     }
+
+    SECTION("empty listener") {
+        auto mailbox = std::make_shared<Mailbox>(scheduler);
+        Actor<Foo> observedActor(mailbox);
+        int emptyCount = 0;
+        mailbox->setEmptyListener([&emptyCount] { emptyCount++; });
+
+        observedActor.message(MFN(&Foo::increment));
+        observedActor.message(MFN(&Foo::add), 5);
+        scheduler->drain();
+        REQUIRE(observedActor.unsafe()->value == 6);
+        // only called once both messages are processed
+        REQUIRE(emptyCount == 1);
+
+        observedActor.message(MFN(&Foo::times2));
+        scheduler->drain();
+        REQUIRE(emptyCount == 2);
+    }
 }
@@ -0,0 +1,153 @@
+#include "CachingLoader.h"
+#include "DataLoaderResult.h"
+#include "TextureLoaderResult.h"
+#include "TilePackFile.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cassert>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Answers immediately with the data of its map, honouring etags like an http server
+class EtagTestLoader : public LoaderInterface {
+  public:
+    TextureLoaderResult loadTexture(const std::string &url, const std::optional<std::string> &etag) override {
+        assert(false);
+        std::abort();
+    }
+
+    DataLoaderResult loadData(const std::string &url, const std::optional<std::string> &etag) override {
+        requests.emplace_back(url, etag);
+        if (offline) {
+            return DataLoaderResult(std::nullopt, std::nullopt, LoaderStatus::ERROR_NETWORK, std::nullopt);
+        }
+        auto it = data.find(url);
+        if (it == data.end()) {
+            return DataLoaderResult(std::nullopt, std::nullopt, LoaderStatus::ERROR_404, std::nullopt);
+        }
+        const auto currentEtag = "etag-" + it->second;
+        if (etag == currentEtag) {
+            return DataLoaderResult(std::nullopt, currentEtag, LoaderStatus::OK, std::nullopt);
+        }
+        return DataLoaderResult(djinni::DataRef(it->second.data(), it->second.size()), currentEtag, LoaderStatus::OK, std::nullopt);
+    }
+
+    ::djinni::Future<TextureLoaderResult> loadTextureAsync(const std::string &url, const std::optional<std::string> &etag) override {
+        assert(false);
+        std::abort();
+    }
+
+    ::djinni::Future<DataLoaderResult> loadDataAsync(const std::string &url, const std::optional<std::string> &etag) override {
+        ::djinni::Promise<DataLoaderResult> promise;
+        promise.setValue(loadData(url, etag));
+        return promise.getFuture();
+    }
+
+    void cancel(const std::string &url) override {}
+
+    std::map<std::string, std::string> data;
+    bool offline = false;
+    std::vector<std::pair<std::string, std::optional<std::string>>> requests;
+};
+
+std::string toString(const DataLoaderResult &result) {
+    REQUIRE(result.data.has_value());
+    return std::string((const char *)result.data->buf(), result.data->len());
+}
+
+} // namespace
+
+TEST_CASE("CachingLoader serves and revalidates tiles from the pack file") {
+    const auto path = (std::filesystem::temp_directory_path() / "mapscore_test.tilepack").string();
+    std::filesystem::remove(path);
+
+    auto loader = std::make_shared<EtagTestLoader>();
+    loader->data = {{"0/0/0", "tile a"}, {"1/0/0", "tile b"}};
+
+    {
+        CachingLoader cachingLoader(loader, path, 1 << 20, 60 * 60 * 1000);
+        REQUIRE(toString(cachingLoader.loadDataAsync("0/0/0", std::nullopt).get()) == "tile a");
+        REQUIRE(loader->requests.size() == 1);
+
+        // fresh entries are served without asking the loader
+        auto cached = cachingLoader.loadDataAsync("0/0/0", std::nullopt);
+        REQUIRE(cached.isReady());
+        REQUIRE(toString(cached.get()) == "tile a");
+        REQUIRE(cached.get().etag == "etag-tile a");
+        REQUIRE(loader->requests.size() == 1);
+
+        REQUIRE(cachingLoader.loadData("1/0/1", std::nullopt).status == LoaderStatus::ERROR_404);
+    }
+
+    // entries are kept across sessions, stale ones are revalidated with their etag
+    {
+        CachingLoader cachingLoader(loader, path, 1 << 20, 0);
+        loader->requests.clear();
+        REQUIRE(toString(cachingLoader.loadDataAsync("0/0/0", std::nullopt).get()) == "tile a");
+        REQUIRE(loader->requests.size() == 1);
+        REQUIRE(loader->requests[0].second == "etag-tile a");
+
+        loader->data["0/0/0"] = "tile a v2";
+        REQUIRE(toString(cachingLoader.loadDataAsync("0/0/0", std::nullopt).get()) == "tile a v2");
+
+        loader->offline = true;
+        REQUIRE(toString(cachingLoader.loadDataAsync("0/0/0", std::nullopt).get()) == "tile a v2");
+        loader->offline = false;
+
+        loader->data.erase("0/0/0");
+        REQUIRE(cachingLoader.loadDataAsync("0/0/0", std::nullopt).get().status == LoaderStatus::ERROR_404);
+    }
+
+    auto packFile = TilePackFile::open(path, 1 << 20);
+    REQUIRE(packFile);
+    REQUIRE(packFile->getNumEntries() == 0);
+    packFile.reset();
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("TilePackFile compacts to the most recently used entries") {
+    const auto path = (std::filesystem::temp_directory_path() / "mapscore_test_compact.tilepack").string();
+    std::filesystem::remove(path);
+
+    const int64_t maxSize = 64 * 1024;
+    const std::vector<uint8_t> data(1000, 7);
+    {
+        auto packFile = TilePackFile::open(path, maxSize);
+        REQUIRE(packFile);
+        for (int i = 0; i < 200; i++) {
+            REQUIRE(packFile->put("tile/" + std::to_string(i), data.data(), data.size(), std::nullopt, 0));
+            // keep the first tile in use
+            REQUIRE(packFile->get("tile/0"));
+            REQUIRE(packFile->getFileSize() <= maxSize);
+        }
+        REQUIRE(packFile->get("tile/199"));
+        REQUIRE(packFile->get("tile/0"));
+        REQUIRE(!packFile->get("tile/100"));
+    }
+
+    // a partially written record is cut off on opening
+    const auto fileSize = std::filesystem::file_size(path);
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        file << "incomplete";
+    }
+    {
+        auto packFile = TilePackFile::open(path, maxSize);
+        REQUIRE(packFile);
+        REQUIRE(packFile->getFileSize() == (int64_t)fileSize);
+        auto tile = packFile->get("tile/199");
+        REQUIRE(tile);
+        REQUIRE(tile->data == data);
+        REQUIRE(packFile->get("tile/0"));
+    }
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,175 @@
+#include "CoalescingLoader.h"
+#include "DataLoaderResult.h"
+#include "TextureLoaderResult.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cassert>
+#include <cstdlib>
+#include <exception>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Keeps all data loads pending until they are resolved by the test
+class PendingTestLoader : public LoaderInterface {
+  public:
+    TextureLoaderResult loadTexture(const std::string &url, const std::optional<std::string> &etag) override {
+        assert(false);
+        std::abort();
+    }
+
+    DataLoaderResult loadData(const std::string &url, const std::optional<std::string> &etag) override {
+        assert(false);
+        std::abort();
+    }
+
+    ::djinni::Future<TextureLoaderResult> loadTextureAsync(const std::string &url, const std::optional<std::string> &etag) override {
+        assert(false);
+        std::abort();
+    }
+
+    ::djinni::Future<DataLoaderResult> loadDataAsync(const std::string &url, const std::optional<std::string> &etag) override {
+        numLoads[url]++;
+        auto &promise = pending.emplace_back(url, ::djinni::Promise<DataLoaderResult>());
+        return promise.second.getFuture();
+    }
+
+    void cancel(const std::string &url) override { numCancels[url]++; }
+
+    void resolveAll() {
+        auto loads = std::move(pending);
+        pending.clear();
+        for (auto &[url, promise] : loads) {
+            std::string data = "data " + url;
+            promise.setValue(DataLoaderResult(djinni::DataRef(data.data(), data.size()), std::nullopt, LoaderStatus::OK, std::nullopt));
+        }
+    }
+
+    void failAll() {
+        auto loads = std::move(pending);
+        pending.clear();
+        for (auto &[url, promise] : loads) {
+            promise.setException(std::make_exception_ptr(std::runtime_error("load failed")));
+        }
+    }
+
+    std::map<std::string, int> numLoads;
+    std::map<std::string, int> numCancels;
+
+  private:
+    std::vector<std::pair<std::string, ::djinni::Promise<DataLoaderResult>>> pending;
+};
+
+std::string toString(const DataLoaderResult &result) {
+    return std::string((const char *)result.data->buf(), result.data->len());
+}
+
+} // namespace
+
+TEST_CASE("CoalescingLoader deduplicates concurrent requests") {
+    auto loader = std::make_shared<PendingTestLoader>();
+    auto sourceA = CoalescingLoader::wrap({loader}).front();
+    auto sourceB = CoalescingLoader::wrap({loader}).front();
+    REQUIRE(sourceA != sourceB);
+
+    auto a = sourceA->loadDataAsync("1/0/0", std::nullopt);
+    auto b = sourceB->loadDataAsync("1/0/0", std::nullopt);
+    auto c = sourceB->loadDataAsync("1/0/1", std::nullopt);
+    auto d = sourceB->loadDataAsync("1/0/1", "etag");
+    REQUIRE(loader->numLoads["1/0/0"] == 1);
+    REQUIRE(loader->numLoads["1/0/1"] == 2);
+    REQUIRE(std::static_pointer_cast<CoalescingLoader>(sourceA)->getNumCoalesced() == 1);
+
+    loader->resolveAll();
+    REQUIRE(a.isReady());
+    REQUIRE(b.isReady());
+    REQUIRE(toString(a.get()) == "data 1/0/0");
+    REQUIRE(toString(b.get()) == "data 1/0/0");
+    REQUIRE(toString(c.get()) == "data 1/0/1");
+    REQUIRE(toString(d.get()) == "data 1/0/1");
+
+    // finished requests are not reused
+    auto e = sourceA->loadDataAsync("1/0/0", std::nullopt);
+    REQUIRE(loader->numLoads["1/0/0"] == 2);
+    loader->resolveAll();
+    REQUIRE(e.isReady());
+}
+
+TEST_CASE("CoalescingLoader cancels a request once nobody waits for it") {
+    auto loader = std::make_shared<PendingTestLoader>();
+    auto sourceA = CoalescingLoader::wrap({loader}).front();
+    auto sourceB = CoalescingLoader::wrap({loader}).front();
+
+    auto a = sourceA->loadDataAsync("1/0/0", std::nullopt);
+    auto b = sourceB->loadDataAsync("1/0/0", std::nullopt);
+
+    // the other source still waits for the tile
+    sourceA->cancel("1/0/0");
+    sourceA->cancel("1/0/0");
+    REQUIRE(loader->numCancels["1/0/0"] == 0);
+
+    sourceB->cancel("1/0/0");
+    REQUIRE(loader->numCancels["1/0/0"] == 1);
+
+    // a new request does not join the cancelled one
+    auto c = sourceA->loadDataAsync("1/0/0", std::nullopt);
+    REQUIRE(loader->numLoads["1/0/0"] == 2);
+
+    loader->resolveAll();
+    REQUIRE(a.isReady());
+    REQUIRE(b.isReady());
+    REQUIRE(c.isReady());
+}
+
+TEST_CASE("CoalescingLoader counts the requests of a wrapper") {
+    auto loader = std::make_shared<PendingTestLoader>();
+    auto sourceA = CoalescingLoader::wrap({loader}).front();
+    auto sourceB = CoalescingLoader::wrap({loader}).front();
+
+    auto a = sourceA->loadDataAsync("1/0/0", std::nullopt);
+    auto b = sourceA->loadDataAsync("1/0/0", std::nullopt);
+    REQUIRE(loader->numLoads["1/0/0"] == 1);
+
+    // the second request of the same source is still waiting
+    sourceA->cancel("1/0/0");
+    REQUIRE(loader->numCancels["1/0/0"] == 0);
+    auto c = sourceB->loadDataAsync("1/0/0", std::nullopt);
+    REQUIRE(loader->numLoads["1/0/0"] == 1);
+
+    sourceA->cancel("1/0/0");
+    REQUIRE(loader->numCancels["1/0/0"] == 0);
+    sourceB->cancel("1/0/0");
+    REQUIRE(loader->numCancels["1/0/0"] == 1);
+
+    loader->resolveAll();
+    REQUIRE(a.isReady());
+    REQUIRE(b.isReady());
+    REQUIRE(c.isReady());
+}
+
+TEST_CASE("CoalescingLoader answers all requests if the loader fails") {
+    auto loader = std::make_shared<PendingTestLoader>();
+    auto sourceA = CoalescingLoader::wrap({loader}).front();
+    auto sourceB = CoalescingLoader::wrap({loader}).front();
+
+    auto a = sourceA->loadDataAsync("1/0/0", std::nullopt);
+    auto b = sourceB->loadDataAsync("1/0/0", std::nullopt);
+
+    loader->failAll();
+    REQUIRE(a.isReady());
+    REQUIRE(b.isReady());
+    REQUIRE(a.get().status == LoaderStatus::ERROR_OTHER);
+    REQUIRE(b.get().status == LoaderStatus::ERROR_OTHER);
+    REQUIRE(b.get().errorCode == "load failed");
+
+    // the failed request is not reused
+    auto c = sourceA->loadDataAsync("1/0/0", std::nullopt);
+    REQUIRE(loader->numLoads["1/0/0"] == 2);
+    loader->resolveAll();
+    REQUIRE(toString(c.get()) == "data 1/0/0");
+}
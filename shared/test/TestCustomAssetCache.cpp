@@ -0,0 +1,107 @@
+#include "Tiled2dMapVectorCustomAssetCache.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+class TestTextureHolder : public TextureHolderInterface {
+  public:
+    int32_t getImageWidth() override { return 256; }
+    int32_t getImageHeight() override { return 256; }
+    int32_t getTextureWidth() override { return 256; }
+    int32_t getTextureHeight() override { return 256; }
+    int32_t attachToGraphics() override { return 0; }
+    void clearFromGraphics() override {}
+};
+
+// Packs each requested icon into a 32x32 cell of a new page and records the requests
+class TestSymbolDelegate : public Tiled2dMapVectorLayerSymbolDelegateInterface {
+  public:
+    std::vector<Tiled2dMapVectorAssetInfo> getCustomAssetsFor(const std::vector<VectorLayerFeatureInfo> &featureInfos,
+                                                              const std::string &layerIdentifier) override {
+        std::unordered_map<std::string, ::RectI> uvs;
+        for (const auto &featureInfo : featureInfos) {
+            requestedIdentifiers.push_back(featureInfo.identifier);
+            const auto index = (int32_t)uvs.size();
+            uvs.emplace(featureInfo.identifier, RectI((index % 8) * 32, (index / 8) * 32, 32, 32));
+        }
+        numRequests++;
+        return {Tiled2dMapVectorAssetInfo(uvs, std::make_shared<TestTextureHolder>())};
+    }
+
+    std::vector<std::string> requestedIdentifiers;
+    int numRequests = 0;
+};
+
+VectorLayerFeatureInfo featureInfo(const std::string &identifier, const std::string &kind = "shop") {
+    return VectorLayerFeatureInfo(identifier, {{"kind", VectorLayerFeatureInfoValue(kind, std::nullopt, std::nullopt, std::nullopt,
+                                                                                    std::nullopt, std::nullopt, std::nullopt)}});
+}
+
+} // namespace
+
+TEST_CASE("Custom asset cache shares pages between symbol groups") {
+    auto delegate = std::make_shared<TestSymbolDelegate>();
+    Tiled2dMapVectorCustomAssetCache cache(0);
+
+    auto firstGroup = cache.getCustomAssetsFor(delegate, {featureInfo("a"), featureInfo("b")}, "poi");
+    REQUIRE(firstGroup.size() == 1);
+    REQUIRE(firstGroup[0].featureIdentifiersUv.size() == 2);
+    REQUIRE(delegate->numRequests == 1);
+
+    // only the new feature is requested, the cached icon is served with the same texture and a subset of the uvs
+    auto secondGroup = cache.getCustomAssetsFor(delegate, {featureInfo("b"), featureInfo("c")}, "poi");
+    REQUIRE(delegate->numRequests == 2);
+    REQUIRE(delegate->requestedIdentifiers == std::vector<std::string>{"a", "b", "c"});
+    REQUIRE(secondGroup.size() == 2);
+    REQUIRE(secondGroup[0].texture == firstGroup[0].texture);
+    REQUIRE(secondGroup[0].featureIdentifiersUv.size() == 1);
+    REQUIRE(secondGroup[0].featureIdentifiersUv.at("b").x == firstGroup[0].featureIdentifiersUv.at("b").x);
+    REQUIRE(secondGroup[0].featureIdentifiersUv.at("b").y == firstGroup[0].featureIdentifiersUv.at("b").y);
+    REQUIRE(secondGroup[1].featureIdentifiersUv.count("c") == 1);
+
+    // the same identifier in another layer or with other properties is a different icon
+    cache.getCustomAssetsFor(delegate, {featureInfo("a", "bar")}, "poi");
+    cache.getCustomAssetsFor(delegate, {featureInfo("a")}, "transit");
+    REQUIRE(delegate->numRequests == 4);
+
+    auto stats = cache.getStatistics();
+    REQUIRE(stats.hits == 1);
+    REQUIRE(stats.misses == 5);
+    REQUIRE(stats.pagesCreated == 4);
+    REQUIRE(stats.numPages == 2);
+    REQUIRE(stats.occupancy == (3.0 * 32 * 32) / (2.0 * 256 * 256));
+
+    // pages no longer used by a group are evicted
+    firstGroup.clear();
+    secondGroup.clear();
+    stats = cache.getStatistics();
+    REQUIRE(stats.numPages == 0);
+    REQUIRE(stats.numIcons == 0);
+    cache.getCustomAssetsFor(delegate, {featureInfo("a")}, "poi");
+    REQUIRE(delegate->numRequests == 5);
+}
+
+TEST_CASE("Custom asset cache retains recently used pages") {
+    auto delegate = std::make_shared<TestSymbolDelegate>();
+    Tiled2dMapVectorCustomAssetCache cache(1);
+
+    cache.getCustomAssetsFor(delegate, {featureInfo("a")}, "poi");
+    cache.getCustomAssetsFor(delegate, {featureInfo("a")}, "poi");
+    REQUIRE(delegate->numRequests == 1);
+
+    // the page of "a" is no longer among the retained pages
+    cache.getCustomAssetsFor(delegate, {featureInfo("b")}, "poi");
+    cache.getCustomAssetsFor(delegate, {featureInfo("a")}, "poi");
+    REQUIRE(delegate->numRequests == 3);
+
+    // a new delegate may return other icons for the same features
+    auto otherDelegate = std::make_shared<TestSymbolDelegate>();
+    auto pages = cache.getCustomAssetsFor(otherDelegate, {featureInfo("a")}, "poi");
+    REQUIRE(otherDelegate->numRequests == 1);
+    REQUIRE(cache.getStatistics().numPages == 1);
+}
@@ -0,0 +1,104 @@
+#include "Tiled2dMapVectorDecodedTileCache.h"
+#include "StringInterner.h"
+#include "Value.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <string>
+
+namespace {
+
+Tiled2dMapVectorTileInfo::FeatureMap makeFeatureMap(StringInterner &stringTable, const std::string &className, size_t numPoints) {
+    auto handler = std::make_shared<VectorTileGeometryHandler>(RectCoord(Coord(0, 0, 0, 0), Coord(0, 1, 1, 0)), 4096, std::nullopt, nullptr);
+    auto &coordinates = handler->getLineCoordinates();
+    coordinates.emplace_back(numPoints, Vec2D(0.0, 0.0));
+
+    FeatureContext::mapType properties;
+    properties.emplace_back(stringTable.add("class"), className);
+    auto context = std::make_shared<FeatureContext>(vtzero::GeomType::LINESTRING, properties, (uint64_t)1);
+
+    auto featureMap = std::make_shared<std::unordered_map<std::string, std::shared_ptr<std::vector<Tiled2dMapVectorTileInfo::FeatureTuple>>>>();
+    auto features = std::make_shared<std::vector<Tiled2dMapVectorTileInfo::FeatureTuple>>();
+    features->push_back({context, handler});
+    featureMap->emplace("roads", features);
+    return featureMap;
+}
+
+} // namespace
+
+TEST_CASE("Decoded tile cache hits, misses and LRU eviction") {
+    auto stringTable = std::make_shared<StringInterner>(ValueKeys::newStringInterner());
+    auto tile = makeFeatureMap(*stringTable, "primary", 1000);
+    const size_t tileSize = Tiled2dMapVectorDecodedTileCache::estimateSizeBytes(tile);
+    REQUIRE(tileSize > 1000 * sizeof(Vec2D));
+
+    // room for two tiles
+    Tiled2dMapVectorDecodedTileCache cache(tileSize * 2 + 1024);
+
+    const auto keyA = Tiled2dMapVectorDecodedTileCache::createKey("https://tiles/0/0/0.pbf", {"roads"});
+    const auto keyB = Tiled2dMapVectorDecodedTileCache::createKey("https://tiles/1/0/0.pbf", {"roads"});
+    const auto keyC = Tiled2dMapVectorDecodedTileCache::createKey("https://tiles/1/1/0.pbf", {"roads"});
+
+    REQUIRE(cache.get(keyA, stringTable) == nullptr);
+    cache.put(keyA, stringTable, tile);
+    cache.put(keyB, stringTable, makeFeatureMap(*stringTable, "secondary", 1000));
+    REQUIRE(cache.get(keyA, stringTable) == tile);
+
+    // B is the least recently used tile
+    cache.put(keyC, stringTable, makeFeatureMap(*stringTable, "tertiary", 1000));
+    REQUIRE(cache.get(keyB, stringTable) == nullptr);
+    REQUIRE(cache.get(keyA, stringTable) == tile);
+    REQUIRE(cache.get(keyC, stringTable) != nullptr);
+
+    auto statistics = cache.getStatistics();
+    REQUIRE(statistics.hits == 3);
+    REQUIRE(statistics.misses == 2);
+    REQUIRE(statistics.evictions == 1);
+    REQUIRE(statistics.numEntries == 2);
+    REQUIRE(statistics.sizeBytes <= tileSize * 2 + 1024);
+
+    cache.setMaxSizeBytes(0);
+    statistics = cache.getStatistics();
+    REQUIRE(statistics.numEntries == 0);
+    REQUIRE(statistics.sizeBytes == 0);
+    REQUIRE(statistics.evictions == 3);
+}
+
+TEST_CASE("Decoded tile cache keys depend on the decoded layers") {
+    const auto key = Tiled2dMapVectorDecodedTileCache::createKey("https://tiles/0/0/0.pbf", {"roads", "water"});
+    REQUIRE(key == Tiled2dMapVectorDecodedTileCache::createKey("https://tiles/0/0/0.pbf", {"water", "roads"}));
+    REQUIRE(key != Tiled2dMapVectorDecodedTileCache::createKey("https://tiles/0/0/0.pbf", {"roads"}));
+    REQUIRE(key != Tiled2dMapVectorDecodedTileCache::createKey("https://tiles/0/0/0.pbf", {}));
+}
+
+TEST_CASE("Decoded tile cache does not keep tiles larger than the budget") {
+    auto stringTable = std::make_shared<StringInterner>(ValueKeys::newStringInterner());
+    Tiled2dMapVectorDecodedTileCache cache(1024);
+    cache.put("tile", stringTable, makeFeatureMap(*stringTable, "primary", 1000));
+    REQUIRE(cache.get("tile", stringTable) == nullptr);
+    REQUIRE(cache.getStatistics().numEntries == 0);
+}
+
+TEST_CASE("Decoded tile cache translates property keys between string tables") {
+    auto stringTable = std::make_shared<StringInterner>(ValueKeys::newStringInterner());
+    auto otherStringTable = std::make_shared<StringInterner>(ValueKeys::newStringInterner());
+    // shift the ids of the other table
+    otherStringTable->add("name");
+    otherStringTable->add("rank");
+
+    auto tile = makeFeatureMap(*stringTable, "primary", 10);
+    Tiled2dMapVectorDecodedTileCache cache;
+    cache.put("tile", stringTable, tile);
+
+    auto translated = cache.get("tile", otherStringTable);
+    REQUIRE(translated != nullptr);
+    REQUIRE(translated != tile);
+
+    const auto &[context, handler] = translated->at("roads")->front();
+    const auto &[originalContext, originalHandler] = tile->at("roads")->front();
+    REQUIRE(handler == originalHandler);
+    REQUIRE(std::get<std::string>(context->getValue(otherStringTable->add("class"))) == "primary");
+    REQUIRE(std::get<std::string>(originalContext->getValue(stringTable->add("class"))) == "primary");
+    REQUIRE(context->identifier == originalContext->identifier);
+}
@@ -0,0 +1,61 @@
+#include "Tiled2dMapVectorGeometryArena.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("Tiled2dMapVectorGeometryArena") {
+    Tiled2dMapVectorGeometryArena arena(100);
+
+    SECTION("allocates consecutive ranges") {
+        REQUIRE(arena.allocate(10) == 0);
+        REQUIRE(arena.allocate(20) == 10);
+        REQUIRE(arena.getEnd() == 30);
+        REQUIRE(arena.getUsed() == 30);
+    }
+
+    SECTION("respects capacity") {
+        REQUIRE(arena.allocate(90) == 0);
+        REQUIRE_FALSE(arena.allocate(11).has_value());
+        REQUIRE(arena.allocate(10) == 90);
+        REQUIRE_FALSE(arena.allocate(1).has_value());
+    }
+
+    SECTION("reuses released ranges") {
+        REQUIRE(arena.allocate(10) == 0);
+        REQUIRE(arena.allocate(10) == 10);
+        REQUIRE(arena.allocate(10) == 20);
+        arena.release(10, 10);
+        REQUIRE(arena.getUsed() == 20);
+        REQUIRE(arena.allocate(5) == 10);
+        REQUIRE(arena.allocate(5) == 15);
+        REQUIRE(arena.allocate(5) == 30);
+        REQUIRE(arena.getEnd() == 35);
+    }
+
+    SECTION("coalesces neighbouring ranges") {
+        REQUIRE(arena.allocate(10) == 0);
+        REQUIRE(arena.allocate(10) == 10);
+        REQUIRE(arena.allocate(10) == 20);
+        REQUIRE(arena.allocate(10) == 30);
+        arena.release(0, 10);
+        arena.release(20, 10);
+        arena.release(10, 10);
+        REQUIRE(arena.allocate(30) == 0);
+    }
+
+    SECTION("shrinks end when releasing the last range") {
+        REQUIRE(arena.allocate(10) == 0);
+        REQUIRE(arena.allocate(10) == 10);
+        arena.release(10, 10);
+        REQUIRE(arena.getEnd() == 10);
+        arena.release(0, 10);
+        REQUIRE(arena.isEmpty());
+        REQUIRE(arena.getEnd() == 0);
+    }
+
+    SECTION("reset") {
+        REQUIRE(arena.allocate(50) == 0);
+        arena.reset();
+        REQUIRE(arena.isEmpty());
+        REQUIRE(arena.allocate(100) == 0);
+    }
+}
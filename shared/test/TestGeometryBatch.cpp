@@ -0,0 +1,256 @@
+#include "Tiled2dMapVectorGeometryBatch.h"
+#include "Tiled2dMapVectorGeometryBatchManager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+class TestGraphicsObject : public GraphicsObjectInterface {
+  public:
+    bool isReady() override { return ready; }
+
+    void setup(const std::shared_ptr<::RenderingContextInterface> &context) override { ready = true; }
+
+    void clear() override {
+        ready = false;
+        clearCount++;
+    }
+
+    void setIsInverseMasked(bool inversed) override {}
+
+    void setDebugLabel(const std::string &label) override {}
+
+    void render(const std::shared_ptr<::RenderingContextInterface> &context, const ::RenderPassConfig &renderPass, int64_t vpMatrix,
+                int64_t mMatrix, const ::Vec3D &origin, bool isMasked, double screenPixelAsRealMeterFactor,
+                bool isScreenSpaceCoords) override {}
+
+    bool ready = false;
+    int clearCount = 0;
+};
+
+class TestMask : public MaskingObjectInterface, public std::enable_shared_from_this<TestMask> {
+  public:
+    std::shared_ptr<GraphicsObjectInterface> asGraphicsObject() override { return graphicsObject; }
+
+    void renderAsMask(const std::shared_ptr<::RenderingContextInterface> &context, const ::RenderPassConfig &renderPass,
+                      int64_t vpMatrix, int64_t mMatrix, const ::Vec3D &origin, double screenPixelAsRealMeterFactor,
+                      bool isScreenSpaceCoords) override {}
+
+    std::shared_ptr<TestGraphicsObject> graphicsObject = std::make_shared<TestGraphicsObject>();
+};
+
+// Vertices of x, y and the style index, at most 4 styles and 8 vertices per group
+class TestGeometryBatch : public Tiled2dMapVectorGeometryBatch {
+  public:
+    struct GroupData {
+        std::shared_ptr<TestGraphicsObject> graphicsObject;
+        std::vector<float> vertices;
+        std::vector<uint32_t> indices;
+        std::vector<uint8_t> styles;
+        int uploads = 0;
+    };
+
+    TestGeometryBatch()
+        : Tiled2dMapVectorGeometryBatch(3, 2, 4, 8) {}
+
+    std::vector<GroupData> groupData;
+
+  protected:
+    std::shared_ptr<GraphicsObjectInterface> createGroupObject(size_t groupIndex) override {
+        groupData.resize(std::max(groupData.size(), groupIndex + 1));
+        groupData[groupIndex].graphicsObject = std::make_shared<TestGraphicsObject>();
+        return groupData[groupIndex].graphicsObject;
+    }
+
+    void setGroupGeometry(size_t groupIndex, const std::vector<float> &vertices, const std::vector<uint32_t> &indices,
+                          const Vec3D &origin) override {
+        groupData[groupIndex].vertices = vertices;
+        groupData[groupIndex].indices = indices;
+        groupData[groupIndex].uploads++;
+    }
+
+    void setGroupStyles(size_t groupIndex, const SharedBytes &styles) override {
+        const auto begin = (const uint8_t *)styles.address;
+        groupData[groupIndex].styles.assign(begin, begin + styles.elementCount * styles.bytesPerElement);
+    }
+};
+
+Tiled2dMapVersionedTileInfo tile(int x, int y, int zoom = 10) {
+    return Tiled2dMapVersionedTileInfo(Tiled2dMapTileInfo(RectCoord(Coord(0, 0, 0, 0), Coord(0, 1, 1, 0)), x, y, 0, zoom, zoom), 0);
+}
+
+// A triangle of three vertices with the given style index
+std::vector<Tiled2dMapVectorGeometryBatch::TileGeometry> triangle(float style, int32_t styleGroupIndex = 0) {
+    return {Tiled2dMapVectorGeometryBatch::TileGeometry{styleGroupIndex, 1, {0, 0, style, 1, 0, style, 0, 1, style}, {0, 1, 2}}};
+}
+
+} // namespace
+
+TEST_CASE("Geometry batch draws the active tiles with one object per group") {
+    TestGeometryBatch batch;
+    const auto tileA = tile(0, 0);
+    const auto tileB = tile(1, 0);
+
+    batch.registerTile(tileA);
+    batch.registerTile(tileB);
+    batch.setTileGeometry(tileA, Vec3D(100, 100, 0), triangle(0));
+    batch.setTileGeometry(tileB, Vec3D(110, 100, 0), triangle(0));
+    batch.setTileStyles(tileA, 0, SharedBytes((int64_t) std::vector<uint8_t>{1, 2}.data(), 1, 2));
+
+    // nothing active, nothing to draw
+    REQUIRE_FALSE(batch.needsUpload());
+    REQUIRE(batch.getRenderObjects().empty());
+
+    batch.setActiveTiles({tileA});
+    REQUIRE(batch.needsUpload());
+    batch.upload(nullptr);
+    REQUIRE_FALSE(batch.needsUpload());
+    REQUIRE(batch.getRenderObjects().size() == 1);
+    REQUIRE(batch.groupData.size() == 1);
+    REQUIRE(batch.groupData[0].graphicsObject->isReady());
+    REQUIRE(batch.groupData[0].indices == std::vector<uint32_t>{0, 1, 2});
+
+    // the vertices of B are relative to the origin of the first tile, its style slot follows the one of A
+    batch.setActiveTiles({tileA, tileB});
+    REQUIRE(batch.needsUpload());
+    batch.upload(nullptr);
+    const auto &group = batch.groupData[0];
+    REQUIRE(group.uploads == 2);
+    REQUIRE(group.indices.size() == 6);
+    REQUIRE(group.vertices.size() == 18);
+    REQUIRE(group.vertices[9] == 10.0f);
+    REQUIRE(group.vertices[10] == 0.0f);
+    REQUIRE(group.vertices[11] == 1.0f);
+
+    // unchanged active tiles do not upload again
+    batch.setActiveTiles({tileA, tileB});
+    REQUIRE_FALSE(batch.needsUpload());
+
+    batch.setHidden(true);
+    REQUIRE(batch.getRenderObjects()[0]->isHidden());
+}
+
+TEST_CASE("Geometry batch releases and reuses the space of removed tiles") {
+    TestGeometryBatch batch;
+    const auto tileA = tile(0, 0);
+    const auto tileB = tile(1, 0);
+    const auto tileC = tile(2, 0);
+
+    for (const auto &t : {tileA, tileB}) {
+        batch.registerTile(t);
+        batch.setTileGeometry(t, Vec3D(0, 0, 0), triangle(0));
+    }
+    batch.setActiveTiles({tileA, tileB});
+    batch.upload(nullptr);
+    REQUIRE(batch.groupData.size() == 1);
+
+    // a third triangle does not fit into the 8 vertices of the group
+    batch.registerTile(tileC);
+    batch.setTileGeometry(tileC, Vec3D(0, 0, 0), triangle(0));
+    batch.setActiveTiles({tileA, tileB, tileC});
+    batch.upload(nullptr);
+    REQUIRE(batch.groupData.size() == 2);
+    REQUIRE(batch.getRenderObjects().size() == 2);
+
+    // the removed tile frees its vertices for the next tile of the same group
+    batch.removeTile(tileA);
+    REQUIRE_FALSE(batch.containsTile(tileA));
+    REQUIRE(batch.needsUpload());
+    batch.upload(nullptr);
+    REQUIRE(batch.groupData[0].indices == std::vector<uint32_t>{3, 4, 5});
+
+    const auto tileD = tile(3, 0);
+    batch.registerTile(tileD);
+    batch.setTileGeometry(tileD, Vec3D(0, 0, 0), triangle(0));
+    batch.setActiveTiles({tileB, tileC, tileD});
+    batch.upload(nullptr);
+    REQUIRE(batch.groupData.size() == 2);
+    REQUIRE(batch.groupData[0].indices.size() == 6);
+
+    // geometry of tiles that were removed in the meantime is ignored
+    batch.setTileGeometry(tileA, Vec3D(0, 0, 0), triangle(0));
+    REQUIRE_FALSE(batch.needsUpload());
+
+    for (const auto &t : {tileB, tileC, tileD}) {
+        batch.removeTile(t);
+    }
+    REQUIRE(batch.isEmpty());
+    batch.upload(nullptr);
+    REQUIRE(batch.getRenderObjects().empty());
+
+    batch.clear();
+    REQUIRE(batch.groupData[0].graphicsObject->clearCount == 1);
+    REQUIRE(batch.needsUpload());
+}
+
+TEST_CASE("Geometry batch manager groups tiles by layer and block") {
+    Tiled2dMapVectorGeometryBatchManager manager;
+    std::vector<std::shared_ptr<TestGeometryBatch>> created;
+    auto createBatch = [&]() {
+        created.push_back(std::make_shared<TestGeometryBatch>());
+        return created.back();
+    };
+
+    const auto tileA = tile(0, 0);
+    const auto tileB = tile(7, 7);
+    const auto tileC = tile(8, 0);
+
+    auto batchA = manager.registerTile(0, tileA, createBatch);
+    REQUIRE(manager.registerTile(0, tileB, createBatch) == batchA);
+    auto batchC = manager.registerTile(0, tileC, createBatch);
+    REQUIRE(batchC != batchA);
+    REQUIRE(manager.registerTile(1, tileA, createBatch) != batchA);
+    REQUIRE(created.size() == 3);
+    REQUIRE(manager.isBatched(tileB, 0));
+    REQUIRE_FALSE(manager.isBatched(tileB, 1));
+
+    for (const auto &t : {tileA, tileB}) {
+        batchA->setTileGeometry(t, Vec3D(0, 0, 0), triangle(0));
+    }
+    batchC->setTileGeometry(tileC, Vec3D(0, 0, 0), triangle(0));
+
+    auto maskA = std::make_shared<TestMask>();
+    auto maskB = std::make_shared<TestMask>();
+    std::unordered_map<Tiled2dMapVersionedTileInfo, std::shared_ptr<MaskingObjectInterface>> visibleTiles = {
+        {tileA, maskA}, {tileB, maskB}, {tileC, nullptr}};
+
+    // the batches have to be uploaded before they are rendered
+    REQUIRE_FALSE(manager.prepareRenderDescriptions(visibleTiles).has_value());
+    manager.upload(nullptr);
+    auto descriptions = manager.prepareRenderDescriptions(visibleTiles);
+    REQUIRE(descriptions.has_value());
+    REQUIRE(descriptions->size() == 3);
+
+    std::shared_ptr<MaskingObjectInterface> blockMask;
+    for (const auto &description : *descriptions) {
+        if (description.layerIndex == 0 && description.renderObjects.size() == 1 && description.mask) {
+            blockMask = description.mask;
+        }
+    }
+    // one mask of the masks of both tiles of the block, kept while the tiles stay the same
+    REQUIRE(blockMask);
+    auto batchMask = std::dynamic_pointer_cast<Tiled2dMapVectorGeometryBatchMask>(blockMask);
+    REQUIRE(batchMask->getMasks().size() == 2);
+    auto again = manager.prepareRenderDescriptions(visibleTiles);
+    bool sameMask = false;
+    for (const auto &description : *again) {
+        sameMask |= description.mask == blockMask;
+    }
+    REQUIRE(sameMask);
+
+    // the last tile of a block removes its batch, its graphics objects are cleared on the next upload
+    manager.removeTile(tileC);
+    REQUIRE_FALSE(manager.isBatched(tileC, 0));
+    manager.upload(nullptr);
+    REQUIRE(created[1]->groupData[0].graphicsObject->clearCount == 1);
+    REQUIRE(manager.registerTile(0, tileC, createBatch) != batchC);
+
+    manager.removeTile(tileA);
+    REQUIRE_FALSE(manager.isBatched(tileA, 0));
+    REQUIRE_FALSE(manager.isBatched(tileA, 1));
+    REQUIRE(manager.isBatched(tileB, 0));
+}
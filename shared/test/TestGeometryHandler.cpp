@@ -60,3 +60,48 @@ TEST_CASE("VectorTileGeometryHandler") {
         return parseAndTriangulate("tiles/relief.pbf", ParsingResult{24345,34413,34413}, meter);
     };
 }
+
+static void countLineVertices(const char *filePath, double tolerance, size_t &numVertices, size_t &numRemovedVertices) {
+    ::RectCoord tileCoords = {Coord(3857,1224991.657211,6287508.342789,0), Coord(3857,1849991.657211,5662508.342789,0)};
+    const auto conversionHelper = std::make_shared<CoordinateConversionHelper>(CoordinateSystemFactory::getEpsg3857System(), false);
+    auto data = TestData::readFileToBuffer(filePath);
+    StringInterner stringTable = ValueKeys::newStringInterner();
+
+    numVertices = 0;
+    numRemovedVertices = 0;
+    vtzero::vector_tile tileData(data.data(), data.size());
+    while (auto layer = tileData.next_layer()) {
+        while (const auto &feature = layer.next_feature()) {
+            if (feature.geometry_type() != vtzero::GeomType::LINESTRING) {
+                continue;
+            }
+            VectorTileGeometryHandler geometryHandler = VectorTileGeometryHandler(tileCoords, (int) layer.extent(), std::nullopt, conversionHelper, tolerance);
+            decode_geometry(feature.geometry(), geometryHandler);
+            numVertices += geometryHandler.getNumLineVertices();
+            numRemovedVertices += geometryHandler.getNumRemovedLineVertices();
+            for (const auto &line : geometryHandler.getLineCoordinates()) {
+                REQUIRE(line.size() >= 2);
+            }
+        }
+    }
+}
+
+TEST_CASE("VectorTileGeometryHandler simplifies lines") {
+    std::vector<Vec2D> line = {Vec2D(0, 0), Vec2D(1, 0.01), Vec2D(2, 0), Vec2D(3, 1), Vec2D(4, 0)};
+    REQUIRE(simplifyLine(line, 0.1) == 1);
+    REQUIRE(line == std::vector<Vec2D>{Vec2D(0, 0), Vec2D(2, 0), Vec2D(3, 1), Vec2D(4, 0)});
+    REQUIRE(simplifyLine(line, 2.0) == 2);
+    REQUIRE(line == std::vector<Vec2D>{Vec2D(0, 0), Vec2D(4, 0)});
+
+    // vertex counts with the tolerance of 1 pixel at 512 pixels per tile
+    for (const auto filePath : {"tiles/reg.pbf", "tiles/relief.pbf"}) {
+        size_t numVertices = 0;
+        size_t numRemovedVertices = 0;
+        countLineVertices(filePath, 0.0, numVertices, numRemovedVertices);
+        REQUIRE(numRemovedVertices == 0);
+
+        countLineVertices(filePath, 4096.0 / 512.0, numVertices, numRemovedVertices);
+        CHECK(numRemovedVertices < numVertices);
+        WARN(filePath << ": " << numVertices << " line vertices, " << numVertices - numRemovedVertices << " after simplification");
+    }
+}
@@ -0,0 +1,125 @@
+#include "IconLayerBatches.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct TestBatch {
+    int id;
+    std::vector<int> icons;
+};
+
+class TestLayer {
+  public:
+    explicit TestLayer(std::vector<int> iconKeys)
+        : iconKeys(std::move(iconKeys)) {
+        for (const auto key : this->iconKeys) {
+            batches.retain(key);
+        }
+    }
+
+    // Adds the icons to the batches in the order they were added to the layer, like IconLayer::update()
+    void drawFrame() {
+        batches.beginFrame();
+        for (int icon = 0; icon < (int)iconKeys.size(); icon++) {
+            const size_t batchCount = batches.getDrawingOrder().size();
+            const auto &batch = batches.add(iconKeys[icon], [&] { return std::make_shared<TestBatch>(TestBatch{createdBatches++, {}}); });
+            if (batches.getDrawingOrder().size() != batchCount) {
+                batch->icons.clear();
+            }
+            batch->icons.push_back(icon);
+        }
+    }
+
+    std::vector<std::vector<int>> drawnIcons() const {
+        std::vector<std::vector<int>> icons;
+        for (const auto &batch : batches.getDrawingOrder()) {
+            icons.push_back(batch->icons);
+        }
+        return icons;
+    }
+
+    std::vector<int> iconKeys;
+    IconLayerBatches<int, TestBatch> batches;
+    int createdBatches = 0;
+};
+
+} // namespace
+
+TEST_CASE("Icon layer batches share a batch for the consecutive icons of a key") {
+    TestLayer layer({1, 1, 1, 2, 2});
+    layer.drawFrame();
+
+    REQUIRE(layer.createdBatches == 2);
+    REQUIRE(layer.drawnIcons() == std::vector<std::vector<int>>{{0, 1, 2}, {3, 4}});
+    REQUIRE(layer.batches.getBatches().size() == 2);
+}
+
+TEST_CASE("Icon layer batches keep the order the icons were added") {
+    TestLayer layer({1, 2, 1, 1, 2});
+    layer.drawFrame();
+
+    // the texture changes along the added icons split the batches
+    REQUIRE(layer.createdBatches == 4);
+    REQUIRE(layer.drawnIcons() == std::vector<std::vector<int>>{{0}, {1}, {2, 3}, {4}});
+    const auto firstOrder = layer.batches.getDrawingOrder();
+
+    // the batches are reused in the same order in the next frame
+    layer.drawFrame();
+    REQUIRE(layer.createdBatches == 4);
+    REQUIRE(layer.batches.getDrawingOrder() == firstOrder);
+    REQUIRE(layer.drawnIcons() == std::vector<std::vector<int>>{{0}, {1}, {2, 3}, {4}});
+
+    // fewer runs use the first batches of a key, the others are kept for later frames
+    layer.iconKeys = {1, 1, 2};
+    layer.drawFrame();
+    REQUIRE(layer.createdBatches == 4);
+    REQUIRE(layer.drawnIcons() == std::vector<std::vector<int>>{{0, 1}, {2}});
+    REQUIRE(layer.batches.getDrawingOrder()[0] == firstOrder[0]);
+    REQUIRE(layer.batches.getDrawingOrder()[1] == firstOrder[1]);
+    REQUIRE(layer.batches.getBatches().size() == 4);
+}
+
+TEST_CASE("Icon layer batches are released with the last icon of their key") {
+    TestLayer layer({1, 2, 1});
+    layer.drawFrame();
+    REQUIRE(layer.batches.getBatches().size() == 3);
+
+    std::vector<std::shared_ptr<TestBatch>> released;
+    REQUIRE_FALSE(layer.batches.release(1, released));
+    REQUIRE(released.empty());
+    REQUIRE_FALSE(layer.batches.release(3, released));
+
+    // both batches of the key are released and no longer drawn
+    REQUIRE(layer.batches.release(1, released));
+    REQUIRE(released.size() == 2);
+    REQUIRE(released[0]->id == 0);
+    REQUIRE(released[1]->id == 2);
+    REQUIRE(layer.batches.getDrawingOrder().size() == 1);
+    REQUIRE(layer.batches.getBatches().size() == 1);
+
+    layer.batches.clear();
+    REQUIRE(layer.batches.getBatches().empty());
+    REQUIRE(layer.batches.getDrawingOrder().empty());
+}
+
+TEST_CASE("Icon layer batches follow an icon that changes its key") {
+    TestLayer layer({1, 2, 2});
+    layer.drawFrame();
+    REQUIRE(layer.drawnIcons() == std::vector<std::vector<int>>{{0}, {1, 2}});
+
+    // the first icon moves into the region of the others, its old batch is released
+    std::vector<std::shared_ptr<TestBatch>> released;
+    layer.iconKeys[0] = 2;
+    layer.batches.retain(2);
+    REQUIRE(layer.batches.release(1, released));
+    REQUIRE(released.size() == 1);
+
+    layer.drawFrame();
+    REQUIRE(layer.createdBatches == 2);
+    REQUIRE(layer.drawnIcons() == std::vector<std::vector<int>>{{0, 1, 2}});
+    REQUIRE(layer.batches.getBatches().size() == 1);
+}
@@ -0,0 +1,177 @@
+#include "LineArcLengthParameterization.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Moves along the line by walking over the coordinates, as label placement did before the arc-length parameterization
+DistanceIndex walkIndexAtDistance(const std::vector<Vec3D> &coordinates, const DistanceIndex &index, double distance) {
+    const int count = (int)coordinates.size();
+    const auto &s = coordinates[index.index];
+    const auto &e = coordinates[std::min(index.index + 1, count - 1)];
+    double currentX = s.x + (e.x - s.x) * index.percentage;
+    double currentY = s.y + (e.y - s.y) * index.percentage;
+
+    double dist = std::abs(distance);
+    int currentI = index.index;
+    double currentPercentage = index.percentage;
+
+    if (distance >= 0) {
+        for (int i = std::min(index.index + 1, count - 1); i < count; i++) {
+            const double d = std::hypot(coordinates[i].x - currentX, coordinates[i].y - currentY);
+            if (dist > d) {
+                dist -= d;
+                currentX = coordinates[i].x;
+                currentY = coordinates[i].y;
+                currentI = i;
+                currentPercentage = 0;
+            } else {
+                return DistanceIndex(currentI, currentPercentage + dist / d * (1.0 - currentPercentage));
+            }
+        }
+    } else {
+        for (int i = index.index; i >= 0; i--) {
+            const double d = std::hypot(coordinates[i].x - currentX, coordinates[i].y - currentY);
+            if (dist > d) {
+                dist -= d;
+                currentX = coordinates[i].x;
+                currentY = coordinates[i].y;
+                currentI = i;
+                currentPercentage = 0.0;
+            } else if (i == currentI) {
+                return DistanceIndex(i, currentPercentage - currentPercentage * dist / d);
+            } else {
+                return DistanceIndex(i, 1.0 - dist / d);
+            }
+        }
+    }
+    return DistanceIndex(currentI, currentPercentage);
+}
+
+Vec3D pointAtIndex(const std::vector<Vec3D> &coordinates, const DistanceIndex &index) {
+    const auto &s = coordinates[index.index];
+    const auto &e = coordinates[std::min(index.index + 1, (int)coordinates.size() - 1)];
+    return Vec3D(s.x + (e.x - s.x) * index.percentage, s.y + (e.y - s.y) * index.percentage, 0.0);
+}
+
+// Grid of slightly curved streets with a coordinate every 2 units
+std::vector<std::vector<Vec3D>> streetGrid(int numStreets, int numCoordinates) {
+    std::vector<std::vector<Vec3D>> streets;
+    for (int street = 0; street < numStreets; street++) {
+        std::vector<Vec3D> horizontal;
+        std::vector<Vec3D> vertical;
+        for (int i = 0; i < numCoordinates; i++) {
+            const double along = i * 2.0;
+            const double across = street * 100.0 + 5.0 * std::sin(i * 0.05);
+            horizontal.emplace_back(along, across, 0.0);
+            vertical.emplace_back(across, along, 0.0);
+        }
+        streets.push_back(std::move(horizontal));
+        streets.push_back(std::move(vertical));
+    }
+    return streets;
+}
+
+void rotate(const std::vector<Vec3D> &coordinates, double angle, std::vector<Vec3D> &rotated) {
+    const double s = std::sin(angle);
+    const double c = std::cos(angle);
+    rotated.clear();
+    for (const auto &coordinate : coordinates) {
+        rotated.emplace_back(coordinate.x * c - coordinate.y * s, coordinate.x * s + coordinate.y * c, 0.0);
+    }
+}
+
+// Glyph placement as in Tiled2dMapVectorSymbolLabelObject::updatePropertiesLine: for each glyph the points half a
+// glyph before and after, then advance to the next glyph. Returns the sum of the angles to have a result to keep.
+template <typename IndexAtDistance>
+double placeGlyphs(const std::vector<Vec3D> &coordinates, int numGlyphs, double advance, IndexAtDistance indexAtDistance) {
+    auto currentIndex = indexAtDistance(DistanceIndex((int)coordinates.size() / 2, 0.5), -numGlyphs * advance * 0.5);
+    double angles = 0.0;
+    for (int glyph = 0; glyph < numGlyphs; glyph++) {
+        const auto before = pointAtIndex(coordinates, indexAtDistance(currentIndex, -advance * 0.5));
+        const auto after = pointAtIndex(coordinates, indexAtDistance(currentIndex, advance * 0.5));
+        angles += std::atan2(before.y - after.y, after.x - before.x);
+        currentIndex = indexAtDistance(currentIndex, advance);
+    }
+    return angles;
+}
+
+} // namespace
+
+TEST_CASE("LineArcLengthParameterization matches walking along the line") {
+    const std::vector<Vec3D> coordinates = {Vec3D(0, 0, 0), Vec3D(10, 0, 0), Vec3D(10, 0, 0), Vec3D(10, 20, 0), Vec3D(40, 60, 0),
+                                            Vec3D(30, 60, 0)};
+    LineArcLengthParameterization parameterization;
+    parameterization.update(coordinates);
+    REQUIRE(parameterization.length() == Catch::Approx(90.0));
+
+    for (int index = 0; index < (int)coordinates.size() - 1; index++) {
+        for (double percentage : {0.0, 0.25, 0.5, 1.0}) {
+            const DistanceIndex start(index, percentage);
+            for (double distance : {-100.0, -45.0, -12.5, -3.0, 0.5, 7.0, 33.3, 100.0}) {
+                const auto expected = pointAtIndex(coordinates, walkIndexAtDistance(coordinates, start, distance));
+                const auto result = pointAtIndex(coordinates, parameterization.indexAtDistance(start, distance));
+                REQUIRE(result.x == Catch::Approx(expected.x).margin(1e-9));
+                REQUIRE(result.y == Catch::Approx(expected.y).margin(1e-9));
+            }
+        }
+    }
+
+    // past the ends of the line
+    REQUIRE(parameterization.indexAtDistance(DistanceIndex(2, 0.5), 1000.0).index == (int)coordinates.size() - 1);
+    const auto beforeStart = parameterization.indexAtDistance(DistanceIndex(2, 0.5), -1000.0);
+    REQUIRE(beforeStart.index == 0);
+    REQUIRE(beforeStart.percentage == 0.0);
+}
+
+TEST_CASE("LineArcLengthParameterization benchmark") {
+    const auto streets = streetGrid(20, 400);
+    const int numGlyphs = 12;
+    const double advance = 16.0;
+
+    // screen coordinates of the streets while the map rotates in steps of 10 degrees
+    std::vector<std::vector<Vec3D>> frames;
+    for (int rotation = 0; rotation < 36; rotation++) {
+        for (const auto &street : streets) {
+            rotate(street, rotation * M_PI / 18.0, frames.emplace_back());
+        }
+    }
+
+    // the glyph placement is the same with both methods
+    LineArcLengthParameterization parameterization;
+    for (const auto &frame : frames) {
+        parameterization.update(frame);
+        const double walked = placeGlyphs(frame, numGlyphs, advance,
+                                          [&](const DistanceIndex &index, double distance) { return walkIndexAtDistance(frame, index, distance); });
+        const double parameterized = placeGlyphs(frame, numGlyphs, advance, [&](const DistanceIndex &index, double distance) {
+            return parameterization.indexAtDistance(index, distance);
+        });
+        REQUIRE(parameterized == Catch::Approx(walked).margin(1e-6));
+    }
+
+    BENCHMARK("Benchmark rotating street labels, walking along the lines") {
+        double result = 0.0;
+        for (const auto &frame : frames) {
+            result += placeGlyphs(frame, numGlyphs, advance,
+                                  [&](const DistanceIndex &index, double distance) { return walkIndexAtDistance(frame, index, distance); });
+        }
+        return result;
+    };
+
+    // the screen coordinates change every frame in 3d, the parameterization is updated before placing the glyphs
+    BENCHMARK("Benchmark rotating street labels, arc-length parameterization") {
+        double result = 0.0;
+        for (const auto &frame : frames) {
+            parameterization.update(frame);
+            result += placeGlyphs(frame, numGlyphs, advance, [&](const DistanceIndex &index, double distance) {
+                return parameterization.indexAtDistance(index, distance);
+            });
+        }
+        return result;
+    };
+}
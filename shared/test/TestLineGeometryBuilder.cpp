@@ -0,0 +1,197 @@
+#include "CoordinateConversionHelper.h"
+#include "CoordinateSystemFactory.h"
+#include "LineGeometryBuilder.h"
+#include "VectorTileGeometryHandler.h"
+#include "helper/TestData.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+using Lines = std::vector<std::tuple<std::vector<Vec3D>, int>>;
+
+// All lines of a tile relative to the tile center, as they are grouped by Tiled2dMapVectorLineTile
+Lines readTileLines(const char *filePath) {
+    const ::RectCoord tileCoords = {Coord(3857, 1224991.657211, 6287508.342789, 0), Coord(3857, 1849991.657211, 5662508.342789, 0)};
+    const auto conversionHelper = std::make_shared<CoordinateConversionHelper>(CoordinateSystemFactory::getEpsg3857System(), false);
+    const double cx = (tileCoords.topLeft.x + tileCoords.bottomRight.x) / 2.0;
+    const double cy = (tileCoords.topLeft.y + tileCoords.bottomRight.y) / 2.0;
+
+    auto data = TestData::readFileToBuffer(filePath);
+    StringInterner stringTable = ValueKeys::newStringInterner();
+
+    Lines lines;
+    vtzero::vector_tile tileData(data.data(), data.size());
+    while (auto layer = tileData.next_layer()) {
+        while (const auto &feature = layer.next_feature()) {
+            if (feature.geometry_type() != vtzero::GeomType::LINESTRING) {
+                continue;
+            }
+            VectorTileGeometryHandler geometryHandler(tileCoords, (int)layer.extent(), std::nullopt, conversionHelper);
+            decode_geometry(feature.geometry(), geometryHandler);
+            for (const auto &lineCoordinates : geometryHandler.getLineCoordinates()) {
+                std::vector<Vec3D> renderCoords;
+                for (const auto &coordinate : lineCoordinates) {
+                    renderCoords.emplace_back(coordinate.x - cx, coordinate.y - cy, 0.0);
+                }
+                lines.emplace_back(std::move(renderCoords), 0);
+            }
+        }
+    }
+    return lines;
+}
+
+void requirePartsWithinLimit(const std::vector<LineGeometryBuilder::LineGeometryPart> &parts, size_t maxVertexCount) {
+    for (const auto &part : parts) {
+        const size_t numVertices = part.lineAttributes.size() / LineGeometryBuilder::getNumAttributesPerVertex(false);
+        REQUIRE(numVertices <= maxVertexCount);
+        REQUIRE(!part.lineIndices.empty());
+        REQUIRE(*std::max_element(part.lineIndices.begin(), part.lineIndices.end()) < numVertices);
+    }
+}
+
+float fromHalfFloat(uint16_t half) {
+    const float magnitude = (half & 0x7C00) == 0 ? std::ldexp((float)(half & 0x3FF), -24)
+                                                 : std::ldexp((float)((half & 0x3FF) | 0x400), ((half >> 10) & 0x1F) - 25);
+    return (half & 0x8000) ? -magnitude : magnitude;
+}
+
+// Unpacks the packed vertices and compares them with the attributes of buildLineGeometry
+void requirePackedVertices(const std::vector<float> &lineAttributes, const Vec3D &origin, bool is3d) {
+    const auto packed = LineGeometryBuilder::packLineVertices(lineAttributes, origin, is3d);
+    const size_t numAttributes = LineGeometryBuilder::getNumAttributesPerVertex(is3d);
+    const size_t vertexSize = LineGeometryBuilder::getPackedVertexSize(is3d);
+    const size_t dimensions = is3d ? 3 : 2;
+    REQUIRE(packed.vertices.size() == lineAttributes.size() / numAttributes * vertexSize);
+
+    const double packedOrigin[3] = {packed.origin.x, packed.origin.y, packed.origin.z};
+    const double originalOrigin[3] = {origin.x, origin.y, origin.z};
+    for (size_t v = 0; v < lineAttributes.size() / numAttributes; ++v) {
+        const float *attributes = &lineAttributes[v * numAttributes];
+        const uint8_t *vertex = &packed.vertices[v * vertexSize];
+
+        int16_t position[3];
+        std::memcpy(position, vertex, dimensions * sizeof(int16_t));
+        for (size_t d = 0; d < dimensions; ++d) {
+            const double unpacked = packedOrigin[d] + position[d] / 32767.0 * packed.positionScale;
+            REQUIRE(std::abs(unpacked - (originalOrigin[d] + attributes[d])) <= packed.positionScale / 32767.0 + 1e-3);
+        }
+        vertex += is3d ? 8 : 4;
+
+        int8_t extrudeSide[4];
+        std::memcpy(extrudeSide, vertex, 4);
+        for (size_t d = 0; d < dimensions; ++d) {
+            REQUIRE(std::abs(extrudeSide[d] / 127.0 * 2.0 - attributes[dimensions + d]) <= 1.0 / 127.0 + 1e-6);
+        }
+        REQUIRE(std::abs(extrudeSide[3] / 127.0 - attributes[2 * dimensions]) <= 0.5 / 127.0 + 1e-6);
+        vertex += 4;
+
+        float lengthPrefix;
+        std::memcpy(&lengthPrefix, vertex, sizeof(float));
+        REQUIRE(lengthPrefix == attributes[2 * dimensions + 1]);
+        vertex += 4;
+
+        uint16_t correctionStyle[2];
+        std::memcpy(correctionStyle, vertex, 4);
+        const float correction = attributes[2 * dimensions + 2];
+        REQUIRE(std::abs(fromHalfFloat(correctionStyle[0]) - correction) <= std::abs(correction) / 2048.0 + 1e-7);
+        REQUIRE(fromHalfFloat(correctionStyle[1]) == attributes[2 * dimensions + 3]);
+    }
+}
+
+} // namespace
+
+TEST_CASE("LineGeometryBuilder splits lines into parts with 16bit indices") {
+    for (const auto filePath : {"tiles/reg.pbf", "tiles/relief.pbf"}) {
+        const auto lines = readTileLines(filePath);
+        REQUIRE(!lines.empty());
+
+        std::vector<float> lineAttributes;
+        std::vector<uint32_t> lineIndices;
+        LineGeometryBuilder::buildLineGeometry(lines, Vec3D(0, 0, 0), LineCapType::ROUND, LineJoinType::ROUND, false, false, lineAttributes,
+                                               lineIndices);
+        const size_t bytesBefore = lineAttributes.size() * sizeof(float) + lineIndices.size() * sizeof(uint32_t);
+
+        std::vector<LineGeometryBuilder::LineGeometryPart> parts;
+        LineGeometryBuilder::buildLineGeometryParts(lines, Vec3D(0, 0, 0), LineCapType::ROUND, LineJoinType::ROUND, false, false,
+                                                    LineGeometryBuilder::maxShortIndexVertexCount, parts);
+        requirePartsWithinLimit(parts, LineGeometryBuilder::maxShortIndexVertexCount);
+
+        size_t bytesAfter = 0;
+        for (const auto &part : parts) {
+            bytesAfter += part.lineAttributes.size() * sizeof(float) + part.lineIndices.size() * sizeof(uint16_t);
+        }
+        REQUIRE(bytesAfter < bytesBefore);
+        WARN(filePath << ": " << bytesBefore << " bytes of line geometry with 32bit indices, " << bytesAfter << " bytes in " << parts.size()
+                      << " parts with 16bit indices");
+    }
+}
+
+TEST_CASE("LineGeometryBuilder splits single lines exceeding the vertex limit") {
+    // zig-zag line, every point is a sharp round join
+    std::vector<Vec3D> coordinates;
+    for (int i = 0; i < 500; i++) {
+        coordinates.emplace_back(i * 10.0, (i % 2) * 100.0, 0.0);
+    }
+    const Lines lines = {{coordinates, 0}};
+
+    std::vector<LineGeometryBuilder::LineGeometryPart> parts;
+    LineGeometryBuilder::buildLineGeometryParts(lines, Vec3D(0, 0, 0), LineCapType::ROUND, LineJoinType::ROUND, false, false, 500, parts);
+    REQUIRE(parts.size() > 1);
+    requirePartsWithinLimit(parts, 500);
+}
+
+TEST_CASE("LineGeometryBuilder converts to half floats") {
+    REQUIRE(LineGeometryBuilder::toHalfFloat(0.0f) == 0x0000);
+    REQUIRE(LineGeometryBuilder::toHalfFloat(1.0f) == 0x3C00);
+    REQUIRE(LineGeometryBuilder::toHalfFloat(-2.0f) == 0xC000);
+    REQUIRE(LineGeometryBuilder::toHalfFloat(0.1f) == 0x2E66);
+    REQUIRE(LineGeometryBuilder::toHalfFloat(255.0f) == 0x5BF8);
+    REQUIRE(LineGeometryBuilder::toHalfFloat(65504.0f) == 0x7BFF);
+    REQUIRE(LineGeometryBuilder::toHalfFloat(70000.0f) == 0x7C00);
+    // subnormal and rounding into the next exponent
+    REQUIRE(LineGeometryBuilder::toHalfFloat(std::ldexp(1.0f, -24)) == 0x0001);
+    REQUIRE(LineGeometryBuilder::toHalfFloat(std::ldexp(3.0f, -16)) == 0x0300);
+    REQUIRE(LineGeometryBuilder::toHalfFloat(2047.9f) == 0x6800);
+    for (float value = -4.0f; value <= 4.0f; value += 0.01f) {
+        REQUIRE(std::abs(fromHalfFloat(LineGeometryBuilder::toHalfFloat(value)) - value) <= std::abs(value) / 2048.0 + 1e-7);
+    }
+}
+
+TEST_CASE("LineGeometryBuilder packs the line vertices") {
+    for (const auto filePath : {"tiles/reg.pbf", "tiles/relief.pbf"}) {
+        const auto lines = readTileLines(filePath);
+        const Vec3D origin(1537491.657211, 5975008.342789, 0);
+
+        std::vector<float> lineAttributes;
+        std::vector<uint32_t> lineIndices;
+        LineGeometryBuilder::buildLineGeometry(lines, origin, LineCapType::SQUARE, LineJoinType::MITER, false, false, lineAttributes,
+                                               lineIndices);
+        requirePackedVertices(lineAttributes, origin, false);
+
+        const size_t numVertices = lineAttributes.size() / LineGeometryBuilder::getNumAttributesPerVertex(false);
+        const size_t bytesBefore = lineAttributes.size() * sizeof(float);
+        const size_t bytesAfter = numVertices * LineGeometryBuilder::getPackedVertexSize(false);
+        REQUIRE(bytesAfter * 2 == bytesBefore);
+        WARN(filePath << ": " << bytesBefore << " bytes of float line vertices, " << bytesAfter << " bytes packed");
+    }
+
+    // a line on the unit sphere around its origin
+    std::vector<Vec3D> coordinates;
+    const Vec3D origin(0.6, 0.0, 0.8);
+    for (int i = 0; i < 50; i++) {
+        const double angle = 0.001 * i;
+        coordinates.emplace_back(0.6 * std::cos(angle) - origin.x, 0.6 * std::sin(angle) - origin.y, 0.8 * std::cos(angle * 0.5) - origin.z);
+    }
+    std::vector<float> lineAttributes;
+    std::vector<uint32_t> lineIndices;
+    LineGeometryBuilder::buildLineGeometry({{coordinates, 3}}, origin, LineCapType::ROUND, LineJoinType::ROUND, true, false, lineAttributes,
+                                           lineIndices);
+    REQUIRE(!lineAttributes.empty());
+    requirePackedVertices(lineAttributes, origin, true);
+}
@@ -0,0 +1,232 @@
+#include "DataLoaderResult.h"
+#include "LoaderInterface.h"
+#include "TextureLoaderResult.h"
+#include "Tiled2dMapSourceLoadScheduler.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+Tiled2dMapTileInfo makeTile(int x) {
+    return Tiled2dMapTileInfo(RectCoord(Coord(0, 0, 0, 0), Coord(0, 1, 1, 0)), x, 0, 0, 0, 0);
+}
+
+// Keeps all data loads pending until they are resolved by the test, in the order of the requests
+class PendingTestLoader : public LoaderInterface {
+  public:
+    TextureLoaderResult loadTexture(const std::string &url, const std::optional<std::string> &etag) override {
+        assert(false);
+        std::abort();
+    }
+
+    DataLoaderResult loadData(const std::string &url, const std::optional<std::string> &etag) override {
+        assert(false);
+        std::abort();
+    }
+
+    ::djinni::Future<TextureLoaderResult> loadTextureAsync(const std::string &url, const std::optional<std::string> &etag) override {
+        assert(false);
+        std::abort();
+    }
+
+    ::djinni::Future<DataLoaderResult> loadDataAsync(const std::string &url, const std::optional<std::string> &etag) override {
+        auto &promise = pending.emplace_back(url, ::djinni::Promise<DataLoaderResult>());
+        return promise.second.getFuture();
+    }
+
+    void cancel(const std::string &url) override {}
+
+    // Resolves the oldest count loads, loads requested while resolving stay pending
+    size_t resolve(size_t count) {
+        count = std::min(count, pending.size());
+        std::vector<std::pair<std::string, ::djinni::Promise<DataLoaderResult>>> loads;
+        for (size_t i = 0; i < count; ++i) {
+            loads.push_back(std::move(pending[i]));
+        }
+        pending.erase(pending.begin(), pending.begin() + count);
+        for (auto &[url, promise] : loads) {
+            promise.setValue(DataLoaderResult(std::nullopt, std::nullopt, LoaderStatus::OK, std::nullopt));
+        }
+        return count;
+    }
+
+    size_t numPending() const { return pending.size(); }
+
+  private:
+    std::vector<std::pair<std::string, ::djinni::Promise<DataLoaderResult>>> pending;
+};
+
+// Time source of the scheduler that only advances when the test says so
+struct FakeClock {
+    std::chrono::steady_clock::time_point time;
+
+    std::function<std::chrono::steady_clock::time_point()> source() {
+        return [this] { return time; };
+    }
+};
+
+/**
+ * Fake tile server that serves at most `capacity` requests per service time. Further requests wait for the next
+ * rounds, i.e. their latency grows with the number of concurrent requests beyond the capacity.
+ */
+size_t runLoads(Tiled2dMapSourceLoadScheduler::Config config, size_t capacity, size_t numRequests) {
+    FakeClock clock;
+    config.now = clock.source();
+    Tiled2dMapSourceLoadScheduler scheduler(config);
+    PendingTestLoader loader;
+
+    auto clientId = scheduler.registerClient([&](const Tiled2dMapTileInfo &tile, size_t loaderIndex, uint64_t token) {
+        scheduler.loadStarted(token);
+        loader.loadDataAsync(std::to_string(tile.x), std::nullopt).then([&scheduler, token](::djinni::Future<DataLoaderResult> result) {
+            scheduler.loadFinished(token, result.get().status != LoaderStatus::NOOP);
+        });
+    });
+
+    std::vector<Tiled2dMapSourceLoadScheduler::Request> requests;
+    for (size_t i = 0; i < numRequests; ++i) {
+        requests.push_back({makeTile((int)i), 0, (int)i});
+    }
+    scheduler.setRequests(clientId, requests);
+
+    size_t numServed = 0;
+    while (loader.numPending() > 0) {
+        clock.time += std::chrono::milliseconds(2);
+        numServed += loader.resolve(capacity);
+    }
+
+    REQUIRE(numServed == numRequests);
+    REQUIRE(scheduler.getNumPending() == 0);
+    REQUIRE(scheduler.getNumLoading() == 0);
+    return scheduler.getConcurrencyLimit();
+}
+
+} // namespace
+
+TEST_CASE("Load scheduler grants requests by loader index and priority") {
+    Tiled2dMapSourceLoadScheduler::Config config;
+    config.minConcurrentLoads = 1;
+    config.maxConcurrentLoads = 1;
+    config.initialConcurrentLoads = 1;
+    Tiled2dMapSourceLoadScheduler scheduler(config);
+
+    std::vector<std::pair<int, size_t>> granted;
+    uint64_t lastToken = 0;
+    auto clientId = scheduler.registerClient([&](const Tiled2dMapTileInfo &tile, size_t loaderIndex, uint64_t token) {
+        granted.emplace_back(tile.x, loaderIndex);
+        lastToken = token;
+    });
+
+    // the first request is granted immediately, the rest waits for the single slot
+    scheduler.setRequests(clientId, {{makeTile(0), 0, 0}});
+    REQUIRE(granted.size() == 1);
+
+    scheduler.addRequest(clientId, {makeTile(1), 1, 0});
+    scheduler.setRequests(clientId, {{makeTile(2), 0, 5}, {makeTile(3), 0, 3}, {makeTile(4), 0, 4}, {makeTile(5), 0, 6}});
+    // the fallback request for tile 1 is dropped, as it is not part of the new requests
+    REQUIRE(scheduler.getNumPending(clientId) == 4);
+
+    // reprioritize in place
+    scheduler.setRequests(clientId, {{makeTile(2), 0, 5}, {makeTile(3), 0, 3}, {makeTile(4), 0, 4}, {makeTile(5), 0, 1}});
+    scheduler.addRequest(clientId, {makeTile(6), 1, -10});
+
+    while (scheduler.getNumLoading() > 0) {
+        scheduler.loadStarted(lastToken);
+        scheduler.loadFinished(lastToken, false);
+    }
+
+    std::vector<std::pair<int, size_t>> expected = {{0, 0}, {5, 0}, {3, 0}, {4, 0}, {2, 0}, {6, 1}};
+    REQUIRE(granted == expected);
+    REQUIRE(scheduler.getNumPending() == 0);
+}
+
+TEST_CASE("Load scheduler ignores requests for tiles that are already loading") {
+    Tiled2dMapSourceLoadScheduler scheduler;
+    std::vector<uint64_t> tokens;
+    auto clientId =
+        scheduler.registerClient([&](const Tiled2dMapTileInfo &tile, size_t loaderIndex, uint64_t token) { tokens.push_back(token); });
+
+    scheduler.setRequests(clientId, {{makeTile(0), 0, 0}, {makeTile(1), 0, 1}});
+    scheduler.setRequests(clientId, {{makeTile(0), 0, 0}, {makeTile(1), 0, 1}});
+    REQUIRE(tokens.size() == 2);
+    REQUIRE(scheduler.getNumPending() == 0);
+
+    // granted loads that were never started are released with the client
+    scheduler.unregisterClient(clientId);
+    REQUIRE(scheduler.getNumLoading() == 0);
+}
+
+TEST_CASE("Load scheduler frees the slot of cancelled loads") {
+    Tiled2dMapSourceLoadScheduler::Config config;
+    config.minConcurrentLoads = 1;
+    config.maxConcurrentLoads = 1;
+    config.initialConcurrentLoads = 1;
+    FakeClock clock;
+    config.now = clock.source();
+    Tiled2dMapSourceLoadScheduler scheduler(config);
+    PendingTestLoader loader;
+
+    std::vector<std::pair<int, uint64_t>> granted;
+    auto clientId = scheduler.registerClient([&](const Tiled2dMapTileInfo &tile, size_t loaderIndex, uint64_t token) {
+        granted.emplace_back(tile.x, token);
+        scheduler.loadStarted(token);
+        loader.loadDataAsync(std::to_string(tile.x), std::nullopt).then([&scheduler, token](::djinni::Future<DataLoaderResult> result) {
+            scheduler.loadFinished(token, true);
+        });
+    });
+
+    scheduler.setRequests(clientId, {{makeTile(0), 0, 0}, {makeTile(1), 0, 1}});
+    REQUIRE(granted.size() == 1);
+    const auto cancelledToken = granted[0].second;
+
+    // the next request is granted while the cancelled load is still pending at the loader
+    scheduler.loadCancelled(cancelledToken);
+    REQUIRE(granted.size() == 2);
+    REQUIRE(granted[1].first == 1);
+    REQUIRE(scheduler.getNumLoading() == 1);
+    REQUIRE(loader.numPending() == 2);
+
+    // the cancelled tile may be requested again, it replaces the cancelled load
+    scheduler.addRequest(clientId, {makeTile(0), 0, 0});
+    REQUIRE(scheduler.getNumPending(clientId) == 1);
+
+    // the late result of the cancelled load neither frees a slot nor counts as a latency sample
+    clock.time += std::chrono::seconds(10);
+    loader.resolve(1);
+    REQUIRE(granted.size() == 2);
+    REQUIRE(scheduler.getNumLoading() == 1);
+
+    loader.resolve(1);
+    REQUIRE(granted.size() == 3);
+    REQUIRE(granted[2].first == 0);
+    REQUIRE(granted[2].second != cancelledToken);
+    loader.resolve(1);
+    REQUIRE(scheduler.getNumLoading() == 0);
+    REQUIRE(scheduler.getNumPending() == 0);
+}
+
+TEST_CASE("Load scheduler increases concurrency while the latency is stable") {
+    Tiled2dMapSourceLoadScheduler::Config config;
+    const size_t initialLimit = config.initialConcurrentLoads;
+
+    const size_t limit = runLoads(config, 64, 2000);
+    REQUIRE(limit > initialLimit * 2);
+}
+
+TEST_CASE("Load scheduler reduces concurrency when the server is saturated") {
+    Tiled2dMapSourceLoadScheduler::Config config;
+    config.initialConcurrentLoads = 64;
+
+    // the server handles 8 requests at a time, the latency of 64 concurrent requests is 8 times the service time
+    const size_t limit = runLoads(config, 8, 800);
+    REQUIRE(limit < 40);
+}
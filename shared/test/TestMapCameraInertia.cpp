@@ -0,0 +1,56 @@
+#include "MapCameraInertia.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <cstdint>
+
+namespace {
+
+constexpr int64_t frameMicros = 16000;
+
+// Distance covered by stepping the inertia frame by frame as the cameras do, as a multiple of the velocity
+double simulatedDistance(const MapCameraInertia &inertia, int64_t startMicros, double decay) {
+    double distance = 0.0;
+    for (int64_t now = startMicros + frameMicros;; now += frameMicros) {
+        const double delta = (now - inertia.timestampStart) / 16000.0;
+        if (delta >= inertia.t1 + inertia.t2) {
+            break;
+        }
+        double factor = std::pow(decay, delta);
+        if (delta > inertia.t1) {
+            factor *= std::pow(0.6, delta - inertia.t1);
+        }
+        distance += factor;
+    }
+    return distance;
+}
+
+} // namespace
+
+TEST_CASE("Remaining inertia distance matches the stepped inertia") {
+    // a fling of the 2D camera (see MapCamera2d::setupInertia)
+    const double velocity = 20.0;
+    const MapCameraInertia inertia2d(0, Vec2F(velocity, 0), -19.4957 * std::log(1.0 / velocity), -1.95762 * std::log(0.01));
+    // and one of the 3D camera (see MapCamera3d::setupInertia)
+    const MapCameraInertia inertia3d(0, Vec2F(0.01, 0), 30.0, 200.0);
+
+    for (const auto &[inertia, decay] : {std::make_pair(inertia2d, 0.95), std::make_pair(inertia3d, 0.9)}) {
+        for (const int64_t frame : {0, 5, 20, 40}) {
+            const int64_t now = frame * frameMicros;
+            const double predicted = inertia.remainingDistanceFactor(now, decay);
+            const double stepped = simulatedDistance(inertia, now, decay);
+            // the frames are summed up, the prediction integrates continuously, they differ by less than one frame
+            REQUIRE(predicted > 0.0);
+            REQUIRE(predicted == Catch::Approx(stepped).margin(1.0));
+        }
+    }
+
+    // the remaining distance shrinks over time and is gone once the inertia ends
+    const int64_t end = (int64_t)std::ceil((inertia2d.t1 + inertia2d.t2) * frameMicros);
+    REQUIRE(inertia2d.remainingDistanceFactor(0, 0.95) > inertia2d.remainingDistanceFactor(10 * frameMicros, 0.95));
+    REQUIRE(inertia2d.remainingDistanceFactor(end, 0.95) == 0.0);
+    // timestamps before the start of the inertia count from its start
+    REQUIRE(inertia2d.remainingDistanceFactor(-frameMicros, 0.95) == inertia2d.remainingDistanceFactor(0, 0.95));
+}
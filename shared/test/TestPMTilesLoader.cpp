@@ -0,0 +1,188 @@
+#include "DataLoaderResult.h"
+#include "PMTilesArchive.h"
+#include "PMTilesLoader.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct ArchiveEntry {
+    uint64_t tileId;
+    uint64_t offset;
+    uint32_t length;
+    uint32_t runLength;
+};
+
+void writeVarint(std::vector<uint8_t> &out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+void writeUInt64(std::vector<uint8_t> &out, size_t pos, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out[pos + i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+std::vector<uint8_t> encodeDirectory(const std::vector<ArchiveEntry> &entries) {
+    std::vector<uint8_t> out;
+    writeVarint(out, entries.size());
+    uint64_t lastId = 0;
+    for (const auto &entry : entries) {
+        writeVarint(out, entry.tileId - lastId);
+        lastId = entry.tileId;
+    }
+    for (const auto &entry : entries) {
+        writeVarint(out, entry.runLength);
+    }
+    for (const auto &entry : entries) {
+        writeVarint(out, entry.length);
+    }
+    for (const auto &entry : entries) {
+        writeVarint(out, entry.offset + 1);
+    }
+    return out;
+}
+
+// Uncompressed archive with tile 0/0/0 in the root directory and the tiles of zoom level 1 in a leaf directory,
+// tiles 1/1/1 and 1/1/0 share their data. modify can change the bytes of the archive before it is written.
+std::string writeTestArchive(const std::function<void(std::vector<uint8_t> &)> &modify = nullptr) {
+    const std::vector<std::string> tiles = {"z0", "z1-a", "z1-b", "z1-c"};
+    std::vector<uint8_t> tileData;
+    std::vector<uint64_t> tileOffsets;
+    for (const auto &tile : tiles) {
+        tileOffsets.push_back(tileData.size());
+        tileData.insert(tileData.end(), tile.begin(), tile.end());
+    }
+
+    const auto leaf = encodeDirectory({
+        {1, tileOffsets[1], 4, 1},
+        {2, tileOffsets[2], 4, 1},
+        {3, tileOffsets[3], 4, 2},
+    });
+    const auto root = encodeDirectory({
+        {0, tileOffsets[0], 2, 1},
+        {1, 0, (uint32_t)leaf.size(), 0},
+    });
+
+    std::vector<uint8_t> archive(PMTilesArchive::headerSize, 0);
+    std::copy_n("PMTiles", 7, archive.begin());
+    archive[7] = 3;
+    const uint64_t rootOffset = archive.size();
+    const uint64_t leafOffset = rootOffset + root.size();
+    const uint64_t tileDataOffset = leafOffset + leaf.size();
+    writeUInt64(archive, 8, rootOffset);
+    writeUInt64(archive, 16, root.size());
+    writeUInt64(archive, 24, tileDataOffset);
+    writeUInt64(archive, 32, 0);
+    writeUInt64(archive, 40, leafOffset);
+    writeUInt64(archive, 48, leaf.size());
+    writeUInt64(archive, 56, tileDataOffset);
+    writeUInt64(archive, 64, tileData.size());
+    archive[97] = (uint8_t)PMTilesArchive::Compression::NONE;
+    archive[98] = (uint8_t)PMTilesArchive::Compression::NONE;
+    archive[99] = (uint8_t)PMTilesArchive::TileType::MVT;
+    archive[100] = 0;
+    archive[101] = 1;
+    archive.insert(archive.end(), root.begin(), root.end());
+    archive.insert(archive.end(), leaf.begin(), leaf.end());
+    archive.insert(archive.end(), tileData.begin(), tileData.end());
+    if (modify) {
+        modify(archive);
+    }
+
+    const auto path = (std::filesystem::temp_directory_path() / "mapscore_test.pmtiles").string();
+    std::ofstream file(path, std::ios::binary);
+    file.write((const char *)archive.data(), archive.size());
+    return path;
+}
+
+std::string toString(const DataLoaderResult &result) {
+    REQUIRE(result.data.has_value());
+    return std::string((const char *)result.data->buf(), result.data->len());
+}
+
+} // namespace
+
+TEST_CASE("PMTiles tile ids") {
+    REQUIRE(PMTilesArchive::zxyToTileId(0, 0, 0) == 0);
+    REQUIRE(PMTilesArchive::zxyToTileId(1, 0, 0) == 1);
+    REQUIRE(PMTilesArchive::zxyToTileId(1, 0, 1) == 2);
+    REQUIRE(PMTilesArchive::zxyToTileId(1, 1, 1) == 3);
+    REQUIRE(PMTilesArchive::zxyToTileId(1, 1, 0) == 4);
+    REQUIRE(PMTilesArchive::zxyToTileId(2, 0, 0) == 5);
+    REQUIRE(PMTilesArchive::zxyToTileId(3, 0, 0) == 21);
+}
+
+TEST_CASE("PMTilesLoader") {
+    const auto path = writeTestArchive();
+    PMTilesLoader loader;
+    const auto url = [&](const std::string &zxy) { return "pmtiles://" + path + "/" + zxy; };
+
+    SECTION("tile in root directory") {
+        auto result = loader.loadData(url("0/0/0.pbf"), std::nullopt);
+        REQUIRE(result.status == LoaderStatus::OK);
+        REQUIRE(toString(result) == "z0");
+    }
+
+    SECTION("tiles in leaf directory") {
+        REQUIRE(toString(loader.loadData(url("1/0/0"), std::nullopt)) == "z1-a");
+        REQUIRE(toString(loader.loadData(url("1/0/1"), std::nullopt)) == "z1-b");
+        REQUIRE(toString(loader.loadData(url("1/1/1"), std::nullopt)) == "z1-c");
+        // run length of 2
+        REQUIRE(toString(loader.loadDataAsync(url("1/1/0"), std::nullopt).get()) == "z1-c");
+    }
+
+    SECTION("missing tiles") {
+        REQUIRE(loader.loadData(url("2/0/0"), std::nullopt).status == LoaderStatus::ERROR_404);
+        REQUIRE(loader.loadData(url("1/2/0"), std::nullopt).status == LoaderStatus::ERROR_404);
+    }
+
+    SECTION("other urls") {
+        REQUIRE(loader.loadData("https://example.com/0/0/0.pbf", std::nullopt).status == LoaderStatus::NOOP);
+        REQUIRE(loader.loadData("pmtiles://" + path, std::nullopt).status == LoaderStatus::NOOP);
+    }
+
+    SECTION("invalid archive") {
+        REQUIRE(loader.loadData("pmtiles:///does/not/exist.pmtiles/0/0/0", std::nullopt).status == LoaderStatus::ERROR_OTHER);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("PMTiles archive rejects offsets outside of the file") {
+    // the leaf directory offset plus its length wraps around
+    const auto wrappingPath = writeTestArchive([](std::vector<uint8_t> &archive) {
+        writeUInt64(archive, 40, std::numeric_limits<uint64_t>::max() - 2);
+    });
+    REQUIRE(PMTilesArchive::open(wrappingPath) == nullptr);
+    std::filesystem::remove(wrappingPath);
+
+    // the tile data section starts at the last byte, the tiles do not fit after it
+    const auto truncatedPath = writeTestArchive([](std::vector<uint8_t> &archive) {
+        writeUInt64(archive, 56, archive.size() - 1);
+        writeUInt64(archive, 64, 1);
+    });
+    auto archive = PMTilesArchive::open(truncatedPath);
+    REQUIRE(archive != nullptr);
+    REQUIRE_FALSE(archive->getTile(0, 0, 0).has_value());
+    REQUIRE_FALSE(archive->getTile(1, 0, 0).has_value());
+    archive = nullptr;
+    std::filesystem::remove(truncatedPath);
+}
+
+TEST_CASE("PMTiles decompression is limited") {
+    const std::vector<uint8_t> data(16, 1);
+    REQUIRE(PMTilesArchive::decompress(data.data(), data.size(), PMTilesArchive::Compression::NONE, 16)->size() == 16);
+    REQUIRE_FALSE(PMTilesArchive::decompress(data.data(), data.size(), PMTilesArchive::Compression::NONE, 15).has_value());
+}
@@ -0,0 +1,96 @@
+#include "CoordinateConversionHelper.h"
+#include "CoordinateSystemFactory.h"
+#include "Tiled2dMapVectorPackedTile.h"
+#include "VectorTileGeometryHandler.h"
+#include "helper/TestData.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+namespace {
+
+const ::RectCoord tileCoords = {Coord(3857, 1224991.657211, 6287508.342789, 0), Coord(3857, 1849991.657211, 5662508.342789, 0)};
+
+// Decodes and triangulates a tile like Tiled2dMapVectorSource::postLoadingTask
+Tiled2dMapVectorTileInfo::FeatureMap decodeTile(const std::vector<char> &data, StringInterner &stringTable,
+                                                const std::shared_ptr<CoordinateConversionHelperInterface> &conversionHelper) {
+    auto featureMap = std::make_shared<std::unordered_map<std::string, std::shared_ptr<std::vector<Tiled2dMapVectorTileInfo::FeatureTuple>>>>();
+    vtzero::vector_tile tileData(data.data(), data.size());
+    mapbox::detail::Earcut<uint16_t> earcutter;
+    while (auto layer = tileData.next_layer()) {
+        auto features = std::make_shared<std::vector<Tiled2dMapVectorTileInfo::FeatureTuple>>();
+        while (const auto &feature = layer.next_feature()) {
+            auto const featureContext = std::make_shared<FeatureContext>(stringTable, feature);
+            auto geometryHandler = std::make_shared<VectorTileGeometryHandler>(tileCoords, (int)layer.extent(), std::nullopt, conversionHelper);
+            decode_geometry(feature.geometry(), *geometryHandler);
+            size_t polygonCount = geometryHandler->beginTriangulatePolygons();
+            for (size_t i = 0; i < polygonCount; i++) {
+                geometryHandler->triangulatePolygons(i, earcutter);
+            }
+            geometryHandler->endTringulatePolygons();
+            features->push_back({featureContext, geometryHandler});
+        }
+        featureMap->emplace(std::string(layer.name()), features);
+    }
+    return featureMap;
+}
+
+void requireEqual(const Tiled2dMapVectorTileInfo::FeatureMap &expected, const Tiled2dMapVectorTileInfo::FeatureMap &actual) {
+    REQUIRE(actual->size() == expected->size());
+    for (const auto &[layerName, expectedFeatures] : *expected) {
+        const auto &features = actual->at(layerName);
+        REQUIRE(features->size() == expectedFeatures->size());
+        for (size_t i = 0; i < features->size(); i++) {
+            const auto &[expectedContext, expectedGeometry] = (*expectedFeatures)[i];
+            const auto &[context, geometry] = (*features)[i];
+            REQUIRE(context->geomType == expectedContext->geomType);
+            REQUIRE(context->identifier == expectedContext->identifier);
+            REQUIRE(context->hasCustomId == expectedContext->hasCustomId);
+            REQUIRE(context->propertiesMap == expectedContext->propertiesMap);
+            REQUIRE(geometry->getPointCoordinates() == expectedGeometry->getPointCoordinates());
+            REQUIRE(geometry->getPolygons().size() == expectedGeometry->getPolygons().size());
+            for (size_t j = 0; j < geometry->getPolygons().size(); j++) {
+                REQUIRE(geometry->getPolygons()[j].coordinates == expectedGeometry->getPolygons()[j].coordinates);
+                REQUIRE(geometry->getPolygons()[j].indices == expectedGeometry->getPolygons()[j].indices);
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("Tiled2dMapVectorPackedTile restores decoded tiles") {
+    const auto conversionHelper = std::make_shared<CoordinateConversionHelper>(CoordinateSystemFactory::getEpsg3857System(), false);
+
+    for (const auto filePath : {"tiles/reg.pbf", "tiles/relief.pbf"}) {
+        auto data = TestData::readFileToBuffer(filePath);
+        StringInterner stringTable = ValueKeys::newStringInterner();
+        auto featureMap = decodeTile(data, stringTable, conversionHelper);
+        auto packed = Tiled2dMapVectorPackedTile::pack(featureMap, stringTable);
+
+        // same interner, keys are mapped to the existing interned strings
+        auto unpacked = Tiled2dMapVectorPackedTile::unpack(packed.data(), packed.size(), tileCoords, stringTable, conversionHelper);
+        REQUIRE(unpacked);
+        requireEqual(featureMap, unpacked);
+
+        // truncated data and other versions are rejected
+        REQUIRE(!Tiled2dMapVectorPackedTile::unpack(packed.data(), packed.size() / 2, tileCoords, stringTable, conversionHelper));
+        auto otherVersion = packed;
+        otherVersion[4]++;
+        REQUIRE(!Tiled2dMapVectorPackedTile::unpack(otherVersion.data(), otherVersion.size(), tileCoords, stringTable, conversionHelper));
+    }
+}
+
+TEST_CASE("Tiled2dMapVectorPackedTile benchmark") {
+    const auto conversionHelper = std::make_shared<CoordinateConversionHelper>(CoordinateSystemFactory::getEpsg3857System(), false);
+    auto data = TestData::readFileToBuffer("tiles/relief.pbf");
+    StringInterner stringTable = ValueKeys::newStringInterner();
+    auto packed = Tiled2dMapVectorPackedTile::pack(decodeTile(data, stringTable, conversionHelper), stringTable);
+
+    BENCHMARK("Benchmark relief decode") { return decodeTile(data, stringTable, conversionHelper); };
+    BENCHMARK("Benchmark relief unpack") {
+        return Tiled2dMapVectorPackedTile::unpack(packed.data(), packed.size(), tileCoords, stringTable, conversionHelper);
+    };
+}
@@ -0,0 +1,320 @@
+#include "Font.h"
+#include "SdfFontLoader.h"
+#include "SdfGlyphAtlas.h"
+#include "Tiled2dMapVectorSymbolFontProviderManager.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+std::string encodeUtf8(uint32_t codepoint) {
+    std::string result;
+    if (codepoint < 0x80) {
+        result += (char)codepoint;
+    } else if (codepoint < 0x800) {
+        result += (char)(0xC0 | (codepoint >> 6));
+        result += (char)(0x80 | (codepoint & 0x3F));
+    } else {
+        result += (char)(0xE0 | (codepoint >> 12));
+        result += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        result += (char)(0x80 | (codepoint & 0x3F));
+    }
+    return result;
+}
+
+// Draws an anti-aliased disc per character, ideographs are larger than latin letters, spaces have no bitmap
+class TestRasterizer : public GlyphRasterizerInterface {
+  public:
+    std::optional<RasterizedGlyph> rasterize(const std::string &charCode, double fontSize) override {
+        numCalls++;
+        if (charCode == "\xE2\x96\xA1") { // U+25A1, not in the font
+            return std::nullopt;
+        }
+        RasterizedGlyph glyph;
+        glyph.advance = fontSize * (charCode.size() > 1 ? 1.0 : 0.6);
+        if (charCode == " ") {
+            return glyph;
+        }
+        const int32_t size = (int32_t)std::round(fontSize * (charCode.size() > 1 ? 0.9 : 0.5));
+        glyph.width = size;
+        glyph.height = size;
+        glyph.bearingX = 1.0;
+        glyph.bearingY = size;
+        glyph.coverage.resize(size * size);
+        const double radius = size / 2.0;
+        for (int32_t y = 0; y < size; y++) {
+            for (int32_t x = 0; x < size; x++) {
+                const double distance = std::hypot(x + 0.5 - radius, y + 0.5 - radius);
+                glyph.coverage[y * size + x] = (uint8_t)std::lround(std::clamp(radius - distance + 0.5, 0.0, 1.0) * 255.0);
+            }
+        }
+        return glyph;
+    }
+
+    std::atomic<int> numCalls = 0;
+};
+
+class TestTextureHolder : public TextureHolderInterface {
+  public:
+    TestTextureHolder(int32_t width, int32_t height, std::vector<uint8_t> distances)
+        : width(width), height(height), distances(std::move(distances)) {}
+
+    int32_t getImageWidth() override { return width; }
+    int32_t getImageHeight() override { return height; }
+    int32_t getTextureWidth() override { return width; }
+    int32_t getTextureHeight() override { return height; }
+    int32_t attachToGraphics() override { return 0; }
+    void clearFromGraphics() override {}
+
+    const int32_t width;
+    const int32_t height;
+    const std::vector<uint8_t> distances;
+};
+
+std::shared_ptr<SdfFontLoader> createFontLoader() {
+    auto fontLoader = std::make_shared<SdfFontLoader>([](int32_t width, int32_t height, std::vector<uint8_t> distances) {
+        return std::make_shared<TestTextureHolder>(width, height, std::move(distances));
+    });
+    fontLoader->addFont("Test Regular", std::make_shared<TestRasterizer>());
+    return fontLoader;
+}
+
+// Street labels of a city with latin and CJK names
+std::vector<std::vector<std::string>> labelSet() {
+    std::vector<std::vector<std::string>> labels;
+    for (uint32_t label = 0; label < 300; label++) {
+        std::vector<std::string> letters;
+        for (uint32_t i = 0; i < 8; i++) {
+            const uint32_t codepoint = label % 3 == 0 ? 'a' + (label * 7 + i * 3) % 26 : 0x4E00 + (label * 13 + i * 101) % 1500;
+            letters.push_back(encodeUtf8(codepoint));
+        }
+        labels.push_back(letters);
+    }
+    return labels;
+}
+
+} // namespace
+
+TEST_CASE("Signed distance field of a coverage bitmap") {
+    // filled square of 8x8 pixels
+    const std::vector<uint8_t> coverage(64, 255);
+    const int32_t buffer = 4;
+    const double distanceRange = 8.0;
+    const auto sdf = SdfGlyphAtlas::generateSdf(coverage, 8, 8, buffer, distanceRange);
+    REQUIRE(sdf.size() == 16 * 16);
+
+    const auto value = [&](int32_t x, int32_t y) { return sdf[y * 16 + x] / 255.0; };
+    // center is 4 pixels inside, the corners of the padding beyond the range outside
+    REQUIRE(value(8, 8) > 0.9);
+    REQUIRE(value(0, 0) == 0.0);
+    // the outline between the outermost covered and the first uncovered pixel
+    REQUIRE(std::abs((value(4, 8) + value(3, 8)) / 2.0 - 0.5) < 0.1);
+    // one pixel further away changes the value by 1 / distanceRange
+    REQUIRE(std::abs(value(2, 8) - (value(3, 8) - 1.0 / distanceRange)) < 0.01);
+    REQUIRE(value(4, 8) > 0.5);
+    REQUIRE(value(3, 8) < 0.5);
+}
+
+TEST_CASE("SdfGlyphAtlas adds glyphs on demand") {
+    auto rasterizer = std::make_shared<TestRasterizer>();
+    SdfGlyphAtlas::Config config;
+    config.fontName = "Test Regular";
+    config.fontSize = 32.0;
+    config.width = 128;
+    config.initialHeight = 32;
+    config.maxHeight = 256;
+    SdfGlyphAtlas atlas(rasterizer, config);
+
+    REQUIRE(atlas.prepareGlyphs({"a", "b", "a", " ", "\xE4\xB8\xAD"}));
+    REQUIRE(rasterizer->numCalls == 4);
+    REQUIRE(atlas.prepareGlyphs({"b", "a"}));
+    REQUIRE(rasterizer->numCalls == 4);
+
+    // missing glyphs are not rasterized again
+    REQUIRE_FALSE(atlas.getGlyph("\xE2\x96\xA1").has_value());
+    REQUIRE_FALSE(atlas.getGlyph("\xE2\x96\xA1").has_value());
+    REQUIRE(rasterizer->numCalls == 5);
+
+    const auto a = atlas.getGlyph("a");
+    REQUIRE(a.has_value());
+    REQUIRE(a->width == 16 + 2 * config.buffer);
+    REQUIRE(a->bearingX == 1.0 - config.buffer);
+    REQUIRE(atlas.getGlyph(" ")->width == 0);
+
+    const auto fontData = atlas.createFontData();
+    REQUIRE(fontData.glyphs.size() == 4);
+    REQUIRE(fontData.glyphs[0].charCode == "a");
+    REQUIRE(fontData.info.size == config.fontSize);
+    REQUIRE(fontData.glyphs[0].advance.x == 0.6);
+    REQUIRE(fontData.glyphs[0].boundingBoxSize.x == a->width / config.fontSize);
+    REQUIRE(fontData.glyphs[0].uv.topLeft.x == a->x / 128.0);
+    REQUIRE(fontData.glyphs[0].uv.bottomRight.y == a->y / fontData.info.bitmapSize.y);
+
+    // the atlas grows to fit more glyphs, until the maximal height
+    std::vector<std::string> ideographs;
+    for (uint32_t codepoint = 0x4E00; codepoint < 0x4E00 + 40; codepoint++) {
+        ideographs.push_back(encodeUtf8(codepoint));
+    }
+    const auto versionBefore = atlas.getVersion();
+    REQUIRE_FALSE(atlas.prepareGlyphs(ideographs));
+    REQUIRE(atlas.getVersion() > versionBefore);
+    const auto stats = atlas.getStatistics();
+    REQUIRE(stats.height == 256);
+    REQUIRE(stats.sizeBytes == 128 * 256);
+    REQUIRE(stats.numGlyphs > 10);
+    REQUIRE(stats.numGlyphs < 44);
+    REQUIRE(stats.numMissingGlyphs == 1);
+    REQUIRE(stats.occupancy > 0.5);
+    REQUIRE(stats.occupancy <= 1.0);
+
+    // glyphs added before the atlas grew keep their pixels
+    const auto image = atlas.getImage();
+    REQUIRE(image.pixels.size() == 128 * 256);
+    REQUIRE(image.pixels[(a->y + a->height / 2) * 128 + a->x + a->width / 2] > 200);
+}
+
+TEST_CASE("SdfGlyphAtlas is filled concurrently") {
+    auto rasterizer = std::make_shared<TestRasterizer>();
+    SdfGlyphAtlas::Config config;
+    config.width = 1024;
+    SdfGlyphAtlas atlas(rasterizer, config);
+
+    const auto labels = labelSet();
+    std::vector<std::thread> threads;
+    for (size_t thread = 0; thread < 4; thread++) {
+        threads.emplace_back([&, thread] {
+            for (size_t label = thread; label < labels.size(); label += 4) {
+                atlas.prepareGlyphs(labels[label]);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::unordered_set<std::string> uniqueLetters;
+    for (const auto &label : labels) {
+        uniqueLetters.insert(label.begin(), label.end());
+    }
+    const auto fontData = atlas.createFontData();
+    REQUIRE(fontData.glyphs.size() == uniqueLetters.size());
+    REQUIRE(atlas.getStatistics().rasterizedGlyphs == (int64_t)uniqueLetters.size());
+}
+
+TEST_CASE("SdfFontLoader renders the glyphs of labels on demand") {
+    auto fontLoader = createFontLoader();
+
+    REQUIRE(fontLoader->loadFont(Font("Unknown")).status == LoaderStatus::ERROR_404);
+    REQUIRE_FALSE(fontLoader->prepareGlyphs("Unknown", "abc").has_value());
+
+    // initially the printable ASCII characters
+    const auto ascii = fontLoader->loadFont(Font("Test Regular"));
+    REQUIRE(ascii.status == LoaderStatus::OK);
+    REQUIRE(ascii.fontData->glyphs.size() == 95);
+    REQUIRE(ascii.fontData->info.name == "Test Regular");
+    const auto texture = std::dynamic_pointer_cast<TestTextureHolder>(ascii.imageData);
+    REQUIRE(texture);
+    REQUIRE(texture->width == ascii.fontData->info.bitmapSize.x);
+    REQUIRE(texture->height == ascii.fontData->info.bitmapSize.y);
+    REQUIRE(texture->distances.size() == (size_t)texture->width * texture->height);
+
+    const auto version = fontLoader->prepareGlyphs("Test Regular", "Main Street");
+    REQUIRE(version.has_value());
+    const auto ideographVersion = fontLoader->prepareGlyphs("Test Regular", "\xE4\xB8\xAD\xE5\xB1\xB1 Road");
+    REQUIRE(ideographVersion > version);
+    REQUIRE(fontLoader->prepareGlyphs("Test Regular", "\xE4\xB8\xAD Road") == ideographVersion);
+
+    const auto result = fontLoader->loadFont(Font("Test Regular"));
+    REQUIRE(result.fontData->glyphs.size() == 97);
+    REQUIRE(result.fontData->glyphs.back().charCode == "\xE5\xB1\xB1");
+    REQUIRE(result.imageData != ascii.imageData);
+
+    const auto statistics = fontLoader->getStatistics();
+    REQUIRE(statistics.size() == 1);
+    REQUIRE(statistics[0].fontName == "Test Regular");
+    REQUIRE(statistics[0].numGlyphs == 97);
+    REQUIRE(statistics[0].sizeBytes == (size_t)statistics[0].width * statistics[0].height);
+}
+
+TEST_CASE("Vector layer fonts are loaded again when glyphs were added") {
+    Tiled2dMapVectorSymbolFontProviderManager fontProvider(createFontLoader());
+
+    const auto first = fontProvider.loadFont("Test Regular", "Main Street");
+    REQUIRE(first->status == LoaderStatus::OK);
+    REQUIRE(fontProvider.loadFont("Test Regular", "Station Road") == first);
+
+    const auto ideographs = fontProvider.loadFont("Test Regular", "\xE4\xB8\xAD\xE5\xB1\xB1");
+    REQUIRE(ideographs != first);
+    REQUIRE(ideographs->fontData->glyphs.size() == first->fontData->glyphs.size() + 2);
+    REQUIRE(fontProvider.loadFont("Test Regular", "\xE4\xB8\xAD Road") == ideographs);
+
+    // labels laid out with the first font keep their glyphs
+    REQUIRE(first->fontData->glyphs.size() == 95);
+
+    REQUIRE(fontProvider.loadFont("Unknown", "Main Street")->status == LoaderStatus::ERROR_404);
+}
+
+TEST_CASE("SdfGlyphAtlas benchmark") {
+    const auto labels = labelSet();
+    SdfGlyphAtlas::Config config;
+    config.width = 1024;
+
+    // first render of the label set with an empty atlas, as after a map start in a new region
+    BENCHMARK("Benchmark first render of 300 labels, one thread") {
+        SdfGlyphAtlas atlas(std::make_shared<TestRasterizer>(), config);
+        for (const auto &label : labels) {
+            atlas.prepareGlyphs(label);
+        }
+        return atlas.getStatistics().numGlyphs;
+    };
+    BENCHMARK("Benchmark first render of 300 labels, four threads") {
+        SdfGlyphAtlas atlas(std::make_shared<TestRasterizer>(), config);
+        std::vector<std::thread> threads;
+        for (size_t thread = 0; thread < 4; thread++) {
+            threads.emplace_back([&, thread] {
+                for (size_t label = thread; label < labels.size(); label += 4) {
+                    atlas.prepareGlyphs(labels[label]);
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        return atlas.getStatistics().numGlyphs;
+    };
+
+    // including the font snapshots of the vector layers, a new one whenever a label added glyphs
+    BENCHMARK("Benchmark first render of 300 labels, vector layer fonts") {
+        Tiled2dMapVectorSymbolFontProviderManager fontProvider(createFontLoader());
+        std::unordered_set<std::shared_ptr<FontLoaderResult>> fonts;
+        for (const auto &label : labels) {
+            std::string text;
+            for (const auto &letter : label) {
+                text += letter;
+            }
+            fonts.insert(fontProvider.loadFont("Test Regular", text));
+        }
+        return fonts.size();
+    };
+
+    SdfGlyphAtlas atlas(std::make_shared<TestRasterizer>(), config);
+    for (const auto &label : labels) {
+        atlas.prepareGlyphs(label);
+    }
+    BENCHMARK("Benchmark render of 300 labels, glyphs in the atlas") {
+        bool allFit = true;
+        for (const auto &label : labels) {
+            allFit &= atlas.prepareGlyphs(label);
+        }
+        return allFit;
+    };
+}
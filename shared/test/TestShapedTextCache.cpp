@@ -0,0 +1,143 @@
+#include "TextHelper.h"
+#include "Tiled2dMapVectorShapedTextCache.h"
+#include "helper/TestData.h"
+
+#include "vtzero/vector_tile.hpp"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+// Names of all features of a tile, one label per feature as in a symbol layer with text-field {name}
+std::vector<std::string> labelTexts(const std::vector<char> &data) {
+    std::vector<std::string> texts;
+    vtzero::vector_tile tile(data.data(), data.size());
+    while (auto layer = tile.next_layer()) {
+        while (auto feature = layer.next_feature()) {
+            while (auto property = feature.next_property()) {
+                if (property.key() == "name" && property.value().type() == vtzero::property_value_type::string_value) {
+                    texts.emplace_back(std::string(property.value().string_value()));
+                }
+            }
+        }
+    }
+    return texts;
+}
+
+// Font with a glyph for every letter of the texts
+std::shared_ptr<FontLoaderResult> createFont(const std::vector<std::string> &texts) {
+    std::unordered_set<std::string> letters = {" "};
+    for (const auto &text : texts) {
+        for (const auto &letter : TextHelper::splitWstring(text)) {
+            letters.insert(letter);
+        }
+    }
+    std::vector<FontGlyph> glyphs;
+    for (const auto &letter : letters) {
+        const double x = (double)glyphs.size() / letters.size();
+        glyphs.emplace_back(letter, Vec2D(0.5, 0.0), Vec2D(0.5, 0.8), Vec2D(0.0, 0.7),
+                            Quad2dD(Vec2D(x, 0.1), Vec2D(x + 0.01, 0.1), Vec2D(x + 0.01, 0.0), Vec2D(x, 0.0)));
+    }
+    auto fontData = FontData(FontWrapper("Test Regular", 1.2, 1.0, Vec2D(512, 512), 24.0, 8.0), glyphs);
+    return std::make_shared<FontLoaderResult>(nullptr, fontData, LoaderStatus::OK);
+}
+
+std::vector<FormattedStringEntry> formatted(const std::string &text) { return {FormattedStringEntry(text, 1.0f)}; }
+
+} // namespace
+
+TEST_CASE("Shaped texts are shared between labels") {
+    const std::vector<std::string> texts = {"Obere Bahnhofstrasse", "Hauptstrasse", "Obere Bahnhofstrasse"};
+    const auto font = createFont(texts);
+    Tiled2dMapVectorShapedTextCache cache;
+
+    auto first = cache.getShapedText(font, formatted(texts[0]), TextSymbolPlacement::POINT, 10, 1.2);
+    auto second = cache.getShapedText(font, formatted(texts[1]), TextSymbolPlacement::POINT, 10, 1.2);
+    auto third = cache.getShapedText(font, formatted(texts[2]), TextSymbolPlacement::POINT, 10, 1.2);
+    REQUIRE(first == third);
+    REQUIRE(first != second);
+    REQUIRE(first->characterCount == 19);
+    REQUIRE(first->textureCoordinates.size() == 4 * 19);
+    REQUIRE(first->numLines == 2);
+
+    // the same text with other shaping properties
+    REQUIRE(cache.getShapedText(font, formatted(texts[0]), TextSymbolPlacement::POINT, 20, 1.2) != first);
+    REQUIRE(cache.getShapedText(font, formatted(texts[0]), TextSymbolPlacement::POINT, 10, 1.5) != first);
+    REQUIRE(cache.getShapedText(font, {FormattedStringEntry(texts[0], 0.8f)}, TextSymbolPlacement::POINT, 10, 1.2) != first);
+    REQUIRE(cache.getShapedText(createFont(texts), formatted(texts[0]), TextSymbolPlacement::POINT, 10, 1.2) != first);
+    // line placements are not broken into lines
+    auto line = cache.getShapedText(font, formatted(texts[0]), TextSymbolPlacement::LINE, 10, 1.2);
+    REQUIRE(line->numLines == 1);
+    REQUIRE(cache.getShapedText(font, formatted(texts[0]), TextSymbolPlacement::LINE, 20, 1.2) == line);
+
+    auto stats = cache.getStatistics();
+    REQUIRE(stats.hits == 2);
+    REQUIRE(stats.numEntries == 3);
+
+    // dropped with the last label
+    first = nullptr;
+    third = nullptr;
+    REQUIRE(cache.getStatistics().numEntries == 2);
+}
+
+TEST_CASE("Shaped text memory per tile") {
+    for (const auto filePath : {"tiles/reg.pbf", "tiles/relief.pbf"}) {
+        const auto texts = labelTexts(TestData::readFileToBuffer(filePath));
+        const auto font = createFont(texts);
+
+        size_t bytesPerLabel = 0;
+        for (const auto &text : texts) {
+            bytesPerLabel += Tiled2dMapVectorShapedText::shape(font, formatted(text), TextSymbolPlacement::POINT, 10, 1.2)->sizeBytes();
+        }
+
+        Tiled2dMapVectorShapedTextCache cache;
+        std::vector<std::shared_ptr<const Tiled2dMapVectorShapedText>> labels;
+        for (const auto &text : texts) {
+            labels.push_back(cache.getShapedText(font, formatted(text), TextSymbolPlacement::POINT, 10, 1.2));
+        }
+        const auto stats = cache.getStatistics();
+        const size_t bytesShared = stats.sizeBytes + labels.size() * sizeof(labels[0]);
+        REQUIRE(bytesShared <= bytesPerLabel + labels.size() * sizeof(labels[0]));
+
+        // the tile of the next zoom level with the same names shares all shaped texts
+        for (const auto &text : texts) {
+            labels.push_back(cache.getShapedText(font, formatted(text), TextSymbolPlacement::POINT, 10, 1.2));
+        }
+        REQUIRE(cache.getStatistics().numEntries == stats.numEntries);
+
+        WARN(filePath << ": " << texts.size() << " labels, " << stats.numEntries << " distinct texts, " << bytesPerLabel
+                      << " bytes of shaped text per tile, " << bytesShared << " bytes shared");
+    }
+}
+
+TEST_CASE("Shaped text benchmark") {
+    const auto texts = labelTexts(TestData::readFileToBuffer("tiles/reg.pbf"));
+    const auto font = createFont(texts);
+
+    Tiled2dMapVectorShapedTextCache cache;
+    std::vector<std::shared_ptr<const Tiled2dMapVectorShapedText>> labels;
+    for (const auto &text : texts) {
+        labels.push_back(cache.getShapedText(font, formatted(text), TextSymbolPlacement::POINT, 10, 1.2));
+    }
+
+    BENCHMARK("Benchmark shaping the labels of a tile") {
+        size_t characterCount = 0;
+        for (const auto &text : texts) {
+            characterCount += Tiled2dMapVectorShapedText::shape(font, formatted(text), TextSymbolPlacement::POINT, 10, 1.2)->characterCount;
+        }
+        return characterCount;
+    };
+    BENCHMARK("Benchmark shared shaped texts of a tile") {
+        size_t characterCount = 0;
+        for (const auto &text : texts) {
+            characterCount += cache.getShapedText(font, formatted(text), TextSymbolPlacement::POINT, 10, 1.2)->characterCount;
+        }
+        return characterCount;
+    };
+}
@@ -0,0 +1,157 @@
+#include "SpatialGridIndex.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Position {
+    double x;
+    double y;
+};
+
+// Icons scattered over a city of 30km, in EPSG:3857
+std::vector<Position> cityPositions(size_t count, std::mt19937 &generator) {
+    std::normal_distribution<double> distribution(0.0, 5000.0);
+    std::vector<Position> positions;
+    for (size_t i = 0; i < count; i++) {
+        positions.push_back({951000.0 + distribution(generator), 6003000.0 + distribution(generator)});
+    }
+    return positions;
+}
+
+std::vector<size_t> scan(const std::vector<Position> &positions, const std::vector<bool> &removed, double minX, double minY, double maxX,
+                         double maxY) {
+    std::vector<size_t> result;
+    for (size_t i = 0; i < positions.size(); i++) {
+        if (!removed[i] && positions[i].x >= minX && positions[i].x <= maxX && positions[i].y >= minY && positions[i].y <= maxY) {
+            result.push_back(i);
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("SpatialGridIndex matches a scan over all positions") {
+    std::mt19937 generator(42);
+    auto positions = cityPositions(5000, generator);
+    std::vector<bool> removed(positions.size(), false);
+
+    SpatialGridIndex<size_t, size_t> index;
+    for (size_t i = 0; i < positions.size(); i++) {
+        index.insert(i, i, positions[i].x, positions[i].y);
+    }
+    REQUIRE(index.size() == positions.size());
+
+    std::uniform_real_distribution<double> offset(-20000.0, 20000.0);
+    std::uniform_real_distribution<double> extent(0.0, 8000.0);
+    std::uniform_int_distribution<size_t> anyIndex(0, positions.size() - 1);
+
+    for (int round = 0; round < 50; round++) {
+        // move and remove some of the positions
+        for (int i = 0; i < 200; i++) {
+            const size_t moved = anyIndex(generator);
+            positions[moved].x += offset(generator) * 0.1;
+            positions[moved].y += offset(generator) * 0.1;
+            REQUIRE(index.move(moved, positions[moved].x, positions[moved].y) == !removed[moved]);
+        }
+        for (int i = 0; i < 50; i++) {
+            const size_t removedIndex = anyIndex(generator);
+            REQUIRE(index.remove(removedIndex) == !removed[removedIndex]);
+            removed[removedIndex] = true;
+        }
+
+        const double minX = 951000.0 + offset(generator);
+        const double minY = 6003000.0 + offset(generator);
+        const double maxX = minX + extent(generator);
+        const double maxY = minY + extent(generator);
+        std::vector<size_t> result;
+        index.query(minX, minY, maxX, maxY, result);
+        REQUIRE(result == scan(positions, removed, minX, minY, maxX, maxY));
+    }
+
+    // removing most of the values shrinks the grid
+    for (size_t i = 0; i < positions.size(); i++) {
+        if (i % 10 != 0) {
+            index.remove(i);
+            removed[i] = true;
+        }
+    }
+    std::vector<size_t> result;
+    index.query(0.0, 0.0, 2e7, 2e7, result);
+    REQUIRE(result == scan(positions, removed, 0.0, 0.0, 2e7, 2e7));
+
+    // moving keeps the insertion order, reinserting places a value last
+    index.clear();
+    index.insert(0, 0, 0.0, 0.0);
+    index.insert(1, 1, 1.0, 1.0);
+    index.insert(2, 2, 2.0, 2.0);
+    index.move(0, 1000.0, 1000.0);
+    index.remove(1);
+    index.insert(1, 1, 3.0, 3.0);
+    result.clear();
+    index.query(-1.0, -1.0, 2000.0, 2000.0, result);
+    REQUIRE(result == std::vector<size_t>{0, 2, 1});
+}
+
+TEST_CASE("SpatialGridIndex benchmark") {
+    for (const size_t count : {10000, 100000}) {
+        std::mt19937 generator(7);
+        const auto positions = cityPositions(count, generator);
+        const std::vector<bool> removed(count, false);
+
+        SpatialGridIndex<size_t, size_t> index;
+        for (size_t i = 0; i < positions.size(); i++) {
+            index.insert(i, i, positions[i].x, positions[i].y);
+        }
+
+        // a tap with icons of 64px at zoom level 14 covers about 1000 units around the tap, the visible rect about 10km
+        const double tapX = 952000.0;
+        const double tapY = 6004000.0;
+        const double tapPadding = 1000.0;
+        const double visibleHalfSize = 5000.0;
+
+        std::vector<size_t> indexed;
+        index.query(tapX - tapPadding, tapY - tapPadding, tapX + tapPadding, tapY + tapPadding, indexed);
+        REQUIRE(indexed == scan(positions, removed, tapX - tapPadding, tapY - tapPadding, tapX + tapPadding, tapY + tapPadding));
+
+        const std::string suffix = " (" + std::to_string(count) + " icons)";
+        BENCHMARK("Benchmark tap, scan over all icons" + suffix) {
+            return scan(positions, removed, tapX - tapPadding, tapY - tapPadding, tapX + tapPadding, tapY + tapPadding);
+        };
+        BENCHMARK("Benchmark tap, spatial grid index" + suffix) {
+            std::vector<size_t> result;
+            index.query(tapX - tapPadding, tapY - tapPadding, tapX + tapPadding, tapY + tapPadding, result);
+            return result;
+        };
+        BENCHMARK("Benchmark visible rect, scan over all icons" + suffix) {
+            return scan(positions, removed, tapX - visibleHalfSize, tapY - visibleHalfSize, tapX + visibleHalfSize, tapY + visibleHalfSize);
+        };
+        BENCHMARK("Benchmark visible rect, spatial grid index" + suffix) {
+            std::vector<size_t> result;
+            index.query(tapX - visibleHalfSize, tapY - visibleHalfSize, tapX + visibleHalfSize, tapY + visibleHalfSize, result);
+            return result;
+        };
+        // the icon layer refreshes the positions of all icons every frame, usually without changes
+        BENCHMARK("Benchmark refreshing unchanged icons" + suffix) {
+            for (size_t i = 0; i < positions.size(); i++) {
+                index.insert(i, i, positions[i].x, positions[i].y);
+            }
+            return index.size();
+        };
+        BENCHMARK("Benchmark moving all icons" + suffix) {
+            for (size_t i = 0; i < positions.size(); i++) {
+                index.move(i, positions[i].x + 1.0, positions[i].y);
+            }
+            for (size_t i = 0; i < positions.size(); i++) {
+                index.move(i, positions[i].x, positions[i].y);
+            }
+            return index.size();
+        };
+    }
+}
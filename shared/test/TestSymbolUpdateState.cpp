@@ -0,0 +1,106 @@
+#include "SymbolAnimationCoordinator.h"
+#include "Tiled2dMapVectorSymbolUpdateState.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+namespace {
+
+using UpdateMode = Tiled2dMapVectorSymbolGroupUpdateTracker::UpdateMode;
+
+const auto noAnimations = []() { return false; };
+
+} // namespace
+
+TEST_CASE("Symbol camera epoch only changes with the camera") {
+    Tiled2dMapVectorSymbolCameraEpoch cameraEpoch;
+    const std::vector<float> vpMatrix(16, 1.0f);
+    const auto first = cameraEpoch.update(1000.0, 0.0, 1.0, Vec2I(800, 600), vpMatrix, Vec3D(0, 0, 0));
+    REQUIRE(cameraEpoch.update(1000.0, 0.0, 1.0, Vec2I(800, 600), vpMatrix, Vec3D(0, 0, 0)) == first);
+
+    auto last = first;
+    auto requireChanged = [&](uint64_t epoch) {
+        REQUIRE(epoch > last);
+        last = epoch;
+    };
+    requireChanged(cameraEpoch.update(500.0, 0.0, 1.0, Vec2I(800, 600), vpMatrix, Vec3D(0, 0, 0)));
+    requireChanged(cameraEpoch.update(500.0, 10.0, 1.0, Vec2I(800, 600), vpMatrix, Vec3D(0, 0, 0)));
+    requireChanged(cameraEpoch.update(500.0, 10.0, 2.0, Vec2I(800, 600), vpMatrix, Vec3D(0, 0, 0)));
+    requireChanged(cameraEpoch.update(500.0, 10.0, 2.0, Vec2I(800, 601), vpMatrix, Vec3D(0, 0, 0)));
+    auto movedMatrix = vpMatrix;
+    movedMatrix[12] = 0.5f;
+    requireChanged(cameraEpoch.update(500.0, 10.0, 2.0, Vec2I(800, 601), movedMatrix, Vec3D(0, 0, 0)));
+    requireChanged(cameraEpoch.update(500.0, 10.0, 2.0, Vec2I(800, 601), movedMatrix, Vec3D(1, 0, 0)));
+    REQUIRE(cameraEpoch.update(500.0, 10.0, 2.0, Vec2I(800, 601), movedMatrix, Vec3D(1, 0, 0)) == last);
+}
+
+TEST_CASE("Symbol groups are skipped while none of their inputs change") {
+    Tiled2dMapVectorSymbolGroupUpdateTracker tracker;
+    Tiled2dMapVectorSymbolUpdateState state;
+    state.cameraEpoch = 3;
+    state.collisionEpoch = 5;
+
+    // the first update after the setup updates everything
+    REQUIRE(tracker.beginUpdate(state, 0, noAnimations) == UpdateMode::ALL);
+    int animationChecks = 0;
+    REQUIRE(tracker.beginUpdate(state, 0, [&]() {
+        animationChecks++;
+        return false;
+    }) == UpdateMode::NONE);
+    REQUIRE(animationChecks == 1);
+
+    int32_t featureStateId = 0;
+    SECTION("camera epoch") {
+        state.cameraEpoch++;
+        REQUIRE(tracker.beginUpdate(state, 0, [&]() {
+            animationChecks++;
+            return false;
+        }) == UpdateMode::ALL);
+        // the animations are not checked if the inputs changed
+        REQUIRE(animationChecks == 1);
+    }
+    SECTION("collision epoch") {
+        state.collisionEpoch++;
+        REQUIRE(tracker.beginUpdate(state, 0, noAnimations) == UpdateMode::ALL);
+    }
+    SECTION("feature state") {
+        featureStateId = 1;
+        REQUIRE(tracker.beginUpdate(state, featureStateId, noAnimations) == UpdateMode::ALL);
+    }
+    SECTION("changes outside of the update") {
+        tracker.invalidate();
+        REQUIRE(tracker.beginUpdate(state, 0, noAnimations) == UpdateMode::ALL);
+    }
+    SECTION("running animation") {
+        REQUIRE(tracker.beginUpdate(state, 0, []() { return true; }) == UpdateMode::ANIMATIONS);
+    }
+
+    // every change is only updated once
+    REQUIRE(tracker.beginUpdate(state, featureStateId, noAnimations) == UpdateMode::NONE);
+}
+
+TEST_CASE("Symbol groups update while an animation is running") {
+    Tiled2dMapVectorSymbolGroupUpdateTracker tracker;
+    Tiled2dMapVectorSymbolUpdateState state;
+    SymbolAnimationCoordinator coordinator(Vec2D(0, 0), 10, 1.0, 1.0, 300, 0);
+    coordinator.increaseUsage();
+    const auto isAnimating = [&]() { return coordinator.isAnimating(); };
+
+    REQUIRE(tracker.beginUpdate(state, 0, isAnimating) == UpdateMode::ALL);
+    REQUIRE(coordinator.getIconAlpha(1.0, 1000) == 0.0f);
+
+    // fading in, only the animation is updated until it ends
+    REQUIRE(tracker.beginUpdate(state, 0, isAnimating) == UpdateMode::ANIMATIONS);
+    REQUIRE(coordinator.getIconAlpha(1.0, 1150) > 0.0f);
+    REQUIRE(tracker.beginUpdate(state, 0, isAnimating) == UpdateMode::ANIMATIONS);
+    REQUIRE(coordinator.getIconAlpha(1.0, 1300) == 1.0f);
+    REQUIRE(tracker.beginUpdate(state, 0, isAnimating) == UpdateMode::NONE);
+
+    // cached symbols do not animate
+    state.collisionEpoch++;
+    REQUIRE(tracker.beginUpdate(state, 0, isAnimating) == UpdateMode::ALL);
+    coordinator.getIconAlpha(0.0, 2000);
+    coordinator.increaseCache();
+    REQUIRE(tracker.beginUpdate(state, 0, isAnimating) == UpdateMode::NONE);
+}
@@ -0,0 +1,951 @@
+#include "TextHelper.h"
+#include "Utf8Iterator.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Label texts of the scripts found in the style files
+const std::vector<std::string> labelCorpus = {
+    "Bahnhofstrasse", "Zürich", "Genève", "Straße des 17. Juni", "Champs-Élysées", "Łódź", "Ærøskøbing", "İstanbul",
+    "Москва", "Санкт-Петербург", "Αθήνα", "Θεσσαλονίκη", "Երևան", "თბილისი", "ירושלים", "القاهرة", "東京", "北京市",
+    "서울특별시", "กรุงเทพมหานคร", "Hà Nội", "Reykjavík", "Ελληνικά Νησιά", "Київ", "Cork / Corcaigh",
+    "Via della Conciliazione", "Rue de la Paix", "Schweizerhalle", "Ōsaka", "ǆungla",
+};
+
+// The former implementation of TextHelper::bestBreakIndices, as a reference
+namespace reference {
+bool isSpecialCharacter(std::string_view c) { return c == "-" || c == "/"; }
+
+bool isLineBreak(std::string_view c) { return c == "\n"; }
+
+bool allowsLineBreak(std::string_view c) { return isSpecialCharacter(c) || isLineBreak(c) || c == " "; }
+
+struct Break {
+    Break(int index, const std::shared_ptr<Break> &prior, float cost)
+        : index(index), prior(prior), cost(cost) {}
+
+    int index;
+    std::shared_ptr<Break> prior;
+    float cost;
+};
+
+float calculateCost(float lineWidth, float targetWidth, float additionalCost, bool isLast) {
+    float cost = std::pow(lineWidth - targetWidth, 2.0);
+    if (isLast) {
+        return cost * ((lineWidth < targetWidth) ? 0.5 : 2.0);
+    }
+    if (additionalCost < 0) {
+        return cost - additionalCost * additionalCost;
+    }
+    return cost + additionalCost * additionalCost;
+}
+
+std::shared_ptr<Break> evaluate(int nextIndex, float targetWidth, const std::vector<std::shared_ptr<Break>> &potentials, int additionalCost,
+                                bool isLast) {
+    std::shared_ptr<Break> bestPrior = nullptr;
+    float bestCost = calculateCost(nextIndex, targetWidth, additionalCost, isLast);
+    for (const auto &potential : potentials) {
+        float lineWidth = nextIndex - potential->index;
+        float cost = calculateCost(lineWidth, targetWidth, additionalCost, isLast) + potential->cost;
+        if (cost <= bestCost) {
+            bestPrior = potential;
+            bestCost = cost;
+        }
+    }
+    return std::make_shared<Break>(nextIndex, bestPrior, bestCost);
+}
+
+std::vector<BreakResult> bestBreakIndicesSub(std::vector<std::string_view> &letters, int64_t maxCharacterWidth) {
+    if (letters.size() == 0 || letters.size() < maxCharacterWidth) {
+        return {};
+    }
+    float targetBreakCount = std::ceil(letters.size() / (float)maxCharacterWidth);
+    float targetWidth = (float)letters.size() / targetBreakCount;
+
+    std::vector<std::shared_ptr<Break>> potentials;
+    for (int i = 0; i < letters.size(); ++i) {
+        const auto &l = letters[i];
+        if (i < letters.size() - 1 && allowsLineBreak(l)) {
+            float additionalCost = isSpecialCharacter(l) ? 100 : 0;
+            potentials.push_back(evaluate(i + 1, targetWidth, potentials, additionalCost, false));
+        }
+    }
+    auto last = evaluate((int)letters.size(), targetWidth, potentials, 0, true);
+
+    std::vector<BreakResult> leastBads;
+    auto prior = last->prior;
+    while (prior) {
+        leastBads.push_back(BreakResult(prior->index - 1, isSpecialCharacter(letters[prior->index])));
+        prior = prior->prior;
+    }
+    return leastBads;
+}
+
+std::vector<BreakResult> bestBreakIndices(const std::vector<std::string_view> &letters, int64_t maxCharacterWidth) {
+    std::vector<std::vector<std::string_view>> strings = {};
+    std::vector<std::string_view> current = {};
+    for (auto &l : letters) {
+        if (isLineBreak(l)) {
+            strings.push_back(current);
+            strings.push_back({l});
+            current.clear();
+        } else {
+            current.push_back(l);
+        }
+    }
+    if (current.size() > 0) {
+        strings.push_back(current);
+    }
+
+    std::vector<BreakResult> result = {};
+    int currentIndex = 0;
+    for (auto &s : strings) {
+        if (s.size() == 1 && isLineBreak(s[0])) {
+            result.push_back(BreakResult(currentIndex, true));
+        } else {
+            for (auto &b : bestBreakIndicesSub(s, maxCharacterWidth)) {
+                b.index += currentIndex;
+                result.push_back(b);
+            }
+        }
+        currentIndex += s.size();
+    }
+    return result;
+}
+
+// The former implementation of TextHelper::uppercase, as a reference
+unsigned char *StrToUprExt(unsigned char *pString) {
+    if (pString && *pString) {
+        unsigned char *p = pString;
+        unsigned char *pExtChar = 0;
+        while (*p) {
+            if ((*p >= 0x61) && (*p <= 0x7a)) // US ASCII
+                (*p) -= 0x20;
+            else if (*p > 0xc0) {
+                pExtChar = p;
+                p++;
+                switch (*pExtChar) {
+                case 0xc3: // Latin 1
+                    // 0x9f Three byte capital 0xe1 0xba 0x9e
+                    if ((*p >= 0xa0) && (*p <= 0xbe) && (*p != 0xb7))
+                        (*p) -= 0x20; // US ASCII shift
+                    else if (*p == 0xbf) {
+                        *pExtChar = 0xc5;
+                        (*p) = 0xb8;
+                    }
+                    break;
+                case 0xc4:                                                // Latin ext
+                    if ((*p >= 0x80) && (*p <= 0xb7) && (*p % 2))         // Odd
+                        (*p)--;                                           // Prev char is upr
+                    else if ((*p >= 0xb9) && (*p <= 0xbe) && (!(*p % 2))) // Even
+                        (*p)--;                                           // Prev char is upr
+                    break;
+                case 0xc5: // Latin ext
+                    if (*p == 0x80) {
+                        *pExtChar = 0xc4;
+                        (*p) = 0xbf;
+                    } else if ((*p >= 0x81) && (*p <= 0x88) && (!(*p % 2))) // Even
+                        (*p)--;                                             // Prev char is upr
+                    else if ((*p >= 0x8a) && (*p <= 0xb7) && (*p % 2))      // Odd
+                        (*p)--;                                             // Prev char is upr
+                    else if (*p == 0xb8) {
+                        *pExtChar = 0xc5;
+                        (*p) = 0xb8;
+                    } else if ((*p >= 0xb9) && (*p <= 0xbe) && (!(*p % 2))) // Even
+                        (*p)--;                                             // Prev char is upr
+                    break;
+                case 0xc6: // Latin ext
+                    switch (*p) {
+                    case 0x83:
+                    case 0x85:
+                    case 0x88:
+                    case 0x8c:
+                    case 0x92:
+                    case 0x99:
+                    case 0xa1:
+                    case 0xa3:
+                    case 0xa5:
+                    case 0xa8:
+                    case 0xad:
+                    case 0xb0:
+                    case 0xb4:
+                    case 0xb6:
+                    case 0xb9:
+                    case 0xbd:
+                        (*p)--; // Prev char is upr
+                        break;
+                    case 0x80:
+                        *pExtChar = 0xc9;
+                        (*p) = 0x83;
+                        break;
+                    case 0x95:
+                        *pExtChar = 0xc7;
+                        (*p) = 0xb6;
+                        break;
+                    case 0x9a:
+                        *pExtChar = 0xc8;
+                        (*p) = 0xbd;
+                        break;
+                    case 0x9e:
+                        *pExtChar = 0xc8;
+                        (*p) = 0xa0;
+                        break;
+                    default:
+                        break;
+                    }
+                    break;
+                case 0xc7: // Latin ext
+                    if (*p == 0x85)
+                        (*p)--; // Prev char is upr
+                    else if (*p == 0x86)
+                        (*p) = 0x84;
+                    else if (*p == 0x88)
+                        (*p)--; // Prev char is upr
+                    else if (*p == 0x89)
+                        (*p) = 0x87;
+                    else if (*p == 0x8b)
+                        (*p)--; // Prev char is upr
+                    else if (*p == 0x8c)
+                        (*p) = 0x8a;
+                    else if ((*p >= 0x8d) && (*p <= 0x9c) && (!(*p % 2))) // Even
+                        (*p)--;                                           // Prev char is upr
+                    else if ((*p >= 0x9e) && (*p <= 0xaf) && (*p % 2))    // Odd
+                        (*p)--;                                           // Prev char is upr
+                    else if (*p == 0xb2)
+                        (*p)--; // Prev char is upr
+                    else if (*p == 0xb3)
+                        (*p) = 0xb1;
+                    else if (*p == 0xb5)
+                        (*p)--;                                        // Prev char is upr
+                    else if ((*p >= 0xb9) && (*p <= 0xbf) && (*p % 2)) // Odd
+                        (*p)--;                                        // Prev char is upr
+                    break;
+                case 0xc8:                                             // Latin ext
+                    if ((*p >= 0x80) && (*p <= 0x9f) && (*p % 2))      // Odd
+                        (*p)--;                                        // Prev char is upr
+                    else if ((*p >= 0xa2) && (*p <= 0xb3) && (*p % 2)) // Odd
+                        (*p)--;                                        // Prev char is upr
+                    else if (*p == 0xbc)
+                        (*p)--; // Prev char is upr
+                    // 0xbf Three byte capital 0xe2 0xb1 0xbe
+                    break;
+                case 0xc9: // Latin ext
+                    switch (*p) {
+                    case 0x80: // Three byte capital 0xe2 0xb1 0xbf
+                    case 0x90: // Three byte capital 0xe2 0xb1 0xaf
+                    case 0x91: // Three byte capital 0xe2 0xb1 0xad
+                    case 0x92: // Three byte capital 0xe2 0xb1 0xb0
+                    case 0x9c: // Three byte capital 0xea 0x9e 0xab
+                    case 0xa1: // Three byte capital 0xea 0x9e 0xac
+                    case 0xa5: // Three byte capital 0xea 0x9e 0x8d
+                    case 0xa6: // Three byte capital 0xea 0x9e 0xaa
+                    case 0xab: // Three byte capital 0xe2 0xb1 0xa2
+                    case 0xac: // Three byte capital 0xea 0x9e 0xad
+                    case 0xb1: // Three byte capital 0xe2 0xb1 0xae
+                    case 0xbd: // Three byte capital 0xe2 0xb1 0xa4
+                        break;
+                    case 0x82:
+                        (*p)--; // Prev char is upr
+                        break;
+                    case 0x93:
+                        *pExtChar = 0xc6;
+                        (*p) = 0x81;
+                        break;
+                    case 0x94:
+                        *pExtChar = 0xc6;
+                        (*p) = 0x86;
+                        break;
+                    case 0x97:
+                        *pExtChar = 0xc6;
+                        (*p) = 0x8a;
+                        break;
+                    case 0x98:
+                        *pExtChar = 0xc6;
+                        (*p) = 0x8e;
+                        break;
+                    case 0x99:
+                        *pExtChar = 0xc6;
+                        (*p) = 0x8f;
+                        break;
+                    case 0x9b:
+                        *pExtChar = 0xc6;
+                        (*p) = 0x90;
+                        break;
+                    case 0xa0:
+                        *pExtChar = 0xc6;
+                        (*p) = 0x93;
+                        break;
+                    case 0xa3:
+                        *pExtChar = 0xc6;
+                        (*p) = 0x94;
+                        break;
+                    case 0xa8:
+                        *pExtChar = 0xc6;
+                        (*p) = 0x97;
+                        break;
+                    case 0xa9:
+                        *pExtChar = 0xc6;
+                        (*p) = 0x96;
+                        break;
+                    case 0xaf:
+                        *pExtChar = 0xc6;
+                        (*p) = 0x9c;
+                        break;
+                    case 0xb2:
+                        *pExtChar = 0xc6;
+                        (*p) = 0x9d;
+                        break;
+                    default:
+                        if ((*p >= 0x87) && (*p <= 0x8f) && (*p % 2)) // Odd
+                            (*p)--;                                   // Prev char is upr
+                        break;
+                    }
+                    break;
+
+                case 0xca: // Latin ext
+                    switch (*p) {
+                    case 0x82: // Three byte capital 0xea 0x9f 0x85
+                    case 0x87: // Three byte capital 0xea 0x9e 0xb1
+                    case 0x9d: // Three byte capital 0xea 0x9e 0xb2
+                    case 0x9e: // Three byte capital 0xea 0x9e 0xb0
+                        break;
+                    case 0x83:
+                        *pExtChar = 0xc6;
+                        (*p) = 0xa9;
+                        break;
+                    case 0x88:
+                        *pExtChar = 0xc6;
+                        (*p) = 0xae;
+                        break;
+                    case 0x89:
+                        *pExtChar = 0xc9;
+                        (*p) = 0x84;
+                        break;
+                    case 0x8a:
+                        *pExtChar = 0xc6;
+                        (*p) = 0xb1;
+                        break;
+                    case 0x8b:
+                        *pExtChar = 0xc6;
+                        (*p) = 0xb2;
+                        break;
+                    case 0x8c:
+                        *pExtChar = 0xc9;
+                        (*p) = 0x85;
+                        break;
+                    case 0x92:
+                        *pExtChar = 0xc6;
+                        (*p) = 0xb7;
+                        break;
+                    default:
+                        break;
+                    }
+                    break;
+                case 0xcd: // Greek & Coptic
+                    switch (*p) {
+                    case 0xb1:
+                    case 0xb3:
+                    case 0xb7:
+                        (*p)--; // Prev char is upr
+                        break;
+                    case 0xbb:
+                        *pExtChar = 0xcf;
+                        (*p) = 0xbd;
+                        break;
+                    case 0xbc:
+                        *pExtChar = 0xcf;
+                        (*p) = 0xbe;
+                        break;
+                    case 0xbd:
+                        *pExtChar = 0xcf;
+                        (*p) = 0xbf;
+                        break;
+                    default:
+                        break;
+                    }
+                    break;
+                case 0xce: // Greek & Coptic
+                    if (*p == 0xac)
+                        (*p) = 0x86;
+                    else if (*p == 0xad)
+                        (*p) = 0x88;
+                    else if (*p == 0xae)
+                        (*p) = 0x89;
+                    else if (*p == 0xaf)
+                        (*p) = 0x8a;
+                    else if ((*p >= 0xb1) && (*p <= 0xbf))
+                        (*p) -= 0x20; // US ASCII shift
+                    break;
+                case 0xcf: // Greek & Coptic
+                    if ((*p >= 0x80) && (*p <= 0x8b)) {
+                        *pExtChar = 0xce;
+                        (*p) += 0x20;
+                    } else if (*p == 0x8c) {
+                        *pExtChar = 0xce;
+                        (*p) = 0x8c;
+                    } else if (*p == 0x8d) {
+                        *pExtChar = 0xce;
+                        (*p) = 0x8e;
+                    } else if (*p == 0x8e) {
+                        *pExtChar = 0xce;
+                        (*p) = 0x8f;
+                    } else if (*p == 0x91)
+                        (*p) = 0xb4;
+                    else if (*p == 0x97)
+                        (*p) = 0x8f;
+                    else if ((*p >= 0x98) && (*p <= 0xaf) && (*p % 2)) // Odd
+                        (*p)--;                                        // Prev char is upr
+                    else if (*p == 0xb2)
+                        (*p) = 0xb9;
+                    else if (*p == 0xb3) {
+                        *pExtChar = 0xcd;
+                        (*p) = 0xbf;
+                    } else if (*p == 0xb8)
+                        (*p)--; // Prev char is upr
+                    else if (*p == 0xbb)
+                        (*p)--; // Prev char is upr
+                    break;
+                case 0xd0: // Cyrillic
+                    if ((*p >= 0xb0) && (*p <= 0xbf))
+                        (*p) -= 0x20; // US ASCII shift
+                    break;
+                case 0xd1: // Cyrillic supplement
+                    if ((*p >= 0x80) && (*p <= 0x8f)) {
+                        *pExtChar = 0xd0;
+                        (*p) += 0x20;
+                    } else if ((*p >= 0x90) && (*p <= 0x9f)) {
+                        *pExtChar = 0xd0;
+                        (*p) -= 0x10;
+                    } else if ((*p >= 0xa0) && (*p <= 0xbf) && (*p % 2)) // Odd
+                        (*p)--;                                          // Prev char is upr
+                    break;
+                case 0xd2: // Cyrillic supplement
+                    if (*p == 0x81)
+                        (*p)--;                                        // Prev char is upr
+                    else if ((*p >= 0x8a) && (*p <= 0xbf) && (*p % 2)) // Odd
+                        (*p)--;                                        // Prev char is upr
+                    break;
+                case 0xd3:                                           // Cyrillic supplement
+                    if ((*p >= 0x81) && (*p <= 0x8e) && (!(*p % 2))) // Even
+                        (*p)--;                                      // Prev char is upr
+                    else if (*p == 0x8f)
+                        (*p) = 0x80;
+                    else if ((*p >= 0x90) && (*p <= 0xbf) && (*p % 2)) // Odd
+                        (*p)--;                                        // Prev char is upr
+                    break;
+                case 0xd4:                                        // Cyrillic supplement & Armenian
+                    if ((*p >= 0x80) && (*p <= 0xaf) && (*p % 2)) // Odd
+                        (*p)--;                                   // Prev char is upr
+                    break;
+                case 0xd5: // Armenian
+                    if ((*p >= 0xa1) && (*p <= 0xaf)) {
+                        *pExtChar = 0xd4;
+                        (*p) += 0x10;
+                    } else if ((*p >= 0xb0) && (*p <= 0xbf)) {
+                        (*p) -= 0x30;
+                    }
+                    break;
+                case 0xd6: // Armenian
+                    if ((*p >= 0x80) && (*p <= 0x86)) {
+                        *pExtChar = 0xd5;
+                        (*p) += 0x10;
+                    }
+                    break;
+                case 0xe1: // Three byte code
+                    pExtChar = p;
+                    p++;
+                    switch (*pExtChar) {
+                    case 0x82: // Georgian mkhedruli
+                        break;
+                    case 0x83: // Georgian mkhedruli
+                        if (((*p >= 0x90) && (*p <= 0xba)) || (*p == 0xbd) || (*p == 0xbe) || (*p == 0xbf)) {
+                            *pExtChar = 0xb2;
+                        }
+                        break;
+                    case 0x8f: // Cherokee
+                        if ((*p >= 0xb8) && (*p <= 0xbd)) {
+                            (*p) -= 0x08;
+                        }
+                        break;
+                    case 0xb6: // Latin ext
+                        if (*p == 0x8e) {
+                            *(p - 2) = 0xea;
+                            *(p - 1) = 0x9f;
+                            (*p) = 0x86;
+                        }
+                        break;
+                    case 0xb8:                                        // Latin ext
+                        if ((*p >= 0x80) && (*p <= 0xbf) && (*p % 2)) // Odd
+                            (*p)--;                                   // Prev char is upr
+                        break;
+                    case 0xb9:                                        // Latin ext
+                        if ((*p >= 0x80) && (*p <= 0xbf) && (*p % 2)) // Odd
+                            (*p)--;                                   // Prev char is upr
+                        break;
+                    case 0xba:                                             // Latin ext
+                        if ((*p >= 0x80) && (*p <= 0x93) && (*p % 2))      // Odd
+                            (*p)--;                                        // Prev char is upr
+                        else if ((*p >= 0xa0) && (*p <= 0xbf) && (*p % 2)) // Odd
+                            (*p)--;                                        // Prev char is upr
+                        break;
+                    case 0xbb:                                        // Latin ext
+                        if ((*p >= 0x80) && (*p <= 0xbf) && (*p % 2)) // Odd
+                            (*p)--;                                   // Prev char is upr
+                        break;
+                    case 0xbc: // Greek ext
+                        if ((*p >= 0x80) && (*p <= 0x87))
+                            (*p) += 0x08;
+                        else if ((*p >= 0x90) && (*p <= 0x97))
+                            (*p) += 0x08;
+                        else if ((*p >= 0xa0) && (*p <= 0xa7))
+                            (*p) += 0x08;
+                        else if ((*p >= 0xb0) && (*p <= 0xb7))
+                            (*p) += 0x08;
+                        break;
+                    case 0xbd: // Greek ext
+                        if ((*p >= 0x80) && (*p <= 0x87))
+                            (*p) += 0x08;
+                        else if (((*p >= 0x90) && (*p <= 0x97)) && (*p % 2)) // Odd
+                            (*p) += 0x08;
+                        else if ((*p >= 0xa0) && (*p <= 0xa7))
+                            (*p) += 0x08;
+                        else if ((*p >= 0xb0) && (*p <= 0xb1)) {
+                            *(p - 1) = 0xbe;
+                            (*p) += 0x0a;
+                        } else if ((*p >= 0xb2) && (*p <= 0xb5)) {
+                            *(p - 1) = 0xbf;
+                            (*p) -= 0x2a;
+                        } else if ((*p >= 0xb6) && (*p <= 0xb7)) {
+                            *(p - 1) = 0xbf;
+                            (*p) -= 0x1e;
+                        } else if ((*p >= 0xb8) && (*p <= 0xb9)) {
+                            *(p - 1) = 0xbf;
+                        } else if ((*p >= 0xba) && (*p <= 0xbb)) {
+                            *(p - 1) = 0xbf;
+                            (*p) -= 0x10;
+                        } else if ((*p >= 0xbc) && (*p <= 0xbd)) {
+                            *(p - 1) = 0xbf;
+                            (*p) -= 0x02;
+                        }
+                        break;
+                    case 0xbe: // Greek ext
+                        if ((*p >= 0x80) && (*p <= 0x87))
+                            (*p) += 0x08;
+                        else if ((*p >= 0x90) && (*p <= 0x97))
+                            (*p) += 0x08;
+                        else if ((*p >= 0xa0) && (*p <= 0xa7))
+                            (*p) += 0x08;
+                        else if ((*p >= 0xb0) && (*p <= 0xb1))
+                            (*p) += 0x08;
+                        else if (*p == 0xb3)
+                            (*p) += 0x09;
+                        break;
+                    case 0xbf: // Greek ext
+                        if (*p == 0x83)
+                            (*p) += 0x09;
+                        else if ((*p >= 0x90) && (*p <= 0x91))
+                            *p += 0x08;
+                        else if ((*p >= 0xa0) && (*p <= 0xa1))
+                            (*p) += 0x08;
+                        else if (*p == 0xa5)
+                            (*p) += 0x07;
+                        else if (*p == 0xb3)
+                            (*p) += 0x09;
+                        break;
+                    default:
+                        break;
+                    }
+                    break;
+                case 0xe2: // Three byte code
+                    pExtChar = p;
+                    p++;
+                    switch (*pExtChar) {
+                    case 0xb0: // Glagolitic
+                        if ((*p >= 0xb0) && (*p <= 0xbf)) {
+                            (*p) -= 0x30;
+                        }
+                        break;
+                    case 0xb1: // Glagolitic
+                        if ((*p >= 0x80) && (*p <= 0x9e)) {
+                            *pExtChar = 0xb0;
+                            (*p) += 0x10;
+                        } else { // Latin ext
+                            switch (*p) {
+                            case 0xa1:
+                            case 0xa8:
+                            case 0xaa:
+                            case 0xac:
+                            case 0xb3:
+                            case 0xb6:
+                                (*p)--; // Prev char is upr
+                                break;
+                            case 0xa5: // Two byte capital  0xc8 0xba
+                            case 0xa6: // Two byte capital  0xc8 0xbe
+                                break;
+                            default:
+                                break;
+                            }
+                        }
+                        break;
+                    case 0xb2:                                        // Coptic
+                        if ((*p >= 0x80) && (*p <= 0xbf) && (*p % 2)) // Odd
+                            (*p)--;                                   // Prev char is upr
+                        break;
+                    case 0xb3:                                         // Coptic
+                        if (((*p >= 0x80) && (*p <= 0xa3) && (*p % 2)) // Odd
+                            || (*p == 0xac) || (*p == 0xae) || (*p == 0xb3))
+                            (*p)--; // Prev char is upr
+                        break;
+                    default:
+                        break;
+                    }
+                    break;
+                case 0xea: // Three byte code
+                    pExtChar = p;
+                    p++;
+                    switch (*pExtChar) {
+                    case 0x99:                                        // Cyrillic
+                        if ((*p >= 0x80) && (*p <= 0xad) && (*p % 2)) // Odd
+                            (*p)--;                                   // Prev char is upr
+                        break;
+                    case 0x9a:                                        // Cyrillic
+                        if ((*p >= 0x80) && (*p <= 0x9b) && (*p % 2)) // Odd
+                            (*p)--;                                   // Prev char is upr
+                        break;
+                    case 0x9c:                                                                              // Latin ext
+                        if ((((*p >= 0xa2) && (*p <= 0xaf)) || ((*p >= 0xb2) && (*p <= 0xbf))) && (*p % 2)) // Odd
+                            (*p)--;                                                                         // Prev char is upr
+                        break;
+                    case 0x9d:                                         // Latin ext
+                        if (((*p >= 0x80) && (*p <= 0xaf) && (*p % 2)) // Odd
+                            || (*p == 0xba) || (*p == 0xbc) || (*p == 0xbf))
+                            (*p)--; // Prev char is upr
+                        break;
+                    case 0x9e: // Latin ext
+                        if (((((*p >= 0x80) && (*p <= 0x87)) || ((*p >= 0x96) && (*p <= 0xa9)) || ((*p >= 0xb4) && (*p <= 0xbf))) &&
+                             (*p % 2)) // Odd
+                            || (*p == 0x8c) || (*p == 0x91) || (*p == 0x93))
+                            (*p)--; // Prev char is upr
+                        else if (*p == 0x94) {
+                            *(p - 2) = 0xea;
+                            *(p - 1) = 0x9f;
+                            *(p) = 0x84;
+                        }
+                        break;
+                    case 0x9f: // Latin ext
+                        if ((*p == 0x83) || (*p == 0x88) || (*p == 0x8a) || (*p == 0xb6))
+                            (*p)--; // Prev char is upr
+                        break;
+                    case 0xad:
+                        // Latin ext
+                        if (*p == 0x93) {
+                            *pExtChar = 0x9e;
+                            (*p) = 0xb3;
+                        }
+                        // Cherokee
+                        else if ((*p >= 0xb0) && (*p <= 0xbf)) {
+                            *(p - 2) = 0xe1;
+                            *pExtChar = 0x8e;
+                            (*p) -= 0x10;
+                        }
+                        break;
+                    case 0xae: // Cherokee
+                        if ((*p >= 0x80) && (*p <= 0x8f)) {
+                            *(p - 2) = 0xe1;
+                            *pExtChar = 0x8e;
+                            (*p) += 0x30;
+                        } else if ((*p >= 0x90) && (*p <= 0xbf)) {
+                            *(p - 2) = 0xe1;
+                            *pExtChar = 0x8f;
+                            (*p) -= 0x10;
+                        }
+                        break;
+                    default:
+                        break;
+                    }
+                    break;
+                case 0xef: // Three byte code
+                    pExtChar = p;
+                    p++;
+                    switch (*pExtChar) {
+                    case 0xbd: // Latin fullwidth
+                        if ((*p >= 0x81) && (*p <= 0x9a)) {
+                            *pExtChar = 0xbc;
+                            (*p) += 0x20;
+                        }
+                        break;
+                    default:
+                        break;
+                    }
+                    break;
+                case 0xf0: // Four byte code
+                    pExtChar = p;
+                    p++;
+                    switch (*pExtChar) {
+                    case 0x90:
+                        pExtChar = p;
+                        p++;
+                        switch (*pExtChar) {
+                        case 0x90: // Deseret
+                            if ((*p >= 0xa8) && (*p <= 0xbf)) {
+                                (*p) -= 0x28;
+                            }
+                            break;
+                        case 0x91: // Deseret
+                            if ((*p >= 0x80) && (*p <= 0x8f)) {
+                                *pExtChar = 0x90;
+                                (*p) += 0x18;
+                            }
+                            break;
+                        case 0x93: // Osage
+                            if ((*p >= 0x98) && (*p <= 0xa7)) {
+                                *pExtChar = 0x92;
+                                (*p) += 0x18;
+                            } else if ((*p >= 0xa8) && (*p <= 0xbb))
+                                (*p) -= 0x28;
+                            break;
+                        case 0xb3: // Old hungarian
+                            if ((*p >= 0x80) && (*p <= 0xb2))
+                                *pExtChar = 0xb2;
+                            break;
+                        default:
+                            break;
+                        }
+                        break;
+                    case 0x91:
+                        pExtChar = p;
+                        p++;
+                        switch (*pExtChar) {
+                        case 0xa3: // Warang citi
+                            if ((*p >= 0x80) && (*p <= 0x9f)) {
+                                *pExtChar = 0xa2;
+                                (*p) += 0x20;
+                            }
+                            break;
+                        default:
+                            break;
+                        }
+                        break;
+                    case 0x96:
+                        pExtChar = p;
+                        p++;
+                        switch (*pExtChar) {
+                        case 0xb9: // Medefaidrin
+                            if ((*p >= 0xa0) && (*p <= 0xbf))
+                                (*p) -= 0x20;
+                            break;
+                        default:
+                            break;
+                        }
+                        break;
+                    case 0x9E:
+                        pExtChar = p;
+                        p++;
+                        switch (*pExtChar) {
+                        case 0xA4: // Adlam
+                            if ((*p >= 0xa2) && (*p <= 0xbf))
+                                (*p) -= 0x22;
+                            break;
+                        case 0xA5: // Adlam
+                            if ((*p >= 0x80) && (*p <= 0x83)) {
+                                *(pExtChar) = 0xa4;
+                                (*p) += 0x1e;
+                            }
+                            break;
+                        default:
+                            break;
+                        }
+                        break;
+                    }
+                    break;
+                default:
+                    break;
+                }
+                pExtChar = 0;
+            }
+            p++;
+        }
+    }
+    return pString;
+}
+
+std::string uppercase(std::string string) {
+    StrToUprExt((unsigned char *)string.data());
+    return string;
+}
+} // namespace reference
+
+bool equalBreaks(const std::vector<BreakResult> &lhs, const std::vector<BreakResult> &rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                      [](const auto &l, const auto &r) { return l.index == r.index && l.keepLetter == r.keepLetter; });
+}
+
+std::vector<std::string_view> letters(const std::string &text) {
+    std::vector<std::string_view> letters;
+    for (const auto letter : Utf8Letters(text)) {
+        letters.push_back(letter);
+    }
+    return letters;
+}
+
+} // namespace
+
+TEST_CASE("TextHelper UTF-8 letters") {
+    std::vector<std::string_view> letters;
+    for (const auto letter : Utf8Letters("Zürich 東京")) {
+        letters.push_back(letter);
+    }
+    REQUIRE(letters == std::vector<std::string_view>{"Z", "ü", "r", "i", "c", "h", " ", "東", "京"});
+
+    // letters outside of the basic multilingual plane and invalid bytes are skipped
+    REQUIRE(TextHelper::splitWstring("a\xF0\x9F\x98\x80"
+                                     "b\xC3") == std::vector<std::string>{"a", "b"});
+    REQUIRE(TextHelper::splitWstring("\xE2\x82"
+                                     "c\x80") == std::vector<std::string>{"c"});
+    REQUIRE(TextHelper::splitWstring("").empty());
+
+    auto it = Utf8Letters("€").begin();
+    REQUIRE(it.codepoint() == 0x20AC);
+    REQUIRE(it.offset() == 0);
+}
+
+TEST_CASE("TextHelper uppercase") {
+    REQUIRE(TextHelper::uppercase("bahnhofstrasse 12a") == "BAHNHOFSTRASSE 12A");
+    REQUIRE(TextHelper::uppercase("Zürich, Genève, Łódź") == "ZÜRICH, GENÈVE, ŁÓDŹ");
+    REQUIRE(TextHelper::uppercase("Straße") == "STRAßE");
+    REQUIRE(TextHelper::uppercase("ÿ") == "Ÿ");
+    REQUIRE(TextHelper::uppercase("Санкт-Петербург") == "САНКТ-ПЕТЕРБУРГ");
+    REQUIRE(TextHelper::uppercase("Θεσσαλονίκη") == "ΘΕΣΣΑΛΟΝΊΚΗ");
+    REQUIRE(TextHelper::uppercase("Երևան") == "ԵՐևԱՆ");
+    REQUIRE(TextHelper::uppercase("ǆungla") == "ǄUNGLA");
+    REQUIRE(TextHelper::uppercase("東京 서울") == "東京 서울");
+    // Deseret, outside of the basic multilingual plane
+    REQUIRE(TextHelper::uppercase("\xF0\x90\x90\xA8") == "\xF0\x90\x90\x80");
+    // invalid bytes are kept
+    REQUIRE(TextHelper::uppercase("a\xC3z\xFF") == "A\xC3Z\xFF");
+    // the ASCII fast path and the remainder
+    REQUIRE(TextHelper::uppercase("abcdefghijklmnopqrstuvwxyz`{@[~") == "ABCDEFGHIJKLMNOPQRSTUVWXYZ`{@[~");
+    REQUIRE(TextHelper::uppercase("abcdefgü") == "ABCDEFGÜ");
+}
+
+TEST_CASE("TextHelper uppercase matches the reference on the basic multilingual plane") {
+    for (uint32_t codepoint = 1; codepoint < 0x10000; ++codepoint) {
+        if (codepoint >= 0xD800 && codepoint < 0xE000) {
+            continue;
+        }
+        std::string letter;
+        Utf8Iterator::append(letter, codepoint);
+        // in a text, the preceding ASCII letters take the fast path
+        const std::string text = "abcdefgh" + letter + letter;
+        const auto expected = reference::uppercase(text);
+        if (TextHelper::uppercase(text) != expected) {
+            FAIL("U+" << std::hex << codepoint << ": " << TextHelper::uppercase(text) << " instead of " << expected);
+        }
+    }
+}
+
+TEST_CASE("TextHelper line breaks") {
+    const auto breaks = TextHelper::bestBreakIndices(letters("Obere Bahnhofstrasse"), 10);
+    REQUIRE(breaks.size() == 1);
+    REQUIRE(breaks[0].index == 5);
+    REQUIRE_FALSE(breaks[0].keepLetter);
+
+    REQUIRE(TextHelper::bestBreakIndices(letters("Zürich"), 10).empty());
+    const auto lineBreak = TextHelper::bestBreakIndices(letters("Zürich\nHB"), 10);
+    REQUIRE(lineBreak.size() == 1);
+    REQUIRE(lineBreak[0].index == 6);
+    REQUIRE(lineBreak[0].keepLetter);
+}
+
+TEST_CASE("TextHelper line breaks skip letters outside of the basic multilingual plane") {
+    // the emojis used to be split into empty letters, which took up space in the line
+    const std::string text = "Obere \xF0\x9F\x9A\x89"
+                             "Bahnhofstrasse \xF0\x9F\x98\x80";
+    const auto split = TextHelper::splitWstring(text);
+    REQUIRE(std::none_of(split.begin(), split.end(), [](const auto &letter) { return letter.empty(); }));
+    REQUIRE(split.size() == 21);
+
+    const auto textLetters = letters(text);
+    REQUIRE(std::none_of(textLetters.begin(), textLetters.end(), [](const auto &letter) { return letter.empty(); }));
+    REQUIRE(equalBreaks(TextHelper::bestBreakIndices(textLetters, 10), TextHelper::bestBreakIndices(letters("Obere Bahnhofstrasse "), 10)));
+    const auto breaks = TextHelper::bestBreakIndices(textLetters, 10);
+    REQUIRE(breaks.size() == 1);
+    REQUIRE(breaks[0].index == 5);
+}
+
+TEST_CASE("TextHelper line breaks match the reference on random texts") {
+    const std::vector<std::string> alphabet = {"a", "b", "ü", "東", " ", " ", "-", "/", "\n"};
+    std::mt19937 random(42);
+
+    for (int i = 0; i < 5000; ++i) {
+        std::string text;
+        const auto length = random() % 60;
+        for (int j = 0; j < length; ++j) {
+            // spaces and special characters are rarer than in the alphabet
+            text += alphabet[random() % 4 == 0 ? random() % alphabet.size() : random() % 4];
+        }
+        const int64_t maxCharacterWidth = random() % 16;
+        const auto expected = reference::bestBreakIndices(letters(text), maxCharacterWidth);
+        // the second call is answered by the cache
+        REQUIRE(equalBreaks(TextHelper::bestBreakIndices(letters(text), maxCharacterWidth), expected));
+        REQUIRE(equalBreaks(TextHelper::bestBreakIndices(letters(text), maxCharacterWidth), expected));
+    }
+}
+
+TEST_CASE("TextHelper benchmark") {
+    BENCHMARK("Benchmark uppercase of the label corpus") {
+        size_t size = 0;
+        for (const auto &text : labelCorpus) {
+            size += TextHelper::uppercase(text).size();
+        }
+        return size;
+    };
+
+    BENCHMARK("Benchmark splitting the label corpus into letters") {
+        size_t count = 0;
+        for (const auto &text : labelCorpus) {
+            count += TextHelper::splitWstring(text).size();
+        }
+        return count;
+    };
+
+    std::vector<std::vector<std::string_view>> corpusLetters;
+    for (const auto &text : labelCorpus) {
+        corpusLetters.push_back(letters(text));
+    }
+    BENCHMARK("Benchmark line breaks of the label corpus, reference") {
+        size_t count = 0;
+        for (const auto &l : corpusLetters) {
+            count += reference::bestBreakIndices(l, 6).size();
+        }
+        return count;
+    };
+    BENCHMARK("Benchmark line breaks of the label corpus") {
+        size_t count = 0;
+        for (const auto &l : corpusLetters) {
+            count += TextHelper::bestBreakIndices(l, 6).size();
+        }
+        return count;
+    };
+
+    BENCHMARK("Benchmark iterating the letters of the label corpus") {
+        size_t count = 0;
+        for (const auto &text : labelCorpus) {
+            for (const auto letter : Utf8Letters(text)) {
+                count += letter.size();
+            }
+        }
+        return count;
+    };
+}
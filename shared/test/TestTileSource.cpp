@@ -1,6 +1,8 @@
+#include "CoordinateConversionHelper.h"
 #include "CoordinateSystemFactory.h"
 #include "DataLoaderResult.h"
 #include "LoaderInterface.h"
+#include "Matrix.h"
 #include "TextureLoaderResult.h"
 #include "Tiled2dMapSource.h"
 #include "WebMercatorTiled2dMapLayerConfig.h"
@@ -25,9 +27,11 @@
 class TestTiled2dMapVectorSource : public Tiled2dMapSource<std::shared_ptr<DataLoaderResult>, std::string> {
   public:
     TestTiled2dMapVectorSource(std::shared_ptr<Tiled2dMapLayerConfig> layerConfig, std::shared_ptr<TestScheduler> scheduler,
-                               std::vector<std::shared_ptr<LoaderInterface>> loaders)
-        : Tiled2dMapSource(MapConfig(CoordinateSystemFactory::getEpsg3857System()), layerConfig,
-                           CoordinateConversionHelperInterface::independentInstance(), scheduler, 62, loaders.size(), "layer")
+                               std::vector<std::shared_ptr<LoaderInterface>> loaders,
+                               const MapConfig &mapConfig = MapConfig(CoordinateSystemFactory::getEpsg3857System()),
+                               const std::shared_ptr<CoordinateConversionHelperInterface> &conversionHelper =
+                                   CoordinateConversionHelperInterface::independentInstance())
+        : Tiled2dMapSource(mapConfig, layerConfig, conversionHelper, scheduler, 62, loaders.size(), "layer")
         , layerConfig(layerConfig)
         , loaders(loaders) {}
 
@@ -50,8 +54,8 @@ class TestTiled2dMapVectorSource : public Tiled2dMapSource<std::shared_ptr<DataL
 
     size_t numLoadingOrQueued() const {
         size_t n = currentlyLoading.size();
-        for (const auto &queue : loadingQueues) {
-            n += queue.size();
+        if (loadSchedulerClientId) {
+            n += loadScheduler->getNumPending(*loadSchedulerClientId);
         }
         return n;
     }
@@ -64,8 +68,35 @@ class TestTiled2dMapVectorSource : public Tiled2dMapSource<std::shared_ptr<DataL
         return errorTiles;
     }
 
+    std::unordered_set<Tiled2dMapTileInfo> getPrefetchedTiles() const {
+        std::unordered_set<Tiled2dMapTileInfo> tiles;
+        for (const auto &tile : prefetchedResults) {
+            tiles.insert(tile.first);
+        }
+        return tiles;
+    }
+
+    int64_t getPrefetchHits() const { return prefetchHits; }
+
+    int64_t getPrefetchMisses() const { return prefetchMisses; }
+
+    std::unordered_set<Tiled2dMapTileInfo> getVisibleTiles() const { return currentVisibleTiles; }
+
+    const Tiled2dMapVisibleTilesPyramid::Tiling &getVisibleTilesTiling() const { return visibleTilesTiling; }
+
+    std::unordered_set<Tiled2dMapTileInfo> getTimeSeriesLoadedTiles() const {
+        std::unordered_set<Tiled2dMapTileInfo> tiles;
+        for (const auto &tile : timeSeriesResults) {
+            tiles.insert(tile.first);
+        }
+        return tiles;
+    }
+
     void notifyTilesUpdates() override {}
 
+    int64_t resultMemorySize = 0;
+    std::pair<int32_t, int32_t> timeSeriesReady = {-1, -1};
+
   protected:
     void cancelLoad(Tiled2dMapTileInfo tile, size_t loaderIndex) override {
         loaders[loaderIndex]->cancel(layerConfig->getTileUrl(tile.x, tile.y, tile.t, tile.zoomIdentifier));
@@ -82,6 +113,10 @@ class TestTiled2dMapVectorSource : public Tiled2dMapSource<std::shared_ptr<DataL
 
     bool hasExpensivePostLoadingTask() override { return false; }
 
+    int64_t getResultMemorySize(const std::string &result) override { return resultMemorySize; }
+
+    void onTimeSeriesReadyChanged(int32_t readyFrames, int32_t numFrames) override { timeSeriesReady = {readyFrames, numFrames}; }
+
     std::string postLoadingTask(std::shared_ptr<DataLoaderResult> loadedData, Tiled2dMapTileInfo tile) override {
         if (!loadedData->data.has_value()) {
             return std::string{};
@@ -426,3 +461,346 @@ TEST_CASE("Tiled2dMapSource error load retry") {
     REQUIRE_THAT(source->getCurrentTiles(), Catch::Matchers::UnorderedRangeEquals(expectedTilesWest));
     REQUIRE(source->numLoadingOrQueued() == 0);
 }
+
+TEST_CASE("Tiled2dMapSource prefetches predicted tiles") {
+    auto layerConfig = std::make_shared<WebMercatorTiled2dMapLayerConfig>(
+        "mock", "test-data://tile/{z}/{x}/{y}", Tiled2dMapZoomInfo(1.0, 0, 0, false, true, false, true), 0, 20);
+
+    auto world = *layerConfig->getBounds();
+    auto zoomLevelInfos = layerConfig->getZoomLevelInfos();
+    const int z = 3;
+    std::vector<Tiled2dMapTileInfo> allTiles = {{world, 0, 0, 0, 0, int(zoomLevelInfos[0].zoom)}};
+    for (int x = 0; x < zoomLevelInfos[z].numTilesX; x++) {
+        for (int y = 0; y < zoomLevelInfos[z].numTilesY; y++) {
+            allTiles.push_back({world, x, y, 0, z, int(zoomLevelInfos[z].zoom)});
+        }
+    }
+
+    auto loader = std::make_shared<BlockingTestLoader>(generateDummyData(allTiles, *layerConfig, "dummy data "));
+    auto scheduler = std::make_shared<TestScheduler>();
+    std::shared_ptr<TestTiled2dMapVectorSource> source =
+        std::make_shared<TestTiled2dMapVectorSource>(layerConfig, scheduler, std::vector<std::shared_ptr<LoaderInterface>>{loader});
+    source->mailbox = std::make_shared<Mailbox>(scheduler);
+    source->setPrefetchEnabled(true);
+
+    const double zoom = zoomLevelInfos[z].zoom;
+    const auto &topLeft = world.topLeft;
+    const auto &bottomRight = world.bottomRight;
+    RectCoord northWest(topLeft, Coord(topLeft.systemIdentifier, 0, 0, 0));
+    RectCoord northEast(Coord(topLeft.systemIdentifier, 0, topLeft.y, 0), Coord(topLeft.systemIdentifier, bottomRight.x, 0, 0));
+    RectCoord southWest(Coord(topLeft.systemIdentifier, topLeft.x, 0, 0), Coord(topLeft.systemIdentifier, 0, bottomRight.y, 0));
+
+    // the visible tiles (including padding) cover the columns 0 to 4, the predicted ones the columns 4 to 7
+    std::unordered_set<Tiled2dMapTileInfo> expectedPrefetched;
+    for (int x = 5; x < 8; x++) {
+        for (int y = 0; y < 5; y++) {
+            expectedPrefetched.insert({world, x, y, 0, z, int(zoomLevelInfos[z].zoom)});
+        }
+    }
+
+    source->onVisibleBoundsChanged(northWest, 0, zoom);
+    source->onPrefetchBoundsChanged(northEast, 0, zoom);
+    while (scheduler->drain(), loader->unblockAll()) {
+    }
+
+    REQUIRE(source->getPrefetchedTiles() == expectedPrefetched);
+    for (const auto &tile : source->getCurrentTiles()) {
+        REQUIRE(expectedPrefetched.count(tile) == 0);
+    }
+
+    // the prediction was right, the prefetched tiles are shown without loading them again
+    source->onVisibleBoundsChanged(northEast, 0, zoom);
+    auto currentTiles = source->getCurrentTiles();
+    for (const auto &tile : expectedPrefetched) {
+        REQUIRE(currentTiles.count(tile) == 1);
+    }
+    REQUIRE(source->getPrefetchHits() == (int64_t)expectedPrefetched.size());
+    REQUIRE(source->getPrefetchMisses() == 0);
+    REQUIRE(source->getPrefetchedTiles().empty());
+    while (scheduler->drain(), loader->unblockAll()) {
+    }
+
+    // the prediction was wrong, the prefetched tiles are dropped
+    source->onPrefetchBoundsChanged(southWest, 0, zoom);
+    while (scheduler->drain(), loader->unblockAll()) {
+    }
+    const auto prefetched = source->getPrefetchedTiles();
+    REQUIRE(!prefetched.empty());
+    for (const auto &tile : prefetched) {
+        REQUIRE(tile.y >= 4);
+    }
+
+    source->onPrefetchBoundsChanged(std::nullopt, 0, zoom);
+    REQUIRE(source->getPrefetchedTiles().empty());
+    REQUIRE(source->getPrefetchMisses() == (int64_t)prefetched.size());
+    REQUIRE(source->getPrefetchHits() == (int64_t)expectedPrefetched.size());
+}
+
+TEST_CASE("Tiled2dMapSource prefetches predicted tiles with the fallback loaders") {
+    auto layerConfig = std::make_shared<WebMercatorTiled2dMapLayerConfig>(
+        "mock", "test-data://tile/{z}/{x}/{y}", Tiled2dMapZoomInfo(1.0, 0, 0, false, true, false, true), 0, 20);
+
+    auto world = *layerConfig->getBounds();
+    auto zoomLevelInfos = layerConfig->getZoomLevelInfos();
+    const int z = 3;
+    std::vector<Tiled2dMapTileInfo> allTiles = {{world, 0, 0, 0, 0, int(zoomLevelInfos[0].zoom)}};
+    for (int x = 0; x < zoomLevelInfos[z].numTilesX; x++) {
+        for (int y = 0; y < zoomLevelInfos[z].numTilesY; y++) {
+            allTiles.push_back({world, x, y, 0, z, int(zoomLevelInfos[z].zoom)});
+        }
+    }
+
+    // the first loader has no data at all, i.e. it answers every load with NOOP
+    auto emptyLoader = std::make_shared<BlockingTestLoader>(std::unordered_map<std::string, std::string>{});
+    auto loader = std::make_shared<BlockingTestLoader>(generateDummyData(allTiles, *layerConfig, "dummy data "));
+    auto scheduler = std::make_shared<TestScheduler>();
+    std::shared_ptr<TestTiled2dMapVectorSource> source = std::make_shared<TestTiled2dMapVectorSource>(
+        layerConfig, scheduler, std::vector<std::shared_ptr<LoaderInterface>>{emptyLoader, loader});
+    source->mailbox = std::make_shared<Mailbox>(scheduler);
+    source->setPrefetchEnabled(true);
+
+    const double zoom = zoomLevelInfos[z].zoom;
+    const auto &topLeft = world.topLeft;
+    const auto &bottomRight = world.bottomRight;
+    RectCoord northWest(topLeft, Coord(topLeft.systemIdentifier, 0, 0, 0));
+    RectCoord northEast(Coord(topLeft.systemIdentifier, 0, topLeft.y, 0), Coord(topLeft.systemIdentifier, bottomRight.x, 0, 0));
+
+    std::unordered_set<Tiled2dMapTileInfo> expectedPrefetched;
+    for (int x = 5; x < 8; x++) {
+        for (int y = 0; y < 5; y++) {
+            expectedPrefetched.insert({world, x, y, 0, z, int(zoomLevelInfos[z].zoom)});
+        }
+    }
+
+    source->onVisibleBoundsChanged(northWest, 0, zoom);
+    source->onPrefetchBoundsChanged(northEast, 0, zoom);
+    while (scheduler->drain(), emptyLoader->unblockAll() | loader->unblockAll()) {
+    }
+
+    REQUIRE(source->getPrefetchedTiles() == expectedPrefetched);
+}
+
+static Tiled2dMapVisibleTilesPyramid::Camera globeCamera(float distance) {
+    std::vector<float> viewMatrix(16, 0.0);
+    std::vector<float> projectionMatrix(16, 0.0);
+    Matrix::setLookAtM(viewMatrix, 0, 0.0, 0.0, distance, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0);
+    Matrix::perspectiveM(projectionMatrix, 0, 40.0, 1.0, 0.01, 10.0);
+    return Tiled2dMapVisibleTilesPyramid::Camera{
+        viewMatrix, projectionMatrix, Vec3D(0.0, 0.0, 0.0), 40.0, 40.0, 1000.0, 1000.0, 0.0, Coord(CoordinateSystemIdentifiers::EPSG4326(), -90.0, 0.0, 0.0)};
+}
+
+static void setCamera(TestTiled2dMapVectorSource &source, const Tiled2dMapVisibleTilesPyramid::Camera &camera) {
+    source.onCameraChange(camera.viewMatrix, camera.projectionMatrix, camera.origin, camera.verticalFov, camera.horizontalFov,
+                          camera.width, camera.height, camera.focusPointAltitude, camera.focusPointPosition, 0.0);
+}
+
+TEST_CASE("Tiled2dMapSource shares the visible tiles of sources with the same tiling") {
+    const MapConfig mapConfig(CoordinateSystemFactory::getUnitSphereSystem());
+    auto conversionHelper = std::make_shared<CoordinateConversionHelper>(mapConfig.mapCoordinateSystem, false);
+    auto scheduler = std::make_shared<TestScheduler>();
+
+    auto makeSource = [&](int32_t maxZoomLevel) {
+        auto layerConfig = std::make_shared<WebMercatorTiled2dMapLayerConfig>(
+            "mock", "{z}/{x}/{y}", Tiled2dMapZoomInfo(1.0, 0, 0, false, true, false, true), 0, maxZoomLevel);
+        auto source = std::make_shared<TestTiled2dMapVectorSource>(
+            layerConfig, scheduler, std::vector<std::shared_ptr<LoaderInterface>>{std::make_shared<NothingTestLoader>()}, mapConfig,
+            conversionHelper);
+        source->mailbox = std::make_shared<Mailbox>(scheduler);
+        return source;
+    };
+
+    // a style with several sources of the same tiling and one with different zoom levels
+    std::vector<std::shared_ptr<TestTiled2dMapVectorSource>> sources = {makeSource(20), makeSource(20), makeSource(20)};
+    auto otherSource = makeSource(10);
+
+    auto pyramid = Tiled2dMapVisibleTilesPyramid::getInstance(conversionHelper);
+    const size_t computations = pyramid->getNumComputations();
+
+    const auto camera = globeCamera(3.0);
+    for (const auto &source : sources) {
+        setCamera(*source, camera);
+    }
+    REQUIRE(pyramid->getNumComputations() == computations + 1);
+
+    const auto visibleTiles = sources[0]->getVisibleTiles();
+    REQUIRE(!visibleTiles.empty());
+    for (const auto &source : sources) {
+        REQUIRE(source->getVisibleTiles() == visibleTiles);
+    }
+
+    setCamera(*otherSource, camera);
+    REQUIRE(pyramid->getNumComputations() == computations + 2);
+
+    // the shared result is the same as the result of an own traversal
+    auto ownResult = pyramid->computeVisibleTiles(sources[0]->getVisibleTilesTiling(), camera);
+    auto sharedResult = pyramid->getVisibleTiles(sources[0]->getVisibleTilesTiling(), camera);
+    REQUIRE(ownResult->visibleTiles.size() == sharedResult->visibleTiles.size());
+    for (size_t i = 0; i < ownResult->visibleTiles.size(); ++i) {
+        REQUIRE(ownResult->visibleTiles[i].second.tileInfo == sharedResult->visibleTiles[i].second.tileInfo);
+    }
+
+    const auto closerCamera = globeCamera(2.0);
+    for (const auto &source : sources) {
+        setCamera(*source, closerCamera);
+    }
+    REQUIRE(pyramid->getNumComputations() == computations + 3);
+
+    // the sources of a layer get the same snapshot of the camera state
+    const auto cameraState = std::make_shared<const MapCameraState>(globeCamera(2.5));
+    for (const auto &source : sources) {
+        source->onCameraStateChanged(cameraState);
+    }
+    REQUIRE(pyramid->getNumComputations() == computations + 4);
+    for (const auto &source : sources) {
+        REQUIRE(source->getVisibleTiles() == sources[0]->getVisibleTiles());
+    }
+
+    scheduler->drain();
+
+    // visible tiles of all sources per camera change, before (own traversal per source) and after (shared traversal)
+    int cameraIndex = 0;
+    BENCHMARK_ADVANCED("visible tiles of 3 sources, traversal per source")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            // a new camera frame for every run
+            const auto camera = globeCamera(2.0 + 0.0001 * (cameraIndex++ % 10000));
+            size_t numTiles = 0;
+            for (const auto &source : sources) {
+                numTiles += pyramid->computeVisibleTiles(source->getVisibleTilesTiling(), camera)->visibleTiles.size();
+            }
+            return numTiles;
+        });
+    };
+    BENCHMARK_ADVANCED("visible tiles of 3 sources, shared traversal")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            // a new camera frame for every run
+            const auto camera = globeCamera(2.0 + 0.0001 * (cameraIndex++ % 10000));
+            size_t numTiles = 0;
+            for (const auto &source : sources) {
+                numTiles += pyramid->getVisibleTiles(source->getVisibleTilesTiling(), camera)->visibleTiles.size();
+            }
+            return numTiles;
+        });
+    };
+}
+
+// WebMercator tiling with several time steps per tile
+class TimeSeriesTestLayerConfig : public WebMercatorTiled2dMapLayerConfig {
+  public:
+    TimeSeriesTestLayerConfig(int32_t numTilesT)
+        : WebMercatorTiled2dMapLayerConfig("mock", "test-data://tile/{z}/{x}/{y}", Tiled2dMapZoomInfo(1.0, 0, 0, false, true, false, true),
+                                           0, 20)
+        , numTilesT(numTilesT) {}
+
+    std::string getTileUrl(int32_t x, int32_t y, int32_t t, int32_t zoom) override {
+        return WebMercatorTiled2dMapLayerConfig::getTileUrl(x, y, t, zoom) + "/" + std::to_string(t);
+    }
+
+    std::vector<Tiled2dMapZoomLevelInfo> getZoomLevelInfos() override {
+        auto infos = WebMercatorTiled2dMapLayerConfig::getZoomLevelInfos();
+        for (auto &info : infos) {
+            info.numTilesT = numTilesT;
+        }
+        return infos;
+    }
+
+    std::vector<Tiled2dMapZoomLevelInfo> getVirtualZoomLevelInfos() override {
+        auto infos = WebMercatorTiled2dMapLayerConfig::getVirtualZoomLevelInfos();
+        for (auto &info : infos) {
+            info.numTilesT = numTilesT;
+        }
+        return infos;
+    }
+
+  private:
+    const int32_t numTilesT;
+};
+
+TEST_CASE("Tiled2dMapSource loads the upcoming time steps of a time series") {
+    const int numTilesT = 6;
+    auto layerConfig = std::make_shared<TimeSeriesTestLayerConfig>(numTilesT);
+
+    auto world = *layerConfig->getBounds();
+    auto zoomLevelInfos = layerConfig->getZoomLevelInfos();
+    const int z = 2;
+    std::vector<Tiled2dMapTileInfo> allTiles;
+    for (int t = 0; t < numTilesT; t++) {
+        allTiles.push_back({world, 0, 0, t, 0, int(zoomLevelInfos[0].zoom)});
+        for (int x = 0; x < zoomLevelInfos[z].numTilesX; x++) {
+            for (int y = 0; y < zoomLevelInfos[z].numTilesY; y++) {
+                allTiles.push_back({world, x, y, t, z, int(zoomLevelInfos[z].zoom)});
+            }
+        }
+    }
+
+    auto loader = std::make_shared<BlockingTestLoader>(generateDummyData(allTiles, *layerConfig, "dummy data "));
+    auto scheduler = std::make_shared<TestScheduler>();
+    std::shared_ptr<TestTiled2dMapVectorSource> source =
+        std::make_shared<TestTiled2dMapVectorSource>(layerConfig, scheduler, std::vector<std::shared_ptr<LoaderInterface>>{loader});
+    source->mailbox = std::make_shared<Mailbox>(scheduler);
+    source->setTimeSeries(3, 0);
+
+    const double zoom = zoomLevelInfos[z].zoom;
+    const auto &topLeft = world.topLeft;
+    RectCoord northWest(topLeft, Coord(topLeft.systemIdentifier, 0, 0, 0));
+
+    auto targetTiles = [&](const std::unordered_set<Tiled2dMapTileInfo> &tiles, int t) {
+        std::unordered_set<Tiled2dMapTileInfo> result;
+        for (const auto &tile : tiles) {
+            if (tile.zoomIdentifier == z && tile.t == t) {
+                result.insert(tile);
+            }
+        }
+        return result;
+    };
+
+    source->onVisibleBoundsChanged(northWest, 0, zoom);
+    while (scheduler->drain(), loader->unblockAll()) {
+    }
+
+    const auto visible = targetTiles(source->getCurrentTiles(), 0);
+    REQUIRE(!visible.empty());
+    REQUIRE(targetTiles(source->getCurrentTiles(), 1).empty());
+    for (int t = 1; t <= 3; t++) {
+        REQUIRE(targetTiles(source->getTimeSeriesLoadedTiles(), t).size() == visible.size());
+    }
+    REQUIRE(targetTiles(source->getTimeSeriesLoadedTiles(), 4).empty());
+    REQUIRE(source->timeSeriesReady == std::make_pair(3, 3));
+
+    // the next time step is shown without loading it
+    source->onVisibleBoundsChanged(northWest, 1, zoom);
+    REQUIRE(targetTiles(source->getCurrentTiles(), 1).size() == visible.size());
+    REQUIRE(targetTiles(source->getCurrentTiles(), 0).empty());
+    REQUIRE(source->timeSeriesReady == std::make_pair(2, 3));
+    while (scheduler->drain(), loader->unblockAll()) {
+    }
+    REQUIRE(source->timeSeriesReady == std::make_pair(3, 3));
+    REQUIRE(targetTiles(source->getTimeSeriesLoadedTiles(), 4).size() == visible.size());
+
+    // the window wraps around after the last time step
+    source->onVisibleBoundsChanged(northWest, numTilesT - 1, zoom);
+    while (scheduler->drain(), loader->unblockAll()) {
+    }
+    REQUIRE(targetTiles(source->getCurrentTiles(), numTilesT - 1).size() == visible.size());
+    for (int t = 0; t <= 2; t++) {
+        REQUIRE(targetTiles(source->getTimeSeriesLoadedTiles(), t).size() == visible.size());
+    }
+    REQUIRE(source->timeSeriesReady == std::make_pair(3, 3));
+
+    // the memory budget leaves room for the current and two upcoming time steps
+    source->resultMemorySize = 1000;
+    source->onVisibleBoundsChanged(northWest, 0, zoom);
+    while (scheduler->drain(), loader->unblockAll()) {
+    }
+    source->setTimeSeries(3, 1000 * (int64_t)visible.size() * 3);
+    source->onVisibleBoundsChanged(northWest, 0, zoom);
+    while (scheduler->drain(), loader->unblockAll()) {
+    }
+    REQUIRE(targetTiles(source->getTimeSeriesLoadedTiles(), 3).empty());
+    REQUIRE(targetTiles(source->getTimeSeriesLoadedTiles(), 2).size() == visible.size());
+    REQUIRE(source->timeSeriesReady == std::make_pair(2, 2));
+
+    source->setTimeSeries(0, 0);
+    source->onVisibleBoundsChanged(northWest, 0, zoom);
+    REQUIRE(source->getTimeSeriesLoadedTiles().empty());
+    REQUIRE(targetTiles(source->getCurrentTiles(), 0).size() == visible.size());
+}
@@ -0,0 +1,47 @@
+#include "VectorModificationWrapper.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <utility>
+
+TEST_CASE("VectorModificationWrapper") {
+    VectorModificationWrapper<float> values(std::vector<float>(10, 1.0f));
+    using Range = std::pair<size_t, size_t>;
+
+    SECTION("tracks the range of modified elements") {
+        REQUIRE_FALSE(values.wasModified());
+        REQUIRE(values.getModifiedRange() == Range(0, 0));
+
+        values[5] = 2.0f;
+        values[3] = 2.0f;
+        REQUIRE(values.wasModified());
+        REQUIRE(values.getModifiedRange() == Range(3, 6));
+        REQUIRE(values[5] == 2.0f);
+
+        values.resetModificationFlag();
+        REQUIRE_FALSE(values.wasModified());
+        values[8] += 1.0f;
+        values[9] *= 2.0;
+        REQUIRE(values.getModifiedRange() == Range(8, 10));
+        REQUIRE(values[9] == 2.0f);
+    }
+
+    SECTION("ignores unchanged values and reads") {
+        values[4] = 1.0f;
+        values[4] += 0.0f;
+        float sum = values[1] + values[2];
+        REQUIRE(sum == 2.0f);
+        REQUIRE_FALSE(values.wasModified());
+    }
+
+    SECTION("marks the whole vector on resize") {
+        values.resize(12);
+        REQUIRE(values.getModifiedRange() == Range(0, 12));
+        values.resetModificationFlag();
+        values.setModified();
+        REQUIRE(values.getModifiedRange() == Range(0, 12));
+        values.resetModificationFlag();
+        values.push_back(3.0f);
+        REQUIRE(values.getModifiedRange() == Range(12, 13));
+    }
+}
@@ -0,0 +1,310 @@
+#define GL_GLEXT_PROTOTYPES 1
+#include "BatchRenderer.h"
+
+#include "Color.h"
+#include "Coord.h"
+#include "CoordinateSystemFactory.h"
+#include "LayerInterface.h"
+#include "MapCallbackInterface.h"
+#include "MapCameraInterface.h"
+#include "MapConfig.h"
+#include "MapReadyCallbackInterface.h"
+#include "RenderingContextInterface.h"
+#include "ThreadPoolScheduler.h"
+#include "Vec2I.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+
+#include <GL/osmesa.h>
+
+namespace {
+
+// Wakes up a worker whenever its map requests a redraw or graphics task execution.
+class InvalidationNotifier : public MapCallbackInterface {
+  public:
+    void invalidate() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            invalidated = true;
+        }
+        condition.notify_all();
+    }
+
+    void onMapResumed() override {}
+
+    void waitForInvalidation() {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this] { return invalidated; });
+        invalidated = false;
+    }
+
+  private:
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool invalidated = false;
+};
+
+// Keeps the last state reported by drawReadyFrame.
+class ReadyStateCallback : public MapReadyCallbackInterface {
+  public:
+    void stateDidUpdate(LayerReadyState state) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->state = state;
+    }
+
+    LayerReadyState getState() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return state;
+    }
+
+  private:
+    std::mutex mutex;
+    LayerReadyState state = LayerReadyState::NOT_READY;
+};
+
+OSMesaContext createOSMesaContext() {
+#if OSMESA_MAJOR_VERSION > 11 || (OSMESA_MAJOR_VERSION == 11 && OSMESA_MINOR_VERSION >= 2)
+    int osmesa_attribs[] = {
+        OSMESA_FORMAT,
+        OSMESA_RGBA,
+        OSMESA_PROFILE,
+        OSMESA_COMPAT_PROFILE,
+        OSMESA_STENCIL_BITS,
+        8,
+        OSMESA_DEPTH_BITS,
+        16,
+        OSMESA_ACCUM_BITS,
+        16,
+        OSMESA_CONTEXT_MAJOR_VERSION,
+        3,
+        OSMESA_CONTEXT_MINOR_VERSION,
+        2,
+        0,
+    };
+    return OSMesaCreateContextAttribs(osmesa_attribs, nullptr);
+#else
+    return OSMesaCreateContext(OSMESA_RGBA, nullptr);
+#endif
+}
+
+} // namespace
+
+// Per thread rendering state: OSMesa context, optional multisampled framebuffer and the warm map.
+class BatchRenderer::Worker {
+  public:
+    Worker(const Config &config, const MapSetup &setupMap)
+        : config(config)
+        , buffer(config.width * config.height * 4) {
+        ctx = createOSMesaContext();
+        if (ctx == nullptr) {
+            std::cerr << "Error creating OSMesa context" << std::endl;
+            return;
+        }
+        if (!OSMesaMakeCurrent(ctx, buffer.data(), GL_UNSIGNED_BYTE, config.width, config.height)) {
+            std::cerr << "Error OSMesaMakeCurrent" << std::endl;
+            return;
+        }
+        if (config.numSamples > 0 && !initMSAA()) {
+            std::cerr << "Error creating multisampled framebuffer" << std::endl;
+            return;
+        }
+
+        const MapConfig mapConfig{CoordinateSystemFactory::getEpsg3857System()};
+        map = MapInterface::createWithOpenGl(mapConfig, ThreadPoolScheduler::create(), config.pixelDensity, false);
+        notifier = std::make_shared<InvalidationNotifier>();
+        map->setCallbackHandler(notifier);
+        map->getRenderingContext()->onSurfaceCreated();
+        map->setViewportSize(Vec2I((int32_t)config.width, (int32_t)config.height));
+        map->setBackgroundColor(Color{0.9f, 0.9f, 0.9f, 1.0f});
+        map->resume();
+
+        setupMap(map);
+
+        // only fully loaded frames are rendered
+        for (const auto &layer : map->getLayers()) {
+            layer->enableAnimations(false);
+        }
+    }
+
+    ~Worker() {
+        if (map) {
+            map->destroy();
+            map = nullptr;
+        }
+        if (fbo != 0) {
+            glDeleteRenderbuffers(2, rbo);
+            glDeleteFramebuffers(1, &fbo);
+        }
+        if (ctx != nullptr) {
+            OSMesaDestroyContext(ctx);
+        }
+    }
+
+    bool isValid() const { return map != nullptr; }
+
+    BatchRenderResult render(const BatchRenderJob &job) {
+        BatchRenderResult result;
+
+        auto bounds = job.bounds;
+        auto paddingPc = job.paddingPc;
+        if (job.zoom) {
+            // drawReadyFrame fits the map to a bounding box, use the one visible at the requested zoom
+            auto camera = map->getCamera();
+            const auto &tl = job.bounds.topLeft;
+            const auto &br = job.bounds.bottomRight;
+            camera->moveToCenterPositionZoom(Coord(tl.systemIdentifier, (tl.x + br.x) / 2.0, (tl.y + br.y) / 2.0, 0.0), *job.zoom,
+                                             false);
+            bounds = camera->getVisibleRect();
+            paddingPc = 0.0f;
+        }
+
+        result.state = awaitReadyFrame(bounds, paddingPc);
+        if (result.state != LayerReadyState::READY) {
+            return result;
+        }
+
+        map->prepare();
+        map->drawFrame();
+        readPixels(result.pixels);
+        return result;
+    }
+
+  private:
+    // Runs drawReadyFrame on a separate thread, which is woken up by the map whenever the ready state of a layer may
+    // have changed. This thread owns the GL context and renders frames whenever the map requests it, until done.
+    LayerReadyState awaitReadyFrame(const RectCoord &bounds, float paddingPc) {
+        auto readyState = std::make_shared<ReadyStateCallback>();
+        std::atomic<bool> done = false;
+
+        std::thread waiter([&] {
+            map->drawReadyFrame(bounds, paddingPc, config.timeout, readyState);
+            done = true;
+            notifier->invalidate();
+        });
+
+        while (!done) {
+            notifier->waitForInvalidation();
+            map->prepare();
+            map->drawFrame();
+        }
+        waiter.join();
+
+        // drawReadyFrame enables the animations again when done, only fully loaded frames are rendered
+        for (const auto &layer : map->getLayers()) {
+            layer->enableAnimations(false);
+        }
+        return readyState->getState();
+    }
+
+    bool initMSAA() {
+        glGenFramebuffers(1, &fbo);
+        glGenRenderbuffers(2, rbo);
+        glBindRenderbuffer(GL_RENDERBUFFER, rbo[0]);
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, config.numSamples, GL_RGBA, config.width, config.height);
+        glBindRenderbuffer(GL_RENDERBUFFER, rbo[1]);
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, config.numSamples, GL_DEPTH24_STENCIL8, config.width, config.height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+        glFramebufferRenderbuffer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, rbo[0]);
+        glFramebufferRenderbuffer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, rbo[1]);
+        return glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    }
+
+    void readPixels(std::vector<uint8_t> &pixels) {
+        const auto width = (GLsizei)config.width;
+        const auto height = (GLsizei)config.height;
+        if (fbo != 0) {
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+            glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+        }
+        glFinish();
+        pixels.resize(config.width * config.height * 4);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        if (fbo != 0) {
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+        }
+    }
+
+    const Config config;
+    std::vector<uint8_t> buffer;
+    OSMesaContext ctx = nullptr;
+    GLuint fbo = 0;
+    GLuint rbo[2] = {0, 0};
+
+    std::shared_ptr<MapInterface> map;
+    std::shared_ptr<InvalidationNotifier> notifier;
+};
+
+BatchRenderer::BatchRenderer(const Config &config, MapSetup setupMap)
+    : config(config)
+    , setupMap(std::move(setupMap)) {
+    for (size_t i = 0; i < std::max<size_t>(config.numWorkers, 1); i++) {
+        threads.emplace_back(&BatchRenderer::runWorker, this, i);
+    }
+}
+
+BatchRenderer::~BatchRenderer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    jobsAvailable.notify_all();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+std::vector<BatchRenderResult> BatchRenderer::render(const std::vector<BatchRenderJob> &jobs) {
+    std::lock_guard<std::mutex> renderLock(renderMutex);
+
+    std::vector<BatchRenderResult> results(jobs.size());
+    std::unique_lock<std::mutex> lock(mutex);
+    this->jobs = &jobs;
+    this->results = &results;
+    nextJob = 0;
+    numDone = 0;
+    jobsAvailable.notify_all();
+
+    jobsDone.wait(lock, [&] { return numDone == jobs.size(); });
+    this->jobs = nullptr;
+    this->results = nullptr;
+    return results;
+}
+
+void BatchRenderer::runWorker(size_t workerIndex) {
+    // the map is only created on the thread that owns the GL context
+    Worker worker(config, setupMap);
+    if (!worker.isValid()) {
+        std::cerr << "Batch render worker " << workerIndex << " failed to initialize" << std::endl;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        jobsAvailable.wait(lock, [this] { return stopped || (jobs != nullptr && nextJob < jobs->size()); });
+        if (stopped) {
+            return;
+        }
+
+        const size_t jobIndex = nextJob++;
+        const auto &job = (*jobs)[jobIndex];
+        lock.unlock();
+
+        BatchRenderResult result;
+        if (worker.isValid()) {
+            result = worker.render(job);
+        } else {
+            result.state = LayerReadyState::ERROR;
+        }
+
+        lock.lock();
+        (*results)[jobIndex] = std::move(result);
+        if (++numDone == jobs->size()) {
+            jobsDone.notify_all();
+        }
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "LayerReadyState.h"
+#include "MapInterface.h"
+#include "RectCoord.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// A single image to render: the map is fitted to `bounds`, or centered on `bounds` at `zoom` if set.
+struct BatchRenderJob {
+    RectCoord bounds;
+    float paddingPc = 0.0f;
+    std::optional<double> zoom = std::nullopt;
+};
+
+struct BatchRenderResult {
+    LayerReadyState state = LayerReadyState::NOT_READY;
+    // RGBA, rows bottom-up as returned by glReadPixels
+    std::vector<uint8_t> pixels;
+};
+
+// Renders lists of map images concurrently on a pool of worker threads, each with its own OSMesa context.
+//
+// Every worker keeps a warm MapInterface across jobs, set up once with the given callback. Resources that are
+// not bound to a GL context (loaders, font loader, their caches) should be created once and shared by the setup
+// callback between all maps of the pool.
+//
+// Each image is rendered with MapInterface::drawReadyFrame, which is notified by the layers whenever their ready state
+// may have changed. Meanwhile, the worker renders frames whenever the map is invalidated.
+class BatchRenderer {
+  public:
+    struct Config {
+        size_t width = 512;
+        size_t height = 512;
+        float pixelDensity = 90.0f;
+        size_t numWorkers = 4;
+        // per image, in seconds
+        float timeout = 30.0f;
+        // 0 disables multi sample anti-aliasing
+        int numSamples = 4;
+    };
+
+    using MapSetup = std::function<void(const std::shared_ptr<MapInterface> &map)>;
+
+    BatchRenderer(const Config &config, MapSetup setupMap);
+
+    ~BatchRenderer();
+
+    // Renders all jobs, blocks until done. Results are in the order of the jobs.
+    std::vector<BatchRenderResult> render(const std::vector<BatchRenderJob> &jobs);
+
+  private:
+    class Worker;
+
+    void runWorker(size_t workerIndex);
+
+    const Config config;
+    const MapSetup setupMap;
+
+    std::mutex mutex;
+    std::condition_variable jobsAvailable;
+    std::condition_variable jobsDone;
+
+    // state of the current render() call, guarded by mutex
+    const std::vector<BatchRenderJob> *jobs = nullptr;
+    std::vector<BatchRenderResult> *results = nullptr;
+    size_t nextJob = 0;
+    size_t numDone = 0;
+    bool stopped = false;
+
+    std::mutex renderMutex;
+    std::vector<std::thread> threads;
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "DataLoaderResult.h"
+#include "FontLoaderInterface.h"
+#include "FontLoaderResult.h"
+#include "LoaderInterface.h"
+#include "TextureLoaderResult.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Loads data (style json, vector tiles, ...) from a local directory. URLs are resolved relative to the root
+// directory, an optional file:// scheme is ignored.
+//
+// Loaded files are kept in memory up to maxCacheSizeBytes, the least recently used ones are evicted first. A single
+// instance shared by multiple maps thus reads files accessed repeatedly only once. Textures are not supported, as there is no image decoder available in the standalone build.
+class LocalDataLoader : public LoaderInterface {
+  public:
+    explicit LocalDataLoader(std::filesystem::path rootDirectory, size_t maxCacheSizeBytes = 64 * 1024 * 1024)
+        : rootDirectory(std::move(rootDirectory))
+        , maxCacheSizeBytes(maxCacheSizeBytes) {}
+
+    TextureLoaderResult loadTexture(const std::string &url, const std::optional<std::string> &etag) override {
+        return TextureLoaderResult(nullptr, std::nullopt, LoaderStatus::ERROR_OTHER, "unsupported");
+    }
+
+    DataLoaderResult loadData(const std::string &url, const std::optional<std::string> &etag) override {
+        const auto path = resolve(url);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = cache.find(path);
+            if (it != cache.end()) {
+                recentlyUsed.splice(recentlyUsed.begin(), recentlyUsed, it->second.recentlyUsed);
+                const auto &data = it->second.data;
+                return DataLoaderResult(::djinni::DataRef(data.data(), data.size()), std::nullopt, LoaderStatus::OK, std::nullopt);
+            }
+        }
+
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return DataLoaderResult(std::nullopt, std::nullopt, LoaderStatus::ERROR_404, std::nullopt);
+        }
+        std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        // the data ref holds a copy, cached entries can be evicted at any time
+        DataLoaderResult result(::djinni::DataRef(data.data(), data.size()), std::nullopt, LoaderStatus::OK, std::nullopt);
+        addToCache(path, std::move(data));
+        return result;
+    }
+
+    ::djinni::Future<TextureLoaderResult> loadTextureAsync(const std::string &url, const std::optional<std::string> &etag) override {
+        ::djinni::Promise<TextureLoaderResult> promise;
+        promise.setValue(loadTexture(url, etag));
+        return promise.getFuture();
+    }
+
+    ::djinni::Future<DataLoaderResult> loadDataAsync(const std::string &url, const std::optional<std::string> &etag) override {
+        ::djinni::Promise<DataLoaderResult> promise;
+        promise.setValue(loadData(url, etag));
+        return promise.getFuture();
+    }
+
+    void cancel(const std::string &url) override {}
+
+  private:
+    struct CacheEntry {
+        std::vector<char> data;
+        std::list<std::string>::iterator recentlyUsed;
+    };
+
+    void addToCache(const std::string &path, std::vector<char> data) {
+        if (data.size() > maxCacheSizeBytes) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (cache.count(path) > 0) {
+            // loaded concurrently
+            return;
+        }
+        while (!recentlyUsed.empty() && cacheSizeBytes + data.size() > maxCacheSizeBytes) {
+            auto it = cache.find(recentlyUsed.back());
+            cacheSizeBytes -= it->second.data.size();
+            cache.erase(it);
+            recentlyUsed.pop_back();
+        }
+        cacheSizeBytes += data.size();
+        recentlyUsed.push_front(path);
+        cache.emplace(path, CacheEntry{std::move(data), recentlyUsed.begin()});
+    }
+
+    std::string resolve(const std::string &url) const {
+        static const std::string fileScheme = "file://";
+        std::filesystem::path path = url.rfind(fileScheme, 0) == 0 ? url.substr(fileScheme.size()) : url;
+        return (path.is_absolute() ? path : rootDirectory / path).lexically_normal().string();
+    }
+
+    const std::filesystem::path rootDirectory;
+    const size_t maxCacheSizeBytes;
+
+    std::mutex mutex;
+    // most recently used first
+    std::list<std::string> recentlyUsed;
+    std::unordered_map<std::string, CacheEntry> cache;
+    size_t cacheSizeBytes = 0;
+};
+
+// Font loader for styles without text, or if labels are not needed.
+class NoFontLoader : public FontLoaderInterface {
+  public:
+    FontLoaderResult loadFont(const Font &font) override { return FontLoaderResult(nullptr, std::nullopt, LoaderStatus::ERROR_404); }
+};
@@ -0,0 +1,92 @@
+// Throughput benchmark for the BatchRenderer: renders a grid of map images around a center position from a
+// local vector tile directory and reports the rendered images per second.
+
+#include "BatchRenderer.h"
+#include "CoordinateSystemIdentifiers.h"
+#include "LocalDataLoader.h"
+#include "PMTilesLoader.h"
+#include "Tiled2dMapVectorDecodedTileCache.h"
+#include "Tiled2dMapVectorLayer.h"
+#include "Tiled2dMapVectorLayerInterface.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+static Coord wgs84ToEpsg3857(double lon, double lat) {
+    const double earthRadius = 6378137.0;
+    const double x = earthRadius * lon * M_PI / 180.0;
+    const double y = earthRadius * std::log(std::tan(M_PI / 4.0 + lat * M_PI / 360.0));
+    return Coord(CoordinateSystemIdentifiers::EPSG3857(), x, y, 0.0);
+}
+
+static std::vector<BatchRenderJob> createJobs(size_t numImages, Coord center, double zoom, double spacing) {
+    std::vector<BatchRenderJob> jobs;
+    const auto side = (size_t)std::ceil(std::sqrt((double)numImages));
+    for (size_t i = 0; i < numImages; i++) {
+        const double dx = ((double)(i % side) - side / 2.0) * spacing;
+        const double dy = ((double)(i / side) - side / 2.0) * spacing;
+        const Coord position(center.systemIdentifier, center.x + dx, center.y + dy, 0.0);
+        jobs.push_back(BatchRenderJob{RectCoord(position, position), 0.0f, zoom});
+    }
+    return jobs;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 5) {
+        std::cerr << "Usage: " << argv[0] << " <data directory> <style json> <lon> <lat> [zoom=5000] [images=64] [workers=4]" << std::endl;
+        std::cerr << "  The style json and its source urls are resolved relative to the data directory," << std::endl;
+        std::cerr << "  sources can also point into PMTiles archives: pmtiles://<archive path>/{z}/{x}/{y}" << std::endl;
+        return 1;
+    }
+
+    const std::string directory = argv[1];
+    const std::string styleJson = argv[2];
+    const Coord center = wgs84ToEpsg3857(std::stod(argv[3]), std::stod(argv[4]));
+    const double zoom = argc > 5 ? std::stod(argv[5]) : 5000.0;
+    const size_t numImages = argc > 6 ? std::stoul(argv[6]) : 64;
+
+    BatchRenderer::Config config;
+    config.numWorkers = argc > 7 ? std::stoul(argv[7]) : 4;
+
+    // shared between all maps of the pool
+    auto pmTilesLoader = std::make_shared<PMTilesLoader>();
+    auto loader = std::make_shared<LocalDataLoader>(directory);
+    auto fontLoader = std::make_shared<NoFontLoader>();
+    auto decodedTileCache = std::make_shared<Tiled2dMapVectorDecodedTileCache>();
+
+    BatchRenderer renderer(config, [&](const std::shared_ptr<MapInterface> &map) {
+        auto layer = Tiled2dMapVectorLayerInterface::createFromStyleJson("benchmark", styleJson, {pmTilesLoader, loader}, fontLoader);
+        if (auto vectorLayer = std::dynamic_pointer_cast<Tiled2dMapVectorLayer>(layer)) {
+            vectorLayer->setDecodedTileCache(decodedTileCache);
+        }
+        map->addLayer(layer->asLayerInterface());
+    });
+
+    // spacing of about one viewport, such that neighbouring images share some tiles
+    const double spacing = zoom * 0.0254 / config.pixelDensity * config.width;
+
+    // first pass warms up the maps and caches, the second one is measured
+    renderer.render(createJobs(config.numWorkers, center, zoom, spacing));
+
+    const auto jobs = createJobs(numImages, center, zoom, spacing);
+    const auto start = std::chrono::steady_clock::now();
+    const auto results = renderer.render(jobs);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    size_t numFailed = 0;
+    for (const auto &result : results) {
+        if (result.state != LayerReadyState::READY) {
+            numFailed++;
+        }
+    }
+
+    std::cout << "rendered " << results.size() << " images (" << numFailed << " failed) with " << config.numWorkers << " workers in "
+              << elapsed.count() << "s: " << results.size() / elapsed.count() << " images/s" << std::endl;
+
+    const auto cacheStatistics = decodedTileCache->getStatistics();
+    std::cout << "decoded tile cache: " << cacheStatistics.hits << " hits, " << cacheStatistics.misses << " misses, "
+              << cacheStatistics.evictions << " evictions, " << cacheStatistics.sizeBytes / 1024 << " KiB" << std::endl;
+    return numFailed == 0 ? 0 : 2;
+}
@@ -4,19 +4,36 @@
 
 #include "Color.h"
 #include "CoordinateSystemFactory.h"
+#include "IconFactory.h"
+#include "IconInfoInterface.h"
+#include "IconLayerInterface.h"
+#include "IconType.h"
 #include "LayerReadyState.h"
+#include "LocalDataLoader.h"
 #include "MapCallbackInterface.h"
 #include "MapCameraInterface.h"
 #include "MapConfig.h"
 #include "MapInterface.h"
+#include "MapReadyCallbackInterface.h"
+#include "PerformanceLogger.h"
 #include "PolygonInfo.h"
 #include "PolygonLayerInterface.h"
 #include "ThreadPoolScheduler.h"
+#include "Tiled2dMapReadyStateListener.h"
+#include "TextureHolderInterface.h"
+#include "Tiled2dMapVectorLayerInterface.h"
 #include "Vec2I.h"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <GL/osmesa.h>
 
@@ -37,15 +54,65 @@ static void readPixelsMSAA(MSAAState s, char *buf, size_t width, size_t height);
 
 static void printRect(const char *h, const RectCoord &b);
 static void addPolygonLayerUB(std::shared_ptr<MapInterface> map, RectCoord rect);
-
-struct NopMapCallback : MapCallbackInterface {
-    void invalidate() override {}
+static void addIconLayer(std::shared_ptr<MapInterface> map, RectCoord rect, int numIcons);
+
+// Records redraw requests of the map, such that the main thread can render frames on demand like a platform
+// render loop would.
+struct RenderRequestCallback : MapCallbackInterface {
+    void invalidate() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            requested = true;
+        }
+        condition.notify_all();
+    }
     void onMapResumed() override {}
+
+    void waitForRequest() {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this] { return requested; });
+        requested = false;
+    }
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool requested = false;
+};
+
+// Time of the last transition of a layer to the ready state.
+struct LayerReadyTimestamp : Tiled2dMapReadyStateListener {
+    void stateUpdate(LayerReadyState state) override {
+        if (state == LayerReadyState::READY) {
+            std::lock_guard<std::mutex> lock(mutex);
+            time = std::chrono::steady_clock::now();
+        }
+    }
+
+    std::mutex mutex;
+    std::optional<std::chrono::steady_clock::time_point> time;
 };
 
-static void awaitReadyToRenderOffscreen(std::shared_ptr<MapInterface> map);
+struct ReadyFrameCallback : MapReadyCallbackInterface {
+    void stateDidUpdate(LayerReadyState state) override {
+        if (state != LayerReadyState::NOT_READY) {
+            std::lock_guard<std::mutex> lock(mutex);
+            this->state = state;
+            time = std::chrono::steady_clock::now();
+        }
+    }
 
-int main() {
+    std::mutex mutex;
+    LayerReadyState state = LayerReadyState::NOT_READY;
+    std::chrono::steady_clock::time_point time;
+};
+
+static void awaitReadyFrame(std::shared_ptr<MapInterface> map, const std::shared_ptr<RenderRequestCallback> &renderRequests,
+                            const RectCoord &bounds, const std::shared_ptr<LayerReadyTimestamp> &layerReady);
+
+// Usage: testmain [<data directory> <style json>] | [--icons <count>]
+// If given, a vector layer is added from the local data directory and the latency of drawReadyFrame, measured from the
+// layer becoming ready, is printed. With --icons, an icon layer with count icons in four textures is added.
+int main(int argc, char **argv) {
     OSMesaContext ctx = initOSMesa();
     if (ctx == nullptr) {
         std::cerr << "Error creating OSMesa context" << std::endl;
@@ -69,7 +136,8 @@ int main() {
     const float pixelDensity = 90.0f; // ??
     auto map = MapInterface::createWithOpenGl(mapConfig, ThreadPoolScheduler::create(), pixelDensity, false);
 
-    map->setCallbackHandler(std::make_shared<NopMapCallback>());
+    auto renderRequests = std::make_shared<RenderRequestCallback>();
+    map->setCallbackHandler(renderRequests);
 
     map->getRenderingContext()->onSurfaceCreated();
     map->setViewportSize(Vec2I(width, height));
@@ -77,6 +145,17 @@ int main() {
     // map->setCamera(MapCamera2dInterface::create(map, 1.0f)); // BUG! must be _before_ setViewportSize
     map->resume();
 
+    const bool withIcons = argc > 2 && strcmp(argv[1], "--icons") == 0;
+    std::shared_ptr<LayerReadyTimestamp> layerReady;
+    if (argc > 2 && !withIcons) {
+        auto vectorLayer = Tiled2dMapVectorLayerInterface::createFromStyleJson(
+            "vector", argv[2], {std::make_shared<LocalDataLoader>(argv[1])}, std::make_shared<NoFontLoader>());
+        layerReady = std::make_shared<LayerReadyTimestamp>();
+        vectorLayer->setReadyStateListener(layerReady);
+        map->addLayer(vectorLayer->asLayerInterface());
+    }
+
+    RectCoord bounds = map->getCamera()->getVisibleRect();
     {
         auto cam = map->getCamera();
         cam->setPaddingTop(10.f);
@@ -89,14 +168,21 @@ int main() {
 
         auto visible = cam->getPaddingAdjustedVisibleRect();
         addPolygonLayerUB(map, visible);
+        if (withIcons) {
+            addIconLayer(map, visible, atoi(argv[2]));
+        }
+        bounds = cam->getVisibleRect();
     }
 
-    awaitReadyToRenderOffscreen(map);
+    awaitReadyFrame(map, renderRequests, bounds, layerReady);
     map->prepare();
     map->drawFrame();
     glCheckError();
     glFinish();
     glCheckError();
+#ifdef ENABLE_PERF_LOGGING
+    std::cout << "draw calls: " << PerformanceLogger::getInstance().getCount("Renderer_drawCalls") << std::endl;
+#endif
 
     map->destroy();
     map = nullptr;
@@ -307,23 +393,90 @@ static void addPolygonLayerUB(std::shared_ptr<MapInterface> map, RectCoord rect)
     map->addLayer(player);
 }
 
-static void awaitReadyToRenderOffscreen(std::shared_ptr<MapInterface> map) {
+// Runs drawReadyFrame on a separate thread, while this thread renders frames whenever the map requests it.
+static void awaitReadyFrame(std::shared_ptr<MapInterface> map, const std::shared_ptr<RenderRequestCallback> &renderRequests,
+                            const RectCoord &bounds, const std::shared_ptr<LayerReadyTimestamp> &layerReady) {
+    auto readyFrame = std::make_shared<ReadyFrameCallback>();
+    std::atomic<bool> done = false;
+
+    const auto start = std::chrono::steady_clock::now();
+    std::thread waiter([&] {
+        map->drawReadyFrame(bounds, 0.0f, 30.0f, readyFrame);
+        done = true;
+        renderRequests->invalidate();
+    });
 
-    bool unready = true;
-    while (unready) {
-        while (map->getScheduler()->runGraphicsTasks()) {
-        };
+    while (!done) {
+        renderRequests->waitForRequest();
+        map->prepare();
+        map->drawFrame();
+    }
+    waiter.join();
 
-        unready = std::ranges::any_of(map->getLayers(), [](std::shared_ptr<LayerInterface> &layer) -> bool {
-            return layer->isReadyToRenderOffscreen() == LayerReadyState::NOT_READY;
-        });
+    std::lock_guard<std::mutex> lock(readyFrame->mutex);
+    if (readyFrame->state != LayerReadyState::READY) {
+        printf("layer in error state: %s\n", toString(readyFrame->state));
+        return;
     }
 
-    // check for error states
-    for (auto layer : map->getLayers()) {
-        const auto layerState = layer->isReadyToRenderOffscreen();
-        if (layerState != LayerReadyState::READY) {
-            printf("layer in error state: %s\n", toString(layerState));
+    auto millis = [](auto duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+    printf("drawReadyFrame: ready after %.2f ms\n", millis(readyFrame->time - start));
+    if (layerReady) {
+        std::lock_guard<std::mutex> layerLock(layerReady->mutex);
+        if (layerReady->time) {
+            printf("drawReadyFrame: latency after layer became ready %.2f ms\n", millis(readyFrame->time - *layerReady->time));
+        }
+    }
+}
+
+// Texture of a single color, created when attached to the OpenGL context.
+struct ColorTextureHolder : TextureHolderInterface {
+    ColorTextureHolder(uint32_t rgba)
+        : rgba(rgba) {}
+
+    int32_t getImageWidth() override { return size; }
+    int32_t getImageHeight() override { return size; }
+    int32_t getTextureWidth() override { return size; }
+    int32_t getTextureHeight() override { return size; }
+
+    int32_t attachToGraphics() override {
+        if (texture == 0) {
+            std::vector<uint32_t> pixels(size * size, rgba);
+            glGenTextures(1, &texture);
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
         }
+        return (int32_t)texture;
     }
+
+    void clearFromGraphics() override {
+        if (texture != 0) {
+            glDeleteTextures(1, &texture);
+            texture = 0;
+        }
+    }
+
+    static constexpr int32_t size = 16;
+    uint32_t rgba;
+    GLuint texture = 0;
+};
+
+// Add an icon layer with numIcons icons on a grid inside the given rectangle, alternating between four textures.
+static void addIconLayer(std::shared_ptr<MapInterface> map, RectCoord rect, int numIcons) {
+    const std::vector<std::shared_ptr<TextureHolderInterface>> textures = {
+        std::make_shared<ColorTextureHolder>(0xff3333e6), std::make_shared<ColorTextureHolder>(0xff33e633),
+        std::make_shared<ColorTextureHolder>(0xffe63333), std::make_shared<ColorTextureHolder>(0xff33e6e6)};
+
+    const int gridSize = std::max(1, (int)std::ceil(std::sqrt(numIcons)));
+    std::vector<std::shared_ptr<IconInfoInterface>> icons;
+    for (int i = 0; i < numIcons; i++) {
+        const double x = std::lerp(rect.topLeft.x, rect.bottomRight.x, (i % gridSize + 0.5) / gridSize);
+        const double y = std::lerp(rect.topLeft.y, rect.bottomRight.y, (i / gridSize + 0.5) / gridSize);
+        icons.push_back(IconFactory::createIcon("icon" + std::to_string(i), Coord(rect.topLeft.systemIdentifier, x, y, 0.0),
+                                                textures[i % textures.size()], Vec2F(4.0, 4.0), IconType::INVARIANT, BlendMode::NORMAL));
+    }
+
+    auto iconLayer = IconLayerInterface::create();
+    iconLayer->setIcons(icons);
+    map->addLayer(iconLayer->asLayerInterface());
 }